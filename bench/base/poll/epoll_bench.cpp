@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+
+#if defined(__linux__)
+
+#include <base/poll/epoll.h>
+#include <spdlog/spdlog.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// 提高 fd 上限，10k 空闲 + 1k 活跃连接需要一万多个 fd
+void raiseFdLimit() {
+  rlimit rl;
+  if (::getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+    rl.rlim_cur = rl.rlim_max;
+    ::setrlimit(RLIMIT_NOFILE, &rl);
+  }
+}
+
+// range(0): 空闲连接数  range(1): 活跃连接数  range(2): 是否边沿触发
+void BM_EpollFiredEvents(benchmark::State& state) {
+  raiseFdLimit();
+  spdlog::set_level(spdlog::level::warn);
+
+  const int idle = static_cast<int>(state.range(0));
+  const int hot = static_cast<int>(state.range(1));
+  Epoll poller(state.range(2) != 0);
+
+  // 空闲连接用 eventfd 模拟：注册了读事件但永远不会就绪
+  std::vector<int> idleFds;
+  for (int i = 0; i < idle; ++i) {
+    int fd = ::eventfd(0, EFD_NONBLOCK);
+    if (fd < 0) {
+      state.SkipWithError("eventfd failed, fd limit too low?");
+      break;
+    }
+    idleFds.push_back(fd);
+    poller.addSocket(fd, static_cast<int>(EventType::Read), nullptr);
+  }
+
+  // 活跃连接用 socketpair：fds[0] 注册到 poller，fds[1] 模拟客户端写入
+  std::vector<int> serverFds, clientFds;
+  for (int i = 0; i < hot; ++i) {
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) != 0) {
+      state.SkipWithError("socketpair failed, fd limit too low?");
+      break;
+    }
+    serverFds.push_back(fds[0]);
+    clientFds.push_back(fds[1]);
+    // userdata 直接存下标
+    poller.addSocket(fds[0], static_cast<int>(EventType::Read),
+                     reinterpret_cast<void*>(static_cast<intptr_t>(i)));
+  }
+
+  std::vector<FiredEvent> fired;
+  const char ping = 'p';
+  char buf[16];
+  int64_t events = 0;
+  for (auto _ : state) {
+    for (int fd : clientFds)
+      (void)!::write(fd, &ping, 1);
+
+    int pending = static_cast<int>(clientFds.size());
+    while (pending > 0) {
+      int n = poller.poll(fired, 1024, 100);
+      if (n <= 0)
+        break;
+      for (int i = 0; i < n; ++i) {
+        auto idx = reinterpret_cast<intptr_t>(fired[i].userdata);
+        (void)!::read(serverFds[idx], buf, sizeof(buf));
+      }
+      pending -= n;
+      events += n;
+    }
+  }
+  state.counters["events/s"] =
+      benchmark::Counter(static_cast<double>(events),
+                         benchmark::Counter::kIsRate);
+
+  for (int fd : idleFds)
+    ::close(fd);
+  for (int fd : serverFds)
+    ::close(fd);
+  for (int fd : clientFds)
+    ::close(fd);
+}
+
+}  // namespace
+
+BENCHMARK(BM_EpollFiredEvents)
+    ->ArgNames({"idle", "hot", "et"})
+    ->Args({0, 1000, 0})
+    ->Args({0, 1000, 1})
+    ->Args({10000, 1000, 0})
+    ->Args({10000, 1000, 1})
+    ->UseRealTime();
+
+#endif  // __linux__
@@ -0,0 +1,243 @@
+#include <benchmark/benchmark.h>
+
+#include <base/poll/ioUring.h>
+
+#if defined(TINYREDIS_HAVE_IO_URING)
+
+#include <base/buffer/buffer.h>
+#include <base/poll/epoll.h>
+#include <spdlog/spdlog.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char kRequest[] = "*1\r\n$4\r\nPING\r\n";
+const char kReply[] = "+PONG\r\n";
+
+struct Conns {
+  std::vector<int> server;
+  std::vector<int> client;
+
+  explicit Conns(int n) {
+    rlimit rl;
+    if (::getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+      rl.rlim_cur = rl.rlim_max;
+      ::setrlimit(RLIMIT_NOFILE, &rl);
+    }
+    for (int i = 0; i < n; ++i) {
+      int fds[2];
+      if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) != 0)
+        break;
+      server.push_back(fds[0]);
+      client.push_back(fds[1]);
+    }
+  }
+  ~Conns() {
+    for (int fd : server)
+      ::close(fd);
+    for (int fd : client)
+      ::close(fd);
+  }
+
+  // 客户端发请求，读回复，不计入服务端系统调用
+  void sendRequests() {
+    for (int fd : client)
+      (void)!::write(fd, kRequest, sizeof(kRequest) - 1);
+  }
+  void drainReplies() {
+    char buf[64];
+    for (int fd : client)
+      (void)!::read(fd, buf, sizeof(buf));
+  }
+};
+
+void report(benchmark::State& state, std::vector<double>& latencies,
+            int64_t syscalls, int64_t requests) {
+  std::sort(latencies.begin(), latencies.end());
+  double p99 = latencies.empty()
+                   ? 0
+                   : latencies[static_cast<std::size_t>(latencies.size() *
+                                                        0.99)];
+  state.counters["syscalls/req"] =
+      requests ? static_cast<double>(syscalls) / requests : 0;
+  state.counters["p99_us"] = p99;
+  state.counters["req/s"] = benchmark::Counter(
+      static_cast<double>(requests), benchmark::Counter::kIsRate);
+}
+
+// 就绪模型：epoll_wait + read + write，每个请求至少两次系统调用
+void BM_EpollPingPong(benchmark::State& state) {
+  spdlog::set_level(spdlog::level::warn);
+  Conns conns(static_cast<int>(state.range(0)));
+  const int n = static_cast<int>(conns.server.size());
+
+  Epoll poller;
+  for (int i = 0; i < n; ++i)
+    poller.addSocket(conns.server[i], static_cast<int>(EventType::Read),
+                     reinterpret_cast<void*>(static_cast<intptr_t>(i)));
+
+  std::vector<FiredEvent> fired;
+  std::vector<double> latencies;
+  int64_t syscalls = 0, requests = 0;
+  char buf[256];
+
+  for (auto _ : state) {
+    conns.sendRequests();
+    auto start = Clock::now();
+    int pending = n;
+    while (pending > 0) {
+      int nFired = poller.poll(fired, 1024, 100);
+      ++syscalls;
+      if (nFired <= 0)
+        break;
+      for (int i = 0; i < nFired; ++i) {
+        int fd = conns.server[reinterpret_cast<intptr_t>(fired[i].userdata)];
+        (void)!::read(fd, buf, sizeof(buf));
+        (void)!::write(fd, kReply, sizeof(kReply) - 1);
+        syscalls += 2;
+        latencies.push_back(std::chrono::duration<double, std::micro>(
+                                Clock::now() - start)
+                                .count());
+      }
+      pending -= nFired;
+      requests += nFired;
+    }
+    state.PauseTiming();
+    conns.drainReplies();
+    state.ResumeTiming();
+  }
+  report(state, latencies, syscalls, requests);
+}
+
+// 就绪模型换成 io_uring：multishot poll 取代 epoll_wait，收发仍是 read + write。
+// 内核不支持完成模型时事件循环退回到这条路径
+void BM_IoUringPollPingPong(benchmark::State& state) {
+  spdlog::set_level(spdlog::level::warn);
+  if (!IoUring::isSupported()) {
+    state.SkipWithError("io_uring not supported");
+    return;
+  }
+  Conns conns(static_cast<int>(state.range(0)));
+  const int n = static_cast<int>(conns.server.size());
+
+  IoUring poller(4096, 0);  // 不注册 buffer ring，只做就绪通知
+  for (int i = 0; i < n; ++i)
+    poller.addSocket(conns.server[i], static_cast<int>(EventType::Read),
+                     reinterpret_cast<void*>(static_cast<intptr_t>(i)));
+
+  std::vector<FiredEvent> fired;
+  std::vector<double> latencies;
+  int64_t syscalls = 0, requests = 0;
+  char buf[256];
+
+  for (auto _ : state) {
+    conns.sendRequests();
+    auto start = Clock::now();
+    int pending = n;
+    while (pending > 0) {
+      int nFired = poller.poll(fired, 4096, 100);
+      ++syscalls;
+      if (nFired <= 0)
+        break;
+      for (int i = 0; i < nFired; ++i) {
+        int fd = conns.server[reinterpret_cast<intptr_t>(fired[i].userdata)];
+        (void)!::read(fd, buf, sizeof(buf));
+        (void)!::write(fd, kReply, sizeof(kReply) - 1);
+        syscalls += 2;
+        latencies.push_back(std::chrono::duration<double, std::micro>(
+                                Clock::now() - start)
+                                .count());
+      }
+      pending -= nFired;
+      requests += nFired;
+    }
+    state.PauseTiming();
+    conns.drainReplies();
+    state.ResumeTiming();
+  }
+  report(state, latencies, syscalls, requests);
+}
+
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+// 完成模型：IoUring 的 multishot recv + sendmsg，也就是事件循环在 6.0+ 内核上
+// 实际走的路径；一轮所有连接共用少量 io_uring_enter
+void BM_IoUringPingPong(benchmark::State& state) {
+  spdlog::set_level(spdlog::level::warn);
+  if (!IoUring::isSupported()) {
+    state.SkipWithError("io_uring not supported");
+    return;
+  }
+  Conns conns(static_cast<int>(state.range(0)));
+  const int n = static_cast<int>(conns.server.size());
+
+  IoUring ring(4096, 4096, 256);
+  if (!ring.completionBased()) {
+    state.SkipWithError("io_uring completion mode not supported");
+    return;
+  }
+  for (int i = 0; i < n; ++i)
+    ring.submitRecv(conns.server[i],
+                    reinterpret_cast<void*>(static_cast<intptr_t>(i)));
+
+  BufferSequence reply;
+  reply.buffers[0].iov_base = const_cast<char*>(kReply);
+  reply.buffers[0].iov_len = sizeof(kReply) - 1;
+  reply.count = 1;
+
+  std::vector<FiredEvent> fired;
+  std::vector<double> latencies;
+  int64_t requests = 0;
+  const std::size_t enterBefore = ring.enterCalls();
+
+  for (auto _ : state) {
+    conns.sendRequests();
+    auto start = Clock::now();
+    int pending = n;  // 回复发送完成才算结束
+    while (pending > 0) {
+      if (ring.poll(fired, 4096, 100) < 0)
+        break;
+      for (const Completion& c : ring.completions()) {
+        if (c.op == Completion::Op::Recv) {
+          const intptr_t i = reinterpret_cast<intptr_t>(c.userdata);
+          if (c.result > 0)
+            ring.submitSend(conns.server[i], reply, nullptr, false,
+                            c.userdata);
+        } else {
+          --pending;
+          ++requests;
+          latencies.push_back(std::chrono::duration<double, std::micro>(
+                                  Clock::now() - start)
+                                  .count());
+        }
+      }
+    }
+    state.PauseTiming();
+    conns.drainReplies();
+    state.ResumeTiming();
+  }
+  report(state, latencies,
+         static_cast<int64_t>(ring.enterCalls() - enterBefore), requests);
+}
+#endif  // TINYREDIS_HAVE_IO_URING_COMPLETION
+
+}  // namespace
+
+BENCHMARK(BM_EpollPingPong)->ArgName("conns")->Arg(100)->Arg(1000)
+    ->UseRealTime();
+BENCHMARK(BM_IoUringPollPingPong)->ArgName("conns")->Arg(100)->Arg(1000)
+    ->UseRealTime();
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+BENCHMARK(BM_IoUringPingPong)->ArgName("conns")->Arg(100)->Arg(1000)
+    ->UseRealTime();
+#endif
+
+#endif  // TINYREDIS_HAVE_IO_URING
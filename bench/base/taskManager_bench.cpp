@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include <base/eventLoop.h>
+#include <base/server.h>
+#include <spdlog/spdlog.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <memory>
+#include <vector>
+
+using Internal::EventLoop;
+using Internal::TaskManager;
+
+namespace {
+// 50k 个空闲连接 + 500 个每轮都收到请求的连接，测量一轮 DoMsgParse 的开销
+const int kIdle = 50000;
+const int kBusy = 500;
+
+struct Fixture {
+  Server server;
+  std::unique_ptr<EventLoop> loop;
+  std::vector<std::shared_ptr<StreamSocket>> all;
+  std::vector<std::shared_ptr<StreamSocket>> busy;
+  std::vector<int> peers;
+
+  Fixture() : loop(new EventLoop(&server, 0)) {
+    spdlog::set_level(spdlog::level::warn);
+    TaskManager& tm = loop->taskManager();
+    for (int i = 0; i < kIdle; ++i) {
+      all.push_back(std::make_shared<StreamSocket>());
+      tm.addTask(all.back());
+    }
+    for (int i = 0; i < kBusy; ++i) {
+      int fds[2];
+      ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds);
+      auto conn = loop->newConnection(fds[0], SocketAddr(), 0);
+      tm.addTask(conn);
+      all.push_back(conn);
+      busy.push_back(conn);
+      peers.push_back(fds[1]);
+    }
+    tm.DoMsgParse();  // 新连接先处理一轮
+  }
+
+  ~Fixture() {
+    for (int fd : peers)
+      ::close(fd);
+    loop->taskManager().clear();
+  }
+
+  // 模拟一轮 poll：每个忙连接收到一条请求并读入缓冲区
+  void receive() {
+    static const char kReq[] = "*1\r\n$4\r\nPING\r\n";
+    for (int i = 0; i < kBusy; ++i) {
+      ssize_t n = ::write(peers[i], kReq, sizeof(kReq) - 1);
+      (void)n;
+      busy[i]->OnReadable();
+    }
+  }
+};
+}  // namespace
+
+// 就绪链表：只处理收到数据的连接
+static void BM_TaskManagerReadyList(benchmark::State& state) {
+  Fixture f;
+  TaskManager& tm = f.loop->taskManager();
+  for (auto _ : state) {
+    state.PauseTiming();
+    f.receive();
+    state.ResumeTiming();
+    tm.DoMsgParse();
+  }
+  state.counters["conns"] = static_cast<double>(tm.size());
+  state.SetItemsProcessed(state.iterations() * kBusy);
+}
+BENCHMARK(BM_TaskManagerReadyList)->Unit(benchmark::kMicrosecond);
+
+// 对照：原来每轮遍历所有连接的做法
+static void BM_TaskManagerFullScan(benchmark::State& state) {
+  Fixture f;
+  TaskManager& tm = f.loop->taskManager();
+  for (auto _ : state) {
+    state.PauseTiming();
+    f.receive();
+    state.ResumeTiming();
+    for (const auto& conn : f.all)
+      benchmark::DoNotOptimize(conn->DoMsgParse());
+    tm.DoMsgParse();  // 清空就绪链表
+  }
+  state.counters["conns"] = static_cast<double>(tm.size());
+  state.SetItemsProcessed(state.iterations() * kBusy);
+}
+BENCHMARK(BM_TaskManagerFullScan)->Unit(benchmark::kMicrosecond);
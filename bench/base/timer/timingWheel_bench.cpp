@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <base/timer/timingWheel.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using Internal::TimingWheel;
+
+namespace {
+const int kArmedTimers = 1000000;
+
+// 在已有 100 万个定时器（延迟分布在 1ms~1h）的时间轮上测量单次操作的开销
+void armTimers(TimingWheel& wheel, std::vector<TimingWheel::TimerId>& ids,
+               int n) {
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<uint64_t> delay(1, 3600 * 1000);
+  ids.reserve(n);
+  for (int i = 0; i < n; ++i)
+    ids.push_back(wheel.schedule(delay(rng), []() {}));
+}
+}  // namespace
+
+// 在 100 万个定时器上继续添加后立即取消，对应空闲超时的重置
+static void BM_TimingWheelScheduleCancel(benchmark::State& state) {
+  TimingWheel wheel;
+  std::vector<TimingWheel::TimerId> ids;
+  armTimers(wheel, ids, kArmedTimers);
+
+  uint64_t delay = 1;
+  for (auto _ : state) {
+    auto id = wheel.schedule(delay, []() {});
+    benchmark::DoNotOptimize(wheel.cancel(id));
+    delay = delay * 7 % (3600 * 1000) + 1;
+  }
+  state.counters["armed"] = static_cast<double>(wheel.size());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimingWheelScheduleCancel);
+
+// 逐毫秒推进 1 小时，触发全部 100 万个定时器，包括降层的开销
+static void BM_TimingWheelExpireAll(benchmark::State& state) {
+  int64_t fired = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    TimingWheel wheel;
+    std::vector<TimingWheel::TimerId> ids;
+    armTimers(wheel, ids, kArmedTimers);
+    state.ResumeTiming();
+
+    for (uint64_t now = 1; !wheel.empty(); now += 1)
+      fired += wheel.advance(now);
+  }
+  state.SetItemsProcessed(fired);
+}
+BENCHMARK(BM_TimingWheelExpireAll)->Unit(benchmark::kMillisecond);
+
+// 事件循环每轮都要调用的 nextTimeoutMs
+static void BM_TimingWheelNextTimeout(benchmark::State& state) {
+  TimingWheel wheel;
+  std::vector<TimingWheel::TimerId> ids;
+  armTimers(wheel, ids, kArmedTimers);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(wheel.nextTimeoutMs(0, 1000));
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimingWheelNextTimeout);
@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+#include <server/db/bplusTree.h>
+#include <server/db/skiplist.h>
+#include <server/util/memory.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using tinyredis::BPlusTree;
+using tinyredis::SkipList;
+using tinyredis::Slice;
+
+namespace {
+const int kElements = 1000000;
+
+enum IndexKind {
+  kBPlusTree,
+  kSkipList,  // 对照：Redis 的 zskiplist
+};
+
+struct Entry {
+  double score;
+  std::string member;
+};
+
+uint64_t nextRandom(uint64_t* x) {
+  *x ^= *x << 13;
+  *x ^= *x >> 7;
+  *x ^= *x << 17;
+  return *x;
+}
+
+// 排行榜式的数据：分数随机，成员是短 id
+const std::vector<Entry>& entries() {
+  static std::vector<Entry> v;
+  if (v.empty()) {
+    uint64_t x = 88172645463325252ULL;
+    v.reserve(kElements);
+    for (int i = 0; i < kElements; ++i) {
+      char buf[32];
+      const int n = std::snprintf(buf, sizeof(buf), "player:%d", i);
+      v.push_back(Entry{static_cast<double>(nextRandom(&x) % 10000000),
+                        std::string(buf, static_cast<std::size_t>(n))});
+    }
+  }
+  return v;
+}
+
+Slice slice(const std::string& s) {
+  return Slice{s.data(), s.size()};
+}
+
+// 两种索引的统一外壳，基准中按 kind 选择
+struct Index {
+  std::unique_ptr<BPlusTree> tree;
+  std::unique_ptr<SkipList> zsl;
+
+  explicit Index(int kind) {
+    if (kind == kBPlusTree)
+      tree.reset(new BPlusTree);
+    else
+      zsl.reset(new SkipList);
+  }
+
+  void insert(const Entry& e) {
+    if (tree)
+      tree->insert(e.score, slice(e.member));
+    else
+      zsl->insert(e.score, slice(e.member));
+  }
+};
+
+std::unique_ptr<Index> makeIndex(int kind, int n) {
+  std::unique_ptr<Index> index(new Index(kind));
+  const std::vector<Entry>& v = entries();
+  for (int i = 0; i < n; ++i)
+    index->insert(v[i]);
+  return index;
+}
+
+void BM_ZsetIndexMemoryPerElement(benchmark::State& state) {
+  const int kind = static_cast<int>(state.range(0));
+  entries();
+  double bytesPerElement = 0;
+  for (auto _ : state) {
+    const std::size_t before = tinyredis::allocatedBytes();
+    std::unique_ptr<Index> index = makeIndex(kind, kElements);
+    bytesPerElement =
+        static_cast<double>(tinyredis::allocatedBytes() - before) / kElements;
+    state.PauseTiming();
+    index.reset();
+    state.ResumeTiming();
+  }
+  state.counters["bytes_per_element"] = bytesPerElement;
+}
+
+// ZADD 新成员：逐个插入 kElements 个随机分数的元素
+void BM_ZsetIndexInsert(benchmark::State& state) {
+  const int kind = static_cast<int>(state.range(0));
+  entries();
+  for (auto _ : state) {
+    std::unique_ptr<Index> index = makeIndex(kind, kElements);
+    state.PauseTiming();
+    index.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+
+// ZRANK 随机成员（分数已由字典查到）
+void BM_ZsetIndexRank(benchmark::State& state) {
+  const int kind = static_cast<int>(state.range(0));
+  std::unique_ptr<Index> index = makeIndex(kind, kElements);
+  const std::vector<Entry>& v = entries();
+  uint64_t x = 2463534242ULL;
+  for (auto _ : state) {
+    const Entry& e = v[nextRandom(&x) % kElements];
+    const Slice m = slice(e.member);
+    const std::size_t r = index->tree ? index->tree->rank(e.score, m)
+                                      : index->zsl->rank(e.score, m);
+    benchmark::DoNotOptimize(r);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// ZRANGE 随机排名开始的 10 个元素
+void BM_ZsetIndexRange10(benchmark::State& state) {
+  const int kind = static_cast<int>(state.range(0));
+  std::unique_ptr<Index> index = makeIndex(kind, kElements);
+  uint64_t x = 2463534242ULL;
+  for (auto _ : state) {
+    const std::size_t start = nextRandom(&x) % (kElements - 10);
+    double sum = 0;
+    if (index->tree) {
+      index->tree->range(start, start + 9,
+                         [&sum](const std::string&, double s) { sum += s; });
+    } else {
+      const SkipList::Node* n = index->zsl->byRank(start);
+      for (int i = 0; i < 10; ++i, n = SkipList::next(n))
+        sum += n->score;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * 10);
+}
+
+BENCHMARK(BM_ZsetIndexMemoryPerElement)
+    ->Arg(kBPlusTree)
+    ->Arg(kSkipList)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ZsetIndexInsert)
+    ->Arg(kBPlusTree)
+    ->Arg(kSkipList)
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ZsetIndexRank)->Arg(kBPlusTree)->Arg(kSkipList);
+BENCHMARK(BM_ZsetIndexRange10)->Arg(kBPlusTree)->Arg(kSkipList);
+}  // namespace
@@ -0,0 +1,182 @@
+#include <benchmark/benchmark.h>
+#include <server/db/dict.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using tinyredis::Dict;
+
+namespace {
+using IntDict = Dict<uint64_t, uint64_t>;
+using Clock = std::chrono::steady_clock;
+
+// 键用 64 位整数，100M 个键时内存仍在可控范围内
+uint64_t keyOf(uint64_t i) {
+  return i * 0x9E3779B97F4A7C15ULL;
+}
+
+double elapsedUs(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+
+// 逐个插入 N 个键，记录单次插入的最大耗时：
+// 渐进式 rehash 下扩容不会让某一次插入停顿在整表迁移上
+void BM_DictInsert(benchmark::State& state) {
+  const uint64_t n = static_cast<uint64_t>(state.range(0));
+  double maxUs = 0;
+  for (auto _ : state) {
+    std::unique_ptr<IntDict> d(new IntDict);
+    for (uint64_t i = 0; i < n; ++i) {
+      Clock::time_point start = Clock::now();
+      d->set(keyOf(i), i);
+      double us = elapsedUs(start);
+      if (us > maxUs)
+        maxUs = us;
+    }
+    state.PauseTiming();
+    d.reset();
+    state.ResumeTiming();
+  }
+  state.counters["max_us"] = maxUs;
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+// 对照：std::unordered_map 扩容时一次性迁移所有元素
+void BM_UnorderedMapInsert(benchmark::State& state) {
+  const uint64_t n = static_cast<uint64_t>(state.range(0));
+  double maxUs = 0;
+  for (auto _ : state) {
+    std::unique_ptr<std::unordered_map<uint64_t, uint64_t>> m(
+        new std::unordered_map<uint64_t, uint64_t>);
+    for (uint64_t i = 0; i < n; ++i) {
+      Clock::time_point start = Clock::now();
+      (*m)[keyOf(i)] = i;
+      double us = elapsedUs(start);
+      if (us > maxUs)
+        maxUs = us;
+    }
+    state.PauseTiming();
+    m.reset();
+    state.ResumeTiming();
+  }
+  state.counters["max_us"] = maxUs;
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+// 每种大小只建一次，随机查找已存在的键
+IntDict& prebuilt(uint64_t n) {
+  static uint64_t builtSize = 0;
+  static std::unique_ptr<IntDict> d;
+  if (builtSize != n) {
+    d.reset(new IntDict);
+    for (uint64_t i = 0; i < n; ++i)
+      d->set(keyOf(i), i);
+    while (d->rehash(1000)) {
+    }
+    builtSize = n;
+  }
+  return *d;
+}
+
+void BM_DictLookup(benchmark::State& state) {
+  const uint64_t n = static_cast<uint64_t>(state.range(0));
+  IntDict& d = prebuilt(n);
+  uint64_t x = 88172645463325252ULL;
+  for (auto _ : state) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    benchmark::DoNotOptimize(d.find(keyOf(x % n)));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// 删除全部键，期间会多次触发缩容
+void BM_DictErase(benchmark::State& state) {
+  const uint64_t n = static_cast<uint64_t>(state.range(0));
+  double maxUs = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::unique_ptr<IntDict> d(new IntDict);
+    for (uint64_t i = 0; i < n; ++i)
+      d->set(keyOf(i), i);
+    state.ResumeTiming();
+
+    for (uint64_t i = 0; i < n; ++i) {
+      Clock::time_point start = Clock::now();
+      d->erase(keyOf(i));
+      double us = elapsedUs(start);
+      if (us > maxUs)
+        maxUs = us;
+    }
+  }
+  state.counters["max_us"] = maxUs;
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+// 扩容时整表迁移的总耗时，以及按 1ms 预算切片后单片的最大耗时
+void BM_DictResize(benchmark::State& state) {
+  const uint64_t n = static_cast<uint64_t>(state.range(0));
+  double maxSliceUs = 0;
+  double slices = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::unique_ptr<IntDict> d(new IntDict);
+    d->reserve(n);
+    while (d->bucketCount() > d->size())
+      d->set(keyOf(d->size()), 0);
+    d->set(keyOf(d->size()), 0);  // 装满后再插一个，开始扩容
+    state.ResumeTiming();
+
+    while (d->isRehashing()) {
+      Clock::time_point start = Clock::now();
+      d->rehashFor(1000);
+      double us = elapsedUs(start);
+      if (us > maxSliceUs)
+        maxSliceUs = us;
+      ++slices;
+    }
+
+    state.PauseTiming();
+    d.reset();
+    state.ResumeTiming();
+  }
+  state.counters["slices"] = slices / static_cast<double>(state.iterations());
+  state.counters["max_slice_us"] = maxSliceUs;
+}
+
+// 1M/10M 默认运行；100M 需要数 GB 内存，设置 TINYREDIS_BENCH_100M 后才注册
+int registerDictBenchmarks() {
+  std::vector<int64_t> sizes = {1000000, 10000000};
+  if (std::getenv("TINYREDIS_BENCH_100M"))
+    sizes.push_back(100000000);
+  for (int64_t n : sizes) {
+    benchmark::RegisterBenchmark("BM_DictInsert", BM_DictInsert)
+        ->Arg(n)
+        ->Iterations(1)
+        ->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("BM_UnorderedMapInsert",
+                                 BM_UnorderedMapInsert)
+        ->Arg(n)
+        ->Iterations(1)
+        ->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("BM_DictLookup", BM_DictLookup)->Arg(n);
+    benchmark::RegisterBenchmark("BM_DictErase", BM_DictErase)
+        ->Arg(n)
+        ->Iterations(1)
+        ->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("BM_DictResize", BM_DictResize)
+        ->Arg(n)
+        ->Iterations(1)
+        ->Unit(benchmark::kMillisecond);
+  }
+  return 0;
+}
+
+const int kDictBenchmarks = registerDictBenchmarks();
+}  // namespace
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include <server/db/hyperloglog.h>
+#include <server/db/object.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using tinyredis::Object;
+using tinyredis::Slice;
+
+namespace hll = tinyredis::hll;
+
+namespace {
+// count 个 dense HLL，寄存器取 0 到 10 的随机值（相当于每个几万个元素）
+std::vector<Object> makeDense(std::size_t count) {
+  std::mt19937 rng(1);
+  std::unique_ptr<hll::Registers> regs(new hll::Registers);
+  std::vector<Object> out(count);
+  for (Object& o : out) {
+    for (std::size_t i = 0; i < hll::kRegisters; ++i)
+      regs->r[i] = static_cast<uint8_t>(rng() % 11);
+    hll::store(o, *regs, true, 0);
+  }
+  return out;
+}
+
+// 多键 PFCOUNT 的计算部分：arg0 为内核，arg1 为键数
+void BM_HllMergeCount(benchmark::State& state) {
+  const hll::Kernel saved = hll::kernels().current();
+  const hll::Kernel kernel = static_cast<hll::Kernel>(state.range(0));
+  if (!hll::kernels().force(kernel)) {
+    state.SkipWithError("kernel not supported");
+    return;
+  }
+  state.SetLabel(hll::kernelName(kernel));
+  const std::vector<Object> hlls =
+      makeDense(static_cast<std::size_t>(state.range(1)));
+  char buf[Object::kIntBufSize];
+  for (auto _ : state) {
+    hll::Registers& regs = hll::scratch();
+    std::memset(regs.r, 0, sizeof(regs.r));
+    for (const Object& o : hlls)
+      hll::merge(regs, o.stringValue(buf));
+    benchmark::DoNotOptimize(hll::count(regs));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(1));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(1) *
+                          static_cast<int64_t>(hll::kDenseSize));
+  hll::kernels().force(saved);
+}
+
+// PFADD 单个元素，arg0 为 0 时保持 sparse，为 1 时为 dense
+void BM_HllAdd(benchmark::State& state) {
+  const bool dense = state.range(0) != 0;
+  Object o = hll::create();
+  std::vector<std::string> elements;
+  for (int i = 0; i < 1000; ++i)
+    elements.push_back("user:" + std::to_string(i));
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::string& e = elements[i++ % elements.size()];
+    benchmark::DoNotOptimize(
+        hll::add(o, Slice{e.data(), e.size()}, dense ? 0 : 3000));
+  }
+  state.SetLabel(dense ? "dense" : "sparse");
+}
+}  // namespace
+
+BENCHMARK(BM_HllMergeCount)
+    ->ArgsProduct({{static_cast<int64_t>(hll::Kernel::kScalar),
+                    static_cast<int64_t>(hll::Kernel::kAvx2)},
+                   {100, 10000}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HllAdd)->Arg(0)->Arg(1);
@@ -0,0 +1,154 @@
+#include <benchmark/benchmark.h>
+#include <server/db/intset.h>
+#include <server/db/intsetIntersect.h>
+#include <server/db/object.h>
+#include <server/util/memory.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using tinyredis::IntArray;
+using tinyredis::IntersectKernel;
+using tinyredis::Intset;
+using tinyredis::Object;
+using tinyredis::Slice;
+
+namespace {
+using SetDict = Object::SetDict;
+
+// 元素取自 [0, kRange)，两个大集合各取约一半，交集约为 1/4
+const int64_t kRange = 2000000;
+
+enum SetKind {
+  kIntsetScalar,
+  kIntsetAvx2,
+  kHashSet,  // 对照：成员为字符串的哈希表，遍历小的一边逐个查找另一边
+};
+
+// seed 相同时生成相同的集合；n 为 0 时每个数以 1/2 的概率选中，否则随机取 n 个
+std::vector<int64_t> makeValues(uint64_t seed, std::size_t n) {
+  std::mt19937_64 rng(seed);
+  std::vector<int64_t> v;
+  if (n == 0) {
+    for (int64_t x = 0; x < kRange; ++x) {
+      if (rng() & 1)
+        v.push_back(x);
+    }
+    return v;
+  }
+  std::vector<bool> picked(kRange);
+  while (v.size() < n) {
+    const int64_t x = static_cast<int64_t>(rng() % kRange);
+    if (!picked[x]) {
+      picked[x] = true;
+      v.push_back(x);
+    }
+  }
+  return v;
+}
+
+// 一个测试集合的两种表示
+struct TestSet {
+  Intset is;
+  std::unique_ptr<SetDict> dict;
+
+  TestSet(const std::vector<int64_t>& values, bool hashed) : is() {
+    if (hashed) {
+      dict.reset(new SetDict);
+      for (int64_t x : values)
+        dict->insert(std::to_string(x));
+    } else {
+      is = Intset::create();
+      for (int64_t x : values)
+        is.add(x);
+    }
+  }
+  ~TestSet() {
+    if (!dict)
+      is.destroy();
+  }
+};
+
+std::size_t intersectHash(SetDict& small, SetDict& big) {
+  std::size_t n = 0;
+  SetDict::Iterator it(&small);
+  while (SetDict::Entry* e = it.next()) {
+    if (big.find(Slice{e->key.data(), e->key.size()}))
+      ++n;
+  }
+  return n;
+}
+
+bool pickKernel(benchmark::State& state, int kind) {
+  if (kind == kHashSet)
+    return true;
+  const IntersectKernel kernel = kind == kIntsetAvx2
+                                     ? IntersectKernel::kAvx2
+                                     : IntersectKernel::kScalar;
+  if (!tinyredis::intersectKernels().force(kernel)) {
+    state.SkipWithError("kernel not supported");
+    return false;
+  }
+  state.SetLabel(tinyredis::intersectKernelName(kernel));
+  return true;
+}
+
+void BM_SetMemoryPerElement(benchmark::State& state) {
+  const bool hashed = state.range(0) == kHashSet;
+  const std::vector<int64_t> values = makeValues(1, 0);
+  double bytesPerElement = 0;
+  for (auto _ : state) {
+    const std::size_t before = tinyredis::allocatedBytes();
+    std::unique_ptr<TestSet> s(new TestSet(values, hashed));
+    bytesPerElement = static_cast<double>(tinyredis::allocatedBytes() -
+                                          before) /
+                      static_cast<double>(values.size());
+    state.PauseTiming();
+    s.reset();
+    state.ResumeTiming();
+  }
+  state.counters["bytes_per_element"] = bytesPerElement;
+}
+
+// SINTER 的计算部分：arg0 为实现，arg1 为小的一边的元素数（0 表示约 1M）。
+// 大的一边约 1M 个元素
+void BM_SetIntersect(benchmark::State& state) {
+  const int kind = static_cast<int>(state.range(0));
+  const IntersectKernel saved = tinyredis::intersectKernels().current();
+  if (!pickKernel(state, kind))
+    return;
+  const bool hashed = kind == kHashSet;
+  TestSet a(makeValues(2, static_cast<std::size_t>(state.range(1))), hashed);
+  TestSet b(makeValues(3, 0), hashed);
+  std::vector<int64_t> out;
+  if (!hashed)
+    out.resize(std::min(a.is.size(), b.is.size()));
+  std::size_t n = 0;
+  for (auto _ : state) {
+    if (hashed) {
+      n = intersectHash(*a.dict, *b.dict);
+    } else {
+      n = tinyredis::intersect(IntArray::of(a.is), IntArray::of(b.is),
+                               out.data(), 0);
+    }
+    benchmark::DoNotOptimize(n);
+  }
+  const std::size_t small = hashed ? a.dict->size() : a.is.size();
+  state.counters["result"] = static_cast<double>(n);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * small));
+  tinyredis::intersectKernels().force(saved);
+}
+
+BENCHMARK(BM_SetMemoryPerElement)
+    ->Arg(kIntsetScalar)
+    ->Arg(kHashSet)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SetIntersect)
+    ->ArgsProduct({{kIntsetScalar, kIntsetAvx2, kHashSet}, {0, 1000}})
+    ->Unit(benchmark::kMicrosecond);
+}  // namespace
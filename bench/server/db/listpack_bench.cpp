@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+#include <server/db/hashType.h>
+#include <server/util/memory.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using tinyredis::EncodingConfig;
+using tinyredis::Listpack;
+using tinyredis::Object;
+using tinyredis::Slice;
+namespace hashType = tinyredis::hashType;
+
+namespace {
+// 每组参数建这么多个 hash，按分配器总量的增长计算每个字段的平均内存
+const int kHashes = 10000;
+
+enum HashEncoding {
+  kListpack,
+  kHashTable,  // 写满后强制转换，对照完整结构
+};
+
+std::string fieldOf(int i) {
+  return "field:" + std::to_string(i);
+}
+
+std::string valueOf(int i) {
+  return "value:" + std::to_string(i * 7919);
+}
+
+Object makeHash(int fields, int encoding) {
+  EncodingConfig cfg;
+  Object o = hashType::create();
+  for (int i = 0; i < fields; ++i) {
+    const std::string f = fieldOf(i);
+    const std::string v = valueOf(i);
+    hashType::set(o, Slice{f.data(), f.size()}, Slice{v.data(), v.size()},
+                  cfg);
+  }
+  if (encoding == kHashTable)
+    hashType::convert(o);
+  return o;
+}
+
+void BM_HashMemoryPerField(benchmark::State& state) {
+  const int fields = static_cast<int>(state.range(0));
+  const int encoding = static_cast<int>(state.range(1));
+  double bytesPerField = 0;
+  for (auto _ : state) {
+    const std::size_t before = tinyredis::allocatedBytes();
+    std::vector<Object> hashes;
+    hashes.reserve(kHashes);
+    for (int i = 0; i < kHashes; ++i)
+      hashes.push_back(makeHash(fields, encoding));
+    bytesPerField = static_cast<double>(tinyredis::allocatedBytes() - before) /
+                    static_cast<double>(kHashes * fields);
+    state.PauseTiming();
+    hashes.clear();
+    state.ResumeTiming();
+  }
+  state.counters["bytes_per_field"] = bytesPerField;
+}
+
+// 轮流查找全部字段，listpack 为线性扫描，哈希表为一次探测
+void BM_HashGet(benchmark::State& state) {
+  const int fields = static_cast<int>(state.range(0));
+  Object o = makeHash(fields, static_cast<int>(state.range(1)));
+  std::vector<std::string> names;
+  for (int i = 0; i < fields; ++i)
+    names.push_back(fieldOf(i));
+
+  char buf[Listpack::kIntBufSize];
+  Slice v;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::string& f = names[i];
+    benchmark::DoNotOptimize(
+        hashType::get(o, Slice{f.data(), f.size()}, buf, &v));
+    benchmark::DoNotOptimize(v);
+    if (++i == names.size())
+      i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void sizes(benchmark::internal::Benchmark* b) {
+  for (int encoding : {kListpack, kHashTable}) {
+    for (int fields : {5, 20, 50, 128})
+      b->Args({fields, encoding});
+  }
+}
+
+BENCHMARK(BM_HashMemoryPerField)
+    ->Apply(sizes)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HashGet)->Apply(sizes);
+}  // namespace
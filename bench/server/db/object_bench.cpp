@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include <server/db/database.h>
+#include <server/util/memory.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+using tinyredis::Database;
+using tinyredis::KeyEqual;
+using tinyredis::KeyHash;
+using tinyredis::Object;
+
+namespace {
+// 对照：值直接存 std::string（引入编码之前的做法）
+using StringKeyspace =
+    tinyredis::HashTable<std::string, std::string, KeyHash, KeyEqual>;
+
+const uint64_t kKeys = 1000000;
+
+enum ValueKind {
+  kInteger,   // "123456"
+  kShort,     // 16 字节
+  kEmbedded,  // 40 字节，embstr 的上限附近
+  kLong,      // 100 字节
+};
+
+std::string valueOf(int kind, uint64_t i) {
+  switch (kind) {
+    case kInteger:
+      return std::to_string(i * 7919);
+    case kShort:
+      return std::string(16, 'v');
+    case kEmbedded:
+      return std::string(40, 'v');
+    default:
+      return std::string(100, 'v');
+  }
+}
+
+std::string keyOf(uint64_t i) {
+  char buf[32];
+  int n = std::snprintf(buf, sizeof(buf), "key:%012llu",
+                        static_cast<unsigned long long>(i));
+  return std::string(buf, static_cast<std::size_t>(n));
+}
+
+// 写入 kKeys 个键，以分配器总量的增长计算每个键的平均内存（键、值、表结构都算在内），
+// 与 MEMORY STATS 的 keys.bytes-per-key 口径相同
+template <typename Table, typename MakeValue>
+void fillAndMeasure(benchmark::State& state, MakeValue makeValue) {
+  const int kind = static_cast<int>(state.range(0));
+  double bytesPerKey = 0;
+  for (auto _ : state) {
+    const std::size_t before = tinyredis::allocatedBytes();
+    std::unique_ptr<Table> t(new Table);
+    for (uint64_t i = 0; i < kKeys; ++i) {
+      std::string v = valueOf(kind, i);
+      t->set(keyOf(i), makeValue(v));
+    }
+    while (t->rehash(1000)) {
+    }
+    bytesPerKey = static_cast<double>(tinyredis::allocatedBytes() - before) /
+                  static_cast<double>(kKeys);
+    state.PauseTiming();
+    t.reset();
+    state.ResumeTiming();
+  }
+  state.counters["bytes_per_key"] = bytesPerKey;
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kKeys));
+}
+
+void BM_ObjectMemoryPerKey(benchmark::State& state) {
+  fillAndMeasure<Database::Keyspace>(state, [](const std::string& v) {
+    return Object::fromString(v.data(), v.size());
+  });
+}
+
+void BM_StringMemoryPerKey(benchmark::State& state) {
+  fillAndMeasure<StringKeyspace>(state,
+                                 [](const std::string& v) { return v; });
+}
+
+void kinds(benchmark::internal::Benchmark* b) {
+  for (int kind : {kInteger, kShort, kEmbedded, kLong})
+    b->Arg(kind);
+  b->Iterations(1)->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_ObjectMemoryPerKey)->Apply(kinds);
+BENCHMARK(BM_StringMemoryPerKey)->Apply(kinds);
+}  // namespace
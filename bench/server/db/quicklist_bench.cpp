@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+#include <server/db/quicklist.h>
+#include <server/util/memory.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <string>
+
+using tinyredis::Quicklist;
+using tinyredis::Slice;
+
+namespace {
+const int kElements = 1000000;
+// list-max-listpack-size 的默认值
+const long long kFill = -2;
+
+enum ListKind {
+  kPlain,       // quicklist，不压缩
+  kCompressed,  // quicklist，list-compress-depth 1
+  kLinkedList,  // 对照：每个元素一个节点（引入 quicklist 之前 Redis 的做法）
+};
+
+// 队列中典型的消息：有重复的前缀和字段名
+std::string itemOf(int i) {
+  char buf[64];
+  int n = std::snprintf(buf, sizeof(buf), "{\"job\":%d,\"state\":\"queued\"}",
+                        i);
+  return std::string(buf, static_cast<std::size_t>(n));
+}
+
+std::unique_ptr<Quicklist> makeList(int kind, int n) {
+  std::unique_ptr<Quicklist> l(new Quicklist(kFill, kind == kCompressed));
+  for (int i = 0; i < n; ++i) {
+    const std::string v = itemOf(i);
+    l->push(Slice{v.data(), v.size()}, false);
+  }
+  return l;
+}
+
+void BM_ListMemoryPerElement(benchmark::State& state) {
+  const int kind = static_cast<int>(state.range(0));
+  double bytesPerElement = 0;
+  for (auto _ : state) {
+    const std::size_t before = tinyredis::allocatedBytes();
+    std::unique_ptr<Quicklist> l;
+    std::unique_ptr<std::list<std::string>> linked;
+    if (kind == kLinkedList) {
+      linked.reset(new std::list<std::string>);
+      for (int i = 0; i < kElements; ++i)
+        linked->push_back(itemOf(i));
+    } else {
+      l = makeList(kind, kElements);
+    }
+    bytesPerElement =
+        static_cast<double>(tinyredis::allocatedBytes() - before) / kElements;
+    state.PauseTiming();
+    l.reset();
+    linked.reset();
+    state.ResumeTiming();
+  }
+  state.counters["bytes_per_element"] = bytesPerElement;
+}
+
+// 队列：RPUSH 一个、LPOP 一个，长度保持在 kElements
+void BM_ListPushPop(benchmark::State& state) {
+  const int kind = static_cast<int>(state.range(0));
+  std::unique_ptr<Quicklist> l = makeList(kind, kElements);
+  const std::string v = itemOf(42);
+  std::string out;
+  for (auto _ : state) {
+    l->push(Slice{v.data(), v.size()}, false);
+    l->pop(true, &out);
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// LINDEX 随机位置：按节点计数跳到目标节点，压缩时还要解压该节点
+void BM_ListIndex(benchmark::State& state) {
+  const int kind = static_cast<int>(state.range(0));
+  std::unique_ptr<Quicklist> l = makeList(kind, kElements);
+  uint64_t x = 88172645463325252ULL;
+  std::string out;
+  for (auto _ : state) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    l->index(static_cast<long long>(x % kElements), &out);
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// LRANGE 中间的 100 个元素
+void BM_ListRange100(benchmark::State& state) {
+  const int kind = static_cast<int>(state.range(0));
+  std::unique_ptr<Quicklist> l = makeList(kind, kElements);
+  const std::size_t start = kElements / 2;
+  for (auto _ : state) {
+    std::size_t bytes = 0;
+    l->range(start, start + 99, [&bytes](const Slice& v) { bytes += v.len; });
+    benchmark::DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * 100);
+}
+
+BENCHMARK(BM_ListMemoryPerElement)
+    ->Arg(kPlain)
+    ->Arg(kCompressed)
+    ->Arg(kLinkedList)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ListPushPop)->Arg(kPlain)->Arg(kCompressed);
+BENCHMARK(BM_ListIndex)->Arg(kPlain)->Arg(kCompressed);
+BENCHMARK(BM_ListRange100)->Arg(kPlain)->Arg(kCompressed);
+}  // namespace
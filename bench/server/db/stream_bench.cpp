@@ -0,0 +1,216 @@
+#include <benchmark/benchmark.h>
+#include <server/db/stream.h>
+#include <server/util/memory.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using tinyredis::Slice;
+using tinyredis::Stream;
+using tinyredis::StreamConsumer;
+using tinyredis::StreamGroup;
+using tinyredis::StreamId;
+using tinyredis::StreamWaiter;
+
+namespace {
+const int kEntries = 1000000;
+// stream-node-max-bytes 与 stream-node-max-entries 的默认值
+const std::size_t kNodeMaxBytes = 4096;
+const std::size_t kNodeMaxEntries = 100;
+
+enum StreamKind {
+  kRadixListpack,  // stream：基数树 + 差值编码的 listpack 节点
+  kOrderedMap,     // 对照：每个条目一个节点，字段与值各一个 std::string
+};
+
+// 事件日志中典型的条目：固定的字段名，值是短字符串与整数
+struct Event {
+  std::string fields[6];
+  std::size_t payload;  // 字段与值的字节数
+};
+
+Event eventOf(int i) {
+  Event e;
+  char buf[32];
+  e.fields[0] = "type";
+  e.fields[1] = i % 3 == 0 ? "click" : "view";
+  e.fields[2] = "user";
+  e.fields[3] = std::to_string(100000 + i % 50000);
+  e.fields[4] = "page";
+  int n = std::snprintf(buf, sizeof(buf), "/item/%d", i % 977);
+  e.fields[5].assign(buf, static_cast<std::size_t>(n));
+  e.payload = 0;
+  for (const std::string& s : e.fields)
+    e.payload += s.size();
+  return e;
+}
+
+void appendEvent(Stream& s, const StreamId& id, const Event& e) {
+  Slice args[6];
+  for (int i = 0; i < 6; ++i)
+    args[i] = Slice{e.fields[i].data(), e.fields[i].size()};
+  s.append(id, args, 3, kNodeMaxBytes, kNodeMaxEntries);
+}
+
+// 每毫秒 10 个条目
+StreamId idOf(int i) {
+  return StreamId{1700000000000ull + static_cast<uint64_t>(i / 10),
+                  static_cast<uint64_t>(i % 10)};
+}
+
+using OrderedMap =
+    std::map<std::pair<uint64_t, uint64_t>, std::vector<std::string>>;
+
+void BM_StreamMemoryPerEntry(benchmark::State& state) {
+  const int kind = static_cast<int>(state.range(0));
+  double bytesPerEntry = 0;
+  double payloadPerEntry = 0;
+  for (auto _ : state) {
+    const std::size_t before = tinyredis::allocatedBytes();
+    std::unique_ptr<Stream> s;
+    std::unique_ptr<OrderedMap> m;
+    std::size_t payload = 0;
+    if (kind == kRadixListpack) {
+      s.reset(new Stream);
+      for (int i = 0; i < kEntries; ++i) {
+        const Event e = eventOf(i);
+        appendEvent(*s, idOf(i), e);
+        payload += e.payload;
+      }
+    } else {
+      m.reset(new OrderedMap);
+      for (int i = 0; i < kEntries; ++i) {
+        Event e = eventOf(i);
+        const StreamId id = idOf(i);
+        std::vector<std::string>& v = (*m)[std::make_pair(id.ms, id.seq)];
+        for (std::string& f : e.fields)
+          v.push_back(std::move(f));
+        payload += e.payload;
+      }
+    }
+    bytesPerEntry =
+        static_cast<double>(tinyredis::allocatedBytes() - before) / kEntries;
+    payloadPerEntry = static_cast<double>(payload) / kEntries;
+    state.PauseTiming();
+    s.reset();
+    m.reset();
+    state.ResumeTiming();
+  }
+  state.counters["bytes_per_entry"] = bytesPerEntry;
+  state.counters["payload_per_entry"] = payloadPerEntry;
+}
+
+// XADD MAXLEN ~ kEntries：长度保持在 kEntries 附近，裁剪每次整块删除头部节点
+void BM_StreamAddCapped(benchmark::State& state) {
+  Stream s;
+  int i = 0;
+  for (; i < kEntries; ++i)
+    appendEvent(s, idOf(i), eventOf(i));
+  const Event e = eventOf(42);
+  Stream::TrimArgs trim{Stream::TrimStrategy::kMaxLen, true, kEntries,
+                        StreamId{0, 0}, 10000};
+  for (auto _ : state) {
+    appendEvent(s, idOf(i++), e);
+    s.trim(trim);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// XRANGE start + COUNT n：定位一次，之后顺序读取节点
+void BM_StreamRangeScan(benchmark::State& state) {
+  const std::size_t count = static_cast<std::size_t>(state.range(0));
+  Stream s;
+  for (int i = 0; i < kEntries; ++i)
+    appendEvent(s, idOf(i), eventOf(i));
+  std::size_t bytes = 0;
+  int start = 0;
+  for (auto _ : state) {
+    Stream::Iterator it(s, idOf(start), StreamId::max(), false);
+    StreamId id;
+    for (std::size_t n = 0; n < count && it.next(&id); ++n) {
+      it.forEachField([&](const Slice& f, const Slice& v) {
+        bytes += f.len + v.len;
+        benchmark::DoNotOptimize(v.data);
+      });
+    }
+    start = (start + 7919) % (kEntries - static_cast<int>(count));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(count));
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+// 任务队列：一个组 200 个消费者，PEL 中保持 state.range(0) 个待确认条目，
+// 每次投递一个新条目并确认最早的一个（XREADGROUP + XACK 的 PEL 部分）
+const int kConsumers = 200;
+
+void BM_StreamGroupDeliverAck(benchmark::State& state) {
+  const int pending = static_cast<int>(state.range(0));
+  StreamGroup g(StreamId::min());
+  std::vector<StreamConsumer*> consumers;
+  bool created;
+  for (int i = 0; i < kConsumers; ++i)
+    consumers.push_back(g.createConsumer("worker:" + std::to_string(i),
+                                         &created));
+  int next = 0;
+  for (; next < pending; ++next)
+    g.deliver(idOf(next), consumers[next % kConsumers], 0);
+  int oldest = 0;
+  for (auto _ : state) {
+    g.deliver(idOf(next), consumers[next % kConsumers], 0);
+    ++next;
+    benchmark::DoNotOptimize(g.ack(idOf(oldest++)));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// 200 个消费者阻塞在同一个组上，每个新条目只唤醒队首的一个，
+// 被唤醒的消费者读完后重新排队
+class QueueWaiter : public StreamWaiter {
+ public:
+  QueueWaiter** woken = nullptr;
+
+ private:
+  bool _OnWake() override {
+    *woken = this;
+    return true;
+  }
+};
+
+void BM_StreamGroupWakeOne(benchmark::State& state) {
+  Stream s;
+  StreamGroup* g = s.createGroup("jobs", StreamId::min());
+  QueueWaiter* woken = nullptr;
+  std::vector<QueueWaiter> waiters(kConsumers);
+  for (auto& w : waiters) {
+    w.woken = &woken;
+    w.waitOn(g);
+  }
+  const Event e = eventOf(42);
+  int i = 0;
+  for (auto _ : state) {
+    appendEvent(s, idOf(i++), e);
+    s.signalWaiters();
+    g->setLastId(s.lastId());
+    woken->waitOn(g);
+  }
+  for (auto& w : waiters)
+    w.cancelWait();
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_StreamMemoryPerEntry)
+    ->Arg(kRadixListpack)
+    ->Arg(kOrderedMap)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StreamAddCapped);
+BENCHMARK(BM_StreamRangeScan)->Arg(10)->Arg(1000);
+BENCHMARK(BM_StreamGroupDeliverAck)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_StreamGroupWakeOne);
+}  // namespace
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include <server/db/database.h>
+#include <server/db/dict.h>
+#include <server/db/swissTable.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using tinyredis::Dict;
+using tinyredis::KeyEqual;
+using tinyredis::KeyHash;
+using tinyredis::SwissTable;
+
+namespace {
+using IntDict = Dict<uint64_t, uint64_t>;
+using IntSwiss = SwissTable<uint64_t, uint64_t>;
+using StringDict = Dict<std::string, std::string, KeyHash, KeyEqual>;
+using StringSwiss = SwissTable<std::string, std::string, KeyHash, KeyEqual>;
+
+// 存在的键取偶数位置、不存在的键取奇数位置，两者来自同一分布
+uint64_t keyOf(uint64_t i) {
+  return i * 0x9E3779B97F4A7C15ULL;
+}
+
+std::string stringKeyOf(uint64_t i) {
+  return "key:" + std::to_string(keyOf(i));
+}
+
+uint64_t xorshift(uint64_t& x) {
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return x;
+}
+
+// 每种表、每种大小只建一次
+template <typename Table>
+Table& prebuiltInt(uint64_t n) {
+  static uint64_t builtSize = 0;
+  static std::unique_ptr<Table> t;
+  if (builtSize != n) {
+    t.reset();
+    t.reset(new Table);
+    for (uint64_t i = 0; i < n; ++i)
+      t->set(keyOf(i * 2), i);
+    while (t->rehash(1000)) {
+    }
+    builtSize = n;
+  }
+  return *t;
+}
+
+template <typename Table>
+Table& prebuiltString(uint64_t n) {
+  static uint64_t builtSize = 0;
+  static std::unique_ptr<Table> t;
+  if (builtSize != n) {
+    t.reset();
+    t.reset(new Table);
+    for (uint64_t i = 0; i < n; ++i)
+      t->set(stringKeyOf(i * 2), std::string("v"));
+    while (t->rehash(1000)) {
+    }
+    builtSize = n;
+  }
+  return *t;
+}
+
+// hitPercent 为命中比例：100 为纯命中的读多负载，0 为纯未命中（例如缓存穿透）
+template <typename Table>
+void BM_IntLookup(benchmark::State& state) {
+  const uint64_t n = static_cast<uint64_t>(state.range(0));
+  const uint64_t hitPercent = static_cast<uint64_t>(state.range(1));
+  Table& t = prebuiltInt<Table>(n);
+  uint64_t x = 88172645463325252ULL;
+  for (auto _ : state) {
+    const uint64_t r = xorshift(x);
+    const uint64_t i = (r >> 8) % n * 2 + ((r & 0xFF) % 100 >= hitPercent);
+    benchmark::DoNotOptimize(t.find(keyOf(i)));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// 字符串键，键预先生成好，只测查找本身
+template <typename Table>
+void BM_StringLookup(benchmark::State& state) {
+  const uint64_t n = static_cast<uint64_t>(state.range(0));
+  const uint64_t hitPercent = static_cast<uint64_t>(state.range(1));
+  Table& t = prebuiltString<Table>(n);
+  const std::size_t kProbes = 1 << 16;
+  std::vector<std::string> probes;
+  probes.reserve(kProbes);
+  uint64_t x = 88172645463325252ULL;
+  for (std::size_t k = 0; k < kProbes; ++k) {
+    const uint64_t r = xorshift(x);
+    probes.push_back(
+        stringKeyOf((r >> 8) % n * 2 + ((r & 0xFF) % 100 >= hitPercent)));
+  }
+  std::size_t k = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(t.find(probes[k]));
+    k = (k + 1) & (kProbes - 1);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void intArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t n : {100000, 10000000}) {
+    for (int64_t hit : {100, 0})
+      b->Args({n, hit});
+  }
+}
+
+void stringArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t hit : {100, 0})
+    b->Args({1000000, hit});
+}
+
+BENCHMARK_TEMPLATE(BM_IntLookup, IntDict)->Apply(intArgs);
+BENCHMARK_TEMPLATE(BM_IntLookup, IntSwiss)->Apply(intArgs);
+BENCHMARK_TEMPLATE(BM_StringLookup, StringDict)->Apply(stringArgs);
+BENCHMARK_TEMPLATE(BM_StringLookup, StringSwiss)->Apply(stringArgs);
+}  // namespace
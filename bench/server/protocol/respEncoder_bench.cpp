@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+#include <base/socket/streamSocket.h>
+#include <server/protocol/respEncoder.h>
+#include <server/protocol/respShared.h>
+
+#include <cstdio>
+
+using tinyredis::RespEncoder;
+
+namespace {
+// 回复只写进发送缓冲区，定期丢弃，不涉及系统调用
+class NullSocket : public StreamSocket {
+ public:
+  void discard() {
+    BufferSequence bf;
+    for (sendBuf_.processBuffer(bf); bf.totalBytes() > 0;
+         sendBuf_.processBuffer(bf))
+      sendBuf_.skip(bf.totalBytes());
+  }
+};
+
+const int kBatch = 1000;
+
+// 改动前的做法：每个回复都用 snprintf 现场格式化
+void snprintfInteger(StreamSocket& sock, long long v) {
+  char buf[32];
+  int n = std::snprintf(buf, sizeof(buf), ":%lld\r\n", v);
+  sock.sendPacket(buf, static_cast<std::size_t>(n));
+}
+
+// 逐位取余的十进制转换
+char* naiveDecimal(char* end, long long v) {
+  unsigned long long u = v < 0 ? 0ULL - static_cast<unsigned long long>(v)
+                               : static_cast<unsigned long long>(v);
+  char* p = end;
+  do {
+    *--p = static_cast<char>('0' + u % 10);
+    u /= 10;
+  } while (u);
+  if (v < 0)
+    *--p = '-';
+  return p;
+}
+}  // namespace
+
+// arg 为整数的起点：0 落在共享缓存内，1e12 需要格式化
+static void BM_ReplyIntegerSnprintf(benchmark::State& state) {
+  NullSocket sock;
+  const long long base = state.range(0);
+  for (auto _ : state) {
+    for (int i = 0; i < kBatch; ++i)
+      snprintfInteger(sock, base + i);
+    sock.discard();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kBatch);
+}
+BENCHMARK(BM_ReplyIntegerSnprintf)->Arg(0)->Arg(1000000000000LL);
+
+static void BM_ReplyIntegerEncoder(benchmark::State& state) {
+  NullSocket sock;
+  RespEncoder enc(&sock);
+  const long long base = state.range(0);
+  for (auto _ : state) {
+    for (int i = 0; i < kBatch; ++i)
+      enc.integer(base + i);
+    sock.discard();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kBatch);
+}
+BENCHMARK(BM_ReplyIntegerEncoder)->Arg(0)->Arg(1000000000000LL);
+
+// 常量回复：现场格式化与引用共享回复
+static void BM_ReplyOkFormatted(benchmark::State& state) {
+  NullSocket sock;
+  RespEncoder enc(&sock);
+  for (auto _ : state) {
+    for (int i = 0; i < kBatch; ++i)
+      enc.simpleString("OK", 2);
+    sock.discard();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kBatch);
+}
+BENCHMARK(BM_ReplyOkFormatted);
+
+static void BM_ReplyOkShared(benchmark::State& state) {
+  NullSocket sock;
+  RespEncoder enc(&sock);
+  for (auto _ : state) {
+    for (int i = 0; i < kBatch; ++i)
+      enc.raw(tinyredis::shared::kOk);
+    sock.discard();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kBatch);
+}
+BENCHMARK(BM_ReplyOkShared);
+
+// 只比较整数转换本身
+static void BM_FormatDecimalNaive(benchmark::State& state) {
+  char buf[32];
+  long long v = state.range(0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(naiveDecimal(buf + sizeof(buf), v));
+    ++v;
+  }
+}
+BENCHMARK(BM_FormatDecimalNaive)->Arg(12345)->Arg(1234567890123456LL);
+
+static void BM_FormatDecimalLut(benchmark::State& state) {
+  char buf[32];
+  long long v = state.range(0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tinyredis::formatDecimal(buf + sizeof(buf), v));
+    ++v;
+  }
+}
+BENCHMARK(BM_FormatDecimalLut)->Arg(12345)->Arg(1234567890123456LL);
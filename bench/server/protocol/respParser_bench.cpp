@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+#include <server/protocol/respParser.h>
+
+#include <algorithm>
+#include <string>
+
+using tinyredis::RespParser;
+
+namespace {
+std::string makeSet(std::size_t valueLen) {
+  std::string value(valueLen, 'v');
+  return "*3\r\n$3\r\nSET\r\n$10\r\nkey:000001\r\n$" + std::to_string(valueLen) +
+         "\r\n" + value + "\r\n";
+}
+
+// 把同一个请求重复到约 1MB，模拟流水线
+std::string makePipeline(std::size_t valueLen) {
+  const std::string one = makeSet(valueLen);
+  std::string out;
+  while (out.size() < 1024 * 1024)
+    out += one;
+  return out;
+}
+}  // namespace
+
+// 连续内存上的解析吞吐，arg 为 value 长度
+static void BM_RespParsePipeline(benchmark::State& state) {
+  const std::string buf = makePipeline(static_cast<std::size_t>(state.range(0)));
+  RespParser parser;
+  for (auto _ : state) {
+    std::size_t off = 0;
+    while (off < buf.size()) {
+      std::size_t consumed = 0;
+      parser.parse(buf.data() + off, buf.size() - off, consumed);
+      benchmark::DoNotOptimize(parser.args().data());
+      parser.reset();
+      off += consumed;
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(buf.size()));
+}
+BENCHMARK(BM_RespParsePipeline)->Arg(8)->Arg(64)->Arg(16 * 1024)->Arg(1 << 20);
+
+// 数据按 1460 字节（一个 TCP 段）到达，每次都从帧首续传
+static void BM_RespParseSegmented(benchmark::State& state) {
+  const std::string buf = makePipeline(static_cast<std::size_t>(state.range(0)));
+  const std::size_t kSegment = 1460;
+  RespParser parser;
+  for (auto _ : state) {
+    std::size_t frame = 0;  // 当前帧的起始
+    std::size_t avail = 0;  // 已到达的数据
+    while (frame < buf.size()) {
+      avail = std::min(buf.size(), avail + kSegment);
+      for (;;) {
+        std::size_t consumed = 0;
+        auto r = parser.parse(buf.data() + frame, avail - frame, consumed);
+        if (r != RespParser::Result::kOk)
+          break;
+        benchmark::DoNotOptimize(parser.args().data());
+        parser.reset();
+        frame += consumed;
+      }
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(buf.size()));
+}
+BENCHMARK(BM_RespParseSegmented)->Arg(8)->Arg(16 * 1024);
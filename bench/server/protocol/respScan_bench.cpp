@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <server/protocol/respParser.h>
+#include <server/protocol/respScan.h>
+
+#include <cstring>
+#include <string>
+
+using tinyredis::RespParser;
+using tinyredis::ScanKernel;
+
+namespace {
+// 混合长短参数的 SET，接近真实流水线里的请求
+std::string makePipeline(std::size_t commands) {
+  std::string out;
+  for (std::size_t i = 0; i < commands; ++i) {
+    std::string key = "key:" + std::to_string(i);
+    std::string value((i % 4 == 0) ? 256 : 16, 'v');
+    out += "*3\r\n$3\r\nSET\r\n$" + std::to_string(key.size()) + "\r\n" + key +
+           "\r\n$" + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+  }
+  return out;
+}
+}  // namespace
+
+// 整条流水线解析一遍，arg0 为内核，arg1 为命令数
+static void BM_RespScanPipeline(benchmark::State& state) {
+  const ScanKernel saved = tinyredis::scanKernels().current();
+  const ScanKernel kernel = static_cast<ScanKernel>(state.range(0));
+  if (!tinyredis::scanKernels().force(kernel)) {
+    state.SkipWithError("kernel not supported");
+    return;
+  }
+  state.SetLabel(tinyredis::scanKernelName(kernel));
+
+  const std::string buf =
+      makePipeline(static_cast<std::size_t>(state.range(1)));
+  RespParser parser;
+  for (auto _ : state) {
+    std::size_t off = 0;
+    while (off < buf.size()) {
+      std::size_t consumed = 0;
+      parser.parse(buf.data() + off, buf.size() - off, consumed);
+      benchmark::DoNotOptimize(parser.args().data());
+      parser.reset();
+      off += consumed;
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(1));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(buf.size()));
+  tinyredis::scanKernels().force(saved);
+}
+BENCHMARK(BM_RespScanPipeline)
+    ->ArgsProduct({{static_cast<int64_t>(ScanKernel::kScalar),
+                    static_cast<int64_t>(ScanKernel::kLibc),
+                    static_cast<int64_t>(ScanKernel::kSse2),
+                    static_cast<int64_t>(ScanKernel::kAvx2)},
+                   {1, 10, 100, 1000}});
+
+// 只测长度字段的解析
+static void BM_RespParseDecimal(benchmark::State& state) {
+  const char* lens[] = {"3", "16", "256", "4096", "65536", "1048576"};
+  for (auto _ : state) {
+    for (const char* s : lens) {
+      long long v = 0;
+      tinyredis::parseDecimal(s, std::strlen(s), v);
+      benchmark::DoNotOptimize(v);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 6);
+}
+BENCHMARK(BM_RespParseDecimal);
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include <server/util/bitops.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using tinyredis::BitKernel;
+using tinyredis::BitOp;
+
+namespace {
+// 16MB 的位图，远大于末级缓存
+const std::size_t kBitmapBytes = 16 * 1024 * 1024;
+
+std::vector<unsigned char> randomBitmap(uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<unsigned char> v(kBitmapBytes);
+  for (unsigned char& b : v)
+    b = static_cast<unsigned char>(rng());
+  return v;
+}
+
+bool pickKernel(benchmark::State& state) {
+  const BitKernel kernel = static_cast<BitKernel>(state.range(0));
+  if (!tinyredis::bitKernels().force(kernel)) {
+    state.SkipWithError("kernel not supported");
+    return false;
+  }
+  state.SetLabel(tinyredis::bitKernelName(kernel));
+  return true;
+}
+}  // namespace
+
+// BITCOUNT 整个位图，arg0 为内核
+static void BM_BitCount(benchmark::State& state) {
+  const BitKernel saved = tinyredis::bitKernels().current();
+  if (!pickKernel(state))
+    return;
+  const std::vector<unsigned char> bitmap = randomBitmap(1);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(tinyredis::popcount(bitmap.data(), kBitmapBytes));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(kBitmapBytes));
+  tinyredis::bitKernels().force(saved);
+}
+BENCHMARK(BM_BitCount)
+    ->Arg(static_cast<int64_t>(BitKernel::kScalar))
+    ->Arg(static_cast<int64_t>(BitKernel::kPopcnt))
+    ->Arg(static_cast<int64_t>(BitKernel::kAvx2))
+    ->Unit(benchmark::kMicrosecond);
+
+// BITPOS key 1：只有最后一个字节不为 0，扫描整个位图。
+// popcnt 内核只影响计数，这里与 BITOP 只比较标量与 AVX2
+static void BM_BitPos(benchmark::State& state) {
+  const BitKernel saved = tinyredis::bitKernels().current();
+  if (!pickKernel(state))
+    return;
+  std::vector<unsigned char> bitmap(kBitmapBytes);
+  bitmap.back() = 1;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        tinyredis::findByteNot(bitmap.data(), kBitmapBytes, 0x00));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(kBitmapBytes));
+  tinyredis::bitKernels().force(saved);
+}
+BENCHMARK(BM_BitPos)
+    ->Arg(static_cast<int64_t>(BitKernel::kScalar))
+    ->Arg(static_cast<int64_t>(BitKernel::kAvx2))
+    ->Unit(benchmark::kMicrosecond);
+
+// BITOP AND dest a b c：三个源，按读取的源字节计算吞吐
+static void BM_BitOpAnd(benchmark::State& state) {
+  const BitKernel saved = tinyredis::bitKernels().current();
+  if (!pickKernel(state))
+    return;
+  const std::vector<unsigned char> a = randomBitmap(2);
+  const std::vector<unsigned char> b = randomBitmap(3);
+  const std::vector<unsigned char> c = randomBitmap(4);
+  const void* srcs[] = {a.data(), b.data(), c.data()};
+  const std::size_t lens[] = {kBitmapBytes, kBitmapBytes, kBitmapBytes};
+  std::vector<unsigned char> dst(kBitmapBytes);
+  for (auto _ : state) {
+    tinyredis::bitop(BitOp::kAnd, dst.data(), kBitmapBytes, srcs, lens, 3);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * 3 *
+                          static_cast<int64_t>(kBitmapBytes));
+  tinyredis::bitKernels().force(saved);
+}
+BENCHMARK(BM_BitOpAnd)
+    ->Arg(static_cast<int64_t>(BitKernel::kScalar))
+    ->Arg(static_cast<int64_t>(BitKernel::kAvx2))
+    ->Unit(benchmark::kMicrosecond);
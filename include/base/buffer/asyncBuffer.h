@@ -15,8 +15,10 @@ class AsyncBuffer {
   void write(const BufferSequence& data);
   void processBuffer(BufferSequence& data);
   void skip(std::size_t size);
+  bool isEmpty() const;
 
  private:
+  const std::size_t size_;  // 主缓冲区容量，第一次写入时分配
   BUFFER buffer_;
   tinyredis::UnboundedBuffer tmpBuffer_;
 
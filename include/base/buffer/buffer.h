@@ -2,6 +2,7 @@
 #define BASE_BUFFER_BUFFER_H
 
 #include <sys/uio.h>
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstddef>
@@ -47,7 +48,7 @@ class CircularBuffer {
   CircularBuffer(char*, std::size_t);
   ~CircularBuffer() {}
 
-  bool isEmpty() const { return readPos_ = writePos_; }
+  bool isEmpty() const { return readPos_ == writePos_; }
 
   // (writePos_ + 1) & (maxSize_ - 1) 相当于取模了，因为maxSize_ - 1为全1
   // maxSize_是2的n次方，如8，那8-1为7（111）
@@ -74,6 +75,12 @@ class CircularBuffer {
 
   std::size_t capacity() const { return maxSize_; }
   void initCapacity(std::size_t size);
+  // 扩容到不小于 size，已有数据挪到开头（只用于自己管理内存的 BUFFER）
+  void expand(std::size_t size);
+  // 收缩到 size（向上取 2 的幂），已有数据必须放得下（只用于自己管理内存的 BUFFER）
+  void shrink(std::size_t size);
+  // 不扩容，原地把已有数据挪到开头，使其连续（只用于自己管理内存的 BUFFER）
+  void linearize();
 
   template <typename T>
   CircularBuffer& operator<<(const T& data);
@@ -92,6 +99,9 @@ class CircularBuffer {
   std::size_t maxSize_;
 
  private:
+  // 换一块 newSize 的内存，已有数据挪到开头
+  void _Reallocate(std::size_t newSize);
+
   BUFFER buffer_;
   std::atomic<std::size_t> readPos_;   // 可以读的开始处
   std::atomic<std::size_t> writePos_;  // 可以写的开始处
@@ -303,6 +313,54 @@ void CircularBuffer<BUFFER>::initCapacity(std::size_t size) {
   std::vector<char>(buffer_).swap(buffer_);
 }
 
+template <typename BUFFER>
+void CircularBuffer<BUFFER>::expand(std::size_t size) {
+  const std::size_t newSize = roundUp2Power(size);
+  if (newSize <= maxSize_)
+    return;
+  _Reallocate(newSize);
+}
+
+template <typename BUFFER>
+void CircularBuffer<BUFFER>::shrink(std::size_t size) {
+  const std::size_t newSize = roundUp2Power(size);
+  if (newSize >= maxSize_ || readableSize() >= newSize)
+    return;
+  _Reallocate(newSize);
+}
+
+template <typename BUFFER>
+void CircularBuffer<BUFFER>::_Reallocate(std::size_t newSize) {
+  BUFFER tmp(newSize);
+  const std::size_t n = readableSize();
+  if (n > 0) {
+    BufferSequence bf;
+    getDatum(bf, n);
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < bf.count; ++i) {
+      ::memcpy(&tmp[offset], bf.buffers[i].iov_base, bf.buffers[i].iov_len);
+      offset += bf.buffers[i].iov_len;
+    }
+  }
+  buffer_.swap(tmp);
+  maxSize_ = newSize;
+  readPos_ = 0;
+  writePos_ = n;
+}
+
+template <typename BUFFER>
+void CircularBuffer<BUFFER>::linearize() {
+  const std::size_t readPos = readPos_;
+  if (readPos == 0)
+    return;
+
+  // 整体旋转后 [readPos, 末尾) 到了开头，绕圈的 [0, writePos) 紧接在后面
+  const std::size_t n = readableSize();
+  std::rotate(buffer_.begin(), buffer_.begin() + readPos, buffer_.end());
+  readPos_ = 0;
+  writePos_ = n;
+}
+
 template <typename BUFFER>
 template <typename T>
 inline CircularBuffer<BUFFER>& CircularBuffer<BUFFER>::operator<<(
@@ -347,7 +405,7 @@ inline BUFFER::CircularBuffer(std::size_t maxSize)
     : maxSize_(roundUp2Power(maxSize)),
       readPos_(0),
       writePos_(0),
-      buffer_(maxSize) {
+      buffer_(maxSize_) {
   assert(0 == (maxSize_ & (maxSize_ - 1)) && "maxSize_ MUST BE power of 2");
 }
 
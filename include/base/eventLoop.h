@@ -0,0 +1,108 @@
+#ifndef BASE_EVENTLOOP_H
+#define BASE_EVENTLOOP_H
+
+#include <base/poll/poller.h>
+#include <base/socket/listenSocket.h>
+#include <base/taskManager.h>
+#include <base/thread/sendThread.h>
+#include <base/timer/timingWheel.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Server;
+
+namespace Internal {
+// 每个事件循环的统计，循环线程写，其他线程只读
+struct LoopStats {
+  std::atomic<uint64_t> accepted{0};    // 累计接受的连接
+  std::atomic<uint64_t> closed{0};      // 累计关闭的连接
+  std::atomic<uint64_t> iterations{0};  // 循环次数
+  std::atomic<uint64_t> events{0};      // poller 返回的事件数
+  std::atomic<uint64_t> bytesIn{0};     // 读到的字节数
+  std::atomic<uint64_t> bytesOut{0};    // 写出的字节数
+  std::atomic<uint64_t> writevCalls{0};  // writev 调用次数
+  std::atomic<uint64_t> batches{0};      // 处理了请求的解析轮数（按连接计）
+  std::atomic<uint64_t> commands{0};     // 处理的请求数
+  std::atomic<uint64_t> zeroCopySends{0};      // MSG_ZEROCOPY 发送次数
+  std::atomic<uint64_t> zeroCopyBytes{0};      // 零拷贝发送的字节数
+  std::atomic<uint64_t> zeroCopyCopied{0};     // 内核退化为拷贝的完成通知数
+  std::atomic<uint64_t> zeroCopyFallbacks{0};  // 走了拷贝路径的大回复
+};
+
+class Waker;
+
+// 一个线程一个事件循环（multi-reactor）：
+// 每个循环拥有自己的 Poller、TaskManager 和监听同一端口的 ListenSocket(SO_REUSEPORT)，
+// 新连接由内核分到某个循环后就只在该线程上处理，StreamSocket 永远不跨线程。
+// 其他线程需要操作某个连接时（例如唤醒阻塞的客户端）用 post() 把任务交给它的循环。
+class EventLoop {
+ public:
+  EventLoop(Server* server, std::size_t index);
+  ~EventLoop();
+
+  EventLoop(const EventLoop&) = delete;
+  void operator=(const EventLoop&) = delete;
+
+  bool listen(const SocketAddr& addr, int tag);
+  void start();  // 启动线程
+  void stop();   // 通知退出并等待线程结束
+
+  // 可以在任意线程调用：task 在循环线程上、本轮处理连接之前执行；
+  // 循环正在 poll 中等待时由 eventfd 唤醒，不依赖轮询间隔
+  void post(std::function<void()> task);
+
+  // 以下只能在循环线程上调用
+  // 为已接受的 fd 创建连接并注册到 poller，失败返回空（fd 已被关闭）；
+  // 调用方负责把连接交给 TaskManager
+  std::shared_ptr<StreamSocket> newConnection(int connfd,
+                                              const SocketAddr& peer, int tag);
+  void unregisterSocket(Socket* sock);
+
+  std::size_t index() const { return index_; }
+  Poller* poller() const { return poller_.get(); }
+  TaskManager& taskManager() { return taskManager_; }
+  SendThread& sendThread() { return sendThread_; }
+  TimingWheel& timers() { return timers_; }
+  LoopStats& stats() { return stats_; }
+  const LoopStats& stats() const { return stats_; }
+
+  static const std::size_t kMaxEvents;
+
+  // 单调时钟的毫秒数，定时器以此为时间基准
+  static uint64_t nowMs();
+
+ private:
+  void _Run();
+  void _Dispatch(const FiredEvent& ev);
+  void _Complete(const Completion& c);
+  void _RunPosted();
+  static bool _HasSocketError(int sock);
+
+  Server* const server_;
+  const std::size_t index_;
+  std::unique_ptr<Poller> poller_;
+  TaskManager taskManager_;
+  SendThread sendThread_;
+  TimingWheel timers_;
+  std::vector<std::shared_ptr<ListenSocket>> listenSockets_;
+  std::vector<FiredEvent> firedEvents_;
+
+  std::unique_ptr<Waker> waker_;
+  std::mutex postedLock_;
+  std::vector<std::function<void()>> posted_;
+  // 取出来正在执行的一批，只在循环线程上访问，复用容量
+  std::vector<std::function<void()>> runningTasks_;
+
+  std::thread thread_;
+  std::atomic<bool> running_;
+  LoopStats stats_;
+};
+}  // namespace Internal
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef BASE_POLL_EPOLL_H
+#define BASE_POLL_EPOLL_H
+
+#include <base/poll/poller.h>
+#include <vector>
+
+#if defined(__linux__)
+
+#include <sys/epoll.h>
+
+class Epoll : public Poller {
+ public:
+  // edgeTriggered 为 true 时所有套接字以 EPOLLET 方式注册，
+  // 调用方必须在一次读/写事件中把数据读空/写满直到 EAGAIN
+  explicit Epoll(bool edgeTriggered = false);
+  ~Epoll();
+
+  bool addSocket(int sock, int events, void* userPtr) override;
+  bool modSocket(int sock, int events, void* userPtr) override;
+  bool delSocket(int sock, int events) override;
+
+  int poll(std::vector<FiredEvent>& events, std::size_t maxEv,
+           int timeOutMs) override;
+
+  bool edgeTriggered() const { return edgeTriggered_; }
+
+ private:
+  uint32_t _ToEpollEvents(int events) const;
+
+  const bool edgeTriggered_;
+  std::vector<epoll_event> events_;  // 只增不减，避免每次 poll 重新分配
+};
+
+#endif  // __linux__
+#endif
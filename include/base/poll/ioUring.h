@@ -0,0 +1,153 @@
+#ifndef BASE_POLL_IOURING_H
+#define BASE_POLL_IOURING_H
+
+#include <base/buffer/buffer.h>
+#include <base/poll/poller.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// 就绪通知需要 5.13+ 的内核头文件（multishot poll 与原地更新事件掩码），
+// 完成模型需要 6.0+（multishot recv、provided buffer ring 与 SEND_ZC）
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#if defined(IORING_POLL_ADD_MULTI) && defined(IORING_POLL_UPDATE_EVENTS)
+#define TINYREDIS_HAVE_IO_URING 1
+#if defined(IORING_RECV_MULTISHOT) && defined(IORING_ACCEPT_MULTISHOT) && \
+    defined(IORING_CQE_F_NOTIF)
+#define TINYREDIS_HAVE_IO_URING_COMPLETION 1
+#endif
+#endif
+#endif
+#endif
+
+#if defined(TINYREDIS_HAVE_IO_URING)
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+// 基于 io_uring 的 Poller，不依赖 liburing，直接使用系统调用和 mmap 的环形队列。
+//
+// 两种用法可以混用：
+// 1. 就绪通知：addSocket/modSocket/delSocket 提交、修改、撤销 multishot POLL_ADD，
+//    poll() 把完成事件转换成 FiredEvent。语义与边沿触发相同，调用方必须读/写到 EAGAIN。
+// 2. 完成模型（内核支持时 completionBased() 为 true）：
+//    submitAccept/submitRecv 提交 multishot accept 与 recv（数据放在内核从
+//    provided buffer ring 中选出的缓冲区里），submitSend 以 sendmsg 发送
+//    BufferSequence 的全部 iovec，zeroCopy 时（只能有一段）用 SEND_ZC，
+//    owner 一直保留到内核发来不再引用数据的通知。结果经 completions() 取出。
+//    multishot 请求被内核终止时透明地重新提交；delSocket 取消该 fd 上的全部请求。
+// 所有提交都先缓存在 SQ 里，到下一次 poll() 时用一次 io_uring_enter 批量提交并等待，
+// 一轮循环里成千上万个连接的收发只需要一次系统调用。
+class IoUring : public Poller {
+ public:
+  explicit IoUring(unsigned entries = 4096, unsigned bufferCount = 1024,
+                   unsigned bufferSize = 16 * 1024);
+  ~IoUring();
+
+  // 运行时探测内核是否支持就绪通知用到的特性
+  static bool isSupported();
+
+  bool addSocket(int sock, int events, void* userPtr) override;
+  bool modSocket(int sock, int events, void* userPtr) override;
+  bool delSocket(int sock, int events) override;
+
+  int poll(std::vector<FiredEvent>& events, std::size_t maxEv,
+           int timeOutMs) override;
+
+  bool completionBased() const override { return completion_; }
+  bool submitAccept(int listenSock, void* userPtr) override;
+  bool submitRecv(int sock, void* userPtr) override;
+  bool cancelRecv(int sock) override;
+  bool submitSend(int sock, const BufferSequence& data,
+                  const std::shared_ptr<const void>& owner, bool zeroCopy,
+                  void* userPtr) override;
+
+  // io_uring_enter 的调用次数，基准测试用来统计每个请求的系统调用数
+  std::size_t enterCalls() const { return enterCalls_; }
+
+ private:
+  enum class OpType : uint8_t { Poll, Accept, Recv, Send };
+
+  struct Request {
+    OpType op;
+    int sock;
+    void* userdata;
+    int events;  // 仅 poll 使用，multishot 被终止时用来重新注册
+    bool cancelled;
+    bool stopping;  // 仅 recv：cancelRecv 已取消，不再重新提交，数据照常交出
+    // 仅 send 使用：内核在完成前可能异步读取 msg、iov 与数据
+    std::shared_ptr<const void> owner;
+    msghdr msg;
+    iovec iov[BufferSequence::kMaxIovec];
+  };
+
+  Request* _NewRequest(OpType op, int sock, void* userPtr);
+  void _FreeRequest(Request* req);
+  void _Cancel(Request* req);
+  void _SubmitCancel(Request* req);
+  bool _SubmitAccept(Request* req);
+  bool _SubmitRecv(Request* req);
+  io_uring_sqe* _GetSqe();
+  unsigned _Flush();
+  void _Cleanup();
+  int _Enter(unsigned toSubmit, unsigned minComplete, unsigned flags,
+             int timeoutMs);
+  void _SetupRings(unsigned entries);
+  bool _ProbeCompletion();
+  bool _SetupBufferRing(unsigned bufferCount, unsigned bufferSize);
+  void _PushBuffer(uint16_t bufferId);
+  void _Reap(std::vector<FiredEvent>& firedEvents, std::size_t maxEvent);
+  void _ReapPoll(Request* req, const io_uring_cqe& cqe, bool more,
+                 std::vector<FiredEvent>& firedEvents);
+  void _ReapIo(Request* req, const io_uring_cqe& cqe, bool more);
+
+  // SQ / CQ 环形队列（mmap 到用户态）
+  unsigned* sqHead_{nullptr};
+  unsigned* sqTail_{nullptr};
+  unsigned* sqMask_{nullptr};
+  unsigned* sqArray_{nullptr};
+  unsigned sqEntries_{0};
+  unsigned sqLocalTail_{0};  // 已填写但还未发布给内核的 sqe
+  io_uring_sqe* sqes_{nullptr};
+
+  unsigned* cqHead_{nullptr};
+  unsigned* cqTail_{nullptr};
+  unsigned* cqMask_{nullptr};
+  io_uring_cqe* cqes_{nullptr};
+
+  void* sqRingPtr_{nullptr};
+  std::size_t sqRingSize_{0};
+  void* cqRingPtr_{nullptr};
+  std::size_t cqRingSize_{0};
+  std::size_t sqesSize_{0};
+
+  bool completion_{false};
+
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+  // provided buffer ring：recv 的数据只在下一次 poll() 之前有效，
+  // 之后缓冲区统一归还给内核
+  io_uring_buf_ring* bufRing_{nullptr};
+  std::size_t bufRingSize_{0};
+  unsigned bufMask_{0};
+  unsigned bufSize_{0};
+  std::vector<char> bufPool_;
+  std::vector<uint16_t> usedBuffers_;
+#endif
+
+  // 每个 sock 上仍在进行中的请求，用于 delSocket 时屏蔽后续事件
+  struct SockState {
+    Request* poll{nullptr};
+    std::vector<Request*> inflight;
+  };
+  std::unordered_map<int, SockState> socks_;
+  std::vector<Request*> freeRequests_;
+
+  std::size_t enterCalls_{0};
+};
+
+#endif  // TINYREDIS_HAVE_IO_URING
+#endif
@@ -6,6 +6,8 @@
 
 #if defined(__APPLE__)
 
+#include <sys/event.h>
+
 class Kqueue : public Poller {
  public:
   Kqueue();
@@ -3,6 +3,9 @@
 
 #include <vector>
 #include <cstddef>
+#include <memory>
+
+struct BufferSequence;
 
 enum class EventType {
   Read  = 0x1,
@@ -15,6 +18,16 @@ struct FiredEvent {
   void* userdata{nullptr};
 };
 
+// 完成模型下内核已经做完的一次 IO
+struct Completion {
+  enum class Op { Accept, Recv, Send };
+
+  Op op{Op::Recv};
+  int result{0};  // accept: 新连接 fd；recv/send: 字节数；< 0 为 -errno
+  void* userdata{nullptr};
+  const char* data{nullptr};  // 仅 recv：收到的数据，到下一次 poll() 之前有效
+};
+
 class Poller {
  public:
   Poller() = default;
@@ -22,13 +35,43 @@ class Poller {
 
   virtual bool addSocket(int sock, int events, void* userPtr) = 0;
   virtual bool modSocket(int sock, int events, void* userPtr) = 0;
+  // 完成模型下同时取消 sock 上所有未完成的 IO，之后不会再有它的完成事件
   virtual bool delSocket(int sock, int events) = 0;
 
   virtual int poll(std::vector<FiredEvent>& events, std::size_t maxEv,
                    int timeOutMs) = 0;
 
+  // 完成模型：accept/recv/send 直接交给内核去做，结果在 poll() 返回后
+  // 从 completions() 取出，调用方不再自己 accept/readv/writev。
+  // 只有 io_uring 支持，其他后端 completionBased() 为 false，
+  // 调用方继续使用就绪通知。
+  virtual bool completionBased() const { return false; }
+  // 持续接受新连接，新连接已设置 SOCK_NONBLOCK | SOCK_CLOEXEC
+  virtual bool submitAccept(int listenSock, void* userPtr);
+  // 持续接收，有数据就产生一个完成事件
+  virtual bool submitRecv(int sock, void* userPtr);
+  // 停止 submitRecv 的持续接收，不影响 sock 上的发送；取消之前已收到的数据
+  // 照常作为完成事件交出，之后可以再次 submitRecv
+  virtual bool cancelRecv(int sock);
+  // 一次发送 data 中的全部 iovec，可能只发出一部分。
+  // owner 持有 data 所在的内存，直到内核不再引用才释放；
+  // zeroCopy 时内核直接从 data 发送，不拷贝
+  virtual bool submitSend(int sock, const BufferSequence& data,
+                          const std::shared_ptr<const void>& owner,
+                          bool zeroCopy, void* userPtr);
+  const std::vector<Completion>& completions() const { return completions_; }
+
  protected:
   int multiplexer_{-1};
+  std::vector<Completion> completions_;
 };
 
+// Poller 的实现。kAuto 在 Linux 上优先使用 io_uring，内核不支持时在运行期
+// 回退到 epoll；指定 kIoUring 而内核不支持时同样回退。macOS 只有 kqueue，忽略该选项
+enum class PollerType { kAuto, kEpoll, kIoUring };
+
+std::unique_ptr<Poller> createPoller(PollerType type = PollerType::kAuto);
+// 解析命令行里的 "epoll" / "io_uring"，不认识时返回 false
+bool parsePollerType(const char* name, PollerType& type);
+
 #endif
@@ -1,6 +1,78 @@
 #ifndef BASE_SERVER_H
 #define BASE_SERVER_H
 
+#include <base/poll/poller.h>
+#include <base/socket/socket.h>
+#include <base/socket/streamSocket.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
 
+namespace Internal {
+class EventLoop;
+}
 
-#endif
\ No newline at end of file
+// 服务器框架：管理 N 个事件循环线程
+// 用法：setLoopCount -> TCPBind -> MainLoop（阻塞直到 terminate）
+class Server {
+  friend class Internal::EventLoop;
+
+ public:
+  Server();
+  virtual ~Server();
+
+  Server(const Server&) = delete;
+  void operator=(const Server&) = delete;
+
+  // 连接 ID 中的循环编号只有 8 位，事件循环最多这么多个
+  static const std::size_t kMaxLoopCount;
+
+  // 事件循环线程数，0 表示使用 CPU 核数，必须在 MainLoop 之前设置；
+  // 超过 kMaxLoopCount 时按 kMaxLoopCount 处理
+  void setLoopCount(std::size_t n);
+  std::size_t loopCount() const { return loops_.size(); }
+
+  // 不小于该大小的回复以 MSG_ZEROCOPY 发送，0 表示关闭
+  void setZeroCopyThreshold(std::size_t bytes) { zeroCopyThreshold_ = bytes; }
+  std::size_t zeroCopyThreshold() const { return zeroCopyThreshold_; }
+
+  // 每个事件循环使用的 Poller 实现，必须在 MainLoop 之前设置
+  void setPoller(PollerType type) { pollerType_ = type; }
+  PollerType pollerType() const { return pollerType_; }
+
+  // 监听队列长度，必须在 MainLoop 之前设置；实际值不超过 net.core.somaxconn
+  void setListenBacklog(int n) { listenBacklog_ = n; }
+  int listenBacklog() const { return listenBacklog_; }
+
+  // 每个事件循环都会以 SO_REUSEPORT 绑定一次该地址
+  bool TCPBind(const SocketAddr& listenAddr, int tag);
+  // 任一循环监听失败时清理已建好的循环并返回 false
+  bool MainLoop();
+  void terminate() { terminate_ = true; }  // 可以在信号处理函数中调用
+  bool isTerminated() const { return terminate_; }
+
+  const Internal::EventLoop& loop(std::size_t i) const { return *loops_[i]; }
+  void logStats() const;
+
+ protected:
+  // 为新连接创建 StreamSocket，子类返回自己的连接类型；在循环线程上调用
+  virtual std::shared_ptr<StreamSocket> _OnNewConnection(int tag);
+  // 所有循环启动之前/全部退出之后调用
+  virtual bool _Init() { return true; }
+  virtual void _Recycle() {}
+  // 在循环线程上、进入循环之前调用，例如注册该循环上的定时器
+  virtual void _OnLoopStart(Internal::EventLoop& loop) { (void)loop; }
+
+ private:
+  std::size_t loopCount_;
+  std::size_t zeroCopyThreshold_;
+  PollerType pollerType_;
+  int listenBacklog_;
+  std::vector<std::pair<SocketAddr, int>> listenAddrs_;
+  std::vector<std::unique_ptr<Internal::EventLoop>> loops_;
+  std::atomic<bool> terminate_;
+};
+
+#endif
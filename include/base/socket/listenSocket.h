@@ -4,27 +4,51 @@
 #include <base/socket/socket.h>
 #include <netinet/in.h>
 #include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+class StreamSocket;
 
 namespace Internal {
 class ListenSocket : public Socket {
-  static const int LISTENQ;  //  TCP 监听队列的最大长度
-
  public:
-  explicit ListenSocket(int tag);
+  static const int LISTENQ;      // TCP 监听队列的默认长度
+  static const int kAcceptBatch;  // 每次可读事件最多接受的连接数
+
+  ListenSocket(int tag, int backlog = LISTENQ);
   ~ListenSocket();
 
   SocketType getSocketType() const { return SocketType::listen; }
 
+  // 以 SO_REUSEPORT 绑定，每个事件循环各自持有一个监听同一地址的 ListenSocket，
+  // 由内核在它们之间分配新连接
   bool Bind(const SocketAddr& addr);
   bool OnReadable();
   bool OnWritable();
   bool OnError();
+  // 完成模型：内核已经接受了 connfd（< 0 为 -errno），本轮的新连接先攒着；
+  // 本轮已满 kAcceptBatch 个时 fd 留到下一轮再建连接
+  void OnAcceptComplete(int connfd);
+  // 完成模型：为上一轮留下的 fd 建连接，同样受 kAcceptBatch 限制
+  void acceptDeferred();
+  // 把攒下的新连接整批交给 TaskManager，并开始新的一轮计数
+  void commitAccepted();
+
+  // 上次因达到批量上限而没有接受完，需要在下一轮继续
+  bool acceptPending() const { return acceptPending_; }
 
  private:
   int _Accept();
+  void _AddAccepted(int connfd);
   sockaddr_in addrClient_;
   uint16_t localPort_;
   const int tag_;
+  const int backlog_;
+  bool acceptPending_;
+  std::vector<std::shared_ptr<StreamSocket>> accepted_;
+  int roundAccepted_;         // 完成模型下本轮已建连接的 fd 数
+  std::deque<int> deferred_;  // 内核已经接受、还没建连接的 fd
 };
 }  // namespace Internal
 
@@ -3,8 +3,10 @@
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#if defined(__APPLE__)
 #include <sys/_endian.h>
 #include <sys/_types/_socklen_t.h>
+#endif
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <atomic>
@@ -112,12 +114,15 @@ struct hash<SocketAddr> {
 
 namespace Internal {
 class SendThread;
-}
+class EventLoop;
+class TaskManager;
+}  // namespace Internal
 
 // 能够使用 shared_from_this() 方法返回指向自身的 shared_ptr
 class Socket : public std::enable_shared_from_this<Socket> {
   friend class Internal::SendThread;
   // 允许 Internal::SendThread 类访问 Socket 的所有成员
+  friend class Internal::TaskManager;  // 连接加入后由 TaskManager 分配 ID
 
  public:
   virtual ~Socket();
@@ -151,12 +156,19 @@ class Socket : public std::enable_shared_from_this<Socket> {
   bool invalid() const { return invalid_; }
   int getSocket() const { return localSock_; }
 
+  // 套接字注册到的事件循环，连接的整个生命周期内不会改变
+  Internal::EventLoop* getLoop() const { return loop_; }
+  void setLoop(Internal::EventLoop* loop) { loop_ = loop; }
+
  protected:
   Socket();
   int localSock_;
   bool epollOut_;
+  Internal::EventLoop* loop_;
 
  private:
+  void _SetID(std::size_t id) { id_ = id; }
+
   std::atomic<bool> invalid_;
   std::size_t id_;
 
@@ -1,25 +1,135 @@
 #ifndef BASE_SOCKET_STREAMSOCKET_H
 #define BASE_SOCKET_STREAMSOCKET_H
 
+#include <base/buffer/asyncBuffer.h>
+#include <base/buffer/buffer.h>
 #include <base/socket/socket.h>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
 
 using packetLength = int32_t;
 
 class StreamSocket : public Socket {
+  friend class Internal::SendThread;
+  friend class Internal::TaskManager;
+
  public:
   StreamSocket();
   ~StreamSocket();
 
+  // fd 需已设置为非阻塞（ListenSocket 以 accept4 接受）
   bool init(int localfd, const SocketAddr& peer);
-  SocketType getSocketType() { return SocketType::stream; }
+  SocketType getSocketType() const override { return SocketType::stream; }
+  bool OnReadable() override;
+  bool OnWritable() override;
+  bool OnError() override;
+  // 完成模型：内核已经把数据收好，拷贝进接收缓冲区；
+  // 放不下（超过接收缓冲区上限）时返回 false
+  bool OnRecvComplete(const char* data, std::size_t len);
   bool DoMsgParse();
   const SocketAddr& getPeerAddr() const { return peerAddr_; }
+  // 接收缓冲区扩容到上限后能放下的最大帧；_HandlePacket 遇到这么长
+  // 还不完整的帧应当报错关闭连接，否则连接再也收不到数据
+  static std::size_t maxPacketSize();
+
+  // 流水线批处理统计（CLIENT INFO 中显示）：一次 DoMsgParse 处理掉的请求算一批，
+  // 这一批的回复在本轮末尾由 SendThread 合并成一次 writev
+  struct BatchStats {
+    uint64_t batches{0};      // 至少处理了一个请求的解析轮数
+    uint64_t commands{0};     // 累计处理的请求数
+    uint64_t lastBatch{0};    // 最近一批的请求数
+    uint64_t maxBatch{0};     // 最大一批的请求数
+    uint64_t flushes{0};      // 写出了数据的 flush 次数
+    uint64_t writevCalls{0};  // writev/send 调用次数
+  };
+  const BatchStats& batchStats() const { return batch_; }
 
  public:
   int recv();
 
+  // 只追加到发送缓冲区，由所在事件循环的 SendThread 在本轮末尾统一 writev。
+  // 必须在连接所属的循环线程上调用
+  bool sendPacket(const void* data, std::size_t len);
+  bool sendPacket(const BufferSequence& data);
+  // 大回复零拷贝发送（MSG_ZEROCOPY），避免拷贝到发送缓冲区。
+  // owner 持有 data 所在的内存，直到内核通知发送完成才释放；
+  // 小于阈值、未开启或系统不支持时退化为上面的拷贝发送
+  bool sendPacket(const std::shared_ptr<const void>& owner, const char* data,
+                  std::size_t len);
+
+  // 例如协议错误：发完已有的回复后关闭连接
+  void closeAfterReply();
+
+  // threshold 为 0 表示关闭；开启失败（内核不支持）时自动关闭
+  void enableZeroCopy(std::size_t threshold);
+  bool zeroCopyEnabled() const { return zcThreshold_ > 0; }
+  // 走零拷贝的最小回复字节数，未开启时为 0
+  std::size_t zeroCopyThreshold() const { return zcThreshold_; }
+  // 读取错误队列中的零拷贝完成通知，释放已完成的内存，返回是否读到通知
+  bool reapZeroCopy();
+
  protected:
+  // 暂停接收，例如客户端挂起时：不再从 socket 读，也不为没处理完的数据
+  // 扩容接收缓冲区，对端继续发的数据由 TCP 流控挡在内核里；
+  // resumeRead 之后照常接收和解析
+  void pauseRead();
+  void resumeRead();
+
   SocketAddr peerAddr_;
+  BUFFER recvBuf_;
+  AsyncBuffer sendBuf_;
+
+ private:
+  // 返回处理掉的字节数，0 表示包不完整。
+  // msg 只在本次调用期间有效；包不完整时下次会以同一帧的起始再次调用，
+  // 但地址可能不同（帧跨过缓冲区末尾或扩容时数据会挪到开头）
+  virtual packetLength _HandlePacket(const char* msg, std::size_t len) {
+    (void)msg;
+    return static_cast<packetLength>(len);
+  }
+
+  std::size_t _ParseBatch();
+  // 交给 poller 的事件：暂停接收时不含 Read，发送不完整时加上 Write
+  int _PollEvents() const;
+  void _RecordBatch(std::size_t commands);
+  void _MarkSendPending();
+  void _MarkReady();
+  void _CompleteZeroCopy(uint32_t lo, uint32_t hi);
+  // 强制关闭时，内核可能仍在引用的零拷贝内存交给事件循环延迟释放
+  void _LingerZeroCopy();
+
+  bool recvFull_;     // 接收缓冲区曾被写满，解析腾出空间后需要继续读
+  bool sendPending_;  // 已登记到 SendThread，等待本轮 flush
+  bool closeAfterReply_;
+  bool readPaused_;
+  bool sendInflight_;       // 完成模型：已提交给内核、还未完成的发送
+  bool sendInflightChunk_;  // 在途的发送是不是 zcQueue_ 的第一个块
+  bool ready_;        // 已在 TaskManager 的就绪链表中
+  StreamSocket* readyNext_;  // 就绪链表的侵入式指针
+  BatchStats batch_;
+
+  // 零拷贝发送的数据块，与 sendBuf_ 中的普通数据按 start 偏移交错
+  struct ZeroCopyChunk {
+    std::shared_ptr<const void> owner;
+    const char* data;
+    std::size_t len;
+    std::size_t sent;
+    uint64_t start;    // 在整个发送流中的偏移
+    uint32_t lastSeq;  // 最后一次 send 对应的完成通知序号
+    bool hasSeq;       // 是否真的以 MSG_ZEROCOPY 发送过
+  };
+
+  std::size_t zcThreshold_;
+  uint64_t bytesQueued_;  // 进入发送流的字节数（普通 + 零拷贝）
+  uint64_t bytesSent_;    // 已写入内核的字节数
+  std::deque<ZeroCopyChunk> zcQueue_;     // 等待发送
+  // 已发送，等待完成通知；不为空时 closeAfterReply 推迟到通知全部到达
+  std::deque<ZeroCopyChunk> zcInflight_;
+  uint32_t zcNextSeq_;  // 下一次 MSG_ZEROCOPY send 的序号
+  uint32_t zcDoneSeq_;  // 小于它的序号都已完成
+  std::map<uint32_t, uint32_t> zcPendingRanges_;  // 乱序到达的通知 [lo, hi]
 };
 
-#endif
\ No newline at end of file
+#endif
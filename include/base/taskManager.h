@@ -2,31 +2,65 @@
 #define BASE_TASKMANAGER_H
 
 #include <base/socket/streamSocket.h>
-#include <map>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <vector>
 
 namespace Internal {
+// 连接表：以连接 ID 为下标的槽数组，外加一个紧凑的活跃连接数组。
+// 连接 ID = 代数(32 位) | 分片(8 位) | 槽下标(24 位)，
+// 分片即事件循环编号，保证不同循环的 ID 不重复；
+// 槽被复用时代数加一，持有旧 ID 的 findTCP 会返回空。
+// 每轮只处理就绪链表上的连接（收到数据、出错或刚加入），
+// 空闲连接不会被访问，开销与活跃连接数成正比。
 class TaskManager {
+ public:
   using PTCPSOCKET = std::shared_ptr<StreamSocket>;
   using NEWTASK_T = std::vector<PTCPSOCKET>;
 
- public:
-  TaskManager() : newCnt_(0) {}
+  explicit TaskManager(std::size_t shard = 0);
   ~TaskManager();
 
   bool addTask(PTCPSOCKET task);
-  bool empty() { return tcpSockets_.empty(); }
-  void clear() { tcpSockets_.clear(); }
-  std::size_t size() const { return tcpSockets_.size(); }
-  PTCPSOCKET findTCP(unsigned int id) const;
+  // 一次加锁加入一批任务
+  bool addTasks(const NEWTASK_T& tasks);
+  bool empty() { return tasks_.empty(); }
+  void clear();
+  std::size_t size() const { return tasks_.size(); }
+  PTCPSOCKET findTCP(std::size_t id) const;
   bool DoMsgParse();
 
+  // 把连接挂到就绪链表，下一次 DoMsgParse 时处理；只能在循环线程上调用
+  void markReady(StreamSocket* sock);
+  bool hasReady() const { return readyHead_ != nullptr; }
+
+  static const int kSlotBits = 24;
+  static const int kShardBits = 8;
+  // 分片编号的个数，也就是事件循环数的上限
+  static const std::size_t kMaxShards = std::size_t(1) << kShardBits;
+
  private:
+  static const uint32_t kNil = 0xffffffffU;
+
+  struct Slot {
+    uint32_t gen;  // 每次释放加一
+    uint32_t pos;  // 在 tasks_ 中的位置，kNil 表示空闲
+  };
+
   bool _AddTask(PTCPSOCKET task);
-  void _RemoveTask(std::map<int, PTCPSOCKET>::iterator&);
-  std::map<int, PTCPSOCKET> tcpSockets_;  // 正式存储所有活跃任务
+  void _RemoveTask(StreamSocket* sock);
+  void _AcceptNewTasks();
+
+  const uint32_t shard_;
+  std::vector<Slot> slots_;
+  std::vector<uint32_t> freeSlots_;
+  std::vector<PTCPSOCKET> tasks_;  // 正式存储所有活跃任务，连续存放便于遍历
+
+  // 就绪链表（FIFO），链接指针放在 StreamSocket 里，入队不分配内存
+  StreamSocket* readyHead_;
+  StreamSocket* readyTail_;
 
   std::mutex lock_;
   NEWTASK_T newTasks_;       // 临时存储新添加的任务
@@ -0,0 +1,56 @@
+#ifndef BASE_THREAD_SENDTHREAD_H
+#define BASE_THREAD_SENDTHREAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Poller;
+class StreamSocket;
+struct BufferSequence;
+
+namespace Internal {
+// 发送子系统。
+// 每个事件循环有一个 SendThread，运行在该循环的线程上（连接不跨线程），
+// 本轮产生的回复只是追加到连接的发送缓冲区并登记到 pending 列表，
+// 在一轮循环的最后由 flush() 统一发送：每个连接一次 writev，
+// 只有发送不完整时才注册写事件，发完后立即取消。
+// poller 是完成模型（io_uring）时不再自己 writev：每个连接同时只有一个
+// 发送交给内核，complete() 收到结果后再提交剩下的数据。
+class SendThread {
+ public:
+  explicit SendThread(Poller* poller);
+
+  SendThread(const SendThread&) = delete;
+  void operator=(const SendThread&) = delete;
+
+  // 登记有待发送数据的连接，同一轮内重复登记只记一次
+  void addPending(const std::shared_ptr<StreamSocket>& sock);
+  // 发送本轮所有登记的连接，返回写出的字节数
+  std::size_t flush();
+  bool empty() const { return pending_.empty(); }
+  // 完成模型：sock 在途的发送已完成，result 为字节数或 -errno，返回写出的字节数
+  std::size_t complete(StreamSocket* sock, int result);
+
+  uint64_t writevCalls() const { return writevCalls_; }
+  uint64_t flushes() const { return flushes_; }
+
+ private:
+  // 返回 false 表示连接出错；yielded 表示达到本轮次数上限而套接字仍可写
+  bool _Send(StreamSocket* sock, std::size_t& sent, bool& yielded);
+  bool _SendZeroCopy(StreamSocket* sock, std::size_t& sent);
+  // 完成模型：提交 sock 接下来的一段数据；返回 false 表示连接应当关闭
+  bool _Submit(StreamSocket* sock);
+  static void _Truncate(BufferSequence& bf, uint64_t limit);
+
+  Poller* const poller_;
+  const bool completion_;
+  std::vector<std::shared_ptr<StreamSocket>> pending_;
+  std::vector<std::shared_ptr<StreamSocket>> sending_;  // 与 pending_ 交换，避免重新分配
+  uint64_t writevCalls_{0};
+  uint64_t flushes_{0};
+};
+}  // namespace Internal
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef BASE_TIMER_TIMINGWHEEL_H
+#define BASE_TIMER_TIMINGWHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Internal {
+// 分层时间轮，只在所属事件循环的线程上使用，不加锁。
+// 精度 1ms，第 0 层 256 个槽，第 1~3 层各 64 个槽，覆盖约 18.6 小时，
+// 更远的定时器先挂在最高层，转到时再重新放置。
+// 定时器节点放在连续的节点池里，以下标加代数作为 TimerId，
+// schedule/cancel 都是 O(1)，已触发或已取消的 TimerId 再 cancel 是安全的。
+class TimingWheel {
+ public:
+  using TimerId = uint64_t;
+  using Callback = std::function<void()>;
+
+  static const TimerId kInvalidTimer = 0;
+
+  explicit TimingWheel(uint64_t nowMs = 0);
+
+  TimingWheel(const TimingWheel&) = delete;
+  void operator=(const TimingWheel&) = delete;
+
+  // delayMs 之后触发；intervalMs > 0 时之后按该间隔重复触发
+  TimerId schedule(uint64_t delayMs, Callback cb, uint64_t intervalMs = 0);
+  // 返回定时器是否还在等待触发
+  bool cancel(TimerId id);
+
+  // 把时间推进到 nowMs，执行所有到期的回调，返回执行的回调数
+  std::size_t advance(uint64_t nowMs);
+
+  // 距离下一个需要处理的时刻还有多少毫秒，不超过 maxMs；没有定时器时返回 maxMs。
+  // 到期时刻在高层时返回的是该槽开始的时刻（需要降层），所以不会睡过头
+  int nextTimeoutMs(uint64_t nowMs, int maxMs) const;
+
+  std::size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+  uint64_t now() const { return now_; }
+
+ private:
+  static const int kLevels = 4;
+  static const int kRootBits = 8;
+  static const int kLevelBits = 6;
+  static const uint32_t kNil = 0xffffffffU;
+
+  struct Node {
+    uint64_t expire;
+    uint64_t interval;
+    Callback cb;
+    uint32_t prev;
+    uint32_t next;
+    uint32_t gen;  // 每次回收加一，用于识别过期的 TimerId
+    int16_t level;  // -1 表示不在任何槽里
+    uint16_t slot;
+  };
+
+  struct Level {
+    std::vector<uint32_t> heads;   // 每个槽的链表头
+    std::vector<uint64_t> bitmap;  // 非空槽的位图
+  };
+
+  static int _SlotCount(int level) {
+    return 1 << (level == 0 ? kRootBits : kLevelBits);
+  }
+  static int _Shift(int level) {
+    return level == 0 ? 0 : kRootBits + (level - 1) * kLevelBits;
+  }
+
+  uint32_t _Alloc();
+  void _Free(uint32_t idx);
+  void _Insert(uint32_t idx);
+  void _Link(uint32_t idx, int level, int slot);
+  void _Unlink(uint32_t idx);
+  void _Cascade(int level);
+  std::size_t _RunSlot(int slot);
+  int _NextSlot(int level, int from) const;
+
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> freeList_;
+  Level levels_[kLevels];
+  uint64_t now_;
+  std::size_t count_;
+  uint32_t running_;  // 正在执行的槽被摘下来后的链表头
+};
+}  // namespace Internal
+
+#endif
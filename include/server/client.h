@@ -0,0 +1,70 @@
+#ifndef SERVER_CLIENT_H
+#define SERVER_CLIENT_H
+
+#include <base/socket/streamSocket.h>
+#include <server/db/stream.h>
+#include <server/protocol/respEncoder.h>
+#include <server/protocol/respParser.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tinyredis {
+class Database;
+
+// 一个 Redis 客户端连接：直接在接收缓冲区上解析 RESP 请求，
+// 经命令表分发执行，回复经 RespEncoder 按协商的协议版本（HELLO）编码。
+// 阻塞命令（XREADGROUP BLOCK）不回复并调用 block()：请求留在接收缓冲区，
+// 连接暂停接收、不再解析后续请求；被唤醒或超时后在所属循环上重新执行同一条请求
+class Client : public StreamSocket, public StreamWaiter {
+ public:
+  explicit Client(Database* db)
+      : db_(db),
+        parser_(maxPacketSize()),
+        reply_(this),
+        blocked_(false),
+        blockActive_(false),
+        blockTimedOut_(false),
+        blockTimer_(0),
+        blockGen_(0) {}
+  ~Client();
+
+  Database& db() { return *db_; }
+  RespEncoder& reply() { return reply_; }
+
+  const std::string& name() const { return name_; }
+  void setName(const std::string& name) { name_ = name; }
+
+  // 在命令中调用（持有键所在分片的锁）：本条请求执行完后挂起，timeoutMs 为 0 表示不超时。
+  // 调用前应已用 waitOn() 排到等待队列
+  void block(uint64_t timeoutMs);
+  // 重新执行的这一次是否因为超时：命令据此回复空结果而不是再次阻塞
+  bool blockTimedOut() const { return blockTimedOut_; }
+
+ private:
+  packetLength _HandlePacket(const char* msg, std::size_t len) override;
+  void _Execute(const std::vector<Slice>& args);
+
+  bool _OnWake() override;
+  void _OnBlockTimeout();
+  // 在循环线程上恢复解析，重新执行挂起的请求
+  void _Resume();
+  void _EndBlock();
+
+  Database* const db_;
+  RespParser parser_;
+  RespEncoder reply_;
+  std::string name_;  // HELLO SETNAME 设置的连接名
+
+  bool blocked_;        // 挂起中，不解析请求
+  bool blockActive_;    // 一次阻塞尚未结束（重新执行后可能再次挂起）
+  bool blockTimedOut_;
+  uint64_t blockTimer_;  // 超时定时器
+  // 每次开始阻塞加一，丢弃上一次阻塞遗留的唤醒
+  uint64_t blockGen_;
+  std::weak_ptr<Client> self_;  // 跨线程投递唤醒任务时使用
+};
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef SERVER_COMMAND_H
+#define SERVER_COMMAND_H
+
+#include <server/db/database.h>
+#include <server/db/object.h>
+#include <server/protocol/respParser.h>
+#include <vector>
+
+namespace tinyredis {
+class Client;
+
+using CommandProc = void (*)(Client& client, const std::vector<Slice>& args);
+// 键的位置不规则、无法用下标描述的命令由它给出键所在的分片；
+// 参数不合法、命令只会回复错误时返回 0
+using KeysProc = Database::ShardMask (*)(const std::vector<Slice>& args);
+
+// firstKey 取这个值表示访问整个键空间（DBSIZE、SCAN、CONFIG 等）
+const int kAllKeys = -1;
+
+// 命令表中的一项
+struct Command {
+  const char* name;  // 小写
+  int arity;         // 含命令名的参数个数；负数表示至少 -arity 个
+  CommandProc proc;
+  // 与 Redis 的命令表相同：第一个键、最后一个键（负数从末尾数）的下标与步长，
+  // 超出参数个数的部分忽略；firstKey 为 0 表示不访问键空间。
+  // 执行期间持有这些键所在分片的锁
+  int firstKey;
+  int lastKey;
+  int keyStep;
+  KeysProc keys;  // 不为空时代替上面三项
+};
+
+// 按名字查找（不区分大小写），没有该命令时返回 nullptr
+const Command* lookupCommand(const Slice& name);
+// 执行 cmd 需要锁住的分片，不访问键空间时为 0
+Database::ShardMask commandShards(const Command& cmd,
+                                  const std::vector<Slice>& args);
+
+// 参数是否等于 word（不区分大小写），用于解析命令选项
+bool argIs(const Slice& arg, const char* word);
+
+// 查找 type 类型的值：不存在时 *out 为空；类型不对时回复 WRONGTYPE 并返回 false
+bool lookupTyped(Client& client, const Slice& key, Object::Type type,
+                 Object** out);
+// 把参数解析为整数，失败时回复错误并返回 false
+bool parseInteger(Client& client, const Slice& arg, long long* out);
+// 聚合类型删空最后一个元素后删除键，与 Redis 一样不保留空的 hash/list/set/zset
+void removeIfEmpty(Client& client, const Slice& key, std::size_t size);
+
+// 各命令的实现，按类别放在 src/server/commands/ 下
+// connection.cpp
+void pingCommand(Client& client, const std::vector<Slice>& args);
+void echoCommand(Client& client, const std::vector<Slice>& args);
+void helloCommand(Client& client, const std::vector<Slice>& args);
+void clientCommand(Client& client, const std::vector<Slice>& args);
+// keyspace.cpp
+void delCommand(Client& client, const std::vector<Slice>& args);
+void existsCommand(Client& client, const std::vector<Slice>& args);
+void dbsizeCommand(Client& client, const std::vector<Slice>& args);
+void flushdbCommand(Client& client, const std::vector<Slice>& args);
+void scanCommand(Client& client, const std::vector<Slice>& args);
+void typeCommand(Client& client, const std::vector<Slice>& args);
+void objectCommand(Client& client, const std::vector<Slice>& args);
+// server.cpp
+void memoryCommand(Client& client, const std::vector<Slice>& args);
+void configCommand(Client& client, const std::vector<Slice>& args);
+Database::ShardMask memoryKeys(const std::vector<Slice>& args);
+// string.cpp
+void getCommand(Client& client, const std::vector<Slice>& args);
+void setCommand(Client& client, const std::vector<Slice>& args);
+void appendCommand(Client& client, const std::vector<Slice>& args);
+void strlenCommand(Client& client, const std::vector<Slice>& args);
+void getrangeCommand(Client& client, const std::vector<Slice>& args);
+void setrangeCommand(Client& client, const std::vector<Slice>& args);
+void incrCommand(Client& client, const std::vector<Slice>& args);
+void decrCommand(Client& client, const std::vector<Slice>& args);
+void incrbyCommand(Client& client, const std::vector<Slice>& args);
+void decrbyCommand(Client& client, const std::vector<Slice>& args);
+// hash.cpp
+void hsetCommand(Client& client, const std::vector<Slice>& args);
+void hgetCommand(Client& client, const std::vector<Slice>& args);
+void hmgetCommand(Client& client, const std::vector<Slice>& args);
+void hdelCommand(Client& client, const std::vector<Slice>& args);
+void hlenCommand(Client& client, const std::vector<Slice>& args);
+void hexistsCommand(Client& client, const std::vector<Slice>& args);
+void hgetallCommand(Client& client, const std::vector<Slice>& args);
+// list.cpp
+void lpushCommand(Client& client, const std::vector<Slice>& args);
+void rpushCommand(Client& client, const std::vector<Slice>& args);
+void lpopCommand(Client& client, const std::vector<Slice>& args);
+void rpopCommand(Client& client, const std::vector<Slice>& args);
+void llenCommand(Client& client, const std::vector<Slice>& args);
+void lrangeCommand(Client& client, const std::vector<Slice>& args);
+void lindexCommand(Client& client, const std::vector<Slice>& args);
+// set.cpp
+void saddCommand(Client& client, const std::vector<Slice>& args);
+void sremCommand(Client& client, const std::vector<Slice>& args);
+void sismemberCommand(Client& client, const std::vector<Slice>& args);
+void scardCommand(Client& client, const std::vector<Slice>& args);
+void smembersCommand(Client& client, const std::vector<Slice>& args);
+void sinterCommand(Client& client, const std::vector<Slice>& args);
+void sintercardCommand(Client& client, const std::vector<Slice>& args);
+Database::ShardMask sintercardKeys(const std::vector<Slice>& args);
+// zset.cpp
+void zaddCommand(Client& client, const std::vector<Slice>& args);
+void zremCommand(Client& client, const std::vector<Slice>& args);
+void zscoreCommand(Client& client, const std::vector<Slice>& args);
+void zcardCommand(Client& client, const std::vector<Slice>& args);
+void zrankCommand(Client& client, const std::vector<Slice>& args);
+void zrangeCommand(Client& client, const std::vector<Slice>& args);
+void zrangebyscoreCommand(Client& client, const std::vector<Slice>& args);
+void zcountCommand(Client& client, const std::vector<Slice>& args);
+// bitmap.cpp
+void setbitCommand(Client& client, const std::vector<Slice>& args);
+void getbitCommand(Client& client, const std::vector<Slice>& args);
+void bitcountCommand(Client& client, const std::vector<Slice>& args);
+void bitposCommand(Client& client, const std::vector<Slice>& args);
+void bitopCommand(Client& client, const std::vector<Slice>& args);
+void bitfieldCommand(Client& client, const std::vector<Slice>& args);
+// hyperloglog.cpp
+void pfaddCommand(Client& client, const std::vector<Slice>& args);
+void pfcountCommand(Client& client, const std::vector<Slice>& args);
+void pfmergeCommand(Client& client, const std::vector<Slice>& args);
+// stream.cpp
+void xaddCommand(Client& client, const std::vector<Slice>& args);
+void xrangeCommand(Client& client, const std::vector<Slice>& args);
+void xrevrangeCommand(Client& client, const std::vector<Slice>& args);
+void xlenCommand(Client& client, const std::vector<Slice>& args);
+void xtrimCommand(Client& client, const std::vector<Slice>& args);
+void xgroupCommand(Client& client, const std::vector<Slice>& args);
+void xreadgroupCommand(Client& client, const std::vector<Slice>& args);
+Database::ShardMask xreadgroupKeys(const std::vector<Slice>& args);
+void xackCommand(Client& client, const std::vector<Slice>& args);
+void xpendingCommand(Client& client, const std::vector<Slice>& args);
+void xclaimCommand(Client& client, const std::vector<Slice>& args);
+void xautoclaimCommand(Client& client, const std::vector<Slice>& args);
+}  // namespace tinyredis
+
+#endif
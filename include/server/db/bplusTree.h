@@ -0,0 +1,113 @@
+#ifndef SERVER_DB_BPLUSTREE_H
+#define SERVER_DB_BPLUSTREE_H
+
+#include <server/protocol/respParser.h>
+#include <cstddef>
+#include <string>
+
+namespace tinyredis {
+// 大 zset 的有序索引：按 (score, member) 排序的内存 B+ 树。
+// 内部节点记录每个子树的元素个数，按排名定位、求排名、按分数计数都是 O(log N)；
+// 叶子按顺序双向链接，范围遍历在叶子内顺序读。
+// 与跳表相比，每层只访问一个节点，节点内的分数连续存放，二分查找时访问的缓存行很少，
+// 只有分数相等时才比较成员；千万级元素也只有五六层。
+// 与 SkipList 一样不检查成员是否重复，由调用方（配合字典）保证
+class BPlusTree {
+ public:
+  static const int kLeafCap = 64;
+  static const int kInnerCap = 32;
+  static const std::size_t npos = static_cast<std::size_t>(-1);
+
+  struct Node {
+    bool leaf;
+    int n;  // 元素个数（叶子）或子节点个数（内部节点）
+  };
+
+  // 数组多留一个位置：先插入再检查是否超过容量、需要分裂
+  struct Leaf : Node {
+    Leaf* prev;
+    Leaf* next;
+    double scores[kLeafCap + 1];
+    std::string members[kLeafCap + 1];
+  };
+
+  // 第 i 个分隔键是第 i 个子树中最小键的下界（i >= 1），第 0 个不使用
+  struct Inner : Node {
+    std::size_t counts[kInnerCap + 1];  // 各子树的元素个数
+    Node* children[kInnerCap + 1];
+    double sepScores[kInnerCap + 1];
+    std::string sepMembers[kInnerCap + 1];
+  };
+
+  // 叶子中的一个位置，用于按顺序遍历；leaf 为 nullptr 表示越界
+  struct Cursor {
+    const Leaf* leaf;
+    int index;
+
+    bool valid() const { return leaf != nullptr; }
+    double score() const { return leaf->scores[index]; }
+    const std::string& member() const { return leaf->members[index]; }
+    void next();
+    void prev();
+  };
+
+  BPlusTree();
+  ~BPlusTree();
+
+  BPlusTree(const BPlusTree&) = delete;
+  void operator=(const BPlusTree&) = delete;
+
+  std::size_t size() const { return size_; }
+  int height() const;
+
+  void insert(double score, const Slice& member);
+  bool erase(double score, const Slice& member);
+  // 修改已存在元素的分数，在叶子内位置不变时原地修改；元素不存在时返回 false
+  bool updateScore(double score, const Slice& member, double newScore);
+
+  // 从 0 开始的排名，不存在时返回 npos
+  std::size_t rank(double score, const Slice& member) const;
+  // 排名为 rank 的元素，越界时返回无效的 Cursor
+  Cursor byRank(std::size_t rank) const;
+  Cursor first() const { return byRank(0); }
+  Cursor last() const {
+    return size_ ? byRank(size_ - 1) : Cursor{nullptr, 0};
+  }
+  // 分数小于 score（inclusive 时为不大于）的元素个数，即分数区间边界的排名
+  std::size_t countBelow(double score, bool inclusive) const;
+
+  // 依次回调排名 [start, stop] 的元素 fn(const std::string& member, double score)，
+  // 调用方保证排名有效
+  template <typename Fn>
+  void range(std::size_t start, std::size_t stop, Fn&& fn) const {
+    Cursor c = byRank(start);
+    for (std::size_t i = start; i <= stop; ++i, c.next())
+      fn(c.member(), c.score());
+  }
+
+  // 节点结构本身占用的字节数，不含成员字符串的堆内存
+  std::size_t nodeBytes() const;
+
+ private:
+  static std::size_t _Count(const Node* node);
+  // 返回分裂出的右半节点（没有分裂时为 nullptr），*sepScore/*sepMember 为其下界
+  Node* _Insert(Node* node, double score, const Slice& member,
+                double* sepScore, std::string* sepMember);
+  bool _Erase(Node* node, double score, const Slice& member);
+  // 子节点 i 元素过少：与相邻的兄弟节点合并或均分
+  void _Rebalance(Inner* parent, int i);
+  void _MergeLeaves(Inner* parent, int i);
+  void _MergeInners(Inner* parent, int i);
+  void _BalanceLeaves(Inner* parent, int i);
+  void _BalanceInners(Inner* parent, int i);
+  static void _RemoveChild(Inner* parent, int i);
+  static void _Free(Node* node);
+
+  Node* root_;
+  std::size_t size_;
+  std::size_t leaves_;
+  std::size_t inners_;
+};
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef SERVER_DB_DATABASE_H
+#define SERVER_DB_DATABASE_H
+
+#include <server/db/hashTable.h>
+#include <server/db/object.h>
+#include <server/protocol/respParser.h>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace tinyredis {
+// 键空间。所有事件循环共享一个实例，按键的哈希分成 kShards 个分片，
+// 每个分片是独立的哈希表和锁：命令执行前按 Guard 锁住它的键所在的分片，
+// 不同分片上的命令在各自的循环上并行执行。
+// 访问键之前必须持有该键所在分片的锁；整个键空间的操作（DBSIZE、SCAN 等）
+// 与编码阈值的修改持有全部分片的锁
+class Database {
+ public:
+  using Keyspace = HashTable<std::string, Object, KeyHash, KeyEqual>;
+  // 分片的集合，第 i 位表示第 i 个分片
+  using ShardMask = uint64_t;
+
+  static const int kShardBits = 6;
+  static const std::size_t kShards = 1u << kShardBits;
+  static const ShardMask kAllShards = ~static_cast<ShardMask>(0);
+  // 空闲时每个分片每次最多花在 rehash 上的时间
+  static const uint64_t kCronRehashUs = 1000;
+
+  // MEMORY STATS 的内容，与 Redis 一样以分配器的总量扣除启动时的基线得到数据集大小
+  struct MemoryStats {
+    std::size_t allocated;   // 分配器当前已分配的总字节数
+    std::size_t startup;     // 数据库创建时的总字节数
+    std::size_t dataset;     // allocated - startup
+    std::size_t tableBytes;  // 其中哈希表结构本身占用的字节数
+    std::size_t keys;
+  };
+
+  // 按编号从小到大锁住一组分片，多键命令之间不会死锁
+  class Guard {
+   public:
+    Guard(Database& db, ShardMask shards);
+    ~Guard();
+
+    Guard(const Guard&) = delete;
+    void operator=(const Guard&) = delete;
+
+   private:
+    Database& db_;
+    const ShardMask shards_;
+  };
+
+  Database();
+
+  // 用哈希的最高几位选分片；表内对哈希再混合后选桶，分片内的键仍然均匀分布
+  static std::size_t shardOf(const Slice& key) {
+    return static_cast<std::size_t>(KeyHash()(key) >> (64 - kShardBits));
+  }
+  static ShardMask shardBit(const Slice& key) {
+    return static_cast<ShardMask>(1) << shardOf(key);
+  }
+
+  // key 所在分片的哈希表，调用方持有该分片的锁（Debug 构建下检查）
+  Keyspace& keys(const Slice& key) { return shard(shardOf(key)); }
+  Keyspace& shard(std::size_t i);
+  // 小聚合类型的编码阈值：持有任一分片的锁时可读，修改需持有全部分片的锁
+  EncodingConfig& config() { return config_; }
+  const EncodingConfig& config() const { return config_; }
+
+  // 加入不存在的键，返回指向值的指针
+  Object* add(const Slice& key, Object value);
+
+  // 以下访问整个键空间，调用方持有全部分片的锁
+  std::size_t size() const;
+  void clear();
+
+  // 由分片所属的事件循环上的定时器周期调用：拿不到锁（命令正在执行）时跳过本次，
+  // 否则在预算内推进该分片的渐进式 rehash，并在装载因子过低时开始缩容
+  void cron(std::size_t shard);
+
+  // 单个键占用的内存估计：键与值的堆内存、元素本身，加上所在分片平摊的桶开销；
+  // 键不存在时返回 0
+  std::size_t memoryUsage(const Slice& key);
+  // 调用方持有全部分片的锁
+  MemoryStats memoryStats() const;
+
+ private:
+  struct Shard {
+    std::mutex mutex;
+    Keyspace keys;
+  };
+
+  Shard shards_[kShards];
+  EncodingConfig config_;
+  const std::size_t startupBytes_;
+};
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,395 @@
+#ifndef SERVER_DB_DICT_H
+#define SERVER_DB_DICT_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <utility>
+
+namespace tinyredis {
+// 链式哈希表，与 Redis 的 dict 相同的渐进式 rehash：
+// 扩容/缩容时分配第二张表，之后每次查找、插入、删除顺带迁移一个桶，
+// 空闲时再由 rehashFor 在时间预算内批量迁移，任何一次操作都不会停顿在整表迁移上。
+// 桶数组用 calloc 分配，大表的零页由内核按需提供，分配本身不会逐页清零。
+//
+// 遍历有两种方式：
+// - scan：无状态游标（高位进位），rehash 期间也保证整轮遍历开始时就存在、
+//   遍历期间没有删除的元素至少返回一次，可能重复；
+// - Iterator：安全迭代器，存活期间暂停 rehash，可以删除当前元素。
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Equal = std::equal_to<K>>
+class Dict {
+ public:
+  struct Entry {
+    K key;
+    V value;
+    Entry* next;
+  };
+
+  static const std::size_t kInitSize = 4;
+  // 装载因子低于 1/kMinFillRatio 时缩容
+  static const std::size_t kMinFillRatio = 10;
+
+  Dict() : rehashIdx_(-1), pauseRehash_(0) {}
+  ~Dict() {
+    _Free(ht_[0]);
+    _Free(ht_[1]);
+  }
+
+  Dict(const Dict&) = delete;
+  void operator=(const Dict&) = delete;
+
+  std::size_t size() const { return ht_[0].used + ht_[1].used; }
+  bool empty() const { return size() == 0; }
+  std::size_t bucketCount() const { return ht_[0].size + ht_[1].size; }
+  bool isRehashing() const { return rehashIdx_ >= 0; }
+  // 表结构本身占用的字节数：桶数组与元素节点，不含键、值自己的堆内存
+  std::size_t tableBytes() const {
+    return bucketCount() * sizeof(Entry*) + size() * sizeof(Entry);
+  }
+
+  // 查找与删除接受任何 Hash/Equal 支持的类型，例如以 Slice 查 std::string 键，
+  // 不必为一次查找构造键
+  template <typename KK>
+  V* find(const KK& key) {
+    Entry* e = findEntry(key);
+    return e ? &e->value : nullptr;
+  }
+
+  template <typename KK>
+  Entry* findEntry(const KK& key) {
+    if (empty())
+      return nullptr;
+    _RehashStep();
+    const uint64_t h = _Hash(key);
+    for (int t = 0; t <= 1; ++t) {
+      const Table& ht = ht_[t];
+      for (Entry* e = ht.table[h & ht.mask]; e; e = e->next) {
+        if (equal_(e->key, key))
+          return e;
+      }
+      if (!isRehashing())
+        break;
+    }
+    return nullptr;
+  }
+
+  // 插入或覆盖，返回 true 表示新插入
+  template <typename KK, typename VV>
+  bool set(KK&& key, VV&& value) {
+    std::pair<Entry*, bool> r = _FindOrInsert(std::forward<KK>(key));
+    r.first->value = std::forward<VV>(value);
+    return r.second;
+  }
+
+  // 不存在时插入值初始化的 V，返回元素以及是否新插入
+  template <typename KK>
+  std::pair<V*, bool> insert(KK&& key) {
+    std::pair<Entry*, bool> r = _FindOrInsert(std::forward<KK>(key));
+    return std::make_pair(&r.first->value, r.second);
+  }
+
+  template <typename KK>
+  bool erase(const KK& key) {
+    if (empty())
+      return false;
+    _RehashStep();
+    const uint64_t h = _Hash(key);
+    for (int t = 0; t <= 1; ++t) {
+      Table& ht = ht_[t];
+      Entry** link = &ht.table[h & ht.mask];
+      for (Entry* e = *link; e; link = &e->next, e = e->next) {
+        if (equal_(e->key, key)) {
+          *link = e->next;
+          delete e;
+          --ht.used;
+          shrinkIfNeeded();
+          return true;
+        }
+      }
+      if (!isRehashing())
+        break;
+    }
+    return false;
+  }
+
+  void clear() {
+    _Free(ht_[0]);
+    _Free(ht_[1]);
+    rehashIdx_ = -1;
+  }
+
+  // 预先扩到能放下 n 个元素（已在 rehash 时不处理）
+  bool reserve(std::size_t n) {
+    if (isRehashing() || n <= ht_[0].size)
+      return false;
+    return _Resize(n);
+  }
+
+  // 装载因子过低时开始缩容，返回是否开始
+  bool shrinkIfNeeded() {
+    if (isRehashing() || pauseRehash_ > 0 || ht_[0].size <= kInitSize)
+      return false;
+    if (ht_[0].used * kMinFillRatio >= ht_[0].size)
+      return false;
+    return _Resize(ht_[0].used);
+  }
+
+  // 迁移最多 n 个非空桶，途中最多跳过 n * 10 个空桶，返回是否还没迁移完
+  bool rehash(std::size_t n) {
+    if (!isRehashing())
+      return false;
+    std::size_t emptyVisits = n * 10;
+    Table& from = ht_[0];
+    Table& to = ht_[1];
+    while (n-- > 0 && from.used != 0) {
+      while (from.table[rehashIdx_] == nullptr) {
+        ++rehashIdx_;
+        if (--emptyVisits == 0)
+          return true;
+      }
+      Entry* e = from.table[rehashIdx_];
+      while (e) {
+        Entry* next = e->next;
+        const std::size_t idx = _Hash(e->key) & to.mask;
+        e->next = to.table[idx];
+        to.table[idx] = e;
+        --from.used;
+        ++to.used;
+        e = next;
+      }
+      from.table[rehashIdx_] = nullptr;
+      ++rehashIdx_;
+    }
+
+    if (from.used == 0) {
+      std::free(from.table);
+      from = to;
+      to = Table();
+      rehashIdx_ = -1;
+      return false;
+    }
+    return true;
+  }
+
+  // 在 budgetUs 微秒内尽量迁移，返回迁移的批次数（每批 100 个桶）
+  std::size_t rehashFor(uint64_t budgetUs) {
+    if (pauseRehash_ > 0)
+      return 0;
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point deadline =
+        Clock::now() + std::chrono::microseconds(budgetUs);
+    std::size_t batches = 0;
+    while (rehash(100)) {
+      ++batches;
+      if (Clock::now() >= deadline)
+        break;
+    }
+    return batches;
+  }
+
+  // 访问游标 cursor 对应的桶，fn(const Entry&) 不能修改字典；返回下一个游标，0 表示结束
+  template <typename Fn>
+  uint64_t scan(uint64_t cursor, Fn&& fn) {
+    if (empty())
+      return 0;
+    ++pauseRehash_;
+    uint64_t v = cursor;
+    if (!isRehashing()) {
+      _ScanBucket(ht_[0], v, fn);
+      v = _NextCursor(v, ht_[0].mask);
+    } else {
+      // 先访问小表的桶，再访问大表中展开自该桶的所有桶
+      const Table* small = &ht_[0];
+      const Table* large = &ht_[1];
+      if (small->size > large->size)
+        std::swap(small, large);
+      _ScanBucket(*small, v, fn);
+      do {
+        _ScanBucket(*large, v, fn);
+        v = _NextCursor(v, large->mask);
+      } while (v & (small->mask ^ large->mask));
+    }
+    --pauseRehash_;
+    return v;
+  }
+
+  // 安全迭代器：存活期间字典不做 rehash 迁移，允许删除 next() 刚返回的元素
+  class Iterator {
+   public:
+    explicit Iterator(Dict* d)
+        : d_(d), table_(0), index_(0), entry_(nullptr), next_(nullptr) {
+      ++d_->pauseRehash_;
+    }
+    ~Iterator() { --d_->pauseRehash_; }
+
+    Iterator(const Iterator&) = delete;
+    void operator=(const Iterator&) = delete;
+
+    // 没有更多元素时返回 nullptr
+    Entry* next() {
+      for (;;) {
+        if (next_) {
+          entry_ = next_;
+          next_ = entry_->next;
+          return entry_;
+        }
+        const Table& ht = d_->ht_[table_];
+        if (index_ >= ht.size) {
+          if (table_ == 1 || !d_->isRehashing())
+            return nullptr;
+          table_ = 1;
+          index_ = 0;
+          continue;
+        }
+        next_ = ht.table[index_++];
+      }
+    }
+
+   private:
+    Dict* d_;
+    int table_;
+    std::size_t index_;
+    Entry* entry_;
+    Entry* next_;
+  };
+
+ private:
+  struct Table {
+    Entry** table;
+    std::size_t size;
+    std::size_t mask;
+    std::size_t used;
+
+    Table() : table(nullptr), size(0), mask(0), used(0) {}
+  };
+
+  template <typename KK>
+  uint64_t _Hash(const KK& key) const {
+    // 再做一次混合：std::hash 对整数是恒等映射，直接取低位会严重冲突
+    uint64_t h = static_cast<uint64_t>(hash_(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  void _RehashStep() {
+    if (pauseRehash_ == 0)
+      rehash(1);
+  }
+
+  template <typename KK>
+  std::pair<Entry*, bool> _FindOrInsert(KK&& key) {
+    if (isRehashing())
+      _RehashStep();
+    _ExpandIfNeeded();
+
+    const uint64_t h = _Hash(key);
+    for (int t = 0; t <= 1; ++t) {
+      const Table& ht = ht_[t];
+      for (Entry* e = ht.table[h & ht.mask]; e; e = e->next) {
+        if (equal_(e->key, key))
+          return std::make_pair(e, false);
+      }
+      if (!isRehashing())
+        break;
+    }
+
+    // rehash 期间新元素一律进新表
+    Table& ht = isRehashing() ? ht_[1] : ht_[0];
+    const std::size_t idx = h & ht.mask;
+    Entry* e = new Entry{K(std::forward<KK>(key)), V(), ht.table[idx]};
+    ht.table[idx] = e;
+    ++ht.used;
+    return std::make_pair(e, true);
+  }
+
+  void _ExpandIfNeeded() {
+    if (isRehashing())
+      return;
+    if (ht_[0].size == 0) {
+      _Resize(kInitSize);
+      return;
+    }
+    if (ht_[0].used >= ht_[0].size)
+      _Resize(ht_[0].used + 1);
+  }
+
+  // 大小取不小于 n 的 2 的幂；旧表为空时直接替换，否则开始渐进迁移
+  bool _Resize(std::size_t n) {
+    std::size_t size = kInitSize;
+    while (size < n)
+      size <<= 1;
+    if (size == ht_[0].size)
+      return false;
+
+    Table t;
+    t.table = static_cast<Entry**>(std::calloc(size, sizeof(Entry*)));
+    if (!t.table)
+      throw std::bad_alloc();
+    t.size = size;
+    t.mask = size - 1;
+
+    if (ht_[0].table == nullptr || ht_[0].used == 0) {
+      _Free(ht_[0]);
+      ht_[0] = t;
+      return true;
+    }
+    ht_[1] = t;
+    rehashIdx_ = 0;
+    return true;
+  }
+
+  void _Free(Table& ht) {
+    for (std::size_t i = 0; i < ht.size && ht.used > 0; ++i) {
+      Entry* e = ht.table[i];
+      while (e) {
+        Entry* next = e->next;
+        delete e;
+        --ht.used;
+        e = next;
+      }
+    }
+    std::free(ht.table);
+    ht = Table();
+  }
+
+  template <typename Fn>
+  static void _ScanBucket(const Table& ht, uint64_t cursor, Fn& fn) {
+    for (const Entry* e = ht.table[cursor & ht.mask]; e; e = e->next)
+      fn(*e);
+  }
+
+  // 对掩码内的位做反向加一：翻转后加一再翻转回来
+  static uint64_t _NextCursor(uint64_t v, uint64_t mask) {
+    v |= ~mask;
+    v = _Reverse(v);
+    ++v;
+    return _Reverse(v);
+  }
+
+  static uint64_t _Reverse(uint64_t v) {
+    v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+    v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return __builtin_bswap64(v);
+  }
+
+  Table ht_[2];
+  long long rehashIdx_;  // 下一个要迁移的 ht_[0] 桶，-1 表示没有在 rehash
+  int pauseRehash_;      // 存活的安全迭代器与进行中的 scan
+  Hash hash_;
+  Equal equal_;
+};
+
+template <typename K, typename V, typename H, typename E>
+const std::size_t Dict<K, V, H, E>::kInitSize;
+template <typename K, typename V, typename H, typename E>
+const std::size_t Dict<K, V, H, E>::kMinFillRatio;
+}  // namespace tinyredis
+
+#endif
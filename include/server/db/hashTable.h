@@ -0,0 +1,52 @@
+#ifndef SERVER_DB_HASHTABLE_H
+#define SERVER_DB_HASHTABLE_H
+
+#include <server/db/dict.h>
+#include <server/db/swissTable.h>
+#include <server/protocol/respParser.h>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+
+namespace tinyredis {
+// 键的哈希（MurmurHash64A），std::string 与 Slice 得到相同结果，
+// 命令可以直接用请求中的参数查找，不必先构造 std::string
+uint64_t hashBytes(const void* data, std::size_t len);
+
+struct KeyHash {
+  uint64_t operator()(const std::string& key) const {
+    return hashBytes(key.data(), key.size());
+  }
+  uint64_t operator()(const Slice& key) const {
+    return hashBytes(key.data, key.len);
+  }
+};
+
+struct KeyEqual {
+  bool operator()(const std::string& a, const std::string& b) const {
+    return a == b;
+  }
+  bool operator()(const std::string& a, const Slice& b) const {
+    return a.size() == b.len && std::memcmp(a.data(), b.data, b.len) == 0;
+  }
+};
+
+// 键空间、hash 的字段、set 的成员使用的哈希表，构建时选择实现：
+// 默认为渐进式 rehash 的链式表 Dict，
+// 以 -DTINYREDIS_HASH_ENGINE=swiss 构建时为 SIMD 开放寻址的 SwissTable。
+// 两者接口相同，调用方只依赖这里的 HashTable
+#ifdef TINYREDIS_SWISS_TABLE
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Equal = std::equal_to<K>>
+using HashTable = SwissTable<K, V, Hash, Equal>;
+const char* const kHashEngine = "swiss";
+#else
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Equal = std::equal_to<K>>
+using HashTable = Dict<K, V, Hash, Equal>;
+const char* const kHashEngine = "chained";
+#endif
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef SERVER_DB_HASHTYPE_H
+#define SERVER_DB_HASHTYPE_H
+
+#include <server/db/object.h>
+
+namespace tinyredis {
+// hash 类型的操作，按编码分派：listpack 中字段与值交替存放，
+// 字段数或任一字段/值的长度超过阈值时转换为哈希表
+namespace hashType {
+Object create();
+std::size_t size(const Object& o);
+// 取字段的值；listpack 中的整数格式化到 buf（至少 Listpack::kIntBufSize 字节）
+bool get(Object& o, const Slice& field, char* buf, Slice* value);
+bool exists(Object& o, const Slice& field);
+// 设置字段，返回 true 表示新字段
+bool set(Object& o, const Slice& field, const Slice& value,
+         const EncodingConfig& cfg);
+bool erase(Object& o, const Slice& field);
+void convert(Object& o);
+
+// 依次回调 fn(const Slice& field, const Slice& value)，期间不能修改 o
+template <typename Fn>
+void forEach(Object& o, Fn&& fn) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    const Listpack& lp = o.listpack();
+    char fbuf[Listpack::kIntBufSize];
+    char vbuf[Listpack::kIntBufSize];
+    for (std::size_t f = lp.first(); f != Listpack::npos;) {
+      const std::size_t v = lp.next(f);
+      fn(lp.get(f, fbuf), lp.get(v, vbuf));
+      f = lp.next(v);
+    }
+    return;
+  }
+  Object::HashDict::Iterator it(&o.hashDict());
+  while (Object::HashDict::Entry* e = it.next()) {
+    fn(Slice{e->key.data(), e->key.size()},
+       Slice{e->value.data(), e->value.size()});
+  }
+}
+}  // namespace hashType
+}  // namespace tinyredis
+
+#endif
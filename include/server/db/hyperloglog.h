@@ -0,0 +1,71 @@
+#ifndef SERVER_DB_HYPERLOGLOG_H
+#define SERVER_DB_HYPERLOGLOG_H
+
+#include <server/db/object.h>
+#include <server/protocol/respParser.h>
+#include <server/util/cpuFeatures.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace tinyredis {
+// HyperLogLog 与 Redis 一样存放在字符串值里（TYPE 为 string），格式也相同：
+//   <"HYLL"> <编码 u8> <3 字节保留> <基数缓存 u64 小端，最高位为 1 表示失效> <寄存器>
+// 16384 个 6 位寄存器，两种编码：
+// - dense：寄存器按位紧密排列，固定 12288 字节；
+// - sparse：游程编码，ZERO（00xxxxxx，1-64 个 0）、XZERO（01xxxxxx yyyyyyyy，
+//   1-16384 个 0）、VAL（1vvvvvxx，1-4 个值为 1-32 的寄存器）。
+//   新建的 HLL 只有 2 字节的寄存器；超过 hll-sparse-max-bytes 或出现大于 32 的值时
+//   转为 dense，之后不再转回。
+// 合并与计数在每个寄存器一字节的 Registers 上进行：dense 每 3 字节拆成 4 个寄存器
+// 后逐个取最大值，AVX2 一次处理 32 个寄存器。x86-64 上根据 CPUID 选择内核
+namespace hll {
+const std::size_t kRegisters = 16384;
+const std::size_t kHeaderSize = 16;
+const std::size_t kDenseSize = kHeaderSize + kRegisters * 6 / 8;
+
+enum class Kernel {
+  kScalar,
+  kAvx2,
+};
+
+// 展开的寄存器。对齐到 32 字节以免向量访问跨缓存行；
+// C++11 的全局 new 不保证超出 max_align_t 的对齐，所以堆上分配走类自己的
+// operator new（posix_memalign）。内核仍按非对齐访问，不依赖这个对齐的正确性
+struct alignas(32) Registers {
+  static void* operator new(std::size_t size);
+  static void operator delete(void* p);
+
+  uint8_t r[kRegisters];
+};
+
+// 空的 HLL，sparse 编码
+Object create();
+// 头部与长度是否合法；sparse 的内容在解码时检查
+bool valid(const Slice& s);
+bool isDense(const Slice& s);
+
+// 把 element 加入 o（调用方保证 valid），sparse 超过 sparseMaxBytes 字节时转为 dense。
+// 返回 1 表示有寄存器变大（同时使基数缓存失效），0 表示没有变化，-1 表示内容损坏
+int add(Object& o, const Slice& element, std::size_t sparseMaxBytes);
+
+// 把 hll 的寄存器按位置取最大值合并到 regs，内容损坏时返回 false
+bool merge(Registers& regs, const Slice& hll);
+// 按 regs 估计基数（Ertl 的改进估计，与 Redis 相同）
+uint64_t count(const Registers& regs);
+// 单个 HLL 的基数：缓存有效时直接返回，否则计算后写回缓存。内容损坏时返回 false
+bool count(Object& o, uint64_t* card);
+// 用 regs 覆盖 o：dense 为 false 且寄存器都不超过 32、sparse 不超过 sparseMaxBytes
+// 时写为 sparse，否则写为 dense
+void store(Object& o, const Registers& regs, bool dense,
+           std::size_t sparseMaxBytes);
+
+// 当前线程的寄存器数组，PFCOUNT/PFMERGE 合并多个键时使用，不必每次分配
+Registers& scratch();
+
+// 当前内核的查询与切换
+KernelSelector<Kernel>& kernels();
+const char* kernelName(Kernel kernel);
+}  // namespace hll
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef SERVER_DB_INTSET_H
+#define SERVER_DB_INTSET_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tinyredis {
+// 全是整数的集合：有序、无重复的整数数组，与 Redis 的 intset 相同：
+//   <元素宽度 u32> <元素个数 u32> <元素 ...>
+// 元素宽度是 2/4/8 字节中能容纳全部元素的最小值，加入更大的数时整体升级，不会降级。
+// 查找是二分，插入和删除移动其后的元素；每个成员只占 2 到 8 字节，
+// 元素按本机字节序存放，求交集时可以直接按 SIMD 向量加载（见 intsetIntersect.h）。
+//
+// 与 Listpack 一样只是对缓冲区的句柄，持有者负责调用 destroy()
+class Intset {
+ public:
+  static const std::size_t kHeaderSize = 8;
+
+  // 空句柄，使用前需要 create()
+  Intset() = default;
+  static Intset create();
+  void destroy();
+
+  std::size_t size() const;
+  bool empty() const { return size() == 0; }
+  // 元素宽度（字节）：2、4 或 8
+  int width() const;
+  // 整块内存的字节数
+  std::size_t bytes() const { return kHeaderSize + size() * width(); }
+  const unsigned char* data() const { return buf_; }
+  const void* contents() const { return buf_ + kHeaderSize; }
+
+  // 第 i 个（从小到大）元素
+  int64_t get(std::size_t i) const;
+  bool contains(int64_t v) const;
+  // 返回 false 表示已存在
+  bool add(int64_t v);
+  bool erase(int64_t v);
+
+  // 能容纳 v 的最小宽度
+  static int widthOf(int64_t v);
+
+ private:
+  // 二分查找：找到时返回 true，*pos 为其下标，否则为插入位置
+  bool _Search(int64_t v, std::size_t* pos) const;
+  void _SetSize(std::size_t n);
+  // 按新的宽度从后往前展开所有元素，v 一定在两端之一
+  void _Upgrade(int64_t v);
+
+  unsigned char* buf_;
+};
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef SERVER_DB_INTSETINTERSECT_H
+#define SERVER_DB_INTSETINTERSECT_H
+
+#include <server/db/intset.h>
+#include <server/util/cpuFeatures.h>
+#include <cstddef>
+
+namespace tinyredis {
+// 有序整数数组求交集的内核，SINTER/SINTERCARD 在所有集合都是 intset 时使用。
+// 两边大小相近时分块归并：每次各取一个向量的元素两两比较（一边循环移位），
+// 按两块的最大值决定前进哪一边；一边远小于另一边时对小的一边逐个
+// 在大的一边倍增查找到所在的块，再整块比较。
+// 两边宽度相同时才走 SIMD，宽度不同的交集不会比较窄的一边宽，按标量处理。
+// x86-64 上根据 CPUID 选择 AVX2，否则用标量实现；程序启动时选定
+enum class IntersectKernel {
+  kScalar,
+  kAvx2,
+};
+
+// 有序、无重复的整数数组的只读视图
+struct IntArray {
+  const void* data;
+  std::size_t size;
+  int width;  // 2、4 或 8 字节
+
+  static IntArray of(const Intset& is) {
+    return IntArray{is.contents(), is.size(), is.width()};
+  }
+};
+
+// a 与 b 的交集按从小到大写入 out，宽度为两者中较小的一个；
+// out 至少能放下 min(a.size, b.size) 个元素，为 nullptr 时只计数。
+// limit 不为 0 时找到 limit 个就停止。返回交集的元素个数
+std::size_t intersect(const IntArray& a, const IntArray& b, void* out,
+                      std::size_t limit);
+
+// 当前内核的查询与切换
+KernelSelector<IntersectKernel>& intersectKernels();
+const char* intersectKernelName(IntersectKernel kernel);
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef SERVER_DB_LISTTYPE_H
+#define SERVER_DB_LISTTYPE_H
+
+#include <server/db/object.h>
+#include <string>
+#include <utility>
+
+namespace tinyredis {
+// list 类型的操作，按编码分派：listpack 超过 list-max-listpack-size 后
+// 转换为 quicklist
+namespace listType {
+Object create();
+std::size_t size(const Object& o);
+void push(Object& o, const Slice& value, bool head, const EncodingConfig& cfg);
+// 弹出一端的元素，list 为空时返回 false
+bool pop(Object& o, bool head, std::string* out);
+// 第 index 个元素，负数从末尾算起
+bool index(Object& o, long long index, std::string* out);
+// 节点大小与压缩深度取 cfg 当前的值，之后不随 CONFIG SET 改变
+void convert(Object& o, const EncodingConfig& cfg);
+
+// 依次回调下标 [start, stop] 的元素 fn(const Slice&)，调用方保证下标有效
+template <typename Fn>
+void range(Object& o, std::size_t start, std::size_t stop, Fn&& fn) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    const Listpack& lp = o.listpack();
+    char buf[Listpack::kIntBufSize];
+    std::size_t p = lp.seek(static_cast<long long>(start));
+    for (std::size_t i = start; i <= stop; ++i, p = lp.next(p))
+      fn(lp.get(p, buf));
+    return;
+  }
+  o.quicklist().range(start, stop, std::forward<Fn>(fn));
+}
+}  // namespace listType
+}  // namespace tinyredis
+
+#endif
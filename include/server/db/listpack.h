@@ -0,0 +1,84 @@
+#ifndef SERVER_DB_LISTPACK_H
+#define SERVER_DB_LISTPACK_H
+
+#include <server/protocol/respParser.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace tinyredis {
+// 紧凑列表：所有元素按变长编码连续存放在一块内存里：
+//   <总字节数 u32> <元素个数 u32> <元素 ...> <0xFF>
+//   元素 = <编码与内容> <反向长度>
+// 头部 8 字节，与 Redis listpack 的 6 字节头部（元素个数只有 u16）不同，
+// 缓冲区不能与 Redis 互换。
+// 能无损往返的整数按 7/13/16/24/32/64 位存放（多字节整数小端），
+// 字符串带 6/12/32 位长度前缀；
+// 反向长度是 "编码与内容" 的字节数，占 1 到 5 字节，每字节存 7 位，高位组在前，
+// 除第一个字节外最高位置 1：从元素末尾往前读，遇到最高位为 0 的字节结束，用于反向遍历。
+// 小的 hash/list/set/zset 用它代替节点式容器：一次分配，顺序扫描对缓存友好。
+//
+// Listpack 只是对缓冲区的句柄，可以按值复制，但只有一个副本拥有缓冲区，
+// 持有者负责调用 destroy()；修改可能 realloc，修改之前取得的位置全部失效。
+class Listpack {
+ public:
+  static const std::size_t kHeaderSize = 8;
+  static const std::size_t npos = static_cast<std::size_t>(-1);
+  // get() 格式化整数需要的缓冲区大小
+  static const std::size_t kIntBufSize = 24;
+
+  // 空句柄，使用前需要 create()
+  Listpack() = default;
+  static Listpack create();
+  // 接管 malloc 分配的、内容是完整 listpack 的缓冲区（例如解压得到的）
+  static Listpack fromBuffer(unsigned char* buf);
+  void destroy();
+
+  std::size_t size() const;
+  bool empty() const { return size() == 0; }
+  // 整块内存的字节数
+  std::size_t bytes() const;
+  const unsigned char* data() const { return buf_; }
+
+  // 位置是元素在缓冲区中的偏移，没有元素时为 npos
+  std::size_t first() const;
+  std::size_t last() const;
+  std::size_t next(std::size_t pos) const;
+  std::size_t prev(std::size_t pos) const;
+  // 第 index 个元素，负数从末尾算起
+  std::size_t seek(long long index) const;
+
+  // 字符串元素返回指向缓冲区的 Slice；整数元素格式化到 buf（至少 kIntBufSize 字节）
+  Slice get(std::size_t pos, char* buf) const;
+  // 整数编码的元素返回 true
+  bool getInteger(std::size_t pos, long long* v) const;
+  bool equals(std::size_t pos, const Slice& s) const;
+  // 从 pos 开始找与 s 相等的元素，每比较一个跳过 skip 个（例如 hash 只比较字段），
+  // 没找到返回 npos
+  std::size_t find(std::size_t pos, const Slice& s, std::size_t skip) const;
+
+  void append(const Slice& s) { insert(npos, s); }
+  void prepend(const Slice& s) { insert(first(), s); }
+  // 在 pos 之前插入，pos 为 npos 时追加到末尾；返回新元素的位置
+  std::size_t insert(std::size_t pos, const Slice& s);
+  // 替换 pos 处的元素，返回其位置
+  std::size_t replace(std::size_t pos, const Slice& s);
+  // 删除从 pos 开始的 n 个元素（不足 n 个时删到末尾），返回删除后位于 pos 的元素
+  std::size_t erase(std::size_t pos, std::size_t n = 1);
+
+  // 按 s 编码成元素后的字节数（含反向长度），用于判断是否超过大小阈值
+  static std::size_t entrySize(const Slice& s);
+
+ private:
+  // pos 处元素 "编码与内容" 部分的字节数
+  std::size_t _EncodedSize(std::size_t pos) const;
+  std::size_t _EntrySize(std::size_t pos) const;
+  void _SetBytes(std::size_t n);
+  void _SetSize(std::size_t n);
+  // p 是否指向本缓冲区内，插入的内容可能来自 get() 返回的 Slice
+  bool _Owns(const char* p) const;
+
+  unsigned char* buf_;
+};
+}  // namespace tinyredis
+
+#endif
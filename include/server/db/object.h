@@ -0,0 +1,212 @@
+#ifndef SERVER_DB_OBJECT_H
+#define SERVER_DB_OBJECT_H
+
+#include <server/db/bplusTree.h>
+#include <server/db/hashTable.h>
+#include <server/db/intset.h>
+#include <server/db/listpack.h>
+#include <server/db/quicklist.h>
+#include <server/db/stream.h>
+#include <server/protocol/respParser.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace tinyredis {
+// 小聚合类型使用 listpack 的阈值（CONFIG SET 可修改），默认值与 Redis 相同。
+// 元素个数或任一元素的字节数超过阈值时转换为完整结构，之后不再转回
+struct EncodingConfig {
+  std::size_t hashMaxListpackEntries = 128;
+  std::size_t hashMaxListpackValue = 64;
+  std::size_t setMaxListpackEntries = 128;
+  std::size_t setMaxListpackValue = 64;
+  // 全是整数的 set 使用 intset 的元素个数上限
+  std::size_t setMaxIntsetEntries = 512;
+  std::size_t zsetMaxListpackEntries = 128;
+  std::size_t zsetMaxListpackValue = 64;
+  // 正数为元素个数上限；-1 到 -5 为字节数上限 4KB/8KB/16KB/32KB/64KB。
+  // 同时也是 quicklist 每个节点的大小上限
+  long long listMaxListpackSize = -2;
+  // quicklist 两端不压缩的节点数，0 表示不压缩
+  long long listCompressDepth = 0;
+  // sparse 编码的 HyperLogLog 的字节数上限（含 16 字节的头），超过时转为 dense
+  std::size_t hllSparseMaxBytes = 3000;
+  // stream 每个 listpack 节点的字节数与条目数上限，0 表示不限制
+  std::size_t streamNodeMaxBytes = 4096;
+  std::size_t streamNodeMaxEntries = 100;
+
+  // 按 listMaxListpackSize 判断 bytes 字节、count 个元素的 listpack 是否仍在上限内
+  bool listFits(std::size_t bytes, std::size_t count) const {
+    return Quicklist::listpackFits(listMaxListpackSize, bytes, count);
+  }
+};
+
+// 键空间中的值。对象头（类型、编码、短字符串长度）16 字节，直接存放在哈希表的元素里，
+// 字符串按编码存放：
+// - int：能无损往返的 64 位整数直接存在对象头里，不做任何分配；
+// - embstr：不超过 kEmbStrMaxLen 字节的字符串，一次恰好大小的分配，长度在对象头里，只读；
+// - raw：更长的字符串或被修改过的字符串，带 {len, cap, refs} 头的缓冲区，
+//   APPEND/SETRANGE 按 sds 的规则预留空间，原地追加不必每次重新分配。
+//   零拷贝发送的大回复通过 shareString() 共同持有缓冲区，
+//   此时的修改先复制一份（写时复制），删除对象也只是放弃自己的引用。
+// 编码对命令透明：修改操作会先把 int/embstr 转为 raw，INCR 等把结果写回 int。
+//
+// hash/list/set/zset 小的时候都是一个 listpack（hash 与 zset 按 字段/值、成员/分数
+// 交替存放，zset 按分数有序），全是整数的 set 是 intset；
+// 超过 EncodingConfig 的阈值后转换为完整结构：
+// hash、set 为 HashTable，list 为 quicklist，zset 为 B+ 树加字典。
+// stream 只有一种编码，见 stream.h。
+// 各类型的操作见 hashType.h 等，它们负责按编码分派和转换
+class Object {
+ public:
+  enum class Type : uint8_t {
+    kString,
+    kList,
+    kHash,
+    kSet,
+    kZset,
+    kStream,
+  };
+
+  enum class Encoding : uint8_t {
+    kInt,
+    kEmbStr,
+    kRaw,
+    kListpack,
+    kHashTable,
+    kQuicklist,
+    kBTree,
+    kIntset,
+    kStream,
+  };
+
+  // 各类型完整结构
+  using HashDict = HashTable<std::string, std::string, KeyHash, KeyEqual>;
+  using SetDict = HashTable<std::string, bool, KeyHash, KeyEqual>;
+  using ZsetDict = HashTable<std::string, double, KeyHash, KeyEqual>;
+  struct ZsetTree {
+    ZsetDict dict;   // 成员到分数
+    BPlusTree tree;  // 按 (分数, 成员) 排序，带子树计数
+  };
+
+  static const std::size_t kEmbStrMaxLen = 44;
+  // 字符串值的上限（proto-max-bulk-len 的默认值）
+  static const std::size_t kMaxStringLen = 512 * 1024 * 1024;
+  // 整数编码格式化为字符串需要的缓冲区大小
+  static const std::size_t kIntBufSize = 24;
+
+  // 空字符串
+  Object() : type_(Type::kString), encoding_(Encoding::kEmbStr), len_(0) {
+    emb_ = nullptr;
+  }
+  ~Object() { _Release(); }
+
+  Object(Object&& other) noexcept;
+  Object& operator=(Object&& other) noexcept;
+  Object(const Object&) = delete;
+  void operator=(const Object&) = delete;
+
+  // 按内容选择最省内存的编码
+  static Object fromString(const char* data, std::size_t len);
+  static Object fromInteger(long long v);
+  // 空的聚合类型，编码为 listpack
+  static Object createAggregate(Type type);
+  // 空的 set，编码为 intset
+  static Object createIntset();
+  static Object createStream();
+
+  Type type() const { return type_; }
+  Encoding encoding() const { return encoding_; }
+  // OBJECT ENCODING 的返回值
+  const char* encodingName() const;
+  // TYPE 的返回值
+  const char* typeName() const;
+
+  std::size_t stringLength() const;
+  // 字符串内容；int 编码时格式化到 buf（至少 kIntBufSize 字节）中，
+  // 返回值在对象被修改或 buf 失效之前有效
+  Slice stringValue(char* buf) const;
+  // 内容能按 parseLongLong 的规则解析为整数时返回 true
+  bool integerValue(long long* out) const;
+  // raw 编码的内容的共享引用，用于零拷贝发送：持有期间内容不变、内存不释放，
+  // 对象被修改或删除不影响它。其他编码返回空。可以在其他线程上释放
+  std::shared_ptr<const char> shareString() const;
+
+  // 在末尾追加；调用方保证结果不超过 kMaxStringLen
+  void append(const char* data, std::size_t len);
+  // 从 offset 开始覆盖写入，超出原长度的部分先以 0 填充
+  void setRange(std::size_t offset, const char* data, std::size_t len);
+  // 转为 raw 编码，长度不足 minLen 时以 0 补齐，返回可写的内容；
+  // 用于 SETBIT/BITFIELD 等按位修改。调用方保证 minLen 不超过 kMaxStringLen
+  char* mutableString(std::size_t minLen);
+  // 截断为前 len 个字节，len 不超过当前长度
+  void truncate(std::size_t len);
+
+  // 聚合类型按编码取内部结构，编码不符时行为未定义
+  Listpack& listpack() { return lp_; }
+  const Listpack& listpack() const { return lp_; }
+  Intset& intset() { return intset_; }
+  const Intset& intset() const { return intset_; }
+  HashDict& hashDict() { return *hash_; }
+  SetDict& setDict() { return *set_; }
+  Quicklist& quicklist() { return *list_; }
+  ZsetTree& zsetTree() { return *zset_; }
+  Stream& stream() { return *stream_; }
+
+  // 把 listpack（或 intset）编码的聚合类型换成完整结构，
+  // 由各类型的转换函数构造好后交给对象
+  void adoptHashDict(HashDict* d);
+  void adoptSetDict(SetDict* d);
+  void adoptQuicklist(Quicklist* l);
+  void adoptZsetTree(ZsetTree* z);
+  // intset 加入非整数成员时换成 listpack
+  void adoptListpack(Listpack lp);
+
+  // 值在堆上占用的字节数（按分配器实际大小），不含对象头；
+  // 完整结构的聚合类型抽样若干元素估计，与 Redis 的 MEMORY USAGE 相同
+  std::size_t allocatedBytes() const;
+
+ private:
+  struct RawHeader {
+    uint32_t len;
+    uint32_t cap;
+    // 对象自己算一个，shareString() 每次加一；大于 1 时只读
+    std::atomic<uint32_t> refs;
+    // 随后是 cap 字节的数据
+  };
+
+  static char* _RawData(RawHeader* raw) {
+    return reinterpret_cast<char*>(raw + 1);
+  }
+
+  static RawHeader* _NewRaw(std::size_t len, std::size_t cap);
+  // 放弃一个引用，最后一个引用释放缓冲区
+  static void _Unref(RawHeader* raw);
+  // 转为独占的 raw 编码并保证容量不小于 minCap
+  void _MakeRaw(std::size_t minCap);
+  // 释放 listpack 或 intset 并换成完整结构
+  void _Adopt(Encoding encoding, void* p);
+  void _ReleaseCompact();
+  void _Release();
+
+  Type type_;
+  Encoding encoding_;
+  uint32_t len_;  // embstr 的长度
+  union {
+    long long int_;
+    char* emb_;
+    RawHeader* raw_;
+    Listpack lp_;
+    Intset intset_;
+    HashDict* hash_;
+    SetDict* set_;
+    Quicklist* list_;
+    ZsetTree* zset_;
+    Stream* stream_;
+  };
+};
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef SERVER_DB_QUICKLIST_H
+#define SERVER_DB_QUICKLIST_H
+
+#include <server/db/listpack.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace tinyredis {
+// 大 list 的编码，与 Redis 的 quicklist 相同：listpack 节点组成的双向链表。
+// 每个节点按 fill（即 list-max-listpack-size）限制大小，元素按节点成块存放，
+// 指针与分配器的开销由整个节点分摊，而不是每个元素一份。
+// compressDepth 大于 0 时，两端各 compressDepth 个节点之外的中间节点用 LZF 压缩，
+// 队列式的 list 只在两端读写，中间的大部分数据一直保持压缩；
+// 两端的节点总是未压缩的，push/pop 是 O(1)。
+// 按下标访问时先按节点的元素个数整块跳过，只在目标节点内线性查找，
+// 读取被压缩的节点时解压到临时缓冲区，不改变节点本身
+class Quicklist {
+ public:
+  struct Node {
+    Node* prev;
+    Node* next;
+    Listpack lp;         // 未压缩时的内容，压缩时为空句柄
+    unsigned char* lzf;  // 压缩后的内容，未压缩时为 nullptr
+    uint32_t lzfBytes;
+    uint32_t count;  // 元素个数
+    uint32_t bytes;  // listpack 的字节数，压缩时为解压后的大小
+  };
+
+  Quicklist(long long fill, long long compressDepth);
+  ~Quicklist();
+
+  Quicklist(const Quicklist&) = delete;
+  void operator=(const Quicklist&) = delete;
+
+  std::size_t size() const { return count_; }
+  std::size_t nodeCount() const { return nodes_; }
+  std::size_t compressedNodes() const;
+  const Node* head() const { return head_; }
+
+  void push(const Slice& value, bool head);
+  // 弹出一端的元素，list 为空时返回 false
+  bool pop(bool head, std::string* out);
+  // 第 index 个元素，负数从末尾算起
+  bool index(long long index, std::string* out) const;
+
+  // 依次回调下标 [start, stop] 的元素 fn(const Slice&)，调用方保证下标有效
+  template <typename Fn>
+  void range(std::size_t start, std::size_t stop, Fn&& fn) const {
+    std::size_t offset;
+    const Node* n = _Locate(start, &offset);
+    std::size_t left = stop - start + 1;
+    char buf[Listpack::kIntBufSize];
+    for (; left > 0; n = n->next, offset = 0) {
+      NodeView view(n);
+      const Listpack& lp = view.listpack();
+      for (std::size_t p = lp.seek(static_cast<long long>(offset));
+           p != Listpack::npos && left > 0; p = lp.next(p), --left)
+        fn(lp.get(p, buf));
+    }
+  }
+
+  // 节点与内容在堆上占用的字节数
+  std::size_t allocatedBytes() const;
+
+  // fill 的含义与 list-max-listpack-size 相同：正数为元素个数上限（且节点不超过
+  // 8KB），-1 到 -5 为字节数上限 4KB 到 64KB
+  static bool listpackFits(long long fill, std::size_t bytes,
+                           std::size_t count);
+
+ private:
+  // 读取节点内容：未压缩时直接引用，压缩时解压到临时缓冲区
+  class NodeView {
+   public:
+    explicit NodeView(const Node* n);
+    ~NodeView();
+    NodeView(const NodeView&) = delete;
+    void operator=(const NodeView&) = delete;
+    const Listpack& listpack() const { return lp_; }
+
+   private:
+    Listpack lp_;
+    bool owned_;
+  };
+
+  // 第 index 个元素所在的节点及其在节点内的下标，从较近的一端开始按节点跳
+  const Node* _Locate(std::size_t index, std::size_t* offset) const;
+  // push/pop 增删节点之后调用：保证两端各 depth_ 个节点未压缩，
+  // 并压缩刚好移入中间的节点
+  void _UpdateCompression();
+  static void _Compress(Node* n);
+  static void _Decompress(Node* n);
+  static void _FreeNode(Node* n);
+
+  Node* head_;
+  Node* tail_;
+  std::size_t count_;
+  std::size_t nodes_;
+  const long long fill_;
+  const std::size_t depth_;
+};
+}  // namespace tinyredis
+
+#endif
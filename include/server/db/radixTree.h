@@ -0,0 +1,116 @@
+#ifndef SERVER_DB_RADIXTREE_H
+#define SERVER_DB_RADIXTREE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tinyredis {
+// 以 16 字节的定长键（大端存放的 128 位 ID，字节序即数值序）索引指针的基数树，
+// 用于 stream 的节点索引和消费组的待确认列表。
+// 内部节点按字节分叉，只有一个分叉的路径压缩成节点的前缀，
+// 叶子存放完整的键，所以树高不超过分叉的字节数：
+// 按时间递增的 ID 共享长前缀，实际只有三四层。
+// 内部节点的子节点按字节有序，遍历是有序的；树不拥有值，由调用方释放
+class RadixTree {
+ public:
+  static const std::size_t kKeyLen = 16;
+
+  struct Node {
+    uint8_t leaf;
+  };
+
+  struct Leaf : Node {
+    unsigned char key[kKeyLen];
+    void* value;
+  };
+
+  // 子节点的分叉字节与指针按容量放在节点之后的同一块内存里
+  struct Inner : Node {
+    uint8_t prefixLen;
+    uint16_t count;
+    uint16_t cap;
+    unsigned char prefix[kKeyLen];
+  };
+
+  // 有序遍历的位置，树被修改后失效
+  class Cursor {
+   public:
+    explicit Cursor(const RadixTree& tree) : tree_(tree), depth_(0),
+                                            leaf_(nullptr) {}
+
+    bool valid() const { return leaf_ != nullptr; }
+    const unsigned char* key() const { return leaf_->key; }
+    void* value() const { return leaf_->value; }
+
+    // 定位到第一个或最后一个键
+    bool first();
+    bool last();
+    // 定位到不小于（ceil）或不大于（floor）key 的键，没有时返回 false
+    bool seekCeil(const unsigned char* key);
+    bool seekFloor(const unsigned char* key);
+    bool next();
+    bool prev();
+
+   private:
+    void _Push(const Inner* n, int index);
+    // 从 node 一直走到最小或最大的叶子
+    void _DescendMin(const Node* node);
+    void _DescendMax(const Node* node);
+    bool _SeekCeil(const Node* node, const unsigned char* key,
+                   std::size_t depth);
+    bool _SeekFloor(const Node* node, const unsigned char* key,
+                    std::size_t depth);
+
+    const RadixTree& tree_;
+    // 从根到当前叶子经过的内部节点及所走的分叉，层数不超过键长
+    const Inner* nodes_[kKeyLen];
+    int indexes_[kKeyLen];
+    std::size_t depth_;
+    const Leaf* leaf_;
+  };
+
+  RadixTree() : root_(nullptr), size_(0), bytes_(0) {}
+  ~RadixTree();
+
+  RadixTree(const RadixTree&) = delete;
+  void operator=(const RadixTree&) = delete;
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // 键已存在时不修改并返回 false
+  bool insert(const unsigned char* key, void* value);
+  // 指向键对应值的位置，可用于替换值；不存在时返回 nullptr
+  void** find(const unsigned char* key) const;
+  // 删除键，*old 为原来的值；不存在时返回 false
+  bool erase(const unsigned char* key, void** old = nullptr);
+
+  // 节点占用的字节数
+  std::size_t nodeBytes() const { return bytes_; }
+
+ private:
+  static unsigned char* _Keys(Inner* n) {
+    return reinterpret_cast<unsigned char*>(n + 1);
+  }
+  static const unsigned char* _Keys(const Inner* n) {
+    return reinterpret_cast<const unsigned char*>(n + 1);
+  }
+  static Node** _Children(Inner* n);
+  static Node* const* _Children(const Inner* n);
+  static std::size_t _InnerBytes(std::size_t cap);
+
+  Leaf* _NewLeaf(const unsigned char* key, void* value);
+  Inner* _NewInner(const unsigned char* prefix, std::size_t prefixLen,
+                   std::size_t cap);
+  // 在 *slot 指向的内部节点中加入分叉 b，容量不够时重新分配并更新 *slot
+  void _AddChild(Node** slot, unsigned char b, Node* child);
+  void _FreeNode(Node* n);
+  void _Free(Node* n);
+
+  Node* root_;
+  std::size_t size_;
+  std::size_t bytes_;
+};
+}  // namespace tinyredis
+
+#endif
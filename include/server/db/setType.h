@@ -0,0 +1,57 @@
+#ifndef SERVER_DB_SETTYPE_H
+#define SERVER_DB_SETTYPE_H
+
+#include <server/db/object.h>
+#include <server/protocol/respShared.h>
+#include <string>
+#include <vector>
+
+namespace tinyredis {
+// set 类型的操作，按编码分派：全是整数时为 intset，加入非整数成员后转为 listpack；
+// 成员个数或任一成员的长度超过阈值时转换为哈希表
+namespace setType {
+// 空的 set，编码为 listpack
+Object create();
+// 按第一个成员选择编码：整数时为 intset
+Object create(const Slice& first);
+std::size_t size(const Object& o);
+bool contains(Object& o, const Slice& member);
+// 返回 true 表示新成员
+bool add(Object& o, const Slice& member, const EncodingConfig& cfg);
+bool erase(Object& o, const Slice& member);
+void convert(Object& o);
+
+// sets 的交集，sets 按大小从小到大重新排列；全部是 intset 时用
+// intsetIntersect.h 的内核，否则遍历最小的集合逐个查找其余集合。
+// limit 不为 0 时找到 limit 个就停止；out 为 nullptr 时只计数。返回交集的大小
+std::size_t intersect(std::vector<Object*>& sets, std::size_t limit,
+                      std::vector<std::string>* out);
+
+// 依次回调 fn(const Slice& member)，期间不能修改 o
+template <typename Fn>
+void forEach(Object& o, Fn&& fn) {
+  if (o.encoding() == Object::Encoding::kIntset) {
+    const Intset& is = o.intset();
+    char buf[Object::kIntBufSize];
+    char* end = buf + sizeof(buf);
+    for (std::size_t i = 0; i < is.size(); ++i) {
+      const char* p = formatDecimal(end, is.get(i));
+      fn(Slice{p, static_cast<std::size_t>(end - p)});
+    }
+    return;
+  }
+  if (o.encoding() == Object::Encoding::kListpack) {
+    const Listpack& lp = o.listpack();
+    char buf[Listpack::kIntBufSize];
+    for (std::size_t p = lp.first(); p != Listpack::npos; p = lp.next(p))
+      fn(lp.get(p, buf));
+    return;
+  }
+  Object::SetDict::Iterator it(&o.setDict());
+  while (Object::SetDict::Entry* e = it.next())
+    fn(Slice{e->key.data(), e->key.size()});
+}
+}  // namespace setType
+}  // namespace tinyredis
+
+#endif
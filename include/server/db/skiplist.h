@@ -0,0 +1,68 @@
+#ifndef SERVER_DB_SKIPLIST_H
+#define SERVER_DB_SKIPLIST_H
+
+#include <server/protocol/respParser.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace tinyredis {
+// 有序集合的跳表，与 Redis 的 zskiplist 相同：按 (score, member) 排序，
+// 每层的前向指针记录跨越的元素数（span），按排名访问和求排名都是 O(log N)；
+// 第 0 层带后向指针，可以反向遍历。不检查成员是否重复，由调用方（配合字典）保证。
+// zset 的完整编码已改用 BPlusTree，跳表保留作为基准测试的对照
+class SkipList {
+ public:
+  static const int kMaxLevel = 32;
+  static const std::size_t npos = static_cast<std::size_t>(-1);
+
+  struct Node {
+    std::string member;
+    double score;
+    Node* backward;
+    struct Level {
+      Node* forward;
+      std::size_t span;
+    } level[1];  // 实际层数在分配时决定
+  };
+
+  SkipList();
+  ~SkipList();
+
+  SkipList(const SkipList&) = delete;
+  void operator=(const SkipList&) = delete;
+
+  std::size_t size() const { return length_; }
+  Node* first() const { return header_->level[0].forward; }
+  Node* last() const { return tail_; }
+  static Node* next(const Node* n) { return n->level[0].forward; }
+  static Node* prev(const Node* n) { return n->backward; }
+
+  Node* insert(double score, const Slice& member);
+  bool erase(double score, const Slice& member);
+  // 修改已存在元素的分数，位置不变时原地修改；返回元素（可能是新节点）
+  Node* updateScore(double score, const Slice& member, double newScore);
+
+  // 从 0 开始的排名，不存在时返回 npos
+  std::size_t rank(double score, const Slice& member) const;
+  // 排名为 rank（从 0 开始）的元素，越界时返回 nullptr
+  Node* byRank(std::size_t rank) const;
+
+  // 节点及其成员占用的字节数估计（用于 MEMORY USAGE）
+  static std::size_t nodeBytes(const Node* n);
+
+ private:
+  static Node* _CreateNode(int level, double score, const Slice& member);
+  static void _FreeNode(Node* n);
+  int _RandomLevel();
+  void _Unlink(Node* x, Node** update);
+
+  Node* header_;
+  Node* tail_;
+  std::size_t length_;
+  int level_;
+  uint64_t rng_;
+};
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,287 @@
+#ifndef SERVER_DB_STREAM_H
+#define SERVER_DB_STREAM_H
+
+#include <server/db/listpack.h>
+#include <server/db/radixTree.h>
+#include <server/protocol/respParser.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tinyredis {
+// 条目 ID：毫秒时间戳与同一毫秒内的序号
+struct StreamId {
+  uint64_t ms;
+  uint64_t seq;
+
+  static StreamId min() { return StreamId{0, 0}; }
+  static StreamId max() { return StreamId{UINT64_MAX, UINT64_MAX}; }
+
+  // 大端存放的 16 字节，字节序与 ID 的顺序一致，作为基数树的键
+  void encode(unsigned char* out) const;
+  static StreamId decode(const unsigned char* in);
+
+  bool operator==(const StreamId& o) const {
+    return ms == o.ms && seq == o.seq;
+  }
+  bool operator!=(const StreamId& o) const { return !(*this == o); }
+  bool operator<(const StreamId& o) const {
+    return ms < o.ms || (ms == o.ms && seq < o.seq);
+  }
+  bool operator>(const StreamId& o) const { return o < *this; }
+  bool operator<=(const StreamId& o) const { return !(o < *this); }
+  bool operator>=(const StreamId& o) const { return !(*this < o); }
+};
+
+struct StreamConsumer;
+class StreamGroup;
+
+// 已投递未确认的条目，由消费组的 PEL 拥有，同时挂在所属消费者的 PEL 中
+struct StreamNack {
+  uint64_t deliveryTime;  // 最后一次投递的时间（毫秒）
+  uint64_t deliveryCount;
+  StreamConsumer* consumer;
+};
+
+struct StreamConsumer {
+  explicit StreamConsumer(const std::string& n) : name(n), seenTime(0) {}
+
+  std::string name;
+  uint64_t seenTime;  // 最后一次读取或认领的时间（毫秒）
+  RadixTree pel;      // ID -> StreamNack*，不拥有
+};
+
+// 阻塞在消费组上等待新条目的一方（XREADGROUP BLOCK 的客户端）。
+// 一个等待者可以同时等待多个组，这些组可能在键空间的不同分片上，
+// 所以等待队列由一把单独的锁保护，等待、取消与唤醒在内部加锁。
+// 唤醒不会丢失：XREADGROUP 检查条目与排队、XADD 追加条目与唤醒
+// 都持有 stream 所在分片的锁
+class StreamWaiter {
+ public:
+  StreamWaiter() {}
+  // 析构前必须已经 cancelWait()
+  virtual ~StreamWaiter() {}
+
+  StreamWaiter(const StreamWaiter&) = delete;
+  void operator=(const StreamWaiter&) = delete;
+
+  // 排到 group 的等待队列末尾
+  void waitOn(StreamGroup* group);
+  // 从所有等待队列中移除
+  void cancelWait();
+  bool waiting() const;
+
+ private:
+  friend class StreamGroup;
+
+  // 被唤醒时已从所有队列中移除，在执行写命令的线程上调用；
+  // 返回 false 表示已无法读取（例如连接已关闭），由下一个等待者接替
+  virtual bool _OnWake() = 0;
+  // 持有等待队列的锁时调用
+  void _Unlink();
+
+  using WaitList = std::list<StreamWaiter*>;
+  std::vector<std::pair<StreamGroup*, WaitList::iterator>> waits_;
+};
+
+// 消费组：lastId 之后的条目尚未投递；PEL 同时按 ID（组内）和按消费者索引，
+// 两处都是基数树，确认、认领与按 ID 扫描都是 O(log n)。
+// 等待者按先来后到排队，新条目到达时只唤醒队首，不会惊动整组消费者
+class StreamGroup {
+ public:
+  using Consumers = std::map<std::string, StreamConsumer*>;
+
+  explicit StreamGroup(const StreamId& lastId)
+      : lastId_(lastId), waiterCount_(0) {}
+  ~StreamGroup();
+
+  StreamGroup(const StreamGroup&) = delete;
+  void operator=(const StreamGroup&) = delete;
+
+  const StreamId& lastId() const { return lastId_; }
+  void setLastId(const StreamId& id) { lastId_ = id; }
+
+  const RadixTree& pel() const { return pel_; }
+  const Consumers& consumers() const { return consumers_; }
+
+  StreamConsumer* consumer(const std::string& name) const;
+  // 不存在时创建，*created 表示是否新建
+  StreamConsumer* createConsumer(const std::string& name, bool* created);
+  // 删除消费者及其待确认条目，返回删除的待确认条目数；不存在时返回 -1
+  long long deleteConsumer(const std::string& name);
+
+  StreamNack* nack(const StreamId& id) const;
+  // 把条目投递给 consumer：不在 PEL 中时加入，已在时转给 consumer，
+  // 投递次数加一
+  StreamNack* deliver(const StreamId& id, StreamConsumer* consumer,
+                      uint64_t nowMs);
+  // 把已在 PEL 中的条目转给 consumer，不修改投递信息
+  void assign(const StreamId& id, StreamNack* nack, StreamConsumer* consumer);
+  // 从 PEL 中删除，不存在时返回 false
+  bool ack(const StreamId& id);
+
+  // 不加锁：XADD 每次都要检查，没有人阻塞时不应争用等待队列的锁。
+  // 排队与 XADD 都持有 stream 所在分片的锁，不会读到过时的 0
+  bool hasWaiters() const {
+    return waiterCount_.load(std::memory_order_acquire) > 0;
+  }
+  // 唤醒队首的一个等待者；wakeAll 用于组或 stream 被删除时
+  void wakeOne();
+  void wakeAll();
+
+  std::size_t allocatedBytes() const;
+
+ private:
+  friend class StreamWaiter;
+
+  StreamId lastId_;
+  RadixTree pel_;  // ID -> StreamNack*，拥有
+  Consumers consumers_;
+  StreamWaiter::WaitList waiters_;
+  std::atomic<std::size_t> waiterCount_;  // waiters_ 的长度，在锁内修改
+};
+
+// stream 的编码，与 Redis 相同：基数树以每个节点第一个条目的 ID（master ID）为键，
+// 指向一个 listpack，条目按 ID 顺序追加在其中：
+//   master 条目：<有效条目数> <已删除条目数> <字段数> <字段 ...> <0>
+//   条目：<flags> <ms 差> <seq 差> <值 ...> <元素数>
+//     或 <flags> <ms 差> <seq 差> <字段数> <字段 值 ...> <元素数>
+// ID 存为与 master ID 的差，字段与 master 相同（flags 带 kSameFields）时只存值，
+// 整数按 listpack 的变长编码，大多数条目的 ID 只占两三个字节；
+// 末尾的元素数是条目中在它之前的元素个数，用于反向遍历。
+// 节点按 stream-node-max-bytes/stream-node-max-entries 限制大小，追加只修改最后一个
+// 节点，范围查询在树上定位一次后顺序读取节点；近似裁剪（MAXLEN ~）只整块删除头部的节点，
+// 精确裁剪对剩下的第一个节点中的条目只打删除标记，不移动内存
+class Stream {
+ public:
+  enum class TrimStrategy {
+    kMaxLen,  // 保留最新的 maxLen 个条目
+    kMinId,   // 删除 ID 小于 minId 的条目
+  };
+
+  struct TrimArgs {
+    TrimStrategy strategy;
+    bool approx;  // 只删除整个节点
+    long long maxLen;
+    StreamId minId;
+    long long limit;  // approx 时最多删除的条目数，0 表示不限制
+  };
+
+  // 按 ID 范围遍历，跳过已删除的条目；遍历期间 stream 不能被修改
+  class Iterator {
+   public:
+    // [start, end] 闭区间，rev 为 true 时从 end 往 start 反向遍历
+    Iterator(const Stream& stream, const StreamId& start, const StreamId& end,
+             bool rev);
+
+    // 移动到下一个条目，范围内没有更多条目时返回 false
+    bool next(StreamId* id);
+    std::size_t numFields() const { return numFields_; }
+    // 依次回调当前条目的 fn(const Slice& field, const Slice& value)
+    template <typename Fn>
+    void forEachField(Fn&& fn) const {
+      char fbuf[Listpack::kIntBufSize];
+      char vbuf[Listpack::kIntBufSize];
+      std::size_t f = fields_;
+      std::size_t v = values_;
+      for (std::size_t i = 0; i < numFields_; ++i) {
+        fn(lp_.get(f, fbuf), lp_.get(v, vbuf));
+        if (sameFields_) {
+          f = lp_.next(f);
+          v = lp_.next(v);
+        } else {
+          f = lp_.next(lp_.next(f));
+          v = lp_.next(lp_.next(v));
+        }
+      }
+    }
+
+   private:
+    // 载入游标所在的节点，pos_ 指向第一个（反向时最后一个）条目
+    void _LoadNode();
+    // 解析从 entry 开始的条目，返回下一个条目的位置
+    std::size_t _ParseEntry(std::size_t entry, StreamId* id, bool* deleted);
+
+    RadixTree::Cursor cursor_;
+    StreamId start_;
+    StreamId end_;
+    bool rev_;
+    bool done_;
+    Listpack lp_;  // 不拥有，只是当前节点的句柄
+    StreamId master_;
+    std::size_t masterFields_;  // master 条目第一个字段的位置
+    std::size_t masterNumFields_;
+    std::size_t masterEnd_;  // master 条目结尾 0 的位置
+    std::size_t pos_;        // 下一个要解析的条目（反向时为其元素数）的位置
+    // 当前条目
+    std::size_t numFields_;
+    bool sameFields_;
+    std::size_t fields_;
+    std::size_t values_;
+  };
+
+  Stream();
+  ~Stream();
+
+  Stream(const Stream&) = delete;
+  void operator=(const Stream&) = delete;
+
+  std::size_t size() const { return length_; }
+  // 最后一个加入的条目的 ID（即使已被裁剪），空 stream 为 0-0
+  const StreamId& lastId() const { return lastId_; }
+  std::size_t nodeCount() const { return rax_.size(); }
+
+  // 自动生成的下一个 ID：当前时间大于最后一个 ID 的时间戳时为 nowMs-0，
+  // 否则在最后一个 ID 上加一。ID 已用尽时返回 false
+  bool nextId(uint64_t nowMs, StreamId* id) const;
+
+  // 追加条目，调用方保证 id 大于 lastId()。fields 为交替存放的 numFields 对
+  // 字段与值；最后一个节点达到 nodeMaxBytes 字节或 nodeMaxEntries 个条目时新建节点，
+  // 为 0 表示不限制
+  void append(const StreamId& id, const Slice* fields, std::size_t numFields,
+              std::size_t nodeMaxBytes, std::size_t nodeMaxEntries);
+
+  // 按 args 裁剪头部，返回删除的条目数
+  std::size_t trim(const TrimArgs& args);
+
+  // id 对应的条目是否存在（未被删除或裁剪）
+  bool contains(const StreamId& id) const;
+
+  // 消费组
+  StreamGroup* group(const std::string& name) const;
+  // 已存在时返回 nullptr
+  StreamGroup* createGroup(const std::string& name, const StreamId& lastId);
+  // 先唤醒组上的等待者，不存在时返回 false
+  bool destroyGroup(const std::string& name);
+  const std::map<std::string, StreamGroup*>& groups() const {
+    return groups_;
+  }
+  // 追加条目后调用：还有未投递条目的组各唤醒一个等待者
+  void signalWaiters();
+
+  // 树节点、所有 listpack 与消费组在堆上占用的字节数
+  std::size_t allocatedBytes() const;
+
+ private:
+  // 节点的最后一个条目（含已删除的）的 ID
+  static StreamId _LastId(const Listpack& lp, const StreamId& master);
+  // 从头把节点中的条目标记为删除，直到满足 args，返回删除的条目数
+  std::size_t _TrimNode(void** slot, const StreamId& master,
+                        const TrimArgs& args);
+
+  RadixTree rax_;
+  std::size_t length_;
+  StreamId lastId_;
+  // 最后一个节点在树中的值与其 master ID，追加时不必重新查找
+  void** tail_;
+  StreamId tailMaster_;
+  std::map<std::string, StreamGroup*> groups_;
+};
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,425 @@
+#ifndef SERVER_DB_SWISSTABLE_H
+#define SERVER_DB_SWISSTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace tinyredis {
+// 开放寻址哈希表（Swiss table）：每个槽位对应一个控制字节，
+// 满槽保存哈希值的低 7 位，空槽与墓碑的最高位为 1。
+// 槽位按 16 个一组，查找时用 SSE2 一次比较整组控制字节得到候选位图，
+// 只有控制字节相同的槽位才比较键，未命中在遇到含空槽的组时即可结束。
+// 控制字节与槽位数组放在同一次分配里，元素原地存放，没有逐元素的堆分配。
+//
+// 与 Dict 接口一致，可以互相替换（见 hashTable.h）；不同之处：
+// - 扩容/缩容是一次性重建，没有渐进式 rehash，rehash/rehashFor 为空操作；
+// - 删除时所在组还有空槽就直接置空，否则留下墓碑，墓碑在下次重建时清除；
+// - scan 游标按组编号做高位进位，每次返回以该组为起点（按哈希归属）的全部元素，
+//   因此扩容/缩容之间的保证与 Dict 相同。
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Equal = std::equal_to<K>>
+class SwissTable {
+ public:
+  struct Entry {
+    K key;
+    V value;
+  };
+
+  static const std::size_t kGroupSize = 16;
+  // 装载因子低于 1/kMinFillRatio 时缩容
+  static const std::size_t kMinFillRatio = 10;
+
+  SwissTable()
+      : ctrl_(nullptr),
+        slots_(nullptr),
+        capacity_(0),
+        size_(0),
+        growthLeft_(0),
+        pauseRehash_(0) {}
+  ~SwissTable() { _Free(); }
+
+  SwissTable(const SwissTable&) = delete;
+  void operator=(const SwissTable&) = delete;
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  std::size_t bucketCount() const { return capacity_; }
+  bool isRehashing() const { return false; }
+  // 表结构本身占用的字节数：控制字节与槽位数组，不含键、值自己的堆内存
+  std::size_t tableBytes() const { return capacity_ * (1 + sizeof(Entry)); }
+
+  template <typename KK>
+  V* find(const KK& key) {
+    Entry* e = findEntry(key);
+    return e ? &e->value : nullptr;
+  }
+
+  template <typename KK>
+  Entry* findEntry(const KK& key) {
+    if (empty())
+      return nullptr;
+    const std::size_t i = _Find(key, _Hash(key));
+    return i == kNotFound ? nullptr : &slots_[i];
+  }
+
+  // 插入或覆盖，返回 true 表示新插入
+  template <typename KK, typename VV>
+  bool set(KK&& key, VV&& value) {
+    std::pair<Entry*, bool> r = _FindOrInsert(std::forward<KK>(key));
+    r.first->value = std::forward<VV>(value);
+    return r.second;
+  }
+
+  // 不存在时插入值初始化的 V，返回元素以及是否新插入
+  template <typename KK>
+  std::pair<V*, bool> insert(KK&& key) {
+    std::pair<Entry*, bool> r = _FindOrInsert(std::forward<KK>(key));
+    return std::make_pair(&r.first->value, r.second);
+  }
+
+  template <typename KK>
+  bool erase(const KK& key) {
+    if (empty())
+      return false;
+    const std::size_t i = _Find(key, _Hash(key));
+    if (i == kNotFound)
+      return false;
+    slots_[i].~Entry();
+    // 组内还有空槽说明探测从未越过这一组，可以直接置空；否则必须留下墓碑
+    if (Group(ctrl_ + (i & ~(kGroupSize - 1))).matchEmpty()) {
+      ctrl_[i] = kEmpty;
+      ++growthLeft_;
+    } else {
+      ctrl_[i] = kDeleted;
+    }
+    --size_;
+    shrinkIfNeeded();
+    return true;
+  }
+
+  void clear() { _Free(); }
+
+  // 预先扩到能放下 n 个元素
+  bool reserve(std::size_t n) {
+    if (_CapacityFor(n) <= capacity_)
+      return false;
+    _Rebuild(_CapacityFor(n));
+    return true;
+  }
+
+  // 装载因子过低时重建为小表，返回是否重建；安全迭代器存活期间不缩容
+  bool shrinkIfNeeded() {
+    if (pauseRehash_ > 0 || capacity_ <= kGroupSize)
+      return false;
+    if (size_ * kMinFillRatio >= capacity_)
+      return false;
+    const std::size_t cap = _CapacityFor(size_);
+    if (cap >= capacity_)
+      return false;
+    _Rebuild(cap);
+    return true;
+  }
+
+  // 没有渐进式迁移，保留这两个接口以便与 Dict 互换
+  bool rehash(std::size_t n) {
+    (void)n;
+    return false;
+  }
+  std::size_t rehashFor(uint64_t budgetUs) {
+    (void)budgetUs;
+    return 0;
+  }
+
+  // 访问游标 cursor 对应组的元素，fn(const Entry&) 不能修改表；返回下一个游标，0 表示结束
+  template <typename Fn>
+  uint64_t scan(uint64_t cursor, Fn&& fn) {
+    if (empty())
+      return 0;
+    const std::size_t groupMask = capacity_ / kGroupSize - 1;
+    const std::size_t home = cursor & groupMask;
+    // 归属该组的元素只可能落在从它开始、直到第一个含空槽的组为止的探测序列上
+    ProbeSeq seq(home, groupMask);
+    for (;;) {
+      const int8_t* ctrl = ctrl_ + seq.offset();
+      for (uint32_t full = Group(ctrl).matchFull(); full; full &= full - 1) {
+        const std::size_t i = seq.offset() + __builtin_ctz(full);
+        if ((_H1(_Hash(slots_[i].key)) & groupMask) == home)
+          fn(static_cast<const Entry&>(slots_[i]));
+      }
+      if (Group(ctrl).matchEmpty() || !seq.next())
+        break;
+    }
+    return _NextCursor(cursor, groupMask);
+  }
+
+  // 安全迭代器：存活期间不缩容，允许删除 next() 刚返回的元素；期间不能插入
+  class Iterator {
+   public:
+    explicit Iterator(SwissTable* t) : t_(t), index_(0) { ++t_->pauseRehash_; }
+    ~Iterator() { --t_->pauseRehash_; }
+
+    Iterator(const Iterator&) = delete;
+    void operator=(const Iterator&) = delete;
+
+    // 没有更多元素时返回 nullptr
+    Entry* next() {
+      while (index_ < t_->capacity_) {
+        const std::size_t i = index_++;
+        if (_IsFull(t_->ctrl_[i]))
+          return &t_->slots_[i];
+      }
+      return nullptr;
+    }
+
+   private:
+    SwissTable* t_;
+    std::size_t index_;
+  };
+
+ private:
+  static const int8_t kEmpty = -128;  // 0b10000000
+  static const int8_t kDeleted = -2;  // 0b11111110
+  static const std::size_t kNotFound = static_cast<std::size_t>(-1);
+
+  static bool _IsFull(int8_t c) { return c >= 0; }
+
+  // 一组 16 个控制字节，各 match 返回命中槽位的位图
+  class Group {
+   public:
+#ifdef __SSE2__
+    explicit Group(const int8_t* ctrl)
+        : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+    uint32_t match(int8_t h2) const {
+      return static_cast<uint32_t>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+    }
+    uint32_t matchEmpty() const { return match(kEmpty); }
+    // 空槽与墓碑的最高位都是 1
+    uint32_t matchFree() const {
+      return static_cast<uint32_t>(_mm_movemask_epi8(ctrl_));
+    }
+
+   private:
+    __m128i ctrl_;
+#else
+    explicit Group(const int8_t* ctrl) : ctrl_(ctrl) {}
+
+    uint32_t match(int8_t h2) const {
+      uint32_t bits = 0;
+      for (std::size_t i = 0; i < kGroupSize; ++i)
+        bits |= static_cast<uint32_t>(ctrl_[i] == h2) << i;
+      return bits;
+    }
+    uint32_t matchEmpty() const { return match(kEmpty); }
+    uint32_t matchFree() const {
+      uint32_t bits = 0;
+      for (std::size_t i = 0; i < kGroupSize; ++i)
+        bits |= static_cast<uint32_t>(ctrl_[i] < 0) << i;
+      return bits;
+    }
+
+   private:
+    const int8_t* ctrl_;
+#endif
+
+   public:
+    uint32_t matchFull() const { return ~matchFree() & 0xFFFFu; }
+  };
+
+  // 按组做三角数探测：组数为 2 的幂时恰好不重复地访问每一组
+  class ProbeSeq {
+   public:
+    ProbeSeq(std::size_t group, std::size_t groupMask)
+        : group_(group), mask_(groupMask), step_(0) {}
+
+    std::size_t offset() const { return group_ * kGroupSize; }
+    // 所有组都访问过时返回 false
+    bool next() {
+      if (step_ == mask_)
+        return false;
+      ++step_;
+      group_ = (group_ + step_) & mask_;
+      return true;
+    }
+
+   private:
+    std::size_t group_;
+    std::size_t mask_;
+    std::size_t step_;
+  };
+
+  template <typename KK>
+  uint64_t _Hash(const KK& key) const {
+    // 与 Dict 相同的再混合，std::hash 对整数是恒等映射
+    uint64_t h = static_cast<uint64_t>(hash_(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+  }
+  // 高位选组，低 7 位存进控制字节
+  static std::size_t _H1(uint64_t h) { return static_cast<std::size_t>(h >> 7); }
+  static int8_t _H2(uint64_t h) { return static_cast<int8_t>(h & 0x7F); }
+
+  template <typename KK>
+  std::size_t _Find(const KK& key, uint64_t h) const {
+    const int8_t h2 = _H2(h);
+    ProbeSeq seq(_H1(h) & (capacity_ / kGroupSize - 1),
+                 capacity_ / kGroupSize - 1);
+    for (;;) {
+      const Group g(ctrl_ + seq.offset());
+      for (uint32_t m = g.match(h2); m; m &= m - 1) {
+        const std::size_t i = seq.offset() + __builtin_ctz(m);
+        if (equal_(slots_[i].key, key))
+          return i;
+      }
+      if (g.matchEmpty() || !seq.next())
+        return kNotFound;
+    }
+  }
+
+  // 探测序列上第一个空槽或墓碑
+  std::size_t _FindFree(uint64_t h) const {
+    ProbeSeq seq(_H1(h) & (capacity_ / kGroupSize - 1),
+                 capacity_ / kGroupSize - 1);
+    for (;;) {
+      const uint32_t m = Group(ctrl_ + seq.offset()).matchFree();
+      if (m)
+        return seq.offset() + __builtin_ctz(m);
+      seq.next();
+    }
+  }
+
+  template <typename KK>
+  std::pair<Entry*, bool> _FindOrInsert(KK&& key) {
+    const uint64_t h = _Hash(key);
+    if (!empty()) {
+      const std::size_t i = _Find(key, h);
+      if (i != kNotFound)
+        return std::make_pair(&slots_[i], false);
+    }
+
+    std::size_t i = capacity_ ? _FindFree(h) : 0;
+    // 只有占用空槽才消耗余量，复用墓碑不消耗
+    if (capacity_ == 0 || (growthLeft_ == 0 && ctrl_[i] == kEmpty)) {
+      // 余量多半被墓碑占着（元素不到 25/32）时原地重建即可回收，否则翻倍
+      const std::size_t cap =
+          size_ * 32 <= capacity_ * 25 ? capacity_ : capacity_ * 2;
+      _Rebuild(cap ? cap : kGroupSize);
+      i = _FindFree(h);
+    }
+    if (ctrl_[i] == kEmpty)
+      --growthLeft_;
+    new (&slots_[i]) Entry{K(std::forward<KK>(key)), V()};
+    ctrl_[i] = _H2(h);
+    ++size_;
+    return std::make_pair(&slots_[i], true);
+  }
+
+  // 最大装载因子 7/8
+  static std::size_t _MaxLoad(std::size_t capacity) {
+    return capacity - capacity / 8;
+  }
+
+  static std::size_t _CapacityFor(std::size_t n) {
+    std::size_t cap = kGroupSize;
+    while (_MaxLoad(cap) < n)
+      cap <<= 1;
+    return cap;
+  }
+
+  // 分配 capacity 个槽位的新表并把元素逐个搬过去，同时清除所有墓碑
+  void _Rebuild(std::size_t capacity) {
+    int8_t* oldCtrl = ctrl_;
+    Entry* oldSlots = slots_;
+    const std::size_t oldCapacity = capacity_;
+
+    _Allocate(capacity);
+    for (std::size_t i = 0; i < oldCapacity; ++i) {
+      if (!_IsFull(oldCtrl[i]))
+        continue;
+      const uint64_t h = _Hash(oldSlots[i].key);
+      const std::size_t j = _FindFree(h);
+      new (&slots_[j]) Entry(std::move(oldSlots[i]));
+      oldSlots[i].~Entry();
+      ctrl_[j] = _H2(h);
+      --growthLeft_;
+    }
+    std::free(oldCtrl);
+  }
+
+  // 一次分配：capacity 个控制字节，随后按 Entry 对齐的槽位数组
+  void _Allocate(std::size_t capacity) {
+    const std::size_t align = alignof(Entry);
+    const std::size_t ctrlBytes = (capacity + align - 1) / align * align;
+    void* mem = std::malloc(ctrlBytes + capacity * sizeof(Entry));
+    if (!mem)
+      throw std::bad_alloc();
+    ctrl_ = static_cast<int8_t*>(mem);
+    slots_ = reinterpret_cast<Entry*>(static_cast<char*>(mem) + ctrlBytes);
+    std::memset(ctrl_, kEmpty, capacity);
+    capacity_ = capacity;
+    growthLeft_ = _MaxLoad(capacity);
+  }
+
+  void _Free() {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      if (_IsFull(ctrl_[i]))
+        slots_[i].~Entry();
+    }
+    std::free(ctrl_);
+    ctrl_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+    growthLeft_ = 0;
+  }
+
+  // 对掩码内的位做反向加一，与 Dict::scan 的游标相同
+  static uint64_t _NextCursor(uint64_t v, uint64_t mask) {
+    v |= ~mask;
+    v = _Reverse(v);
+    ++v;
+    return _Reverse(v);
+  }
+
+  static uint64_t _Reverse(uint64_t v) {
+    v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+    v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return __builtin_bswap64(v);
+  }
+
+  int8_t* ctrl_;  // 同一次分配的起始地址
+  Entry* slots_;
+  std::size_t capacity_;    // 槽位数，0 或 kGroupSize 的 2 的幂倍
+  std::size_t size_;
+  std::size_t growthLeft_;  // 还能占用多少个空槽（墓碑不计）才需要重建
+  int pauseRehash_;         // 存活的安全迭代器
+  Hash hash_;
+  Equal equal_;
+};
+
+template <typename K, typename V, typename H, typename E>
+const std::size_t SwissTable<K, V, H, E>::kGroupSize;
+template <typename K, typename V, typename H, typename E>
+const std::size_t SwissTable<K, V, H, E>::kMinFillRatio;
+template <typename K, typename V, typename H, typename E>
+const int8_t SwissTable<K, V, H, E>::kEmpty;
+template <typename K, typename V, typename H, typename E>
+const int8_t SwissTable<K, V, H, E>::kDeleted;
+template <typename K, typename V, typename H, typename E>
+const std::size_t SwissTable<K, V, H, E>::kNotFound;
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef SERVER_DB_ZSETTYPE_H
+#define SERVER_DB_ZSETTYPE_H
+
+#include <server/db/object.h>
+
+namespace tinyredis {
+// zset 类型的操作，按编码分派：listpack 中成员与分数交替存放，按 (分数, 成员) 有序；
+// 成员数或任一成员的长度超过阈值时转换为 B+ 树加字典
+namespace zsetType {
+Object create();
+std::size_t size(const Object& o);
+// 加入成员或更新已有成员的分数，返回 true 表示新成员
+bool add(Object& o, double score, const Slice& member,
+         const EncodingConfig& cfg);
+bool erase(Object& o, const Slice& member);
+bool score(Object& o, const Slice& member, double* out);
+// 从 0 开始的排名
+bool rank(Object& o, const Slice& member, std::size_t* out);
+
+// 分数区间，两端可以是开区间
+struct ScoreRange {
+  double min;
+  double max;
+  bool minExclusive;
+  bool maxExclusive;
+};
+// 分数在 range 内的元素是排名连续的一段：*first 为起始排名，返回个数
+std::size_t rankRange(Object& o, const ScoreRange& range, std::size_t* first);
+void convert(Object& o);
+
+// listpack 中分数元素的值
+double listpackScore(const Listpack& lp, std::size_t pos);
+
+// 依次回调排名 [start, stop] 的元素 fn(const Slice& member, double score)，
+// 调用方保证排名有效
+template <typename Fn>
+void range(Object& o, std::size_t start, std::size_t stop, Fn&& fn) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    const Listpack& lp = o.listpack();
+    char buf[Listpack::kIntBufSize];
+    std::size_t p = lp.seek(static_cast<long long>(start * 2));
+    for (std::size_t i = start; i <= stop; ++i) {
+      const std::size_t s = lp.next(p);
+      fn(lp.get(p, buf), listpackScore(lp, s));
+      p = lp.next(s);
+    }
+    return;
+  }
+  o.zsetTree().tree.range(
+      start, stop, [&fn](const std::string& member, double score) {
+        fn(Slice{member.data(), member.size()}, score);
+      });
+}
+}  // namespace zsetType
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef SERVER_PROTOCOL_RESPENCODER_H
+#define SERVER_PROTOCOL_RESPENCODER_H
+
+#include <server/protocol/respParser.h>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+class StreamSocket;
+
+namespace tinyredis {
+// 连接协商的协议版本，默认 RESP2，HELLO 3 之后切换到 RESP3
+enum class RespVersion {
+  kResp2 = 2,
+  kResp3 = 3,
+};
+
+// 带类型的回复编码器：每次调用直接把一个元素追加到连接的发送缓冲区，
+// 类型头在栈上格式化，内容与头部、结尾的 CRLF 以一个 BufferSequence 写入，
+// 不拼接中间字符串；小整数和短头部直接引用 respShared.h 中的公共回复。
+// RESP3 独有的类型在 RESP2 下按 Redis 的规则降级：
+// map 变为 2N 个元素的数组，set/push 变为数组，double 与大数变为批量字符串，
+// 布尔变为整数 1/0，null 变为 "$-1"（数组语境下用 nullArray 得到 "*-1"）。
+// 聚合类型只写头部，调用方随后依次写入各个元素。
+class RespEncoder {
+ public:
+  explicit RespEncoder(StreamSocket* out,
+                       RespVersion version = RespVersion::kResp2)
+      : out_(out), version_(version) {}
+
+  RespEncoder(const RespEncoder&) = delete;
+  void operator=(const RespEncoder&) = delete;
+
+  RespVersion version() const { return version_; }
+  void setVersion(RespVersion version) { version_ = version; }
+  bool resp3() const { return version_ == RespVersion::kResp3; }
+
+  // +OK
+  void simpleString(const char* s, std::size_t len);
+  void simpleString(const char* s) { simpleString(s, std::strlen(s)); }
+  // -ERR ...，msg 不含前缀时补上 "ERR "；以 '-' 开头时自带错误码
+  void error(const char* msg, std::size_t len);
+  void error(const char* msg) { error(msg, std::strlen(msg)); }
+  void integer(long long v);
+  void bulk(const char* data, std::size_t len);
+  // 内容由 data 共同持有的批量字符串：达到连接的零拷贝阈值时以 MSG_ZEROCOPY 发送，
+  // 内核确认发送完成后才放开 data；否则与上面相同，拷贝到发送缓冲区
+  void bulk(const std::shared_ptr<const char>& data, std::size_t len);
+  // len 字节的回复是否会走零拷贝，调用方据此决定是否值得共享内容
+  bool zeroCopy(std::size_t len) const;
+  void null();
+  void nullArray();
+  void boolean(bool v);
+  void dbl(double v);
+  // 任意精度整数，digits 为十进制表示（可带负号）
+  void bigNumber(const char* digits, std::size_t len);
+  // 带格式的字符串，format 为 3 个字符，例如 "txt"、"mkd"
+  void verbatim(const char* format, const char* data, std::size_t len);
+
+  // 原样写入预先编码好的回复，例如 shared::kOk
+  void raw(const Slice& reply);
+
+  void array(std::size_t n);
+  // n 为键值对数
+  void map(std::size_t n);
+  void set(std::size_t n);
+  // 服务端主动推送（例如失效通知），只应在 RESP3 连接上使用
+  void push(std::size_t n);
+
+ private:
+  // 写入 "<type><n>\r\n"
+  void _Header(char type, long long n);
+  // 写入 "<type><body>\r\n"
+  void _Line(char type, const char* body, std::size_t len);
+  // 写入 "<type><len>\r\n<body>\r\n"
+  void _Blob(char type, const char* body, std::size_t len);
+
+  StreamSocket* const out_;
+  RespVersion version_;
+};
+}  // namespace tinyredis
+
+#endif
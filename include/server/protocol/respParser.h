@@ -0,0 +1,81 @@
+#ifndef SERVER_PROTOCOL_RESPPARSER_H
+#define SERVER_PROTOCOL_RESPPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tinyredis {
+// 指向请求缓冲区的只读视图，只在本次处理请求期间有效
+struct Slice {
+  const char* data;
+  std::size_t len;
+
+  std::string toString() const { return std::string(data, len); }
+};
+
+// 可断点续传的 RESP2 请求解析器，支持多条批量字符串和内联命令。
+// 每次调用 parse 时 data 都必须从同一帧的起始处开始（帧没有解析完不消费），
+// 但可以位于不同的内存（例如绕圈或扩容时数据挪到了缓冲区开头）：
+// 解析进度以相对帧首的偏移保存，续传时从上次停下的位置继续，不会重复扫描。
+// 参数不拷贝，直接指向 data。
+class RespParser {
+ public:
+  enum class Result {
+    kOk,          // 解析出一个完整请求，args() 可用
+    kIncomplete,  // 需要更多数据
+    kError,       // 协议错误，error() 给出原因
+  };
+
+  static const std::size_t kMaxInlineLen = 64 * 1024;
+  static const long long kMaxMultiBulkLen = 1024 * 1024;
+  static const long long kMaxBulkLen = 512LL * 1024 * 1024;
+
+  // maxRequestLen 为调用方最多能提供的帧长度（例如接收缓冲区的上限），
+  // 帧有这么长还不完整时报协议错误，而不是一直等下去
+  explicit RespParser(std::size_t maxRequestLen = SIZE_MAX);
+
+  // consumed 为完整请求的字节数，只在返回 kOk 时有效
+  Result parse(const char* data, std::size_t len, std::size_t& consumed);
+
+  const std::vector<Slice>& args() const { return args_; }
+  const std::string& error() const { return error_; }
+
+  // 处理完一个请求后调用，准备解析下一帧
+  void reset();
+
+ private:
+  enum class State {
+    kStart,       // 等待帧的第一个字节
+    kMultiBulk,   // 读取 "*<n>\r\n"
+    kBulkHeader,  // 读取 "$<len>\r\n"
+    kBulkBody,    // 读取 <len> 字节和 "\r\n"
+    kInline,      // 读取内联命令行
+  };
+
+  static const long kBadLineEnd = -2;
+
+  Result _Parse(const char* data, std::size_t len, std::size_t& consumed);
+
+  // 在 [pos_, len) 找行尾，从 scanned_ 继续找，返回 '\r' 的偏移；
+  // 数据不够返回 -1，'\r' 后面不是 '\n' 返回 kBadLineEnd
+  long _FindLineEnd(const char* data, std::size_t len);
+  Result _ParseInline(const char* data, std::size_t len);
+  // 所有协议错误都经这里记下原因
+  Result _Fail(const std::string& reason);
+  void _BuildArgs(const char* data);
+
+  const std::size_t maxRequestLen_;
+  State state_;
+  std::size_t pos_;        // 已经解析完的偏移
+  std::size_t scanned_;    // 找行尾时已经扫描过的偏移
+  long long multiBulk_;    // 剩余的参数个数
+  long long bulkLen_;      // 当前参数长度
+  std::vector<std::pair<std::size_t, std::size_t>> offsets_;  // 参数位置
+  std::vector<Slice> args_;
+  std::string error_;
+};
+}  // namespace tinyredis
+
+#endif
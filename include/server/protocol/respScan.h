@@ -0,0 +1,43 @@
+#ifndef SERVER_PROTOCOL_RESPSCAN_H
+#define SERVER_PROTOCOL_RESPSCAN_H
+
+#include <server/util/cpuFeatures.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace tinyredis {
+// RESP 解析用的扫描内核：找 '\r' / '\n'，以及把十进制长度转成整数。
+// x86-64 上根据 CPUID 在 AVX2 与 SSE2 之间选择，其他平台用标量实现；
+// 程序启动时选定，之后直接走函数指针。
+enum class ScanKernel {
+  kScalar,  // 逐字节比较
+  kLibc,    // std::memchr
+  kSse2,
+  kAvx2,
+};
+
+namespace scan {
+using FindFunc = const char* (*)(const char* p, std::size_t n);
+extern FindFunc findCR;
+extern FindFunc findLF;
+}  // namespace scan
+
+// 返回 [p, p + n) 中第一个 '\r'，没有则返回 nullptr
+inline const char* findCR(const char* p, std::size_t n) {
+  return scan::findCR(p, n);
+}
+// 返回 [p, p + n) 中第一个 '\n'，没有则返回 nullptr
+inline const char* findLF(const char* p, std::size_t n) {
+  return scan::findLF(p, n);
+}
+
+// 解析可选负号加最多 18 位数字，不满足时返回 false；
+// 每 8 位一段用 SWAR 转换，不逐位相乘
+bool parseDecimal(const char* p, std::size_t n, long long& out);
+
+// 内核的选择与切换，切换时同时更新 findCR / findLF
+KernelSelector<ScanKernel>& scanKernels();
+const char* scanKernelName(ScanKernel kernel);
+}  // namespace tinyredis
+
+#endif
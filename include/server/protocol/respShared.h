@@ -0,0 +1,43 @@
+#ifndef SERVER_PROTOCOL_RESPSHARED_H
+#define SERVER_PROTOCOL_RESPSHARED_H
+
+#include <server/protocol/respParser.h>
+#include <cstddef>
+
+namespace tinyredis {
+// 预先格式化好的公共回复，进程内只有一份，回复时直接引用，不再格式化。
+// 与 Redis 的 shared 对象相同：常量回复、小整数 ":<n>" 以及短聚合/批量头部
+namespace shared {
+const long long kIntegers = 10000;  // 缓存 ":0" 到 ":9999"
+const std::size_t kHeaders = 32;    // 缓存长度 0 到 31 的头部
+
+extern const Slice kOk;          // +OK
+extern const Slice kPong;        // +PONG
+extern const Slice kQueued;      // +QUEUED
+extern const Slice kCRLF;        // \r\n
+extern const Slice kZero;        // :0
+extern const Slice kOne;         // :1
+extern const Slice kMinusOne;    // :-1
+extern const Slice kNullBulk;    // $-1
+extern const Slice kNullArray;   // *-1
+extern const Slice kNull;        // _（RESP3）
+extern const Slice kTrue;        // #t（RESP3）
+extern const Slice kFalse;       // #f（RESP3）
+extern const Slice kEmptyArray;  // *0
+extern const Slice kEmptyBulk;   // $0\r\n\r\n
+extern const Slice kSyntaxErr;   // -ERR syntax error
+extern const Slice kWrongType;   // -WRONGTYPE ...
+
+// ":<n>\r\n"，n 必须在 [0, kIntegers) 内
+Slice integer(long long n);
+// "<type><n>\r\n"，type 为 '*'、'$'、'%'、'~'、'>' 之一；
+// 其他类型或 n 不小于 kHeaders 时返回空 Slice
+Slice header(char type, std::size_t n);
+}  // namespace shared
+
+// 把 v 的十进制表示倒序写到 end 之前（每次查表写两位），返回起始位置；
+// 调用方需保证 end 前至少有 20 字节
+char* formatDecimal(char* end, long long v);
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef SERVER_UTIL_BITOPS_H
+#define SERVER_UTIL_BITOPS_H
+
+#include <server/util/cpuFeatures.h>
+#include <cstddef>
+
+namespace tinyredis {
+// 位图命令（BITCOUNT/BITPOS/BITOP）的扫描内核。位图可以有几百 MB，
+// 逐字节处理会长时间阻塞事件循环，按 CPU 能力选择：
+// - scalar：每次 8 字节，SWAR 计数；
+// - popcnt：硬件 POPCNT 指令，每次 8 字节；
+// - avx2：每次 32 字节，BITCOUNT 用 Harley-Seal 进位保存加法器，
+//   每 16 个向量只做一次按 4 位查表的计数。
+// x86-64 上根据 CPUID 选择，其他平台用标量实现；程序启动时选定
+enum class BitKernel {
+  kScalar,
+  kPopcnt,
+  kAvx2,
+};
+
+enum class BitOp {
+  kAnd,
+  kOr,
+  kXor,
+  kNot,
+};
+
+// [p, p + n) 中值为 1 的位数
+std::size_t popcount(const void* p, std::size_t n);
+
+// 第一个不等于 skip 的字节的下标，全部等于时返回 n。
+// BITPOS 找 1 时 skip 为 0x00，找 0 时为 0xFF
+std::size_t findByteNot(const void* p, std::size_t n, unsigned char skip);
+
+// dst 的 n 个字节 = op(srcs[0], srcs[1], ...)，共 count 个源；
+// 源比 n 短的部分视为 0。NOT 只使用第一个源。dst 不能与源重叠
+void bitop(BitOp op, void* dst, std::size_t n, const void* const* srcs,
+           const std::size_t* lens, std::size_t count);
+
+// 当前内核的查询与切换
+KernelSelector<BitKernel>& bitKernels();
+const char* bitKernelName(BitKernel kernel);
+}  // namespace tinyredis
+
+#endif
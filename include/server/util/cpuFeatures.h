@@ -0,0 +1,79 @@
+#ifndef SERVER_UTIL_CPUFEATURES_H
+#define SERVER_UTIL_CPUFEATURES_H
+
+#include <initializer_list>
+
+namespace tinyredis {
+// CPUID 检测。SIMD 内核只在 x86-64 上编译，其他平台一律返回 false
+inline bool cpuHasSse2() {
+#if defined(__x86_64__)
+  return true;  // x86-64 的基线指令集
+#else
+  return false;
+#endif
+}
+
+inline bool cpuHasPopcnt() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("popcnt");
+#else
+  return false;
+#endif
+}
+
+inline bool cpuHasAvx2() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+// 按 CPU 能力选择的 SIMD 内核。Kernel 是各模块自己的枚举，
+// supported 判断当前 CPU 能否运行某个内核；构造时取 preference 中
+// 第一个受支持的，preference 按从快到慢排列，最后一个应当总是受支持。
+// 内核在程序启动时选定，之后只在测试与基准中切换
+template <typename Kernel>
+class KernelSelector {
+ public:
+  using Supported = bool (*)(Kernel);
+  // 切换内核后调用，供按内核缓存函数指针的模块刷新
+  using Apply = void (*)(Kernel);
+
+  KernelSelector(Supported supported, std::initializer_list<Kernel> preference,
+                 Apply apply = nullptr)
+      : supported_(supported), apply_(apply), current_(*preference.begin()) {
+    for (Kernel kernel : preference) {
+      current_ = kernel;
+      if (supported_(kernel))
+        break;
+    }
+  }
+
+  KernelSelector(const KernelSelector&) = delete;
+  KernelSelector& operator=(const KernelSelector&) = delete;
+
+  // 当前使用的内核
+  Kernel current() const { return current_; }
+  bool supported(Kernel kernel) const { return supported_(kernel); }
+
+  // 测试与基准用：强制使用某个内核，CPU 不支持时返回 false
+  bool force(Kernel kernel) {
+    if (!supported_(kernel))
+      return false;
+    current_ = kernel;
+    if (apply_)
+      apply_(kernel);
+    return true;
+  }
+
+ private:
+  Supported supported_;
+  Apply apply_;
+  Kernel current_;
+};
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef SERVER_UTIL_LZF_H
+#define SERVER_UTIL_LZF_H
+
+#include <cstddef>
+
+namespace tinyredis {
+// LZF 压缩，输出格式与 liblzf（Redis 压缩 quicklist 节点和 RDB 字符串所用）相同：
+//   000LLLLL <L+1 字节字面量>
+//   LLLOOOOO oooooooo             长度 L+2（L 为 1..6）、距离 O+1 的回溯拷贝
+//   111OOOOO LLLLLLLL oooooooo    长度 L+9 的回溯拷贝
+// 只用 3 字节哈希找最近一次出现的位置，速度优先于压缩率。
+// 输出超过 outCap 时放弃并返回 0，调用方据此判断不值得压缩
+std::size_t lzfCompress(const void* in, std::size_t inLen, void* out,
+                        std::size_t outCap);
+
+// 解压到 out，返回解压后的字节数；数据损坏或 outCap 不够时返回 0
+std::size_t lzfDecompress(const void* in, std::size_t inLen, void* out,
+                          std::size_t outCap);
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef SERVER_UTIL_MEMORY_H
+#define SERVER_UTIL_MEMORY_H
+
+#include <cstddef>
+#include <string>
+
+namespace tinyredis {
+// malloc 分配的 p 实际可用的字节数（含分配器的取整），p 为空时返回 0；
+// 不是 glibc 时退化为 0
+std::size_t mallocUsableSize(const void* p);
+
+// std::string 内容的堆内存，短字符串优化存放在对象内部时为 0
+std::size_t stringHeapBytes(const std::string& s);
+
+// 分配器当前已分配给程序的总字节数（glibc 的 mallinfo2，含 mmap 的大块）；
+// 遍历所有 arena，不适合放在热路径上
+std::size_t allocatedBytes();
+}  // namespace tinyredis
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef SERVER_UTIL_NUMBERS_H
+#define SERVER_UTIL_NUMBERS_H
+
+#include <cstddef>
+
+namespace tinyredis {
+// 严格解析 64 位有符号整数，与 Redis 的 string2ll 相同：
+// 只接受规范形式（可选负号、无前导零、无空白、无 '+'、没有 "-0"），
+// 因此解析成功的字符串与格式化回去的结果逐字节相同。溢出或格式不对时返回 false
+bool parseLongLong(const char* s, std::size_t len, long long* out);
+
+// 判断值能否按整数编码存放（字符串对象、listpack、intset），语义同 parseLongLong。
+// 超过 20 字节的不可能是 64 位整数，内联判断长度，长字符串不必调用解析
+inline bool tryParseInt(const char* s, std::size_t len, long long& out) {
+  return len <= 20 && parseLongLong(s, len, &out);
+}
+
+// 解析 double，与 Redis 的 string2d 相同：整个字符串必须是一个合法的数，
+// 不允许首尾空白，接受 inf/-inf，拒绝 nan 和上溢/下溢
+bool parseDouble(const char* s, std::size_t len, double* out);
+}  // namespace tinyredis
+
+#endif
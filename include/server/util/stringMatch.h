@@ -0,0 +1,12 @@
+#ifndef SERVER_UTIL_STRINGMATCH_H
+#define SERVER_UTIL_STRINGMATCH_H
+
+#include <cstddef>
+
+namespace tinyredis {
+// 与 Redis 相同的 glob 匹配：* ? [abc] [^a-z] 以及 \ 转义
+bool stringMatch(const char* pattern, std::size_t plen, const char* str,
+                 std::size_t slen, bool nocase = false);
+}  // namespace tinyredis
+
+#endif
@@ -1,15 +1,16 @@
 #include <base/buffer/asyncBuffer.h>
 #include <base/buffer/buffer.h>
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <mutex>
 
-AsyncBuffer::AsyncBuffer(std::size_t size) : buffer_(size), backBytes_(0) {}
+AsyncBuffer::AsyncBuffer(std::size_t size) : size_(size), backBytes_(0) {}
 AsyncBuffer::~AsyncBuffer() {}
 
 void AsyncBuffer::write(const void* data, std::size_t len) {
   BufferSequence bf;
-  bf.buffers[0].iov_base = &data;
+  bf.buffers[0].iov_base = const_cast<void*>(data);
   bf.buffers[0].iov_len = len;
   bf.count = 1;
   this->write(bf);
@@ -17,6 +18,12 @@ void AsyncBuffer::write(const void* data, std::size_t len) {
 
 void AsyncBuffer::write(const BufferSequence& data) {
   auto len = data.totalBytes();
+  if (len == 0)
+    return;
+
+  // 第一次写入才分配主缓冲区，空闲连接不占内存
+  if (buffer_.capacity() == 0)
+    buffer_.initCapacity(size_);
 
   // 条件1：backBytes_ > 0 ?
   // 条件2：主缓冲区可写空间不足
@@ -32,48 +39,60 @@ void AsyncBuffer::write(const BufferSequence& data) {
       assert(backBytes_ == backBuffer_.readableSize());  // 验证数据量一致性
       return;
     }
-    assert(backBytes_ == 0 && buffer_.writableSize() >= len);
-    for (size_t i = 0; i < data.count; ++i) {
-      buffer_.pushData(data.buffers[i].iov_base, data.buffers[i].iov_len);
-    }
   }
+
+  assert(backBytes_ == 0 && buffer_.writableSize() >= len);
+  for (size_t i = 0; i < data.count; ++i) {
+    buffer_.pushData(data.buffers[i].iov_base, data.buffers[i].iov_len);
+  }
+}
+
+bool AsyncBuffer::isEmpty() const {
+  return tmpBuffer_.isEmpty() &&
+         (buffer_.capacity() == 0 || buffer_.isEmpty()) && backBytes_ == 0;
 }
 
-// 将缓冲区中的数据提取到 BufferSequence 结构
+// 将缓冲区中的数据提取到 BufferSequence 结构，供一次 writev 发送
+// 顺序：临时缓冲区 tmpBuffer_ 中的数据一定比主缓冲区 buffer_ 中的旧
 void AsyncBuffer::processBuffer(BufferSequence& data) {
   data.count = 0;
 
-  // 临时缓冲区tmpBuf_中有数据（上次从backBuf_迁移的剩余数据）
-  if (!tmpBuffer_.isEmpty()) {
-    data.count = 1;
-    data.buffers[0].iov_base = tmpBuffer_.readAddr();
-    data.buffers[0].iov_len = tmpBuffer_.readableSize();
-  } else if (!buffer_.isEmpty()) {  // 主缓冲区buffer_中有数据
-    auto nLen = buffer_.readableSize();
-    buffer_.getDatum(data, nLen);
-    assert(nLen == data.totalBytes());
-  } else {  // 主缓冲和临时缓冲都为空，尝试处理备用缓冲backBuf_的数据
+  // 主缓冲和临时缓冲都为空，才把备用缓冲 backBuffer_ 的数据换出来，保证数据顺序
+  if (tmpBuffer_.isEmpty() && (buffer_.capacity() == 0 || buffer_.isEmpty())) {
     if (backBytes_ > 0 && backBufferLock_.try_lock()) {
       backBytes_ = 0;
       tmpBuffer_.swap(backBuffer_);
       backBufferLock_.unlock();
+    }
+  }
+
+  // 临时缓冲区tmpBuf_中有数据（从backBuf_迁移的剩余数据）
+  if (!tmpBuffer_.isEmpty()) {
+    data.count = 1;
+    data.buffers[0].iov_base = tmpBuffer_.readAddr();
+    data.buffers[0].iov_len = tmpBuffer_.readableSize();
+  }
 
-      data.count = 1;
-      data.buffers[0].iov_base = tmpBuffer_.readAddr();
-      data.buffers[0].iov_len = tmpBuffer_.readableSize();
+  // 主缓冲区buffer_中有数据，最多两段（绕圈）
+  if (buffer_.capacity() > 0 && !buffer_.isEmpty()) {
+    BufferSequence datum;
+    buffer_.getDatum(datum, buffer_.readableSize());
+    for (std::size_t i = 0; i < datum.count; ++i) {
+      data.buffers[data.count++] = datum.buffers[i];
     }
   }
 }
 
 // 跳过缓冲区中指定大小的数据（标记为 “已处理”）
 void AsyncBuffer::skip(std::size_t size) {
-  // 临时缓冲区tmpBuf_中有数据
+  // 先消耗临时缓冲区tmpBuf_，剩余的再从主缓冲区buffer_中扣除
   if (!tmpBuffer_.isEmpty()) {
-    assert(size <= tmpBuffer_.readableSize());
-    tmpBuffer_.adjustReadPtr(size);
-  } else {
-    // 临时缓冲区为空，则操作主缓冲区buffer_
+    std::size_t n = std::min(size, tmpBuffer_.readableSize());
+    tmpBuffer_.adjustReadPtr(n);
+    size -= n;
+  }
+  if (size > 0) {
     assert(buffer_.readableSize() >= size);
     buffer_.adjustReadAddr(size);
   }
-}
\ No newline at end of file
+}
@@ -84,7 +84,7 @@ void UnboundedBuffer::_AssureSpace(std::size_t nSize) {
       maxSize += (maxSize / 2);
     } else
       break;
-    buffer_.reserve(maxSize);
+    buffer_.resize(maxSize);
   }
 
   // 数据迁移：如果有已读数据（readPos_ > 0），将有效数据前移，释放前部空间
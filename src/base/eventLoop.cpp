@@ -0,0 +1,308 @@
+#include <base/eventLoop.h>
+#include <base/server.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#else
+#include <fcntl.h>
+#endif
+
+namespace Internal {
+const std::size_t EventLoop::kMaxEvents = 1024;
+
+namespace {
+// 没有更近的定时器时 poll 的最长等待时间，也决定了 stop() 的最大延迟
+const int kMaxPollTimeoutMs = 100;
+}  // namespace
+
+// post() 的唤醒通道：Linux 上是 eventfd，其他平台是 pipe，
+// 读端注册到 poller，写入一次即可让 poll 返回
+class Waker : public Socket {
+ public:
+  Waker() : writeFd_(INVALID_SOCKET) {
+#if defined(__linux__)
+    localSock_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    writeFd_ = localSock_;
+#else
+    int fds[2];
+    if (::pipe(fds) == 0) {
+      for (int fd : fds) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+      }
+      localSock_ = fds[0];
+      writeFd_ = fds[1];
+    }
+#endif
+  }
+
+  ~Waker() {
+    if (writeFd_ != localSock_)
+      ::close(writeFd_);
+  }
+
+  bool OnReadable() override {
+    char buf[64];
+    while (::read(localSock_, buf, sizeof(buf)) > 0) {
+    }
+    return true;
+  }
+
+  void notify() {
+    const uint64_t one = 1;
+    ssize_t n = ::write(writeFd_, &one, sizeof(one));
+    (void)n;  // 计数已满或管道已满时循环本来就会被唤醒
+  }
+
+ private:
+  int writeFd_;
+};
+
+uint64_t EventLoop::nowMs() {
+  using namespace std::chrono;
+  return static_cast<uint64_t>(
+      duration_cast<milliseconds>(steady_clock::now().time_since_epoch())
+          .count());
+}
+
+EventLoop::EventLoop(Server* server, std::size_t index)
+    : server_(server),
+      index_(index),
+      poller_(createPoller(server->pollerType())),
+      taskManager_(index),
+      sendThread_(poller_.get()),
+      timers_(nowMs()),
+      waker_(new Waker),
+      running_(false) {
+  firedEvents_.reserve(kMaxEvents);
+  if (waker_->getSocket() == INVALID_SOCKET ||
+      !poller_->addSocket(waker_->getSocket(),
+                          static_cast<int>(EventType::Read),
+                          static_cast<Socket*>(waker_.get())))
+    spdlog::error("Event loop {} failed to register wakeup fd", index_);
+}
+
+EventLoop::~EventLoop() {
+  stop();
+  // 连接在析构时关闭 fd
+  taskManager_.clear();
+}
+
+bool EventLoop::listen(const SocketAddr& addr, int tag) {
+  std::shared_ptr<ListenSocket> sock(
+      new ListenSocket(tag, server_->listenBacklog()));
+  if (!sock->Bind(addr))
+    return false;
+
+  sock->setLoop(this);
+  // 完成模型下由内核持续 accept，否则等可读事件再自己 accept
+  const bool ok =
+      poller_->completionBased()
+          ? poller_->submitAccept(sock->getSocket(),
+                                  static_cast<Socket*>(sock.get()))
+          : poller_->addSocket(sock->getSocket(),
+                               static_cast<int>(EventType::Read),
+                               static_cast<Socket*>(sock.get()));
+  if (!ok)
+    return false;
+
+  listenSockets_.push_back(sock);
+  return true;
+}
+
+void EventLoop::start() {
+  running_ = true;
+  thread_ = std::thread([this]() { this->_Run(); });
+}
+
+void EventLoop::stop() {
+  running_ = false;
+  // 循环可能正在 poll 中等待，唤醒它立即退出，不必等到超时
+  waker_->notify();
+  if (thread_.joinable())
+    thread_.join();
+}
+
+void EventLoop::post(std::function<void()> task) {
+  bool wasEmpty;
+  {
+    std::lock_guard<std::mutex> guard(postedLock_);
+    wasEmpty = posted_.empty();
+    posted_.push_back(std::move(task));
+  }
+  // 队列非空时已经有一次唤醒在路上
+  if (wasEmpty)
+    waker_->notify();
+}
+
+void EventLoop::_RunPosted() {
+  {
+    std::lock_guard<std::mutex> guard(postedLock_);
+    if (posted_.empty())
+      return;
+    runningTasks_.swap(posted_);
+  }
+  for (auto& task : runningTasks_)
+    task();
+  runningTasks_.clear();
+}
+
+std::shared_ptr<StreamSocket> EventLoop::newConnection(int connfd,
+                                                     const SocketAddr& peer,
+                                                     int tag) {
+  std::shared_ptr<StreamSocket> conn = server_->_OnNewConnection(tag);
+  if (!conn || !conn->init(connfd, peer)) {
+    Socket::closeSocket(connfd);
+    return std::shared_ptr<StreamSocket>();
+  }
+
+  conn->setLoop(this);
+  conn->enableZeroCopy(server_->zeroCopyThreshold());
+  const bool ok =
+      poller_->completionBased()
+          ? poller_->submitRecv(connfd, static_cast<Socket*>(conn.get()))
+          : poller_->addSocket(connfd, static_cast<int>(EventType::Read),
+                               static_cast<Socket*>(conn.get()));
+  if (!ok) {
+    // init 之后 fd 归 conn 所有，由 conn 析构时关闭
+    return std::shared_ptr<StreamSocket>();
+  }
+
+  ++stats_.accepted;
+  return conn;
+}
+
+void EventLoop::unregisterSocket(Socket* sock) {
+  poller_->delSocket(sock->getSocket(), static_cast<int>(EventType::Read) |
+                                            static_cast<int>(EventType::Write));
+  ++stats_.closed;
+}
+
+bool EventLoop::_HasSocketError(int sock) {
+  int err = 0;
+  socklen_t len = sizeof(err);
+  if (::getsockopt(sock, SOL_SOCKET, SO_ERROR, &err, &len) == SOCKET_ERROR)
+    return true;
+  return err != 0;
+}
+
+void EventLoop::_Dispatch(const FiredEvent& ev) {
+  Socket* sock = static_cast<Socket*>(ev.userdata);
+  if (!sock || sock->invalid())
+    return;
+
+  if (ev.events & static_cast<int>(EventType::Read)) {
+    if (!sock->OnReadable()) {
+      sock->OnError();
+      return;
+    }
+  }
+
+  if (ev.events & static_cast<int>(EventType::Write)) {
+    if (!sock->OnWritable()) {
+      sock->OnError();
+      return;
+    }
+  }
+
+  if (ev.events & static_cast<int>(EventType::Error)) {
+    // 零拷贝的完成通知通过错误队列送达，同样会触发 EPOLLERR。
+    // 通知可能已在上一次事件中被读走，所以以 SO_ERROR 判断是否真的出错；
+    // 对端挂断时 Read 分支会读到 EOF
+    if (sock->getSocketType() == Socket::SocketType::stream) {
+      auto conn = static_cast<StreamSocket*>(sock);
+      if (conn->zeroCopyEnabled()) {
+        conn->reapZeroCopy();
+        if (!_HasSocketError(sock->getSocket()))
+          return;
+      }
+    }
+    sock->OnError();
+  }
+}
+
+void EventLoop::_Complete(const Completion& c) {
+  Socket* sock = static_cast<Socket*>(c.userdata);
+  if (!sock || sock->invalid())
+    return;
+
+  switch (c.op) {
+    case Completion::Op::Accept:
+      static_cast<ListenSocket*>(sock)->OnAcceptComplete(c.result);
+      break;
+    case Completion::Op::Recv: {
+      // 0 为对端关闭
+      auto conn = static_cast<StreamSocket*>(sock);
+      if (c.result <= 0 ||
+          !conn->OnRecvComplete(c.data, static_cast<std::size_t>(c.result)))
+        conn->OnError();
+      break;
+    }
+    case Completion::Op::Send:
+      stats_.bytesOut +=
+          sendThread_.complete(static_cast<StreamSocket*>(sock), c.result);
+      break;
+  }
+}
+
+void EventLoop::_Run() {
+  spdlog::info("Event loop {} started", index_);
+  server_->_OnLoopStart(*this);
+
+  while (running_) {
+    // 上一轮没有接受完的连接先接受一批，并且本轮 poll 不再等待
+    bool acceptPending = false;
+    for (const auto& sock : listenSockets_) {
+      if (sock->acceptPending()) {
+        if (poller_->completionBased())
+          sock->acceptDeferred();
+        else
+          sock->OnReadable();
+        acceptPending = acceptPending || sock->acceptPending();
+      }
+    }
+
+    // 等待时间由最近的定时器决定，既不空转也不会错过到期时刻；
+    // 还有就绪连接没处理完或者上一轮没发完的回复时不等待
+    int timeoutMs = (acceptPending || taskManager_.hasReady() ||
+                     !sendThread_.empty())
+                        ? 0
+                        : timers_.nextTimeoutMs(nowMs(), kMaxPollTimeoutMs);
+    int nFired = poller_->poll(firedEvents_, kMaxEvents, timeoutMs);
+    ++stats_.iterations;
+    if (nFired > 0) {
+      stats_.events += nFired;
+      for (int i = 0; i < nFired; ++i)
+        _Dispatch(firedEvents_[i]);
+    }
+
+    const std::vector<Completion>& completions = poller_->completions();
+    if (!completions.empty()) {
+      stats_.events += completions.size();
+      for (const Completion& c : completions)
+        _Complete(c);
+    }
+    // 包括本轮开头为上一轮留下的 fd 建的连接
+    if (poller_->completionBased()) {
+      for (const auto& sock : listenSockets_)
+        sock->commitAccepted();
+    }
+
+    timers_.advance(nowMs());
+    _RunPosted();
+
+    taskManager_.DoMsgParse();
+
+    // 本轮所有连接的回复合并到这里发送
+    if (!sendThread_.empty()) {
+      stats_.bytesOut += sendThread_.flush();
+      stats_.writevCalls = sendThread_.writevCalls();
+    }
+  }
+
+  spdlog::info("Event loop {} stopped", index_);
+}
+}  // namespace Internal
@@ -0,0 +1,122 @@
+#if defined(__linux__)
+
+#include <base/poll/epoll.h>
+#include <base/poll/poller.h>
+#include <spdlog/spdlog.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+Epoll::Epoll(bool edgeTriggered) : edgeTriggered_(edgeTriggered) {
+  multiplexer_ = ::epoll_create1(EPOLL_CLOEXEC);
+  if (multiplexer_ == -1) {
+    spdlog::error("Failed to create epoll: {}", strerror(errno));
+    throw std::runtime_error("Failed to create epoll");
+  }
+  events_.resize(64);
+  spdlog::info("create epoll: {}, edge triggered: {}", multiplexer_,
+               edgeTriggered_);
+}
+
+Epoll::~Epoll() {
+  spdlog::info("close epoll: {}", multiplexer_);
+  if (multiplexer_ != -1) {
+    ::close(multiplexer_);
+  }
+}
+
+uint32_t Epoll::_ToEpollEvents(int events) const {
+  uint32_t ev = 0;
+  if (events & static_cast<int>(EventType::Read))
+    ev |= EPOLLIN;
+  if (events & static_cast<int>(EventType::Write))
+    ev |= EPOLLOUT;
+  // EPOLLERR 与 EPOLLHUP 内核总会上报，无需注册
+  if (edgeTriggered_)
+    ev |= EPOLLET;
+  return ev;
+}
+
+bool Epoll::addSocket(int sock, int events, void* userPtr) {
+  epoll_event ev;
+  ev.events = _ToEpollEvents(events);
+  ev.data.ptr = userPtr;
+
+  int ret = ::epoll_ctl(multiplexer_, EPOLL_CTL_ADD, sock, &ev);
+  if (ret == -1) {
+    spdlog::error("addSocket failed (fd {}): {}", sock, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool Epoll::delSocket(int sock, int /* events */) {
+  // epoll 以 fd 为单位注册，删除时忽略事件掩码；
+  // 2.6.9 之前的内核要求 event 非空，这里传一个占位
+  epoll_event dummy;
+  std::memset(&dummy, 0, sizeof(dummy));
+
+  int ret = ::epoll_ctl(multiplexer_, EPOLL_CTL_DEL, sock, &dummy);
+  if (ret == -1) {
+    spdlog::warn("delSocket failed (fd {}): {}", sock, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool Epoll::modSocket(int sock, int events, void* userPtr) {
+  // events 为 0 时也只修改掩码、不删除：fd 保持注册，之后的 modSocket
+  // 仍可原地打开事件（删除后再 EPOLL_CTL_MOD 会得到 ENOENT）
+  epoll_event ev;
+  ev.events = _ToEpollEvents(events);
+  ev.data.ptr = userPtr;
+
+  // 与 Kqueue 不同，epoll 可以原地修改，不需要先删后加
+  int ret = ::epoll_ctl(multiplexer_, EPOLL_CTL_MOD, sock, &ev);
+  if (ret == -1) {
+    spdlog::error("modSocket failed (fd {}): {}", sock, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+int Epoll::poll(std::vector<FiredEvent>& firedEvents, std::size_t maxEvent,
+                int timeoutMs) {
+  if (maxEvent == 0)  // 最大接受事件数
+    return 0;
+
+  if (events_.size() < maxEvent)
+    events_.resize(maxEvent);
+
+  int nFired = ::epoll_wait(multiplexer_, events_.data(),
+                            static_cast<int>(maxEvent), timeoutMs);
+  if (nFired == -1) {
+    if (errno == EINTR)
+      return 0;  // 被信号打断，不报错
+    spdlog::error("epoll_wait failed: {}", strerror(errno));
+    return -1;
+  }
+
+  // resize 不会释放已有容量，稳态下不再分配内存
+  firedEvents.resize(nFired);
+
+  for (int i = 0; i < nFired; ++i) {
+    FiredEvent& fe = firedEvents[i];
+    fe.events = 0;
+    fe.userdata = events_[i].data.ptr;
+
+    const uint32_t ev = events_[i].events;
+    if (ev & (EPOLLIN | EPOLLPRI | EPOLLRDHUP))
+      fe.events |= static_cast<int>(EventType::Read);
+    if (ev & EPOLLOUT)
+      fe.events |= static_cast<int>(EventType::Write);
+    if (ev & (EPOLLERR | EPOLLHUP))
+      fe.events |= static_cast<int>(EventType::Error);
+  }
+
+  return nFired;  // 发生的事件数
+}
+
+#endif
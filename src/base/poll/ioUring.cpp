@@ -0,0 +1,719 @@
+#include <base/poll/ioUring.h>
+
+#if defined(TINYREDIS_HAVE_IO_URING)
+
+#include <base/poll/poller.h>
+#include <poll.h>
+#include <signal.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+int sysSetup(unsigned entries, io_uring_params* p) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int sysRegister(int fd, unsigned opcode, void* arg, unsigned nrArgs) {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+}
+
+int sysEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags,
+             void* arg, std::size_t argSize) {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit,
+                                    minComplete, flags, arg, argSize));
+}
+
+// 内核与用户态共享的环形队列指针，需要 acquire/release 语义
+inline unsigned loadAcquire(const unsigned* p) {
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+inline void storeRelease(unsigned* p, unsigned v) {
+  __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+uint32_t pollMask(int events) {
+  uint32_t mask = 0;
+  if (events & static_cast<int>(EventType::Read))
+    mask |= POLLIN | POLLRDHUP;
+  if (events & static_cast<int>(EventType::Write))
+    mask |= POLLOUT;
+  return mask;
+}
+}  // namespace
+
+bool IoUring::isSupported() {
+  io_uring_params p;
+  std::memset(&p, 0, sizeof(p));
+  int fd = sysSetup(4, &p);
+  if (fd < 0) {
+    spdlog::info("io_uring_setup unavailable: {}", strerror(errno));
+    return false;
+  }
+
+  bool ok = (p.features & IORING_FEAT_EXT_ARG) &&
+            (p.features & IORING_FEAT_NODROP);
+
+  // multishot poll 没有单独的特性位，与 IORING_FEAT_RSRC_TAGS 同在 5.13 引入
+  ok = ok && (p.features & IORING_FEAT_RSRC_TAGS);
+
+  ::close(fd);
+  return ok;
+}
+
+IoUring::IoUring(unsigned entries, unsigned bufferCount,
+                 unsigned bufferSize) {
+  try {
+    _SetupRings(entries);
+  } catch (...) {
+    _Cleanup();
+    throw;
+  }
+  // 完成模型要求更新的内核，不支持时只做就绪通知，调用方自己收发
+  completion_ = bufferCount > 0 && _ProbeCompletion() &&
+                _SetupBufferRing(bufferCount, bufferSize);
+  spdlog::info("create io_uring: {}, sq entries {}, completion based: {}",
+               multiplexer_, sqEntries_, completion_);
+}
+
+IoUring::~IoUring() {
+  if (multiplexer_ != -1)
+    spdlog::info("close io_uring: {}", multiplexer_);
+  _Cleanup();
+
+  for (auto& kv : socks_) {
+    for (Request* req : kv.second.inflight)
+      delete req;
+  }
+  for (Request* req : freeRequests_)
+    delete req;
+}
+
+void IoUring::_Cleanup() {
+  if (multiplexer_ != -1) {
+    ::close(multiplexer_);  // 关闭 ring 时内核会取消全部未完成的请求
+    multiplexer_ = -1;
+  }
+  if (sqes_)
+    ::munmap(sqes_, sqesSize_);
+  if (cqRingPtr_ && cqRingPtr_ != sqRingPtr_)
+    ::munmap(cqRingPtr_, cqRingSize_);
+  if (sqRingPtr_)
+    ::munmap(sqRingPtr_, sqRingSize_);
+  sqes_ = nullptr;
+  cqRingPtr_ = sqRingPtr_ = nullptr;
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+  if (bufRing_)
+    ::munmap(bufRing_, bufRingSize_);
+  bufRing_ = nullptr;
+#endif
+}
+
+void IoUring::_SetupRings(unsigned entries) {
+  io_uring_params p;
+  std::memset(&p, 0, sizeof(p));
+  // multishot 请求一个 sqe 会产生多个 cqe，CQ 放大一些以减少溢出
+  p.flags = IORING_SETUP_CQSIZE;
+  p.cq_entries = entries * 4;
+
+  multiplexer_ = sysSetup(entries, &p);
+  if (multiplexer_ < 0) {
+    spdlog::error("Failed to create io_uring: {}", strerror(errno));
+    throw std::runtime_error("Failed to create io_uring");
+  }
+
+  sqRingSize_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  cqRingSize_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+  const bool singleMmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (singleMmap)
+    sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+  sqRingPtr_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, multiplexer_,
+                      IORING_OFF_SQ_RING);
+  if (sqRingPtr_ == MAP_FAILED) {
+    sqRingPtr_ = nullptr;
+    throw std::runtime_error("Failed to mmap io_uring sq ring");
+  }
+
+  if (singleMmap) {
+    cqRingPtr_ = sqRingPtr_;
+  } else {
+    cqRingPtr_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, multiplexer_,
+                        IORING_OFF_CQ_RING);
+    if (cqRingPtr_ == MAP_FAILED) {
+      cqRingPtr_ = nullptr;
+      throw std::runtime_error("Failed to mmap io_uring cq ring");
+    }
+  }
+
+  sqesSize_ = p.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, multiplexer_,
+                      IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    throw std::runtime_error("Failed to mmap io_uring sqes");
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  char* sq = static_cast<char*>(sqRingPtr_);
+  sqHead_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+  sqTail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+  sqMask_ = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+  sqArray_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+  sqEntries_ = p.sq_entries;
+  sqLocalTail_ = *sqTail_;
+
+  char* cq = static_cast<char*>(cqRingPtr_);
+  cqHead_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+  cqTail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+  cqMask_ = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+}
+
+bool IoUring::_ProbeCompletion() {
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+  // multishot recv 与 IORING_OP_SEND_ZC 同在 6.0 引入，用后者作为探针
+  const unsigned nOps = 256;
+  std::vector<char> mem(sizeof(io_uring_probe) +
+                        nOps * sizeof(io_uring_probe_op));
+  io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(mem.data());
+  if (sysRegister(multiplexer_, IORING_REGISTER_PROBE, probe, nOps) != 0)
+    return false;
+  return probe->last_op >= IORING_OP_SEND_ZC &&
+         (probe->ops[IORING_OP_SEND_ZC].flags & IO_URING_OP_SUPPORTED);
+#else
+  return false;
+#endif
+}
+
+bool IoUring::_SetupBufferRing(unsigned bufferCount, unsigned bufferSize) {
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+  // 条目数必须是 2 的幂，bid 只有 16 位
+  bufferCount = static_cast<unsigned>(
+      roundUp2Power(std::min(bufferCount, 32768U)));
+  bufRingSize_ = bufferCount * sizeof(io_uring_buf);
+  void* ring = ::mmap(nullptr, bufRingSize_, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ring == MAP_FAILED) {
+    spdlog::warn("mmap io_uring buffer ring failed: {}", strerror(errno));
+    return false;
+  }
+  bufRing_ = static_cast<io_uring_buf_ring*>(ring);
+  bufRing_->tail = 0;
+
+  io_uring_buf_reg reg;
+  std::memset(&reg, 0, sizeof(reg));
+  reg.ring_addr = reinterpret_cast<uint64_t>(bufRing_);
+  reg.ring_entries = bufferCount;
+  reg.bgid = 0;
+  if (sysRegister(multiplexer_, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+    spdlog::warn("register io_uring buffer ring failed: {}", strerror(errno));
+    ::munmap(bufRing_, bufRingSize_);
+    bufRing_ = nullptr;
+    return false;
+  }
+
+  bufMask_ = bufferCount - 1;
+  bufSize_ = bufferSize;
+  bufPool_.resize(static_cast<std::size_t>(bufferCount) * bufferSize);
+  usedBuffers_.reserve(bufferCount);
+  for (unsigned i = 0; i < bufferCount; ++i)
+    _PushBuffer(static_cast<uint16_t>(i));
+  return true;
+#else
+  (void)bufferCount;
+  (void)bufferSize;
+  return false;
+#endif
+}
+
+void IoUring::_PushBuffer(uint16_t bufferId) {
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+  // 内核头文件里的 bufs 是 __DECLARE_FLEX_ARRAY，C++ 下偏移量不是 0；
+  // tail 与第 0 项的 resv 重叠，这里不写 resv
+  const uint16_t tail = bufRing_->tail;
+  io_uring_buf& buf =
+      reinterpret_cast<io_uring_buf*>(bufRing_)[tail & bufMask_];
+  buf.addr = reinterpret_cast<uint64_t>(
+      &bufPool_[static_cast<std::size_t>(bufferId) * bufSize_]);
+  buf.len = bufSize_;
+  buf.bid = bufferId;
+  __atomic_store_n(&bufRing_->tail, static_cast<uint16_t>(tail + 1),
+                   __ATOMIC_RELEASE);
+#else
+  (void)bufferId;
+#endif
+}
+
+IoUring::Request* IoUring::_NewRequest(OpType op, int sock, void* userPtr) {
+  Request* req;
+  if (freeRequests_.empty()) {
+    req = new Request;
+  } else {
+    req = freeRequests_.back();
+    freeRequests_.pop_back();
+  }
+  req->op = op;
+  req->sock = sock;
+  req->userdata = userPtr;
+  req->events = 0;
+  req->cancelled = false;
+  req->stopping = false;
+  socks_[sock].inflight.push_back(req);
+  return req;
+}
+
+void IoUring::_FreeRequest(Request* req) {
+  auto it = socks_.find(req->sock);
+  if (it != socks_.end()) {
+    SockState& state = it->second;
+    if (state.poll == req)
+      state.poll = nullptr;
+    auto pos = std::find(state.inflight.begin(), state.inflight.end(), req);
+    if (pos != state.inflight.end()) {
+      *pos = state.inflight.back();
+      state.inflight.pop_back();
+    }
+    if (state.inflight.empty())
+      socks_.erase(it);
+  }
+  req->owner.reset();
+  freeRequests_.push_back(req);
+}
+
+io_uring_sqe* IoUring::_GetSqe() {
+  // SQ 已满，先把已有的提交掉
+  if (sqLocalTail_ - loadAcquire(sqHead_) >= sqEntries_) {
+    _Enter(_Flush(), 0, 0, -1);
+    if (sqLocalTail_ - loadAcquire(sqHead_) >= sqEntries_)
+      return nullptr;
+  }
+
+  const unsigned idx = sqLocalTail_ & *sqMask_;
+  io_uring_sqe* sqe = &sqes_[idx];
+  std::memset(sqe, 0, sizeof(*sqe));
+  sqArray_[idx] = idx;
+  ++sqLocalTail_;
+  return sqe;
+}
+
+unsigned IoUring::_Flush() {
+  storeRelease(sqTail_, sqLocalTail_);
+  return sqLocalTail_ - loadAcquire(sqHead_);
+}
+
+int IoUring::_Enter(unsigned toSubmit, unsigned minComplete, unsigned flags,
+                    int timeoutMs) {
+  io_uring_getevents_arg arg;
+  __kernel_timespec ts;
+  void* argPtr = nullptr;
+  std::size_t argSize = 0;
+
+  if ((flags & IORING_ENTER_GETEVENTS) && timeoutMs > 0) {
+    ts.tv_sec = timeoutMs / 1000;               // 秒数
+    ts.tv_nsec = (timeoutMs % 1000) * 1000000;  // 纳秒数
+    std::memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts = reinterpret_cast<uint64_t>(&ts);
+    argPtr = &arg;
+    argSize = sizeof(arg);
+    flags |= IORING_ENTER_EXT_ARG;
+  }
+
+  ++enterCalls_;
+  int ret = sysEnter(multiplexer_, toSubmit, minComplete, flags, argPtr,
+                     argSize);
+  if (ret < 0 && errno != ETIME && errno != EINTR && errno != EAGAIN &&
+      errno != EBUSY) {
+    spdlog::error("io_uring_enter failed: {}", strerror(errno));
+  }
+  return ret;
+}
+
+bool IoUring::addSocket(int sock, int events, void* userPtr) {
+  io_uring_sqe* sqe = _GetSqe();
+  if (!sqe) {
+    spdlog::error("addSocket failed (fd {}): sq full", sock);
+    return false;
+  }
+
+  Request* req = _NewRequest(OpType::Poll, sock, userPtr);
+  req->events = events;
+  socks_[sock].poll = req;
+
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = sock;
+  sqe->len = IORING_POLL_ADD_MULTI;
+  sqe->poll32_events = pollMask(events);
+  sqe->user_data = reinterpret_cast<uint64_t>(req);
+  return true;
+}
+
+bool IoUring::delSocket(int sock, int /* events */) {
+  auto it = socks_.find(sock);
+  if (it == socks_.end())
+    return false;
+
+  // 就绪通知与完成模型的请求一并取消。fd 可能马上被关闭并复用，
+  // 已取消的请求留在 inflight 里直到最后一个 cqe，这里跳过它们
+  it->second.poll = nullptr;
+  bool found = false;
+  for (Request* req : it->second.inflight) {
+    if (!req->cancelled) {
+      _Cancel(req);
+      found = true;
+    }
+  }
+  return found;
+}
+
+void IoUring::_Cancel(Request* req) {
+  req->cancelled = true;  // 之后到达的 cqe 全部丢弃，释放留给最后一个 cqe
+  _SubmitCancel(req);
+}
+
+void IoUring::_SubmitCancel(Request* req) {
+  io_uring_sqe* sqe = _GetSqe();
+  if (!sqe) {
+    spdlog::warn("cancel failed (fd {}): sq full", req->sock);
+    return;
+  }
+  // 按 user_data 取消而不是按 fd：fd 关闭后可能已被其他线程复用
+  sqe->opcode = req->op == OpType::Poll ? IORING_OP_POLL_REMOVE
+                                        : IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = reinterpret_cast<uint64_t>(req);
+  sqe->user_data = 0;  // 控制类请求的完成事件直接忽略
+}
+
+bool IoUring::modSocket(int sock, int events, void* userPtr) {
+  // events 为 0 时同样原地修改：只撤销就绪通知，不影响该 fd 上的收发请求
+  auto it = socks_.find(sock);
+  if (it == socks_.end() || !it->second.poll)
+    return addSocket(sock, events, userPtr);
+
+  // 原地修改 multishot poll 的事件掩码，不必先删后加。
+  // 即使更新时请求恰好已被内核终止，_Reap 也会按新的 events 重新注册
+  Request* req = it->second.poll;
+  req->userdata = userPtr;
+  if (req->events == events)
+    return true;
+
+  io_uring_sqe* sqe = _GetSqe();
+  if (!sqe) {
+    spdlog::warn("modSocket failed (fd {}): sq full", sock);
+    return false;
+  }
+  req->events = events;
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = reinterpret_cast<uint64_t>(req);
+  sqe->len = IORING_POLL_UPDATE_EVENTS | IORING_POLL_ADD_MULTI;
+  sqe->poll32_events = pollMask(events);
+  sqe->user_data = 0;
+  return true;
+}
+
+bool IoUring::submitAccept(int listenSock, void* userPtr) {
+  if (!completion_)
+    return false;
+  Request* req = _NewRequest(OpType::Accept, listenSock, userPtr);
+  if (!_SubmitAccept(req)) {
+    _FreeRequest(req);
+    return false;
+  }
+  return true;
+}
+
+bool IoUring::submitRecv(int sock, void* userPtr) {
+  if (!completion_)
+    return false;
+  Request* req = _NewRequest(OpType::Recv, sock, userPtr);
+  if (!_SubmitRecv(req)) {
+    _FreeRequest(req);
+    return false;
+  }
+  return true;
+}
+
+bool IoUring::cancelRecv(int sock) {
+  auto it = socks_.find(sock);
+  if (it == socks_.end())
+    return false;
+  for (Request* req : it->second.inflight) {
+    if (req->op == OpType::Recv && !req->cancelled && !req->stopping) {
+      req->stopping = true;
+      _SubmitCancel(req);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IoUring::submitSend(int sock, const BufferSequence& data,
+                         const std::shared_ptr<const void>& owner,
+                         bool zeroCopy, void* userPtr) {
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+  if (!completion_ || data.count == 0 ||
+      data.count > BufferSequence::kMaxIovec || (zeroCopy && data.count != 1))
+    return false;
+
+  io_uring_sqe* sqe = _GetSqe();
+  if (!sqe) {
+    spdlog::warn("submitSend failed (fd {}): sq full", sock);
+    return false;
+  }
+  Request* req = _NewRequest(OpType::Send, sock, userPtr);
+  req->owner = owner;
+
+  sqe->fd = sock;
+  sqe->msg_flags = MSG_NOSIGNAL;
+  sqe->user_data = reinterpret_cast<uint64_t>(req);
+  if (zeroCopy) {
+    sqe->opcode = IORING_OP_SEND_ZC;
+    sqe->addr = reinterpret_cast<uint64_t>(data.buffers[0].iov_base);
+    sqe->len = static_cast<uint32_t>(data.buffers[0].iov_len);
+  } else {
+    // iovec 复制到请求里，内核可能在 io_uring_enter 返回后才读取它们
+    std::copy(data.buffers, data.buffers + data.count, req->iov);
+    std::memset(&req->msg, 0, sizeof(req->msg));
+    req->msg.msg_iov = req->iov;
+    req->msg.msg_iovlen = data.count;
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->addr = reinterpret_cast<uint64_t>(&req->msg);
+    sqe->len = 1;
+  }
+  return true;
+#else
+  (void)sock;
+  (void)data;
+  (void)owner;
+  (void)zeroCopy;
+  (void)userPtr;
+  return false;
+#endif
+}
+
+bool IoUring::_SubmitAccept(Request* req) {
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+  io_uring_sqe* sqe = _GetSqe();
+  if (!sqe) {
+    spdlog::warn("submitAccept failed (fd {}): sq full", req->sock);
+    return false;
+  }
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = req->sock;
+  sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+  sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+  sqe->user_data = reinterpret_cast<uint64_t>(req);
+  return true;
+#else
+  (void)req;
+  return false;
+#endif
+}
+
+bool IoUring::_SubmitRecv(Request* req) {
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+  io_uring_sqe* sqe = _GetSqe();
+  if (!sqe) {
+    spdlog::warn("submitRecv failed (fd {}): sq full", req->sock);
+    return false;
+  }
+  // 不指定缓冲区，由内核在数据到达时从 buffer ring 中选一个
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = req->sock;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = 0;
+  sqe->user_data = reinterpret_cast<uint64_t>(req);
+  return true;
+#else
+  (void)req;
+  return false;
+#endif
+}
+
+int IoUring::poll(std::vector<FiredEvent>& firedEvents, std::size_t maxEvent,
+                  int timeoutMs) {
+  firedEvents.clear();
+  completions_.clear();
+  if (maxEvent == 0)  // 最大接受事件数
+    return 0;
+
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+  // 上一轮 completions() 里的数据已经被调用方取走，缓冲区还给内核
+  for (uint16_t bid : usedBuffers_)
+    _PushBuffer(bid);
+  usedBuffers_.clear();
+#endif
+
+  // 提交与等待合并成一次 io_uring_enter
+  const unsigned toSubmit = _Flush();
+  const bool ready = loadAcquire(cqTail_) != *cqHead_;
+  if (ready) {
+    if (toSubmit > 0)
+      _Enter(toSubmit, 0, 0, -1);
+  } else if (timeoutMs == 0) {
+    _Enter(toSubmit, 0, IORING_ENTER_GETEVENTS, 0);
+  } else {
+    int ret = _Enter(toSubmit, 1, IORING_ENTER_GETEVENTS, timeoutMs);
+    if (ret < 0 && errno != ETIME && errno != EINTR && errno != EAGAIN &&
+        errno != EBUSY)
+      return -1;
+  }
+
+  _Reap(firedEvents, maxEvent);
+  return static_cast<int>(firedEvents.size());
+}
+
+void IoUring::_Reap(std::vector<FiredEvent>& firedEvents,
+                    std::size_t maxEvent) {
+  unsigned head = *cqHead_;
+  const unsigned tail = loadAcquire(cqTail_);
+
+  // maxEvent 同时限制就绪事件与完成事件，其余 cqe 留在 CQ 里等下一次 poll()
+  for (; head != tail && firedEvents.size() + completions_.size() < maxEvent;
+       ++head) {
+    const io_uring_cqe& cqe = cqes_[head & *cqMask_];
+    Request* req = reinterpret_cast<Request*>(cqe.user_data);
+    if (!req)
+      continue;
+
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+    // 已取消的 recv 也可能占用了缓冲区，同样要归还
+    if (cqe.flags & IORING_CQE_F_BUFFER)
+      usedBuffers_.push_back(
+          static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+#endif
+
+    const bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+    if (req->cancelled) {
+      if (!more)
+        _FreeRequest(req);
+      continue;
+    }
+
+    if (req->op == OpType::Poll)
+      _ReapPoll(req, cqe, more, firedEvents);
+    else
+      _ReapIo(req, cqe, more);
+  }
+
+  storeRelease(cqHead_, head);
+}
+
+void IoUring::_ReapPoll(Request* req, const io_uring_cqe& cqe, bool more,
+                        std::vector<FiredEvent>& firedEvents) {
+  FiredEvent fe;
+  fe.userdata = req->userdata;
+  if (cqe.res < 0) {
+    fe.events = static_cast<int>(EventType::Error);
+  } else {
+    const uint32_t mask = static_cast<uint32_t>(cqe.res);
+    if (mask & (POLLIN | POLLPRI | POLLRDHUP))
+      fe.events |= static_cast<int>(EventType::Read);
+    if (mask & POLLOUT)
+      fe.events |= static_cast<int>(EventType::Write);
+    if (mask & (POLLERR | POLLHUP))
+      fe.events |= static_cast<int>(EventType::Error);
+  }
+  firedEvents.push_back(fe);
+
+  if (!more) {
+    // multishot poll 被内核终止（例如 CQ 溢出），透明地重新注册
+    const int sock = req->sock;
+    const int events = req->events;
+    void* userdata = req->userdata;
+    _FreeRequest(req);
+    if (cqe.res >= 0)
+      addSocket(sock, events, userdata);
+  }
+}
+
+void IoUring::_ReapIo(Request* req, const io_uring_cqe& cqe, bool more) {
+#if defined(TINYREDIS_HAVE_IO_URING_COMPLETION)
+  // SEND_ZC 的第二个 cqe：内核不再引用数据，可以释放 owner 了
+  if (cqe.flags & IORING_CQE_F_NOTIF) {
+    _FreeRequest(req);
+    return;
+  }
+
+  // cancelRecv 取消的 recv 结束了：调用方主动停的，不报告、不重新提交
+  if (req->stopping && !more &&
+      (cqe.res == -ECANCELED || cqe.res == -ENOBUFS)) {
+    _FreeRequest(req);
+    return;
+  }
+
+  // buffer ring 暂时用光，multishot recv 被终止；缓冲区在下一次 poll() 时
+  // 归还，这里直接重新提交，调用方感觉不到
+  if (req->op == OpType::Recv && cqe.res == -ENOBUFS) {
+    if (!_SubmitRecv(req)) {
+      Completion c;
+      c.result = -ENOBUFS;
+      c.userdata = req->userdata;
+      completions_.push_back(c);
+      _FreeRequest(req);
+    }
+    return;
+  }
+
+  Completion c;
+  c.result = cqe.res;
+  c.userdata = req->userdata;
+  switch (req->op) {
+    case OpType::Accept:
+      c.op = Completion::Op::Accept;
+      break;
+    case OpType::Recv:
+      c.op = Completion::Op::Recv;
+      if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER))
+        c.data = &bufPool_[static_cast<std::size_t>(
+                               cqe.flags >> IORING_CQE_BUFFER_SHIFT) *
+                           bufSize_];
+      break;
+    default:
+      c.op = Completion::Op::Send;
+      break;
+  }
+  completions_.push_back(c);
+
+  // SEND_ZC 的结果带 F_MORE：请求留到通知到达时再释放
+  if (more)
+    return;
+
+  // multishot accept/recv 被内核终止时重新提交；
+  // recv 读到 EOF 或出错、监听套接字已关闭时不再提交
+  bool resubmit = false;
+  if (req->op == OpType::Recv)
+    resubmit = cqe.res > 0 && !req->stopping;
+  else if (req->op == OpType::Accept)
+    resubmit = cqe.res != -EBADF && cqe.res != -EINVAL;
+  if (resubmit) {
+    resubmit = req->op == OpType::Recv ? _SubmitRecv(req) : _SubmitAccept(req);
+    if (!resubmit) {
+      c.result = -EAGAIN;  // 无法继续收，通知调用方按出错处理
+      c.data = nullptr;
+      completions_.push_back(c);
+    }
+  }
+  if (!resubmit)
+    _FreeRequest(req);
+#else
+  (void)req;
+  (void)cqe;
+  (void)more;
+#endif
+}
+
+#endif  // TINYREDIS_HAVE_IO_URING
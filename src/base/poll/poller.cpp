@@ -0,0 +1,67 @@
+#include <base/poll/poller.h>
+#include <spdlog/spdlog.h>
+#include <cstring>
+#include <exception>
+
+#if defined(__linux__)
+#include <base/poll/epoll.h>
+#include <base/poll/ioUring.h>
+#elif defined(__APPLE__)
+#include <base/poll/kqueue.h>
+#endif
+
+bool Poller::submitAccept(int /* listenSock */, void* /* userPtr */) {
+  return false;
+}
+
+bool Poller::submitRecv(int /* sock */, void* /* userPtr */) {
+  return false;
+}
+
+bool Poller::cancelRecv(int /* sock */) {
+  return false;
+}
+
+bool Poller::submitSend(int /* sock */, const BufferSequence& /* data */,
+                        const std::shared_ptr<const void>& /* owner */,
+                        bool /* zeroCopy */, void* /* userPtr */) {
+  return false;
+}
+
+std::unique_ptr<Poller> createPoller(PollerType type) {
+#if defined(__linux__)
+#if defined(TINYREDIS_HAVE_IO_URING)
+  if (type != PollerType::kEpoll && IoUring::isSupported()) {
+    try {
+      return std::unique_ptr<Poller>(new IoUring(4096));
+    } catch (const std::exception& e) {
+      // 例如 RLIMIT_MEMLOCK 过小或者被 seccomp 禁用
+      spdlog::warn("io_uring unavailable ({}), fall back to epoll", e.what());
+    }
+  } else if (type == PollerType::kIoUring) {
+    spdlog::warn("io_uring unsupported by the kernel, fall back to epoll");
+  }
+#else
+  if (type == PollerType::kIoUring)
+    spdlog::warn("built without io_uring, fall back to epoll");
+#endif
+  return std::unique_ptr<Poller>(new Epoll());
+#elif defined(__APPLE__)
+  (void)type;
+  return std::unique_ptr<Poller>(new Kqueue());
+#else
+#error "Unsupported platform"
+#endif
+}
+
+bool parsePollerType(const char* name, PollerType& type) {
+  if (!std::strcmp(name, "epoll")) {
+    type = PollerType::kEpoll;
+    return true;
+  }
+  if (!std::strcmp(name, "io_uring")) {
+    type = PollerType::kIoUring;
+    return true;
+  }
+  return false;
+}
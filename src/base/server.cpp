@@ -0,0 +1,102 @@
+#include <base/eventLoop.h>
+#include <base/server.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+const std::size_t Server::kMaxLoopCount = Internal::TaskManager::kMaxShards;
+
+Server::Server()
+    : loopCount_(0),
+      zeroCopyThreshold_(64 * 1024),
+      pollerType_(PollerType::kAuto),
+      listenBacklog_(Internal::ListenSocket::LISTENQ),
+      terminate_(false) {}
+
+Server::~Server() {}
+
+void Server::setLoopCount(std::size_t n) {
+  if (n > kMaxLoopCount) {
+    spdlog::warn("Loop count {} exceeds the limit, use {}", n, kMaxLoopCount);
+    n = kMaxLoopCount;
+  }
+  loopCount_ = n;
+}
+
+bool Server::TCPBind(const SocketAddr& listenAddr, int tag) {
+  if (listenAddr.empty())
+    return false;
+  listenAddrs_.push_back(std::make_pair(listenAddr, tag));
+  return true;
+}
+
+std::shared_ptr<StreamSocket> Server::_OnNewConnection(int /* tag */) {
+  return std::make_shared<StreamSocket>();
+}
+
+bool Server::MainLoop() {
+  std::size_t n = loopCount_;
+  if (n == 0)
+    n = std::min<std::size_t>(std::max(1U, std::thread::hardware_concurrency()),
+                              kMaxLoopCount);
+
+  if (!_Init()) {
+    spdlog::error("Server init failed");
+    return false;
+  }
+
+  for (std::size_t i = 0; i < n; ++i) {
+    std::unique_ptr<Internal::EventLoop> loop(new Internal::EventLoop(this, i));
+    for (const auto& addr : listenAddrs_) {
+      if (!loop->listen(addr.first, addr.second)) {
+        spdlog::error("Event loop {} failed to listen on {}", i,
+                      addr.first.toString());
+        // 循环还没有启动，直接析构即可关闭已经建好的监听套接字
+        loops_.clear();
+        _Recycle();
+        return false;
+      }
+    }
+    loops_.push_back(std::move(loop));
+  }
+
+  for (auto& loop : loops_)
+    loop->start();
+  spdlog::info("Server started with {} event loops", loops_.size());
+
+  // 主线程只负责等待退出和定期打印统计
+  int seconds = 0;
+  while (!terminate_) {
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    if (++seconds % 60 == 0)
+      logStats();
+  }
+
+  for (auto& loop : loops_)
+    loop->stop();
+  logStats();
+  loops_.clear();
+
+  _Recycle();
+  return true;
+}
+
+void Server::logStats() const {
+  for (const auto& loop : loops_) {
+    const Internal::LoopStats& st = loop->stats();
+    spdlog::info(
+        "loop {}: connections {}, accepted {}, closed {}, iterations {}, "
+        "events {}, bytes in {}, bytes out {}, commands {} in {} batches "
+        "(avg {:.1f}), writev {}, zerocopy sends {} "
+        "({} bytes, {} copied by kernel), zerocopy fallbacks {}",
+        loop->index(), st.accepted - st.closed, st.accepted.load(),
+        st.closed.load(), st.iterations.load(), st.events.load(),
+        st.bytesIn.load(), st.bytesOut.load(), st.commands.load(),
+        st.batches.load(),
+        st.batches ? static_cast<double>(st.commands) / st.batches : 0.0,
+        st.writevCalls.load(),
+        st.zeroCopySends.load(), st.zeroCopyBytes.load(),
+        st.zeroCopyCopied.load(), st.zeroCopyFallbacks.load());
+  }
+}
@@ -0,0 +1,177 @@
+#include <base/eventLoop.h>
+#include <base/socket/listenSocket.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <cerrno>
+#include <memory>
+#include <vector>
+
+namespace Internal {
+const int ListenSocket::LISTENQ = 1024;
+const int ListenSocket::kAcceptBatch = 64;
+
+ListenSocket::ListenSocket(int tag, int backlog)
+    : localPort_(0),
+      tag_(tag),
+      backlog_(backlog > 0 ? backlog : LISTENQ),
+      acceptPending_(false),
+      roundAccepted_(0) {}
+
+ListenSocket::~ListenSocket() {
+  for (int connfd : deferred_)
+    closeSocket(connfd);
+  spdlog::info("Close listen socket {}, port {}", localSock_, localPort_);
+}
+
+bool ListenSocket::Bind(const SocketAddr& addr) {
+  if (addr.empty())
+    return false;
+
+  if (localSock_ != INVALID_SOCKET)
+    return false;
+
+  localPort_ = addr.getPort();
+  localSock_ = createTCPSocket();
+  if (localSock_ == INVALID_SOCKET)
+    return false;
+
+  setNonBlock(localSock_, true);
+
+  int reuse = 1;
+  ::setsockopt(localSock_, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse,
+               sizeof(reuse));
+  if (::setsockopt(localSock_, SOL_SOCKET, SO_REUSEPORT, (const char*)&reuse,
+                   sizeof(reuse)) == SOCKET_ERROR) {
+    spdlog::error("setsockopt SO_REUSEPORT failed: {}", strerror(errno));
+    closeSocket(localSock_);
+    return false;
+  }
+
+  sockaddr_in serv = addr.getAddr();
+  if (::bind(localSock_, (sockaddr*)&serv, sizeof(serv)) == SOCKET_ERROR) {
+    spdlog::error("bind {} failed: {}", addr.toString(), strerror(errno));
+    closeSocket(localSock_);
+    return false;
+  }
+
+  // 实际长度还受 net.core.somaxconn 限制
+  if (::listen(localSock_, backlog_) == SOCKET_ERROR) {
+    spdlog::error("listen {} failed: {}", addr.toString(), strerror(errno));
+    closeSocket(localSock_);
+    return false;
+  }
+
+  spdlog::info("Success: listen on ({}:{}), backlog {}", addr.getIP(),
+               localPort_, backlog_);
+  return true;
+}
+
+int ListenSocket::_Accept() {
+  socklen_t addrLength = sizeof(addrClient_);
+#if defined(__linux__)
+  // 一次系统调用同时设置非阻塞和 close-on-exec
+  return ::accept4(localSock_, (sockaddr*)&addrClient_, &addrLength,
+                   SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+  int connfd = ::accept(localSock_, (sockaddr*)&addrClient_, &addrLength);
+  if (connfd != SOCKET_ERROR)
+    setNonBlock(connfd, true);
+  return connfd;
+#endif
+}
+
+bool ListenSocket::OnReadable() {
+  if (!loop_)
+    return false;
+
+  // 一次最多接受 kAcceptBatch 个连接，避免连接风暴时长时间不处理已有连接；
+  // 边沿触发下剩余的连接不会再通知，由事件循环根据 acceptPending 继续接受
+  std::vector<std::shared_ptr<StreamSocket>> batch;
+  batch.reserve(kAcceptBatch);
+  int accepted = 0;
+  while (accepted < kAcceptBatch) {
+    int connfd = _Accept();
+    if (connfd == SOCKET_ERROR) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        spdlog::error("accept failed: {}", strerror(errno));
+      break;
+    }
+
+    ++accepted;
+    setNodelay(connfd);
+    std::shared_ptr<StreamSocket> conn =
+        loop_->newConnection(connfd, SocketAddr(addrClient_), tag_);
+    if (conn)
+      batch.push_back(std::move(conn));
+  }
+  acceptPending_ = (accepted == kAcceptBatch);
+
+  // 整批只加一次锁交给 TaskManager
+  if (!batch.empty())
+    loop_->taskManager().addTasks(batch);
+  return true;
+}
+
+void ListenSocket::OnAcceptComplete(int connfd) {
+  if (!loop_)
+    return;
+  if (connfd < 0) {
+    if (connfd != -EINTR && connfd != -ECONNABORTED && connfd != -EAGAIN)
+      spdlog::error("accept failed: {}", strerror(-connfd));
+    return;
+  }
+
+  // multishot accept 一轮可能交来成百上千个连接，与就绪通知下一样
+  // 每轮最多建 kAcceptBatch 个，其余按到达顺序留到后面几轮
+  if (!deferred_.empty() || roundAccepted_ >= kAcceptBatch) {
+    deferred_.push_back(connfd);
+    acceptPending_ = true;
+    return;
+  }
+  _AddAccepted(connfd);
+}
+
+void ListenSocket::acceptDeferred() {
+  while (!deferred_.empty() && roundAccepted_ < kAcceptBatch) {
+    _AddAccepted(deferred_.front());
+    deferred_.pop_front();
+  }
+  acceptPending_ = !deferred_.empty();
+}
+
+void ListenSocket::_AddAccepted(int connfd) {
+  ++roundAccepted_;
+  sockaddr_in peer;
+  socklen_t len = sizeof(peer);
+  std::memset(&peer, 0, sizeof(peer));
+  ::getpeername(connfd, (sockaddr*)&peer, &len);
+
+  setNodelay(connfd);
+  std::shared_ptr<StreamSocket> conn =
+      loop_->newConnection(connfd, SocketAddr(peer), tag_);
+  if (conn)
+    accepted_.push_back(std::move(conn));
+}
+
+void ListenSocket::commitAccepted() {
+  roundAccepted_ = 0;
+  if (accepted_.empty())
+    return;
+  loop_->taskManager().addTasks(accepted_);
+  accepted_.clear();
+}
+
+bool ListenSocket::OnWritable() {
+  return false;
+}
+
+bool ListenSocket::OnError() {
+  if (Socket::OnError()) {
+    spdlog::error("Listen socket {} error", localSock_);
+    return true;
+  }
+  return false;
+}
+}  // namespace Internal
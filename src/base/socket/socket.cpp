@@ -3,13 +3,15 @@
 #include <spdlog/spdlog.h>
 #include <sys/fcntl.h>
 #include <sys/socket.h>
-
-#if defined(__APPLE__)
 #include <unistd.h>
-#endif
+
+std::atomic<std::size_t> Socket::sid_{0};
 
 Socket::Socket()
-    : localSock_(INVALID_SOCKET), epollOut_(false), invalid_(false) {
+    : localSock_(INVALID_SOCKET),
+      epollOut_(false),
+      loop_(nullptr),
+      invalid_(false) {
   ++sid_;
   std::size_t expect = 0;
   sid_.compare_exchange_strong(expect, 1);
@@ -44,6 +46,14 @@ bool Socket::OnError() {
   return false;
 }
 
+bool Socket::OnConnect() {
+  return false;
+}
+
+bool Socket::OnDisconnect() {
+  return false;
+}
+
 void Socket::closeSocket(int& sock) {
   if (sock != INVALID_SOCKET) {
     ::shutdown(sock, SHUT_RDWR);  // 关闭套接字读写方向
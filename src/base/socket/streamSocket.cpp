@@ -1,5 +1,418 @@
+#include <base/eventLoop.h>
 #include <base/socket/streamSocket.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <cerrno>
+#include <vector>
 
-bool StreamSocket::DoMsgParse(){
-    
-}
\ No newline at end of file
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#endif
+
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#define TINYREDIS_HAVE_ZEROCOPY 1
+#endif
+
+namespace {
+const int kEOFSocket = -1;     // 对端关闭
+const int kErrorSocket = -2;   // 读出错
+const std::size_t kRecvBufferSize = 64 * 1024;
+// 单个请求大于接收缓冲区时翻倍扩容，最多到 1GB
+const std::size_t kMaxRecvBufferSize = 1024 * 1024 * 1024;
+// 一次解析中缓冲区反复被填满时最多补读几次，防止一个连接占住整轮
+const int kMaxReadsPerParse = 4;
+// 连接被强制关闭后就读不到零拷贝的完成通知了，内核可能仍在发送的内存
+// 交给事件循环再保留这么久
+const uint64_t kZeroCopyLingerMs = 10 * 1000;
+}  // namespace
+
+std::size_t StreamSocket::maxPacketSize() {
+  // 环形缓冲区留一个字节区分空和满
+  return kMaxRecvBufferSize - 1;
+}
+
+StreamSocket::StreamSocket()
+    : recvFull_(false),
+      sendPending_(false),
+      closeAfterReply_(false),
+      readPaused_(false),
+      sendInflight_(false),
+      sendInflightChunk_(false),
+      ready_(false),
+      readyNext_(nullptr),
+      zcThreshold_(0),
+      bytesQueued_(0),
+      bytesSent_(0),
+      zcNextSeq_(0),
+      zcDoneSeq_(0) {}
+
+StreamSocket::~StreamSocket() {
+  spdlog::debug("Destruct stream socket {}", localSock_);
+}
+
+bool StreamSocket::init(int fd, const SocketAddr& peer) {
+  if (fd < 0)
+    return false;
+
+  peerAddr_ = peer;
+  localSock_ = fd;
+  return true;
+}
+
+int StreamSocket::recv() {
+  // 第一次收到数据才分配缓冲区，空闲连接不占内存
+  if (recvBuf_.capacity() == 0)
+    recvBuf_.initCapacity(kRecvBufferSize);
+
+  BufferSequence buffers;
+  recvBuf_.getSpace(buffers);
+  if (buffers.count == 0) {
+    recvFull_ = true;
+    return 0;
+  }
+
+  int ret = static_cast<int>(::readv(localSock_, buffers.buffers,
+                                     static_cast<int>(buffers.count)));
+  if (ret == SOCKET_ERROR) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+      return 0;
+    spdlog::debug("recv error on socket {}: {}", localSock_, strerror(errno));
+    return kErrorSocket;
+  }
+  if (ret == 0)
+    return kEOFSocket;
+
+  recvBuf_.adjustWriteAddr(ret);
+  return ret;
+}
+
+bool StreamSocket::OnReadable() {
+  // 暂停前已经产生的可读事件，留到 resumeRead 时补读
+  if (readPaused_)
+    return true;
+  // 边沿触发（以及 io_uring 的 multishot poll）下必须一直读到 EAGAIN
+  for (;;) {
+    int nBytes = recv();
+    if (nBytes < 0)
+      return false;  // 由调用方转到 OnError
+    if (nBytes == 0)
+      break;
+    if (loop_)
+      loop_->stats().bytesIn += nBytes;
+    _MarkReady();
+  }
+  return true;
+}
+
+bool StreamSocket::OnRecvComplete(const char* data, std::size_t len) {
+  if (recvBuf_.capacity() == 0)
+    recvBuf_.initCapacity(kRecvBufferSize);
+
+  // 完成模型下内核不等我们腾出空间就会继续收，放不下时直接扩容
+  if (recvBuf_.writableSize() < len) {
+    const std::size_t need = recvBuf_.readableSize() + len + 1;
+    if (need > kMaxRecvBufferSize)
+      return false;
+    recvBuf_.expand(need);
+  }
+  recvBuf_.pushData(data, len);
+  if (loop_)
+    loop_->stats().bytesIn += len;
+  _MarkReady();
+  return true;
+}
+
+void StreamSocket::pauseRead() {
+  if (readPaused_ || !loop_ || invalid())
+    return;
+  readPaused_ = true;
+  Poller* poller = loop_->poller();
+  if (poller->completionBased())
+    poller->cancelRecv(localSock_);
+  else
+    poller->modSocket(localSock_, _PollEvents(), static_cast<Socket*>(this));
+}
+
+void StreamSocket::resumeRead() {
+  if (!readPaused_ || !loop_)
+    return;
+  readPaused_ = false;
+  if (invalid())
+    return;
+  Poller* poller = loop_->poller();
+  if (poller->completionBased()) {
+    if (!poller->submitRecv(localSock_, static_cast<Socket*>(this)))
+      OnError();
+    return;
+  }
+  poller->modSocket(localSock_, _PollEvents(), static_cast<Socket*>(this));
+  // 暂停期间到达的数据不会再有边沿事件，下次解析完后补读
+  recvFull_ = true;
+  _MarkReady();
+}
+
+int StreamSocket::_PollEvents() const {
+  int events = readPaused_ ? 0 : static_cast<int>(EventType::Read);
+  if (epollOut_)
+    events |= static_cast<int>(EventType::Write);
+  return events;
+}
+
+bool StreamSocket::OnWritable() {
+  // 上次发送不完整，交给 SendThread 在本轮末尾继续发
+  _MarkSendPending();
+  return true;
+}
+
+bool StreamSocket::sendPacket(const void* data, std::size_t len) {
+  if (invalid() || len == 0)
+    return false;
+  sendBuf_.write(data, len);
+  bytesQueued_ += len;
+  _MarkSendPending();
+  return true;
+}
+
+bool StreamSocket::sendPacket(const BufferSequence& data) {
+  if (invalid() || data.totalBytes() == 0)
+    return false;
+  bytesQueued_ += data.totalBytes();
+  sendBuf_.write(data);
+  _MarkSendPending();
+  return true;
+}
+
+bool StreamSocket::sendPacket(const std::shared_ptr<const void>& owner,
+                              const char* data, std::size_t len) {
+  if (zcThreshold_ == 0 || len < zcThreshold_) {
+    if (loop_ && zcThreshold_ > 0)
+      ++loop_->stats().zeroCopyFallbacks;
+    return sendPacket(data, len);
+  }
+  if (invalid())
+    return false;
+
+  ZeroCopyChunk chunk;
+  chunk.owner = owner;
+  chunk.data = data;
+  chunk.len = len;
+  chunk.sent = 0;
+  chunk.start = bytesQueued_;
+  chunk.lastSeq = 0;
+  chunk.hasSeq = false;
+  zcQueue_.push_back(chunk);
+  bytesQueued_ += len;
+  _MarkSendPending();
+  return true;
+}
+
+void StreamSocket::enableZeroCopy(std::size_t threshold) {
+  zcThreshold_ = 0;
+  if (threshold == 0)
+    return;
+#if defined(TINYREDIS_HAVE_ZEROCOPY)
+  int one = 1;
+  if (::setsockopt(localSock_, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) ==
+      0) {
+    zcThreshold_ = threshold;
+  } else {
+    spdlog::debug("SO_ZEROCOPY unsupported on socket {}: {}", localSock_,
+                  strerror(errno));
+  }
+#endif
+}
+
+bool StreamSocket::reapZeroCopy() {
+  bool reaped = false;
+#if defined(TINYREDIS_HAVE_ZEROCOPY)
+  if (zcThreshold_ == 0)
+    return false;
+
+  for (;;) {
+    char control[128];
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    if (::recvmsg(localSock_, &msg, MSG_ERRQUEUE) == SOCKET_ERROR)
+      break;  // EAGAIN：错误队列已读空
+
+    for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+      const bool isRecvErr =
+          (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+          (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+      if (!isRecvErr)
+        continue;
+
+      sock_extended_err serr;
+      std::memcpy(&serr, CMSG_DATA(cm), sizeof(serr));
+      if (serr.ee_errno != 0 || serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+        continue;
+
+      // 内核退化成了拷贝（例如回环网卡），数据仍然发送成功
+      if ((serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) && loop_)
+        ++loop_->stats().zeroCopyCopied;
+      _CompleteZeroCopy(serr.ee_info, serr.ee_data);
+      reaped = true;
+    }
+  }
+#endif
+  return reaped;
+}
+
+void StreamSocket::_CompleteZeroCopy(uint32_t lo, uint32_t hi) {
+  // 通知一般按序到达，乱序的区间先存起来
+  if (lo != zcDoneSeq_) {
+    zcPendingRanges_[lo] = hi;
+    return;
+  }
+  zcDoneSeq_ = hi + 1;
+  for (auto it = zcPendingRanges_.find(zcDoneSeq_);
+       it != zcPendingRanges_.end();
+       it = zcPendingRanges_.find(zcDoneSeq_)) {
+    zcDoneSeq_ = it->second + 1;
+    zcPendingRanges_.erase(it);
+  }
+
+  // 序号小于 zcDoneSeq_ 的块内核已不再引用，可以释放（序号会回绕，按差值比较）
+  while (!zcInflight_.empty() &&
+         static_cast<int32_t>(zcInflight_.front().lastSeq - zcDoneSeq_) < 0) {
+    zcInflight_.pop_front();
+  }
+  // 等这些通知才关闭的连接现在可以关了
+  if (closeAfterReply_ && zcInflight_.empty())
+    _MarkSendPending();
+}
+
+void StreamSocket::_LingerZeroCopy() {
+  reapZeroCopy();  // 已经到达的通知先读走
+
+  // 发出去一部分的块同样被内核引用着
+  auto pinned = std::make_shared<std::vector<std::shared_ptr<const void>>>();
+  for (const ZeroCopyChunk& chunk : zcInflight_)
+    pinned->push_back(chunk.owner);
+  for (const ZeroCopyChunk& chunk : zcQueue_) {
+    if (chunk.hasSeq)
+      pinned->push_back(chunk.owner);
+  }
+  zcInflight_.clear();
+  zcQueue_.clear();
+  if (pinned->empty())
+    return;
+
+  spdlog::debug("socket {} closed with {} zero-copy buffers in flight",
+                localSock_, pinned->size());
+  loop_->timers().schedule(kZeroCopyLingerMs, [pinned]() { pinned->clear(); });
+}
+
+void StreamSocket::closeAfterReply() {
+  // 不再处理后续请求，回复发完后由 SendThread 关闭连接
+  closeAfterReply_ = true;
+  _MarkSendPending();
+}
+
+void StreamSocket::_MarkReady() {
+  if (!ready_ && loop_)
+    loop_->taskManager().markReady(this);
+}
+
+void StreamSocket::_MarkSendPending() {
+  if (!sendPending_ && loop_) {
+    loop_->sendThread().addPending(
+        std::static_pointer_cast<StreamSocket>(shared_from_this()));
+  }
+}
+
+bool StreamSocket::OnError() {
+  if (Socket::OnError()) {
+    spdlog::debug(
+        "OnError stream socket {}: {} commands in {} batches (max {}), "
+        "{} flushes, {} writev",
+        localSock_, batch_.commands, batch_.batches, batch_.maxBatch,
+        batch_.flushes, batch_.writevCalls);
+    if (loop_) {
+      _LingerZeroCopy();
+      loop_->unregisterSocket(this);
+      _MarkReady();  // 由 TaskManager 在本轮移除
+    }
+    return true;
+  }
+  return false;
+}
+
+bool StreamSocket::DoMsgParse() {
+  std::size_t commands = 0;
+  for (int reads = 0;; ++reads) {
+    commands += _ParseBatch();
+
+    // 一个请求就占满了缓冲区，扩容后才能继续接收；
+    // 大请求处理完后缩回默认大小，不为偶尔一次的大请求一直占着内存
+    // 暂停接收时缓冲区满了并不说明一个请求放不下，不扩容
+    if (!recvBuf_.isEmpty() && recvBuf_.writableSize() == 0 &&
+        !readPaused_ && recvBuf_.capacity() < kMaxRecvBufferSize) {
+      recvBuf_.expand(recvBuf_.capacity() * 2);
+    } else if (recvBuf_.capacity() > kRecvBufferSize &&
+               recvBuf_.readableSize() < kRecvBufferSize / 2) {
+      recvBuf_.shrink(kRecvBufferSize);
+    }
+
+    // 缓冲区满时停止了读取，腾出空间后补读，避免边沿触发丢事件；
+    // 补读到的请求并入这一批，回复仍在本轮末尾一起发送
+    if (!recvFull_ || recvBuf_.writableSize() == 0 || closeAfterReply_ ||
+        readPaused_)
+      break;
+    recvFull_ = false;
+    if (!OnReadable()) {
+      OnError();
+      break;
+    }
+    if (reads == kMaxReadsPerParse)
+      break;  // 剩下的已重新挂到就绪链表，下一轮继续
+  }
+
+  _RecordBatch(commands);
+  return commands > 0;
+}
+
+std::size_t StreamSocket::_ParseBatch() {
+  std::size_t commands = 0;
+  while (!recvBuf_.isEmpty() && !closeAfterReply_) {
+    BufferSequence datum;
+    recvBuf_.getDatum(datum, recvBuf_.readableSize());
+
+    // 先直接在第一段上解析，大多数帧不跨过缓冲区末尾，不需要拷贝
+    auto bodyLen =
+        _HandlePacket(static_cast<const char*>(datum.buffers[0].iov_base),
+                      datum.buffers[0].iov_len);
+    if (bodyLen <= 0 && datum.count > 1 && !readPaused_) {
+      // 帧跨过了缓冲区末尾：把数据挪到开头一次，之后收到的数据接在后面，
+      // 不用每次重新拷贝；解析器以偏移保存进度，续传不会重复扫描。
+      // 暂停接收时不会再有数据，不必挪
+      recvBuf_.linearize();
+      bodyLen = _HandlePacket(recvBuf_.readAddr(), recvBuf_.readableSize());
+    }
+    if (bodyLen <= 0)
+      break;
+
+    ++commands;
+    recvBuf_.adjustReadAddr(bodyLen);
+  }
+  return commands;
+}
+
+void StreamSocket::_RecordBatch(std::size_t commands) {
+  if (commands == 0)
+    return;
+  ++batch_.batches;
+  batch_.commands += commands;
+  batch_.lastBatch = commands;
+  batch_.maxBatch = std::max<uint64_t>(batch_.maxBatch, commands);
+  if (loop_) {
+    ++loop_->stats().batches;
+    loop_->stats().commands += commands;
+  }
+}
@@ -1,10 +1,24 @@
 #include <base/taskManager.h>
 #include <cassert>
-#include <map>
 #include <mutex>
 #include "spdlog/spdlog.h"
 
 namespace Internal {
+const uint32_t TaskManager::kNil;
+const std::size_t TaskManager::kMaxShards;
+
+static_assert(TaskManager::kSlotBits + TaskManager::kShardBits == 32,
+              "连接 ID 的低 32 位为分片与槽下标，高 32 位为代数");
+
+TaskManager::TaskManager(std::size_t shard)
+    : shard_(static_cast<uint32_t>(shard)),
+      readyHead_(nullptr),
+      readyTail_(nullptr),
+      newCnt_(0) {
+  // 超出范围时 ID 会与其他循环的连接重复，Server 已把循环数限制在范围内
+  assert(shard < kMaxShards && "shard does not fit in the connection ID");
+}
+
 TaskManager::~TaskManager() {
   assert(empty() && "Why you do not clear container before exit?");
 }
@@ -16,63 +30,135 @@ bool TaskManager::addTask(PTCPSOCKET task) {
   return true;
 }
 
-TaskManager::PTCPSOCKET TaskManager::findTCP(unsigned int id) const {
-  if (id > 0) {
-    auto it = tcpSockets_.find(id);
-    if (it != tcpSockets_.end())
-      return it->second;
-  }
+bool TaskManager::addTasks(const NEWTASK_T& tasks) {
+  std::lock_guard<std::mutex> guard(lock_);
+  newTasks_.insert(newTasks_.end(), tasks.begin(), tasks.end());
+  newCnt_ += static_cast<int>(tasks.size());
+  return true;
+}
+
+void TaskManager::clear() {
+  readyHead_ = readyTail_ = nullptr;
+  tasks_.clear();
+  slots_.clear();
+  freeSlots_.clear();
+}
+
+TaskManager::PTCPSOCKET TaskManager::findTCP(std::size_t id) const {
+  // 槽下标与代数都对得上才是同一个连接
+  const uint32_t slot = static_cast<uint32_t>(id & ((1U << kSlotBits) - 1));
+  const uint32_t gen = static_cast<uint32_t>(id >> (kSlotBits + kShardBits));
+  if (slot < slots_.size() && slots_[slot].gen == gen &&
+      slots_[slot].pos != kNil)
+    return tasks_[slots_[slot].pos];
   return PTCPSOCKET();
 }
 
 bool TaskManager::_AddTask(PTCPSOCKET task) {
-  bool success = tcpSockets_.insert({task->getID(), task}).second;
-  return success;
+  uint32_t slot;
+  if (!freeSlots_.empty()) {
+    slot = freeSlots_.back();
+    freeSlots_.pop_back();
+  } else {
+    if (slots_.size() >= (1U << kSlotBits))
+      return false;
+    slot = static_cast<uint32_t>(slots_.size());
+    slots_.push_back(Slot{1, kNil});
+  }
+
+  slots_[slot].pos = static_cast<uint32_t>(tasks_.size());
+  task->_SetID((static_cast<std::size_t>(slots_[slot].gen)
+                << (kSlotBits + kShardBits)) |
+               (static_cast<std::size_t>(shard_) << kSlotBits) | slot);
+  tasks_.push_back(std::move(task));
+  return true;
 }
 
-void TaskManager::_RemoveTask(std::map<int, PTCPSOCKET>::iterator& it) {
-  tcpSockets_.erase(it++);  // 采用 it++ 确保在删除后迭代器仍然有效
+void TaskManager::markReady(StreamSocket* sock) {
+  if (sock->ready_)
+    return;
+  sock->ready_ = true;
+  sock->readyNext_ = nullptr;
+  if (readyTail_)
+    readyTail_->readyNext_ = sock;
+  else
+    readyHead_ = sock;
+  readyTail_ = sock;
 }
 
-bool TaskManager::DoMsgParse() {
-  if (newCnt_ > 0 && lock_.try_lock()) {
-    NEWTASK_T tmpNewTasks;
-    tmpNewTasks.swap(newTasks_);
-    newCnt_ = 0;
-    lock_.unlock();
-
-    for (const auto& task : newTasks_) {
-      if (!_AddTask(task)) {
-        spdlog::error("Why can not insert tcp socket {} , id = {}",
-                      task->getSocket(), task->getID());
-      } else {
-        spdlog::info("New connection from {}, id = {}",
-                     task->getPeerAddr().toString(), task->getID());
-        // 调用任务的连接成功回调
-        task->OnConnect();
-      }
+void TaskManager::_RemoveTask(StreamSocket* sock) {
+  const uint32_t slot =
+      static_cast<uint32_t>(sock->getID() & ((1U << kSlotBits) - 1));
+  if (slot >= slots_.size() || slots_[slot].pos == kNil ||
+      tasks_[slots_[slot].pos].get() != sock)
+    return;  // 还没有加入（ID 尚未分配）
+
+  // 与最后一个交换后删除，保持 tasks_ 紧凑
+  const std::size_t pos = slots_[slot].pos;
+  if (pos + 1 != tasks_.size()) {
+    tasks_[pos] = std::move(tasks_.back());
+    const uint32_t moved =
+        static_cast<uint32_t>(tasks_[pos]->getID() & ((1U << kSlotBits) - 1));
+    slots_[moved].pos = static_cast<uint32_t>(pos);
+  }
+  tasks_.pop_back();
+
+  slots_[slot].pos = kNil;
+  if (++slots_[slot].gen == 0)
+    slots_[slot].gen = 1;
+  freeSlots_.push_back(slot);
+}
+
+void TaskManager::_AcceptNewTasks() {
+  NEWTASK_T tmpNewTasks;
+  tmpNewTasks.swap(newTasks_);
+  newCnt_ = 0;
+  lock_.unlock();
+
+  for (auto& task : tmpNewTasks) {
+    if (!task)
+      continue;
+    if (!_AddTask(task)) {
+      spdlog::error("Why can not insert tcp socket {} , id = {}",
+                    task->getSocket(), task->getID());
+    } else {
+      spdlog::info("New connection from {}, id = {}",
+                   task->getPeerAddr().toString(), task->getID());
+      // 调用任务的连接成功回调
+      task->OnConnect();
+      // 加入之前可能已经收到了数据或已经出错，先处理一次
+      markReady(task.get());
     }
   }
+}
+
+bool TaskManager::DoMsgParse() {
+  if (newCnt_ > 0 && lock_.try_lock())
+    _AcceptNewTasks();  // 内部解锁
+
+  // 取下整条就绪链表，处理期间新就绪的连接留到下一轮
+  StreamSocket* sock = readyHead_;
+  readyHead_ = readyTail_ = nullptr;
+
   bool busy = false;  // 标记是否有任务在处理消息
-  for (auto it(tcpSockets_.begin()); it != tcpSockets_.end();) {
-    // 检查任务是否无效（智能指针为空或套接字无效）
-    if (it->second || it->second->invalid()) {
-      if (it->second) {
-        spdlog::info("Close connection from {}, id = {}",
-                     it->second->getPeerAddr().toString(), it->second->getID());
-        it->second->OnDisconnect();
-      }
-      _RemoveTask(it);  // 会it++
-    } else {
+  while (sock) {
+    StreamSocket* next = sock->readyNext_;
+    sock->readyNext_ = nullptr;
+    sock->ready_ = false;
+
+    // 检查套接字是否无效
+    if (sock->invalid()) {
+      spdlog::info("Close connection from {}, id = {}",
+                   sock->getPeerAddr().toString(), sock->getID());
+      sock->OnDisconnect();
+      _RemoveTask(sock);  // 可能释放 sock
+    } else if (sock->DoMsgParse()) {
       // 调用任务自身的消息解析方法
-      // 如果有任务在处理消息且当前busy为false，则标记为busy
-      if (it->second->DoMsgParse() && !busy) {
-        busy = true;
-      }
-      ++it;
+      busy = true;
     }
+    sock = next;
   }
   // 返回是否有任务在处理消息
   return busy;
 }
-}  // namespace Internal
\ No newline at end of file
+}  // namespace Internal
@@ -0,0 +1,287 @@
+#include <base/eventLoop.h>
+#include <base/poll/poller.h>
+#include <base/socket/streamSocket.h>
+#include <base/thread/sendThread.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <cerrno>
+#include <cstdint>
+
+namespace Internal {
+namespace {
+// 单个连接一轮最多 writev 的次数，防止大回复饿死其他连接
+const int kMaxWritevPerFlush = 4;
+}  // namespace
+
+SendThread::SendThread(Poller* poller)
+    : poller_(poller), completion_(poller && poller->completionBased()) {}
+
+void SendThread::addPending(const std::shared_ptr<StreamSocket>& sock) {
+  if (sock->sendPending_)
+    return;
+  sock->sendPending_ = true;
+  pending_.push_back(sock);
+}
+
+std::size_t SendThread::flush() {
+  if (pending_.empty())
+    return 0;
+
+  ++flushes_;
+  sending_.swap(pending_);
+
+  std::size_t total = 0;
+  for (const auto& sock : sending_) {
+    sock->sendPending_ = false;
+    if (sock->invalid())
+      continue;
+
+    if (completion_) {
+      if (!_Submit(sock.get()))
+        sock->OnError();
+      continue;
+    }
+
+    std::size_t sent = 0;
+    bool yielded = false;
+    bool ok = _Send(sock.get(), sent, yielded);
+    total += sent;
+    if (sent > 0)
+      ++sock->batch_.flushes;
+    if (!ok) {
+      sock->OnError();
+      continue;
+    }
+
+    if (yielded) {
+      // 套接字仍可写，不会再有可写事件（io_uring 的 multishot poll 与 EPOLLET
+      // 只在状态变化时通知），直接留到下一轮继续发
+      addPending(sock);
+      continue;
+    }
+
+    const bool remain = !sock->sendBuf_.isEmpty() || !sock->zcQueue_.empty();
+    if (!remain && sock->closeAfterReply_ && sock->zcInflight_.empty()) {
+      sock->OnError();
+      continue;
+    }
+    // 还有零拷贝的块在等完成通知时先不关闭：关闭后读不到通知，内存无法安全释放。
+    // 通知全部到达后 _CompleteZeroCopy 会重新登记到这里
+    if (remain != sock->epollOut_) {
+      // 发送不完整时等待可写事件后继续，发完后撤销
+      sock->epollOut_ = remain;
+      poller_->modSocket(sock->localSock_, sock->_PollEvents(),
+                         static_cast<Socket*>(sock.get()));
+    }
+  }
+  sending_.clear();
+  return total;
+}
+
+bool SendThread::_Send(StreamSocket* sock, std::size_t& sent,
+                       bool& yielded) {
+  for (int i = 0; i < kMaxWritevPerFlush; ++i) {
+    // 下一个零拷贝块之前的普通数据要先发出去；块已经发出一部分时
+    // bytesSent_ 越过了 start，必须先把块的剩余部分续发完
+    uint64_t limit = UINT64_MAX;
+    if (!sock->zcQueue_.empty()) {
+      const uint64_t start = sock->zcQueue_.front().start;
+      limit = sock->bytesSent_ >= start ? 0 : start - sock->bytesSent_;
+    }
+
+    if (limit > 0) {
+      BufferSequence bf;
+      sock->sendBuf_.processBuffer(bf);
+      _Truncate(bf, limit);
+      const std::size_t total = bf.totalBytes();
+      if (total == 0)
+        return true;
+
+      ++writevCalls_;
+      ++sock->batch_.writevCalls;
+      ssize_t ret = ::writev(sock->localSock_, bf.buffers,
+                             static_cast<int>(bf.count));
+      if (ret == SOCKET_ERROR) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+          return true;
+        spdlog::debug("writev error on socket {}: {}", sock->localSock_,
+                      strerror(errno));
+        return false;
+      }
+
+      sock->sendBuf_.skip(static_cast<std::size_t>(ret));
+      sock->bytesSent_ += static_cast<uint64_t>(ret);
+      sent += static_cast<std::size_t>(ret);
+      if (static_cast<std::size_t>(ret) < total)
+        return true;  // 内核发送缓冲区满
+      continue;
+    }
+
+    const StreamSocket::ZeroCopyChunk& chunk = sock->zcQueue_.front();
+    const std::size_t want = chunk.len - chunk.sent;
+    std::size_t n = 0;
+    if (!_SendZeroCopy(sock, n))
+      return false;
+    sent += n;
+    if (n < want)
+      return true;  // EAGAIN 或者只发出去一部分
+  }
+  yielded = !sock->sendBuf_.isEmpty() || !sock->zcQueue_.empty();
+  return true;
+}
+
+bool SendThread::_SendZeroCopy(StreamSocket* sock, std::size_t& sent) {
+  StreamSocket::ZeroCopyChunk& chunk = sock->zcQueue_.front();
+  const char* data = chunk.data + chunk.sent;
+  const std::size_t len = chunk.len - chunk.sent;
+
+  int flags = MSG_NOSIGNAL;
+#if defined(MSG_ZEROCOPY)
+  flags |= MSG_ZEROCOPY;
+#endif
+
+  ++writevCalls_;
+  ++sock->batch_.writevCalls;
+  ssize_t ret = ::send(sock->localSock_, data, len, flags);
+#if defined(MSG_ZEROCOPY)
+  if (ret == SOCKET_ERROR && errno == ENOBUFS) {
+    // 超过 optmem 限制，无法再挂完成通知，本次退化为普通发送
+    if (sock->loop_)
+      ++sock->loop_->stats().zeroCopyFallbacks;
+    flags &= ~MSG_ZEROCOPY;
+    ret = ::send(sock->localSock_, data, len, flags);
+  }
+#endif
+  if (ret == SOCKET_ERROR) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+      return true;
+    spdlog::debug("send error on socket {}: {}", sock->localSock_,
+                  strerror(errno));
+    return false;
+  }
+
+#if defined(MSG_ZEROCOPY)
+  if (flags & MSG_ZEROCOPY) {
+    // 每次成功的 MSG_ZEROCOPY 调用占用一个通知序号
+    chunk.lastSeq = sock->zcNextSeq_++;
+    chunk.hasSeq = true;
+    if (sock->loop_) {
+      ++sock->loop_->stats().zeroCopySends;
+      sock->loop_->stats().zeroCopyBytes += static_cast<uint64_t>(ret);
+    }
+  }
+#endif
+
+  chunk.sent += static_cast<std::size_t>(ret);
+  sock->bytesSent_ += static_cast<uint64_t>(ret);
+  sent = static_cast<std::size_t>(ret);
+
+  if (chunk.sent == chunk.len) {
+    // 内核还引用着这块内存，等完成通知再释放
+    if (chunk.hasSeq)
+      sock->zcInflight_.push_back(chunk);
+    sock->zcQueue_.pop_front();
+  }
+  return true;
+}
+
+// 与 _Send 的顺序规则相同：零拷贝块之前的普通数据先发，
+// 块发出一部分后先续发块的剩余部分
+bool SendThread::_Submit(StreamSocket* sock) {
+  if (sock->sendInflight_)
+    return true;  // complete() 时会重新登记
+
+  uint64_t limit = UINT64_MAX;
+  if (!sock->zcQueue_.empty()) {
+    const uint64_t start = sock->zcQueue_.front().start;
+    limit = sock->bytesSent_ >= start ? 0 : start - sock->bytesSent_;
+  }
+
+  BufferSequence bf;
+  bf.count = 0;
+  if (limit > 0) {
+    // 数据留在 sendBuf_ 里直到 skip，期间新写入的回复不会覆盖它；
+    // owner 保证连接关闭后缓冲区也活到内核完成为止
+    sock->sendBuf_.processBuffer(bf);
+    _Truncate(bf, limit);
+  }
+  bool ok;
+  if (bf.totalBytes() > 0) {
+    sock->sendInflightChunk_ = false;
+    ok = poller_->submitSend(sock->localSock_, bf, sock->shared_from_this(),
+                             false, static_cast<Socket*>(sock));
+  } else if (!sock->zcQueue_.empty()) {
+    const StreamSocket::ZeroCopyChunk& chunk = sock->zcQueue_.front();
+    bf.count = 1;
+    bf.buffers[0].iov_base = const_cast<char*>(chunk.data + chunk.sent);
+    bf.buffers[0].iov_len = chunk.len - chunk.sent;
+    sock->sendInflightChunk_ = true;
+    ok = poller_->submitSend(sock->localSock_, bf, chunk.owner, true,
+                             static_cast<Socket*>(sock));
+  } else {
+    // 回复都发完了
+    return !sock->closeAfterReply_;
+  }
+
+  if (!ok)
+    return false;
+  sock->sendInflight_ = true;
+  ++writevCalls_;
+  ++sock->batch_.writevCalls;
+  return true;
+}
+
+std::size_t SendThread::complete(StreamSocket* sock, int result) {
+  sock->sendInflight_ = false;
+  if (sock->invalid())
+    return 0;
+
+  auto self = std::static_pointer_cast<StreamSocket>(sock->shared_from_this());
+  if (result < 0) {
+    if (result == -EAGAIN || result == -EINTR) {
+      addPending(self);
+      return 0;
+    }
+    spdlog::debug("send error on socket {}: {}", sock->localSock_,
+                  strerror(-result));
+    sock->OnError();
+    return 0;
+  }
+
+  const std::size_t n = static_cast<std::size_t>(result);
+  if (sock->sendInflightChunk_) {
+    // 块的内存由在途请求持有到内核的通知为止，这里可以直接出队
+    StreamSocket::ZeroCopyChunk& chunk = sock->zcQueue_.front();
+    chunk.sent += n;
+    if (sock->loop_) {
+      ++sock->loop_->stats().zeroCopySends;
+      sock->loop_->stats().zeroCopyBytes += n;
+    }
+    if (chunk.sent == chunk.len)
+      sock->zcQueue_.pop_front();
+  } else {
+    sock->sendBuf_.skip(n);
+  }
+  sock->bytesSent_ += n;
+  if (n > 0)
+    ++sock->batch_.flushes;
+
+  if (!sock->sendBuf_.isEmpty() || !sock->zcQueue_.empty() ||
+      sock->closeAfterReply_)
+    addPending(self);
+  return n;
+}
+
+void SendThread::_Truncate(BufferSequence& bf, uint64_t limit) {
+  uint64_t total = 0;
+  for (std::size_t i = 0; i < bf.count; ++i) {
+    if (total + bf.buffers[i].iov_len >= limit) {
+      bf.buffers[i].iov_len = static_cast<std::size_t>(limit - total);
+      bf.count = i + 1;
+      return;
+    }
+    total += bf.buffers[i].iov_len;
+  }
+}
+}  // namespace Internal
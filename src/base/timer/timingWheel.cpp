@@ -0,0 +1,264 @@
+#include <base/timer/timingWheel.h>
+#include <algorithm>
+#include <utility>
+
+namespace Internal {
+namespace {
+inline int lowestBit(uint64_t word) {
+  return __builtin_ctzll(word);
+}
+}  // namespace
+
+const TimingWheel::TimerId TimingWheel::kInvalidTimer;
+const uint32_t TimingWheel::kNil;
+
+TimingWheel::TimingWheel(uint64_t nowMs)
+    : now_(nowMs + 1), count_(0), running_(kNil) {
+  // now_ 是下一个待处理的时刻，nowMs 及之前的时刻视为已处理
+  for (int l = 0; l < kLevels; ++l) {
+    levels_[l].heads.assign(_SlotCount(l), kNil);
+    levels_[l].bitmap.assign((_SlotCount(l) + 63) / 64, 0);
+  }
+}
+
+TimingWheel::TimerId TimingWheel::schedule(uint64_t delayMs, Callback cb,
+                                           uint64_t intervalMs) {
+  uint32_t idx = _Alloc();
+  Node& node = nodes_[idx];
+  node.expire = now_ - 1 + delayMs;  // delay 为 0 时在下一次 advance 触发
+  node.interval = intervalMs;
+  node.cb = std::move(cb);
+  _Insert(idx);
+  ++count_;
+  return (static_cast<TimerId>(node.gen) << 32) | (idx + 1);
+}
+
+bool TimingWheel::cancel(TimerId id) {
+  if (id == kInvalidTimer)
+    return false;
+
+  uint32_t idx = static_cast<uint32_t>(id & 0xffffffffU) - 1;
+  uint32_t gen = static_cast<uint32_t>(id >> 32);
+  if (idx >= nodes_.size() || nodes_[idx].gen != gen || nodes_[idx].level < 0)
+    return false;
+
+  _Unlink(idx);
+  _Free(idx);
+  --count_;
+  return true;
+}
+
+std::size_t TimingWheel::advance(uint64_t nowMs) {
+  std::size_t fired = 0;
+  while (now_ <= nowMs) {
+    if (count_ == 0) {
+      now_ = nowMs + 1;
+      break;
+    }
+
+    int index = static_cast<int>(now_ & (_SlotCount(0) - 1));
+    if (index != 0) {
+      // 跳过第 0 层本圈内的空槽，空闲时推进很长一段时间也只需几次位运算
+      int d = _NextSlot(0, index);
+      uint64_t jump = (d < 0 || index + d >= _SlotCount(0))
+                          ? static_cast<uint64_t>(_SlotCount(0) - index)
+                          : static_cast<uint64_t>(d);
+      if (jump > 0) {
+        now_ += std::min(jump, nowMs + 1 - now_);
+        continue;
+      }
+    } else {
+      // 第 0 层转完一圈，把上一层对应的槽降下来，逐层进位
+      for (int l = 1; l < kLevels; ++l) {
+        _Cascade(l);
+        if (((now_ >> _Shift(l)) & (_SlotCount(l) - 1)) != 0)
+          break;
+      }
+    }
+
+    ++now_;
+    fired += _RunSlot(index);
+  }
+  return fired;
+}
+
+int TimingWheel::nextTimeoutMs(uint64_t nowMs, int maxMs) const {
+  if (count_ == 0)
+    return maxMs;
+
+  uint64_t nearest = UINT64_MAX;
+  for (int l = 0; l < kLevels; ++l) {
+    // 第 l 层的槽在 now_ 之后第一个对齐到本层粒度的时刻开始依次被处理
+    const uint64_t unit = 1ULL << _Shift(l);
+    const uint64_t base = (now_ + unit - 1) & ~(unit - 1);
+    const int cur = static_cast<int>((base >> _Shift(l)) & (_SlotCount(l) - 1));
+    int d = _NextSlot(l, cur);
+    if (d >= 0)
+      nearest = std::min(nearest, base + static_cast<uint64_t>(d) * unit);
+  }
+
+  if (nearest <= nowMs)
+    return 0;
+  uint64_t wait = nearest - nowMs;
+  return wait < static_cast<uint64_t>(maxMs) ? static_cast<int>(wait) : maxMs;
+}
+
+uint32_t TimingWheel::_Alloc() {
+  if (!freeList_.empty()) {
+    uint32_t idx = freeList_.back();
+    freeList_.pop_back();
+    return idx;
+  }
+
+  nodes_.emplace_back();
+  Node& node = nodes_.back();
+  node.prev = node.next = kNil;
+  node.gen = 1;
+  node.level = -1;
+  node.slot = 0;
+  return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void TimingWheel::_Free(uint32_t idx) {
+  Node& node = nodes_[idx];
+  node.cb = nullptr;
+  node.level = -1;
+  if (++node.gen == 0)  // TimerId 不能为 0
+    node.gen = 1;
+  freeList_.push_back(idx);
+}
+
+void TimingWheel::_Insert(uint32_t idx) {
+  const uint64_t expire = nodes_[idx].expire;
+  if (expire < now_) {
+    // 已经过期（或在回调里以 0 延迟添加），放到下一个要处理的槽
+    _Link(idx, 0, static_cast<int>(now_ & (_SlotCount(0) - 1)));
+    return;
+  }
+
+  const uint64_t delta = expire - now_;
+  for (int l = 0; l < kLevels; ++l) {
+    const int bits = _Shift(l) + (l == 0 ? kRootBits : kLevelBits);
+    if (delta < (1ULL << bits)) {
+      _Link(idx, l,
+            static_cast<int>((expire >> _Shift(l)) & (_SlotCount(l) - 1)));
+      return;
+    }
+  }
+
+  // 超出时间轮范围，先挂在最高层最远的槽，降层时会按真实时刻重新放置
+  const int top = kLevels - 1;
+  const uint64_t farthest =
+      now_ + (1ULL << (_Shift(top) + kLevelBits)) - 1;
+  _Link(idx, top,
+        static_cast<int>((farthest >> _Shift(top)) & (_SlotCount(top) - 1)));
+}
+
+void TimingWheel::_Link(uint32_t idx, int level, int slot) {
+  Level& lv = levels_[level];
+  Node& node = nodes_[idx];
+  node.level = static_cast<int16_t>(level);
+  node.slot = static_cast<uint16_t>(slot);
+  node.prev = kNil;
+  node.next = lv.heads[slot];
+  if (node.next != kNil)
+    nodes_[node.next].prev = idx;
+  lv.heads[slot] = idx;
+  lv.bitmap[slot >> 6] |= 1ULL << (slot & 63);
+}
+
+void TimingWheel::_Unlink(uint32_t idx) {
+  Node& node = nodes_[idx];
+  if (node.next != kNil)
+    nodes_[node.next].prev = node.prev;
+
+  if (node.prev != kNil) {
+    nodes_[node.prev].next = node.next;
+  } else if (node.level == kLevels) {
+    running_ = node.next;  // 在正在执行的链表里
+  } else {
+    Level& lv = levels_[node.level];
+    lv.heads[node.slot] = node.next;
+    if (node.next == kNil)
+      lv.bitmap[node.slot >> 6] &= ~(1ULL << (node.slot & 63));
+  }
+  node.prev = node.next = kNil;
+  node.level = -1;
+}
+
+void TimingWheel::_Cascade(int level) {
+  // 调用时 now_ 恰好对齐到本层粒度，取出当前槽重新放置，它们会落到更低的层
+  Level& lv = levels_[level];
+  const int slot =
+      static_cast<int>((now_ >> _Shift(level)) & (_SlotCount(level) - 1));
+  uint32_t idx = lv.heads[slot];
+  lv.heads[slot] = kNil;
+  lv.bitmap[slot >> 6] &= ~(1ULL << (slot & 63));
+
+  while (idx != kNil) {
+    uint32_t next = nodes_[idx].next;
+    _Insert(idx);
+    idx = next;
+  }
+}
+
+std::size_t TimingWheel::_RunSlot(int slot) {
+  Level& root = levels_[0];
+  running_ = root.heads[slot];
+  root.heads[slot] = kNil;
+  root.bitmap[slot >> 6] &= ~(1ULL << (slot & 63));
+  for (uint32_t idx = running_; idx != kNil; idx = nodes_[idx].next)
+    nodes_[idx].level = kLevels;  // 回调里可能取消同一批的其他定时器
+
+  std::size_t fired = 0;
+  while (running_ != kNil) {
+    const uint32_t idx = running_;
+    _Unlink(idx);
+
+    Node& node = nodes_[idx];
+    if (node.expire >= now_) {
+      // 超出范围的定时器降层后可能还没有到期
+      _Insert(idx);
+      continue;
+    }
+
+    // 回调可能添加定时器导致 nodes_ 扩容，先把回调移出来
+    Callback cb = std::move(node.cb);
+    const uint32_t gen = node.gen;
+    if (node.interval > 0) {
+      node.expire = now_ - 1 + node.interval;
+      _Insert(idx);
+    } else {
+      _Free(idx);
+      --count_;
+    }
+
+    ++fired;
+    cb();
+
+    // 周期定时器在回调里没有被取消，把回调放回去
+    if (nodes_[idx].gen == gen && nodes_[idx].level >= 0)
+      nodes_[idx].cb = std::move(cb);
+  }
+  return fired;
+}
+
+int TimingWheel::_NextSlot(int level, int from) const {
+  // 从 from 开始（含）循环查找第一个非空槽，返回距离，没有则返回 -1
+  const Level& lv = levels_[level];
+  const int slots = _SlotCount(level);
+  const int words = static_cast<int>(lv.bitmap.size());
+
+  int w = from >> 6;
+  uint64_t word = lv.bitmap[w] & (~0ULL << (from & 63));
+  for (int i = 0; i <= words; ++i) {
+    if (word) {
+      int slot = (w << 6) + lowestBit(word);
+      return (slot - from + slots) & (slots - 1);
+    }
+    w = (w + 1) % words;
+    word = lv.bitmap[w];
+  }
+  return -1;
+}
+}  // namespace Internal
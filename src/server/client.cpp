@@ -0,0 +1,129 @@
+#include <base/eventLoop.h>
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <spdlog/spdlog.h>
+#include <string>
+
+namespace tinyredis {
+Client::~Client() {
+  // 其他线程的 XADD 可能正在遍历等待队列，先从中移除
+  if (blockActive_)
+    cancelWait();
+}
+
+void Client::block(uint64_t timeoutMs) {
+  blocked_ = true;
+  // 挂起期间不再接收：后续请求留在对端和内核里，不占接收缓冲区
+  pauseRead();
+  if (blockActive_)
+    return;  // 被唤醒后没有读到条目，再次挂起，超时仍从第一次阻塞算起
+  blockActive_ = true;
+  ++blockGen_;
+  self_ = std::static_pointer_cast<Client>(shared_from_this());
+  if (timeoutMs > 0) {
+    std::weak_ptr<Client> weak = self_;
+    blockTimer_ = getLoop()->timers().schedule(timeoutMs, [weak]() {
+      if (auto c = weak.lock())
+        c->_OnBlockTimeout();
+    });
+  }
+}
+
+bool Client::_OnWake() {
+  if (invalid())
+    return false;
+  // 可能在其他循环的线程上：只投递任务，连接的状态只在自己的循环上修改
+  std::weak_ptr<Client> weak = self_;
+  const uint64_t gen = blockGen_;
+  getLoop()->post([weak, gen]() {
+    auto c = weak.lock();
+    if (c && c->blockGen_ == gen)
+      c->_Resume();
+  });
+  return true;
+}
+
+void Client::_OnBlockTimeout() {
+  blockTimer_ = 0;
+  cancelWait();
+  blockTimedOut_ = true;
+  _Resume();
+}
+
+void Client::_Resume() {
+  if (!blocked_ || invalid())
+    return;
+  blocked_ = false;
+  resumeRead();
+  getLoop()->taskManager().markReady(this);
+}
+
+void Client::_EndBlock() {
+  if (blockTimer_ != 0) {
+    getLoop()->timers().cancel(blockTimer_);
+    blockTimer_ = 0;
+  }
+  blockActive_ = false;
+  blockTimedOut_ = false;
+  self_.reset();
+}
+
+packetLength Client::_HandlePacket(const char* msg, std::size_t len) {
+  if (blocked_)
+    return 0;
+
+  std::size_t consumed = 0;
+  switch (parser_.parse(msg, len, consumed)) {
+    case RespParser::Result::kIncomplete:
+      return 0;
+
+    case RespParser::Result::kError:
+      // 与 Redis 一致：回复错误后关闭连接，丢弃剩余输入
+      spdlog::debug("{} from {}", parser_.error(), peerAddr_.toString());
+      reply_.error(parser_.error().data(), parser_.error().size());
+      closeAfterReply();
+      parser_.reset();
+      return static_cast<packetLength>(len);
+
+    case RespParser::Result::kOk:
+      if (!parser_.args().empty())
+        _Execute(parser_.args());
+      parser_.reset();
+      // 挂起的请求留在缓冲区，恢复后从头重新解析执行
+      if (blocked_)
+        return 0;
+      if (blockActive_)
+        _EndBlock();
+      return static_cast<packetLength>(consumed);
+  }
+  return 0;
+}
+
+void Client::_Execute(const std::vector<Slice>& args) {
+  const Command* cmd = lookupCommand(args[0]);
+  if (!cmd) {
+    std::string msg = "ERR unknown command '" + args[0].toString() + "'";
+    reply_.error(msg.data(), msg.size());
+    return;
+  }
+
+  const long long argc = static_cast<long long>(args.size());
+  if ((cmd->arity > 0 && argc != cmd->arity) ||
+      (cmd->arity < 0 && argc < -cmd->arity)) {
+    std::string msg = std::string("ERR wrong number of arguments for '") +
+                      cmd->name + "' command";
+    reply_.error(msg.data(), msg.size());
+    return;
+  }
+
+  const Database::ShardMask shards = commandShards(*cmd, args);
+  if (shards != 0) {
+    // 键空间由所有事件循环共享，只锁住涉及的分片
+    Database::Guard guard(*db_, shards);
+    cmd->proc(*this, args);
+  } else {
+    cmd->proc(*this, args);
+  }
+}
+}  // namespace tinyredis
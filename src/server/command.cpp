@@ -0,0 +1,177 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <server/protocol/respShared.h>
+#include <server/util/numbers.h>
+#include <strings.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+
+namespace tinyredis {
+namespace {
+const Command kCommands[] = {
+    {"ping", -1, pingCommand, 0, 0, 0, nullptr},
+    {"echo", 2, echoCommand, 0, 0, 0, nullptr},
+    {"hello", -1, helloCommand, 0, 0, 0, nullptr},
+    {"client", -2, clientCommand, 0, 0, 0, nullptr},
+    {"del", -2, delCommand, 1, -1, 1, nullptr},
+    {"exists", -2, existsCommand, 1, -1, 1, nullptr},
+    {"dbsize", 1, dbsizeCommand, kAllKeys, 0, 0, nullptr},
+    {"flushdb", -1, flushdbCommand, kAllKeys, 0, 0, nullptr},
+    {"scan", -2, scanCommand, kAllKeys, 0, 0, nullptr},
+    {"type", 2, typeCommand, 1, 1, 1, nullptr},
+    {"object", -2, objectCommand, 2, 2, 1, nullptr},
+    {"memory", -2, memoryCommand, 0, 0, 0, memoryKeys},
+    {"config", -2, configCommand, kAllKeys, 0, 0, nullptr},
+    {"get", 2, getCommand, 1, 1, 1, nullptr},
+    {"set", 3, setCommand, 1, 1, 1, nullptr},
+    {"append", 3, appendCommand, 1, 1, 1, nullptr},
+    {"strlen", 2, strlenCommand, 1, 1, 1, nullptr},
+    {"getrange", 4, getrangeCommand, 1, 1, 1, nullptr},
+    {"setrange", 4, setrangeCommand, 1, 1, 1, nullptr},
+    {"incr", 2, incrCommand, 1, 1, 1, nullptr},
+    {"decr", 2, decrCommand, 1, 1, 1, nullptr},
+    {"incrby", 3, incrbyCommand, 1, 1, 1, nullptr},
+    {"decrby", 3, decrbyCommand, 1, 1, 1, nullptr},
+    {"hset", -4, hsetCommand, 1, 1, 1, nullptr},
+    {"hget", 3, hgetCommand, 1, 1, 1, nullptr},
+    {"hmget", -3, hmgetCommand, 1, 1, 1, nullptr},
+    {"hdel", -3, hdelCommand, 1, 1, 1, nullptr},
+    {"hlen", 2, hlenCommand, 1, 1, 1, nullptr},
+    {"hexists", 3, hexistsCommand, 1, 1, 1, nullptr},
+    {"hgetall", 2, hgetallCommand, 1, 1, 1, nullptr},
+    {"lpush", -3, lpushCommand, 1, 1, 1, nullptr},
+    {"rpush", -3, rpushCommand, 1, 1, 1, nullptr},
+    {"lpop", 2, lpopCommand, 1, 1, 1, nullptr},
+    {"rpop", 2, rpopCommand, 1, 1, 1, nullptr},
+    {"llen", 2, llenCommand, 1, 1, 1, nullptr},
+    {"lrange", 4, lrangeCommand, 1, 1, 1, nullptr},
+    {"lindex", 3, lindexCommand, 1, 1, 1, nullptr},
+    {"sadd", -3, saddCommand, 1, 1, 1, nullptr},
+    {"srem", -3, sremCommand, 1, 1, 1, nullptr},
+    {"sismember", 3, sismemberCommand, 1, 1, 1, nullptr},
+    {"scard", 2, scardCommand, 1, 1, 1, nullptr},
+    {"smembers", 2, smembersCommand, 1, 1, 1, nullptr},
+    {"sinter", -2, sinterCommand, 1, -1, 1, nullptr},
+    {"sintercard", -3, sintercardCommand, 0, 0, 0, sintercardKeys},
+    {"zadd", -4, zaddCommand, 1, 1, 1, nullptr},
+    {"zrem", -3, zremCommand, 1, 1, 1, nullptr},
+    {"zscore", 3, zscoreCommand, 1, 1, 1, nullptr},
+    {"zcard", 2, zcardCommand, 1, 1, 1, nullptr},
+    {"zrank", 3, zrankCommand, 1, 1, 1, nullptr},
+    {"zrange", -4, zrangeCommand, 1, 1, 1, nullptr},
+    {"zrangebyscore", -4, zrangebyscoreCommand, 1, 1, 1, nullptr},
+    {"zcount", 4, zcountCommand, 1, 1, 1, nullptr},
+    {"setbit", 4, setbitCommand, 1, 1, 1, nullptr},
+    {"getbit", 3, getbitCommand, 1, 1, 1, nullptr},
+    {"bitcount", -2, bitcountCommand, 1, 1, 1, nullptr},
+    {"bitpos", -3, bitposCommand, 1, 1, 1, nullptr},
+    {"bitop", -4, bitopCommand, 2, -1, 1, nullptr},
+    {"bitfield", -2, bitfieldCommand, 1, 1, 1, nullptr},
+    {"pfadd", -2, pfaddCommand, 1, 1, 1, nullptr},
+    {"pfcount", -2, pfcountCommand, 1, -1, 1, nullptr},
+    {"pfmerge", -2, pfmergeCommand, 1, -1, 1, nullptr},
+    {"xadd", -5, xaddCommand, 1, 1, 1, nullptr},
+    {"xrange", -4, xrangeCommand, 1, 1, 1, nullptr},
+    {"xrevrange", -4, xrevrangeCommand, 1, 1, 1, nullptr},
+    {"xlen", 2, xlenCommand, 1, 1, 1, nullptr},
+    {"xtrim", -4, xtrimCommand, 1, 1, 1, nullptr},
+    {"xgroup", -2, xgroupCommand, 2, 2, 1, nullptr},
+    {"xreadgroup", -7, xreadgroupCommand, 0, 0, 0, xreadgroupKeys},
+    {"xack", -4, xackCommand, 1, 1, 1, nullptr},
+    {"xpending", -3, xpendingCommand, 1, 1, 1, nullptr},
+    {"xclaim", -6, xclaimCommand, 1, 1, 1, nullptr},
+    {"xautoclaim", -6, xautoclaimCommand, 1, 1, 1, nullptr},
+};
+
+const std::size_t kMaxNameLen = 32;
+
+// 命令名与 name 按字节序比较
+int compareName(const Command* cmd, const Slice& name) {
+  const std::size_t len = std::strlen(cmd->name);
+  const int c = std::memcmp(cmd->name, name.data, std::min(len, name.len));
+  if (c != 0)
+    return c;
+  return len < name.len ? -1 : (len > name.len ? 1 : 0);
+}
+
+// 按名字排好序的命令表，第一次使用时建立，之后只读：
+// 多个事件循环线程并发二分查找，查找不修改任何状态
+const std::vector<const Command*>& commandTable() {
+  static const std::vector<const Command*> table = [] {
+    std::vector<const Command*> t;
+    for (const Command& cmd : kCommands)
+      t.push_back(&cmd);
+    std::sort(t.begin(), t.end(), [](const Command* a, const Command* b) {
+      return std::strcmp(a->name, b->name) < 0;
+    });
+    return t;
+  }();
+  return table;
+}
+}  // namespace
+
+Database::ShardMask commandShards(const Command& cmd,
+                                  const std::vector<Slice>& args) {
+  if (cmd.keys)
+    return cmd.keys(args);
+  if (cmd.firstKey == kAllKeys)
+    return Database::kAllShards;
+  if (cmd.firstKey == 0)
+    return 0;
+
+  const int argc = static_cast<int>(args.size());
+  const int last = cmd.lastKey < 0 ? argc + cmd.lastKey : cmd.lastKey;
+  Database::ShardMask shards = 0;
+  for (int i = cmd.firstKey; i <= last && i < argc; i += cmd.keyStep)
+    shards |= Database::shardBit(args[i]);
+  return shards;
+}
+
+const Command* lookupCommand(const Slice& name) {
+  if (name.len == 0 || name.len > kMaxNameLen)
+    return nullptr;
+  char lower[kMaxNameLen];
+  for (std::size_t i = 0; i < name.len; ++i)
+    lower[i] = static_cast<char>(
+        std::tolower(static_cast<unsigned char>(name.data[i])));
+
+  const Slice key{lower, name.len};
+  const std::vector<const Command*>& table = commandTable();
+  auto it = std::lower_bound(table.begin(), table.end(), key,
+                             [](const Command* cmd, const Slice& k) {
+                               return compareName(cmd, k) < 0;
+                             });
+  return it != table.end() && compareName(*it, key) == 0 ? *it : nullptr;
+}
+
+bool argIs(const Slice& arg, const char* word) {
+  return std::strlen(word) == arg.len &&
+         ::strncasecmp(arg.data, word, arg.len) == 0;
+}
+
+bool lookupTyped(Client& client, const Slice& key, Object::Type type,
+                 Object** out) {
+  *out = client.db().keys(key).find(key);
+  if (*out && (*out)->type() != type) {
+    client.reply().raw(shared::kWrongType);
+    return false;
+  }
+  return true;
+}
+
+bool parseInteger(Client& client, const Slice& arg, long long* out) {
+  if (!parseLongLong(arg.data, arg.len, out)) {
+    client.reply().error("ERR value is not an integer or out of range");
+    return false;
+  }
+  return true;
+}
+
+void removeIfEmpty(Client& client, const Slice& key, std::size_t size) {
+  if (size == 0)
+    client.db().keys(key).erase(key);
+}
+}  // namespace tinyredis
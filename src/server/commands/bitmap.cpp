@@ -0,0 +1,558 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <server/protocol/respShared.h>
+#include <server/util/bitops.h>
+#include <server/util/numbers.h>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace tinyredis {
+namespace {
+// 位的编号与 Redis 相同：第 0 位是第 0 个字节的最高位
+int bitAt(const unsigned char* p, std::size_t len, uint64_t offset) {
+  const uint64_t byte = offset >> 3;
+  if (byte >= len)
+    return 0;
+  return (p[byte] >> (7 - (offset & 7))) & 1;
+}
+
+void setBitAt(unsigned char* p, uint64_t offset, int value) {
+  const unsigned char mask =
+      static_cast<unsigned char>(1u << (7 - (offset & 7)));
+  if (value)
+    p[offset >> 3] |= mask;
+  else
+    p[offset >> 3] &= static_cast<unsigned char>(~mask);
+}
+
+// 位偏移不超过字符串上限（512MB）对应的位数；hash 为 true 时接受 BITFIELD 的
+// "#N" 形式，表示第 N 个 bits 位宽的字段
+bool parseBitOffset(Client& client, const Slice& arg, bool hash, int bits,
+                    uint64_t* out) {
+  const bool useHash = hash && arg.len > 0 && arg.data[0] == '#';
+  const std::size_t skip = useHash ? 1 : 0;
+  long long v;
+  bool ok = parseLongLong(arg.data + skip, arg.len - skip, &v) && v >= 0;
+  if (ok && useHash) {
+    ok = v <= LLONG_MAX / bits;
+    v *= bits;
+  }
+  if (!ok || static_cast<unsigned long long>(v >> 3) >= Object::kMaxStringLen) {
+    client.reply().error("ERR bit offset is not an integer or out of range");
+    return false;
+  }
+  *out = static_cast<uint64_t>(v);
+  return true;
+}
+
+// 写操作取位图：键不存在时创建，长度不足 maxBit 所在的字节时以 0 补齐
+unsigned char* bitmapForWrite(Client& client, const Slice& key,
+                              uint64_t maxBit) {
+  Object* o;
+  if (!lookupTyped(client, key, Object::Type::kString, &o))
+    return nullptr;
+  if (!o)
+    o = client.db().keys(key).insert(key.toString()).first;
+  return reinterpret_cast<unsigned char*>(
+      o->mutableString(static_cast<std::size_t>(maxBit >> 3) + 1));
+}
+
+// BITCOUNT/BITPOS 的区间：负数从末尾算起，越界的部分截掉；区间为空时返回 false
+bool clampRange(long long total, long long* start, long long* end) {
+  if (*start < 0 && *end < 0 && *start > *end)
+    return false;
+  if (*start < 0)
+    *start += total;
+  if (*end < 0)
+    *end += total;
+  if (*start < 0)
+    *start = 0;
+  if (*end < 0)
+    *end = 0;
+  if (*end >= total)
+    *end = total - 1;
+  return total > 0 && *start <= *end;
+}
+
+// 区间的单位：BYTE（默认）或 BIT
+bool parseRangeUnit(Client& client, const Slice& arg, bool* isBit) {
+  if (argIs(arg, "bit")) {
+    *isBit = true;
+  } else if (argIs(arg, "byte")) {
+    *isBit = false;
+  } else {
+    client.reply().raw(shared::kSyntaxErr);
+    return false;
+  }
+  return true;
+}
+
+enum class Overflow {
+  kWrap,
+  kSat,
+  kFail,
+};
+
+struct BitfieldOp {
+  enum Kind { kGet, kSet, kIncrBy } kind;
+  uint64_t offset;
+  int64_t value;
+  int bits;
+  bool sign;
+  Overflow overflow;
+};
+
+uint64_t getUnsigned(const unsigned char* p, std::size_t len, uint64_t offset,
+                     int bits) {
+  uint64_t v = 0;
+  for (int i = 0; i < bits; ++i)
+    v = (v << 1) | static_cast<uint64_t>(bitAt(p, len, offset + i));
+  return v;
+}
+
+int64_t getSigned(const unsigned char* p, std::size_t len, uint64_t offset,
+                  int bits) {
+  uint64_t v = getUnsigned(p, len, offset, bits);
+  // 符号扩展
+  if (bits < 64 && (v & (1ULL << (bits - 1))))
+    v |= ~0ULL << bits;
+  return static_cast<int64_t>(v);
+}
+
+void setField(unsigned char* p, uint64_t offset, int bits, uint64_t v) {
+  for (int i = 0; i < bits; ++i)
+    setBitAt(p, offset + i, static_cast<int>((v >> (bits - 1 - i)) & 1));
+}
+
+// 以下两个溢出检查与 Redis 相同：value + incr 超出位宽时返回 1（上溢）或 -1（下溢），
+// 并按 WRAP/SAT 把结果写入 *limit
+int checkUnsignedOverflow(uint64_t value, int64_t incr, int bits,
+                          Overflow overflow, uint64_t* limit) {
+  const uint64_t max = bits == 64 ? UINT64_MAX : (1ULL << bits) - 1;
+  const int64_t maxIncr = static_cast<int64_t>(max - value);
+  const int64_t minIncr = static_cast<int64_t>(0 - value);
+  int result = 0;
+  if (value > max || (incr > 0 && incr > maxIncr)) {
+    result = 1;
+    *limit = max;
+  } else if (incr < 0 && incr < minIncr) {
+    result = -1;
+    *limit = 0;
+  }
+  if (result != 0 && overflow == Overflow::kWrap) {
+    const uint64_t sum = value + static_cast<uint64_t>(incr);
+    *limit = bits == 64 ? sum : sum & ~(~0ULL << bits);
+  }
+  return result;
+}
+
+int checkSignedOverflow(int64_t value, int64_t incr, int bits,
+                        Overflow overflow, int64_t* limit) {
+  const int64_t max = bits == 64 ? INT64_MAX : (1LL << (bits - 1)) - 1;
+  const int64_t min = -max - 1;
+  // 可能溢出，但只在 value 在范围内时才使用，按无符号计算避免未定义行为
+  const int64_t maxIncr = static_cast<int64_t>(static_cast<uint64_t>(max) -
+                                               static_cast<uint64_t>(value));
+  const int64_t minIncr = static_cast<int64_t>(static_cast<uint64_t>(min) -
+                                               static_cast<uint64_t>(value));
+  int result = 0;
+  if (value > max || (bits != 64 && incr > maxIncr) ||
+      (value >= 0 && incr > 0 && incr > maxIncr)) {
+    result = 1;
+    *limit = max;
+  } else if (value < min || (bits != 64 && incr < minIncr) ||
+             (value < 0 && incr < 0 && incr < minIncr)) {
+    result = -1;
+    *limit = min;
+  }
+  if (result != 0 && overflow == Overflow::kWrap) {
+    uint64_t sum = static_cast<uint64_t>(value) + static_cast<uint64_t>(incr);
+    // 按位宽截断，符号位扩展到高位
+    if (bits < 64) {
+      const uint64_t mask = ~0ULL << bits;
+      if (sum & (1ULL << (bits - 1)))
+        sum |= mask;
+      else
+        sum &= ~mask;
+    }
+    *limit = static_cast<int64_t>(sum);
+  }
+  return result;
+}
+
+// i1..i64 或 u1..u63
+bool parseBitfieldType(Client& client, const Slice& arg, bool* sign,
+                       int* bits) {
+  long long n = 0;
+  bool ok = arg.len >= 2 && (arg.data[0] == 'i' || arg.data[0] == 'I' ||
+                             arg.data[0] == 'u' || arg.data[0] == 'U');
+  if (ok) {
+    *sign = arg.data[0] == 'i' || arg.data[0] == 'I';
+    ok = parseLongLong(arg.data + 1, arg.len - 1, &n) && n >= 1 &&
+         n <= (*sign ? 64 : 63);
+  }
+  if (!ok) {
+    client.reply().error(
+        "ERR Invalid bitfield type. Use something like i16 u8. Note that u64 "
+        "is not supported but i64 is.");
+    return false;
+  }
+  *bits = static_cast<int>(n);
+  return true;
+}
+}  // namespace
+
+// SETBIT key offset value，返回原来的位
+void setbitCommand(Client& client, const std::vector<Slice>& args) {
+  uint64_t offset;
+  if (!parseBitOffset(client, args[2], false, 0, &offset))
+    return;
+  if (args[3].len != 1 || (args[3].data[0] != '0' && args[3].data[0] != '1')) {
+    client.reply().error("ERR bit is not an integer or out of range");
+    return;
+  }
+  unsigned char* p = bitmapForWrite(client, args[1], offset);
+  if (!p)
+    return;
+  const int old = bitAt(p, static_cast<std::size_t>(offset >> 3) + 1, offset);
+  setBitAt(p, offset, args[3].data[0] - '0');
+  client.reply().integer(old);
+}
+
+void getbitCommand(Client& client, const std::vector<Slice>& args) {
+  uint64_t offset;
+  if (!parseBitOffset(client, args[2], false, 0, &offset))
+    return;
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kString, &o))
+    return;
+  if (!o) {
+    client.reply().raw(shared::kZero);
+    return;
+  }
+  char buf[Object::kIntBufSize];
+  const Slice s = o->stringValue(buf);
+  client.reply().integer(
+      bitAt(reinterpret_cast<const unsigned char*>(s.data), s.len, offset));
+}
+
+// BITCOUNT key [start end [BYTE|BIT]]
+void bitcountCommand(Client& client, const std::vector<Slice>& args) {
+  long long start = 0;
+  long long end = -1;
+  bool isBit = false;
+  if (args.size() == 3 || args.size() > 5) {
+    client.reply().raw(shared::kSyntaxErr);
+    return;
+  }
+  if (args.size() >= 4) {
+    if (!parseInteger(client, args[2], &start) ||
+        !parseInteger(client, args[3], &end))
+      return;
+    if (args.size() == 5 && !parseRangeUnit(client, args[4], &isBit))
+      return;
+  }
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kString, &o))
+    return;
+  if (!o) {
+    client.reply().raw(shared::kZero);
+    return;
+  }
+  char buf[Object::kIntBufSize];
+  const Slice s = o->stringValue(buf);
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data);
+  const long long total = static_cast<long long>(s.len) * (isBit ? 8 : 1);
+  if (!clampRange(total, &start, &end)) {
+    client.reply().raw(shared::kZero);
+    return;
+  }
+  if (!isBit) {
+    client.reply().integer(static_cast<long long>(
+        popcount(p + start, static_cast<std::size_t>(end - start + 1))));
+    return;
+  }
+  // 按字节计数后减去首尾字节中区间之外的位
+  const std::size_t first = static_cast<std::size_t>(start >> 3);
+  const std::size_t last = static_cast<std::size_t>(end >> 3);
+  std::size_t count = popcount(p + first, last - first + 1);
+  const unsigned char before =
+      static_cast<unsigned char>(0xFF00u >> (start & 7));
+  const unsigned char after =
+      static_cast<unsigned char>((1u << (7 - (end & 7))) - 1);
+  count -= __builtin_popcount(p[first] & before);
+  count -= __builtin_popcount(p[last] & after);
+  client.reply().integer(static_cast<long long>(count));
+}
+
+// BITPOS key bit [start [end [BYTE|BIT]]]。找 0 且没有给出 end 时，
+// 与 Redis 一样把字符串右边视为补 0，全是 1 时返回字符串之后的第一位
+void bitposCommand(Client& client, const std::vector<Slice>& args) {
+  if (args.size() > 6) {
+    client.reply().raw(shared::kSyntaxErr);
+    return;
+  }
+  long long bit;
+  if (!parseInteger(client, args[2], &bit))
+    return;
+  if (bit != 0 && bit != 1) {
+    client.reply().error("ERR The bit argument must be 1 or 0.");
+    return;
+  }
+  long long start = 0;
+  long long end = -1;
+  const bool endGiven = args.size() >= 5;
+  bool isBit = false;
+  if (args.size() >= 4 && !parseInteger(client, args[3], &start))
+    return;
+  if (endGiven && !parseInteger(client, args[4], &end))
+    return;
+  if (args.size() == 6 && !parseRangeUnit(client, args[5], &isBit))
+    return;
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kString, &o))
+    return;
+  if (!o) {
+    client.reply().integer(bit ? -1 : 0);
+    return;
+  }
+  char buf[Object::kIntBufSize];
+  const Slice s = o->stringValue(buf);
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data);
+  const long long total = static_cast<long long>(s.len) * (isBit ? 8 : 1);
+  if (!clampRange(total, &start, &end)) {
+    client.reply().integer(-1);
+    return;
+  }
+  const uint64_t startBit = static_cast<uint64_t>(isBit ? start : start * 8);
+  const uint64_t endBit = static_cast<uint64_t>(isBit ? end : end * 8 + 7);
+  const std::size_t first = static_cast<std::size_t>(startBit >> 3);
+  const std::size_t last = static_cast<std::size_t>(endBit >> 3);
+  const unsigned char skip = bit ? 0x00 : 0xFF;
+  // 首尾字节中区间之外的位填成 skip 的值，不会被找到
+  auto masked = [&](std::size_t i) {
+    unsigned b = p[i];
+    if (i == first)
+      b = bit ? b & (0xFFu >> (startBit & 7)) : b | (0xFF00u >> (startBit & 7));
+    if (i == last) {
+      const unsigned tail = (1u << (7 - (endBit & 7))) - 1;
+      b = bit ? b & ~tail : b | tail;
+    }
+    return static_cast<unsigned char>(b);
+  };
+
+  std::size_t at = first;
+  unsigned char b = masked(first);
+  if (b == skip && last > first) {
+    at = first + 1 + findByteNot(p + first + 1, last - first - 1, skip);
+    b = at < last ? p[at] : masked(last);
+  }
+  if (b != skip) {
+    const unsigned want = bit ? b : static_cast<unsigned char>(~b);
+    client.reply().integer(static_cast<long long>(at) * 8 +
+                           __builtin_clz(want) - 24);
+    return;
+  }
+  if (!bit && !endGiven)
+    client.reply().integer(static_cast<long long>(s.len) * 8);
+  else
+    client.reply().integer(-1);
+}
+
+// BITOP AND|OR|XOR|NOT destkey key [key ...]，返回结果的长度；
+// 结果为空时删除 destkey
+void bitopCommand(Client& client, const std::vector<Slice>& args) {
+  BitOp op;
+  if (argIs(args[1], "and")) {
+    op = BitOp::kAnd;
+  } else if (argIs(args[1], "or")) {
+    op = BitOp::kOr;
+  } else if (argIs(args[1], "xor")) {
+    op = BitOp::kXor;
+  } else if (argIs(args[1], "not")) {
+    op = BitOp::kNot;
+  } else {
+    client.reply().raw(shared::kSyntaxErr);
+    return;
+  }
+  if (op == BitOp::kNot && args.size() != 4) {
+    client.reply().error(
+        "ERR BITOP NOT must be called with a single source key.");
+    return;
+  }
+
+  const std::size_t count = args.size() - 3;
+  std::unique_ptr<char[]> intBufs(new char[count * Object::kIntBufSize]);
+  std::vector<const void*> srcs(count);
+  std::vector<std::size_t> lens(count);
+  std::size_t maxLen = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    Object* o;
+    if (!lookupTyped(client, args[3 + i], Object::Type::kString, &o))
+      return;
+    Slice s{nullptr, 0};
+    if (o)
+      s = o->stringValue(intBufs.get() + i * Object::kIntBufSize);
+    srcs[i] = s.data;
+    lens[i] = s.len;
+    if (s.len > maxLen)
+      maxLen = s.len;
+  }
+
+  Database::Keyspace& keys = client.db().keys(args[2]);
+  if (maxLen == 0) {
+    keys.erase(args[2]);
+    client.reply().raw(shared::kZero);
+    return;
+  }
+  // 先算出结果再替换 destkey，destkey 同时是源时也不受影响
+  Object result;
+  bitop(op, result.mutableString(maxLen), maxLen, srcs.data(), lens.data(),
+        count);
+  Object* cur = keys.find(args[2]);
+  if (cur)
+    *cur = std::move(result);
+  else
+    keys.set(args[2].toString(), std::move(result));
+  client.reply().integer(static_cast<long long>(maxLen));
+}
+
+// BITFIELD key [GET type offset] [SET type offset value]
+//   [INCRBY type offset increment] [OVERFLOW WRAP|SAT|FAIL] ...
+// 先解析全部子命令，有写操作时才创建键或补齐长度；FAIL 溢出的写操作回复 null
+void bitfieldCommand(Client& client, const std::vector<Slice>& args) {
+  std::vector<BitfieldOp> ops;
+  Overflow overflow = Overflow::kWrap;
+  bool write = false;
+  uint64_t maxBit = 0;
+  for (std::size_t i = 2; i < args.size();) {
+    const std::size_t left = args.size() - i - 1;
+    BitfieldOp op;
+    if (argIs(args[i], "get") && left >= 2) {
+      op.kind = BitfieldOp::kGet;
+    } else if (argIs(args[i], "set") && left >= 3) {
+      op.kind = BitfieldOp::kSet;
+    } else if (argIs(args[i], "incrby") && left >= 3) {
+      op.kind = BitfieldOp::kIncrBy;
+    } else if (argIs(args[i], "overflow") && left >= 1) {
+      if (argIs(args[i + 1], "wrap")) {
+        overflow = Overflow::kWrap;
+      } else if (argIs(args[i + 1], "sat")) {
+        overflow = Overflow::kSat;
+      } else if (argIs(args[i + 1], "fail")) {
+        overflow = Overflow::kFail;
+      } else {
+        client.reply().error("ERR Invalid OVERFLOW type specified");
+        return;
+      }
+      i += 2;
+      continue;
+    } else {
+      client.reply().raw(shared::kSyntaxErr);
+      return;
+    }
+    if (!parseBitfieldType(client, args[i + 1], &op.sign, &op.bits) ||
+        !parseBitOffset(client, args[i + 2], true, op.bits, &op.offset))
+      return;
+    op.value = 0;
+    op.overflow = overflow;
+    if (op.kind != BitfieldOp::kGet) {
+      long long v;
+      if (!parseInteger(client, args[i + 3], &v))
+        return;
+      op.value = v;
+      write = true;
+      if (op.offset + op.bits - 1 > maxBit)
+        maxBit = op.offset + op.bits - 1;
+    }
+    ops.push_back(op);
+    i += op.kind == BitfieldOp::kGet ? 3 : 4;
+  }
+
+  const unsigned char* p = nullptr;
+  std::size_t len = 0;
+  unsigned char* w = nullptr;
+  char buf[Object::kIntBufSize];
+  if (write) {
+    w = bitmapForWrite(client, args[1], maxBit);
+    if (!w)
+      return;
+    p = w;
+    len = static_cast<std::size_t>(maxBit >> 3) + 1;
+  } else {
+    Object* o;
+    if (!lookupTyped(client, args[1], Object::Type::kString, &o))
+      return;
+    if (o) {
+      const Slice s = o->stringValue(buf);
+      p = reinterpret_cast<const unsigned char*>(s.data);
+      len = s.len;
+    }
+  }
+
+  RespEncoder& reply = client.reply();
+  reply.array(ops.size());
+  for (const BitfieldOp& op : ops) {
+    if (op.sign) {
+      const int64_t old = getSigned(p, len, op.offset, op.bits);
+      if (op.kind == BitfieldOp::kGet) {
+        reply.integer(old);
+        continue;
+      }
+      int64_t wrapped = 0;
+      int64_t next;
+      int64_t ret;
+      int over;
+      if (op.kind == BitfieldOp::kIncrBy) {
+        over = checkSignedOverflow(old, op.value, op.bits, op.overflow,
+                                   &wrapped);
+        next = over ? wrapped
+                    : static_cast<int64_t>(static_cast<uint64_t>(old) +
+                                           static_cast<uint64_t>(op.value));
+        ret = next;
+      } else {
+        over = checkSignedOverflow(op.value, 0, op.bits, op.overflow,
+                                   &wrapped);
+        next = over ? wrapped : op.value;
+        ret = old;
+      }
+      if (over && op.overflow == Overflow::kFail) {
+        reply.null();
+        continue;
+      }
+      setField(w, op.offset, op.bits, static_cast<uint64_t>(next));
+      reply.integer(ret);
+    } else {
+      const uint64_t old = getUnsigned(p, len, op.offset, op.bits);
+      if (op.kind == BitfieldOp::kGet) {
+        reply.integer(static_cast<long long>(old));
+        continue;
+      }
+      uint64_t wrapped = 0;
+      uint64_t next;
+      uint64_t ret;
+      int over;
+      if (op.kind == BitfieldOp::kIncrBy) {
+        over = checkUnsignedOverflow(old, op.value, op.bits, op.overflow,
+                                     &wrapped);
+        next = over ? wrapped : old + static_cast<uint64_t>(op.value);
+        ret = next;
+      } else {
+        over = checkUnsignedOverflow(static_cast<uint64_t>(op.value), 0,
+                                     op.bits, op.overflow, &wrapped);
+        next = over ? wrapped : static_cast<uint64_t>(op.value);
+        ret = old;
+      }
+      if (over && op.overflow == Overflow::kFail) {
+        reply.null();
+        continue;
+      }
+      setField(w, op.offset, op.bits, next);
+      reply.integer(static_cast<long long>(ret));
+    }
+  }
+}
+}  // namespace tinyredis
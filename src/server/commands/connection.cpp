@@ -0,0 +1,149 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/protocol/respScan.h>
+#include <server/protocol/respShared.h>
+#include <string>
+#include <vector>
+
+namespace tinyredis {
+namespace {
+// 与 Redis 一致：连接名只允许可见 ASCII 字符，不能有空格
+bool validClientName(const std::string& name) {
+  for (char c : name) {
+    if (c < '!' || c > '~')
+      return false;
+  }
+  return true;
+}
+
+// CLIENT INFO 的一行，字段以空格分隔；流水线批处理统计放在末尾
+std::string clientInfo(const Client& client) {
+  const StreamSocket::BatchStats& st = client.batchStats();
+  return "id=" + std::to_string(client.getID()) +
+         " addr=" + client.getPeerAddr().toString() +
+         " fd=" + std::to_string(client.getSocket()) +
+         " name=" + client.name() +
+         " cmds=" + std::to_string(st.commands) +
+         " batches=" + std::to_string(st.batches) +
+         " last-batch=" + std::to_string(st.lastBatch) +
+         " max-batch=" + std::to_string(st.maxBatch) +
+         " flushes=" + std::to_string(st.flushes) +
+         " writev=" + std::to_string(st.writevCalls) + "\n";
+}
+}  // namespace
+
+void pingCommand(Client& client, const std::vector<Slice>& args) {
+  if (args.size() > 2) {
+    client.reply().error("ERR wrong number of arguments for 'ping' command");
+  } else if (args.size() == 1) {
+    client.reply().raw(shared::kPong);
+  } else {
+    client.reply().bulk(args[1].data, args[1].len);
+  }
+}
+
+void echoCommand(Client& client, const std::vector<Slice>& args) {
+  client.reply().bulk(args[1].data, args[1].len);
+}
+
+// HELLO [protover [AUTH username password] [SETNAME clientname]]
+void helloCommand(Client& client, const std::vector<Slice>& args) {
+  RespEncoder& reply = client.reply();
+  RespVersion version = reply.version();
+  std::size_t i = 1;
+  if (args.size() > 1) {
+    long long ver = 0;
+    if (!parseDecimal(args[1].data, args[1].len, ver)) {
+      reply.error("ERR Protocol version is not an integer or out of range");
+      return;
+    }
+    if (ver != 2 && ver != 3) {
+      reply.error("-NOPROTO unsupported protocol version");
+      return;
+    }
+    version = static_cast<RespVersion>(ver);
+    i = 2;
+  }
+
+  // 先检查全部选项，出错时不改变连接状态
+  std::string name = client.name();
+  for (; i < args.size(); ++i) {
+    const std::size_t more = args.size() - i - 1;
+    if (argIs(args[i], "auth") && more >= 2) {
+      i += 2;  // 还没有访问控制，任何凭据都接受
+    } else if (argIs(args[i], "setname") && more >= 1) {
+      name = args[++i].toString();
+      if (!validClientName(name)) {
+        reply.error(
+            "ERR Client names cannot contain spaces, newlines or special "
+            "characters.");
+        return;
+      }
+    } else {
+      std::string msg =
+          "ERR Syntax error in HELLO option '" + args[i].toString() + "'";
+      reply.error(msg.data(), msg.size());
+      return;
+    }
+  }
+  client.setName(name);
+  reply.setVersion(version);
+
+  reply.map(7);
+  reply.bulk("server", 6);
+  reply.bulk("redis", 5);
+  reply.bulk("version", 7);
+  reply.bulk("7.0.0", 5);
+  reply.bulk("proto", 5);
+  reply.integer(static_cast<long long>(version));
+  reply.bulk("id", 2);
+  reply.integer(static_cast<long long>(client.getID()));
+  reply.bulk("mode", 4);
+  reply.bulk("standalone", 10);
+  reply.bulk("role", 4);
+  reply.bulk("master", 6);
+  reply.bulk("modules", 7);
+  reply.array(0);
+}
+
+// CLIENT ID | GETNAME | SETNAME name | INFO，只涉及当前连接
+void clientCommand(Client& client, const std::vector<Slice>& args) {
+  RespEncoder& reply = client.reply();
+  if (argIs(args[1], "id") && args.size() == 2) {
+    reply.integer(static_cast<long long>(client.getID()));
+    return;
+  }
+
+  if (argIs(args[1], "getname") && args.size() == 2) {
+    if (client.name().empty())
+      reply.null();
+    else
+      reply.bulk(client.name().data(), client.name().size());
+    return;
+  }
+
+  if (argIs(args[1], "setname") && args.size() == 3) {
+    std::string name = args[2].toString();
+    if (!validClientName(name)) {
+      reply.error(
+          "ERR Client names cannot contain spaces, newlines or special "
+          "characters.");
+      return;
+    }
+    client.setName(name);
+    reply.raw(shared::kOk);
+    return;
+  }
+
+  if (argIs(args[1], "info") && args.size() == 2) {
+    const std::string info = clientInfo(client);
+    reply.verbatim("txt", info.data(), info.size());
+    return;
+  }
+
+  std::string msg =
+      "ERR unknown subcommand or wrong number of arguments for '" +
+      args[1].toString() + "'. Try CLIENT HELP.";
+  reply.error(msg.data(), msg.size());
+}
+}  // namespace tinyredis
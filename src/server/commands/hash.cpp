@@ -0,0 +1,97 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <server/db/hashType.h>
+#include <server/protocol/respShared.h>
+
+namespace tinyredis {
+// HSET key field value [field value ...]，返回新增的字段数
+void hsetCommand(Client& client, const std::vector<Slice>& args) {
+  if (args.size() % 2 != 0) {
+    client.reply().error("ERR wrong number of arguments for 'hset' command");
+    return;
+  }
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kHash, &o))
+    return;
+  if (!o)
+    o = client.db().add(args[1], hashType::create());
+  const EncodingConfig& cfg = client.db().config();
+  long long added = 0;
+  for (std::size_t i = 2; i < args.size(); i += 2)
+    added += hashType::set(*o, args[i], args[i + 1], cfg);
+  client.reply().integer(added);
+}
+
+void hgetCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kHash, &o))
+    return;
+  char buf[Listpack::kIntBufSize];
+  Slice v;
+  if (o && hashType::get(*o, args[2], buf, &v))
+    client.reply().bulk(v.data, v.len);
+  else
+    client.reply().null();
+}
+
+void hmgetCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kHash, &o))
+    return;
+  client.reply().array(args.size() - 2);
+  char buf[Listpack::kIntBufSize];
+  Slice v;
+  for (std::size_t i = 2; i < args.size(); ++i) {
+    if (o && hashType::get(*o, args[i], buf, &v))
+      client.reply().bulk(v.data, v.len);
+    else
+      client.reply().null();
+  }
+}
+
+void hdelCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kHash, &o))
+    return;
+  if (!o) {
+    client.reply().raw(shared::kZero);
+    return;
+  }
+  long long deleted = 0;
+  for (std::size_t i = 2; i < args.size(); ++i)
+    deleted += hashType::erase(*o, args[i]);
+  removeIfEmpty(client, args[1], hashType::size(*o));
+  client.reply().integer(deleted);
+}
+
+void hlenCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kHash, &o))
+    return;
+  client.reply().integer(o ? static_cast<long long>(hashType::size(*o)) : 0);
+}
+
+void hexistsCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kHash, &o))
+    return;
+  client.reply().integer(o && hashType::exists(*o, args[2]) ? 1 : 0);
+}
+
+void hgetallCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kHash, &o))
+    return;
+  RespEncoder& reply = client.reply();
+  if (!o) {
+    reply.map(0);
+    return;
+  }
+  reply.map(hashType::size(*o));
+  hashType::forEach(*o, [&reply](const Slice& field, const Slice& value) {
+    reply.bulk(field.data, field.len);
+    reply.bulk(value.data, value.len);
+  });
+}
+}  // namespace tinyredis
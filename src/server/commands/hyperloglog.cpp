@@ -0,0 +1,108 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <server/db/hyperloglog.h>
+#include <server/protocol/respShared.h>
+#include <cstring>
+
+namespace tinyredis {
+namespace {
+void replyCorrupted(Client& client) {
+  client.reply().error("-INVALIDOBJ Corrupted HLL object detected");
+}
+
+// 查找 HLL：不存在时 *out 为空；不是字符串或内容不是 HLL 时回复错误并返回 false
+bool lookupHll(Client& client, const Slice& key, Object** out) {
+  if (!lookupTyped(client, key, Object::Type::kString, out))
+    return false;
+  char buf[Object::kIntBufSize];
+  if (*out && !hll::valid((*out)->stringValue(buf))) {
+    client.reply().error(
+        "-WRONGTYPE Key is not a valid HyperLogLog string value.");
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+// PFADD key [element ...]，有寄存器变化或新建了键时返回 1
+void pfaddCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupHll(client, args[1], &o))
+    return;
+  bool updated = false;
+  if (!o) {
+    o = client.db().add(args[1], hll::create());
+    updated = true;
+  }
+  const std::size_t sparseMaxBytes = client.db().config().hllSparseMaxBytes;
+  for (std::size_t i = 2; i < args.size(); ++i) {
+    const int r = hll::add(*o, args[i], sparseMaxBytes);
+    if (r < 0) {
+      replyCorrupted(client);
+      return;
+    }
+    updated = updated || r > 0;
+  }
+  client.reply().raw(updated ? shared::kOne : shared::kZero);
+}
+
+// PFCOUNT key [key ...]。单个键时使用并更新基数缓存；
+// 多个键时合并到线程的临时寄存器上计数，不修改各个键
+void pfcountCommand(Client& client, const std::vector<Slice>& args) {
+  if (args.size() == 2) {
+    Object* o;
+    if (!lookupHll(client, args[1], &o))
+      return;
+    uint64_t card = 0;
+    if (o && !hll::count(*o, &card)) {
+      replyCorrupted(client);
+      return;
+    }
+    client.reply().integer(static_cast<long long>(card));
+    return;
+  }
+  hll::Registers& regs = hll::scratch();
+  std::memset(regs.r, 0, sizeof(regs.r));
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    Object* o;
+    if (!lookupHll(client, args[i], &o))
+      return;
+    char buf[Object::kIntBufSize];
+    if (o && !hll::merge(regs, o->stringValue(buf))) {
+      replyCorrupted(client);
+      return;
+    }
+  }
+  client.reply().integer(static_cast<long long>(hll::count(regs)));
+}
+
+// PFMERGE destkey [sourcekey ...]：destkey 本身也参与合并；
+// 有任一输入是 dense 时结果为 dense，否则尽量保持 sparse
+void pfmergeCommand(Client& client, const std::vector<Slice>& args) {
+  hll::Registers& regs = hll::scratch();
+  std::memset(regs.r, 0, sizeof(regs.r));
+  bool dense = false;
+  Object* dest = nullptr;
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    Object* o;
+    if (!lookupHll(client, args[i], &o))
+      return;
+    if (!o)
+      continue;
+    char buf[Object::kIntBufSize];
+    const Slice s = o->stringValue(buf);
+    dense = dense || hll::isDense(s);
+    if (!hll::merge(regs, s)) {
+      replyCorrupted(client);
+      return;
+    }
+    if (i == 1)
+      dest = o;
+  }
+  if (!dest)
+    dest = client.db().add(args[1], hll::create());
+  hll::store(*dest, regs, dense, client.db().config().hllSparseMaxBytes);
+  client.reply().raw(shared::kOk);
+}
+}  // namespace tinyredis
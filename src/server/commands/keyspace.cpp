@@ -0,0 +1,174 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <server/protocol/respScan.h>
+#include <server/protocol/respShared.h>
+#include <server/util/stringMatch.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace tinyredis {
+namespace {
+// 游标是无符号 64 位整数，超出 parseDecimal 的 18 位范围
+bool parseCursor(const Slice& arg, uint64_t& out) {
+  if (arg.len == 0 || arg.len > 20)
+    return false;
+  char buf[21];
+  for (std::size_t i = 0; i < arg.len; ++i) {
+    if (arg.data[i] < '0' || arg.data[i] > '9')
+      return false;
+    buf[i] = arg.data[i];
+  }
+  buf[arg.len] = '\0';
+  errno = 0;
+  unsigned long long v = std::strtoull(buf, nullptr, 10);
+  if (errno == ERANGE)
+    return false;
+  out = v;
+  return true;
+}
+}  // namespace
+
+void delCommand(Client& client, const std::vector<Slice>& args) {
+  long long deleted = 0;
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    if (client.db().keys(args[i]).erase(args[i]))
+      ++deleted;
+  }
+  client.reply().integer(deleted);
+}
+
+void existsCommand(Client& client, const std::vector<Slice>& args) {
+  long long found = 0;
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    if (client.db().keys(args[i]).find(args[i]))
+      ++found;
+  }
+  client.reply().integer(found);
+}
+
+void dbsizeCommand(Client& client, const std::vector<Slice>& args) {
+  (void)args;
+  client.reply().integer(static_cast<long long>(client.db().size()));
+}
+
+// FLUSHDB [ASYNC|SYNC]，都同步执行
+void flushdbCommand(Client& client, const std::vector<Slice>& args) {
+  if (args.size() > 2 ||
+      (args.size() == 2 && !argIs(args[1], "async") &&
+       !argIs(args[1], "sync"))) {
+    client.reply().raw(shared::kSyntaxErr);
+    return;
+  }
+  client.db().clear();
+  client.reply().raw(shared::kOk);
+}
+
+// SCAN cursor [MATCH pattern] [COUNT count]
+void scanCommand(Client& client, const std::vector<Slice>& args) {
+  RespEncoder& reply = client.reply();
+  uint64_t cursor = 0;
+  if (!parseCursor(args[1], cursor)) {
+    reply.error("ERR invalid cursor");
+    return;
+  }
+
+  const Slice* pattern = nullptr;
+  long long count = 10;
+  for (std::size_t i = 2; i < args.size(); i += 2) {
+    if (i + 1 >= args.size()) {
+      reply.raw(shared::kSyntaxErr);
+      return;
+    }
+    if (argIs(args[i], "match")) {
+      pattern = &args[i + 1];
+      // "*" 匹配一切，不必逐个比较
+      if (pattern->len == 1 && pattern->data[0] == '*')
+        pattern = nullptr;
+    } else if (argIs(args[i], "count")) {
+      if (!parseDecimal(args[i + 1].data, args[i + 1].len, count)) {
+        reply.error("ERR value is not an integer or out of range");
+        return;
+      }
+      if (count < 1) {
+        reply.raw(shared::kSyntaxErr);
+        return;
+      }
+    } else {
+      reply.raw(shared::kSyntaxErr);
+      return;
+    }
+  }
+
+  // 游标的低位是分片编号，其余是该分片哈希表的游标；一个分片扫完后
+  // 从下一个分片的开头继续，最后一个分片扫完时游标回到 0。
+  // 与 Redis 一样，count 只是提示：最多访问 count * 10 个桶，防止稀疏表上空转。
+  // 持有全部分片的锁，回复写完之前键不会被修改，直接引用字典中的键
+  Database& db = client.db();
+  std::size_t shard =
+      static_cast<std::size_t>(cursor) & (Database::kShards - 1);
+  uint64_t tableCursor = cursor >> Database::kShardBits;
+  std::vector<const std::string*> found;
+  long long maxBuckets = count < (1LL << 40) ? count * 10 : (1LL << 40);
+  do {
+    tableCursor = db.shard(shard).scan(
+        tableCursor, [&found](const Database::Keyspace::Entry& e) {
+          found.push_back(&e.key);
+        });
+    if (tableCursor == 0)
+      ++shard;
+  } while (shard < Database::kShards && --maxBuckets > 0 &&
+           static_cast<long long>(found.size()) < count);
+  cursor = shard < Database::kShards
+               ? (tableCursor << Database::kShardBits) | shard
+               : 0;
+
+  std::size_t n = found.size();
+  if (pattern) {
+    n = 0;
+    for (std::size_t i = 0; i < found.size(); ++i) {
+      const std::string& key = *found[i];
+      if (stringMatch(pattern->data, pattern->len, key.data(), key.size()))
+        found[n++] = found[i];
+    }
+  }
+
+  char buf[32];
+  char* end = buf + sizeof(buf);
+  char* p = formatDecimal(end, static_cast<long long>(cursor));
+  reply.array(2);
+  reply.bulk(p, static_cast<std::size_t>(end - p));
+  reply.array(n);
+  for (std::size_t i = 0; i < n; ++i)
+    reply.bulk(found[i]->data(), found[i]->size());
+}
+
+void typeCommand(Client& client, const std::vector<Slice>& args) {
+  const Object* value = client.db().keys(args[1]).find(args[1]);
+  if (!value) {
+    client.reply().simpleString("none");
+    return;
+  }
+  client.reply().simpleString(value->typeName());
+}
+
+// OBJECT ENCODING key
+void objectCommand(Client& client, const std::vector<Slice>& args) {
+  if (argIs(args[1], "encoding") && args.size() == 3) {
+    const Object* value = client.db().keys(args[2]).find(args[2]);
+    if (value)
+      client.reply().bulk(value->encodingName(),
+                          std::strlen(value->encodingName()));
+    else
+      client.reply().null();
+    return;
+  }
+  std::string msg =
+      "ERR unknown subcommand or wrong number of arguments for '" +
+      args[1].toString() + "'. Try OBJECT HELP.";
+  client.reply().error(msg.data(), msg.size());
+}
+}  // namespace tinyredis
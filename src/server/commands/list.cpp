@@ -0,0 +1,100 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <server/db/listType.h>
+#include <server/protocol/respShared.h>
+#include <string>
+
+namespace tinyredis {
+namespace {
+// LPUSH/RPUSH 的公共部分，返回 push 之后的长度
+void push(Client& client, const std::vector<Slice>& args, bool head) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kList, &o))
+    return;
+  if (!o)
+    o = client.db().add(args[1], listType::create());
+  const EncodingConfig& cfg = client.db().config();
+  for (std::size_t i = 2; i < args.size(); ++i)
+    listType::push(*o, args[i], head, cfg);
+  client.reply().integer(static_cast<long long>(listType::size(*o)));
+}
+
+void pop(Client& client, const std::vector<Slice>& args, bool head) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kList, &o))
+    return;
+  std::string v;
+  if (!o || !listType::pop(*o, head, &v)) {
+    client.reply().null();
+    return;
+  }
+  removeIfEmpty(client, args[1], listType::size(*o));
+  client.reply().bulk(v.data(), v.size());
+}
+}  // namespace
+
+void lpushCommand(Client& client, const std::vector<Slice>& args) {
+  push(client, args, true);
+}
+
+void rpushCommand(Client& client, const std::vector<Slice>& args) {
+  push(client, args, false);
+}
+
+void lpopCommand(Client& client, const std::vector<Slice>& args) {
+  pop(client, args, true);
+}
+
+void rpopCommand(Client& client, const std::vector<Slice>& args) {
+  pop(client, args, false);
+}
+
+void llenCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kList, &o))
+    return;
+  client.reply().integer(o ? static_cast<long long>(listType::size(*o)) : 0);
+}
+
+// LRANGE key start stop，负数下标从末尾算起，超出范围的部分截掉
+void lrangeCommand(Client& client, const std::vector<Slice>& args) {
+  long long start, stop;
+  if (!parseInteger(client, args[2], &start) ||
+      !parseInteger(client, args[3], &stop))
+    return;
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kList, &o))
+    return;
+  RespEncoder& reply = client.reply();
+  const long long n = o ? static_cast<long long>(listType::size(*o)) : 0;
+  if (start < 0)
+    start = start + n < 0 ? 0 : start + n;
+  if (stop < 0)
+    stop += n;
+  if (stop >= n)
+    stop = n - 1;
+  if (start > stop || start >= n) {
+    reply.raw(shared::kEmptyArray);
+    return;
+  }
+  reply.array(static_cast<std::size_t>(stop - start + 1));
+  listType::range(*o, static_cast<std::size_t>(start),
+                  static_cast<std::size_t>(stop),
+                  [&reply](const Slice& v) { reply.bulk(v.data, v.len); });
+}
+
+void lindexCommand(Client& client, const std::vector<Slice>& args) {
+  long long index;
+  if (!parseInteger(client, args[2], &index))
+    return;
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kList, &o))
+    return;
+  std::string v;
+  if (o && listType::index(*o, index, &v))
+    client.reply().bulk(v.data(), v.size());
+  else
+    client.reply().null();
+}
+}  // namespace tinyredis
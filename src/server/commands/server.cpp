@@ -0,0 +1,182 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <server/protocol/respShared.h>
+#include <server/util/numbers.h>
+#include <server/util/stringMatch.h>
+#include <climits>
+#include <cstring>
+#include <string>
+
+namespace tinyredis {
+namespace {
+void replyStat(RespEncoder& reply, const char* name, long long v) {
+  reply.bulk(name, std::strlen(name));
+  reply.integer(v);
+}
+
+// CONFIG 可读写的参数，都是 EncodingConfig 中的整数：
+// 多数是非负的 size 字段，list 的两个参数是 long long，有各自的取值范围
+struct ConfigParam {
+  const char* name;
+  std::size_t EncodingConfig::*size;
+  long long EncodingConfig::*value;
+  long long min;
+  long long max;
+};
+
+const long long kIntMax = 2147483647LL;
+
+const ConfigParam kConfigParams[] = {
+    {"hash-max-listpack-entries", &EncodingConfig::hashMaxListpackEntries,
+     nullptr, 0, LLONG_MAX},
+    {"hash-max-listpack-value", &EncodingConfig::hashMaxListpackValue,
+     nullptr, 0, LLONG_MAX},
+    {"set-max-listpack-entries", &EncodingConfig::setMaxListpackEntries,
+     nullptr, 0, LLONG_MAX},
+    {"set-max-listpack-value", &EncodingConfig::setMaxListpackValue, nullptr,
+     0, LLONG_MAX},
+    {"set-max-intset-entries", &EncodingConfig::setMaxIntsetEntries,
+     nullptr, 0, LLONG_MAX},
+    {"zset-max-listpack-entries", &EncodingConfig::zsetMaxListpackEntries,
+     nullptr, 0, LLONG_MAX},
+    {"zset-max-listpack-value", &EncodingConfig::zsetMaxListpackValue,
+     nullptr, 0, LLONG_MAX},
+    // 与 Redis 一样限制在 [-5, 2^31) 以内
+    {"list-max-listpack-size", nullptr, &EncodingConfig::listMaxListpackSize,
+     -5, kIntMax},
+    {"list-compress-depth", nullptr, &EncodingConfig::listCompressDepth, 0,
+     kIntMax},
+    {"hll-sparse-max-bytes", &EncodingConfig::hllSparseMaxBytes, nullptr, 0,
+     LLONG_MAX},
+    {"stream-node-max-bytes", &EncodingConfig::streamNodeMaxBytes, nullptr, 0,
+     LLONG_MAX},
+    {"stream-node-max-entries", &EncodingConfig::streamNodeMaxEntries, nullptr,
+     0, LLONG_MAX},
+};
+
+const ConfigParam* findConfigParam(const Slice& name) {
+  for (const ConfigParam& p : kConfigParams) {
+    if (argIs(name, p.name))
+      return &p;
+  }
+  return nullptr;
+}
+
+long long configValue(const EncodingConfig& cfg, const ConfigParam& p) {
+  return p.size ? static_cast<long long>(cfg.*p.size) : cfg.*p.value;
+}
+
+bool setConfigValue(EncodingConfig& cfg, const ConfigParam& p, long long v) {
+  if (v < p.min || v > p.max)
+    return false;
+  if (p.size)
+    cfg.*p.size = static_cast<std::size_t>(v);
+  else
+    cfg.*p.value = v;
+  return true;
+}
+}  // namespace
+
+// MEMORY USAGE key [SAMPLES count] | MEMORY STATS
+void memoryCommand(Client& client, const std::vector<Slice>& args) {
+  RespEncoder& reply = client.reply();
+  // 估计不做抽样，SAMPLES 只为兼容而接受
+  if (argIs(args[1], "usage") &&
+      (args.size() == 3 || (args.size() == 5 && argIs(args[3], "samples")))) {
+    const std::size_t bytes = client.db().memoryUsage(args[2]);
+    if (bytes == 0)
+      reply.null();
+    else
+      reply.integer(static_cast<long long>(bytes));
+    return;
+  }
+
+  if (argIs(args[1], "stats") && args.size() == 2) {
+    const Database::MemoryStats stats = client.db().memoryStats();
+    reply.map(7);
+    replyStat(reply, "total.allocated",
+              static_cast<long long>(stats.allocated));
+    replyStat(reply, "startup.allocated",
+              static_cast<long long>(stats.startup));
+    replyStat(reply, "dataset.bytes", static_cast<long long>(stats.dataset));
+    replyStat(reply, "table.bytes", static_cast<long long>(stats.tableBytes));
+    replyStat(reply, "keys.count", static_cast<long long>(stats.keys));
+    replyStat(reply, "keys.bytes-per-key",
+              stats.keys ? static_cast<long long>(stats.dataset / stats.keys)
+                         : 0);
+    reply.bulk("hash.engine", 11);
+    reply.bulk(kHashEngine, std::strlen(kHashEngine));
+    return;
+  }
+
+  std::string msg =
+      "ERR unknown subcommand or wrong number of arguments for '" +
+      args[1].toString() + "'. Try MEMORY HELP.";
+  reply.error(msg.data(), msg.size());
+}
+
+// USAGE 只访问一个键，STATS 统计整个键空间
+Database::ShardMask memoryKeys(const std::vector<Slice>& args) {
+  if (argIs(args[1], "usage"))
+    return args.size() >= 3 ? Database::shardBit(args[2]) : 0;
+  return argIs(args[1], "stats") ? Database::kAllShards : 0;
+}
+
+// CONFIG GET pattern | CONFIG SET parameter value [parameter value ...]，
+// 目前只有小聚合类型的编码阈值；SET 先检查全部参数，有一个不合法就不做修改
+void configCommand(Client& client, const std::vector<Slice>& args) {
+  RespEncoder& reply = client.reply();
+  EncodingConfig& cfg = client.db().config();
+  if (argIs(args[1], "get") && args.size() == 3) {
+    const ConfigParam* matched[sizeof(kConfigParams) / sizeof(ConfigParam)];
+    std::size_t n = 0;
+    for (const ConfigParam& p : kConfigParams) {
+      if (stringMatch(args[2].data, args[2].len, p.name, std::strlen(p.name),
+                      true))
+        matched[n++] = &p;
+    }
+    reply.map(n);
+    char buf[32];
+    char* end = buf + sizeof(buf);
+    for (std::size_t i = 0; i < n; ++i) {
+      reply.bulk(matched[i]->name, std::strlen(matched[i]->name));
+      char* p = formatDecimal(end, configValue(cfg, *matched[i]));
+      reply.bulk(p, static_cast<std::size_t>(end - p));
+    }
+    return;
+  }
+
+  if (argIs(args[1], "set") && args.size() >= 4 && args.size() % 2 == 0) {
+    EncodingConfig updated = cfg;
+    for (std::size_t i = 2; i < args.size(); i += 2) {
+      const ConfigParam* p = findConfigParam(args[i]);
+      if (!p) {
+        std::string msg =
+            "ERR Unknown option or number of arguments for CONFIG SET - '" +
+            args[i].toString() + "'";
+        reply.error(msg.data(), msg.size());
+        return;
+      }
+      long long v;
+      if (!parseLongLong(args[i + 1].data, args[i + 1].len, &v) ||
+          !setConfigValue(updated, *p, v)) {
+        std::string msg =
+            "ERR CONFIG SET failed (possibly related to argument '" +
+            args[i].toString() + "') - argument couldn't be parsed or is "
+            "out of range";
+        reply.error(msg.data(), msg.size());
+        return;
+      }
+    }
+    cfg = updated;
+    reply.raw(shared::kOk);
+    return;
+  }
+
+  std::string msg =
+      "ERR unknown subcommand or wrong number of arguments for '" +
+      args[1].toString() + "'. Try CONFIG HELP.";
+  reply.error(msg.data(), msg.size());
+}
+}  // namespace tinyredis
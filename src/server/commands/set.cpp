@@ -0,0 +1,155 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <server/db/setType.h>
+#include <server/protocol/respShared.h>
+#include <server/util/numbers.h>
+#include <string>
+
+namespace tinyredis {
+namespace {
+// 取 [first, last) 的各个键，与 Redis 一样先检查全部键的类型（类型不符时回复错误
+// 并返回 false）；不存在的键视为空集，*missing 为 true
+bool lookupSets(Client& client, std::vector<Slice>::const_iterator first,
+                std::vector<Slice>::const_iterator last,
+                std::vector<Object*>* sets, bool* missing) {
+  *missing = false;
+  for (; first != last; ++first) {
+    Object* o;
+    if (!lookupTyped(client, *first, Object::Type::kSet, &o))
+      return false;
+    if (o)
+      sets->push_back(o);
+    else
+      *missing = true;
+  }
+  return true;
+}
+}  // namespace
+
+// SADD key member [member ...]，返回新增的成员数
+void saddCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kSet, &o))
+    return;
+  if (!o)
+    o = client.db().add(args[1], setType::create(args[2]));
+  const EncodingConfig& cfg = client.db().config();
+  long long added = 0;
+  for (std::size_t i = 2; i < args.size(); ++i)
+    added += setType::add(*o, args[i], cfg);
+  client.reply().integer(added);
+}
+
+void sremCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kSet, &o))
+    return;
+  if (!o) {
+    client.reply().raw(shared::kZero);
+    return;
+  }
+  long long removed = 0;
+  for (std::size_t i = 2; i < args.size(); ++i)
+    removed += setType::erase(*o, args[i]);
+  removeIfEmpty(client, args[1], setType::size(*o));
+  client.reply().integer(removed);
+}
+
+void sismemberCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kSet, &o))
+    return;
+  client.reply().integer(o && setType::contains(*o, args[2]) ? 1 : 0);
+}
+
+void scardCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kSet, &o))
+    return;
+  client.reply().integer(o ? static_cast<long long>(setType::size(*o)) : 0);
+}
+
+void smembersCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kSet, &o))
+    return;
+  RespEncoder& reply = client.reply();
+  if (!o) {
+    reply.set(0);
+    return;
+  }
+  reply.set(setType::size(*o));
+  setType::forEach(*o, [&reply](const Slice& member) {
+    reply.bulk(member.data, member.len);
+  });
+}
+
+// SINTER key [key ...]
+void sinterCommand(Client& client, const std::vector<Slice>& args) {
+  std::vector<Object*> sets;
+  bool missing;
+  if (!lookupSets(client, args.begin() + 1, args.end(), &sets, &missing))
+    return;
+  std::vector<std::string> members;
+  if (!missing)
+    setType::intersect(sets, 0, &members);
+  RespEncoder& reply = client.reply();
+  reply.set(members.size());
+  for (const std::string& m : members)
+    reply.bulk(m.data(), m.size());
+}
+
+// numkeys 不合法时命令只回复错误，不访问键
+Database::ShardMask sintercardKeys(const std::vector<Slice>& args) {
+  long long numkeys = 0;
+  if (!parseLongLong(args[1].data, args[1].len, &numkeys) || numkeys <= 0 ||
+      static_cast<unsigned long long>(numkeys) > args.size() - 2)
+    return 0;
+  Database::ShardMask shards = 0;
+  for (std::size_t i = 0; i < static_cast<std::size_t>(numkeys); ++i)
+    shards |= Database::shardBit(args[2 + i]);
+  return shards;
+}
+
+// SINTERCARD numkeys key [key ...] [LIMIT limit]，只计数不生成交集；
+// limit 为 0 表示不限
+void sintercardCommand(Client& client, const std::vector<Slice>& args) {
+  long long numkeys;
+  if (!parseInteger(client, args[1], &numkeys))
+    return;
+  if (numkeys <= 0) {
+    client.reply().error("ERR numkeys should be greater than 0");
+    return;
+  }
+  if (static_cast<unsigned long long>(numkeys) > args.size() - 2) {
+    client.reply().error("ERR Number of keys can't be greater than number of "
+                         "args");
+    return;
+  }
+  const std::size_t keysEnd = 2 + static_cast<std::size_t>(numkeys);
+  long long limit = 0;
+  for (std::size_t i = keysEnd; i < args.size(); i += 2) {
+    if (!argIs(args[i], "limit") || i + 1 >= args.size()) {
+      client.reply().raw(shared::kSyntaxErr);
+      return;
+    }
+    if (!parseInteger(client, args[i + 1], &limit))
+      return;
+    if (limit < 0) {
+      client.reply().error("ERR LIMIT can't be negative");
+      return;
+    }
+  }
+  std::vector<Object*> sets;
+  bool missing;
+  if (!lookupSets(client, args.begin() + 2, args.begin() + keysEnd, &sets,
+                  &missing))
+    return;
+  const std::size_t n =
+      missing ? 0
+              : setType::intersect(sets, static_cast<std::size_t>(limit),
+                                   nullptr);
+  client.reply().integer(static_cast<long long>(n));
+}
+}  // namespace tinyredis
@@ -0,0 +1,1082 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <server/db/stream.h>
+#include <server/protocol/respShared.h>
+#include <chrono>
+#include <climits>
+#include <string>
+#include <vector>
+
+namespace tinyredis {
+namespace {
+// "ms-seq" 两个 64 位无符号数的最大长度
+const std::size_t kIdBufSize = 42;
+
+const char* kInvalidId =
+    "ERR Invalid stream ID specified as stream command argument";
+
+char* formatUnsigned(char* end, uint64_t v) {
+  do {
+    *--end = static_cast<char>('0' + v % 10);
+    v /= 10;
+  } while (v > 0);
+  return end;
+}
+
+Slice formatId(char* buf, const StreamId& id) {
+  char* end = buf + kIdBufSize;
+  char* p = formatUnsigned(end, id.seq);
+  *--p = '-';
+  p = formatUnsigned(p, id.ms);
+  return Slice{p, static_cast<std::size_t>(end - p)};
+}
+
+bool parseUnsigned(const char* s, std::size_t len, uint64_t* out) {
+  if (len == 0 || len > 20)
+    return false;
+  uint64_t v = 0;
+  for (std::size_t i = 0; i < len; ++i) {
+    if (s[i] < '0' || s[i] > '9')
+      return false;
+    const uint64_t d = static_cast<uint64_t>(s[i] - '0');
+    if (v > (UINT64_MAX - d) / 10)
+      return false;
+    v = v * 10 + d;
+  }
+  *out = v;
+  return true;
+}
+
+// 解析 "ms-seq" 或 "ms"（seq 取 missingSeq）；strict 为 false 时 "-"、"+" 表示最小、
+// 最大的 ID。seqAuto 不为空时还接受 XADD 的 "ms-*"，此时 *seqAuto 为 true
+bool parseId(const Slice& s, uint64_t missingSeq, bool strict, StreamId* id,
+             bool* seqAuto = nullptr) {
+  if (seqAuto)
+    *seqAuto = false;
+  if (!strict && s.len == 1 && (s.data[0] == '-' || s.data[0] == '+')) {
+    *id = s.data[0] == '-' ? StreamId::min() : StreamId::max();
+    return true;
+  }
+  std::size_t dash = 0;
+  while (dash < s.len && s.data[dash] != '-')
+    ++dash;
+  if (!parseUnsigned(s.data, dash, &id->ms))
+    return false;
+  if (dash == s.len) {
+    id->seq = missingSeq;
+    return true;
+  }
+  const char* seq = s.data + dash + 1;
+  const std::size_t seqLen = s.len - dash - 1;
+  if (seqAuto && seqLen == 1 && seq[0] == '*') {
+    *seqAuto = true;
+    id->seq = 0;
+    return true;
+  }
+  return parseUnsigned(seq, seqLen, &id->seq);
+}
+
+bool parseIdOrReply(Client& client, const Slice& s, uint64_t missingSeq,
+                    bool strict, StreamId* id, bool* seqAuto = nullptr) {
+  if (!parseId(s, missingSeq, strict, id, seqAuto)) {
+    client.reply().error(kInvalidId);
+    return false;
+  }
+  return true;
+}
+
+// ID 的后继与前驱，调用方保证不是最大、最小的 ID
+StreamId incrId(const StreamId& id) {
+  return id.seq == UINT64_MAX ? StreamId{id.ms + 1, 0}
+                              : StreamId{id.ms, id.seq + 1};
+}
+
+StreamId decrId(const StreamId& id) {
+  return id.seq == 0 ? StreamId{id.ms - 1, UINT64_MAX}
+                     : StreamId{id.ms, id.seq - 1};
+}
+
+uint64_t nowMs() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+
+// XADD 与 XTRIM 的选项
+struct AddOptions {
+  bool noMkStream = false;
+  bool trim = false;
+  Stream::TrimArgs trimArgs{Stream::TrimStrategy::kMaxLen, false, 0,
+                            StreamId{0, 0}, 0};
+};
+
+// 从 args[2] 开始解析选项，规则与 Redis 相同。XADD 遇到 "*" 或不认识的参数时视为 ID，
+// 返回其下标；XTRIM 不认识的参数是语法错误。出错时回复并返回 0
+std::size_t parseAddOptions(Client& client, const std::vector<Slice>& args,
+                            bool xadd, AddOptions* opts) {
+  RespEncoder& reply = client.reply();
+  bool limitGiven = false;
+  std::size_t i = 2;
+  for (; i < args.size(); ++i) {
+    const bool more = i + 1 < args.size();
+    const Slice& opt = args[i];
+    if (xadd && opt.len == 1 && opt.data[0] == '*')
+      break;
+    const bool maxLen = argIs(opt, "maxlen");
+    if ((maxLen || argIs(opt, "minid")) && more) {
+      if (opts->trim) {
+        reply.error(
+            "ERR syntax error, MAXLEN and MINID options at the same time are "
+            "not compatible");
+        return 0;
+      }
+      Stream::TrimArgs& t = opts->trimArgs;
+      const Slice& next = args[i + 1];
+      if (i + 2 < args.size() && next.len == 1 &&
+          (next.data[0] == '~' || next.data[0] == '=')) {
+        t.approx = next.data[0] == '~';
+        ++i;
+      }
+      ++i;
+      if (maxLen) {
+        t.strategy = Stream::TrimStrategy::kMaxLen;
+        if (!parseInteger(client, args[i], &t.maxLen))
+          return 0;
+        if (t.maxLen < 0) {
+          reply.error("ERR The MAXLEN argument must be >= 0.");
+          return 0;
+        }
+      } else {
+        t.strategy = Stream::TrimStrategy::kMinId;
+        if (!parseIdOrReply(client, args[i], 0, false, &t.minId))
+          return 0;
+      }
+      opts->trim = true;
+    } else if (argIs(opt, "limit") && more) {
+      long long limit;
+      if (!parseInteger(client, args[i + 1], &limit))
+        return 0;
+      if (limit < 0 || limit > 1000000) {
+        reply.error("ERR The LIMIT argument must be >= 0.");
+        return 0;
+      }
+      opts->trimArgs.limit = limit;
+      limitGiven = true;
+      ++i;
+    } else if (xadd && argIs(opt, "nomkstream")) {
+      opts->noMkStream = true;
+    } else if (xadd) {
+      break;
+    } else {
+      reply.raw(shared::kSyntaxErr);
+      return 0;
+    }
+  }
+
+  if (limitGiven && !opts->trim) {
+    reply.error(
+        "ERR syntax error, LIMIT cannot be used without specifying a trimming "
+        "strategy");
+    return 0;
+  }
+  if (!xadd && !opts->trim) {
+    reply.error(
+        "ERR syntax error, XTRIM must be called with a trimming strategy");
+    return 0;
+  }
+  if (limitGiven && !opts->trimArgs.approx) {
+    reply.error(
+        "ERR syntax error, LIMIT cannot be used without the special ~ option");
+    return 0;
+  }
+  if (!limitGiven && opts->trimArgs.approx) {
+    // 近似裁剪默认每次最多删除 100 个节点的条目，避免一次阻塞太久
+    const long long entries = static_cast<long long>(
+        client.db().config().streamNodeMaxEntries);
+    opts->trimArgs.limit =
+        entries > 0 && entries <= 100 ? entries * 100 : 10000;
+  }
+  return i;
+}
+
+void replyEntry(RespEncoder& reply, const Stream::Iterator& it,
+                const StreamId& id) {
+  char buf[kIdBufSize];
+  const Slice s = formatId(buf, id);
+  reply.array(2);
+  reply.bulk(s.data, s.len);
+  reply.array(it.numFields() * 2);
+  it.forEachField([&](const Slice& field, const Slice& value) {
+    reply.bulk(field.data, field.len);
+    reply.bulk(value.data, value.len);
+  });
+}
+
+// XRANGE/XREVRANGE 的公共部分，rev 时参数顺序为 end start
+void range(Client& client, const std::vector<Slice>& args, bool rev) {
+  RespEncoder& reply = client.reply();
+  const Slice& startArg = args[rev ? 3 : 2];
+  const Slice& endArg = args[rev ? 2 : 3];
+  StreamId start, end;
+  // "(" 表示开区间，换成相邻的 ID
+  const bool startEx = startArg.len > 1 && startArg.data[0] == '(';
+  const bool endEx = endArg.len > 1 && endArg.data[0] == '(';
+  if (startEx) {
+    if (!parseIdOrReply(client, Slice{startArg.data + 1, startArg.len - 1}, 0,
+                        true, &start))
+      return;
+    if (start == StreamId::max()) {
+      reply.error("ERR invalid start ID for the interval");
+      return;
+    }
+    start = incrId(start);
+  } else if (!parseIdOrReply(client, startArg, 0, false, &start)) {
+    return;
+  }
+  if (endEx) {
+    if (!parseIdOrReply(client, Slice{endArg.data + 1, endArg.len - 1},
+                        UINT64_MAX, true, &end))
+      return;
+    if (end == StreamId::min()) {
+      reply.error("ERR invalid end ID for the interval");
+      return;
+    }
+    end = decrId(end);
+  } else if (!parseIdOrReply(client, endArg, UINT64_MAX, false, &end)) {
+    return;
+  }
+
+  long long count = -1;
+  for (std::size_t i = 4; i < args.size(); ++i) {
+    if (argIs(args[i], "count") && i + 1 < args.size()) {
+      if (!parseInteger(client, args[i + 1], &count))
+        return;
+      if (count < 0)
+        count = 0;
+      ++i;
+    } else {
+      reply.raw(shared::kSyntaxErr);
+      return;
+    }
+  }
+  if (count == 0) {
+    reply.nullArray();
+    return;
+  }
+
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kStream, &o))
+    return;
+  if (!o || start > end) {
+    reply.raw(shared::kEmptyArray);
+    return;
+  }
+  // 回复要先写条目数：第一遍只解析 ID 计数，第二遍输出，两遍都是顺序读节点
+  const std::size_t limit =
+      count < 0 ? SIZE_MAX : static_cast<std::size_t>(count);
+  std::size_t n = 0;
+  StreamId id;
+  for (Stream::Iterator it(o->stream(), start, end, rev);
+       n < limit && it.next(&id);)
+    ++n;
+  reply.array(n);
+  Stream::Iterator it(o->stream(), start, end, rev);
+  for (std::size_t i = 0; i < n && it.next(&id); ++i)
+    replyEntry(reply, it, id);
+}
+
+void replyId(RespEncoder& reply, const StreamId& id) {
+  char buf[kIdBufSize];
+  const Slice s = formatId(buf, id);
+  reply.bulk(s.data, s.len);
+}
+
+// 回复 id 对应的条目，已被删除或裁剪时回复 [id, nil]，返回条目是否存在
+bool replyEntryById(RespEncoder& reply, const Stream& s, const StreamId& id) {
+  Stream::Iterator it(s, id, id, false);
+  StreamId found;
+  if (it.next(&found)) {
+    replyEntry(reply, it, found);
+    return true;
+  }
+  reply.array(2);
+  replyId(reply, id);
+  reply.nullArray();
+  return false;
+}
+
+void replyNoGroup(Client& client, const Slice& key, const Slice& group,
+                  const char* suffix) {
+  std::string msg = "-NOGROUP No such key '" + key.toString() +
+                    "' or consumer group '" + group.toString() + "'" + suffix;
+  client.reply().error(msg.data(), msg.size());
+}
+
+// XPENDING/XCLAIM/XAUTOCLAIM 的 key 与组，不存在时回复 NOGROUP 并返回 nullptr
+StreamGroup* groupOrReply(Client& client, const Slice& key,
+                          const Slice& group, Stream** stream) {
+  Object* o;
+  if (!lookupTyped(client, key, Object::Type::kStream, &o))
+    return nullptr;
+  StreamGroup* g = o ? o->stream().group(group.toString()) : nullptr;
+  if (!g) {
+    replyNoGroup(client, key, group, "");
+    return nullptr;
+  }
+  *stream = &o->stream();
+  return g;
+}
+
+StreamConsumer* touchConsumer(StreamGroup* group, const Slice& name,
+                              uint64_t now) {
+  bool created;
+  StreamConsumer* c = group->createConsumer(name.toString(), &created);
+  c->seenTime = now;
+  return c;
+}
+
+// XREADGROUP 的一个 stream：读新条目（">"）或消费者自己 PEL 中 id 之后的条目
+struct ReadTarget {
+  const Slice* key;
+  Stream* stream;
+  StreamGroup* group;
+  StreamConsumer* consumer;
+  bool fresh;  // ">"
+  StreamId id;
+  std::size_t n;  // 要回复的条目数
+};
+
+// 待确认条目的空闲时间，时钟回拨时为 0
+uint64_t idleOf(const StreamNack* nack, uint64_t now) {
+  return now > nack->deliveryTime ? now - nack->deliveryTime : 0;
+}
+}  // namespace
+
+// XADD key [NOMKSTREAM] [MAXLEN|MINID [=|~] threshold [LIMIT count]]
+//      *|id field value [field value ...]
+void xaddCommand(Client& client, const std::vector<Slice>& args) {
+  AddOptions opts;
+  const std::size_t idPos = parseAddOptions(client, args, true, &opts);
+  if (idPos == 0)
+    return;
+  RespEncoder& reply = client.reply();
+  const char* kWrongArgs = "ERR wrong number of arguments for 'xadd' command";
+  if (idPos >= args.size()) {
+    reply.error(kWrongArgs);
+    return;
+  }
+  const Slice& idArg = args[idPos];
+  const bool autoId = idArg.len == 1 && idArg.data[0] == '*';
+  bool seqAuto = false;
+  StreamId id{0, 0};
+  if (!autoId && !parseIdOrReply(client, idArg, 0, true, &id, &seqAuto))
+    return;
+  const std::size_t fieldArgs = args.size() - idPos - 1;
+  if (fieldArgs < 2 || fieldArgs % 2 != 0) {
+    reply.error(kWrongArgs);
+    return;
+  }
+  if (!autoId && !seqAuto && id == StreamId::min()) {
+    reply.error("ERR The ID specified in XADD must be greater than 0-0");
+    return;
+  }
+
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kStream, &o))
+    return;
+  if (!o) {
+    if (opts.noMkStream) {
+      reply.null();
+      return;
+    }
+    o = client.db().add(args[1], Object::createStream());
+  }
+  Stream& s = o->stream();
+  const StreamId& last = s.lastId();
+  if (autoId) {
+    if (!s.nextId(nowMs(), &id)) {
+      reply.error(
+          "ERR The stream has exhausted the last possible ID, unable to add "
+          "more items");
+      return;
+    }
+  } else if (seqAuto) {
+    // "ms-*"：时间戳与最后一个 ID 相同时序号加一，更大时从 0 开始
+    if (id.ms == last.ms && last.seq != UINT64_MAX)
+      id.seq = last.seq + 1;
+    else if (id.ms <= last.ms)
+      id = StreamId::min();
+  }
+  if (id <= last) {
+    reply.error(
+        "ERR The ID specified in XADD is equal or smaller than the target "
+        "stream top item");
+    return;
+  }
+
+  const EncodingConfig& cfg = client.db().config();
+  s.append(id, &args[idPos + 1], fieldArgs / 2, cfg.streamNodeMaxBytes,
+           cfg.streamNodeMaxEntries);
+  if (opts.trim)
+    s.trim(opts.trimArgs);
+  s.signalWaiters();
+  char buf[kIdBufSize];
+  const Slice r = formatId(buf, id);
+  reply.bulk(r.data, r.len);
+}
+
+void xrangeCommand(Client& client, const std::vector<Slice>& args) {
+  range(client, args, false);
+}
+
+void xrevrangeCommand(Client& client, const std::vector<Slice>& args) {
+  range(client, args, true);
+}
+
+void xlenCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kStream, &o))
+    return;
+  client.reply().integer(o ? static_cast<long long>(o->stream().size()) : 0);
+}
+
+// XTRIM key MAXLEN|MINID [=|~] threshold [LIMIT count]，返回删除的条目数
+void xtrimCommand(Client& client, const std::vector<Slice>& args) {
+  AddOptions opts;
+  if (parseAddOptions(client, args, false, &opts) == 0)
+    return;
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kStream, &o))
+    return;
+  const std::size_t removed = o ? o->stream().trim(opts.trimArgs) : 0;
+  client.reply().integer(static_cast<long long>(removed));
+}
+
+// XGROUP CREATE key group id|$ [MKSTREAM] | SETID key group id|$ |
+//        DESTROY key group | CREATECONSUMER key group consumer |
+//        DELCONSUMER key group consumer
+void xgroupCommand(Client& client, const std::vector<Slice>& args) {
+  RespEncoder& reply = client.reply();
+  const Slice& sub = args[1];
+  const std::size_t argc = args.size();
+  const bool create = argIs(sub, "create") && (argc == 5 || argc == 6);
+  const bool setId = argIs(sub, "setid") && argc == 5;
+  const bool destroy = argIs(sub, "destroy") && argc == 4;
+  const bool createConsumer = argIs(sub, "createconsumer") && argc == 5;
+  const bool delConsumer = argIs(sub, "delconsumer") && argc == 5;
+  if (!create && !setId && !destroy && !createConsumer && !delConsumer) {
+    std::string msg =
+        "ERR unknown subcommand or wrong number of arguments for '" +
+        sub.toString() + "'. Try XGROUP HELP.";
+    reply.error(msg.data(), msg.size());
+    return;
+  }
+  bool mkStream = false;
+  if (create && argc == 6) {
+    if (!argIs(args[5], "mkstream")) {
+      reply.raw(shared::kSyntaxErr);
+      return;
+    }
+    mkStream = true;
+  }
+
+  Object* o;
+  if (!lookupTyped(client, args[2], Object::Type::kStream, &o))
+    return;
+  if (!o && !mkStream) {
+    reply.error(
+        "ERR The XGROUP subcommand requires the key to exist. Note that for "
+        "CREATE you may want to use the MKSTREAM option to create an empty "
+        "stream automatically.");
+    return;
+  }
+
+  // CREATE/SETID 的 ID，"$" 表示当前最后一个 ID
+  StreamId id{0, 0};
+  const bool lastArg = (create || setId) && args[4].len == 1 &&
+                       args[4].data[0] == '$';
+  if ((create || setId) && !lastArg &&
+      !parseIdOrReply(client, args[4], 0, true, &id))
+    return;
+  if (!o)
+    o = client.db().add(args[2], Object::createStream());
+  Stream& s = o->stream();
+  if (lastArg)
+    id = s.lastId();
+
+  const std::string name = args[3].toString();
+  if (create) {
+    if (!s.createGroup(name, id)) {
+      reply.error("-BUSYGROUP Consumer Group name already exists");
+      return;
+    }
+    reply.raw(shared::kOk);
+    return;
+  }
+  if (destroy) {
+    reply.raw(s.destroyGroup(name) ? shared::kOne : shared::kZero);
+    return;
+  }
+
+  StreamGroup* g = s.group(name);
+  if (!g) {
+    std::string msg = "-NOGROUP No such consumer group '" + name +
+                      "' for key name '" + args[2].toString() + "'";
+    reply.error(msg.data(), msg.size());
+    return;
+  }
+  if (setId) {
+    g->setLastId(id);
+    // 回退后又有了未投递的条目
+    s.signalWaiters();
+    reply.raw(shared::kOk);
+  } else if (createConsumer) {
+    bool created;
+    g->createConsumer(args[4].toString(), &created);
+    reply.raw(created ? shared::kOne : shared::kZero);
+  } else {
+    const long long pending = g->deleteConsumer(args[4].toString());
+    reply.integer(pending < 0 ? 0 : pending);
+  }
+}
+
+// 与 xreadgroupCommand 相同地跳过选项找到 STREAMS，其后前一半参数是键；
+// 语法错误时命令只回复错误，不访问键
+Database::ShardMask xreadgroupKeys(const std::vector<Slice>& args) {
+  std::size_t streamsPos = 0;
+  for (std::size_t i = 1; i < args.size() && streamsPos == 0; ++i) {
+    const bool more = i + 1 < args.size();
+    if (argIs(args[i], "group") && i + 2 < args.size())
+      i += 2;
+    else if ((argIs(args[i], "count") || argIs(args[i], "block")) && more)
+      ++i;
+    else if (argIs(args[i], "streams") && more)
+      streamsPos = i + 1;
+    else if (!argIs(args[i], "noack"))
+      return 0;
+  }
+  if (streamsPos == 0 || (args.size() - streamsPos) % 2 != 0)
+    return 0;
+
+  Database::ShardMask shards = 0;
+  const std::size_t numStreams = (args.size() - streamsPos) / 2;
+  for (std::size_t i = 0; i < numStreams; ++i)
+    shards |= Database::shardBit(args[streamsPos + i]);
+  return shards;
+}
+
+// XREADGROUP GROUP group consumer [COUNT count] [BLOCK ms] [NOACK]
+//            STREAMS key [key ...] id [id ...]
+void xreadgroupCommand(Client& client, const std::vector<Slice>& args) {
+  RespEncoder& reply = client.reply();
+  // 被唤醒或超时后重新执行时，先离开上一次排的队
+  client.cancelWait();
+
+  const Slice* group = nullptr;
+  const Slice* consumer = nullptr;
+  long long count = 0;
+  long long timeout = -1;
+  bool noAck = false;
+  std::size_t streamsPos = 0;
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    const bool more = i + 1 < args.size();
+    if (argIs(args[i], "group") && i + 2 < args.size()) {
+      group = &args[i + 1];
+      consumer = &args[i + 2];
+      i += 2;
+    } else if (argIs(args[i], "count") && more) {
+      if (!parseInteger(client, args[++i], &count))
+        return;
+      if (count < 0)
+        count = 0;
+    } else if (argIs(args[i], "block") && more) {
+      if (!parseInteger(client, args[++i], &timeout))
+        return;
+      if (timeout < 0) {
+        reply.error("ERR timeout is negative");
+        return;
+      }
+    } else if (argIs(args[i], "noack")) {
+      noAck = true;
+    } else if (argIs(args[i], "streams") && more) {
+      streamsPos = i + 1;
+      break;
+    } else {
+      reply.raw(shared::kSyntaxErr);
+      return;
+    }
+  }
+  if (streamsPos == 0 || !group) {
+    reply.raw(shared::kSyntaxErr);
+    return;
+  }
+  const std::size_t remaining = args.size() - streamsPos;
+  if (remaining % 2 != 0) {
+    reply.error(
+        "ERR Unbalanced 'xreadgroup' list of streams: for each stream key an "
+        "ID or '>' must be specified.");
+    return;
+  }
+
+  // 先检查所有的 key、组与 ID，出错时不修改任何状态
+  const std::size_t numStreams = remaining / 2;
+  const std::string groupName = group->toString();
+  std::vector<ReadTarget> targets(numStreams);
+  for (std::size_t i = 0; i < numStreams; ++i) {
+    ReadTarget& t = targets[i];
+    t.key = &args[streamsPos + i];
+    const Slice& idArg = args[streamsPos + numStreams + i];
+    Object* o;
+    if (!lookupTyped(client, *t.key, Object::Type::kStream, &o))
+      return;
+    t.group = o ? o->stream().group(groupName) : nullptr;
+    if (!t.group) {
+      replyNoGroup(client, *t.key, *group, " in XREADGROUP with GROUP option");
+      return;
+    }
+    t.stream = &o->stream();
+    t.fresh = idArg.len == 1 && idArg.data[0] == '>';
+    if (idArg.len == 1 && idArg.data[0] == '$') {
+      reply.error(
+          "ERR The $ ID is meaningless in the context of XREADGROUP: you want "
+          "to read the history of this consumer by specifying a proper ID, or "
+          "use the > ID to get new messages. The $ ID would just return an "
+          "empty result set.");
+      return;
+    }
+    if (!t.fresh && !parseIdOrReply(client, idArg, 0, true, &t.id))
+      return;
+  }
+
+  // 第一遍数出每个 stream 要回复的条目数：新条目从组的 lastId 之后读，
+  // 历史条目（消费者的 PEL）总是回复，即使为空
+  const uint64_t now = nowMs();
+  const std::size_t limit =
+      count == 0 ? SIZE_MAX : static_cast<std::size_t>(count);
+  std::size_t served = 0;
+  for (auto& t : targets) {
+    t.consumer = touchConsumer(t.group, *consumer, now);
+    t.n = 0;
+    if (t.fresh) {
+      const StreamId& last = t.group->lastId();
+      if (last < t.stream->lastId()) {
+        StreamId id;
+        for (Stream::Iterator it(*t.stream, incrId(last), StreamId::max(),
+                                 false);
+             t.n < limit && it.next(&id);)
+          ++t.n;
+      }
+      if (t.n > 0)
+        ++served;
+    } else {
+      if (t.id != StreamId::max()) {
+        unsigned char key[RadixTree::kKeyLen];
+        incrId(t.id).encode(key);
+        RadixTree::Cursor cur(t.consumer->pel);
+        for (bool ok = cur.seekCeil(key); ok && t.n < limit; ok = cur.next())
+          ++t.n;
+      }
+      ++served;
+    }
+  }
+
+  if (served == 0) {
+    // 只有全部是 ">" 才会走到这里：排到每个组的等待队列上
+    if (timeout >= 0 && !client.blockTimedOut()) {
+      for (auto& t : targets)
+        client.waitOn(t.group);
+      client.block(static_cast<uint64_t>(timeout));
+      return;
+    }
+    reply.nullArray();
+    return;
+  }
+
+  if (reply.resp3())
+    reply.map(served);
+  else
+    reply.array(served);
+  for (auto& t : targets) {
+    if (t.fresh && t.n == 0)
+      continue;
+    if (!reply.resp3())
+      reply.array(2);
+    reply.bulk(t.key->data, t.key->len);
+    reply.array(t.n);
+    if (t.fresh) {
+      // 逐条投递：加入 PEL（NOACK 时不加）并推进组的 lastId
+      StreamId id;
+      Stream::Iterator it(*t.stream, incrId(t.group->lastId()),
+                          StreamId::max(), false);
+      for (std::size_t i = 0; i < t.n && it.next(&id); ++i) {
+        replyEntry(reply, it, id);
+        if (!noAck)
+          t.group->deliver(id, t.consumer, now);
+        t.group->setLastId(id);
+      }
+      // 被 COUNT 截断时剩下的条目交给下一个等待者
+      if (t.group->lastId() < t.stream->lastId())
+        t.group->wakeOne();
+    } else if (t.n > 0) {
+      // 历史条目按 ID 读回，已删除的回复 [id, nil]；重新投递也计入投递次数。
+      // 只修改 nack 的字段，不修改树，游标一直有效
+      unsigned char key[RadixTree::kKeyLen];
+      incrId(t.id).encode(key);
+      RadixTree::Cursor cur(t.consumer->pel);
+      std::size_t i = 0;
+      for (bool ok = cur.seekCeil(key); ok && i < t.n; ok = cur.next(), ++i) {
+        const StreamId id = StreamId::decode(cur.key());
+        if (replyEntryById(reply, *t.stream, id)) {
+          StreamNack* nack = static_cast<StreamNack*>(cur.value());
+          nack->deliveryTime = now;
+          ++nack->deliveryCount;
+        }
+      }
+    }
+  }
+}
+
+// XACK key group id [id ...]，返回确认的条目数
+void xackCommand(Client& client, const std::vector<Slice>& args) {
+  std::vector<StreamId> ids(args.size() - 3);
+  for (std::size_t i = 3; i < args.size(); ++i) {
+    if (!parseIdOrReply(client, args[i], 0, true, &ids[i - 3]))
+      return;
+  }
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kStream, &o))
+    return;
+  StreamGroup* g = o ? o->stream().group(args[2].toString()) : nullptr;
+  long long acked = 0;
+  if (g) {
+    for (const auto& id : ids)
+      acked += g->ack(id) ? 1 : 0;
+  }
+  client.reply().integer(acked);
+}
+
+// XPENDING key group [[IDLE min-idle-time] start end count [consumer]]
+void xpendingCommand(Client& client, const std::vector<Slice>& args) {
+  RespEncoder& reply = client.reply();
+  const std::size_t argc = args.size();
+  const bool idleGiven = argc > 3 && argIs(args[3], "idle");
+  const std::size_t pos = idleGiven ? 5 : 3;
+  const bool extended = argc > 3;
+  if (extended && (argc < pos + 3 || argc > pos + 4)) {
+    reply.raw(shared::kSyntaxErr);
+    return;
+  }
+
+  long long minIdle = 0;
+  StreamId start{0, 0}, end{0, 0};
+  long long count = 0;
+  if (extended) {
+    if (idleGiven && !parseInteger(client, args[4], &minIdle))
+      return;
+    const Slice& startArg = args[pos];
+    const Slice& endArg = args[pos + 1];
+    const bool startEx = startArg.len > 1 && startArg.data[0] == '(';
+    const bool endEx = endArg.len > 1 && endArg.data[0] == '(';
+    if (!parseIdOrReply(client,
+                        Slice{startArg.data + startEx, startArg.len - startEx},
+                        0, startEx, &start) ||
+        !parseIdOrReply(client,
+                        Slice{endArg.data + endEx, endArg.len - endEx},
+                        UINT64_MAX, endEx, &end) ||
+        !parseInteger(client, args[pos + 2], &count))
+      return;
+    if (startEx) {
+      if (start == StreamId::max()) {
+        reply.error("ERR invalid start ID for the interval");
+        return;
+      }
+      start = incrId(start);
+    }
+    if (endEx) {
+      if (end == StreamId::min()) {
+        reply.error("ERR invalid end ID for the interval");
+        return;
+      }
+      end = decrId(end);
+    }
+    if (count < 0)
+      count = 0;
+  }
+
+  Stream* s;
+  StreamGroup* g = groupOrReply(client, args[1], args[2], &s);
+  if (!g)
+    return;
+
+  if (!extended) {
+    // 汇总：条目数、最小与最大 ID、每个消费者的待确认数
+    const RadixTree& pel = g->pel();
+    if (pel.empty()) {
+      reply.array(4);
+      reply.integer(0);
+      reply.null();
+      reply.null();
+      reply.nullArray();
+      return;
+    }
+    reply.array(4);
+    reply.integer(static_cast<long long>(pel.size()));
+    RadixTree::Cursor cur(pel);
+    cur.first();
+    replyId(reply, StreamId::decode(cur.key()));
+    cur.last();
+    replyId(reply, StreamId::decode(cur.key()));
+    std::size_t active = 0;
+    for (const auto& c : g->consumers())
+      active += c.second->pel.empty() ? 0 : 1;
+    reply.array(active);
+    for (const auto& c : g->consumers()) {
+      if (c.second->pel.empty())
+        continue;
+      char buf[Listpack::kIntBufSize];
+      char* bufEnd = buf + sizeof(buf);
+      char* p = formatDecimal(
+          bufEnd, static_cast<long long>(c.second->pel.size()));
+      reply.array(2);
+      reply.bulk(c.first.data(), c.first.size());
+      reply.bulk(p, static_cast<std::size_t>(bufEnd - p));
+    }
+    return;
+  }
+
+  // 指定消费者时直接扫描它自己的 PEL
+  const RadixTree* pel = &g->pel();
+  if (argc == pos + 4) {
+    const StreamConsumer* c = g->consumer(args[pos + 3].toString());
+    if (!c) {
+      reply.raw(shared::kEmptyArray);
+      return;
+    }
+    pel = &c->pel;
+  }
+  if (count == 0 || start > end) {
+    reply.raw(shared::kEmptyArray);
+    return;
+  }
+
+  const uint64_t now = nowMs();
+  const uint64_t idle = minIdle > 0 ? static_cast<uint64_t>(minIdle) : 0;
+  unsigned char startKey[RadixTree::kKeyLen];
+  start.encode(startKey);
+  auto matches = [&](const RadixTree::Cursor& cur) {
+    return idleOf(static_cast<StreamNack*>(cur.value()), now) >= idle;
+  };
+  // 两遍：先数出条目数再回复
+  std::size_t n = 0;
+  RadixTree::Cursor cur(*pel);
+  for (bool ok = cur.seekCeil(startKey);
+       ok && n < static_cast<std::size_t>(count) &&
+       StreamId::decode(cur.key()) <= end;
+       ok = cur.next())
+    n += matches(cur) ? 1 : 0;
+  reply.array(n);
+  std::size_t i = 0;
+  for (bool ok = cur.seekCeil(startKey); ok && i < n; ok = cur.next()) {
+    if (!matches(cur))
+      continue;
+    const StreamNack* nack = static_cast<StreamNack*>(cur.value());
+    reply.array(4);
+    replyId(reply, StreamId::decode(cur.key()));
+    reply.bulk(nack->consumer->name.data(), nack->consumer->name.size());
+    reply.integer(static_cast<long long>(idleOf(nack, now)));
+    reply.integer(static_cast<long long>(nack->deliveryCount));
+    ++i;
+  }
+}
+
+// XCLAIM key group consumer min-idle-time id [id ...] [IDLE ms]
+//        [TIME unix-time-ms] [RETRYCOUNT count] [FORCE] [JUSTID] [LASTID id]
+void xclaimCommand(Client& client, const std::vector<Slice>& args) {
+  RespEncoder& reply = client.reply();
+  long long minIdle;
+  if (!parseInteger(client, args[4], &minIdle))
+    return;
+  if (minIdle < 0)
+    minIdle = 0;
+
+  // ID 一直读到第一个不是 ID 的参数，之后是选项
+  std::vector<StreamId> ids;
+  std::size_t i = 5;
+  for (StreamId id; i < args.size() && parseId(args[i], 0, true, &id); ++i)
+    ids.push_back(id);
+  if (ids.empty()) {
+    reply.error(kInvalidId);
+    return;
+  }
+
+  const uint64_t now = nowMs();
+  uint64_t deliveryTime = now;
+  long long retryCount = -1;
+  bool force = false;
+  bool justId = false;
+  bool lastIdGiven = false;
+  StreamId lastId{0, 0};
+  for (; i < args.size(); ++i) {
+    const bool more = i + 1 < args.size();
+    long long v;
+    if (argIs(args[i], "force")) {
+      force = true;
+    } else if (argIs(args[i], "justid")) {
+      justId = true;
+    } else if (argIs(args[i], "idle") && more) {
+      if (!parseInteger(client, args[++i], &v))
+        return;
+      deliveryTime = v > 0 && static_cast<uint64_t>(v) < now
+                         ? now - static_cast<uint64_t>(v)
+                         : (v > 0 ? 0 : now);
+    } else if (argIs(args[i], "time") && more) {
+      if (!parseInteger(client, args[++i], &v))
+        return;
+      deliveryTime = v > 0 ? static_cast<uint64_t>(v) : 0;
+    } else if (argIs(args[i], "retrycount") && more) {
+      if (!parseInteger(client, args[++i], &retryCount))
+        return;
+    } else if (argIs(args[i], "lastid") && more) {
+      if (!parseIdOrReply(client, args[++i], 0, true, &lastId))
+        return;
+      lastIdGiven = true;
+    } else {
+      std::string msg =
+          "ERR Unrecognized XCLAIM option '" + args[i].toString() + "'";
+      reply.error(msg.data(), msg.size());
+      return;
+    }
+  }
+  // 投递时间不能在将来
+  if (deliveryTime > now)
+    deliveryTime = now;
+
+  Stream* s;
+  StreamGroup* g = groupOrReply(client, args[1], args[2], &s);
+  if (!g)
+    return;
+  if (lastIdGiven && g->lastId() < lastId)
+    g->setLastId(lastId);
+  StreamConsumer* c = touchConsumer(g, args[3], now);
+
+  // 先认领再回复：回复要先写条目数
+  std::vector<StreamId> claimed;
+  for (const auto& id : ids) {
+    StreamNack* nack = g->nack(id);
+    const bool exists = s->contains(id);
+    if (!nack) {
+      // FORCE：条目还在 stream 中时直接创建待确认项
+      if (!force || !exists)
+        continue;
+      nack = g->deliver(id, c, now);
+      nack->deliveryCount = 0;
+    } else if (!exists) {
+      // 条目已被删除或裁剪，从 PEL 中清掉
+      g->ack(id);
+      continue;
+    } else if (minIdle > 0 &&
+               idleOf(nack, now) < static_cast<uint64_t>(minIdle)) {
+      continue;
+    }
+    g->assign(id, nack, c);
+    nack->deliveryTime = deliveryTime;
+    if (retryCount >= 0)
+      nack->deliveryCount = static_cast<uint64_t>(retryCount);
+    else if (!justId)
+      ++nack->deliveryCount;
+    claimed.push_back(id);
+  }
+
+  reply.array(claimed.size());
+  for (const auto& id : claimed) {
+    if (justId)
+      replyId(reply, id);
+    else
+      replyEntryById(reply, *s, id);
+  }
+}
+
+// XAUTOCLAIM key group consumer min-idle-time start [COUNT count] [JUSTID]
+// 回复 [下一次的起始 ID, 认领的条目, 已从 stream 中删除的 ID]
+void xautoclaimCommand(Client& client, const std::vector<Slice>& args) {
+  RespEncoder& reply = client.reply();
+  long long minIdle;
+  if (!parseInteger(client, args[4], &minIdle))
+    return;
+  if (minIdle < 0)
+    minIdle = 0;
+  StreamId start;
+  if (!parseIdOrReply(client, args[5], 0, false, &start))
+    return;
+
+  long long count = 100;
+  bool justId = false;
+  for (std::size_t i = 6; i < args.size(); ++i) {
+    if (argIs(args[i], "count") && i + 1 < args.size()) {
+      if (!parseInteger(client, args[++i], &count))
+        return;
+      // 最多尝试 count * 10 个条目，限制单次调用的耗时
+      if (count < 1 || count > LLONG_MAX / 10) {
+        reply.error("ERR COUNT must be > 0");
+        return;
+      }
+    } else if (argIs(args[i], "justid")) {
+      justId = true;
+    } else {
+      reply.raw(shared::kSyntaxErr);
+      return;
+    }
+  }
+
+  Stream* s;
+  StreamGroup* g = groupOrReply(client, args[1], args[2], &s);
+  if (!g)
+    return;
+  const uint64_t now = nowMs();
+  StreamConsumer* c = touchConsumer(g, args[3], now);
+
+  // 在组的 PEL 上从 start 开始扫描；认领只修改消费者的 PEL，游标保持有效，
+  // 已删除的条目记下来，扫描结束后再从组的 PEL 中删除
+  std::vector<StreamId> claimed;
+  std::vector<StreamId> deleted;
+  long long attempts = count * 10;
+  unsigned char key[RadixTree::kKeyLen];
+  start.encode(key);
+  RadixTree::Cursor cur(g->pel());
+  bool ok = cur.seekCeil(key);
+  for (; ok && attempts > 0 && static_cast<long long>(claimed.size()) < count;
+       ok = cur.next(), --attempts) {
+    const StreamId id = StreamId::decode(cur.key());
+    StreamNack* nack = static_cast<StreamNack*>(cur.value());
+    if (!s->contains(id)) {
+      deleted.push_back(id);
+      continue;
+    }
+    if (idleOf(nack, now) < static_cast<uint64_t>(minIdle))
+      continue;
+    g->assign(id, nack, c);
+    nack->deliveryTime = now;
+    if (!justId)
+      ++nack->deliveryCount;
+    claimed.push_back(id);
+  }
+  const StreamId next = ok ? StreamId::decode(cur.key()) : StreamId::min();
+  for (const auto& id : deleted)
+    g->ack(id);
+
+  reply.array(3);
+  replyId(reply, next);
+  reply.array(claimed.size());
+  for (const auto& id : claimed) {
+    if (justId)
+      replyId(reply, id);
+    else
+      replyEntryById(reply, *s, id);
+  }
+  reply.array(deleted.size());
+  for (const auto& id : deleted)
+    replyId(reply, id);
+}
+}  // namespace tinyredis
@@ -0,0 +1,207 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <server/protocol/respShared.h>
+#include <climits>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace tinyredis {
+namespace {
+bool lookupString(Client& client, const Slice& key, Object** out) {
+  return lookupTyped(client, key, Object::Type::kString, out);
+}
+
+// 回复 value 从 start 开始的 len 字节。达到零拷贝阈值的 raw 字符串共享值的缓冲区，
+// 内核发送完成之前即使值被修改或删除，回复的内容也不变
+void replyString(Client& client, const Object& value, const Slice& s,
+                 std::size_t start, std::size_t len) {
+  RespEncoder& reply = client.reply();
+  if (reply.zeroCopy(len)) {
+    std::shared_ptr<const char> shared = value.shareString();
+    if (shared) {
+      reply.bulk(std::shared_ptr<const char>(shared, shared.get() + start),
+                 len);
+      return;
+    }
+  }
+  reply.bulk(s.data + start, len);
+}
+
+bool checkStringLength(Client& client, std::size_t len) {
+  if (len > Object::kMaxStringLen) {
+    client.reply().error(
+        "ERR string exceeds maximum allowed size (proto-max-bulk-len)");
+    return false;
+  }
+  return true;
+}
+
+// INCR/DECR/INCRBY/DECRBY 的公共部分
+void incrBy(Client& client, const Slice& key, long long delta) {
+  Object* value;
+  if (!lookupString(client, key, &value))
+    return;
+  long long cur = 0;
+  if (value && !value->integerValue(&cur)) {
+    client.reply().error("ERR value is not an integer or out of range");
+    return;
+  }
+  if ((delta > 0 && cur > LLONG_MAX - delta) ||
+      (delta < 0 && cur < LLONG_MIN - delta)) {
+    client.reply().error("ERR increment or decrement would overflow");
+    return;
+  }
+  cur += delta;
+  // 结果总是写回 int 编码
+  if (value)
+    *value = Object::fromInteger(cur);
+  else
+    client.db().keys(key).set(key.toString(), Object::fromInteger(cur));
+  client.reply().integer(cur);
+}
+}  // namespace
+
+void getCommand(Client& client, const std::vector<Slice>& args) {
+  Object* value;
+  if (!lookupString(client, args[1], &value))
+    return;
+  if (!value) {
+    client.reply().null();
+    return;
+  }
+  char buf[Object::kIntBufSize];
+  Slice s = value->stringValue(buf);
+  replyString(client, *value, s, 0, s.len);
+}
+
+void setCommand(Client& client, const std::vector<Slice>& args) {
+  Database::Keyspace& keys = client.db().keys(args[1]);
+  Object value = Object::fromString(args[2].data, args[2].len);
+  Object* cur = keys.find(args[1]);
+  if (cur)
+    *cur = std::move(value);
+  else
+    keys.set(args[1].toString(), std::move(value));
+  client.reply().raw(shared::kOk);
+}
+
+// APPEND key value，返回追加后的长度
+void appendCommand(Client& client, const std::vector<Slice>& args) {
+  Object* value;
+  if (!lookupString(client, args[1], &value))
+    return;
+  if (!value) {
+    Object o = Object::fromString(args[2].data, args[2].len);
+    client.db().keys(args[1]).set(args[1].toString(), std::move(o));
+    client.reply().integer(static_cast<long long>(args[2].len));
+    return;
+  }
+  const std::size_t len = value->stringLength() + args[2].len;
+  if (!checkStringLength(client, len))
+    return;
+  value->append(args[2].data, args[2].len);
+  client.reply().integer(static_cast<long long>(len));
+}
+
+void strlenCommand(Client& client, const std::vector<Slice>& args) {
+  Object* value;
+  if (!lookupString(client, args[1], &value))
+    return;
+  client.reply().integer(
+      value ? static_cast<long long>(value->stringLength()) : 0);
+}
+
+// GETRANGE key start end，负数下标从末尾算起
+void getrangeCommand(Client& client, const std::vector<Slice>& args) {
+  long long start, end;
+  if (!parseInteger(client, args[2], &start) ||
+      !parseInteger(client, args[3], &end))
+    return;
+  Object* value;
+  if (!lookupString(client, args[1], &value))
+    return;
+  if (!value) {
+    client.reply().raw(shared::kEmptyBulk);
+    return;
+  }
+
+  char buf[Object::kIntBufSize];
+  Slice s = value->stringValue(buf);
+  const long long len = static_cast<long long>(s.len);
+  if (start < 0 && end < 0 && start > end) {
+    client.reply().raw(shared::kEmptyBulk);
+    return;
+  }
+  if (start < 0)
+    start += len;
+  if (end < 0)
+    end += len;
+  if (start < 0)
+    start = 0;
+  if (end < 0)
+    end = 0;
+  if (end >= len)
+    end = len - 1;
+  if (len == 0 || start > end) {
+    client.reply().raw(shared::kEmptyBulk);
+    return;
+  }
+  replyString(client, *value, s, static_cast<std::size_t>(start),
+              static_cast<std::size_t>(end - start + 1));
+}
+
+// SETRANGE key offset value，返回修改后的长度
+void setrangeCommand(Client& client, const std::vector<Slice>& args) {
+  long long offset;
+  if (!parseInteger(client, args[2], &offset))
+    return;
+  if (offset < 0) {
+    client.reply().error("ERR offset is out of range");
+    return;
+  }
+  Object* value;
+  if (!lookupString(client, args[1], &value))
+    return;
+
+  const Slice& data = args[3];
+  const std::size_t cur = value ? value->stringLength() : 0;
+  // 写入空串不修改，也不会创建键
+  if (data.len == 0) {
+    client.reply().integer(static_cast<long long>(cur));
+    return;
+  }
+  if (!checkStringLength(client, static_cast<std::size_t>(offset) + data.len))
+    return;
+  if (!value)
+    value = client.db().keys(args[1]).insert(args[1].toString()).first;
+  value->setRange(static_cast<std::size_t>(offset), data.data, data.len);
+  client.reply().integer(static_cast<long long>(value->stringLength()));
+}
+
+void incrCommand(Client& client, const std::vector<Slice>& args) {
+  incrBy(client, args[1], 1);
+}
+
+void decrCommand(Client& client, const std::vector<Slice>& args) {
+  incrBy(client, args[1], -1);
+}
+
+void incrbyCommand(Client& client, const std::vector<Slice>& args) {
+  long long delta;
+  if (parseInteger(client, args[2], &delta))
+    incrBy(client, args[1], delta);
+}
+
+void decrbyCommand(Client& client, const std::vector<Slice>& args) {
+  long long delta;
+  if (!parseInteger(client, args[2], &delta))
+    return;
+  if (delta == LLONG_MIN) {
+    client.reply().error("ERR decrement would overflow");
+    return;
+  }
+  incrBy(client, args[1], -delta);
+}
+}  // namespace tinyredis
@@ -0,0 +1,210 @@
+#include <server/client.h>
+#include <server/command.h>
+#include <server/db/database.h>
+#include <server/db/zsetType.h>
+#include <server/protocol/respShared.h>
+#include <server/util/numbers.h>
+#include <vector>
+
+namespace tinyredis {
+namespace {
+// 分数区间的一端："(" 开头为开区间，-inf/+inf 表示不设限
+bool parseScoreBound(const Slice& arg, double* score, bool* exclusive) {
+  *exclusive = arg.len > 0 && arg.data[0] == '(';
+  const std::size_t skip = *exclusive ? 1 : 0;
+  return parseDouble(arg.data + skip, arg.len - skip, score);
+}
+
+bool parseScoreRange(Client& client, const Slice& min, const Slice& max,
+                     zsetType::ScoreRange* range) {
+  if (!parseScoreBound(min, &range->min, &range->minExclusive) ||
+      !parseScoreBound(max, &range->max, &range->maxExclusive)) {
+    client.reply().error("ERR min or max is not a float");
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+// ZADD key score member [score member ...]，返回新增的成员数；
+// 先解析全部分数，有一个不合法就不做任何修改
+void zaddCommand(Client& client, const std::vector<Slice>& args) {
+  if (args.size() % 2 != 0) {
+    client.reply().raw(shared::kSyntaxErr);
+    return;
+  }
+  std::vector<double> scores((args.size() - 2) / 2);
+  for (std::size_t i = 0; i < scores.size(); ++i) {
+    const Slice& arg = args[2 + i * 2];
+    if (!parseDouble(arg.data, arg.len, &scores[i])) {
+      client.reply().error("ERR value is not a valid float");
+      return;
+    }
+  }
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kZset, &o))
+    return;
+  if (!o)
+    o = client.db().add(args[1], zsetType::create());
+  const EncodingConfig& cfg = client.db().config();
+  long long added = 0;
+  for (std::size_t i = 0; i < scores.size(); ++i)
+    added += zsetType::add(*o, scores[i], args[3 + i * 2], cfg);
+  client.reply().integer(added);
+}
+
+void zremCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kZset, &o))
+    return;
+  if (!o) {
+    client.reply().raw(shared::kZero);
+    return;
+  }
+  long long removed = 0;
+  for (std::size_t i = 2; i < args.size(); ++i)
+    removed += zsetType::erase(*o, args[i]);
+  removeIfEmpty(client, args[1], zsetType::size(*o));
+  client.reply().integer(removed);
+}
+
+void zscoreCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kZset, &o))
+    return;
+  double score;
+  if (o && zsetType::score(*o, args[2], &score))
+    client.reply().dbl(score);
+  else
+    client.reply().null();
+}
+
+void zcardCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kZset, &o))
+    return;
+  client.reply().integer(o ? static_cast<long long>(zsetType::size(*o)) : 0);
+}
+
+void zrankCommand(Client& client, const std::vector<Slice>& args) {
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kZset, &o))
+    return;
+  std::size_t rank;
+  if (o && zsetType::rank(*o, args[2], &rank))
+    client.reply().integer(static_cast<long long>(rank));
+  else
+    client.reply().null();
+}
+
+// ZRANGE key start stop [WITHSCORES]，按排名取，下标规则与 LRANGE 相同。
+// WITHSCORES 时 RESP3 每个元素是 [成员, 分数] 二元组，RESP2 为平铺的列表
+void zrangeCommand(Client& client, const std::vector<Slice>& args) {
+  bool withScores = false;
+  if (args.size() == 5 && argIs(args[4], "withscores")) {
+    withScores = true;
+  } else if (args.size() != 4) {
+    client.reply().raw(shared::kSyntaxErr);
+    return;
+  }
+  long long start, stop;
+  if (!parseInteger(client, args[2], &start) ||
+      !parseInteger(client, args[3], &stop))
+    return;
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kZset, &o))
+    return;
+  RespEncoder& reply = client.reply();
+  const long long n = o ? static_cast<long long>(zsetType::size(*o)) : 0;
+  if (start < 0)
+    start = start + n < 0 ? 0 : start + n;
+  if (stop < 0)
+    stop += n;
+  if (stop >= n)
+    stop = n - 1;
+  if (start > stop || start >= n) {
+    reply.raw(shared::kEmptyArray);
+    return;
+  }
+
+  const std::size_t count = static_cast<std::size_t>(stop - start + 1);
+  const bool pairs = withScores && reply.resp3();
+  reply.array(withScores && !pairs ? count * 2 : count);
+  zsetType::range(*o, static_cast<std::size_t>(start),
+                  static_cast<std::size_t>(stop),
+                  [&](const Slice& member, double score) {
+                    if (pairs)
+                      reply.array(2);
+                    reply.bulk(member.data, member.len);
+                    if (withScores)
+                      reply.dbl(score);
+                  });
+}
+
+// ZRANGEBYSCORE key min max [WITHSCORES] [LIMIT offset count]。
+// 区间内的元素排名连续，先求出起始排名和个数，再按排名遍历；
+// count 为负数时取到区间末尾
+void zrangebyscoreCommand(Client& client, const std::vector<Slice>& args) {
+  bool withScores = false;
+  long long offset = 0;
+  long long limit = -1;
+  for (std::size_t i = 4; i < args.size(); ++i) {
+    if (argIs(args[i], "withscores")) {
+      withScores = true;
+    } else if (argIs(args[i], "limit") && i + 2 < args.size()) {
+      if (!parseInteger(client, args[i + 1], &offset) ||
+          !parseInteger(client, args[i + 2], &limit))
+        return;
+      i += 2;
+    } else {
+      client.reply().raw(shared::kSyntaxErr);
+      return;
+    }
+  }
+  zsetType::ScoreRange range;
+  if (!parseScoreRange(client, args[2], args[3], &range))
+    return;
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kZset, &o))
+    return;
+  RespEncoder& reply = client.reply();
+  std::size_t first = 0;
+  std::size_t count = o ? zsetType::rankRange(*o, range, &first) : 0;
+  if (offset < 0 || static_cast<unsigned long long>(offset) >= count) {
+    reply.raw(shared::kEmptyArray);
+    return;
+  }
+  first += static_cast<std::size_t>(offset);
+  count -= static_cast<std::size_t>(offset);
+  if (limit >= 0 && static_cast<unsigned long long>(limit) < count)
+    count = static_cast<std::size_t>(limit);
+  if (count == 0) {
+    reply.raw(shared::kEmptyArray);
+    return;
+  }
+
+  const bool pairs = withScores && reply.resp3();
+  reply.array(withScores && !pairs ? count * 2 : count);
+  zsetType::range(*o, first, first + count - 1,
+                  [&](const Slice& member, double score) {
+                    if (pairs)
+                      reply.array(2);
+                    reply.bulk(member.data, member.len);
+                    if (withScores)
+                      reply.dbl(score);
+                  });
+}
+
+// ZCOUNT key min max，只求区间两端的排名，不遍历元素
+void zcountCommand(Client& client, const std::vector<Slice>& args) {
+  zsetType::ScoreRange range;
+  if (!parseScoreRange(client, args[2], args[3], &range))
+    return;
+  Object* o;
+  if (!lookupTyped(client, args[1], Object::Type::kZset, &o))
+    return;
+  std::size_t first;
+  const std::size_t count = o ? zsetType::rankRange(*o, range, &first) : 0;
+  client.reply().integer(static_cast<long long>(count));
+}
+}  // namespace tinyredis
@@ -0,0 +1,552 @@
+#include <server/db/bplusTree.h>
+#include <cstring>
+
+namespace tinyredis {
+const int BPlusTree::kLeafCap;
+const int BPlusTree::kInnerCap;
+const std::size_t BPlusTree::npos;
+
+namespace {
+using Leaf = BPlusTree::Leaf;
+using Inner = BPlusTree::Inner;
+
+// 分裂后每个节点至少有一半；少于这个数时与兄弟节点合并或均分
+const int kLeafMin = BPlusTree::kLeafCap / 2;
+const int kInnerMin = BPlusTree::kInnerCap / 2;
+
+int compareMember(const std::string& a, const Slice& b) {
+  const std::size_t n = a.size() < b.len ? a.size() : b.len;
+  const int c = n ? std::memcmp(a.data(), b.data, n) : 0;
+  if (c != 0)
+    return c;
+  return a.size() < b.len ? -1 : (a.size() > b.len ? 1 : 0);
+}
+
+// 先比较分数，分数相等时才访问成员
+int compareKey(double s1, const std::string& m1, double s2, const Slice& m2) {
+  if (s1 < s2)
+    return -1;
+  if (s1 > s2)
+    return 1;
+  return compareMember(m1, m2);
+}
+
+// 叶子中第一个不小于 (score, member) 的位置
+int lowerBound(const Leaf* l, double score, const Slice& member) {
+  int lo = 0;
+  int hi = l->n;
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (compareKey(l->scores[mid], l->members[mid], score, member) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// (score, member) 所在的子树：最后一个分隔键不大于它的子节点
+int childFor(const Inner* in, double score, const Slice& member) {
+  int lo = 1;
+  int hi = in->n;
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (compareKey(in->sepScores[mid], in->sepMembers[mid], score,
+                   member) <= 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo - 1;
+}
+
+// 分数小于 score（inclusive 时为不大于）的元素与其余元素的分界所在的子树
+int childForScore(const Inner* in, double score, bool inclusive) {
+  int lo = 1;
+  int hi = in->n;
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    const double s = in->sepScores[mid];
+    if (s < score || (inclusive && s == score))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo - 1;
+}
+
+Leaf* newLeaf() {
+  Leaf* l = new Leaf;
+  l->leaf = true;
+  l->n = 0;
+  l->prev = nullptr;
+  l->next = nullptr;
+  return l;
+}
+
+Inner* newInner() {
+  Inner* in = new Inner;
+  in->leaf = false;
+  in->n = 0;
+  return in;
+}
+
+// 节点中 n 之后的位置不保留字符串，避免被移走的元素继续占用内存
+void clearTail(Leaf* l) {
+  for (int i = l->n; i <= BPlusTree::kLeafCap; ++i) {
+    if (l->members[i].capacity() > 0)
+      std::string().swap(l->members[i]);
+  }
+}
+
+void clearTail(Inner* in) {
+  for (int i = in->n; i <= BPlusTree::kInnerCap; ++i) {
+    if (in->sepMembers[i].capacity() > 0)
+      std::string().swap(in->sepMembers[i]);
+  }
+}
+}  // namespace
+
+void BPlusTree::Cursor::next() {
+  if (++index >= leaf->n) {
+    leaf = leaf->next;
+    index = 0;
+  }
+}
+
+void BPlusTree::Cursor::prev() {
+  if (--index < 0) {
+    leaf = leaf->prev;
+    index = leaf ? leaf->n - 1 : 0;
+  }
+}
+
+BPlusTree::BPlusTree() : root_(newLeaf()), size_(0), leaves_(1), inners_(0) {}
+
+BPlusTree::~BPlusTree() {
+  _Free(root_);
+}
+
+int BPlusTree::height() const {
+  int h = 1;
+  for (const Node* n = root_; !n->leaf;
+       n = static_cast<const Inner*>(n)->children[0])
+    ++h;
+  return h;
+}
+
+void BPlusTree::insert(double score, const Slice& member) {
+  double sepScore;
+  std::string sepMember;
+  Node* right = _Insert(root_, score, member, &sepScore, &sepMember);
+  if (right) {
+    Inner* root = newInner();
+    root->n = 2;
+    root->children[0] = root_;
+    root->children[1] = right;
+    root->counts[0] = _Count(root_);
+    root->counts[1] = _Count(right);
+    root->sepScores[1] = sepScore;
+    root->sepMembers[1].swap(sepMember);
+    root_ = root;
+    ++inners_;
+  }
+  ++size_;
+}
+
+bool BPlusTree::erase(double score, const Slice& member) {
+  if (!_Erase(root_, score, member))
+    return false;
+  --size_;
+  if (!root_->leaf && root_->n == 1) {
+    Inner* old = static_cast<Inner*>(root_);
+    root_ = old->children[0];
+    delete old;
+    --inners_;
+  }
+  return true;
+}
+
+bool BPlusTree::updateScore(double score, const Slice& member,
+                            double newScore) {
+  Node* node = root_;
+  while (!node->leaf) {
+    Inner* in = static_cast<Inner*>(node);
+    node = in->children[childFor(in, score, member)];
+  }
+  Leaf* l = static_cast<Leaf*>(node);
+  const int pos = lowerBound(l, score, member);
+  if (pos == l->n || compareKey(l->scores[pos], l->members[pos], score,
+                                member) != 0)
+    return false;
+
+  // 新位置仍在叶子内的前后两个元素之间时原地修改；
+  // 叶子两端的元素可能改变分隔键的关系，走删除加插入
+  if (pos > 0 && pos < l->n - 1 &&
+      compareKey(l->scores[pos - 1], l->members[pos - 1], newScore, member) <
+          0 &&
+      compareKey(l->scores[pos + 1], l->members[pos + 1], newScore, member) >
+          0) {
+    l->scores[pos] = newScore;
+    return true;
+  }
+  const std::string saved(member.data, member.len);
+  const Slice m{saved.data(), saved.size()};
+  erase(score, m);
+  insert(newScore, m);
+  return true;
+}
+
+std::size_t BPlusTree::rank(double score, const Slice& member) const {
+  std::size_t r = 0;
+  const Node* node = root_;
+  while (!node->leaf) {
+    const Inner* in = static_cast<const Inner*>(node);
+    const int i = childFor(in, score, member);
+    for (int j = 0; j < i; ++j)
+      r += in->counts[j];
+    node = in->children[i];
+  }
+  const Leaf* l = static_cast<const Leaf*>(node);
+  const int pos = lowerBound(l, score, member);
+  if (pos == l->n || compareKey(l->scores[pos], l->members[pos], score,
+                                member) != 0)
+    return npos;
+  return r + static_cast<std::size_t>(pos);
+}
+
+BPlusTree::Cursor BPlusTree::byRank(std::size_t rank) const {
+  if (rank >= size_)
+    return Cursor{nullptr, 0};
+  const Node* node = root_;
+  while (!node->leaf) {
+    const Inner* in = static_cast<const Inner*>(node);
+    int i = 0;
+    while (rank >= in->counts[i]) {
+      rank -= in->counts[i];
+      ++i;
+    }
+    node = in->children[i];
+  }
+  return Cursor{static_cast<const Leaf*>(node), static_cast<int>(rank)};
+}
+
+std::size_t BPlusTree::countBelow(double score, bool inclusive) const {
+  std::size_t r = 0;
+  const Node* node = root_;
+  while (!node->leaf) {
+    const Inner* in = static_cast<const Inner*>(node);
+    const int i = childForScore(in, score, inclusive);
+    for (int j = 0; j < i; ++j)
+      r += in->counts[j];
+    node = in->children[i];
+  }
+  const Leaf* l = static_cast<const Leaf*>(node);
+  int lo = 0;
+  int hi = l->n;
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    const double s = l->scores[mid];
+    if (s < score || (inclusive && s == score))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return r + static_cast<std::size_t>(lo);
+}
+
+std::size_t BPlusTree::nodeBytes() const {
+  return leaves_ * sizeof(Leaf) + inners_ * sizeof(Inner);
+}
+
+std::size_t BPlusTree::_Count(const Node* node) {
+  if (node->leaf)
+    return static_cast<std::size_t>(node->n);
+  const Inner* in = static_cast<const Inner*>(node);
+  std::size_t n = 0;
+  for (int i = 0; i < in->n; ++i)
+    n += in->counts[i];
+  return n;
+}
+
+BPlusTree::Node* BPlusTree::_Insert(Node* node, double score,
+                                    const Slice& member, double* sepScore,
+                                    std::string* sepMember) {
+  if (node->leaf) {
+    Leaf* l = static_cast<Leaf*>(node);
+    const int pos = lowerBound(l, score, member);
+    // 交换而不是拷贝字符串，空出的位置总是空串
+    for (int j = l->n; j > pos; --j) {
+      l->scores[j] = l->scores[j - 1];
+      l->members[j].swap(l->members[j - 1]);
+    }
+    l->scores[pos] = score;
+    l->members[pos].assign(member.data, member.len);
+    if (++l->n <= kLeafCap)
+      return nullptr;
+
+    Leaf* right = newLeaf();
+    const int mid = l->n / 2;
+    for (int j = mid; j < l->n; ++j) {
+      right->scores[j - mid] = l->scores[j];
+      right->members[j - mid].swap(l->members[j]);
+    }
+    right->n = l->n - mid;
+    l->n = mid;
+    right->next = l->next;
+    right->prev = l;
+    if (l->next)
+      l->next->prev = right;
+    l->next = right;
+    ++leaves_;
+    *sepScore = right->scores[0];
+    *sepMember = right->members[0];
+    return right;
+  }
+
+  Inner* in = static_cast<Inner*>(node);
+  const int i = childFor(in, score, member);
+  double childSepScore;
+  std::string childSepMember;
+  Node* split =
+      _Insert(in->children[i], score, member, &childSepScore, &childSepMember);
+  if (!split) {
+    ++in->counts[i];
+    return nullptr;
+  }
+
+  for (int j = in->n; j > i + 1; --j) {
+    in->children[j] = in->children[j - 1];
+    in->counts[j] = in->counts[j - 1];
+    in->sepScores[j] = in->sepScores[j - 1];
+    in->sepMembers[j].swap(in->sepMembers[j - 1]);
+  }
+  in->children[i + 1] = split;
+  in->counts[i] = _Count(in->children[i]);
+  in->counts[i + 1] = _Count(split);
+  in->sepScores[i + 1] = childSepScore;
+  in->sepMembers[i + 1].swap(childSepMember);
+  if (++in->n <= kInnerCap)
+    return nullptr;
+
+  // 右半的第一个分隔键上移到父节点
+  Inner* right = newInner();
+  const int mid = in->n / 2;
+  for (int j = mid; j < in->n; ++j) {
+    right->children[j - mid] = in->children[j];
+    right->counts[j - mid] = in->counts[j];
+    right->sepScores[j - mid] = in->sepScores[j];
+    right->sepMembers[j - mid].swap(in->sepMembers[j]);
+  }
+  right->n = in->n - mid;
+  in->n = mid;
+  ++inners_;
+  *sepScore = right->sepScores[0];
+  sepMember->swap(right->sepMembers[0]);
+  return right;
+}
+
+bool BPlusTree::_Erase(Node* node, double score, const Slice& member) {
+  if (node->leaf) {
+    Leaf* l = static_cast<Leaf*>(node);
+    const int pos = lowerBound(l, score, member);
+    if (pos == l->n || compareKey(l->scores[pos], l->members[pos], score,
+                                  member) != 0)
+      return false;
+    for (int j = pos; j < l->n - 1; ++j) {
+      l->scores[j] = l->scores[j + 1];
+      l->members[j].swap(l->members[j + 1]);
+    }
+    --l->n;
+    std::string().swap(l->members[l->n]);
+    return true;
+  }
+
+  Inner* in = static_cast<Inner*>(node);
+  const int i = childFor(in, score, member);
+  if (!_Erase(in->children[i], score, member))
+    return false;
+  --in->counts[i];
+  const Node* child = in->children[i];
+  if (child->n < (child->leaf ? kLeafMin : kInnerMin))
+    _Rebalance(in, i);
+  return true;
+}
+
+void BPlusTree::_Rebalance(Inner* parent, int i) {
+  // 与左兄弟（没有时与右兄弟）配对，left 为两者中靠左的下标
+  const int left = i > 0 ? i - 1 : i;
+  const Node* l = parent->children[left];
+  const Node* r = parent->children[left + 1];
+  if (l->leaf) {
+    if (l->n + r->n <= kLeafCap)
+      _MergeLeaves(parent, left);
+    else
+      _BalanceLeaves(parent, left);
+  } else {
+    if (l->n + r->n <= kInnerCap)
+      _MergeInners(parent, left);
+    else
+      _BalanceInners(parent, left);
+  }
+}
+
+void BPlusTree::_MergeLeaves(Inner* parent, int i) {
+  Leaf* l = static_cast<Leaf*>(parent->children[i]);
+  Leaf* r = static_cast<Leaf*>(parent->children[i + 1]);
+  for (int j = 0; j < r->n; ++j) {
+    l->scores[l->n + j] = r->scores[j];
+    l->members[l->n + j].swap(r->members[j]);
+  }
+  l->n += r->n;
+  l->next = r->next;
+  if (r->next)
+    r->next->prev = l;
+  delete r;
+  --leaves_;
+  parent->counts[i] += parent->counts[i + 1];
+  _RemoveChild(parent, i + 1);
+}
+
+void BPlusTree::_MergeInners(Inner* parent, int i) {
+  Inner* l = static_cast<Inner*>(parent->children[i]);
+  Inner* r = static_cast<Inner*>(parent->children[i + 1]);
+  // 父节点的分隔键下移，成为 r 第一个子树的下界
+  l->sepScores[l->n] = parent->sepScores[i + 1];
+  l->sepMembers[l->n].swap(parent->sepMembers[i + 1]);
+  for (int j = 0; j < r->n; ++j) {
+    l->children[l->n + j] = r->children[j];
+    l->counts[l->n + j] = r->counts[j];
+    if (j > 0) {
+      l->sepScores[l->n + j] = r->sepScores[j];
+      l->sepMembers[l->n + j].swap(r->sepMembers[j]);
+    }
+  }
+  l->n += r->n;
+  delete r;
+  --inners_;
+  parent->counts[i] += parent->counts[i + 1];
+  _RemoveChild(parent, i + 1);
+}
+
+void BPlusTree::_BalanceLeaves(Inner* parent, int i) {
+  Leaf* l = static_cast<Leaf*>(parent->children[i]);
+  Leaf* r = static_cast<Leaf*>(parent->children[i + 1]);
+  const int target = (l->n + r->n) / 2;
+  if (l->n > target) {
+    const int k = l->n - target;
+    for (int j = r->n - 1; j >= 0; --j) {
+      r->scores[j + k] = r->scores[j];
+      r->members[j + k].swap(r->members[j]);
+    }
+    for (int j = 0; j < k; ++j) {
+      r->scores[j] = l->scores[target + j];
+      r->members[j].swap(l->members[target + j]);
+    }
+    r->n += k;
+    l->n = target;
+  } else {
+    const int k = target - l->n;
+    for (int j = 0; j < k; ++j) {
+      l->scores[l->n + j] = r->scores[j];
+      l->members[l->n + j].swap(r->members[j]);
+    }
+    for (int j = 0; j + k < r->n; ++j) {
+      r->scores[j] = r->scores[j + k];
+      r->members[j].swap(r->members[j + k]);
+    }
+    r->n -= k;
+    l->n = target;
+  }
+  clearTail(l);
+  clearTail(r);
+  parent->counts[i] = static_cast<std::size_t>(l->n);
+  parent->counts[i + 1] = static_cast<std::size_t>(r->n);
+  parent->sepScores[i + 1] = r->scores[0];
+  parent->sepMembers[i + 1] = r->members[0];
+}
+
+void BPlusTree::_BalanceInners(Inner* parent, int i) {
+  Inner* l = static_cast<Inner*>(parent->children[i]);
+  Inner* r = static_cast<Inner*>(parent->children[i + 1]);
+  const int target = (l->n + r->n) / 2;
+  std::size_t moved = 0;
+  if (l->n > target) {
+    // l 末尾的 k 个子树经父节点的分隔键转到 r 的开头
+    const int k = l->n - target;
+    for (int j = r->n - 1; j >= 0; --j) {
+      r->children[j + k] = r->children[j];
+      r->counts[j + k] = r->counts[j];
+      r->sepScores[j + k] = r->sepScores[j];
+      r->sepMembers[j + k].swap(r->sepMembers[j]);
+    }
+    r->sepScores[k] = parent->sepScores[i + 1];
+    r->sepMembers[k].swap(parent->sepMembers[i + 1]);
+    for (int j = 0; j < k; ++j) {
+      r->children[j] = l->children[target + j];
+      r->counts[j] = l->counts[target + j];
+      moved += r->counts[j];
+      if (j > 0) {
+        r->sepScores[j] = l->sepScores[target + j];
+        r->sepMembers[j].swap(l->sepMembers[target + j]);
+      }
+    }
+    parent->sepScores[i + 1] = l->sepScores[target];
+    parent->sepMembers[i + 1].swap(l->sepMembers[target]);
+    r->n += k;
+    l->n = target;
+    parent->counts[i] -= moved;
+    parent->counts[i + 1] += moved;
+  } else {
+    // r 开头的 k 个子树转到 l 的末尾
+    const int k = target - l->n;
+    l->sepScores[l->n] = parent->sepScores[i + 1];
+    l->sepMembers[l->n].swap(parent->sepMembers[i + 1]);
+    for (int j = 0; j < k; ++j) {
+      l->children[l->n + j] = r->children[j];
+      l->counts[l->n + j] = r->counts[j];
+      moved += r->counts[j];
+      if (j > 0) {
+        l->sepScores[l->n + j] = r->sepScores[j];
+        l->sepMembers[l->n + j].swap(r->sepMembers[j]);
+      }
+    }
+    parent->sepScores[i + 1] = r->sepScores[k];
+    parent->sepMembers[i + 1].swap(r->sepMembers[k]);
+    for (int j = 0; j + k < r->n; ++j) {
+      r->children[j] = r->children[j + k];
+      r->counts[j] = r->counts[j + k];
+      r->sepScores[j] = r->sepScores[j + k];
+      r->sepMembers[j].swap(r->sepMembers[j + k]);
+    }
+    l->n += k;
+    r->n -= k;
+    parent->counts[i] += moved;
+    parent->counts[i + 1] -= moved;
+  }
+  clearTail(l);
+  clearTail(r);
+}
+
+void BPlusTree::_RemoveChild(Inner* parent, int i) {
+  for (int j = i; j < parent->n - 1; ++j) {
+    parent->children[j] = parent->children[j + 1];
+    parent->counts[j] = parent->counts[j + 1];
+    parent->sepScores[j] = parent->sepScores[j + 1];
+    parent->sepMembers[j].swap(parent->sepMembers[j + 1]);
+  }
+  --parent->n;
+  clearTail(parent);
+}
+
+void BPlusTree::_Free(Node* node) {
+  if (node->leaf) {
+    delete static_cast<Leaf*>(node);
+    return;
+  }
+  Inner* in = static_cast<Inner*>(node);
+  for (int i = 0; i < in->n; ++i)
+    _Free(in->children[i]);
+  delete in;
+}
+}  // namespace tinyredis
@@ -0,0 +1,99 @@
+#include <server/db/database.h>
+#include <server/util/memory.h>
+#include <cassert>
+#include <utility>
+
+namespace tinyredis {
+const int Database::kShardBits;
+const std::size_t Database::kShards;
+const Database::ShardMask Database::kAllShards;
+const uint64_t Database::kCronRehashUs;
+
+namespace {
+#ifndef NDEBUG
+// 当前线程经 Guard 持有的分片，用于检查命令只访问了声明过的键
+thread_local Database::ShardMask heldShards = 0;
+#endif
+}  // namespace
+
+Database::Guard::Guard(Database& db, ShardMask shards)
+    : db_(db), shards_(shards) {
+  for (std::size_t i = 0; i < kShards; ++i) {
+    if (shards_ & (static_cast<ShardMask>(1) << i))
+      db_.shards_[i].mutex.lock();
+  }
+#ifndef NDEBUG
+  heldShards |= shards_;
+#endif
+}
+
+Database::Guard::~Guard() {
+#ifndef NDEBUG
+  heldShards &= ~shards_;
+#endif
+  for (std::size_t i = 0; i < kShards; ++i) {
+    if (shards_ & (static_cast<ShardMask>(1) << i))
+      db_.shards_[i].mutex.unlock();
+  }
+}
+
+Database::Database() : startupBytes_(allocatedBytes()) {}
+
+Database::Keyspace& Database::shard(std::size_t i) {
+#ifndef NDEBUG
+  assert((heldShards >> i) & 1);
+#endif
+  return shards_[i].keys;
+}
+
+Object* Database::add(const Slice& key, Object value) {
+  Object* o = keys(key).insert(key.toString()).first;
+  *o = std::move(value);
+  return o;
+}
+
+std::size_t Database::size() const {
+  std::size_t n = 0;
+  for (const Shard& s : shards_)
+    n += s.keys.size();
+  return n;
+}
+
+void Database::clear() {
+  for (Shard& s : shards_)
+    s.keys.clear();
+}
+
+void Database::cron(std::size_t shard) {
+  Shard& s = shards_[shard];
+  std::unique_lock<std::mutex> lock(s.mutex, std::try_to_lock);
+  if (!lock.owns_lock())
+    return;
+  s.keys.shrinkIfNeeded();
+  s.keys.rehashFor(kCronRehashUs);
+}
+
+std::size_t Database::memoryUsage(const Slice& key) {
+  Keyspace& table = keys(key);
+  const Keyspace::Entry* e = table.findEntry(key);
+  if (!e)
+    return 0;
+  const std::size_t entryBytes = table.tableBytes() / table.size();
+  return entryBytes + stringHeapBytes(e->key) + e->value.allocatedBytes();
+}
+
+Database::MemoryStats Database::memoryStats() const {
+  MemoryStats stats;
+  stats.allocated = allocatedBytes();
+  stats.startup = startupBytes_;
+  stats.dataset =
+      stats.allocated > stats.startup ? stats.allocated - stats.startup : 0;
+  stats.tableBytes = 0;
+  stats.keys = 0;
+  for (const Shard& s : shards_) {
+    stats.tableBytes += s.keys.tableBytes();
+    stats.keys += s.keys.size();
+  }
+  return stats;
+}
+}  // namespace tinyredis
@@ -0,0 +1,51 @@
+#include <server/db/hashTable.h>
+
+namespace tinyredis {
+uint64_t hashBytes(const void* data, std::size_t len) {
+  const uint64_t m = 0xc6a4a7935bd1e995ULL;
+  const int r = 47;
+  const uint64_t seed = 0x5bd1e9955bd1e995ULL;
+
+  uint64_t h = seed ^ (len * m);
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  const unsigned char* end = p + (len & ~static_cast<std::size_t>(7));
+  for (; p != end; p += 8) {
+    uint64_t k;
+    std::memcpy(&k, p, sizeof(k));
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+    h ^= k;
+    h *= m;
+  }
+
+  switch (len & 7) {
+    case 7:
+      h ^= static_cast<uint64_t>(p[6]) << 48;
+      // fallthrough
+    case 6:
+      h ^= static_cast<uint64_t>(p[5]) << 40;
+      // fallthrough
+    case 5:
+      h ^= static_cast<uint64_t>(p[4]) << 32;
+      // fallthrough
+    case 4:
+      h ^= static_cast<uint64_t>(p[3]) << 24;
+      // fallthrough
+    case 3:
+      h ^= static_cast<uint64_t>(p[2]) << 16;
+      // fallthrough
+    case 2:
+      h ^= static_cast<uint64_t>(p[1]) << 8;
+      // fallthrough
+    case 1:
+      h ^= static_cast<uint64_t>(p[0]);
+      h *= m;
+  }
+
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+}  // namespace tinyredis
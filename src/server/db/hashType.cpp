@@ -0,0 +1,83 @@
+#include <server/db/hashType.h>
+
+namespace tinyredis {
+namespace hashType {
+Object create() {
+  return Object::createAggregate(Object::Type::kHash);
+}
+
+std::size_t size(const Object& o) {
+  if (o.encoding() == Object::Encoding::kListpack)
+    return o.listpack().size() / 2;
+  return const_cast<Object&>(o).hashDict().size();
+}
+
+bool get(Object& o, const Slice& field, char* buf, Slice* value) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    const Listpack& lp = o.listpack();
+    const std::size_t f = lp.find(lp.first(), field, 1);
+    if (f == Listpack::npos)
+      return false;
+    *value = lp.get(lp.next(f), buf);
+    return true;
+  }
+  const std::string* v = o.hashDict().find(field);
+  if (!v)
+    return false;
+  *value = Slice{v->data(), v->size()};
+  return true;
+}
+
+bool exists(Object& o, const Slice& field) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    const Listpack& lp = o.listpack();
+    return lp.find(lp.first(), field, 1) != Listpack::npos;
+  }
+  return o.hashDict().find(field) != nullptr;
+}
+
+bool set(Object& o, const Slice& field, const Slice& value,
+         const EncodingConfig& cfg) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    Listpack& lp = o.listpack();
+    const std::size_t f = lp.find(lp.first(), field, 1);
+    if (f != Listpack::npos) {
+      lp.replace(lp.next(f), value);
+      return false;
+    }
+    if (size(o) + 1 <= cfg.hashMaxListpackEntries &&
+        field.len <= cfg.hashMaxListpackValue &&
+        value.len <= cfg.hashMaxListpackValue) {
+      lp.append(field);
+      lp.append(value);
+      return true;
+    }
+    convert(o);
+  }
+  std::pair<std::string*, bool> r = o.hashDict().insert(field.toString());
+  r.first->assign(value.data, value.len);
+  return r.second;
+}
+
+bool erase(Object& o, const Slice& field) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    Listpack& lp = o.listpack();
+    const std::size_t f = lp.find(lp.first(), field, 1);
+    if (f == Listpack::npos)
+      return false;
+    lp.erase(f, 2);
+    return true;
+  }
+  return o.hashDict().erase(field);
+}
+
+void convert(Object& o) {
+  Object::HashDict* d = new Object::HashDict;
+  d->reserve(size(o));
+  forEach(o, [d](const Slice& field, const Slice& value) {
+    d->set(field.toString(), value.toString());
+  });
+  o.adoptHashDict(d);
+}
+}  // namespace hashType
+}  // namespace tinyredis
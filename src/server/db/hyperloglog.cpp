@@ -0,0 +1,526 @@
+#include <server/db/hyperloglog.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define TINYREDIS_HLL_X86 1
+#endif
+
+namespace tinyredis {
+namespace hll {
+namespace {
+const char kMagic[] = {'H', 'Y', 'L', 'L'};
+const unsigned char kEncodingDense = 0;
+const unsigned char kEncodingSparse = 1;
+// 基数缓存的最高字节，最高位为 1 表示缓存失效
+const std::size_t kCardHighByte = 15;
+const unsigned char kCardInvalid = 0x80;
+
+// 哈希的低 kP 位选寄存器，剩下的 kQ 位决定寄存器的值
+const int kP = 14;
+const int kQ = 64 - kP;
+const double kAlphaInf = 0.721347520444481703680;
+
+const unsigned char kXZeroBit = 0x40;
+const unsigned char kValBit = 0x80;
+const std::size_t kZeroMaxLen = 64;
+const std::size_t kXZeroMaxLen = 16384;
+const std::size_t kValMaxLen = 4;
+const unsigned kValMaxValue = 32;
+
+// sparseSet 的返回值：需要先转为 dense
+const int kNeedDense = 2;
+
+// Redis 使用的 MurmurHash64A，种子也相同，同一个元素落在同一个寄存器
+uint64_t murmurHash64A(const unsigned char* data, std::size_t len) {
+  const uint64_t m = 0xc6a4a7935bd1e995ULL;
+  const int r = 47;
+  uint64_t h = 0xadc83b19ULL ^ (len * m);
+  const unsigned char* end = data + (len & ~static_cast<std::size_t>(7));
+  for (; data != end; data += 8) {
+    uint64_t k;
+    std::memcpy(&k, data, sizeof(k));
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+    h ^= k;
+    h *= m;
+  }
+  const std::size_t rest = len & 7;
+  if (rest) {
+    for (std::size_t i = rest; i > 0; --i)
+      h ^= static_cast<uint64_t>(data[i - 1]) << (8 * (i - 1));
+    h *= m;
+  }
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
+// 元素对应的寄存器和值：值为剩余位中从低位起第一个 1 的位置（从 1 开始）
+void hashElement(const Slice& element, std::size_t* index, unsigned* value) {
+  uint64_t hash = murmurHash64A(
+      reinterpret_cast<const unsigned char*>(element.data), element.len);
+  *index = static_cast<std::size_t>(hash & (kRegisters - 1));
+  hash >>= kP;
+  hash |= 1ULL << kQ;
+  *value = static_cast<unsigned>(__builtin_ctzll(hash)) + 1;
+}
+
+// dense 寄存器 i 从第 i * 6 位开始，字节内低位在前；fb 不超过 2 时不跨字节
+unsigned denseGet(const unsigned char* regs, std::size_t i) {
+  const std::size_t byte = i * 6 / 8;
+  const unsigned fb = (i * 6) & 7;
+  unsigned v = regs[byte] >> fb;
+  if (fb > 2)
+    v |= static_cast<unsigned>(regs[byte + 1]) << (8 - fb);
+  return v & 63;
+}
+
+void denseSet(unsigned char* regs, std::size_t i, unsigned v) {
+  const std::size_t byte = i * 6 / 8;
+  const unsigned fb = (i * 6) & 7;
+  regs[byte] = static_cast<unsigned char>((regs[byte] & ~(63u << fb)) |
+                                          (v << fb));
+  if (fb > 2) {
+    const unsigned shift = 8 - fb;
+    regs[byte + 1] = static_cast<unsigned char>(
+        (regs[byte + 1] & ~(63u >> shift)) | (v >> shift));
+  }
+}
+
+void writeHeader(unsigned char* p, unsigned char encoding) {
+  std::memcpy(p, kMagic, sizeof(kMagic));
+  std::memset(p + 4, 0, kHeaderSize - 4);
+  p[4] = encoding;
+  p[kCardHighByte] = kCardInvalid;
+}
+
+// 一个 sparse 操作码：连续 len 个值为 value 的寄存器，占 bytes 字节
+struct Op {
+  std::size_t len;
+  unsigned value;
+  std::size_t bytes;
+};
+
+bool decodeOp(const unsigned char* p, std::size_t n, Op* op) {
+  if (n == 0)
+    return false;
+  const unsigned b = p[0];
+  if (b & kValBit) {
+    op->value = ((b >> 2) & 0x1F) + 1;
+    op->len = (b & 3) + 1;
+    op->bytes = 1;
+  } else if (b & kXZeroBit) {
+    if (n < 2)
+      return false;
+    op->value = 0;
+    op->len = (((b & 0x3F) << 8) | p[1]) + 1;
+    op->bytes = 2;
+  } else {
+    op->value = 0;
+    op->len = b + 1;
+    op->bytes = 1;
+  }
+  return true;
+}
+
+// len 个值为 value 的寄存器编码到 out，返回字节数；每个操作码至少覆盖一个寄存器
+std::size_t encodeRun(unsigned char* out, unsigned value, std::size_t len) {
+  std::size_t n = 0;
+  while (len > 0) {
+    if (value == 0 && len > kZeroMaxLen) {
+      const std::size_t run = len < kXZeroMaxLen ? len : kXZeroMaxLen;
+      out[n++] = static_cast<unsigned char>(kXZeroBit | ((run - 1) >> 8));
+      out[n++] = static_cast<unsigned char>((run - 1) & 0xFF);
+      len -= run;
+    } else if (value == 0) {
+      out[n++] = static_cast<unsigned char>(len - 1);
+      len = 0;
+    } else {
+      const std::size_t run = len < kValMaxLen ? len : kValMaxLen;
+      out[n++] = static_cast<unsigned char>(kValBit | ((value - 1) << 2) |
+                                            (run - 1));
+      len -= run;
+    }
+  }
+  return n;
+}
+
+// 在 sparse 中把寄存器 index 设为 value（不超过 kValMaxValue）。
+// 重新编码该寄存器所在的操作码及其前后各一个，合并相同值的相邻游程后原地替换
+int sparseSet(Object& o, const Slice& s, std::size_t index, unsigned value,
+              std::size_t sparseMaxBytes) {
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data);
+  const std::size_t n = s.len;
+  std::size_t pos = kHeaderSize;
+  std::size_t first = 0;
+  bool hasPrev = false;
+  std::size_t prevPos = 0;
+  Op prev = Op();
+  Op op;
+  for (;;) {
+    if (!decodeOp(p + pos, n - pos, &op))
+      return -1;
+    if (index < first + op.len)
+      break;
+    hasPrev = true;
+    prevPos = pos;
+    prev = op;
+    first += op.len;
+    pos += op.bytes;
+  }
+  if (op.value >= value)
+    return 0;
+
+  struct Run {
+    unsigned value;
+    std::size_t len;
+  };
+  Run runs[5];
+  int nruns = 0;
+  auto push = [&](unsigned v, std::size_t len) {
+    if (len == 0)
+      return;
+    if (nruns > 0 && runs[nruns - 1].value == v)
+      runs[nruns - 1].len += len;
+    else
+      runs[nruns++] = Run{v, len};
+  };
+  if (hasPrev)
+    push(prev.value, prev.len);
+  push(op.value, index - first);
+  push(value, 1);
+  push(op.value, first + op.len - index - 1);
+  const std::size_t start = hasPrev ? prevPos : pos;
+  std::size_t end = pos + op.bytes;
+  if (end < n) {
+    Op next;
+    if (!decodeOp(p + end, n - end, &next))
+      return -1;
+    push(next.value, next.len);
+    end += next.bytes;
+  }
+
+  unsigned char enc[32];
+  std::size_t encLen = 0;
+  for (int i = 0; i < nruns; ++i)
+    encLen += encodeRun(enc + encLen, runs[i].value, runs[i].len);
+  const std::size_t newLen = n - (end - start) + encLen;
+  if (newLen > sparseMaxBytes)
+    return kNeedDense;
+
+  // s 在修改 o 之后失效，以下只用偏移
+  unsigned char* w = reinterpret_cast<unsigned char*>(
+      o.mutableString(newLen > n ? newLen : 0));
+  std::memmove(w + start + encLen, w + end, n - end);
+  std::memcpy(w + start, enc, encLen);
+  w[kCardHighByte] |= kCardInvalid;
+  if (newLen < n)
+    o.truncate(newLen);
+  return 1;
+}
+
+// sparse 转为 dense，s 为 o 当前的内容
+bool toDense(Object& o, const Slice& s) {
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data);
+  std::string dense(kDenseSize, '\0');
+  unsigned char* d = reinterpret_cast<unsigned char*>(&dense[0]);
+  writeHeader(d, kEncodingDense);
+  std::size_t index = 0;
+  for (std::size_t pos = kHeaderSize; pos < s.len;) {
+    Op op;
+    if (!decodeOp(p + pos, s.len - pos, &op) ||
+        index + op.len > kRegisters)
+      return false;
+    if (op.value) {
+      for (std::size_t i = 0; i < op.len; ++i)
+        denseSet(d + kHeaderSize, index + i, op.value);
+    }
+    index += op.len;
+    pos += op.bytes;
+  }
+  if (index != kRegisters)
+    return false;
+  o = Object::fromString(dense.data(), dense.size());
+  return true;
+}
+
+bool mergeSparse(Registers& regs, const unsigned char* p, std::size_t n) {
+  std::size_t index = 0;
+  for (std::size_t pos = 0; pos < n;) {
+    Op op;
+    if (!decodeOp(p + pos, n - pos, &op) || index + op.len > kRegisters)
+      return false;
+    if (op.value) {
+      for (std::size_t i = index; i < index + op.len; ++i) {
+        if (regs.r[i] < op.value)
+          regs.r[i] = static_cast<uint8_t>(op.value);
+      }
+    }
+    index += op.len;
+    pos += op.bytes;
+  }
+  return index == kRegisters;
+}
+
+// dense 每 3 字节（小端 24 位）是 4 个寄存器
+void mergeDenseScalar(uint8_t* regs, const unsigned char* p) {
+  for (std::size_t i = 0; i < kRegisters; i += 4, p += 3) {
+    const uint32_t v = p[0] | (static_cast<uint32_t>(p[1]) << 8) |
+                       (static_cast<uint32_t>(p[2]) << 16);
+    for (int k = 0; k < 4; ++k) {
+      const uint8_t r = static_cast<uint8_t>((v >> (6 * k)) & 63);
+      if (regs[i + k] < r)
+        regs[i + k] = r;
+    }
+  }
+}
+
+#if defined(TINYREDIS_HLL_X86)
+// 每次 24 字节展开为 32 个寄存器：两个 128 位通道各取 12 字节，
+// 按 3 字节一组放进 32 位元素，再把 4 个 6 位字段移到各自的字节。
+// 高半部分从 p + 8 读取，最后一组也不会读出寄存器数组
+__attribute__((target("avx2"))) void mergeDenseAvx2(uint8_t* regs,
+                                                    const unsigned char* p) {
+  const __m256i shuffle = _mm256_setr_epi8(
+      0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,  //
+      4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15, -1);
+  const __m256i mask0 = _mm256_set1_epi32(0x3F);
+  const __m256i mask1 = _mm256_set1_epi32(0x3F00);
+  const __m256i mask2 = _mm256_set1_epi32(0x3F0000);
+  const __m256i mask3 = _mm256_set1_epi32(0x3F000000);
+  for (std::size_t i = 0; i < kRegisters; i += 32, p += 24) {
+    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8));
+    __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    v = _mm256_shuffle_epi8(v, shuffle);
+    __m256i r = _mm256_and_si256(v, mask0);
+    r = _mm256_or_si256(r, _mm256_and_si256(_mm256_slli_epi32(v, 2), mask1));
+    r = _mm256_or_si256(r, _mm256_and_si256(_mm256_slli_epi32(v, 4), mask2));
+    r = _mm256_or_si256(r, _mm256_and_si256(_mm256_slli_epi32(v, 6), mask3));
+    __m256i* dst = reinterpret_cast<__m256i*>(regs + i);
+    _mm256_storeu_si256(dst, _mm256_max_epu8(_mm256_loadu_si256(dst), r));
+  }
+}
+#endif
+
+bool kernelSupported(Kernel kernel) {
+  switch (kernel) {
+    case Kernel::kScalar:
+      return true;
+    case Kernel::kAvx2:
+      return cpuHasAvx2();
+  }
+  return false;
+}
+
+KernelSelector<Kernel> g_kernels(kernelSupported,
+                                 {Kernel::kAvx2, Kernel::kScalar});
+
+double sigma(double x) {
+  if (x == 1.0)
+    return INFINITY;
+  double y = 1.0;
+  double z = x;
+  double zPrime;
+  do {
+    x *= x;
+    zPrime = z;
+    z += x * y;
+    y += y;
+  } while (zPrime != z);
+  return z;
+}
+
+double tau(double x) {
+  if (x == 0.0 || x == 1.0)
+    return 0.0;
+  double y = 1.0;
+  double z = 1 - x;
+  double zPrime;
+  do {
+    x = std::sqrt(x);
+    zPrime = z;
+    y *= 0.5;
+    z -= (1 - x) * (1 - x) * y;
+  } while (zPrime != z);
+  return z / 3;
+}
+}  // namespace
+
+Object create() {
+  unsigned char buf[kHeaderSize + 2];
+  writeHeader(buf, kEncodingSparse);
+  // 基数缓存有效，为 0
+  buf[kCardHighByte] = 0;
+  encodeRun(buf + kHeaderSize, 0, kRegisters);
+  return Object::fromString(reinterpret_cast<const char*>(buf), sizeof(buf));
+}
+
+bool valid(const Slice& s) {
+  if (s.len < kHeaderSize || std::memcmp(s.data, kMagic, sizeof(kMagic)) != 0)
+    return false;
+  const unsigned char encoding = static_cast<unsigned char>(s.data[4]);
+  if (encoding == kEncodingDense)
+    return s.len == kDenseSize;
+  return encoding == kEncodingSparse;
+}
+
+bool isDense(const Slice& s) {
+  return static_cast<unsigned char>(s.data[4]) == kEncodingDense;
+}
+
+int add(Object& o, const Slice& element, std::size_t sparseMaxBytes) {
+  std::size_t index;
+  unsigned value;
+  hashElement(element, &index, &value);
+  char buf[Object::kIntBufSize];
+  const Slice s = o.stringValue(buf);
+  if (!isDense(s)) {
+    const int r = value > kValMaxValue
+                      ? kNeedDense
+                      : sparseSet(o, s, index, value, sparseMaxBytes);
+    if (r != kNeedDense)
+      return r;
+    if (!toDense(o, s))
+      return -1;
+  }
+  unsigned char* p = reinterpret_cast<unsigned char*>(o.mutableString(0));
+  if (denseGet(p + kHeaderSize, index) >= value)
+    return 0;
+  denseSet(p + kHeaderSize, index, value);
+  p[kCardHighByte] |= kCardInvalid;
+  return 1;
+}
+
+bool merge(Registers& regs, const Slice& hll) {
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(hll.data);
+  if (!isDense(hll))
+    return mergeSparse(regs, p + kHeaderSize, hll.len - kHeaderSize);
+#if defined(TINYREDIS_HLL_X86)
+  if (g_kernels.current() == Kernel::kAvx2) {
+    mergeDenseAvx2(regs.r, p + kHeaderSize);
+    return true;
+  }
+#endif
+  mergeDenseScalar(regs.r, p + kHeaderSize);
+  return true;
+}
+
+uint64_t count(const Registers& regs) {
+  // 各个值的寄存器个数；寄存器不超过 kQ + 1
+  uint32_t histo[64] = {0};
+  for (std::size_t i = 0; i < kRegisters; ++i)
+    ++histo[regs.r[i] & 63];
+  const double m = static_cast<double>(kRegisters);
+  double z = m * tau((m - histo[kQ + 1]) / m);
+  for (int j = kQ; j >= 1; --j) {
+    z += histo[j];
+    z *= 0.5;
+  }
+  z += m * sigma(histo[0] / m);
+  return static_cast<uint64_t>(std::llround(kAlphaInf * m * m / z));
+}
+
+bool count(Object& o, uint64_t* card) {
+  char buf[Object::kIntBufSize];
+  const Slice s = o.stringValue(buf);
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data);
+  if (!(p[kCardHighByte] & kCardInvalid)) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i)
+      v = (v << 8) | p[8 + i];
+    *card = v;
+    return true;
+  }
+  Registers& regs = scratch();
+  std::memset(regs.r, 0, sizeof(regs.r));
+  if (!merge(regs, s))
+    return false;
+  const uint64_t v = count(regs);
+  unsigned char* w = reinterpret_cast<unsigned char*>(o.mutableString(0));
+  for (int i = 0; i < 8; ++i)
+    w[8 + i] = static_cast<unsigned char>(v >> (8 * i));
+  *card = v;
+  return true;
+}
+
+void store(Object& o, const Registers& regs, bool dense,
+           std::size_t sparseMaxBytes) {
+  if (!dense) {
+    // 每个操作码至少覆盖一个寄存器，kRegisters 字节一定放得下
+    std::string sparse(kHeaderSize + kRegisters, '\0');
+    unsigned char* p = reinterpret_cast<unsigned char*>(&sparse[0]);
+    writeHeader(p, kEncodingSparse);
+    std::size_t len = kHeaderSize;
+    for (std::size_t i = 0; i < kRegisters && !dense;) {
+      const uint8_t v = regs.r[i];
+      std::size_t j = i + 1;
+      while (j < kRegisters && regs.r[j] == v)
+        ++j;
+      if (v > kValMaxValue) {
+        dense = true;
+        break;
+      }
+      len += encodeRun(p + len, v, j - i);
+      dense = len > sparseMaxBytes;
+      i = j;
+    }
+    if (!dense) {
+      o = Object::fromString(sparse.data(), len);
+      return;
+    }
+  }
+  std::string out(kDenseSize, '\0');
+  unsigned char* p = reinterpret_cast<unsigned char*>(&out[0]);
+  writeHeader(p, kEncodingDense);
+  unsigned char* d = p + kHeaderSize;
+  for (std::size_t i = 0; i < kRegisters; i += 4, d += 3) {
+    const uint32_t v = (regs.r[i] & 63u) | ((regs.r[i + 1] & 63u) << 6) |
+                       ((regs.r[i + 2] & 63u) << 12) |
+                       ((regs.r[i + 3] & 63u) << 18);
+    d[0] = static_cast<unsigned char>(v);
+    d[1] = static_cast<unsigned char>(v >> 8);
+    d[2] = static_cast<unsigned char>(v >> 16);
+  }
+  o = Object::fromString(out.data(), out.size());
+}
+
+void* Registers::operator new(std::size_t size) {
+  void* p = nullptr;
+  if (::posix_memalign(&p, alignof(Registers), size) != 0)
+    throw std::bad_alloc();
+  return p;
+}
+
+void Registers::operator delete(void* p) {
+  std::free(p);
+}
+
+Registers& scratch() {
+  static thread_local Registers regs;
+  return regs;
+}
+
+KernelSelector<Kernel>& kernels() {
+  return g_kernels;
+}
+
+const char* kernelName(Kernel kernel) {
+  switch (kernel) {
+    case Kernel::kScalar:
+      return "scalar";
+    case Kernel::kAvx2:
+      return "avx2";
+  }
+  return "unknown";
+}
+}  // namespace hll
+}  // namespace tinyredis
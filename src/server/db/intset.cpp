@@ -0,0 +1,180 @@
+#include <server/db/intset.h>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace tinyredis {
+const std::size_t Intset::kHeaderSize;
+
+namespace {
+unsigned char* checkedRealloc(unsigned char* p, std::size_t n) {
+  void* q = std::realloc(p, n);
+  if (!q)
+    throw std::bad_alloc();
+  return static_cast<unsigned char*>(q);
+}
+
+uint32_t readU32(const unsigned char* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+void writeU32(unsigned char* p, uint32_t v) {
+  std::memcpy(p, &v, sizeof(v));
+}
+
+int64_t readAt(const unsigned char* contents, std::size_t i, int width) {
+  switch (width) {
+    case 2: {
+      int16_t v;
+      std::memcpy(&v, contents + i * 2, 2);
+      return v;
+    }
+    case 4: {
+      int32_t v;
+      std::memcpy(&v, contents + i * 4, 4);
+      return v;
+    }
+    default: {
+      int64_t v;
+      std::memcpy(&v, contents + i * 8, 8);
+      return v;
+    }
+  }
+}
+
+void writeAt(unsigned char* contents, std::size_t i, int width, int64_t v) {
+  switch (width) {
+    case 2: {
+      const int16_t x = static_cast<int16_t>(v);
+      std::memcpy(contents + i * 2, &x, 2);
+      break;
+    }
+    case 4: {
+      const int32_t x = static_cast<int32_t>(v);
+      std::memcpy(contents + i * 4, &x, 4);
+      break;
+    }
+    default:
+      std::memcpy(contents + i * 8, &v, 8);
+      break;
+  }
+}
+}  // namespace
+
+Intset Intset::create() {
+  Intset is;
+  is.buf_ = checkedRealloc(nullptr, kHeaderSize);
+  writeU32(is.buf_, 2);
+  writeU32(is.buf_ + 4, 0);
+  return is;
+}
+
+void Intset::destroy() {
+  std::free(buf_);
+  buf_ = nullptr;
+}
+
+std::size_t Intset::size() const {
+  return readU32(buf_ + 4);
+}
+
+int Intset::width() const {
+  return static_cast<int>(readU32(buf_));
+}
+
+int64_t Intset::get(std::size_t i) const {
+  return readAt(buf_ + kHeaderSize, i, width());
+}
+
+bool Intset::contains(int64_t v) const {
+  std::size_t pos;
+  return widthOf(v) <= width() && _Search(v, &pos);
+}
+
+bool Intset::add(int64_t v) {
+  if (widthOf(v) > width()) {
+    _Upgrade(v);
+    return true;
+  }
+  std::size_t pos;
+  if (_Search(v, &pos))
+    return false;
+  const std::size_t n = size();
+  const int w = width();
+  buf_ = checkedRealloc(buf_, kHeaderSize + (n + 1) * w);
+  unsigned char* contents = buf_ + kHeaderSize;
+  std::memmove(contents + (pos + 1) * w, contents + pos * w, (n - pos) * w);
+  writeAt(contents, pos, w, v);
+  _SetSize(n + 1);
+  return true;
+}
+
+bool Intset::erase(int64_t v) {
+  std::size_t pos;
+  if (widthOf(v) > width() || !_Search(v, &pos))
+    return false;
+  const std::size_t n = size();
+  const int w = width();
+  unsigned char* contents = buf_ + kHeaderSize;
+  std::memmove(contents + pos * w, contents + (pos + 1) * w,
+               (n - pos - 1) * w);
+  _SetSize(n - 1);
+  buf_ = checkedRealloc(buf_, kHeaderSize + (n - 1) * w);
+  return true;
+}
+
+int Intset::widthOf(int64_t v) {
+  if (v >= INT16_MIN && v <= INT16_MAX)
+    return 2;
+  if (v >= INT32_MIN && v <= INT32_MAX)
+    return 4;
+  return 8;
+}
+
+bool Intset::_Search(int64_t v, std::size_t* pos) const {
+  const std::size_t n = size();
+  const int w = width();
+  const unsigned char* contents = buf_ + kHeaderSize;
+  // 先看两端，顺序追加的常见情况不必二分
+  if (n == 0 || v > readAt(contents, n - 1, w)) {
+    *pos = n;
+    return false;
+  }
+  if (v < readAt(contents, 0, w)) {
+    *pos = 0;
+    return false;
+  }
+  std::size_t lo = 0;
+  std::size_t hi = n;
+  while (lo < hi) {
+    const std::size_t mid = lo + (hi - lo) / 2;
+    if (readAt(contents, mid, w) < v)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  *pos = lo;
+  return lo < n && readAt(contents, lo, w) == v;
+}
+
+void Intset::_SetSize(std::size_t n) {
+  writeU32(buf_ + 4, static_cast<uint32_t>(n));
+}
+
+void Intset::_Upgrade(int64_t v) {
+  const std::size_t n = size();
+  const int from = width();
+  const int to = widthOf(v);
+  buf_ = checkedRealloc(buf_, kHeaderSize + (n + 1) * to);
+  unsigned char* contents = buf_ + kHeaderSize;
+  // 比原有元素都宽的数要么最小要么最大
+  const std::size_t shift = v < 0 ? 1 : 0;
+  for (std::size_t i = n; i-- > 0;)
+    writeAt(contents, i + shift, to, readAt(contents, i, from));
+  writeAt(contents, v < 0 ? 0 : n, to, v);
+  writeU32(buf_, static_cast<uint32_t>(to));
+  _SetSize(n + 1);
+}
+}  // namespace tinyredis
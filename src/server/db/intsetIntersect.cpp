@@ -0,0 +1,354 @@
+#include <server/db/intsetIntersect.h>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define TINYREDIS_INTERSECT_X86 1
+#endif
+
+namespace tinyredis {
+namespace {
+// 大的一边超过小的一边这么多倍时，倍增查找比逐个归并访问的元素少
+const std::size_t kGallopRatio = 32;
+
+template <typename A, typename B, typename O>
+std::size_t mergeScalar(const A* a, std::size_t na, const B* b,
+                        std::size_t nb, O* out, std::size_t limit) {
+  std::size_t i = 0;
+  std::size_t j = 0;
+  std::size_t n = 0;
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      if (out)
+        out[n] = static_cast<O>(a[i]);
+      ++i;
+      ++j;
+      if (++n == limit)
+        break;
+    }
+  }
+  return n;
+}
+
+// a 远小于 b：对 a 的每个元素，从上一次的位置起在 b 中按 1、2、4... 的步长
+// 找到第一个不小于它的元素所在的区间，再二分
+template <typename A, typename B, typename O>
+std::size_t gallopScalar(const A* a, std::size_t na, const B* b,
+                         std::size_t nb, O* out, std::size_t limit) {
+  std::size_t j = 0;
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < na && j < nb; ++i) {
+    const A x = a[i];
+    std::size_t lo = j;
+    std::size_t hi = j;
+    std::size_t step = 1;
+    while (hi < nb && b[hi] < x) {
+      lo = hi + 1;
+      hi += step;
+      step *= 2;
+    }
+    if (hi > nb)
+      hi = nb;
+    while (lo < hi) {
+      const std::size_t mid = lo + (hi - lo) / 2;
+      if (b[mid] < x)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    j = lo;
+    if (j < nb && b[j] == x) {
+      if (out)
+        out[n] = static_cast<O>(x);
+      ++j;
+      if (++n == limit)
+        break;
+    }
+  }
+  return n;
+}
+
+// 输出宽度取两者中较窄的一个
+template <typename A, typename B>
+std::size_t intersectScalar(const A* a, std::size_t na, const B* b,
+                            std::size_t nb, void* out, std::size_t limit) {
+  using O = typename std::conditional<sizeof(A) <= sizeof(B), A, B>::type;
+  O* o = static_cast<O*>(out);
+  if (nb / na >= kGallopRatio)
+    return gallopScalar(a, na, b, nb, o, limit);
+  return mergeScalar(a, na, b, nb, o, limit);
+}
+
+template <typename A>
+std::size_t intersectScalarWith(const A* a, std::size_t na, const IntArray& b,
+                                void* out, std::size_t limit) {
+  switch (b.width) {
+    case 2:
+      return intersectScalar(a, na, static_cast<const int16_t*>(b.data),
+                             b.size, out, limit);
+    case 4:
+      return intersectScalar(a, na, static_cast<const int32_t*>(b.data),
+                             b.size, out, limit);
+    default:
+      return intersectScalar(a, na, static_cast<const int64_t*>(b.data),
+                             b.size, out, limit);
+  }
+}
+
+std::size_t intersectScalar(const IntArray& a, const IntArray& b, void* out,
+                            std::size_t limit) {
+  switch (a.width) {
+    case 2:
+      return intersectScalarWith(static_cast<const int16_t*>(a.data), a.size,
+                                 b, out, limit);
+    case 4:
+      return intersectScalarWith(static_cast<const int32_t*>(a.data), a.size,
+                                 b, out, limit);
+    default:
+      return intersectScalarWith(static_cast<const int64_t*>(a.data), a.size,
+                                 b, out, limit);
+  }
+}
+
+#if defined(TINYREDIS_INTERSECT_X86)
+// 每种宽度一个块：match 返回 a 的块中哪些元素出现在 b 的块中（按位），
+// contains 判断 x 是否在 b 的块中
+struct Avx2Int16 {
+  using T = int16_t;
+  static const std::size_t kLanes = 8;
+
+  __attribute__((target("avx2"))) static unsigned match(const T* a,
+                                                        const T* b) {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    __m128i m = _mm_cmpeq_epi16(va, vb);
+    m = _mm_or_si128(m, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 2)));
+    m = _mm_or_si128(m, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 4)));
+    m = _mm_or_si128(m, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 6)));
+    m = _mm_or_si128(m, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 8)));
+    m = _mm_or_si128(m, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 10)));
+    m = _mm_or_si128(m, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 12)));
+    m = _mm_or_si128(m, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 14)));
+    // 每个 16 位的比较结果压成一个字节
+    return static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_packs_epi16(m, _mm_setzero_si128())));
+  }
+
+  __attribute__((target("avx2"))) static bool contains(T x, const T* b) {
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(vb, _mm_set1_epi16(x))) != 0;
+  }
+};
+
+struct Avx2Int32 {
+  using T = int32_t;
+  static const std::size_t kLanes = 8;
+
+  // 128 位半边内循环移位 3 次，交换两个半边后再移位 3 次，覆盖全部 8x8 对
+  __attribute__((target("avx2"))) static unsigned match(const T* a,
+                                                        const T* b) {
+    const __m256i va =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    const __m256i vb =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    const __m256i vs = _mm256_permute2x128_si256(vb, vb, 1);
+    __m256i m = _mm256_cmpeq_epi32(va, vb);
+    m = _mm256_or_si256(
+        m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, 0x39)));
+    m = _mm256_or_si256(
+        m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, 0x4E)));
+    m = _mm256_or_si256(
+        m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, 0x93)));
+    m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vs));
+    m = _mm256_or_si256(
+        m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, 0x39)));
+    m = _mm256_or_si256(
+        m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, 0x4E)));
+    m = _mm256_or_si256(
+        m, _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, 0x93)));
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+  }
+
+  __attribute__((target("avx2"))) static bool contains(T x, const T* b) {
+    const __m256i vb =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    return !_mm256_testz_si256(
+        _mm256_cmpeq_epi32(vb, _mm256_set1_epi32(x)), _mm256_set1_epi32(-1));
+  }
+};
+
+struct Avx2Int64 {
+  using T = int64_t;
+  static const std::size_t kLanes = 4;
+
+  __attribute__((target("avx2"))) static unsigned match(const T* a,
+                                                        const T* b) {
+    const __m256i va =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    const __m256i vb =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    __m256i m = _mm256_cmpeq_epi64(va, vb);
+    m = _mm256_or_si256(
+        m, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x39)));
+    m = _mm256_or_si256(
+        m, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x4E)));
+    m = _mm256_or_si256(
+        m, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x93)));
+    return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(m)));
+  }
+
+  __attribute__((target("avx2"))) static bool contains(T x, const T* b) {
+    const __m256i vb =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    return !_mm256_testz_si256(
+        _mm256_cmpeq_epi64(vb, _mm256_set1_epi64x(x)),
+        _mm256_set1_epi32(-1));
+  }
+};
+
+// 分块归并：两块中最大值较小的一块不可能再与之后的块有交集，前进它
+// （相等时两边都前进）。输出仍然有序；不足一块的尾部按标量归并
+template <typename Tr>
+__attribute__((target("avx2"))) std::size_t mergeAvx2(
+    const typename Tr::T* a, std::size_t na, const typename Tr::T* b,
+    std::size_t nb, typename Tr::T* out, std::size_t limit) {
+  using T = typename Tr::T;
+  const std::size_t kLanes = Tr::kLanes;
+  std::size_t i = 0;
+  std::size_t j = 0;
+  std::size_t n = 0;
+  while (i + kLanes <= na && j + kLanes <= nb) {
+    unsigned mask = Tr::match(a + i, b + j);
+    while (mask) {
+      if (out)
+        out[n] = a[i + __builtin_ctz(mask)];
+      mask &= mask - 1;
+      if (++n == limit)
+        return n;
+    }
+    const T amax = a[i + kLanes - 1];
+    const T bmax = b[j + kLanes - 1];
+    if (amax <= bmax)
+      i += kLanes;
+    if (bmax <= amax)
+      j += kLanes;
+  }
+  return n + mergeScalar(a + i, na - i, b + j, nb - j, out ? out + n : out,
+                         limit ? limit - n : 0);
+}
+
+// 按块倍增：找到末元素不小于 x 的块之后整块比较，下一个元素从这个块开始找
+template <typename Tr>
+__attribute__((target("avx2"))) std::size_t gallopAvx2(
+    const typename Tr::T* a, std::size_t na, const typename Tr::T* b,
+    std::size_t nb, typename Tr::T* out, std::size_t limit) {
+  using T = typename Tr::T;
+  const std::size_t kLanes = Tr::kLanes;
+  std::size_t i = 0;
+  std::size_t j = 0;
+  std::size_t n = 0;
+  for (; i < na; ++i) {
+    const T x = a[i];
+    if (nb - j < kLanes)
+      break;
+    if (b[j + kLanes - 1] < x) {
+      // 以块为单位：第 lo 块的末元素小于 x，第 hi 块（存在时）不小于 x
+      const std::size_t blocks = (nb - j) / kLanes;
+      std::size_t lo = 0;
+      std::size_t hi = 1;
+      while (hi < blocks && b[j + hi * kLanes + kLanes - 1] < x) {
+        lo = hi;
+        hi *= 2;
+      }
+      if (hi > blocks)
+        hi = blocks;
+      while (hi - lo > 1) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (b[j + mid * kLanes + kLanes - 1] < x)
+          lo = mid;
+        else
+          hi = mid;
+      }
+      j += hi * kLanes;
+      if (nb - j < kLanes)
+        break;
+    }
+    if (Tr::contains(x, b + j)) {
+      if (out)
+        out[n] = x;
+      if (++n == limit)
+        return n;
+    }
+  }
+  return n + gallopScalar(a + i, na - i, b + j, nb - j, out ? out + n : out,
+                          limit ? limit - n : 0);
+}
+
+template <typename Tr>
+__attribute__((target("avx2"))) std::size_t intersectAvx2(
+    const IntArray& a, const IntArray& b, void* out, std::size_t limit) {
+  using T = typename Tr::T;
+  const T* pa = static_cast<const T*>(a.data);
+  const T* pb = static_cast<const T*>(b.data);
+  if (b.size / a.size >= kGallopRatio)
+    return gallopAvx2<Tr>(pa, a.size, pb, b.size, static_cast<T*>(out),
+                          limit);
+  return mergeAvx2<Tr>(pa, a.size, pb, b.size, static_cast<T*>(out), limit);
+}
+#endif
+
+bool kernelSupported(IntersectKernel kernel) {
+  switch (kernel) {
+    case IntersectKernel::kScalar:
+      return true;
+    case IntersectKernel::kAvx2:
+      return cpuHasAvx2();
+  }
+  return false;
+}
+
+KernelSelector<IntersectKernel> g_kernels(kernelSupported,
+                                          {IntersectKernel::kAvx2,
+                                           IntersectKernel::kScalar});
+}  // namespace
+
+std::size_t intersect(const IntArray& x, const IntArray& y, void* out,
+                      std::size_t limit) {
+  const IntArray& a = x.size <= y.size ? x : y;
+  const IntArray& b = x.size <= y.size ? y : x;
+  if (a.size == 0)
+    return 0;
+#if defined(TINYREDIS_INTERSECT_X86)
+  if (g_kernels.current() == IntersectKernel::kAvx2 && a.width == b.width) {
+    switch (a.width) {
+      case 2:
+        return intersectAvx2<Avx2Int16>(a, b, out, limit);
+      case 4:
+        return intersectAvx2<Avx2Int32>(a, b, out, limit);
+      default:
+        return intersectAvx2<Avx2Int64>(a, b, out, limit);
+    }
+  }
+#endif
+  return intersectScalar(a, b, out, limit);
+}
+
+KernelSelector<IntersectKernel>& intersectKernels() {
+  return g_kernels;
+}
+
+const char* intersectKernelName(IntersectKernel kernel) {
+  switch (kernel) {
+    case IntersectKernel::kScalar:
+      return "scalar";
+    case IntersectKernel::kAvx2:
+      return "avx2";
+  }
+  return "unknown";
+}
+}  // namespace tinyredis
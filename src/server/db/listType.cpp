@@ -0,0 +1,67 @@
+#include <server/db/listType.h>
+
+namespace tinyredis {
+namespace listType {
+Object create() {
+  return Object::createAggregate(Object::Type::kList);
+}
+
+std::size_t size(const Object& o) {
+  if (o.encoding() == Object::Encoding::kListpack)
+    return o.listpack().size();
+  return const_cast<Object&>(o).quicklist().size();
+}
+
+void push(Object& o, const Slice& value, bool head, const EncodingConfig& cfg) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    Listpack& lp = o.listpack();
+    if (cfg.listFits(lp.bytes() + Listpack::entrySize(value), lp.size() + 1)) {
+      if (head)
+        lp.prepend(value);
+      else
+        lp.append(value);
+      return;
+    }
+    convert(o, cfg);
+  }
+  o.quicklist().push(value, head);
+}
+
+bool pop(Object& o, bool head, std::string* out) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    Listpack& lp = o.listpack();
+    const std::size_t p = head ? lp.first() : lp.last();
+    if (p == Listpack::npos)
+      return false;
+    char buf[Listpack::kIntBufSize];
+    Slice v = lp.get(p, buf);
+    out->assign(v.data, v.len);
+    lp.erase(p);
+    return true;
+  }
+  return o.quicklist().pop(head, out);
+}
+
+bool index(Object& o, long long index, std::string* out) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    const Listpack& lp = o.listpack();
+    const std::size_t p = lp.seek(index);
+    if (p == Listpack::npos)
+      return false;
+    char buf[Listpack::kIntBufSize];
+    const Slice v = lp.get(p, buf);
+    out->assign(v.data, v.len);
+    return true;
+  }
+  return o.quicklist().index(index, out);
+}
+
+void convert(Object& o, const EncodingConfig& cfg) {
+  Quicklist* l = new Quicklist(cfg.listMaxListpackSize, cfg.listCompressDepth);
+  const std::size_t n = size(o);
+  if (n > 0)
+    range(o, 0, n - 1, [l](const Slice& v) { l->push(v, false); });
+  o.adoptQuicklist(l);
+}
+}  // namespace listType
+}  // namespace tinyredis
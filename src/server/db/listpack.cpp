@@ -0,0 +1,404 @@
+#include <server/db/listpack.h>
+#include <server/protocol/respShared.h>
+#include <server/util/numbers.h>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+namespace tinyredis {
+const std::size_t Listpack::kHeaderSize;
+const std::size_t Listpack::npos;
+const std::size_t Listpack::kIntBufSize;
+
+namespace {
+const unsigned char kEof = 0xFF;
+const unsigned char kStr32 = 0xF0;
+const unsigned char kInt16 = 0xF1;
+const unsigned char kInt24 = 0xF2;
+const unsigned char kInt32 = 0xF3;
+const unsigned char kInt64 = 0xF4;
+
+uint64_t readLE(const unsigned char* p, int n) {
+  uint64_t v = 0;
+  for (int i = n - 1; i >= 0; --i)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+void writeLE(unsigned char* p, uint64_t v, int n) {
+  for (int i = 0; i < n; ++i) {
+    p[i] = static_cast<unsigned char>(v & 0xFF);
+    v >>= 8;
+  }
+}
+
+// 一个元素的编码头：整数的内容也在头里，字符串的内容另外拷贝
+struct Encoded {
+  unsigned char head[9];
+  std::size_t headLen;
+  const char* data;
+  std::size_t dataLen;
+
+  std::size_t size() const { return headLen + dataLen; }
+};
+
+Encoded encode(const Slice& s) {
+  Encoded e;
+  e.data = s.data;
+  e.dataLen = 0;
+  long long v;
+  if (tryParseInt(s.data, s.len, v)) {
+    const uint64_t u = static_cast<uint64_t>(v);
+    if (v >= 0 && v <= 127) {
+      e.head[0] = static_cast<unsigned char>(v);
+      e.headLen = 1;
+    } else if (v >= -4096 && v <= 4095) {
+      const uint64_t b = v < 0 ? (1ULL << 13) + u : u;
+      e.head[0] = static_cast<unsigned char>(0xC0 | (b >> 8));
+      e.head[1] = static_cast<unsigned char>(b & 0xFF);
+      e.headLen = 2;
+    } else if (v >= -32768 && v <= 32767) {
+      e.head[0] = kInt16;
+      writeLE(e.head + 1, u, 2);
+      e.headLen = 3;
+    } else if (v >= -8388608 && v <= 8388607) {
+      e.head[0] = kInt24;
+      writeLE(e.head + 1, u, 3);
+      e.headLen = 4;
+    } else if (v >= -2147483648LL && v <= 2147483647LL) {
+      e.head[0] = kInt32;
+      writeLE(e.head + 1, u, 4);
+      e.headLen = 5;
+    } else {
+      e.head[0] = kInt64;
+      writeLE(e.head + 1, u, 8);
+      e.headLen = 9;
+    }
+    return e;
+  }
+
+  e.dataLen = s.len;
+  if (s.len < 64) {
+    e.head[0] = static_cast<unsigned char>(0x80 | s.len);
+    e.headLen = 1;
+  } else if (s.len < 4096) {
+    e.head[0] = static_cast<unsigned char>(0xE0 | (s.len >> 8));
+    e.head[1] = static_cast<unsigned char>(s.len & 0xFF);
+    e.headLen = 2;
+  } else {
+    e.head[0] = kStr32;
+    writeLE(e.head + 1, s.len, 4);
+    e.headLen = 5;
+  }
+  return e;
+}
+
+std::size_t backlenSize(std::size_t len) {
+  if (len <= 127)
+    return 1;
+  if (len < 16383)
+    return 2;
+  if (len < 2097151)
+    return 3;
+  if (len < 268435455)
+    return 4;
+  return 5;
+}
+
+// 高位字节在前，除第一个字节外最高位置 1，从末尾往前读时据此判断是否还有更多字节
+void writeBacklen(unsigned char* p, std::size_t len) {
+  const std::size_t n = backlenSize(len);
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::size_t shift = 7 * (n - 1 - i);
+    unsigned char b = static_cast<unsigned char>((len >> shift) & 127);
+    if (i > 0)
+      b |= 128;
+    p[i] = b;
+  }
+}
+
+// p 指向反向长度的最后一个字节，*n 返回反向长度本身占用的字节数
+std::size_t readBacklen(const unsigned char* p, std::size_t* n) {
+  std::size_t v = 0;
+  std::size_t shift = 0;
+  std::size_t count = 0;
+  for (;;) {
+    v |= static_cast<std::size_t>(p[0] & 127) << shift;
+    ++count;
+    if (!(p[0] & 128))
+      break;
+    shift += 7;
+    --p;
+  }
+  *n = count;
+  return v;
+}
+
+bool decodeInteger(const unsigned char* p, long long* v) {
+  const unsigned char b = p[0];
+  if (b < 0x80) {
+    *v = b;
+  } else if ((b & 0xE0) == 0xC0) {
+    const long long u = ((b & 0x1F) << 8) | p[1];
+    *v = u >= (1 << 12) ? u - (1 << 13) : u;
+  } else if (b == kInt16) {
+    *v = static_cast<int16_t>(readLE(p + 1, 2));
+  } else if (b == kInt24) {
+    const long long u = static_cast<long long>(readLE(p + 1, 3));
+    *v = u >= (1 << 23) ? u - (1 << 24) : u;
+  } else if (b == kInt32) {
+    *v = static_cast<int32_t>(readLE(p + 1, 4));
+  } else if (b == kInt64) {
+    *v = static_cast<long long>(readLE(p + 1, 8));
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// 字符串元素的内容
+Slice decodeString(const unsigned char* p) {
+  const unsigned char b = p[0];
+  const char* base = reinterpret_cast<const char*>(p);
+  if ((b & 0xC0) == 0x80)
+    return Slice{base + 1, static_cast<std::size_t>(b & 0x3F)};
+  if ((b & 0xF0) == 0xE0)
+    return Slice{base + 2, static_cast<std::size_t>(((b & 0x0F) << 8) | p[1])};
+  return Slice{base + 5, static_cast<std::size_t>(readLE(p + 1, 4))};
+}
+
+unsigned char* checkedRealloc(unsigned char* p, std::size_t n) {
+  void* q = std::realloc(p, n);
+  if (!q)
+    throw std::bad_alloc();
+  return static_cast<unsigned char*>(q);
+}
+}  // namespace
+
+Listpack Listpack::create() {
+  Listpack lp;
+  lp.buf_ = checkedRealloc(nullptr, kHeaderSize + 1);
+  lp._SetBytes(kHeaderSize + 1);
+  lp._SetSize(0);
+  lp.buf_[kHeaderSize] = kEof;
+  return lp;
+}
+
+Listpack Listpack::fromBuffer(unsigned char* buf) {
+  Listpack lp;
+  lp.buf_ = buf;
+  return lp;
+}
+
+void Listpack::destroy() {
+  std::free(buf_);
+  buf_ = nullptr;
+}
+
+std::size_t Listpack::size() const {
+  return static_cast<std::size_t>(readLE(buf_ + 4, 4));
+}
+
+std::size_t Listpack::bytes() const {
+  return static_cast<std::size_t>(readLE(buf_, 4));
+}
+
+std::size_t Listpack::first() const {
+  return buf_[kHeaderSize] == kEof ? npos : kHeaderSize;
+}
+
+std::size_t Listpack::last() const {
+  return prev(bytes() - 1);
+}
+
+std::size_t Listpack::next(std::size_t pos) const {
+  pos += _EntrySize(pos);
+  return buf_[pos] == kEof ? npos : pos;
+}
+
+std::size_t Listpack::prev(std::size_t pos) const {
+  if (pos <= kHeaderSize)
+    return npos;
+  std::size_t n;
+  const std::size_t len = readBacklen(buf_ + pos - 1, &n);
+  return pos - n - len;
+}
+
+std::size_t Listpack::seek(long long index) const {
+  const long long n = static_cast<long long>(size());
+  if (index < 0)
+    index += n;
+  if (index < 0 || index >= n)
+    return npos;
+  // 从较近的一端开始走
+  if (index <= n / 2) {
+    std::size_t pos = first();
+    while (index-- > 0)
+      pos = next(pos);
+    return pos;
+  }
+  std::size_t pos = last();
+  for (long long i = n - 1; i > index; --i)
+    pos = prev(pos);
+  return pos;
+}
+
+Slice Listpack::get(std::size_t pos, char* buf) const {
+  long long v;
+  if (decodeInteger(buf_ + pos, &v)) {
+    char* end = buf + kIntBufSize;
+    char* p = formatDecimal(end, v);
+    return Slice{p, static_cast<std::size_t>(end - p)};
+  }
+  return decodeString(buf_ + pos);
+}
+
+bool Listpack::getInteger(std::size_t pos, long long* v) const {
+  return decodeInteger(buf_ + pos, v);
+}
+
+bool Listpack::equals(std::size_t pos, const Slice& s) const {
+  long long v;
+  if (decodeInteger(buf_ + pos, &v)) {
+    long long sv;
+    return tryParseInt(s.data, s.len, sv) && sv == v;
+  }
+  const Slice e = decodeString(buf_ + pos);
+  return e.len == s.len && std::memcmp(e.data, s.data, s.len) == 0;
+}
+
+std::size_t Listpack::find(std::size_t pos, const Slice& s,
+                           std::size_t skip) const {
+  // 查找的值只解析一次，之后整数元素按数值比较，字符串元素先比长度
+  long long sv = 0;
+  const bool sIsInt = tryParseInt(s.data, s.len, sv);
+  while (pos != npos) {
+    long long v;
+    if (decodeInteger(buf_ + pos, &v)) {
+      if (sIsInt && v == sv)
+        return pos;
+    } else if (!sIsInt) {
+      const Slice e = decodeString(buf_ + pos);
+      if (e.len == s.len && std::memcmp(e.data, s.data, s.len) == 0)
+        return pos;
+    }
+    pos = next(pos);
+    for (std::size_t i = 0; i < skip && pos != npos; ++i)
+      pos = next(pos);
+  }
+  return npos;
+}
+
+std::size_t Listpack::insert(std::size_t pos, const Slice& s) {
+  if (pos == npos)
+    pos = bytes() - 1;
+  const Encoded e = encode(s);
+  const std::size_t entry = e.size() + backlenSize(e.size());
+  const std::size_t old = bytes();
+  // 内容在本缓冲区内时记下偏移，realloc 与移动之后重新定位
+  const bool owned = e.dataLen > 0 && _Owns(e.data);
+  const std::size_t offset =
+      owned ? static_cast<std::size_t>(
+                  reinterpret_cast<const unsigned char*>(e.data) - buf_)
+            : 0;
+  buf_ = checkedRealloc(buf_, old + entry);
+  std::memmove(buf_ + pos + entry, buf_ + pos, old - pos);
+
+  const char* data = e.data;
+  if (owned)
+    data = reinterpret_cast<const char*>(buf_) + offset +
+           (offset >= pos ? entry : 0);
+  unsigned char* p = buf_ + pos;
+  std::memcpy(p, e.head, e.headLen);
+  if (e.dataLen > 0)
+    std::memcpy(p + e.headLen, data, e.dataLen);
+  writeBacklen(p + e.size(), e.size());
+  _SetBytes(old + entry);
+  _SetSize(size() + 1);
+  return pos;
+}
+
+std::size_t Listpack::replace(std::size_t pos, const Slice& s) {
+  const Encoded e = encode(s);
+  // 大小不变时原地覆盖
+  if (e.size() == _EncodedSize(pos)) {
+    unsigned char* p = buf_ + pos;
+    std::memcpy(p, e.head, e.headLen);
+    if (e.dataLen > 0)
+      std::memmove(p + e.headLen, e.data, e.dataLen);
+    return pos;
+  }
+  // 先删除会移动并缩小缓冲区，指向本缓冲区的内容先拷贝出来
+  if (e.dataLen > 0 && _Owns(e.data)) {
+    const std::string copy(s.data, s.len);
+    return replace(pos, Slice{copy.data(), copy.size()});
+  }
+  const std::size_t at = erase(pos);
+  return insert(at, s);
+}
+
+std::size_t Listpack::erase(std::size_t pos, std::size_t n) {
+  std::size_t end = pos;
+  std::size_t removed = 0;
+  while (removed < n && buf_[end] != kEof) {
+    end += _EntrySize(end);
+    ++removed;
+  }
+  const std::size_t old = bytes();
+  std::memmove(buf_ + pos, buf_ + end, old - end);
+  buf_ = checkedRealloc(buf_, old - (end - pos));
+  _SetBytes(old - (end - pos));
+  _SetSize(size() - removed);
+  return buf_[pos] == kEof ? npos : pos;
+}
+
+bool Listpack::_Owns(const char* p) const {
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(buf_);
+  const uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+  return addr >= begin && addr < begin + bytes();
+}
+
+std::size_t Listpack::entrySize(const Slice& s) {
+  const Encoded e = encode(s);
+  return e.size() + backlenSize(e.size());
+}
+
+std::size_t Listpack::_EncodedSize(std::size_t pos) const {
+  const unsigned char* p = buf_ + pos;
+  const unsigned char b = p[0];
+  if (b < 0x80)
+    return 1;
+  if ((b & 0xC0) == 0x80)
+    return 1 + (b & 0x3F);
+  if ((b & 0xE0) == 0xC0)
+    return 2;
+  if ((b & 0xF0) == 0xE0)
+    return 2 + (((b & 0x0F) << 8) | p[1]);
+  switch (b) {
+    case kStr32:
+      return 5 + static_cast<std::size_t>(readLE(p + 1, 4));
+    case kInt16:
+      return 3;
+    case kInt24:
+      return 4;
+    case kInt32:
+      return 5;
+    default:
+      return 9;
+  }
+}
+
+std::size_t Listpack::_EntrySize(std::size_t pos) const {
+  const std::size_t n = _EncodedSize(pos);
+  return n + backlenSize(n);
+}
+
+void Listpack::_SetBytes(std::size_t n) {
+  writeLE(buf_, n, 4);
+}
+
+void Listpack::_SetSize(std::size_t n) {
+  writeLE(buf_ + 4, n, 4);
+}
+}  // namespace tinyredis
@@ -0,0 +1,423 @@
+#include <server/db/object.h>
+#include <server/protocol/respShared.h>
+#include <server/util/memory.h>
+#include <server/util/numbers.h>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace tinyredis {
+const std::size_t Object::kEmbStrMaxLen;
+const std::size_t Object::kMaxStringLen;
+const std::size_t Object::kIntBufSize;
+
+namespace {
+// 与 sds 相同：1MB 以内翻倍预留，之后每次多留 1MB
+const std::size_t kPreallocMax = 1024 * 1024;
+
+std::size_t growCapacity(std::size_t need) {
+  return need < kPreallocMax ? need * 2 : need + kPreallocMax;
+}
+
+void* checkedAlloc(void* p) {
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+// MEMORY USAGE 对完整结构抽样的元素个数
+const std::size_t kMemorySamples = 5;
+
+// 抽样前 kMemorySamples 个元素，按平均值估计全部元素的堆内存
+template <typename Table, typename Fn>
+std::size_t sampleTable(const Table& t, Fn elementBytes) {
+  if (t.empty())
+    return t.tableBytes();
+  Table& table = const_cast<Table&>(t);
+  typename Table::Iterator it(&table);
+  std::size_t sampled = 0;
+  std::size_t bytes = 0;
+  while (sampled < kMemorySamples) {
+    typename Table::Entry* e = it.next();
+    if (!e)
+      break;
+    bytes += elementBytes(*e);
+    ++sampled;
+  }
+  return t.tableBytes() + bytes * t.size() / sampled;
+}
+}  // namespace
+
+Object::Object(Object&& other) noexcept
+    : type_(other.type_), encoding_(other.encoding_), len_(other.len_) {
+  int_ = other.int_;
+  other.type_ = Type::kString;
+  other.encoding_ = Encoding::kEmbStr;
+  other.len_ = 0;
+  other.emb_ = nullptr;
+}
+
+Object& Object::operator=(Object&& other) noexcept {
+  if (this != &other) {
+    _Release();
+    type_ = other.type_;
+    encoding_ = other.encoding_;
+    len_ = other.len_;
+    int_ = other.int_;
+    other.type_ = Type::kString;
+    other.encoding_ = Encoding::kEmbStr;
+    other.len_ = 0;
+    other.emb_ = nullptr;
+  }
+  return *this;
+}
+
+Object Object::fromString(const char* data, std::size_t len) {
+  long long v;
+  if (tryParseInt(data, len, v))
+    return fromInteger(v);
+
+  Object o;
+  if (len <= kEmbStrMaxLen) {
+    if (len > 0) {
+      o.emb_ = static_cast<char*>(checkedAlloc(std::malloc(len)));
+      std::memcpy(o.emb_, data, len);
+      o.len_ = static_cast<uint32_t>(len);
+    }
+    return o;
+  }
+  // SET 写入的长字符串大多不会再追加，不预留空间
+  o.raw_ = _NewRaw(len, len);
+  std::memcpy(_RawData(o.raw_), data, len);
+  o.encoding_ = Encoding::kRaw;
+  return o;
+}
+
+Object Object::fromInteger(long long v) {
+  Object o;
+  o.encoding_ = Encoding::kInt;
+  o.int_ = v;
+  return o;
+}
+
+Object Object::createAggregate(Type type) {
+  Object o;
+  o.type_ = type;
+  o.encoding_ = Encoding::kListpack;
+  o.lp_ = Listpack::create();
+  return o;
+}
+
+Object Object::createIntset() {
+  Object o;
+  o.type_ = Type::kSet;
+  o.encoding_ = Encoding::kIntset;
+  o.intset_ = Intset::create();
+  return o;
+}
+
+Object Object::createStream() {
+  Object o;
+  o.type_ = Type::kStream;
+  o.encoding_ = Encoding::kStream;
+  o.stream_ = new Stream();
+  return o;
+}
+
+const char* Object::encodingName() const {
+  switch (encoding_) {
+    case Encoding::kInt:
+      return "int";
+    case Encoding::kEmbStr:
+      return "embstr";
+    case Encoding::kRaw:
+      return "raw";
+    case Encoding::kListpack:
+      return "listpack";
+    case Encoding::kHashTable:
+      return "hashtable";
+    case Encoding::kQuicklist:
+      return "quicklist";
+    case Encoding::kBTree:
+      return "btree";
+    case Encoding::kIntset:
+      return "intset";
+    case Encoding::kStream:
+      return "stream";
+  }
+  return "unknown";
+}
+
+const char* Object::typeName() const {
+  switch (type_) {
+    case Type::kString:
+      return "string";
+    case Type::kList:
+      return "list";
+    case Type::kHash:
+      return "hash";
+    case Type::kSet:
+      return "set";
+    case Type::kZset:
+      return "zset";
+    case Type::kStream:
+      return "stream";
+  }
+  return "unknown";
+}
+
+std::size_t Object::stringLength() const {
+  switch (encoding_) {
+    case Encoding::kInt: {
+      char buf[kIntBufSize];
+      return stringValue(buf).len;
+    }
+    case Encoding::kEmbStr:
+      return len_;
+    case Encoding::kRaw:
+      return raw_->len;
+    default:
+      break;
+  }
+  return 0;
+}
+
+Slice Object::stringValue(char* buf) const {
+  switch (encoding_) {
+    case Encoding::kInt: {
+      char* end = buf + kIntBufSize;
+      char* p = formatDecimal(end, int_);
+      return Slice{p, static_cast<std::size_t>(end - p)};
+    }
+    case Encoding::kEmbStr:
+      return Slice{emb_, len_};
+    case Encoding::kRaw:
+      return Slice{_RawData(raw_), raw_->len};
+    default:
+      break;
+  }
+  return Slice{nullptr, 0};
+}
+
+bool Object::integerValue(long long* out) const {
+  if (encoding_ == Encoding::kInt) {
+    *out = int_;
+    return true;
+  }
+  char buf[kIntBufSize];
+  Slice s = stringValue(buf);
+  return tryParseInt(s.data, s.len, *out);
+}
+
+std::shared_ptr<const char> Object::shareString() const {
+  if (encoding_ != Encoding::kRaw)
+    return std::shared_ptr<const char>();
+  raw_->refs.fetch_add(1, std::memory_order_relaxed);
+  std::shared_ptr<RawHeader> holder(raw_, &Object::_Unref);
+  return std::shared_ptr<const char>(holder, _RawData(raw_));
+}
+
+void Object::append(const char* data, std::size_t len) {
+  const std::size_t cur = stringLength();
+  _MakeRaw(cur + len);
+  std::memcpy(_RawData(raw_) + cur, data, len);
+  raw_->len = static_cast<uint32_t>(cur + len);
+}
+
+void Object::setRange(std::size_t offset, const char* data, std::size_t len) {
+  const std::size_t cur = stringLength();
+  const std::size_t need = offset + len > cur ? offset + len : cur;
+  _MakeRaw(need);
+  char* p = _RawData(raw_);
+  if (offset > cur)
+    std::memset(p + cur, 0, offset - cur);
+  std::memcpy(p + offset, data, len);
+  raw_->len = static_cast<uint32_t>(need);
+}
+
+char* Object::mutableString(std::size_t minLen) {
+  const std::size_t cur = stringLength();
+  const std::size_t need = minLen > cur ? minLen : cur;
+  _MakeRaw(need);
+  char* p = _RawData(raw_);
+  if (need > cur)
+    std::memset(p + cur, 0, need - cur);
+  raw_->len = static_cast<uint32_t>(need);
+  return p;
+}
+
+void Object::truncate(std::size_t len) {
+  _MakeRaw(len);
+  raw_->len = static_cast<uint32_t>(len);
+}
+
+void Object::adoptHashDict(HashDict* d) {
+  _Adopt(Encoding::kHashTable, d);
+}
+
+void Object::adoptSetDict(SetDict* d) {
+  _Adopt(Encoding::kHashTable, d);
+}
+
+void Object::adoptQuicklist(Quicklist* l) {
+  _Adopt(Encoding::kQuicklist, l);
+}
+
+void Object::adoptZsetTree(ZsetTree* z) {
+  _Adopt(Encoding::kBTree, z);
+}
+
+void Object::adoptListpack(Listpack lp) {
+  _ReleaseCompact();
+  encoding_ = Encoding::kListpack;
+  lp_ = lp;
+}
+
+std::size_t Object::allocatedBytes() const {
+  switch (encoding_) {
+    case Encoding::kInt:
+      return 0;
+    case Encoding::kEmbStr:
+      return mallocUsableSize(emb_);
+    case Encoding::kRaw:
+      return mallocUsableSize(raw_);
+    case Encoding::kListpack:
+      return mallocUsableSize(lp_.data());
+    case Encoding::kIntset:
+      return mallocUsableSize(intset_.data());
+    case Encoding::kHashTable:
+      if (type_ == Type::kHash) {
+        return sampleTable(*hash_, [](const HashDict::Entry& e) {
+          return stringHeapBytes(e.key) + stringHeapBytes(e.value);
+        });
+      }
+      return sampleTable(*set_, [](const SetDict::Entry& e) {
+        return stringHeapBytes(e.key);
+      });
+    case Encoding::kQuicklist:
+      return list_->allocatedBytes();
+    case Encoding::kBTree: {
+      // 树的节点按个数精确计算，成员字符串的堆内存与字典一起抽样
+      std::size_t members = 0;
+      std::size_t sampled = 0;
+      for (BPlusTree::Cursor c = zset_->tree.first();
+           c.valid() && sampled < kMemorySamples; c.next(), ++sampled)
+        members += stringHeapBytes(c.member());
+      return sampleTable(zset_->dict,
+                         [](const ZsetDict::Entry& e) {
+                           return stringHeapBytes(e.key);
+                         }) +
+             zset_->tree.nodeBytes() +
+             (sampled ? members * zset_->tree.size() / sampled : 0);
+    }
+    case Encoding::kStream:
+      return stream_->allocatedBytes();
+  }
+  return 0;
+}
+
+Object::RawHeader* Object::_NewRaw(std::size_t len, std::size_t cap) {
+  void* p = checkedAlloc(std::malloc(sizeof(RawHeader) + cap));
+  RawHeader* raw = new (p) RawHeader;
+  raw->len = static_cast<uint32_t>(len);
+  raw->cap = static_cast<uint32_t>(cap);
+  raw->refs.store(1, std::memory_order_relaxed);
+  return raw;
+}
+
+void Object::_Unref(RawHeader* raw) {
+  if (raw->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    raw->~RawHeader();
+    std::free(raw);
+  }
+}
+
+void Object::_MakeRaw(std::size_t minCap) {
+  // 只有对象自己引用时才能原地修改；否则下面复制一份再改
+  if (encoding_ == Encoding::kRaw &&
+      raw_->refs.load(std::memory_order_acquire) == 1) {
+    if (raw_->cap >= minCap)
+      return;
+    const std::size_t cap = growCapacity(minCap);
+    raw_ = static_cast<RawHeader*>(
+        checkedAlloc(std::realloc(raw_, sizeof(RawHeader) + cap)));
+    raw_->cap = static_cast<uint32_t>(cap);
+    return;
+  }
+
+  char buf[kIntBufSize];
+  const Slice cur = stringValue(buf);
+  const std::size_t cap = growCapacity(minCap > cur.len ? minCap : cur.len);
+  RawHeader* raw = _NewRaw(cur.len, cap);
+  if (cur.len > 0)
+    std::memcpy(_RawData(raw), cur.data, cur.len);
+  _Release();
+  raw_ = raw;
+  encoding_ = Encoding::kRaw;
+  len_ = 0;
+}
+
+void Object::_Adopt(Encoding encoding, void* p) {
+  _ReleaseCompact();
+  encoding_ = encoding;
+  switch (encoding) {
+    case Encoding::kHashTable:
+      if (type_ == Type::kHash)
+        hash_ = static_cast<HashDict*>(p);
+      else
+        set_ = static_cast<SetDict*>(p);
+      break;
+    case Encoding::kQuicklist:
+      list_ = static_cast<Quicklist*>(p);
+      break;
+    default:
+      zset_ = static_cast<ZsetTree*>(p);
+      break;
+  }
+}
+
+void Object::_ReleaseCompact() {
+  if (encoding_ == Encoding::kIntset)
+    intset_.destroy();
+  else
+    lp_.destroy();
+}
+
+void Object::_Release() {
+  switch (encoding_) {
+    case Encoding::kInt:
+      break;
+    case Encoding::kEmbStr:
+      std::free(emb_);
+      break;
+    case Encoding::kRaw:
+      _Unref(raw_);
+      break;
+    case Encoding::kListpack:
+      lp_.destroy();
+      break;
+    case Encoding::kIntset:
+      intset_.destroy();
+      break;
+    case Encoding::kHashTable:
+      if (type_ == Type::kHash)
+        delete hash_;
+      else
+        delete set_;
+      break;
+    case Encoding::kQuicklist:
+      delete list_;
+      break;
+    case Encoding::kBTree:
+      delete zset_;
+      break;
+    case Encoding::kStream:
+      delete stream_;
+      break;
+  }
+  type_ = Type::kString;
+  encoding_ = Encoding::kEmbStr;
+  len_ = 0;
+  emb_ = nullptr;
+}
+}  // namespace tinyredis
@@ -0,0 +1,236 @@
+#include <server/db/quicklist.h>
+#include <server/util/lzf.h>
+#include <server/util/memory.h>
+#include <cstdlib>
+#include <new>
+
+namespace tinyredis {
+namespace {
+// 与 Redis 相同：fill 为正数时节点仍不超过 8KB；太小的节点不值得压缩，
+// 压缩后至少要省下 8 字节才保留
+const std::size_t kSizeSafetyLimit = 8192;
+const std::size_t kMinCompressBytes = 48;
+const std::size_t kMinCompressSaving = 8;
+}  // namespace
+
+bool Quicklist::listpackFits(long long fill, std::size_t bytes,
+                             std::size_t count) {
+  if (fill >= 0)
+    return count <= static_cast<std::size_t>(fill) &&
+           bytes <= kSizeSafetyLimit;
+  const long long level = -fill < 5 ? -fill : 5;
+  return bytes <= (std::size_t(4096) << (level - 1));
+}
+
+Quicklist::Quicklist(long long fill, long long compressDepth)
+    : head_(nullptr),
+      tail_(nullptr),
+      count_(0),
+      nodes_(0),
+      fill_(fill),
+      depth_(compressDepth > 0 ? static_cast<std::size_t>(compressDepth) : 0) {
+}
+
+Quicklist::~Quicklist() {
+  Node* n = head_;
+  while (n) {
+    Node* next = n->next;
+    _FreeNode(n);
+    n = next;
+  }
+}
+
+std::size_t Quicklist::compressedNodes() const {
+  std::size_t n = 0;
+  for (const Node* node = head_; node; node = node->next)
+    n += node->lzf != nullptr;
+  return n;
+}
+
+void Quicklist::push(const Slice& value, bool head) {
+  Node* n = head ? head_ : tail_;
+  const std::size_t entry = Listpack::entrySize(value);
+  // 两端的节点不会被压缩（depth_ 为 0 时根本不压缩）
+  if (!n || !listpackFits(fill_, n->bytes + entry, n->count + 1)) {
+    Listpack lp = Listpack::create();
+    n = new Node{nullptr, nullptr, lp,
+                 nullptr, 0,       0,
+                 static_cast<uint32_t>(lp.bytes())};
+    if (head) {
+      n->next = head_;
+      if (head_)
+        head_->prev = n;
+      head_ = n;
+      if (!tail_)
+        tail_ = n;
+    } else {
+      n->prev = tail_;
+      if (tail_)
+        tail_->next = n;
+      tail_ = n;
+      if (!head_)
+        head_ = n;
+    }
+    ++nodes_;
+    _UpdateCompression();
+  }
+  if (head)
+    n->lp.prepend(value);
+  else
+    n->lp.append(value);
+  n->bytes = static_cast<uint32_t>(n->lp.bytes());
+  ++n->count;
+  ++count_;
+}
+
+bool Quicklist::pop(bool head, std::string* out) {
+  Node* n = head ? head_ : tail_;
+  if (!n)
+    return false;
+  const std::size_t p = head ? n->lp.first() : n->lp.last();
+  char buf[Listpack::kIntBufSize];
+  const Slice v = n->lp.get(p, buf);
+  out->assign(v.data, v.len);
+  n->lp.erase(p);
+  n->bytes = static_cast<uint32_t>(n->lp.bytes());
+  --n->count;
+  --count_;
+
+  if (n->count == 0) {
+    if (n->prev)
+      n->prev->next = n->next;
+    else
+      head_ = n->next;
+    if (n->next)
+      n->next->prev = n->prev;
+    else
+      tail_ = n->prev;
+    _FreeNode(n);
+    --nodes_;
+    _UpdateCompression();
+  }
+  return true;
+}
+
+bool Quicklist::index(long long index, std::string* out) const {
+  const long long n = static_cast<long long>(count_);
+  if (index < 0)
+    index += n;
+  if (index < 0 || index >= n)
+    return false;
+  std::size_t offset;
+  const Node* node = _Locate(static_cast<std::size_t>(index), &offset);
+  NodeView view(node);
+  const Listpack& lp = view.listpack();
+  char buf[Listpack::kIntBufSize];
+  const Slice v = lp.get(lp.seek(static_cast<long long>(offset)), buf);
+  out->assign(v.data, v.len);
+  return true;
+}
+
+std::size_t Quicklist::allocatedBytes() const {
+  std::size_t bytes = 0;
+  for (const Node* n = head_; n; n = n->next) {
+    bytes += mallocUsableSize(n);
+    bytes += n->lzf ? mallocUsableSize(n->lzf) : mallocUsableSize(n->lp.data());
+  }
+  return bytes;
+}
+
+Quicklist::NodeView::NodeView(const Node* n) : owned_(n->lzf != nullptr) {
+  if (!owned_) {
+    lp_ = n->lp;
+    return;
+  }
+  unsigned char* buf = static_cast<unsigned char*>(std::malloc(n->bytes));
+  if (!buf)
+    throw std::bad_alloc();
+  lzfDecompress(n->lzf, n->lzfBytes, buf, n->bytes);
+  lp_ = Listpack::fromBuffer(buf);
+}
+
+Quicklist::NodeView::~NodeView() {
+  if (owned_)
+    lp_.destroy();
+}
+
+const Quicklist::Node* Quicklist::_Locate(std::size_t index,
+                                          std::size_t* offset) const {
+  if (index < count_ / 2) {
+    const Node* n = head_;
+    while (index >= n->count) {
+      index -= n->count;
+      n = n->next;
+    }
+    *offset = index;
+    return n;
+  }
+  // 从尾部往前跳，rest 是目标之后（含目标）的元素个数
+  std::size_t rest = count_ - index;
+  const Node* n = tail_;
+  while (rest > n->count) {
+    rest -= n->count;
+    n = n->prev;
+  }
+  *offset = n->count - rest;
+  return n;
+}
+
+void Quicklist::_UpdateCompression() {
+  if (depth_ == 0)
+    return;
+  // 两端 depth_ 个节点解压；节点不超过 2 * depth_ 个时全部在这个范围内
+  Node* front = head_;
+  Node* back = tail_;
+  for (std::size_t i = 0; i < depth_ && front; ++i) {
+    _Decompress(front);
+    _Decompress(back);
+    front = front->next;
+    back = back->prev;
+  }
+  if (nodes_ > 2 * depth_) {
+    _Compress(front);
+    _Compress(back);
+  }
+}
+
+void Quicklist::_Compress(Node* n) {
+  if (n->lzf || n->bytes < kMinCompressBytes)
+    return;
+  const std::size_t cap = n->bytes - kMinCompressSaving;
+  unsigned char* out = static_cast<unsigned char*>(std::malloc(cap));
+  if (!out)
+    throw std::bad_alloc();
+  const std::size_t len = lzfCompress(n->lp.data(), n->bytes, out, cap);
+  if (len == 0) {
+    std::free(out);
+    return;
+  }
+  // 按实际大小收缩，realloc 失败时保留原缓冲区
+  unsigned char* shrunk = static_cast<unsigned char*>(std::realloc(out, len));
+  n->lzf = shrunk ? shrunk : out;
+  n->lzfBytes = static_cast<uint32_t>(len);
+  n->lp.destroy();
+}
+
+void Quicklist::_Decompress(Node* n) {
+  if (!n->lzf)
+    return;
+  unsigned char* buf = static_cast<unsigned char*>(std::malloc(n->bytes));
+  if (!buf)
+    throw std::bad_alloc();
+  lzfDecompress(n->lzf, n->lzfBytes, buf, n->bytes);
+  std::free(n->lzf);
+  n->lzf = nullptr;
+  n->lzfBytes = 0;
+  n->lp = Listpack::fromBuffer(buf);
+}
+
+void Quicklist::_FreeNode(Node* n) {
+  if (n->lzf)
+    std::free(n->lzf);
+  else
+    n->lp.destroy();
+  delete n;
+}
+}  // namespace tinyredis
@@ -0,0 +1,387 @@
+#include <server/db/radixTree.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace tinyredis {
+namespace {
+const std::size_t kInitialCap = 4;
+const std::size_t kMaxCap = 256;
+
+void* checkedAlloc(std::size_t n) {
+  void* p = std::malloc(n);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+// 子节点指针放在分叉字节之后，按指针对齐
+std::size_t childrenOffset(std::size_t cap) {
+  const std::size_t align = alignof(RadixTree::Node*);
+  return (sizeof(RadixTree::Inner) + cap + align - 1) / align * align;
+}
+
+// 分叉字节中不小于 b 的第一个位置
+int lowerBound(const unsigned char* keys, int count, unsigned char b) {
+  return static_cast<int>(std::lower_bound(keys, keys + count, b) - keys);
+}
+}  // namespace
+
+RadixTree::~RadixTree() {
+  _Free(root_);
+}
+
+RadixTree::Node** RadixTree::_Children(Inner* n) {
+  return reinterpret_cast<Node**>(reinterpret_cast<char*>(n) +
+                                  childrenOffset(n->cap));
+}
+
+RadixTree::Node* const* RadixTree::_Children(const Inner* n) {
+  return reinterpret_cast<Node* const*>(reinterpret_cast<const char*>(n) +
+                                        childrenOffset(n->cap));
+}
+
+std::size_t RadixTree::_InnerBytes(std::size_t cap) {
+  return childrenOffset(cap) + cap * sizeof(Node*);
+}
+
+RadixTree::Leaf* RadixTree::_NewLeaf(const unsigned char* key, void* value) {
+  Leaf* l = static_cast<Leaf*>(checkedAlloc(sizeof(Leaf)));
+  l->leaf = 1;
+  std::memcpy(l->key, key, kKeyLen);
+  l->value = value;
+  bytes_ += sizeof(Leaf);
+  return l;
+}
+
+RadixTree::Inner* RadixTree::_NewInner(const unsigned char* prefix,
+                                       std::size_t prefixLen,
+                                       std::size_t cap) {
+  Inner* n = static_cast<Inner*>(checkedAlloc(_InnerBytes(cap)));
+  n->leaf = 0;
+  n->prefixLen = static_cast<uint8_t>(prefixLen);
+  n->count = 0;
+  n->cap = static_cast<uint16_t>(cap);
+  std::memcpy(n->prefix, prefix, prefixLen);
+  bytes_ += _InnerBytes(cap);
+  return n;
+}
+
+void RadixTree::_AddChild(Node** slot, unsigned char b, Node* child) {
+  Inner* n = static_cast<Inner*>(*slot);
+  if (n->count == n->cap) {
+    const std::size_t cap = std::min<std::size_t>(n->cap * 2, kMaxCap);
+    Inner* grown = _NewInner(n->prefix, n->prefixLen, cap);
+    grown->count = n->count;
+    std::memcpy(_Keys(grown), _Keys(n), n->count);
+    std::memcpy(_Children(grown), _Children(n), n->count * sizeof(Node*));
+    _FreeNode(n);
+    *slot = grown;
+    n = grown;
+  }
+  unsigned char* keys = _Keys(n);
+  Node** children = _Children(n);
+  const int i = lowerBound(keys, n->count, b);
+  std::memmove(keys + i + 1, keys + i, n->count - i);
+  std::memmove(children + i + 1, children + i, (n->count - i) * sizeof(Node*));
+  keys[i] = b;
+  children[i] = child;
+  ++n->count;
+}
+
+bool RadixTree::insert(const unsigned char* key, void* value) {
+  Node** slot = &root_;
+  std::size_t depth = 0;
+  for (;;) {
+    Node* n = *slot;
+    if (!n) {
+      *slot = _NewLeaf(key, value);
+      break;
+    }
+    if (n->leaf) {
+      // 与叶子的键从 depth 起的公共部分成为新内部节点的前缀
+      Leaf* l = static_cast<Leaf*>(n);
+      std::size_t d = depth;
+      while (d < kKeyLen && l->key[d] == key[d])
+        ++d;
+      if (d == kKeyLen)
+        return false;
+      Node* split = _NewInner(key + depth, d - depth, 2);
+      _AddChild(&split, l->key[d], l);
+      _AddChild(&split, key[d], _NewLeaf(key, value));
+      *slot = split;
+      break;
+    }
+    Inner* in = static_cast<Inner*>(n);
+    std::size_t i = 0;
+    while (i < in->prefixLen && in->prefix[i] == key[depth + i])
+      ++i;
+    if (i < in->prefixLen) {
+      // 前缀在第 i 个字节分叉：公共部分成为新的父节点，原节点去掉前 i + 1 个字节
+      Node* split = _NewInner(in->prefix, i, 2);
+      const unsigned char b = in->prefix[i];
+      in->prefixLen = static_cast<uint8_t>(in->prefixLen - i - 1);
+      std::memmove(in->prefix, in->prefix + i + 1, in->prefixLen);
+      _AddChild(&split, b, in);
+      _AddChild(&split, key[depth + i], _NewLeaf(key, value));
+      *slot = split;
+      break;
+    }
+    depth += in->prefixLen;
+    const unsigned char b = key[depth];
+    const int idx = lowerBound(_Keys(in), in->count, b);
+    if (idx == in->count || _Keys(in)[idx] != b) {
+      _AddChild(slot, b, _NewLeaf(key, value));
+      break;
+    }
+    slot = &_Children(in)[idx];
+    ++depth;
+  }
+  ++size_;
+  return true;
+}
+
+void** RadixTree::find(const unsigned char* key) const {
+  Node* n = root_;
+  std::size_t depth = 0;
+  while (n && !n->leaf) {
+    Inner* in = static_cast<Inner*>(n);
+    if (std::memcmp(in->prefix, key + depth, in->prefixLen) != 0)
+      return nullptr;
+    depth += in->prefixLen;
+    const int idx = lowerBound(_Keys(in), in->count, key[depth]);
+    if (idx == in->count || _Keys(in)[idx] != key[depth])
+      return nullptr;
+    n = _Children(in)[idx];
+    ++depth;
+  }
+  if (!n)
+    return nullptr;
+  Leaf* l = static_cast<Leaf*>(n);
+  return std::memcmp(l->key, key, kKeyLen) == 0 ? &l->value : nullptr;
+}
+
+bool RadixTree::erase(const unsigned char* key, void** old) {
+  Node** slot = &root_;
+  Node** parentSlot = nullptr;
+  int parentIdx = 0;
+  std::size_t depth = 0;
+  while (*slot && !(*slot)->leaf) {
+    Inner* in = static_cast<Inner*>(*slot);
+    if (std::memcmp(in->prefix, key + depth, in->prefixLen) != 0)
+      return false;
+    depth += in->prefixLen;
+    const int idx = lowerBound(_Keys(in), in->count, key[depth]);
+    if (idx == in->count || _Keys(in)[idx] != key[depth])
+      return false;
+    parentSlot = slot;
+    parentIdx = idx;
+    slot = &_Children(in)[idx];
+    ++depth;
+  }
+  Leaf* l = static_cast<Leaf*>(*slot);
+  if (!l || std::memcmp(l->key, key, kKeyLen) != 0)
+    return false;
+  if (old)
+    *old = l->value;
+  _FreeNode(l);
+  --size_;
+  if (!parentSlot) {
+    root_ = nullptr;
+    return true;
+  }
+
+  Inner* p = static_cast<Inner*>(*parentSlot);
+  unsigned char* keys = _Keys(p);
+  Node** children = _Children(p);
+  --p->count;
+  std::memmove(keys + parentIdx, keys + parentIdx + 1, p->count - parentIdx);
+  std::memmove(children + parentIdx, children + parentIdx + 1,
+               (p->count - parentIdx) * sizeof(Node*));
+  if (p->count == 1) {
+    // 只剩一个分叉：把子节点接到 p 的位置，p 的前缀和分叉字节并入子节点的前缀
+    Node* child = children[0];
+    if (!child->leaf) {
+      Inner* c = static_cast<Inner*>(child);
+      const std::size_t add = p->prefixLen + 1u;
+      std::memmove(c->prefix + add, c->prefix, c->prefixLen);
+      std::memcpy(c->prefix, p->prefix, p->prefixLen);
+      c->prefix[p->prefixLen] = keys[0];
+      c->prefixLen = static_cast<uint8_t>(c->prefixLen + add);
+    }
+    _FreeNode(p);
+    *parentSlot = child;
+  }
+  return true;
+}
+
+void RadixTree::_FreeNode(Node* n) {
+  bytes_ -= n->leaf ? sizeof(Leaf) : _InnerBytes(static_cast<Inner*>(n)->cap);
+  std::free(n);
+}
+
+void RadixTree::_Free(Node* n) {
+  if (!n)
+    return;
+  if (!n->leaf) {
+    Inner* in = static_cast<Inner*>(n);
+    for (int i = 0; i < in->count; ++i)
+      _Free(_Children(in)[i]);
+  }
+  _FreeNode(n);
+}
+
+void RadixTree::Cursor::_Push(const Inner* n, int index) {
+  nodes_[depth_] = n;
+  indexes_[depth_] = index;
+  ++depth_;
+}
+
+void RadixTree::Cursor::_DescendMin(const Node* node) {
+  while (!node->leaf) {
+    const Inner* in = static_cast<const Inner*>(node);
+    _Push(in, 0);
+    node = _Children(in)[0];
+  }
+  leaf_ = static_cast<const Leaf*>(node);
+}
+
+void RadixTree::Cursor::_DescendMax(const Node* node) {
+  while (!node->leaf) {
+    const Inner* in = static_cast<const Inner*>(node);
+    _Push(in, in->count - 1);
+    node = _Children(in)[in->count - 1];
+  }
+  leaf_ = static_cast<const Leaf*>(node);
+}
+
+bool RadixTree::Cursor::first() {
+  depth_ = 0;
+  leaf_ = nullptr;
+  if (!tree_.root_)
+    return false;
+  _DescendMin(tree_.root_);
+  return true;
+}
+
+bool RadixTree::Cursor::last() {
+  depth_ = 0;
+  leaf_ = nullptr;
+  if (!tree_.root_)
+    return false;
+  _DescendMax(tree_.root_);
+  return true;
+}
+
+bool RadixTree::Cursor::seekCeil(const unsigned char* key) {
+  depth_ = 0;
+  leaf_ = nullptr;
+  return tree_.root_ && _SeekCeil(tree_.root_, key, 0);
+}
+
+bool RadixTree::Cursor::seekFloor(const unsigned char* key) {
+  depth_ = 0;
+  leaf_ = nullptr;
+  return tree_.root_ && _SeekFloor(tree_.root_, key, 0);
+}
+
+// 失败时不在栈上留下任何节点
+bool RadixTree::Cursor::_SeekCeil(const Node* node, const unsigned char* key,
+                                  std::size_t depth) {
+  if (node->leaf) {
+    const Leaf* l = static_cast<const Leaf*>(node);
+    if (std::memcmp(l->key, key, kKeyLen) < 0)
+      return false;
+    leaf_ = l;
+    return true;
+  }
+  const Inner* in = static_cast<const Inner*>(node);
+  const int cmp = std::memcmp(in->prefix, key + depth, in->prefixLen);
+  if (cmp != 0) {
+    if (cmp < 0)
+      return false;
+    _DescendMin(in);
+    return true;
+  }
+  depth += in->prefixLen;
+  const unsigned char* keys = _Keys(in);
+  int i = lowerBound(keys, in->count, key[depth]);
+  if (i < in->count && keys[i] == key[depth]) {
+    _Push(in, i);
+    if (_SeekCeil(_Children(in)[i], key, depth + 1))
+      return true;
+    --depth_;
+    ++i;
+  }
+  if (i == in->count)
+    return false;
+  _Push(in, i);
+  _DescendMin(_Children(in)[i]);
+  return true;
+}
+
+bool RadixTree::Cursor::_SeekFloor(const Node* node, const unsigned char* key,
+                                   std::size_t depth) {
+  if (node->leaf) {
+    const Leaf* l = static_cast<const Leaf*>(node);
+    if (std::memcmp(l->key, key, kKeyLen) > 0)
+      return false;
+    leaf_ = l;
+    return true;
+  }
+  const Inner* in = static_cast<const Inner*>(node);
+  const int cmp = std::memcmp(in->prefix, key + depth, in->prefixLen);
+  if (cmp != 0) {
+    if (cmp > 0)
+      return false;
+    _DescendMax(in);
+    return true;
+  }
+  depth += in->prefixLen;
+  const unsigned char* keys = _Keys(in);
+  // 不大于分叉字节的最后一个位置
+  int i = lowerBound(keys, in->count, key[depth]);
+  if (i < in->count && keys[i] == key[depth]) {
+    _Push(in, i);
+    if (_SeekFloor(_Children(in)[i], key, depth + 1))
+      return true;
+    --depth_;
+  }
+  if (i == 0)
+    return false;
+  _Push(in, i - 1);
+  _DescendMax(_Children(in)[i - 1]);
+  return true;
+}
+
+bool RadixTree::Cursor::next() {
+  while (depth_ > 0) {
+    const Inner* in = nodes_[depth_ - 1];
+    const int i = indexes_[depth_ - 1] + 1;
+    if (i < in->count) {
+      indexes_[depth_ - 1] = i;
+      _DescendMin(_Children(in)[i]);
+      return true;
+    }
+    --depth_;
+  }
+  leaf_ = nullptr;
+  return false;
+}
+
+bool RadixTree::Cursor::prev() {
+  while (depth_ > 0) {
+    const Inner* in = nodes_[depth_ - 1];
+    const int i = indexes_[depth_ - 1] - 1;
+    if (i >= 0) {
+      indexes_[depth_ - 1] = i;
+      _DescendMax(_Children(in)[i]);
+      return true;
+    }
+    --depth_;
+  }
+  leaf_ = nullptr;
+  return false;
+}
+}  // namespace tinyredis
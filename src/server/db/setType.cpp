@@ -0,0 +1,202 @@
+#include <server/db/intsetIntersect.h>
+#include <server/db/setType.h>
+#include <server/util/numbers.h>
+#include <algorithm>
+#include <cstring>
+
+namespace tinyredis {
+namespace setType {
+namespace {
+int64_t valueAt(const IntArray& a, std::size_t i) {
+  const unsigned char* p = static_cast<const unsigned char*>(a.data);
+  switch (a.width) {
+    case 2: {
+      int16_t v;
+      std::memcpy(&v, p + i * 2, 2);
+      return v;
+    }
+    case 4: {
+      int32_t v;
+      std::memcpy(&v, p + i * 4, 4);
+      return v;
+    }
+    default: {
+      int64_t v;
+      std::memcpy(&v, p + i * 8, 8);
+      return v;
+    }
+  }
+}
+
+std::size_t decimalLength(int64_t v) {
+  char buf[Object::kIntBufSize];
+  char* end = buf + sizeof(buf);
+  return static_cast<std::size_t>(end - formatDecimal(end, v));
+}
+
+// 与 Redis 相同：intset 加入非整数时，个数和最长成员都在 listpack 阈值内才转为
+// listpack，否则直接转为哈希表。最长的十进制表示一定在最小或最大的元素上
+void convertIntset(Object& o, const Slice& member, const EncodingConfig& cfg) {
+  const Intset& is = o.intset();
+  const std::size_t n = is.size();
+  const std::size_t longest =
+      n ? std::max(decimalLength(is.get(0)), decimalLength(is.get(n - 1)))
+        : 0;
+  if (n + 1 > cfg.setMaxListpackEntries ||
+      member.len > cfg.setMaxListpackValue ||
+      longest > cfg.setMaxListpackValue) {
+    convert(o);
+    return;
+  }
+  Listpack lp = Listpack::create();
+  forEach(o, [&lp](const Slice& m) { lp.append(m); });
+  o.adoptListpack(lp);
+}
+
+// 全部是 intset 的交集：从最小的两个开始，中间结果只会越来越少，
+// 放在两块缓冲区里交替使用，宽度取参与过的集合中最窄的
+std::size_t intersectIntsets(const std::vector<Object*>& sets,
+                             std::size_t limit,
+                             std::vector<std::string>* out) {
+  std::vector<int64_t> bufs[2];
+  IntArray cur = IntArray::of(sets[0]->intset());
+  std::size_t n = 0;
+  for (std::size_t k = 1; k < sets.size(); ++k) {
+    const bool last = k + 1 == sets.size();
+    const IntArray other = IntArray::of(sets[k]->intset());
+    void* dst = nullptr;
+    if (!last || out) {
+      bufs[k % 2].resize(cur.size);
+      dst = bufs[k % 2].data();
+    }
+    n = intersect(cur, other, dst, last ? limit : 0);
+    cur = IntArray{dst, n, std::min(cur.width, other.width)};
+    if (n == 0)
+      return 0;
+  }
+  if (out) {
+    char buf[Object::kIntBufSize];
+    char* end = buf + sizeof(buf);
+    out->reserve(out->size() + n);
+    for (std::size_t i = 0; i < n; ++i) {
+      const char* p = formatDecimal(end, valueAt(cur, i));
+      out->emplace_back(p, static_cast<std::size_t>(end - p));
+    }
+  }
+  return n;
+}
+}  // namespace
+
+Object create() {
+  return Object::createAggregate(Object::Type::kSet);
+}
+
+Object create(const Slice& first) {
+  long long v;
+  if (tryParseInt(first.data, first.len, v))
+    return Object::createIntset();
+  return create();
+}
+
+std::size_t size(const Object& o) {
+  if (o.encoding() == Object::Encoding::kIntset)
+    return o.intset().size();
+  if (o.encoding() == Object::Encoding::kListpack)
+    return o.listpack().size();
+  return const_cast<Object&>(o).setDict().size();
+}
+
+bool contains(Object& o, const Slice& member) {
+  if (o.encoding() == Object::Encoding::kIntset) {
+    long long v;
+    return tryParseInt(member.data, member.len, v) && o.intset().contains(v);
+  }
+  if (o.encoding() == Object::Encoding::kListpack) {
+    const Listpack& lp = o.listpack();
+    return lp.find(lp.first(), member, 0) != Listpack::npos;
+  }
+  return o.setDict().find(member) != nullptr;
+}
+
+bool add(Object& o, const Slice& member, const EncodingConfig& cfg) {
+  if (o.encoding() == Object::Encoding::kIntset) {
+    long long v;
+    if (tryParseInt(member.data, member.len, v)) {
+      Intset& is = o.intset();
+      if (is.contains(v))
+        return false;
+      if (is.size() + 1 <= cfg.setMaxIntsetEntries)
+        return is.add(v);
+      convert(o);
+    } else {
+      convertIntset(o, member, cfg);
+    }
+  }
+  if (o.encoding() == Object::Encoding::kListpack) {
+    Listpack& lp = o.listpack();
+    if (lp.find(lp.first(), member, 0) != Listpack::npos)
+      return false;
+    if (lp.size() + 1 <= cfg.setMaxListpackEntries &&
+        member.len <= cfg.setMaxListpackValue) {
+      lp.append(member);
+      return true;
+    }
+    convert(o);
+  }
+  return o.setDict().insert(member.toString()).second;
+}
+
+bool erase(Object& o, const Slice& member) {
+  if (o.encoding() == Object::Encoding::kIntset) {
+    long long v;
+    return tryParseInt(member.data, member.len, v) && o.intset().erase(v);
+  }
+  if (o.encoding() == Object::Encoding::kListpack) {
+    Listpack& lp = o.listpack();
+    const std::size_t p = lp.find(lp.first(), member, 0);
+    if (p == Listpack::npos)
+      return false;
+    lp.erase(p);
+    return true;
+  }
+  return o.setDict().erase(member);
+}
+
+void convert(Object& o) {
+  Object::SetDict* d = new Object::SetDict;
+  d->reserve(size(o));
+  forEach(o, [d](const Slice& member) { d->insert(member.toString()); });
+  o.adoptSetDict(d);
+}
+
+std::size_t intersect(std::vector<Object*>& sets, std::size_t limit,
+                      std::vector<std::string>* out) {
+  std::sort(sets.begin(), sets.end(), [](const Object* a, const Object* b) {
+    return size(*a) < size(*b);
+  });
+  if (sets.empty() || size(*sets[0]) == 0)
+    return 0;
+  const bool intsets =
+      sets.size() > 1 &&
+      std::all_of(sets.begin(), sets.end(), [](const Object* o) {
+        return o->encoding() == Object::Encoding::kIntset;
+      });
+  if (intsets)
+    return intersectIntsets(sets, limit, out);
+
+  std::size_t n = 0;
+  forEach(*sets[0], [&](const Slice& member) {
+    if (limit && n == limit)
+      return;
+    for (std::size_t k = 1; k < sets.size(); ++k) {
+      if (!contains(*sets[k], member))
+        return;
+    }
+    if (out)
+      out->push_back(member.toString());
+    ++n;
+  });
+  return n;
+}
+}  // namespace setType
+}  // namespace tinyredis
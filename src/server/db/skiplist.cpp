@@ -0,0 +1,230 @@
+#include <server/db/skiplist.h>
+#include <server/util/memory.h>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace tinyredis {
+const int SkipList::kMaxLevel;
+const std::size_t SkipList::npos;
+
+namespace {
+// 与 Redis 相同，每升一层的概率为 1/4
+const uint32_t kLevelP = 0x40000000;  // UINT32_MAX / 4
+
+int compareMember(const std::string& a, const Slice& b) {
+  const std::size_t n = a.size() < b.len ? a.size() : b.len;
+  const int c = n ? std::memcmp(a.data(), b.data, n) : 0;
+  if (c != 0)
+    return c;
+  return a.size() < b.len ? -1 : (a.size() > b.len ? 1 : 0);
+}
+
+// 节点 n 是否排在 (score, member) 之前
+bool before(const SkipList::Node* n, double score, const Slice& member) {
+  return n->score < score ||
+         (n->score == score && compareMember(n->member, member) < 0);
+}
+
+bool same(const SkipList::Node* n, double score, const Slice& member) {
+  return n->score == score && compareMember(n->member, member) == 0;
+}
+}  // namespace
+
+SkipList::SkipList()
+    : header_(_CreateNode(kMaxLevel, 0, Slice{"", 0})),
+      tail_(nullptr),
+      length_(0),
+      level_(1),
+      rng_(0x9E3779B97F4A7C15ULL) {
+  for (int i = 0; i < kMaxLevel; ++i) {
+    header_->level[i].forward = nullptr;
+    header_->level[i].span = 0;
+  }
+  header_->backward = nullptr;
+}
+
+SkipList::~SkipList() {
+  Node* n = header_->level[0].forward;
+  while (n) {
+    Node* next = n->level[0].forward;
+    _FreeNode(n);
+    n = next;
+  }
+  _FreeNode(header_);
+}
+
+SkipList::Node* SkipList::insert(double score, const Slice& member) {
+  Node* update[kMaxLevel];
+  std::size_t rank[kMaxLevel];
+  Node* x = header_;
+  for (int i = level_ - 1; i >= 0; --i) {
+    rank[i] = i == level_ - 1 ? 0 : rank[i + 1];
+    while (x->level[i].forward && before(x->level[i].forward, score, member)) {
+      rank[i] += x->level[i].span;
+      x = x->level[i].forward;
+    }
+    update[i] = x;
+  }
+
+  const int level = _RandomLevel();
+  if (level > level_) {
+    for (int i = level_; i < level; ++i) {
+      rank[i] = 0;
+      update[i] = header_;
+      update[i]->level[i].span = length_;
+    }
+    level_ = level;
+  }
+
+  x = _CreateNode(level, score, member);
+  for (int i = 0; i < level; ++i) {
+    x->level[i].forward = update[i]->level[i].forward;
+    update[i]->level[i].forward = x;
+    // update[i] 到 x 之间跨过的元素数为 rank[0] - rank[i]
+    x->level[i].span = update[i]->level[i].span - (rank[0] - rank[i]);
+    update[i]->level[i].span = (rank[0] - rank[i]) + 1;
+  }
+  // 更高的层没有指向 x，跨度加一
+  for (int i = level; i < level_; ++i)
+    ++update[i]->level[i].span;
+
+  x->backward = update[0] == header_ ? nullptr : update[0];
+  if (x->level[0].forward)
+    x->level[0].forward->backward = x;
+  else
+    tail_ = x;
+  ++length_;
+  return x;
+}
+
+bool SkipList::erase(double score, const Slice& member) {
+  Node* update[kMaxLevel];
+  Node* x = header_;
+  for (int i = level_ - 1; i >= 0; --i) {
+    while (x->level[i].forward && before(x->level[i].forward, score, member))
+      x = x->level[i].forward;
+    update[i] = x;
+  }
+  x = x->level[0].forward;
+  if (!x || !same(x, score, member))
+    return false;
+  _Unlink(x, update);
+  _FreeNode(x);
+  return true;
+}
+
+SkipList::Node* SkipList::updateScore(double score, const Slice& member,
+                                      double newScore) {
+  Node* update[kMaxLevel];
+  Node* x = header_;
+  for (int i = level_ - 1; i >= 0; --i) {
+    while (x->level[i].forward && before(x->level[i].forward, score, member))
+      x = x->level[i].forward;
+    update[i] = x;
+  }
+  x = x->level[0].forward;
+  if (!x || !same(x, score, member))
+    return nullptr;
+
+  // 新分数仍在前后两个元素之间时不必移动
+  const Slice m{x->member.data(), x->member.size()};
+  if ((!x->backward || before(x->backward, newScore, m)) &&
+      (!x->level[0].forward || !before(x->level[0].forward, newScore, m))) {
+    x->score = newScore;
+    return x;
+  }
+  const std::string saved = x->member;
+  _Unlink(x, update);
+  _FreeNode(x);
+  return insert(newScore, Slice{saved.data(), saved.size()});
+}
+
+std::size_t SkipList::rank(double score, const Slice& member) const {
+  std::size_t r = 0;
+  const Node* x = header_;
+  for (int i = level_ - 1; i >= 0; --i) {
+    while (x->level[i].forward &&
+           (before(x->level[i].forward, score, member) ||
+            same(x->level[i].forward, score, member))) {
+      r += x->level[i].span;
+      x = x->level[i].forward;
+    }
+    if (x != header_ && same(x, score, member))
+      return r - 1;
+  }
+  return npos;
+}
+
+SkipList::Node* SkipList::byRank(std::size_t rank) const {
+  if (rank >= length_)
+    return nullptr;
+  // span 从 1 开始计数
+  const std::size_t target = rank + 1;
+  std::size_t traversed = 0;
+  Node* x = header_;
+  for (int i = level_ - 1; i >= 0; --i) {
+    while (x->level[i].forward && traversed + x->level[i].span <= target) {
+      traversed += x->level[i].span;
+      x = x->level[i].forward;
+    }
+    if (traversed == target)
+      return x;
+  }
+  return nullptr;
+}
+
+std::size_t SkipList::nodeBytes(const Node* n) {
+  return mallocUsableSize(n) + stringHeapBytes(n->member);
+}
+
+SkipList::Node* SkipList::_CreateNode(int level, double score,
+                                      const Slice& member) {
+  const std::size_t bytes =
+      sizeof(Node) + static_cast<std::size_t>(level - 1) * sizeof(Node::Level);
+  void* mem = std::malloc(bytes);
+  if (!mem)
+    throw std::bad_alloc();
+  Node* n = static_cast<Node*>(mem);
+  new (&n->member) std::string(member.data, member.len);
+  n->score = score;
+  n->backward = nullptr;
+  return n;
+}
+
+void SkipList::_FreeNode(Node* n) {
+  n->member.~basic_string();
+  std::free(n);
+}
+
+int SkipList::_RandomLevel() {
+  int level = 1;
+  for (;;) {
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 7;
+    rng_ ^= rng_ << 17;
+    if (static_cast<uint32_t>(rng_ >> 32) >= kLevelP || level >= kMaxLevel)
+      break;
+    ++level;
+  }
+  return level;
+}
+
+void SkipList::_Unlink(Node* x, Node** update) {
+  for (int i = 0; i < level_; ++i) {
+    if (update[i]->level[i].forward == x) {
+      update[i]->level[i].span += x->level[i].span - 1;
+      update[i]->level[i].forward = x->level[i].forward;
+    } else {
+      --update[i]->level[i].span;
+    }
+  }
+  if (x->level[0].forward)
+    x->level[0].forward->backward = x->backward;
+  else
+    tail_ = x->backward;
+  while (level_ > 1 && header_->level[level_ - 1].forward == nullptr)
+    --level_;
+  --length_;
+}
+}  // namespace tinyredis
@@ -0,0 +1,533 @@
+#include <server/db/stream.h>
+#include <server/protocol/respShared.h>
+#include <server/util/memory.h>
+#include <iterator>
+#include <mutex>
+
+namespace tinyredis {
+namespace {
+const long long kFlagDeleted = 1;
+const long long kFlagSameFields = 2;
+
+// 所有组的等待队列与等待者的 waits_ 共用一把锁；XADD 只读各组的计数，不取这把锁
+std::mutex waitMutex;
+
+Slice formatInteger(char* buf, long long v) {
+  char* end = buf + Listpack::kIntBufSize;
+  char* p = formatDecimal(end, v);
+  return Slice{p, static_cast<std::size_t>(end - p)};
+}
+
+void appendInteger(Listpack& lp, long long v) {
+  char buf[Listpack::kIntBufSize];
+  lp.append(formatInteger(buf, v));
+}
+
+void replaceInteger(Listpack& lp, std::size_t pos, long long v) {
+  char buf[Listpack::kIntBufSize];
+  lp.replace(pos, formatInteger(buf, v));
+}
+
+// 节点里的计数与差值都按整数编码写入
+long long integerAt(const Listpack& lp, std::size_t pos) {
+  long long v = 0;
+  lp.getInteger(pos, &v);
+  return v;
+}
+
+std::size_t skip(const Listpack& lp, std::size_t pos, std::size_t n) {
+  for (; n > 0; --n)
+    pos = lp.next(pos);
+  return pos;
+}
+
+Listpack nodeOf(void* value) {
+  return Listpack::fromBuffer(static_cast<unsigned char*>(value));
+}
+
+void* bufferOf(const Listpack& lp) {
+  return const_cast<unsigned char*>(lp.data());
+}
+
+// 解析 master 条目，返回结尾 0 的位置
+std::size_t parseMaster(const Listpack& lp, std::size_t* numFields,
+                        std::size_t* fields) {
+  const std::size_t p = skip(lp, lp.first(), 2);
+  *numFields = static_cast<std::size_t>(integerAt(lp, p));
+  *fields = lp.next(p);
+  return skip(lp, p, *numFields + 1);
+}
+}  // namespace
+
+void StreamId::encode(unsigned char* out) const {
+  for (int i = 0; i < 8; ++i) {
+    out[i] = static_cast<unsigned char>(ms >> (56 - 8 * i));
+    out[8 + i] = static_cast<unsigned char>(seq >> (56 - 8 * i));
+  }
+}
+
+StreamId StreamId::decode(const unsigned char* in) {
+  StreamId id{0, 0};
+  for (int i = 0; i < 8; ++i) {
+    id.ms = id.ms << 8 | in[i];
+    id.seq = id.seq << 8 | in[8 + i];
+  }
+  return id;
+}
+
+Stream::Stream() : length_(0), lastId_{0, 0}, tail_(nullptr),
+                   tailMaster_{0, 0} {}
+
+Stream::~Stream() {
+  // 键被删除或覆盖：阻塞的消费者醒来后会得到 NOGROUP 错误
+  for (auto& g : groups_) {
+    g.second->wakeAll();
+    delete g.second;
+  }
+  RadixTree::Cursor c(rax_);
+  for (bool ok = c.first(); ok; ok = c.next())
+    nodeOf(c.value()).destroy();
+}
+
+bool Stream::nextId(uint64_t nowMs, StreamId* id) const {
+  if (nowMs > lastId_.ms) {
+    *id = StreamId{nowMs, 0};
+  } else if (lastId_.seq != UINT64_MAX) {
+    *id = StreamId{lastId_.ms, lastId_.seq + 1};
+  } else if (lastId_.ms != UINT64_MAX) {
+    *id = StreamId{lastId_.ms + 1, 0};
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void Stream::append(const StreamId& id, const Slice* fields,
+                    std::size_t numFields, std::size_t nodeMaxBytes,
+                    std::size_t nodeMaxEntries) {
+  Listpack lp;
+  bool fresh = tail_ == nullptr;
+  if (!fresh) {
+    lp = nodeOf(*tail_);
+    std::size_t payload = 0;
+    for (std::size_t i = 0; i < numFields * 2; ++i)
+      payload += fields[i].len;
+    const std::size_t p = lp.first();
+    const std::size_t entries = static_cast<std::size_t>(
+        integerAt(lp, p) + integerAt(lp, lp.next(p)));
+    fresh = (nodeMaxBytes > 0 && lp.bytes() + payload >= nodeMaxBytes) ||
+            (nodeMaxEntries > 0 && entries >= nodeMaxEntries);
+    if (!fresh)
+      replaceInteger(lp, p, integerAt(lp, p) + 1);
+  }
+  if (fresh) {
+    // 新节点以这个条目的 ID 为 master ID、字段为 master 字段
+    lp = Listpack::create();
+    appendInteger(lp, 1);
+    appendInteger(lp, 0);
+    appendInteger(lp, static_cast<long long>(numFields));
+    for (std::size_t i = 0; i < numFields; ++i)
+      lp.append(fields[i * 2]);
+    appendInteger(lp, 0);
+    unsigned char key[RadixTree::kKeyLen];
+    id.encode(key);
+    rax_.insert(key, bufferOf(lp));
+    tail_ = rax_.find(key);
+    tailMaster_ = id;
+  }
+
+  std::size_t p = skip(lp, lp.first(), 2);
+  bool same = static_cast<std::size_t>(integerAt(lp, p)) == numFields;
+  for (std::size_t i = 0; same && i < numFields; ++i) {
+    p = lp.next(p);
+    same = lp.equals(p, fields[i * 2]);
+  }
+  appendInteger(lp, same ? kFlagSameFields : 0);
+  // 差值按补码回绕，读取时加回 master ID 得到原值
+  appendInteger(lp, static_cast<long long>(id.ms - tailMaster_.ms));
+  appendInteger(lp, static_cast<long long>(id.seq - tailMaster_.seq));
+  if (same) {
+    for (std::size_t i = 0; i < numFields; ++i)
+      lp.append(fields[i * 2 + 1]);
+    appendInteger(lp, static_cast<long long>(3 + numFields));
+  } else {
+    appendInteger(lp, static_cast<long long>(numFields));
+    for (std::size_t i = 0; i < numFields * 2; ++i)
+      lp.append(fields[i]);
+    appendInteger(lp, static_cast<long long>(4 + numFields * 2));
+  }
+  *tail_ = bufferOf(lp);
+  ++length_;
+  lastId_ = id;
+}
+
+std::size_t Stream::trim(const TrimArgs& args) {
+  std::size_t removed = 0;
+  RadixTree::Cursor c(rax_);
+  while (c.first()) {
+    if (args.strategy == TrimStrategy::kMaxLen &&
+        length_ <= static_cast<std::size_t>(args.maxLen))
+      break;
+    Listpack lp = nodeOf(c.value());
+    const StreamId master = StreamId::decode(c.key());
+    const std::size_t entries =
+        static_cast<std::size_t>(integerAt(lp, lp.first()));
+    const bool whole =
+        args.strategy == TrimStrategy::kMaxLen
+            ? length_ - entries >= static_cast<std::size_t>(args.maxLen)
+            : _LastId(lp, master) < args.minId;
+    if (!whole) {
+      // 近似裁剪不拆开节点
+      if (!args.approx)
+        removed += _TrimNode(rax_.find(c.key()), master, args);
+      break;
+    }
+    if (args.limit > 0 &&
+        removed + entries > static_cast<std::size_t>(args.limit))
+      break;
+    unsigned char key[RadixTree::kKeyLen];
+    master.encode(key);
+    rax_.erase(key);
+    lp.destroy();
+    if (master == tailMaster_)
+      tail_ = nullptr;
+    length_ -= entries;
+    removed += entries;
+  }
+  return removed;
+}
+
+std::size_t Stream::_TrimNode(void** slot, const StreamId& master,
+                              const TrimArgs& args) {
+  Listpack lp = nodeOf(*slot);
+  const std::size_t countPos = lp.first();
+  const std::size_t deletedPos = lp.next(countPos);
+  long long count = integerAt(lp, countPos);
+  long long deleted = integerAt(lp, deletedPos);
+  std::size_t numFields, fields;
+  std::size_t p = lp.next(parseMaster(lp, &numFields, &fields));
+  std::size_t removed = 0;
+  while (p != Listpack::npos) {
+    if (args.strategy == TrimStrategy::kMaxLen &&
+        length_ <= static_cast<std::size_t>(args.maxLen))
+      break;
+    const long long flags = integerAt(lp, p);
+    std::size_t q = lp.next(p);
+    const StreamId id{master.ms + static_cast<uint64_t>(integerAt(lp, q)),
+                      master.seq +
+                          static_cast<uint64_t>(integerAt(lp, lp.next(q)))};
+    std::size_t next = skip(lp, q, 2);
+    if (flags & kFlagSameFields)
+      next = skip(lp, next, numFields);
+    else
+      next = skip(lp, next,
+                  1 + 2 * static_cast<std::size_t>(integerAt(lp, next)));
+    next = lp.next(next);
+    if (!(flags & kFlagDeleted)) {
+      if (args.strategy == TrimStrategy::kMinId && id >= args.minId)
+        break;
+      // flags 的编码长度不变，原地修改，后面的位置仍然有效
+      replaceInteger(lp, p, flags | kFlagDeleted);
+      --count;
+      ++deleted;
+      --length_;
+      ++removed;
+    }
+    p = next;
+  }
+  // 计数的编码长度可能改变，从后往前改
+  replaceInteger(lp, deletedPos, deleted);
+  replaceInteger(lp, countPos, count);
+  *slot = bufferOf(lp);
+  return removed;
+}
+
+StreamId Stream::_LastId(const Listpack& lp, const StreamId& master) {
+  std::size_t p = lp.last();
+  for (long long n = integerAt(lp, p); n > 0; --n)
+    p = lp.prev(p);
+  p = lp.next(p);
+  return StreamId{master.ms + static_cast<uint64_t>(integerAt(lp, p)),
+                  master.seq +
+                      static_cast<uint64_t>(integerAt(lp, lp.next(p)))};
+}
+
+std::size_t Stream::allocatedBytes() const {
+  std::size_t bytes = rax_.nodeBytes();
+  RadixTree::Cursor c(rax_);
+  for (bool ok = c.first(); ok; ok = c.next())
+    bytes += mallocUsableSize(c.value());
+  for (const auto& g : groups_)
+    bytes += g.first.capacity() + g.second->allocatedBytes();
+  return bytes;
+}
+
+bool Stream::contains(const StreamId& id) const {
+  Iterator it(*this, id, id, false);
+  StreamId found;
+  return it.next(&found);
+}
+
+StreamGroup* Stream::group(const std::string& name) const {
+  auto it = groups_.find(name);
+  return it == groups_.end() ? nullptr : it->second;
+}
+
+StreamGroup* Stream::createGroup(const std::string& name,
+                                 const StreamId& lastId) {
+  auto res = groups_.insert(std::make_pair(name, nullptr));
+  if (!res.second)
+    return nullptr;
+  res.first->second = new StreamGroup(lastId);
+  return res.first->second;
+}
+
+bool Stream::destroyGroup(const std::string& name) {
+  auto it = groups_.find(name);
+  if (it == groups_.end())
+    return false;
+  it->second->wakeAll();
+  delete it->second;
+  groups_.erase(it);
+  return true;
+}
+
+void Stream::signalWaiters() {
+  for (const auto& g : groups_) {
+    if (g.second->hasWaiters() && g.second->lastId() < lastId_)
+      g.second->wakeOne();
+  }
+}
+
+void StreamWaiter::waitOn(StreamGroup* group) {
+  std::lock_guard<std::mutex> guard(waitMutex);
+  group->waiters_.push_back(this);
+  group->waiterCount_.fetch_add(1, std::memory_order_release);
+  waits_.push_back(std::make_pair(group, std::prev(group->waiters_.end())));
+}
+
+void StreamWaiter::cancelWait() {
+  std::lock_guard<std::mutex> guard(waitMutex);
+  _Unlink();
+}
+
+bool StreamWaiter::waiting() const {
+  std::lock_guard<std::mutex> guard(waitMutex);
+  return !waits_.empty();
+}
+
+void StreamWaiter::_Unlink() {
+  for (auto& w : waits_) {
+    w.first->waiters_.erase(w.second);
+    w.first->waiterCount_.fetch_sub(1, std::memory_order_release);
+  }
+  waits_.clear();
+}
+
+StreamGroup::~StreamGroup() {
+  RadixTree::Cursor c(pel_);
+  for (bool ok = c.first(); ok; ok = c.next())
+    delete static_cast<StreamNack*>(c.value());
+  for (auto& consumer : consumers_)
+    delete consumer.second;
+}
+
+StreamConsumer* StreamGroup::consumer(const std::string& name) const {
+  auto it = consumers_.find(name);
+  return it == consumers_.end() ? nullptr : it->second;
+}
+
+StreamConsumer* StreamGroup::createConsumer(const std::string& name,
+                                            bool* created) {
+  auto res = consumers_.insert(std::make_pair(name, nullptr));
+  *created = res.second;
+  if (res.second)
+    res.first->second = new StreamConsumer(name);
+  return res.first->second;
+}
+
+long long StreamGroup::deleteConsumer(const std::string& name) {
+  auto it = consumers_.find(name);
+  if (it == consumers_.end())
+    return -1;
+  StreamConsumer* c = it->second;
+  const long long pending = static_cast<long long>(c->pel.size());
+  RadixTree::Cursor cur(c->pel);
+  for (bool ok = cur.first(); ok; ok = cur.next()) {
+    pel_.erase(cur.key());
+    delete static_cast<StreamNack*>(cur.value());
+  }
+  delete c;
+  consumers_.erase(it);
+  return pending;
+}
+
+StreamNack* StreamGroup::nack(const StreamId& id) const {
+  unsigned char key[RadixTree::kKeyLen];
+  id.encode(key);
+  void** slot = pel_.find(key);
+  return slot ? static_cast<StreamNack*>(*slot) : nullptr;
+}
+
+StreamNack* StreamGroup::deliver(const StreamId& id, StreamConsumer* consumer,
+                                 uint64_t nowMs) {
+  unsigned char key[RadixTree::kKeyLen];
+  id.encode(key);
+  StreamNack* n;
+  void** slot = pel_.find(key);
+  if (slot) {
+    // SETID 回退后重新投递的条目：转给新的消费者
+    n = static_cast<StreamNack*>(*slot);
+    if (n->consumer != consumer) {
+      n->consumer->pel.erase(key);
+      consumer->pel.insert(key, n);
+      n->consumer = consumer;
+    }
+  } else {
+    n = new StreamNack{0, 0, consumer};
+    pel_.insert(key, n);
+    consumer->pel.insert(key, n);
+  }
+  n->deliveryTime = nowMs;
+  ++n->deliveryCount;
+  return n;
+}
+
+void StreamGroup::assign(const StreamId& id, StreamNack* nack,
+                         StreamConsumer* consumer) {
+  if (nack->consumer == consumer)
+    return;
+  unsigned char key[RadixTree::kKeyLen];
+  id.encode(key);
+  nack->consumer->pel.erase(key);
+  consumer->pel.insert(key, nack);
+  nack->consumer = consumer;
+}
+
+bool StreamGroup::ack(const StreamId& id) {
+  unsigned char key[RadixTree::kKeyLen];
+  id.encode(key);
+  void* value;
+  if (!pel_.erase(key, &value))
+    return false;
+  StreamNack* n = static_cast<StreamNack*>(value);
+  n->consumer->pel.erase(key);
+  delete n;
+  return true;
+}
+
+void StreamGroup::wakeOne() {
+  std::lock_guard<std::mutex> guard(waitMutex);
+  while (!waiters_.empty()) {
+    StreamWaiter* w = waiters_.front();
+    w->_Unlink();
+    if (w->_OnWake())
+      return;
+  }
+}
+
+void StreamGroup::wakeAll() {
+  std::lock_guard<std::mutex> guard(waitMutex);
+  while (!waiters_.empty()) {
+    StreamWaiter* w = waiters_.front();
+    w->_Unlink();
+    w->_OnWake();
+  }
+}
+
+std::size_t StreamGroup::allocatedBytes() const {
+  std::size_t bytes = sizeof(StreamGroup) + pel_.nodeBytes() +
+                      pel_.size() * sizeof(StreamNack);
+  for (const auto& c : consumers_)
+    bytes += sizeof(StreamConsumer) + c.first.capacity() +
+             c.second->name.capacity() + c.second->pel.nodeBytes();
+  return bytes;
+}
+
+Stream::Iterator::Iterator(const Stream& stream, const StreamId& start,
+                           const StreamId& end, bool rev)
+    : cursor_(stream.rax_), start_(start), end_(end), rev_(rev),
+      done_(true) {
+  unsigned char key[RadixTree::kKeyLen];
+  // 正向从 master ID 不大于 start 的最后一个节点开始，start 之前的节点都不含范围内的条目；
+  // 反向同理从包含 end 的节点开始
+  (rev ? end : start).encode(key);
+  if (start <= end &&
+      (cursor_.seekFloor(key) || (!rev && cursor_.first()))) {
+    done_ = false;
+    _LoadNode();
+  }
+}
+
+void Stream::Iterator::_LoadNode() {
+  lp_ = nodeOf(cursor_.value());
+  master_ = StreamId::decode(cursor_.key());
+  masterEnd_ = parseMaster(lp_, &masterNumFields_, &masterFields_);
+  pos_ = rev_ ? lp_.last() : lp_.next(masterEnd_);
+}
+
+std::size_t Stream::Iterator::_ParseEntry(std::size_t entry, StreamId* id,
+                                          bool* deleted) {
+  const long long flags = integerAt(lp_, entry);
+  std::size_t p = lp_.next(entry);
+  id->ms = master_.ms + static_cast<uint64_t>(integerAt(lp_, p));
+  p = lp_.next(p);
+  id->seq = master_.seq + static_cast<uint64_t>(integerAt(lp_, p));
+  p = lp_.next(p);
+  *deleted = (flags & kFlagDeleted) != 0;
+  sameFields_ = (flags & kFlagSameFields) != 0;
+  if (sameFields_) {
+    numFields_ = masterNumFields_;
+    fields_ = masterFields_;
+    values_ = p;
+    p = skip(lp_, p, numFields_);
+  } else {
+    numFields_ = static_cast<std::size_t>(integerAt(lp_, p));
+    fields_ = lp_.next(p);
+    values_ = lp_.next(fields_);
+    p = skip(lp_, fields_, numFields_ * 2);
+  }
+  return lp_.next(p);
+}
+
+bool Stream::Iterator::next(StreamId* id) {
+  while (!done_) {
+    StreamId cur;
+    bool deleted;
+    if (!rev_) {
+      if (pos_ == Listpack::npos) {
+        if (!cursor_.next())
+          break;
+        _LoadNode();
+        continue;
+      }
+      pos_ = _ParseEntry(pos_, &cur, &deleted);
+      if (deleted || cur < start_)
+        continue;
+      if (cur > end_)
+        break;
+    } else {
+      if (pos_ == masterEnd_) {
+        if (!cursor_.prev())
+          break;
+        _LoadNode();
+        continue;
+      }
+      // pos_ 是条目末尾的元素数，往前跳过这么多个元素就是条目的开头
+      std::size_t entry = pos_;
+      for (long long n = integerAt(lp_, pos_); n > 0; --n)
+        entry = lp_.prev(entry);
+      pos_ = lp_.prev(entry);
+      _ParseEntry(entry, &cur, &deleted);
+      if (deleted || cur > end_)
+        continue;
+      if (cur < start_)
+        break;
+    }
+    *id = cur;
+    return true;
+  }
+  done_ = true;
+  return false;
+}
+}  // namespace tinyredis
@@ -0,0 +1,214 @@
+#include <server/db/zsetType.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace tinyredis {
+namespace zsetType {
+namespace {
+// 绝对值在 2^53 以内的整数分数能精确表示，按整数存进 listpack 更省空间
+const double kMaxExactInteger = 9007199254740992.0;
+// %.17g 格式化一个 double 最多需要的字节数
+const std::size_t kScoreBufSize = 32;
+
+Slice formatScore(double score, char* buf) {
+  int n;
+  if (std::floor(score) == score && std::fabs(score) < kMaxExactInteger)
+    n = std::snprintf(buf, kScoreBufSize, "%lld",
+                      static_cast<long long>(score));
+  else
+    n = std::snprintf(buf, kScoreBufSize, "%.17g", score);
+  return Slice{buf, static_cast<std::size_t>(n)};
+}
+
+int compareMember(const Slice& a, const Slice& b) {
+  const std::size_t n = a.len < b.len ? a.len : b.len;
+  const int c = n ? std::memcmp(a.data, b.data, n) : 0;
+  if (c != 0)
+    return c;
+  return a.len < b.len ? -1 : (a.len > b.len ? 1 : 0);
+}
+
+// 在 listpack 中找成员，返回成员元素的位置
+std::size_t findMember(const Listpack& lp, const Slice& member) {
+  return lp.find(lp.first(), member, 1);
+}
+
+// 按 (分数, 成员) 有序插入一对元素
+void insertSorted(Listpack& lp, double score, const Slice& member) {
+  char buf[Listpack::kIntBufSize];
+  std::size_t p = lp.first();
+  while (p != Listpack::npos) {
+    const std::size_t s = lp.next(p);
+    const double cur = listpackScore(lp, s);
+    if (cur > score ||
+        (cur == score && compareMember(lp.get(p, buf), member) > 0))
+      break;
+    p = lp.next(s);
+  }
+  char sbuf[kScoreBufSize];
+  const Slice encoded = formatScore(score, sbuf);
+  if (p == Listpack::npos) {
+    lp.append(member);
+    lp.append(encoded);
+    return;
+  }
+  p = lp.insert(p, member);
+  lp.insert(lp.next(p), encoded);
+}
+}  // namespace
+
+double listpackScore(const Listpack& lp, std::size_t pos) {
+  long long v;
+  if (lp.getInteger(pos, &v))
+    return static_cast<double>(v);
+  char buf[Listpack::kIntBufSize];
+  const Slice s = lp.get(pos, buf);
+  char tmp[kScoreBufSize];
+  const std::size_t n = s.len < kScoreBufSize - 1 ? s.len : kScoreBufSize - 1;
+  std::memcpy(tmp, s.data, n);
+  tmp[n] = '\0';
+  return std::strtod(tmp, nullptr);
+}
+
+Object create() {
+  return Object::createAggregate(Object::Type::kZset);
+}
+
+std::size_t size(const Object& o) {
+  if (o.encoding() == Object::Encoding::kListpack)
+    return o.listpack().size() / 2;
+  return const_cast<Object&>(o).zsetTree().tree.size();
+}
+
+bool add(Object& o, double score, const Slice& member,
+         const EncodingConfig& cfg) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    Listpack& lp = o.listpack();
+    const std::size_t p = findMember(lp, member);
+    if (p != Listpack::npos) {
+      if (listpackScore(lp, lp.next(p)) != score) {
+        lp.erase(p, 2);
+        insertSorted(lp, score, member);
+      }
+      return false;
+    }
+    if (size(o) + 1 <= cfg.zsetMaxListpackEntries &&
+        member.len <= cfg.zsetMaxListpackValue) {
+      insertSorted(lp, score, member);
+      return true;
+    }
+    convert(o);
+  }
+  Object::ZsetTree& z = o.zsetTree();
+  std::pair<double*, bool> r = z.dict.insert(member.toString());
+  if (r.second) {
+    *r.first = score;
+    z.tree.insert(score, member);
+    return true;
+  }
+  if (*r.first != score) {
+    z.tree.updateScore(*r.first, member, score);
+    *r.first = score;
+  }
+  return false;
+}
+
+bool erase(Object& o, const Slice& member) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    Listpack& lp = o.listpack();
+    const std::size_t p = findMember(lp, member);
+    if (p == Listpack::npos)
+      return false;
+    lp.erase(p, 2);
+    return true;
+  }
+  Object::ZsetTree& z = o.zsetTree();
+  const double* s = z.dict.find(member);
+  if (!s)
+    return false;
+  z.tree.erase(*s, member);
+  z.dict.erase(member);
+  return true;
+}
+
+bool score(Object& o, const Slice& member, double* out) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    const Listpack& lp = o.listpack();
+    const std::size_t p = findMember(lp, member);
+    if (p == Listpack::npos)
+      return false;
+    *out = listpackScore(lp, lp.next(p));
+    return true;
+  }
+  const double* s = o.zsetTree().dict.find(member);
+  if (!s)
+    return false;
+  *out = *s;
+  return true;
+}
+
+bool rank(Object& o, const Slice& member, std::size_t* out) {
+  if (o.encoding() == Object::Encoding::kListpack) {
+    const Listpack& lp = o.listpack();
+    std::size_t r = 0;
+    for (std::size_t p = lp.first(); p != Listpack::npos;
+         p = lp.next(lp.next(p)), ++r) {
+      if (lp.equals(p, member)) {
+        *out = r;
+        return true;
+      }
+    }
+    return false;
+  }
+  Object::ZsetTree& z = o.zsetTree();
+  const double* s = z.dict.find(member);
+  if (!s)
+    return false;
+  *out = z.tree.rank(*s, member);
+  return true;
+}
+
+std::size_t rankRange(Object& o, const ScoreRange& range, std::size_t* first) {
+  std::size_t begin;
+  std::size_t end;
+  if (o.encoding() == Object::Encoding::kListpack) {
+    // 有序的 listpack 顺序扫描，begin/end 的含义与树的 countBelow 相同
+    const Listpack& lp = o.listpack();
+    begin = 0;
+    end = 0;
+    for (std::size_t p = lp.first(); p != Listpack::npos;) {
+      const std::size_t sp = lp.next(p);
+      const double s = listpackScore(lp, sp);
+      if (s < range.min || (range.minExclusive && s == range.min))
+        ++begin;
+      if (s < range.max || (!range.maxExclusive && s == range.max))
+        ++end;
+      else
+        break;
+      p = lp.next(sp);
+    }
+  } else {
+    const BPlusTree& tree = o.zsetTree().tree;
+    begin = tree.countBelow(range.min, range.minExclusive);
+    end = tree.countBelow(range.max, !range.maxExclusive);
+  }
+  *first = begin;
+  return end > begin ? end - begin : 0;
+}
+
+void convert(Object& o) {
+  Object::ZsetTree* z = new Object::ZsetTree;
+  const std::size_t n = size(o);
+  z->dict.reserve(n);
+  if (n > 0) {
+    range(o, 0, n - 1, [z](const Slice& member, double score) {
+      z->dict.set(member.toString(), score);
+      z->tree.insert(score, member);
+    });
+  }
+  o.adoptZsetTree(z);
+}
+}  // namespace zsetType
+}  // namespace tinyredis
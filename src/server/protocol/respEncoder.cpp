@@ -0,0 +1,230 @@
+#include <base/socket/streamSocket.h>
+#include <server/protocol/respEncoder.h>
+#include <server/protocol/respShared.h>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace tinyredis {
+namespace {
+const char kCRLF[] = "\r\n";
+
+// 与 Redis 一致：inf/-inf/nan 用文字，其余用 %.17g 保证往返精度
+std::size_t formatDouble(char* buf, std::size_t size, double v) {
+  if (std::isinf(v)) {
+    const char* s = v > 0 ? "inf" : "-inf";
+    std::size_t n = std::strlen(s);
+    std::memcpy(buf, s, n);
+    return n;
+  }
+  if (std::isnan(v)) {
+    std::memcpy(buf, "nan", 3);
+    return 3;
+  }
+  int n = std::snprintf(buf, size, "%.17g", v);
+  return n > 0 ? static_cast<std::size_t>(n) : 0;
+}
+}  // namespace
+
+void RespEncoder::simpleString(const char* s, std::size_t len) {
+  _Line('+', s, len);
+}
+
+void RespEncoder::error(const char* msg, std::size_t len) {
+  // 错误信息里可能带有用户输入，换行会破坏协议，替换成空格
+  std::string clean;
+  if (std::memchr(msg, '\r', len) || std::memchr(msg, '\n', len)) {
+    clean.assign(msg, len);
+    for (char& c : clean) {
+      if (c == '\r' || c == '\n')
+        c = ' ';
+    }
+    msg = clean.data();
+  }
+
+  // 与 Redis 一致：以 '-' 开头表示自带错误码（如 "-NOPROTO ..."），
+  // 以 "ERR" 开头的原样发送，其余补上 "ERR "
+  if (len > 0 && msg[0] == '-') {
+    _Line('-', msg + 1, len - 1);
+    return;
+  }
+  if (len >= 3 && std::memcmp(msg, "ERR", 3) == 0) {
+    _Line('-', msg, len);
+    return;
+  }
+  const char prefix[] = "-ERR ";
+  BufferSequence reply;
+  reply.buffers[0].iov_base = const_cast<char*>(prefix);
+  reply.buffers[0].iov_len = sizeof(prefix) - 1;
+  reply.buffers[1].iov_base = const_cast<char*>(msg);
+  reply.buffers[1].iov_len = len;
+  reply.buffers[2].iov_base = const_cast<char*>(kCRLF);
+  reply.buffers[2].iov_len = 2;
+  reply.count = 3;
+  out_->sendPacket(reply);
+}
+
+void RespEncoder::integer(long long v) {
+  if (v >= 0 && v < shared::kIntegers)
+    raw(shared::integer(v));
+  else
+    _Header(':', v);
+}
+
+void RespEncoder::raw(const Slice& reply) {
+  out_->sendPacket(reply.data, reply.len);
+}
+
+void RespEncoder::bulk(const char* data, std::size_t len) {
+  _Blob('$', data, len);
+}
+
+void RespEncoder::bulk(const std::shared_ptr<const char>& data,
+                       std::size_t len) {
+  if (!zeroCopy(len)) {
+    _Blob('$', data.get(), len);
+    return;
+  }
+  // 头部与结尾的 CRLF 拷贝，内容按偏移排在两者之间零拷贝发送
+  _Header('$', static_cast<long long>(len));
+  out_->sendPacket(std::shared_ptr<const void>(data, data.get()), data.get(),
+                   len);
+  out_->sendPacket(kCRLF, 2);
+}
+
+bool RespEncoder::zeroCopy(std::size_t len) const {
+  const std::size_t threshold = out_->zeroCopyThreshold();
+  return threshold > 0 && len >= threshold;
+}
+
+void RespEncoder::null() {
+  raw(resp3() ? shared::kNull : shared::kNullBulk);
+}
+
+void RespEncoder::nullArray() {
+  raw(resp3() ? shared::kNull : shared::kNullArray);
+}
+
+void RespEncoder::boolean(bool v) {
+  if (resp3())
+    raw(v ? shared::kTrue : shared::kFalse);
+  else
+    raw(v ? shared::kOne : shared::kZero);
+}
+
+void RespEncoder::dbl(double v) {
+  char buf[64];
+  std::size_t n = formatDouble(buf, sizeof(buf), v);
+  if (resp3())
+    _Line(',', buf, n);
+  else
+    _Blob('$', buf, n);
+}
+
+void RespEncoder::bigNumber(const char* digits, std::size_t len) {
+  if (resp3())
+    _Line('(', digits, len);
+  else
+    _Blob('$', digits, len);
+}
+
+void RespEncoder::verbatim(const char* format, const char* data,
+                           std::size_t len) {
+  if (!resp3()) {
+    _Blob('$', data, len);
+    return;
+  }
+
+  // "=<len + 4>\r\n<fmt>:" 在栈上拼好，内容与结尾直接引用
+  char header[48];
+  char* end = header + sizeof(header) - 6;
+  char* p = formatDecimal(end, static_cast<long long>(len + 4));
+  *--p = '=';
+  end[0] = '\r';
+  end[1] = '\n';
+  std::memcpy(end + 2, format, 3);
+  end[5] = ':';
+
+  BufferSequence reply;
+  reply.buffers[0].iov_base = p;
+  reply.buffers[0].iov_len = static_cast<std::size_t>(end + 6 - p);
+  reply.buffers[1].iov_base = const_cast<char*>(data);
+  reply.buffers[1].iov_len = len;
+  reply.buffers[2].iov_base = const_cast<char*>(kCRLF);
+  reply.buffers[2].iov_len = 2;
+  reply.count = 3;
+  out_->sendPacket(reply);
+}
+
+void RespEncoder::array(std::size_t n) {
+  _Header('*', static_cast<long long>(n));
+}
+
+void RespEncoder::map(std::size_t n) {
+  if (resp3())
+    _Header('%', static_cast<long long>(n));
+  else
+    _Header('*', static_cast<long long>(n * 2));
+}
+
+void RespEncoder::set(std::size_t n) {
+  _Header(resp3() ? '~' : '*', static_cast<long long>(n));
+}
+
+void RespEncoder::push(std::size_t n) {
+  _Header(resp3() ? '>' : '*', static_cast<long long>(n));
+}
+
+void RespEncoder::_Header(char type, long long n) {
+  if (n >= 0 && n < static_cast<long long>(shared::kHeaders)) {
+    const Slice hdr = shared::header(type, static_cast<std::size_t>(n));
+    if (hdr.len > 0) {
+      raw(hdr);
+      return;
+    }
+  }
+  char buf[32];
+  char* end = buf + sizeof(buf) - 2;
+  char* p = formatDecimal(end, n);
+  *--p = type;
+  end[0] = '\r';
+  end[1] = '\n';
+  out_->sendPacket(p, static_cast<std::size_t>(end + 2 - p));
+}
+
+void RespEncoder::_Line(char type, const char* body, std::size_t len) {
+  BufferSequence reply;
+  reply.buffers[0].iov_base = &type;
+  reply.buffers[0].iov_len = 1;
+  reply.buffers[1].iov_base = const_cast<char*>(body);
+  reply.buffers[1].iov_len = len;
+  reply.buffers[2].iov_base = const_cast<char*>(kCRLF);
+  reply.buffers[2].iov_len = 2;
+  reply.count = 3;
+  out_->sendPacket(reply);
+}
+
+void RespEncoder::_Blob(char type, const char* body, std::size_t len) {
+  BufferSequence reply;
+  char buf[32];
+  if (len < shared::kHeaders) {
+    const Slice hdr = shared::header(type, len);
+    reply.buffers[0].iov_base = const_cast<char*>(hdr.data);
+    reply.buffers[0].iov_len = hdr.len;
+  } else {
+    char* end = buf + sizeof(buf) - 2;
+    char* p = formatDecimal(end, static_cast<long long>(len));
+    *--p = type;
+    end[0] = '\r';
+    end[1] = '\n';
+    reply.buffers[0].iov_base = p;
+    reply.buffers[0].iov_len = static_cast<std::size_t>(end + 2 - p);
+  }
+  reply.buffers[1].iov_base = const_cast<char*>(body);
+  reply.buffers[1].iov_len = len;
+  reply.buffers[2].iov_base = const_cast<char*>(kCRLF);
+  reply.buffers[2].iov_len = 2;
+  reply.count = 3;
+  out_->sendPacket(reply);
+}
+}  // namespace tinyredis
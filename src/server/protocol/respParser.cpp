@@ -0,0 +1,196 @@
+#include <server/protocol/respParser.h>
+#include <server/protocol/respScan.h>
+#include <algorithm>
+
+namespace tinyredis {
+const std::size_t RespParser::kMaxInlineLen;
+const long long RespParser::kMaxMultiBulkLen;
+const long long RespParser::kMaxBulkLen;
+const long RespParser::kBadLineEnd;
+
+RespParser::RespParser(std::size_t maxRequestLen)
+    : maxRequestLen_(maxRequestLen) {
+  reset();
+}
+
+void RespParser::reset() {
+  state_ = State::kStart;
+  pos_ = 0;
+  scanned_ = 0;
+  multiBulk_ = 0;
+  bulkLen_ = 0;
+  offsets_.clear();
+  args_.clear();
+}
+
+RespParser::Result RespParser::parse(const char* data, std::size_t len,
+                                     std::size_t& consumed) {
+  Result res = _Parse(data, len, consumed);
+  // 帧已经占满了调用方能给出的全部空间，再多的数据也放不下
+  if (res == Result::kIncomplete && len >= maxRequestLen_)
+    return _Fail("Protocol error: too big request");
+  return res;
+}
+
+RespParser::Result RespParser::_Parse(const char* data, std::size_t len,
+                                      std::size_t& consumed) {
+  for (;;) {
+    switch (state_) {
+      case State::kStart:
+        if (pos_ >= len)
+          return Result::kIncomplete;
+        state_ = data[pos_] == '*' ? State::kMultiBulk : State::kInline;
+        break;
+
+      case State::kMultiBulk: {
+        long cr = _FindLineEnd(data, len);
+        if (cr == kBadLineEnd)
+          return _Fail("Protocol error: expected '\\n' after '\\r'");
+        if (cr < 0) {
+          if (len - pos_ > kMaxInlineLen)
+            return _Fail("Protocol error: too big mbulk count string");
+          return Result::kIncomplete;
+        }
+
+        long long n = 0;
+        if (!parseDecimal(data + pos_ + 1, cr - pos_ - 1, n) ||
+            n > kMaxMultiBulkLen)
+          return _Fail("Protocol error: invalid multibulk length");
+
+        pos_ = cr + 2;
+        if (n <= 0) {
+          // "*0" 或 "*-1"：空请求，直接跳过
+          args_.clear();
+          consumed = pos_;
+          return Result::kOk;
+        }
+        multiBulk_ = n;
+        offsets_.reserve(static_cast<std::size_t>(std::min(n, 1024LL)));
+        state_ = State::kBulkHeader;
+        break;
+      }
+
+      case State::kBulkHeader: {
+        if (pos_ >= len)
+          return Result::kIncomplete;
+        if (data[pos_] != '$') {
+          std::string reason = "Protocol error: expected '$', got '";
+          reason.push_back(data[pos_]);
+          reason.push_back('\'');
+          return _Fail(reason);
+        }
+
+        long cr = _FindLineEnd(data, len);
+        if (cr == kBadLineEnd)
+          return _Fail("Protocol error: expected '\\n' after '\\r'");
+        if (cr < 0) {
+          if (len - pos_ > kMaxInlineLen)
+            return _Fail("Protocol error: too big bulk count string");
+          return Result::kIncomplete;
+        }
+
+        long long n = 0;
+        if (!parseDecimal(data + pos_ + 1, cr - pos_ - 1, n) || n < 0 ||
+            n > kMaxBulkLen)
+          return _Fail("Protocol error: invalid bulk length");
+
+        pos_ = cr + 2;
+        bulkLen_ = n;
+        state_ = State::kBulkBody;
+        break;
+      }
+
+      case State::kBulkBody: {
+        // 参数本身不扫描，数据够了直接记下位置
+        const std::size_t need = static_cast<std::size_t>(bulkLen_) + 2;
+        if (len - pos_ < need)
+          return Result::kIncomplete;
+        // 参数后必须紧跟 "\r\n"，否则长度与内容对不上，后续的帧都会错位
+        const char* trailer = data + pos_ + bulkLen_;
+        if (trailer[0] != '\r' || trailer[1] != '\n')
+          return _Fail("Protocol error: expected '\\r\\n' after bulk data");
+
+        offsets_.push_back(
+            std::make_pair(pos_, static_cast<std::size_t>(bulkLen_)));
+        pos_ += need;
+        scanned_ = pos_;
+        if (--multiBulk_ == 0) {
+          _BuildArgs(data);
+          consumed = pos_;
+          return Result::kOk;
+        }
+        state_ = State::kBulkHeader;
+        break;
+      }
+
+      case State::kInline: {
+        Result r = _ParseInline(data, len);
+        if (r == Result::kOk)
+          consumed = pos_;
+        return r;
+      }
+    }
+  }
+}
+
+long RespParser::_FindLineEnd(const char* data, std::size_t len) {
+  std::size_t from = std::max(scanned_, pos_);
+  if (from < len) {
+    const char* cr = findCR(data + from, len - from);
+    if (cr) {
+      std::size_t off = cr - data;
+      if (off + 1 < len)
+        return data[off + 1] == '\n' ? static_cast<long>(off) : kBadLineEnd;
+      scanned_ = off;  // '\n' 还没有到
+      return -1;
+    }
+  }
+  scanned_ = len;
+  return -1;
+}
+
+RespParser::Result RespParser::_ParseInline(const char* data,
+                                            std::size_t len) {
+  std::size_t from = std::max(scanned_, pos_);
+  const char* nl = from < len ? findLF(data + from, len - from) : nullptr;
+  if (!nl) {
+    scanned_ = len;
+    if (len - pos_ > kMaxInlineLen)
+      return _Fail("Protocol error: too big inline request");
+    return Result::kIncomplete;
+  }
+
+  // 以空白分隔参数，不支持引号
+  std::size_t end = nl - data;
+  std::size_t lineEnd = end;
+  if (lineEnd > pos_ && data[lineEnd - 1] == '\r')
+    --lineEnd;
+
+  std::size_t i = pos_;
+  while (i < lineEnd) {
+    while (i < lineEnd && (data[i] == ' ' || data[i] == '\t'))
+      ++i;
+    std::size_t start = i;
+    while (i < lineEnd && data[i] != ' ' && data[i] != '\t')
+      ++i;
+    if (i > start)
+      offsets_.push_back(std::make_pair(start, i - start));
+  }
+
+  pos_ = end + 1;
+  _BuildArgs(data);
+  return Result::kOk;
+}
+
+RespParser::Result RespParser::_Fail(const std::string& reason) {
+  error_ = reason;
+  return Result::kError;
+}
+
+void RespParser::_BuildArgs(const char* data) {
+  args_.clear();
+  args_.reserve(offsets_.size());
+  for (const auto& off : offsets_)
+    args_.push_back(Slice{data + off.first, off.second});
+}
+}  // namespace tinyredis
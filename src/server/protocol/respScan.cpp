@@ -0,0 +1,178 @@
+#include <server/protocol/respScan.h>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define TINYREDIS_SCAN_X86 1
+#endif
+
+namespace tinyredis {
+namespace {
+template <char C>
+const char* findScalar(const char* p, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    if (p[i] == C)
+      return p + i;
+  }
+  return nullptr;
+}
+
+template <char C>
+const char* findLibc(const char* p, std::size_t n) {
+  return static_cast<const char*>(std::memchr(p, C, n));
+}
+
+#if defined(TINYREDIS_SCAN_X86)
+// x86-64 必定支持 SSE2。只按整块加载，不足一块的尾部逐字节比较，不会越界读
+template <char C>
+const char* findSse2(const char* p, std::size_t n) {
+  const __m128i needle = _mm_set1_epi8(C);
+  while (n >= 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+    if (mask)
+      return p + __builtin_ctz(mask);
+    p += 16;
+    n -= 16;
+  }
+  return findScalar<C>(p, n);
+}
+
+template <char C>
+__attribute__((target("avx2"))) const char* findAvx2(const char* p,
+                                                     std::size_t n) {
+  const __m256i needle = _mm256_set1_epi8(C);
+  while (n >= 32) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    unsigned mask = static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+    if (mask)
+      return p + __builtin_ctz(mask);
+    p += 32;
+    n -= 32;
+  }
+  return findSse2<C>(p, n);
+}
+#endif
+
+bool kernelSupported(ScanKernel kernel) {
+  switch (kernel) {
+    case ScanKernel::kScalar:
+    case ScanKernel::kLibc:
+      return true;
+    case ScanKernel::kSse2:
+      return cpuHasSse2();
+    case ScanKernel::kAvx2:
+      return cpuHasAvx2();
+  }
+  return false;
+}
+
+scan::FindFunc pickFind(ScanKernel kernel, bool cr) {
+  switch (kernel) {
+    case ScanKernel::kScalar:
+      return cr ? findScalar<'\r'> : findScalar<'\n'>;
+#if defined(TINYREDIS_SCAN_X86)
+    case ScanKernel::kSse2:
+      return cr ? findSse2<'\r'> : findSse2<'\n'>;
+    case ScanKernel::kAvx2:
+      return cr ? findAvx2<'\r'> : findAvx2<'\n'>;
+#endif
+    default:
+      return cr ? findLibc<'\r'> : findLibc<'\n'>;
+  }
+}
+
+void applyKernel(ScanKernel kernel) {
+  scan::findCR = pickFind(kernel, true);
+  scan::findLF = pickFind(kernel, false);
+}
+
+KernelSelector<ScanKernel> g_kernels(kernelSupported,
+                                     {ScanKernel::kAvx2, ScanKernel::kSse2,
+                                      ScanKernel::kLibc},
+                                     applyKernel);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// 最多 8 位数字：左侧补 '0' 凑成 8 字节，校验后用三次乘法转换
+bool parseEightDigits(const char* p, std::size_t n, uint64_t& out) {
+  uint64_t chunk = 0x3030303030303030ULL;
+  std::memcpy(reinterpret_cast<char*>(&chunk) + (8 - n), p, n);
+
+  const uint64_t high = chunk & 0xF0F0F0F0F0F0F0F0ULL;
+  const uint64_t carry = (chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL;
+  if (high != 0x3030303030303030ULL || carry != 0x3030303030303030ULL)
+    return false;
+
+  uint64_t v = chunk - 0x3030303030303030ULL;
+  v = (v * 10) + (v >> 8);
+  v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+       (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+      32;
+  out = static_cast<uint32_t>(v);
+  return true;
+}
+#else
+bool parseEightDigits(const char* p, std::size_t n, uint64_t& out) {
+  uint64_t v = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    unsigned d = static_cast<unsigned char>(p[i]) - '0';
+    if (d > 9)
+      return false;
+    v = v * 10 + d;
+  }
+  out = v;
+  return true;
+}
+#endif
+}  // namespace
+
+namespace scan {
+FindFunc findCR = pickFind(g_kernels.current(), true);
+FindFunc findLF = pickFind(g_kernels.current(), false);
+}  // namespace scan
+
+bool parseDecimal(const char* p, std::size_t n, long long& out) {
+  bool negative = false;
+  if (n > 0 && *p == '-') {
+    negative = true;
+    ++p;
+    --n;
+  }
+  if (n == 0 || n > 18)
+    return false;
+
+  // 从高位起每段最多 8 位，首段取余下的位数
+  uint64_t v = 0;
+  std::size_t chunk = n % 8 ? n % 8 : 8;
+  while (n > 0) {
+    uint64_t part = 0;
+    if (!parseEightDigits(p, chunk, part))
+      return false;
+    v = v * 100000000ULL + part;
+    p += chunk;
+    n -= chunk;
+    chunk = 8;
+  }
+  out = negative ? -static_cast<long long>(v) : static_cast<long long>(v);
+  return true;
+}
+
+KernelSelector<ScanKernel>& scanKernels() {
+  return g_kernels;
+}
+
+const char* scanKernelName(ScanKernel kernel) {
+  switch (kernel) {
+    case ScanKernel::kScalar:
+      return "scalar";
+    case ScanKernel::kLibc:
+      return "memchr";
+    case ScanKernel::kSse2:
+      return "sse2";
+    case ScanKernel::kAvx2:
+      return "avx2";
+  }
+  return "unknown";
+}
+}  // namespace tinyredis
@@ -0,0 +1,122 @@
+#include <server/protocol/respShared.h>
+#include <cstdint>
+#include <vector>
+
+namespace tinyredis {
+namespace {
+const char kDigits2[] =
+    "000102030405060708091011121314151617181920212223242526272829"
+    "303132333435363738394041424344454647484950515253545556575859"
+    "606162636465666768697071727374757677787980818283848586878889"
+    "90919293949596979899";
+
+const char kHeaderTypes[] = {'*', '$', '%', '~', '>'};
+const std::size_t kHeaderSlot = 8;  // "*31\r\n" 最长 5 字节
+
+// 启动时一次生成，之后只读，多个事件循环线程共享
+class SharedTable {
+ public:
+  SharedTable() {
+    offsets_.reserve(shared::kIntegers + 1);
+    for (long long n = 0; n < shared::kIntegers; ++n) {
+      offsets_.push_back(static_cast<uint32_t>(integers_.size()));
+      char buf[32];
+      char* end = buf + sizeof(buf);
+      char* p = formatDecimal(end, n);
+      integers_.push_back(':');
+      integers_.insert(integers_.end(), p, end);
+      integers_.push_back('\r');
+      integers_.push_back('\n');
+    }
+    offsets_.push_back(static_cast<uint32_t>(integers_.size()));
+
+    for (std::size_t t = 0; t < sizeof(kHeaderTypes); ++t) {
+      for (std::size_t n = 0; n < shared::kHeaders; ++n) {
+        char* slot = headers_[t][n];
+        char* end = slot + kHeaderSlot - 2;
+        char* p = formatDecimal(end, static_cast<long long>(n));
+        std::size_t len = static_cast<std::size_t>(end - p);
+        slot[0] = kHeaderTypes[t];
+        for (std::size_t i = 0; i < len; ++i)
+          slot[1 + i] = p[i];
+        slot[1 + len] = '\r';
+        slot[2 + len] = '\n';
+        headerLens_[t][n] = static_cast<uint8_t>(len + 3);
+      }
+    }
+  }
+
+  Slice integer(long long n) const {
+    const uint32_t off = offsets_[static_cast<std::size_t>(n)];
+    return Slice{&integers_[off], offsets_[n + 1] - off};
+  }
+
+  Slice header(std::size_t type, std::size_t n) const {
+    return Slice{headers_[type][n], headerLens_[type][n]};
+  }
+
+ private:
+  std::vector<char> integers_;     // 所有 ":<n>\r\n" 连续存放
+  std::vector<uint32_t> offsets_;  // 第 n 个的起始位置
+  char headers_[sizeof(kHeaderTypes)][shared::kHeaders][kHeaderSlot];
+  uint8_t headerLens_[sizeof(kHeaderTypes)][shared::kHeaders];
+};
+
+const SharedTable g_table;
+}  // namespace
+
+namespace shared {
+const Slice kOk = {"+OK\r\n", 5};
+const Slice kPong = {"+PONG\r\n", 7};
+const Slice kQueued = {"+QUEUED\r\n", 9};
+const Slice kCRLF = {"\r\n", 2};
+const Slice kZero = {":0\r\n", 4};
+const Slice kOne = {":1\r\n", 4};
+const Slice kMinusOne = {":-1\r\n", 5};
+const Slice kNullBulk = {"$-1\r\n", 5};
+const Slice kNullArray = {"*-1\r\n", 5};
+const Slice kNull = {"_\r\n", 3};
+const Slice kTrue = {"#t\r\n", 4};
+const Slice kFalse = {"#f\r\n", 4};
+const Slice kEmptyArray = {"*0\r\n", 4};
+const Slice kEmptyBulk = {"$0\r\n\r\n", 6};
+const Slice kSyntaxErr = {"-ERR syntax error\r\n", 19};
+const Slice kWrongType = {
+    "-WRONGTYPE Operation against a key holding the wrong kind of value\r\n",
+    68};
+
+Slice integer(long long n) {
+  return g_table.integer(n);
+}
+
+Slice header(char type, std::size_t n) {
+  for (std::size_t t = 0; t < sizeof(kHeaderTypes); ++t) {
+    if (kHeaderTypes[t] == type)
+      return n < kHeaders ? g_table.header(t, n) : Slice{nullptr, 0};
+  }
+  return Slice{nullptr, 0};
+}
+}  // namespace shared
+
+char* formatDecimal(char* end, long long v) {
+  unsigned long long u = v < 0 ? 0ULL - static_cast<unsigned long long>(v)
+                               : static_cast<unsigned long long>(v);
+  char* p = end;
+  while (u >= 100) {
+    const std::size_t i = static_cast<std::size_t>(u % 100) * 2;
+    u /= 100;
+    *--p = kDigits2[i + 1];
+    *--p = kDigits2[i];
+  }
+  if (u < 10) {
+    *--p = static_cast<char>('0' + u);
+  } else {
+    const std::size_t i = static_cast<std::size_t>(u) * 2;
+    *--p = kDigits2[i + 1];
+    *--p = kDigits2[i];
+  }
+  if (v < 0)
+    *--p = '-';
+  return p;
+}
+}  // namespace tinyredis
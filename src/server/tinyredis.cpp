@@ -1,3 +1,110 @@
-int main(){
-    
-}
\ No newline at end of file
+#include <base/eventLoop.h>
+#include <base/server.h>
+#include <server/client.h>
+#include <server/db/database.h>
+#include <spdlog/spdlog.h>
+#include <signal.h>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace {
+const int kClientTag = 1;  // 客户端监听套接字的 tag
+const uint64_t kCronIntervalMs = 10;
+
+class TinyRedis : public Server {
+ protected:
+  std::shared_ptr<StreamSocket> _OnNewConnection(int tag) override {
+    if (tag == kClientTag)
+      return std::make_shared<tinyredis::Client>(&db_);
+    return Server::_OnNewConnection(tag);
+  }
+
+  // 键空间的分片按编号轮流分给各个循环，每个循环只负责自己那些分片空闲时的 rehash；
+  // 每次只处理其中一个分片，一个循环每次花在 rehash 上的时间与不分片时相同
+  void _OnLoopStart(Internal::EventLoop& loop) override {
+    const std::size_t first = loop.index();
+    const std::size_t step = loopCount();
+    if (first >= tinyredis::Database::kShards)
+      return;
+    std::size_t next = first;
+    loop.timers().schedule(
+        kCronIntervalMs,
+        [this, first, step, next]() mutable {
+          db_.cron(next);
+          next += step;
+          if (next >= tinyredis::Database::kShards)
+            next = first;
+        },
+        kCronIntervalMs);
+  }
+
+ private:
+  tinyredis::Database db_;
+};
+
+Server* g_server = nullptr;
+
+void signalHandler(int) {
+  if (g_server)
+    g_server->terminate();
+}
+
+void usage(const char* prog) {
+  spdlog::info(
+      "Usage: {} [--port 6379] [--bind 0.0.0.0] [--loops N] "
+      "[--zerocopy-threshold BYTES] [--backlog N] [--poller epoll|io_uring]",
+      prog);
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string bindIP = "0.0.0.0";
+  int port = 6379;
+  std::size_t loops = 0;  // 0: 与 CPU 核数相同
+  long zeroCopyThreshold = -1;  // -1: 使用默认值
+  int backlog = 0;              // 0: 使用默认值
+  PollerType poller = PollerType::kAuto;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--port") && i + 1 < argc) {
+      port = std::atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--bind") && i + 1 < argc) {
+      bindIP = argv[++i];
+    } else if (!strcmp(argv[i], "--loops") && i + 1 < argc) {
+      loops = static_cast<std::size_t>(std::atoi(argv[++i]));
+    } else if (!strcmp(argv[i], "--zerocopy-threshold") && i + 1 < argc) {
+      zeroCopyThreshold = std::atol(argv[++i]);
+    } else if (!strcmp(argv[i], "--backlog") && i + 1 < argc) {
+      backlog = std::atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--poller") && i + 1 < argc &&
+               parsePollerType(argv[i + 1], poller)) {
+      ++i;
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  ::signal(SIGPIPE, SIG_IGN);
+  ::signal(SIGINT, signalHandler);
+  ::signal(SIGTERM, signalHandler);
+
+  TinyRedis server;
+  g_server = &server;
+  server.setLoopCount(loops);
+  if (zeroCopyThreshold >= 0)
+    server.setZeroCopyThreshold(static_cast<std::size_t>(zeroCopyThreshold));
+  if (backlog > 0)
+    server.setListenBacklog(backlog);
+  server.setPoller(poller);
+  if (!server.TCPBind(SocketAddr(bindIP + ":" + std::to_string(port)),
+                      kClientTag)) {
+    return 1;
+  }
+  spdlog::info("Hash table engine: {}", tinyredis::kHashEngine);
+  const bool ok = server.MainLoop();
+  g_server = nullptr;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,321 @@
+#include <server/util/bitops.h>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define TINYREDIS_BITOPS_X86 1
+#endif
+
+namespace tinyredis {
+namespace {
+// BITOP 按这个大小分段，每段依次合并所有源，段内的 dst 一直在 L1 里
+const std::size_t kStripe = 4096;
+
+uint64_t load64(const unsigned char* p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+void store64(unsigned char* p, uint64_t v) {
+  std::memcpy(p, &v, sizeof(v));
+}
+
+uint64_t popcount64(uint64_t x) {
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (x * 0x0101010101010101ULL) >> 56;
+}
+
+std::size_t popcountScalar(const unsigned char* p, std::size_t n) {
+  std::size_t count = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    count += popcount64(load64(p + i));
+  for (; i < n; ++i)
+    count += popcount64(p[i]);
+  return count;
+}
+
+std::size_t findByteNotScalar(const unsigned char* p, std::size_t n,
+                              unsigned char skip) {
+  const uint64_t pattern = 0x0101010101010101ULL * skip;
+  std::size_t i = 0;
+  while (i + 8 <= n && load64(p + i) == pattern)
+    i += 8;
+  while (i < n && p[i] == skip)
+    ++i;
+  return i;
+}
+
+template <BitOp Op>
+uint64_t apply64(uint64_t a, uint64_t b) {
+  return Op == BitOp::kAnd ? a & b : (Op == BitOp::kOr ? a | b : a ^ b);
+}
+
+// d op= s，共 n 字节
+template <BitOp Op>
+void mergeScalar(unsigned char* d, const unsigned char* s, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    store64(d + i, apply64<Op>(load64(d + i), load64(s + i)));
+  for (; i < n; ++i)
+    d[i] = static_cast<unsigned char>(apply64<Op>(d[i], s[i]));
+}
+
+void notScalar(unsigned char* d, const unsigned char* s, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    store64(d + i, ~load64(s + i));
+  for (; i < n; ++i)
+    d[i] = static_cast<unsigned char>(~s[i]);
+}
+
+#if defined(TINYREDIS_BITOPS_X86)
+__attribute__((target("popcnt"))) std::size_t popcountHardware(
+    const unsigned char* p, std::size_t n) {
+  // 四个独立的累加器，避免每次都等上一条 POPCNT 的结果
+  uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    c0 += __builtin_popcountll(load64(p + i));
+    c1 += __builtin_popcountll(load64(p + i + 8));
+    c2 += __builtin_popcountll(load64(p + i + 16));
+    c3 += __builtin_popcountll(load64(p + i + 24));
+  }
+  for (; i + 8 <= n; i += 8)
+    c0 += __builtin_popcountll(load64(p + i));
+  for (; i < n; ++i)
+    c0 += __builtin_popcount(p[i]);
+  return static_cast<std::size_t>(c0 + c1 + c2 + c3);
+}
+
+// 每个字节按高低 4 位查表计数，再按 8 字节一组横向求和，得到 4 个 64 位计数
+__attribute__((target("avx2"))) __m256i popcount256(__m256i v) {
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1,
+                       1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low = _mm256_set1_epi8(0x0F);
+  const __m256i lo = _mm256_and_si256(v, low);
+  const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+  const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                        _mm256_shuffle_epi8(lookup, hi));
+  return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+// 进位保存加法器：三个输入按位相加，*h 为进位，*l 为和
+__attribute__((target("avx2"))) void csa(__m256i* h, __m256i* l, __m256i a,
+                                         __m256i b, __m256i c) {
+  const __m256i u = _mm256_xor_si256(a, b);
+  *h = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+  *l = _mm256_xor_si256(u, c);
+}
+
+__attribute__((target("avx2"))) __m256i load256(const unsigned char* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// Harley-Seal：ones/twos/fours/eights 保存各位权的部分和，
+// 每 16 个向量只对进位到 16 的部分做一次查表计数
+__attribute__((target("avx2,popcnt"))) std::size_t popcountAvx2(
+    const unsigned char* p, std::size_t n) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i total = zero;
+  __m256i ones = zero, twos = zero, fours = zero, eights = zero;
+  __m256i sixteens, twosA, twosB, foursA, foursB, eightsA, eightsB;
+  std::size_t i = 0;
+  for (; i + 16 * 32 <= n; i += 16 * 32) {
+    const unsigned char* q = p + i;
+    csa(&twosA, &ones, ones, load256(q), load256(q + 32));
+    csa(&twosB, &ones, ones, load256(q + 64), load256(q + 96));
+    csa(&foursA, &twos, twos, twosA, twosB);
+    csa(&twosA, &ones, ones, load256(q + 128), load256(q + 160));
+    csa(&twosB, &ones, ones, load256(q + 192), load256(q + 224));
+    csa(&foursB, &twos, twos, twosA, twosB);
+    csa(&eightsA, &fours, fours, foursA, foursB);
+    csa(&twosA, &ones, ones, load256(q + 256), load256(q + 288));
+    csa(&twosB, &ones, ones, load256(q + 320), load256(q + 352));
+    csa(&foursA, &twos, twos, twosA, twosB);
+    csa(&twosA, &ones, ones, load256(q + 384), load256(q + 416));
+    csa(&twosB, &ones, ones, load256(q + 448), load256(q + 480));
+    csa(&foursB, &twos, twos, twosA, twosB);
+    csa(&eightsB, &fours, fours, foursA, foursB);
+    csa(&sixteens, &eights, eights, eightsA, eightsB);
+    total = _mm256_add_epi64(total, popcount256(sixteens));
+  }
+  total = _mm256_slli_epi64(total, 4);
+  total = _mm256_add_epi64(total,
+                           _mm256_slli_epi64(popcount256(eights), 3));
+  total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(fours), 2));
+  total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(twos), 1));
+  total = _mm256_add_epi64(total, popcount256(ones));
+  for (; i + 32 <= n; i += 32)
+    total = _mm256_add_epi64(total, popcount256(load256(p + i)));
+
+  uint64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+  return static_cast<std::size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+         popcountHardware(p + i, n - i);
+}
+
+__attribute__((target("avx2"))) std::size_t findByteNotAvx2(
+    const unsigned char* p, std::size_t n, unsigned char skip) {
+  const __m256i pattern = _mm256_set1_epi8(static_cast<char>(skip));
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const unsigned mask = static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(load256(p + i), pattern)));
+    if (mask != 0xFFFFFFFFu)
+      return i + static_cast<std::size_t>(__builtin_ctz(~mask));
+  }
+  return i + findByteNotScalar(p + i, n - i, skip);
+}
+
+template <BitOp Op>
+__attribute__((target("avx2"))) __m256i apply256(__m256i a, __m256i b) {
+  return Op == BitOp::kAnd
+             ? _mm256_and_si256(a, b)
+             : (Op == BitOp::kOr ? _mm256_or_si256(a, b)
+                                 : _mm256_xor_si256(a, b));
+}
+
+template <BitOp Op>
+__attribute__((target("avx2"))) void mergeAvx2(unsigned char* d,
+                                               const unsigned char* s,
+                                               std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i),
+                        apply256<Op>(load256(d + i), load256(s + i)));
+  }
+  mergeScalar<Op>(d + i, s + i, n - i);
+}
+
+__attribute__((target("avx2"))) void notAvx2(unsigned char* d,
+                                             const unsigned char* s,
+                                             std::size_t n) {
+  const __m256i all = _mm256_set1_epi8(-1);
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i),
+                        _mm256_xor_si256(load256(s + i), all));
+  }
+  notScalar(d + i, s + i, n - i);
+}
+#endif
+
+bool kernelSupported(BitKernel kernel) {
+  switch (kernel) {
+    case BitKernel::kScalar:
+      return true;
+    case BitKernel::kPopcnt:
+      return cpuHasPopcnt();
+    case BitKernel::kAvx2:
+      return cpuHasAvx2() && cpuHasPopcnt();
+  }
+  return false;
+}
+
+KernelSelector<BitKernel> g_kernels(kernelSupported,
+                                    {BitKernel::kAvx2, BitKernel::kPopcnt,
+                                     BitKernel::kScalar});
+
+// popcnt 内核只加速计数，其余操作与标量相同
+void merge(BitOp op, unsigned char* d, const unsigned char* s,
+           std::size_t n) {
+#if defined(TINYREDIS_BITOPS_X86)
+  if (g_kernels.current() == BitKernel::kAvx2) {
+    switch (op) {
+      case BitOp::kAnd:
+        return mergeAvx2<BitOp::kAnd>(d, s, n);
+      case BitOp::kOr:
+        return mergeAvx2<BitOp::kOr>(d, s, n);
+      case BitOp::kXor:
+        return mergeAvx2<BitOp::kXor>(d, s, n);
+      case BitOp::kNot:
+        return notAvx2(d, s, n);
+    }
+  }
+#endif
+  switch (op) {
+    case BitOp::kAnd:
+      return mergeScalar<BitOp::kAnd>(d, s, n);
+    case BitOp::kOr:
+      return mergeScalar<BitOp::kOr>(d, s, n);
+    case BitOp::kXor:
+      return mergeScalar<BitOp::kXor>(d, s, n);
+    case BitOp::kNot:
+      return notScalar(d, s, n);
+  }
+}
+}  // namespace
+
+std::size_t popcount(const void* p, std::size_t n) {
+  const unsigned char* s = static_cast<const unsigned char*>(p);
+#if defined(TINYREDIS_BITOPS_X86)
+  if (g_kernels.current() == BitKernel::kAvx2)
+    return popcountAvx2(s, n);
+  if (g_kernels.current() == BitKernel::kPopcnt)
+    return popcountHardware(s, n);
+#endif
+  return popcountScalar(s, n);
+}
+
+std::size_t findByteNot(const void* p, std::size_t n, unsigned char skip) {
+  const unsigned char* s = static_cast<const unsigned char*>(p);
+#if defined(TINYREDIS_BITOPS_X86)
+  if (g_kernels.current() == BitKernel::kAvx2)
+    return findByteNotAvx2(s, n, skip);
+#endif
+  return findByteNotScalar(s, n, skip);
+}
+
+void bitop(BitOp op, void* dst, std::size_t n, const void* const* srcs,
+           const std::size_t* lens, std::size_t count) {
+  unsigned char* d = static_cast<unsigned char*>(dst);
+  for (std::size_t off = 0; off < n; off += kStripe) {
+    const std::size_t len = n - off < kStripe ? n - off : kStripe;
+    for (std::size_t k = 0; k < count; ++k) {
+      const unsigned char* s = static_cast<const unsigned char*>(srcs[k]);
+      const std::size_t avail =
+          lens[k] > off ? (lens[k] - off < len ? lens[k] - off : len) : 0;
+      if (avail)
+        s += off;
+      if (k == 0) {
+        // 第一个源直接写入，不足的部分补 0；NOT 写入取反，补 0xFF
+        if (op == BitOp::kNot) {
+          merge(op, d + off, s, avail);
+          std::memset(d + off + avail, 0xFF, len - avail);
+          break;
+        }
+        if (avail)
+          std::memcpy(d + off, s, avail);
+        std::memset(d + off + avail, 0, len - avail);
+        continue;
+      }
+      merge(op, d + off, s, avail);
+      // 源不足的部分视为 0：AND 的结果为 0，OR/XOR 不变
+      if (op == BitOp::kAnd)
+        std::memset(d + off + avail, 0, len - avail);
+    }
+  }
+}
+
+KernelSelector<BitKernel>& bitKernels() {
+  return g_kernels;
+}
+
+const char* bitKernelName(BitKernel kernel) {
+  switch (kernel) {
+    case BitKernel::kScalar:
+      return "scalar";
+    case BitKernel::kPopcnt:
+      return "popcnt";
+    case BitKernel::kAvx2:
+      return "avx2";
+  }
+  return "unknown";
+}
+}  // namespace tinyredis
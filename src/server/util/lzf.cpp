@@ -0,0 +1,136 @@
+#include <server/util/lzf.h>
+#include <cstdint>
+#include <cstring>
+
+namespace tinyredis {
+namespace {
+const std::size_t kMaxLiteral = 32;
+const std::size_t kMaxOffset = 8192;
+const std::size_t kMaxMatch = 264;  // 7 + 255 + 2
+const int kHashBits = 13;
+
+inline uint32_t hash3(const unsigned char* p) {
+  const uint32_t v = (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2];
+  return (v * 2654435761u) >> (32 - kHashBits);
+}
+
+// 把 [lit, end) 的字面量按每段最多 kMaxLiteral 字节写出
+bool flushLiterals(const unsigned char* lit, const unsigned char* end,
+                   unsigned char** op, const unsigned char* outEnd) {
+  while (lit < end) {
+    std::size_t n = static_cast<std::size_t>(end - lit);
+    if (n > kMaxLiteral)
+      n = kMaxLiteral;
+    if (static_cast<std::size_t>(outEnd - *op) < n + 1)
+      return false;
+    *(*op)++ = static_cast<unsigned char>(n - 1);
+    std::memcpy(*op, lit, n);
+    *op += n;
+    lit += n;
+  }
+  return true;
+}
+}  // namespace
+
+std::size_t lzfCompress(const void* in, std::size_t inLen, void* out,
+                        std::size_t outCap) {
+  const unsigned char* const base = static_cast<const unsigned char*>(in);
+  const unsigned char* const end = base + inLen;
+  unsigned char* op = static_cast<unsigned char*>(out);
+  const unsigned char* const outEnd = op + outCap;
+  if (inLen == 0 || outCap == 0)
+    return 0;
+
+  // 位置加 1 存放，0 表示空
+  uint32_t table[1 << kHashBits];
+  std::memset(table, 0, sizeof(table));
+
+  const unsigned char* ip = base;
+  const unsigned char* lit = base;
+  while (end - ip > 2) {
+    const uint32_t h = hash3(ip);
+    const uint32_t cand = table[h];
+    table[h] = static_cast<uint32_t>(ip - base) + 1;
+    if (cand) {
+      const unsigned char* ref = base + cand - 1;
+      const std::size_t off = static_cast<std::size_t>(ip - ref) - 1;
+      if (off < kMaxOffset && ref[0] == ip[0] && ref[1] == ip[1] &&
+          ref[2] == ip[2]) {
+        std::size_t maxLen = static_cast<std::size_t>(end - ip);
+        if (maxLen > kMaxMatch)
+          maxLen = kMaxMatch;
+        std::size_t len = 3;
+        while (len < maxLen && ref[len] == ip[len])
+          ++len;
+
+        if (!flushLiterals(lit, ip, &op, outEnd))
+          return 0;
+        const std::size_t l = len - 2;
+        if (static_cast<std::size_t>(outEnd - op) < (l < 7 ? 2u : 3u))
+          return 0;
+        if (l < 7) {
+          *op++ = static_cast<unsigned char>((off >> 8) | (l << 5));
+        } else {
+          *op++ = static_cast<unsigned char>((off >> 8) | (7 << 5));
+          *op++ = static_cast<unsigned char>(l - 7);
+        }
+        *op++ = static_cast<unsigned char>(off & 0xFF);
+
+        // 匹配末尾的位置也登记进哈希表，让紧接着的重复能找到
+        ip += len;
+        if (end - ip > 2)
+          table[hash3(ip - 1)] = static_cast<uint32_t>(ip - 1 - base) + 1;
+        lit = ip;
+        continue;
+      }
+    }
+    ++ip;
+  }
+  if (!flushLiterals(lit, end, &op, outEnd))
+    return 0;
+  return static_cast<std::size_t>(op - static_cast<unsigned char*>(out));
+}
+
+std::size_t lzfDecompress(const void* in, std::size_t inLen, void* out,
+                          std::size_t outCap) {
+  const unsigned char* ip = static_cast<const unsigned char*>(in);
+  const unsigned char* const inEnd = ip + inLen;
+  unsigned char* const outBegin = static_cast<unsigned char*>(out);
+  unsigned char* op = outBegin;
+  unsigned char* const outEnd = op + outCap;
+
+  while (ip < inEnd) {
+    const unsigned c = *ip++;
+    if (c < 32) {
+      const std::size_t n = c + 1;
+      if (static_cast<std::size_t>(inEnd - ip) < n ||
+          static_cast<std::size_t>(outEnd - op) < n)
+        return 0;
+      std::memcpy(op, ip, n);
+      op += n;
+      ip += n;
+      continue;
+    }
+
+    std::size_t len = c >> 5;
+    if (len == 7) {
+      if (ip >= inEnd)
+        return 0;
+      len += *ip++;
+    }
+    if (ip >= inEnd)
+      return 0;
+    const std::size_t off = ((c & 0x1F) << 8) + *ip++ + 1;
+    len += 2;
+    if (off > static_cast<std::size_t>(op - outBegin) ||
+        static_cast<std::size_t>(outEnd - op) < len)
+      return 0;
+    // 距离可能小于长度（重复的模式），只能逐字节拷贝
+    const unsigned char* ref = op - off;
+    for (std::size_t i = 0; i < len; ++i)
+      op[i] = ref[i];
+    op += len;
+  }
+  return static_cast<std::size_t>(op - outBegin);
+}
+}  // namespace tinyredis
@@ -0,0 +1,34 @@
+#include <server/util/memory.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace tinyredis {
+std::size_t mallocUsableSize(const void* p) {
+#ifdef __GLIBC__
+  return p ? ::malloc_usable_size(const_cast<void*>(p)) : 0;
+#else
+  (void)p;
+  return 0;
+#endif
+}
+
+std::size_t stringHeapBytes(const std::string& s) {
+  const char* inlineBegin = reinterpret_cast<const char*>(&s);
+  const char* inlineEnd = inlineBegin + sizeof(s);
+  if (s.data() >= inlineBegin && s.data() < inlineEnd)
+    return 0;
+  return mallocUsableSize(s.data());
+}
+
+std::size_t allocatedBytes() {
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  struct mallinfo2 mi = ::mallinfo2();
+  return mi.uordblks + mi.hblkhd;
+#else
+  return 0;
+#endif
+}
+}  // namespace tinyredis
@@ -0,0 +1,68 @@
+#include <server/util/numbers.h>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace tinyredis {
+bool parseLongLong(const char* s, std::size_t len, long long* out) {
+  // "-9223372036854775808" 最长 20 字节
+  if (len == 0 || len > 20)
+    return false;
+  if (len == 1 && s[0] == '0') {
+    *out = 0;
+    return true;
+  }
+
+  std::size_t i = 0;
+  const bool negative = s[0] == '-';
+  if (negative && ++i == len)
+    return false;
+  if (s[i] < '1' || s[i] > '9')
+    return false;
+
+  unsigned long long v = 0;
+  const unsigned long long kMax = 18446744073709551615ULL;
+  for (; i < len; ++i) {
+    if (s[i] < '0' || s[i] > '9')
+      return false;
+    const unsigned d = static_cast<unsigned>(s[i] - '0');
+    if (v > (kMax - d) / 10)
+      return false;
+    v = v * 10 + d;
+  }
+
+  const unsigned long long kLimit = 9223372036854775807ULL;
+  if (negative) {
+    if (v > kLimit + 1)
+      return false;
+    *out = v == kLimit + 1 ? (-9223372036854775807LL - 1)
+                           : -static_cast<long long>(v);
+  } else {
+    if (v > kLimit)
+      return false;
+    *out = static_cast<long long>(v);
+  }
+  return true;
+}
+
+bool parseDouble(const char* s, std::size_t len, double* out) {
+  // 足够容纳任何有意义的十进制表示，更长的一定不是 Redis 接受的格式
+  char buf[128];
+  if (len == 0 || len >= sizeof(buf) ||
+      std::isspace(static_cast<unsigned char>(s[0])))
+    return false;
+  std::memcpy(buf, s, len);
+  buf[len] = '\0';
+
+  char* end;
+  errno = 0;
+  const double v = std::strtod(buf, &end);
+  if (static_cast<std::size_t>(end - buf) != len || std::isnan(v) ||
+      (errno == ERANGE && (std::isinf(v) || v == 0)))
+    return false;
+  *out = v;
+  return true;
+}
+}  // namespace tinyredis
@@ -0,0 +1,107 @@
+#include <server/util/stringMatch.h>
+#include <cctype>
+
+namespace tinyredis {
+namespace {
+bool sameChar(char a, char b, bool nocase) {
+  if (nocase)
+    return std::tolower(static_cast<unsigned char>(a)) ==
+           std::tolower(static_cast<unsigned char>(b));
+  return a == b;
+}
+
+// 匹配 [...]，p 指向 '[' 之后，返回是否匹配并把 p 移到 ']' 之后
+bool matchClass(const char*& p, const char* pend, char c, bool nocase) {
+  bool negate = false;
+  if (p < pend && *p == '^') {
+    negate = true;
+    ++p;
+  }
+  bool match = false;
+  while (p < pend && *p != ']') {
+    if (*p == '\\' && p + 1 < pend) {
+      ++p;
+      match = match || sameChar(*p, c, nocase);
+      ++p;
+    } else if (p + 2 < pend && p[1] == '-' && p[2] != ']') {
+      char lo = p[0];
+      char hi = p[2];
+      if (lo > hi) {
+        char t = lo;
+        lo = hi;
+        hi = t;
+      }
+      char cc = c;
+      if (nocase) {
+        lo = static_cast<char>(std::tolower(static_cast<unsigned char>(lo)));
+        hi = static_cast<char>(std::tolower(static_cast<unsigned char>(hi)));
+        cc = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      }
+      match = match || (cc >= lo && cc <= hi);
+      p += 3;
+    } else {
+      match = match || sameChar(*p, c, nocase);
+      ++p;
+    }
+  }
+  if (p < pend)
+    ++p;  // 跳过 ']'
+  return negate ? !match : match;
+}
+}  // namespace
+
+bool stringMatch(const char* pattern, std::size_t plen, const char* str,
+                 std::size_t slen, bool nocase) {
+  const char* p = pattern;
+  const char* pend = pattern + plen;
+  const char* s = str;
+  const char* send = str + slen;
+  // 最近一个 '*' 之后的位置，失配时从这里回溯，让 '*' 多吞一个字符
+  const char* starP = nullptr;
+  const char* starS = nullptr;
+
+  while (s < send) {
+    if (p < pend && *p == '*') {
+      while (p < pend && *p == '*')
+        ++p;
+      if (p == pend)
+        return true;
+      starP = p;
+      starS = s;
+      continue;
+    }
+
+    bool ok = false;
+    if (p < pend) {
+      const char* next = p;
+      if (*p == '?') {
+        ok = true;
+        ++next;
+      } else if (*p == '[') {
+        ++next;
+        ok = matchClass(next, pend, *s, nocase);
+      } else if (*p == '\\' && p + 1 < pend) {
+        ok = sameChar(p[1], *s, nocase);
+        next += 2;
+      } else {
+        ok = sameChar(*p, *s, nocase);
+        ++next;
+      }
+      if (ok) {
+        p = next;
+        ++s;
+        continue;
+      }
+    }
+
+    if (!starP)
+      return false;
+    p = starP;
+    s = ++starS;
+  }
+
+  while (p < pend && *p == '*')
+    ++p;
+  return p == pend;
+}
+}  // namespace tinyredis
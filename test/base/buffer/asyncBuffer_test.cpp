@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <base/buffer/asyncBuffer.h>
+
+#include <string>
+
+namespace {
+std::string drain(AsyncBuffer& buf) {
+  std::string out;
+  for (;;) {
+    BufferSequence bf;
+    buf.processBuffer(bf);
+    if (bf.count == 0)
+      break;
+    for (std::size_t i = 0; i < bf.count; ++i) {
+      out.append(static_cast<const char*>(bf.buffers[i].iov_base),
+                 bf.buffers[i].iov_len);
+    }
+    buf.skip(bf.totalBytes());
+  }
+  return out;
+}
+}  // namespace
+
+TEST(AsyncBufferTest, WriteAndProcess) {
+  AsyncBuffer buf(64);
+  EXPECT_TRUE(buf.isEmpty());
+  buf.write("hello ", 6);
+  buf.write("world", 5);
+  EXPECT_FALSE(buf.isEmpty());
+  EXPECT_EQ(drain(buf), "hello world");
+  EXPECT_TRUE(buf.isEmpty());
+}
+
+TEST(AsyncBufferTest, OverflowKeepsOrder) {
+  AsyncBuffer buf(16);
+  std::string expect;
+  for (int i = 0; i < 20; ++i) {
+    std::string s = "msg" + std::to_string(i) + ";";
+    buf.write(s.data(), s.size());
+    expect += s;
+  }
+  EXPECT_EQ(drain(buf), expect);
+}
+
+TEST(AsyncBufferTest, PartialSkip) {
+  AsyncBuffer buf(16);
+  std::string expect;
+  for (int i = 0; i < 10; ++i) {
+    std::string s = "abcdefg" + std::to_string(i);
+    buf.write(s.data(), s.size());
+    expect += s;
+  }
+
+  // 每次只消费 3 个字节，模拟 writev 部分发送
+  std::string out;
+  while (!buf.isEmpty()) {
+    BufferSequence bf;
+    buf.processBuffer(bf);
+    ASSERT_GT(bf.count, 0u);
+    std::size_t n = std::min<std::size_t>(3, bf.buffers[0].iov_len);
+    out.append(static_cast<const char*>(bf.buffers[0].iov_base), n);
+    buf.skip(n);
+  }
+  EXPECT_EQ(out, expect);
+}
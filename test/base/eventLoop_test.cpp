@@ -0,0 +1,23 @@
+#include <gtest/gtest.h>
+#include <base/eventLoop.h>
+#include <base/server.h>
+
+#include <chrono>
+#include <thread>
+
+using Internal::EventLoop;
+
+// 空闲的循环在 poll 中等待，stop 唤醒它立即退出，不等 poll 超时
+TEST(EventLoopTest, StopWakesIdleLoop) {
+  Server server;
+  for (int i = 0; i < 3; ++i) {
+    EventLoop loop(&server, 0);
+    loop.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    const auto begin = std::chrono::steady_clock::now();
+    loop.stop();
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    EXPECT_LT(elapsed, std::chrono::milliseconds(50));
+  }
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <base/poll/epoll.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#if defined(__linux__)
+
+namespace {
+// 只等一次，返回 userdata 上报的事件（没有事件为 0）
+int pollOnce(Epoll& ep, void* userdata, int timeoutMs) {
+  std::vector<FiredEvent> fired;
+  ep.poll(fired, 16, timeoutMs);
+  int events = 0;
+  for (const auto& ev : fired) {
+    if (ev.userdata == userdata)
+      events |= ev.events;
+  }
+  return events;
+}
+}  // namespace
+
+// 掩码改成 0 后 fd 仍然注册着，之后可以原地重新打开事件
+TEST(EpollTest, ModSocketToEmptyMaskKeepsRegistration) {
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  Epoll ep;
+  int tag = 0;
+  const int kRead = static_cast<int>(EventType::Read);
+  const int kWrite = static_cast<int>(EventType::Write);
+
+  ASSERT_TRUE(ep.addSocket(fds[0], kRead, &tag));
+  ASSERT_TRUE(ep.modSocket(fds[0], 0, &tag));
+  ASSERT_EQ(::write(fds[1], "x", 1), 1);
+  EXPECT_EQ(pollOnce(ep, &tag, 10), 0);
+
+  ASSERT_TRUE(ep.modSocket(fds[0], kRead, &tag));
+  EXPECT_EQ(pollOnce(ep, &tag, 100), kRead);
+
+  ASSERT_TRUE(ep.modSocket(fds[0], kRead | kWrite, &tag));
+  EXPECT_EQ(pollOnce(ep, &tag, 100), kRead | kWrite);
+
+  ASSERT_TRUE(ep.delSocket(fds[0], kRead | kWrite));
+  EXPECT_EQ(pollOnce(ep, &tag, 10), 0);
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+#endif
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <base/buffer/buffer.h>
+#include <base/poll/ioUring.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(TINYREDIS_HAVE_IO_URING)
+
+namespace {
+// 只等一次，返回 userdata 上报的事件（没有事件为 0）
+int pollOnce(IoUring& ring, void* userdata, int timeoutMs) {
+  std::vector<FiredEvent> fired;
+  ring.poll(fired, 16, timeoutMs);
+  int events = 0;
+  for (const auto& ev : fired) {
+    if (ev.userdata == userdata)
+      events |= ev.events;
+  }
+  return events;
+}
+
+// 回环上监听一个临时端口，返回套接字，addr 为监听地址
+int listenLoopback(sockaddr_in& addr) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+      ::listen(fd, 4) != 0 ||
+      ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+    if (fd >= 0)
+      ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// 反复 poll 直到出现 userdata 的 op 完成事件，超时返回 false
+bool waitCompletion(IoUring& ring, Completion::Op op, void* userdata,
+                    Completion& out) {
+  std::vector<FiredEvent> fired;
+  for (int i = 0; i < 100; ++i) {
+    ring.poll(fired, 16, 10);
+    for (const Completion& c : ring.completions()) {
+      if (c.op == op && c.userdata == userdata) {
+        out = c;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+BufferSequence oneBuffer(const void* data, std::size_t len) {
+  BufferSequence bf;
+  bf.buffers[0].iov_base = const_cast<void*>(data);
+  bf.buffers[0].iov_len = len;
+  bf.count = 1;
+  return bf;
+}
+}  // namespace
+
+// 写事件的开关原地修改同一个 multishot poll，读事件不受影响
+TEST(IoUringTest, ModSocketTogglesWriteInPlace) {
+  if (!IoUring::isSupported())
+    GTEST_SKIP() << "io_uring unsupported";
+
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  IoUring ring(64);
+  int tag = 0;
+  const int kRead = static_cast<int>(EventType::Read);
+  const int kWrite = static_cast<int>(EventType::Write);
+
+  ASSERT_TRUE(ring.addSocket(fds[0], kRead, &tag));
+  EXPECT_EQ(pollOnce(ring, &tag, 10), 0);
+
+  // 套接字一直可写，打开写事件后立即上报
+  ASSERT_TRUE(ring.modSocket(fds[0], kRead | kWrite, &tag));
+  EXPECT_TRUE(pollOnce(ring, &tag, 100) & kWrite);
+
+  ASSERT_TRUE(ring.modSocket(fds[0], kRead, &tag));
+  pollOnce(ring, &tag, 10);  // 丢弃更新之前已经产生的事件
+  ASSERT_EQ(::write(fds[1], "x", 1), 1);
+  const int events = pollOnce(ring, &tag, 100);
+  EXPECT_TRUE(events & kRead);
+  EXPECT_FALSE(events & kWrite);
+
+  ASSERT_TRUE(ring.delSocket(fds[0], kRead));
+  ASSERT_EQ(::write(fds[1], "y", 1), 1);
+  EXPECT_EQ(pollOnce(ring, &tag, 10), 0);
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+// 完成模型：内核 accept、recv 到 buffer ring、sendmsg 与零拷贝 send
+TEST(IoUringTest, CompletionRoundTrip) {
+  if (!IoUring::isSupported())
+    GTEST_SKIP() << "io_uring unsupported";
+  IoUring ring(64, 16, 4096);
+  if (!ring.completionBased())
+    GTEST_SKIP() << "io_uring completion mode unsupported";
+
+  sockaddr_in addr;
+  int listener = listenLoopback(addr);
+  ASSERT_GE(listener, 0);
+  int listenTag = 0;
+  int connTag = 0;
+  ASSERT_TRUE(ring.submitAccept(listener, &listenTag));
+
+  int client = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_EQ(::connect(client, reinterpret_cast<sockaddr*>(&addr),
+                      sizeof(addr)),
+            0);
+  Completion c;
+  ASSERT_TRUE(waitCompletion(ring, Completion::Op::Accept, &listenTag, c));
+  ASSERT_GE(c.result, 0);
+  const int conn = c.result;
+
+  ASSERT_TRUE(ring.submitRecv(conn, &connTag));
+  ASSERT_EQ(::write(client, "ping", 4), 4);
+  ASSERT_TRUE(waitCompletion(ring, Completion::Op::Recv, &connTag, c));
+  ASSERT_EQ(c.result, 4);
+  EXPECT_EQ(std::string(c.data, 4), "ping");
+
+  // multishot recv 一直有效，不需要重新提交
+  ASSERT_EQ(::write(client, "pong", 4), 4);
+  ASSERT_TRUE(waitCompletion(ring, Completion::Op::Recv, &connTag, c));
+  EXPECT_EQ(std::string(c.data, static_cast<std::size_t>(c.result)), "pong");
+
+  // 两段 iovec 一次 sendmsg 发出
+  BufferSequence bf = oneBuffer("+O", 2);
+  bf.buffers[1].iov_base = const_cast<char*>("K\r\n");
+  bf.buffers[1].iov_len = 3;
+  bf.count = 2;
+  ASSERT_TRUE(ring.submitSend(conn, bf, nullptr, false, &connTag));
+  ASSERT_TRUE(waitCompletion(ring, Completion::Op::Send, &connTag, c));
+  EXPECT_EQ(c.result, 5);
+  char buf[64];
+  ASSERT_EQ(::read(client, buf, sizeof(buf)), 5);
+  EXPECT_EQ(std::string(buf, 5), "+OK\r\n");
+
+  // 零拷贝发送：owner 一直保留到内核的通知到达
+  std::shared_ptr<std::string> owner(new std::string(8192, 'z'));
+  ASSERT_TRUE(ring.submitSend(conn, oneBuffer(owner->data(), owner->size()),
+                              owner, true, &connTag));
+  ASSERT_TRUE(waitCompletion(ring, Completion::Op::Send, &connTag, c));
+  ASSERT_GT(c.result, 0);
+  std::string received;
+  while (received.size() < static_cast<std::size_t>(c.result)) {
+    ssize_t n = ::read(client, buf, sizeof(buf));
+    ASSERT_GT(n, 0);
+    received.append(buf, static_cast<std::size_t>(n));
+  }
+  EXPECT_EQ(received, owner->substr(0, received.size()));
+  std::vector<FiredEvent> fired;
+  for (int i = 0; i < 100 && owner.use_count() > 1; ++i)
+    ring.poll(fired, 16, 10);
+  EXPECT_EQ(owner.use_count(), 1);
+
+  ::close(client);
+  ::close(conn);
+  ::close(listener);
+}
+
+// delSocket 取消该 fd 上的 multishot recv，之后的数据不再产生完成事件
+TEST(IoUringTest, DelSocketCancelsRecv) {
+  if (!IoUring::isSupported())
+    GTEST_SKIP() << "io_uring unsupported";
+  IoUring ring(64, 16, 4096);
+  if (!ring.completionBased())
+    GTEST_SKIP() << "io_uring completion mode unsupported";
+
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  int tag = 0;
+  ASSERT_TRUE(ring.submitRecv(fds[0], &tag));
+  ASSERT_EQ(::write(fds[1], "x", 1), 1);
+  Completion c;
+  ASSERT_TRUE(waitCompletion(ring, Completion::Op::Recv, &tag, c));
+
+  ASSERT_TRUE(ring.delSocket(fds[0], 0));
+  EXPECT_FALSE(ring.delSocket(fds[0], 0));  // 已经在取消中
+  ASSERT_EQ(::write(fds[1], "y", 1), 1);
+  EXPECT_FALSE(waitCompletion(ring, Completion::Op::Recv, &tag, c));
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+#endif
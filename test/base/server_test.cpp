@@ -0,0 +1,375 @@
+#include <gtest/gtest.h>
+#include <base/eventLoop.h>
+#include <base/poll/epoll.h>
+#include <base/poll/ioUring.h>
+#include <base/server.h>
+#include <base/socket/streamSocket.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+class TestServer : public Server {
+ public:
+  std::atomic<std::size_t> started{0};
+  std::atomic<bool> recycled{false};
+
+ protected:
+  void _OnLoopStart(Internal::EventLoop&) override { ++started; }
+  void _Recycle() override { recycled = true; }
+};
+
+// 原样回显收到的数据；大块以零拷贝发送（未开启时 sendPacket 退化为拷贝）
+class EchoSocket : public StreamSocket {
+ private:
+  packetLength _HandlePacket(const char* msg, std::size_t len) override {
+    std::shared_ptr<char> copy(new char[len], std::default_delete<char[]>());
+    std::memcpy(copy.get(), msg, len);
+    sendPacket(copy, copy.get(), len);
+    return static_cast<packetLength>(len);
+  }
+};
+
+class EchoServer : public TestServer {
+ protected:
+  std::shared_ptr<StreamSocket> _OnNewConnection(int) override {
+    return std::make_shared<EchoSocket>();
+  }
+};
+
+// 收到 "PAUSE\n" 后像挂起的客户端一样暂停接收，不再消费后续数据，
+// 直到测试线程让它恢复；其余数据只计数
+class PausingSocket : public StreamSocket {
+ public:
+  std::atomic<std::size_t> consumed{0};
+  std::atomic<std::size_t> pausedCapacity{0};  // 暂停期间接收缓冲区的最大容量
+
+  // 在循环线程上调用
+  void resume() {
+    paused_ = false;
+    resumeRead();
+    getLoop()->taskManager().markReady(this);
+  }
+
+ private:
+  packetLength _HandlePacket(const char* msg, std::size_t len) override {
+    if (paused_) {
+      pausedCapacity = std::max(pausedCapacity.load(), recvBuf_.capacity());
+      return 0;
+    }
+    if (!pausedOnce_ && len >= 6 && std::memcmp(msg, "PAUSE\n", 6) == 0) {
+      pausedOnce_ = paused_ = true;
+      pauseRead();
+      consumed += 6;
+      return 6;
+    }
+    consumed += len;
+    return static_cast<packetLength>(len);
+  }
+
+  bool paused_{false};
+  bool pausedOnce_{false};
+};
+
+class PausingServer : public TestServer {
+ public:
+  std::shared_ptr<PausingSocket> conn;  // connected 之后才能在其他线程访问
+  std::atomic<bool> connected{false};
+
+  std::size_t consumed() const {
+    return connected ? conn->consumed.load() : 0;
+  }
+
+ protected:
+  std::shared_ptr<StreamSocket> _OnNewConnection(int) override {
+    conn = std::make_shared<PausingSocket>();
+    connected = true;
+    return conn;
+  }
+};
+
+// 绑定到回环地址的临时端口，返回套接字（调用方关闭）和端口号
+int bindLoopback(bool doListen, int& port) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+      (doListen && ::listen(fd, 1) != 0) ||
+      ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+    if (fd >= 0)
+      ::close(fd);
+    return -1;
+  }
+  port = ntohs(addr.sin_port);
+  return fd;
+}
+
+int connectLoopback(int port) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  if (fd >= 0 &&
+      ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+std::string loopbackAddr(int port) {
+  return "127.0.0.1:" + std::to_string(port);
+}
+
+// 每个用例分别用 epoll 和 io_uring 运行，两种后端走的是不同的收发路径
+class ServerTest : public ::testing::TestWithParam<PollerType> {
+ protected:
+  void SetUp() override {
+#if defined(TINYREDIS_HAVE_IO_URING)
+    const bool ioUring = IoUring::isSupported();
+#else
+    const bool ioUring = false;
+#endif
+    if (GetParam() == PollerType::kIoUring && !ioUring)
+      GTEST_SKIP() << "io_uring unsupported";
+  }
+
+  // 循环确实使用了指定的后端，而不是悄悄回退
+  void expectBackend(const Server& server) const {
+    const Poller* poller = server.loop(0).poller();
+    if (GetParam() == PollerType::kEpoll)
+      EXPECT_NE(dynamic_cast<const Epoll*>(poller), nullptr);
+#if defined(TINYREDIS_HAVE_IO_URING)
+    else
+      EXPECT_NE(dynamic_cast<const IoUring*>(poller), nullptr);
+#endif
+  }
+};
+}  // namespace
+
+// 每个循环以 SO_REUSEPORT 各自监听同一端口，内核把连接分给所有循环
+TEST_P(ServerTest, EveryLoopAcceptsConnections) {
+  int port = 0;
+  int probe = bindLoopback(false, port);
+  ASSERT_GE(probe, 0);
+  ::close(probe);
+
+  const std::size_t kLoops = 4;
+  TestServer server;
+  server.setPoller(GetParam());
+  server.setLoopCount(kLoops);
+  ASSERT_TRUE(server.TCPBind(SocketAddr(loopbackAddr(port)), 0));
+  bool ok = false;
+  std::thread mainLoop([&]() { ok = server.MainLoop(); });
+
+  for (int i = 0; i < 2000 && server.started < kLoops; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ASSERT_EQ(server.started.load(), kLoops);
+  expectBackend(server);
+
+  // 按四元组哈希分配，连上足够多的连接后每个循环都应分到
+  std::vector<int> conns;
+  bool allAccepted = false;
+  for (int i = 0; i < 256 && !allAccepted; ++i) {
+    int fd = connectLoopback(port);
+    ASSERT_GE(fd, 0);
+    conns.push_back(fd);
+    for (int wait = 0; wait < 100; ++wait) {
+      uint64_t total = 0;
+      allAccepted = true;
+      for (std::size_t l = 0; l < kLoops; ++l) {
+        total += server.loop(l).stats().accepted;
+        allAccepted = allAccepted && server.loop(l).stats().accepted > 0;
+      }
+      if (total == conns.size())
+        break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  EXPECT_TRUE(allAccepted);
+
+  for (int fd : conns)
+    ::close(fd);
+  server.terminate();
+  mainLoop.join();
+  EXPECT_TRUE(ok);
+  EXPECT_TRUE(server.recycled);
+}
+
+// 回显几 MB 数据：io_uring 完成模型下收发都由内核完成，epoll 下走就绪通知、
+// writev 与 MSG_ZEROCOPY，两条路径都必须保证字节流完整且有序
+TEST_P(ServerTest, EchoLargeStream) {
+  int port = 0;
+  int probe = bindLoopback(false, port);
+  ASSERT_GE(probe, 0);
+  ::close(probe);
+
+  EchoServer server;
+  server.setPoller(GetParam());
+  server.setLoopCount(1);
+  server.setZeroCopyThreshold(16 * 1024);
+  ASSERT_TRUE(server.TCPBind(SocketAddr(loopbackAddr(port)), 0));
+  bool ok = false;
+  std::thread mainLoop([&]() { ok = server.MainLoop(); });
+  for (int i = 0; i < 2000 && server.started < 1; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ASSERT_EQ(server.started.load(), 1u);
+  expectBackend(server);
+
+  int fd = connectLoopback(port);
+  ASSERT_GE(fd, 0);
+  std::string sent(4 * 1024 * 1024, '\0');
+  for (std::size_t i = 0; i < sent.size(); ++i)
+    sent[i] = static_cast<char>('a' + (i * 7 + i / 4096) % 26);
+
+  // 边写边读，避免双方的发送缓冲区都被填满
+  std::thread writer([&]() {
+    std::size_t off = 0;
+    while (off < sent.size()) {
+      ssize_t n = ::write(fd, sent.data() + off,
+                          std::min<std::size_t>(sent.size() - off, 100000));
+      if (n <= 0)
+        break;
+      off += static_cast<std::size_t>(n);
+    }
+  });
+  std::string received;
+  received.reserve(sent.size());
+  char buf[64 * 1024];
+  while (received.size() < sent.size()) {
+    ssize_t n = ::read(fd, buf, sizeof(buf));
+    if (n <= 0)
+      break;
+    received.append(buf, static_cast<std::size_t>(n));
+  }
+  writer.join();
+
+  ASSERT_EQ(received.size(), sent.size());
+  // 不用 EXPECT_EQ，避免失败时打印几 MB 的内容
+  EXPECT_TRUE(received == sent);
+
+  ::close(fd);
+  server.terminate();
+  mainLoop.join();
+  EXPECT_TRUE(ok);
+}
+
+// 暂停接收期间对端继续发送大量数据：既不读进来也不扩容接收缓冲区，
+// 数据由 TCP 流控挡住；恢复后一个字节不少地处理完
+TEST_P(ServerTest, PausedReadDoesNotBuffer) {
+  int port = 0;
+  int probe = bindLoopback(false, port);
+  ASSERT_GE(probe, 0);
+  ::close(probe);
+
+  PausingServer server;
+  server.setPoller(GetParam());
+  server.setLoopCount(1);
+  ASSERT_TRUE(server.TCPBind(SocketAddr(loopbackAddr(port)), 0));
+  bool ok = false;
+  std::thread mainLoop([&]() { ok = server.MainLoop(); });
+  for (int i = 0; i < 2000 && server.started < 1; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  int fd = connectLoopback(port);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(::write(fd, "PAUSE\n", 6), 6);
+  for (int i = 0; i < 2000 && server.consumed() < 6; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ASSERT_EQ(server.consumed(), 6u);
+
+  const std::size_t kBytes = 32 * 1024 * 1024;
+  std::thread writer([&]() {
+    std::string chunk(64 * 1024, 'x');
+    std::size_t off = 0;
+    while (off < kBytes) {
+      ssize_t n = ::write(fd, chunk.data(),
+                          std::min(chunk.size(), kBytes - off));
+      if (n <= 0)
+        break;
+      off += static_cast<std::size_t>(n);
+    }
+  });
+  // 写满双方的内核缓冲区后 writer 阻塞
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(server.consumed(), 6u);
+  EXPECT_LE(server.conn->pausedCapacity.load(), 64u * 1024);
+
+  std::shared_ptr<PausingSocket> conn = server.conn;
+  conn->getLoop()->post([conn]() { conn->resume(); });
+  writer.join();
+  for (int i = 0; i < 5000 && server.consumed() < kBytes + 6; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_EQ(server.consumed(), kBytes + 6);
+
+  ::close(fd);
+  server.terminate();
+  mainLoop.join();
+  EXPECT_TRUE(ok);
+}
+
+// 端口被不带 SO_REUSEPORT 的套接字占用时启动失败，并且照常清理
+TEST_P(ServerTest, ListenFailureRecyclesAndFails) {
+  int port = 0;
+  int holder = bindLoopback(true, port);
+  ASSERT_GE(holder, 0);
+
+  TestServer server;
+  server.setPoller(GetParam());
+  server.setLoopCount(2);
+  ASSERT_TRUE(server.TCPBind(SocketAddr(loopbackAddr(port)), 0));
+  EXPECT_FALSE(server.MainLoop());
+  EXPECT_TRUE(server.recycled);
+  EXPECT_EQ(server.loopCount(), 0u);
+  EXPECT_EQ(server.started.load(), 0u);
+
+  ::close(holder);
+}
+
+INSTANTIATE_TEST_SUITE_P(Pollers, ServerTest,
+                         ::testing::Values(PollerType::kEpoll,
+                                           PollerType::kIoUring),
+                         [](const ::testing::TestParamInfo<PollerType>& info)
+                             -> std::string {
+                           return info.param == PollerType::kEpoll
+                                      ? "epoll"
+                                      : "io_uring";
+                         });
+
+// 循环编号要放进连接 ID 的 8 位分片里，超过上限的循环数按上限处理
+TEST(ServerLoopCountTest, ClampedToShardLimit) {
+  int port = 0;
+  int probe = bindLoopback(false, port);
+  ASSERT_GE(probe, 0);
+  ::close(probe);
+
+  TestServer server;
+  server.setPoller(PollerType::kEpoll);
+  server.setLoopCount(Server::kMaxLoopCount + 1);
+  ASSERT_TRUE(server.TCPBind(SocketAddr(loopbackAddr(port)), 0));
+  bool ok = false;
+  std::thread mainLoop([&]() { ok = server.MainLoop(); });
+  for (int i = 0; i < 5000 && server.started < Server::kMaxLoopCount; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_EQ(server.started.load(), Server::kMaxLoopCount);
+  EXPECT_EQ(server.loopCount(), Server::kMaxLoopCount);
+
+  server.terminate();
+  mainLoop.join();
+  EXPECT_TRUE(ok);
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <base/eventLoop.h>
+#include <base/server.h>
+#include <base/socket/listenSocket.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <memory>
+#include <vector>
+
+using Internal::EventLoop;
+using Internal::ListenSocket;
+
+// 完成模型下内核一轮交来的连接超过 kAcceptBatch 时，多出的留到后面几轮再建
+TEST(ListenSocketTest, CompletionAcceptsAreBatched) {
+  Server server;
+  EventLoop loop(&server, 0);
+  auto listener = std::make_shared<ListenSocket>(0);
+  listener->setLoop(&loop);
+
+  const int kConns = ListenSocket::kAcceptBatch * 2 + 10;
+  std::vector<int> peers;
+  for (int i = 0; i < kConns; ++i) {
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds), 0);
+    peers.push_back(fds[1]);
+    listener->OnAcceptComplete(fds[0]);
+  }
+  listener->commitAccepted();
+  EXPECT_EQ(loop.stats().accepted.load(),
+            static_cast<uint64_t>(ListenSocket::kAcceptBatch));
+  EXPECT_TRUE(listener->acceptPending());
+
+  listener->acceptDeferred();
+  listener->commitAccepted();
+  EXPECT_EQ(loop.stats().accepted.load(),
+            static_cast<uint64_t>(ListenSocket::kAcceptBatch * 2));
+  EXPECT_TRUE(listener->acceptPending());
+
+  // 还有 fd 留着时新到的连接排在它们后面
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds), 0);
+  peers.push_back(fds[1]);
+  listener->OnAcceptComplete(fds[0]);
+  listener->acceptDeferred();
+  listener->commitAccepted();
+  EXPECT_EQ(loop.stats().accepted.load(), static_cast<uint64_t>(kConns + 1));
+  EXPECT_FALSE(listener->acceptPending());
+
+  for (int fd : peers)
+    ::close(fd);
+}
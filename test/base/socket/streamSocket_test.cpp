@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+#include <base/socket/streamSocket.h>
+#include <base/thread/sendThread.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+// 每个请求固定为 "PING\r\n"，回复 "+PONG\r\n"
+class PingSocket : public StreamSocket {
+ private:
+  packetLength _HandlePacket(const char* msg, std::size_t len) override {
+    if (len < 6)
+      return 0;
+    EXPECT_EQ(std::string(msg, 6), "PING\r\n");
+    sendPacket("+PONG\r\n", 7);
+    return 6;
+  }
+};
+}  // namespace
+
+TEST(StreamSocketTest, PipelineIsOneBatchAndOneWritev) {
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+  auto sock = std::make_shared<PingSocket>();
+  ASSERT_TRUE(sock->init(fds[0], SocketAddr()));
+
+  std::string pipeline;
+  for (int i = 0; i < 100; ++i)
+    pipeline += "PING\r\n";
+  ASSERT_EQ(::write(fds[1], pipeline.data(), pipeline.size()),
+            static_cast<ssize_t>(pipeline.size()));
+
+  ASSERT_TRUE(sock->OnReadable());
+  EXPECT_TRUE(sock->DoMsgParse());
+
+  const StreamSocket::BatchStats& st = sock->batchStats();
+  EXPECT_EQ(st.batches, 1u);
+  EXPECT_EQ(st.commands, 100u);
+  EXPECT_EQ(st.lastBatch, 100u);
+  EXPECT_EQ(st.maxBatch, 100u);
+
+  // 100 个回复都在发送缓冲区里，一次 writev 发完；没有事件循环时手动登记
+  Internal::SendThread sender(nullptr);
+  sender.addPending(sock);
+  EXPECT_EQ(sender.flush(), 700u);
+  EXPECT_EQ(sender.writevCalls(), 1u);
+  EXPECT_EQ(st.flushes, 1u);
+  EXPECT_EQ(st.writevCalls, 1u);
+
+  char buf[1024];
+  EXPECT_EQ(::read(fds[1], buf, sizeof(buf)), 700);
+
+  // 半个请求不算一批
+  ASSERT_EQ(::write(fds[1], "PIN", 3), 3);
+  ASSERT_TRUE(sock->OnReadable());
+  EXPECT_FALSE(sock->DoMsgParse());
+  EXPECT_EQ(st.batches, 1u);
+
+  ::close(fds[1]);
+}
+
+namespace {
+// 回环上建立一对 TCP 连接，返回 false 表示环境不支持
+bool tcpPair(int fds[2]) {
+  int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  bool ok = listener >= 0 &&
+            ::bind(listener, reinterpret_cast<sockaddr*>(&addr), len) == 0 &&
+            ::listen(listener, 1) == 0 &&
+            ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr),
+                          &len) == 0;
+  fds[1] = ok ? ::socket(AF_INET, SOCK_STREAM, 0) : -1;
+  ok = ok && fds[1] >= 0 &&
+       ::connect(fds[1], reinterpret_cast<sockaddr*>(&addr), len) == 0;
+  fds[0] = ok ? ::accept(listener, nullptr, nullptr) : -1;
+  if (listener >= 0)
+    ::close(listener);
+  return fds[0] >= 0;
+}
+}  // namespace
+
+// 零拷贝的块还没等到完成通知时，closeAfterReply 不能关闭连接、释放内存
+TEST(StreamSocketTest, CloseAfterReplyWaitsForZeroCopyCompletion) {
+  int fds[2];
+  if (!tcpPair(fds))
+    GTEST_SKIP() << "loopback TCP unavailable";
+  ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+  auto sock = std::make_shared<PingSocket>();
+  ASSERT_TRUE(sock->init(fds[0], SocketAddr()));
+  sock->enableZeroCopy(1);
+  if (!sock->zeroCopyEnabled()) {
+    ::close(fds[1]);
+    GTEST_SKIP() << "SO_ZEROCOPY unsupported";
+  }
+
+  const std::size_t kLen = 64 * 1024;
+  std::weak_ptr<const void> weak;
+  {
+    std::shared_ptr<const char> owner(new char[kLen](),
+                                      std::default_delete<char[]>());
+    weak = owner;
+    ASSERT_TRUE(sock->sendPacket(owner, owner.get(), kLen));
+  }
+  sock->closeAfterReply();
+
+  Internal::SendThread sender(nullptr);
+  sender.addPending(sock);
+  EXPECT_EQ(sender.flush(), kLen);
+  EXPECT_FALSE(sock->invalid());
+  EXPECT_FALSE(weak.expired());
+
+  std::string received;
+  char buf[16 * 1024];
+  while (received.size() < kLen) {
+    ssize_t n = ::read(fds[1], buf, sizeof(buf));
+    ASSERT_GT(n, 0);
+    received.append(buf, static_cast<std::size_t>(n));
+  }
+  for (int i = 0; i < 1000 && !sock->reapZeroCopy(); ++i)
+    ::usleep(1000);
+  EXPECT_TRUE(weak.expired());
+
+  // 通知到齐之后才关闭；没有事件循环时手动登记
+  sender.addPending(sock);
+  sender.flush();
+  EXPECT_TRUE(sock->invalid());
+  ::close(fds[1]);
+}
+
+namespace {
+// 每个请求是以 '\n' 结尾的一行，记下每次解析时看到的帧首地址
+class LineSocket : public StreamSocket {
+ public:
+  std::vector<std::string> lines;
+  std::set<const char*> starts;
+
+  std::size_t recvCapacity() const { return recvBuf_.capacity(); }
+
+ private:
+  packetLength _HandlePacket(const char* msg, std::size_t len) override {
+    starts.insert(msg);
+    const void* nl = std::memchr(msg, '\n', len);
+    if (!nl)
+      return 0;
+    const std::size_t n = static_cast<const char*>(nl) - msg + 1;
+    lines.push_back(std::string(msg, n));
+    starts.clear();
+    return static_cast<packetLength>(n);
+  }
+};
+}  // namespace
+
+// 跨过缓冲区末尾、分多次到达的帧只挪动一次，之后的数据接在后面解析
+TEST(StreamSocketTest, WrappedFrameIsLinearizedOnce) {
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+  auto sock = std::make_shared<LineSocket>();
+  ASSERT_TRUE(sock->init(fds[0], SocketAddr()));
+
+  // 先把读位置推到 64KB 缓冲区的末尾附近
+  const std::string filler = std::string(60000 - 1, 'f') + "\n";
+  ASSERT_EQ(::write(fds[1], filler.data(), filler.size()),
+            static_cast<ssize_t>(filler.size()));
+  ASSERT_TRUE(sock->OnReadable());
+  EXPECT_TRUE(sock->DoMsgParse());
+  ASSERT_EQ(sock->lines.size(), 1u);
+
+  std::string frame;
+  for (int i = 0; i < 20000 - 1; ++i)
+    frame.push_back(static_cast<char>('a' + i % 26));
+  frame.push_back('\n');
+  const std::size_t kChunk = 2000;
+  for (std::size_t off = 0; off < frame.size(); off += kChunk) {
+    ASSERT_EQ(::write(fds[1], frame.data() + off, kChunk),
+              static_cast<ssize_t>(kChunk));
+    ASSERT_TRUE(sock->OnReadable());
+    sock->DoMsgParse();
+    // 绕圈前在原处解析，绕圈后都在缓冲区开头，不会每次换一块拷贝
+    if (off + kChunk < frame.size()) {
+      EXPECT_LE(sock->starts.size(), 2u);
+    }
+  }
+  ASSERT_EQ(sock->lines.size(), 2u);
+  EXPECT_EQ(sock->lines[1], frame);
+
+  ::close(fds[1]);
+}
+
+// 大请求让接收缓冲区扩容，处理完后缩回默认大小
+TEST(StreamSocketTest, RecvBufferShrinksAfterLargeFrame) {
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+  auto sock = std::make_shared<LineSocket>();
+  ASSERT_TRUE(sock->init(fds[0], SocketAddr()));
+
+  const std::string frame = std::string(256 * 1024 - 1, 'x') + "\n";
+  const std::size_t kChunk = 16 * 1024;
+  std::size_t maxCapacity = 0;
+  for (std::size_t off = 0; off < frame.size(); off += kChunk) {
+    ASSERT_EQ(::write(fds[1], frame.data() + off, kChunk),
+              static_cast<ssize_t>(kChunk));
+    ASSERT_TRUE(sock->OnReadable());
+    sock->DoMsgParse();
+    maxCapacity = std::max(maxCapacity, sock->recvCapacity());
+  }
+  ASSERT_EQ(sock->lines.size(), 1u);
+  EXPECT_EQ(sock->lines[0], frame);
+  EXPECT_GE(maxCapacity, frame.size());
+  EXPECT_EQ(sock->recvCapacity(), 64u * 1024);
+
+  ::close(fds[1]);
+}
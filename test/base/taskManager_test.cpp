@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <base/taskManager.h>
+
+#include <memory>
+#include <vector>
+
+using Internal::TaskManager;
+
+TEST(TaskManagerTest, FindById) {
+  TaskManager tm(3);
+  std::vector<std::shared_ptr<StreamSocket>> socks;
+  for (int i = 0; i < 100; ++i) {
+    socks.push_back(std::make_shared<StreamSocket>());
+    tm.addTask(socks.back());
+  }
+  tm.DoMsgParse();
+  ASSERT_EQ(tm.size(), 100u);
+
+  for (const auto& sock : socks) {
+    EXPECT_EQ(tm.findTCP(sock->getID()), sock);
+    // 分片编号编码在 ID 中
+    EXPECT_EQ((sock->getID() >> TaskManager::kSlotBits) &
+                  ((1U << TaskManager::kShardBits) - 1),
+              3u);
+  }
+  EXPECT_EQ(tm.findTCP(0), nullptr);
+  tm.clear();
+}
+
+TEST(TaskManagerTest, StaleIdAfterSlotReuse) {
+  TaskManager tm;
+  auto a = std::make_shared<StreamSocket>();
+  auto b = std::make_shared<StreamSocket>();
+  tm.addTask(a);
+  tm.addTask(b);
+  tm.DoMsgParse();
+  const std::size_t oldId = a->getID();
+
+  // 失效的连接在下一轮被移除，空出的槽给新连接使用；
+  // 没有事件循环时需要手动挂到就绪链表
+  a->OnError();
+  tm.markReady(a.get());
+  tm.DoMsgParse();
+  EXPECT_EQ(tm.size(), 1u);
+  EXPECT_EQ(tm.findTCP(oldId), nullptr);
+  EXPECT_EQ(tm.findTCP(b->getID()), b);
+
+  auto c = std::make_shared<StreamSocket>();
+  tm.addTask(c);
+  tm.DoMsgParse();
+  EXPECT_NE(c->getID(), oldId);
+  EXPECT_EQ(c->getID() & ((1U << TaskManager::kSlotBits) - 1),
+            oldId & ((1U << TaskManager::kSlotBits) - 1));
+  EXPECT_EQ(tm.findTCP(oldId), nullptr);
+  EXPECT_EQ(tm.findTCP(c->getID()), c);
+  tm.clear();
+}
+
+TEST(TaskManagerTest, OnlyReadyTasksAreParsed) {
+  TaskManager tm;
+  auto idle = std::make_shared<StreamSocket>();
+  auto busy = std::make_shared<StreamSocket>();
+  tm.addTask(idle);
+  tm.addTask(busy);
+  EXPECT_FALSE(tm.hasReady());
+  tm.DoMsgParse();  // 新加入的连接会先处理一次
+  EXPECT_FALSE(tm.hasReady());
+
+  tm.markReady(busy.get());
+  tm.markReady(busy.get());  // 重复登记只记一次
+  EXPECT_TRUE(tm.hasReady());
+
+  // 空闲连接失效后不挂到就绪链表就不会被访问
+  idle->OnError();
+  tm.DoMsgParse();
+  EXPECT_FALSE(tm.hasReady());
+  EXPECT_EQ(tm.size(), 2u);
+
+  tm.markReady(idle.get());
+  tm.DoMsgParse();
+  EXPECT_EQ(tm.size(), 1u);
+  EXPECT_EQ(tm.findTCP(busy->getID()), busy);
+  tm.clear();
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <base/timer/timingWheel.h>
+
+#include <vector>
+
+using Internal::TimingWheel;
+
+TEST(TimingWheelTest, FiresAtDeadline) {
+  TimingWheel wheel(1000);
+  int fired = 0;
+  wheel.schedule(5, [&fired]() { ++fired; });
+  EXPECT_EQ(wheel.advance(1004), 0u);
+  EXPECT_EQ(fired, 0);
+  EXPECT_EQ(wheel.advance(1005), 1u);
+  EXPECT_EQ(fired, 1);
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, CancelAndStaleId) {
+  TimingWheel wheel;
+  int fired = 0;
+  auto id = wheel.schedule(10, [&fired]() { ++fired; });
+  EXPECT_TRUE(wheel.cancel(id));
+  EXPECT_FALSE(wheel.cancel(id));
+
+  // 节点被复用后，旧的 id 不能取消新的定时器
+  auto id2 = wheel.schedule(10, [&fired]() { ++fired; });
+  EXPECT_FALSE(wheel.cancel(id));
+  wheel.advance(10);
+  EXPECT_EQ(fired, 1);
+  EXPECT_FALSE(wheel.cancel(id2));
+  EXPECT_FALSE(wheel.cancel(TimingWheel::kInvalidTimer));
+}
+
+TEST(TimingWheelTest, CascadesAcrossLevels) {
+  // 覆盖每一层以及超出范围的情况
+  const uint64_t delays[] = {1, 255, 256, 300, 16383, 16384, 70000,
+                             1048576, 5000000, 67108864, 100000000};
+  TimingWheel wheel(7);
+  std::vector<uint64_t> firedAt;
+  uint64_t now = 7;
+  for (uint64_t d : delays)
+    wheel.schedule(d, [&firedAt, &now]() { firedAt.push_back(now); });
+
+  // 每次推进到 nextTimeoutMs 给出的时刻，检查不会睡过头
+  while (!wheel.empty()) {
+    int wait = wheel.nextTimeoutMs(now, 1 << 30);
+    ASSERT_GT(wait, 0);
+    now += wait;
+    wheel.advance(now);
+  }
+
+  ASSERT_EQ(firedAt.size(), sizeof(delays) / sizeof(delays[0]));
+  for (std::size_t i = 0; i < firedAt.size(); ++i)
+    EXPECT_EQ(firedAt[i], 7 + delays[i]);
+}
+
+TEST(TimingWheelTest, PeriodicAndReentrant) {
+  TimingWheel wheel;
+  int ticks = 0;
+  TimingWheel::TimerId periodic = TimingWheel::kInvalidTimer;
+  periodic = wheel.schedule(10, [&]() {
+    // 第三次触发时在回调里取消自己
+    if (++ticks == 3)
+      wheel.cancel(periodic);
+  }, 10);
+
+  int zeroDelay = 0;
+  wheel.schedule(1, [&]() {
+    // 回调里添加的 0 延迟定时器在下一个时刻触发
+    wheel.schedule(0, [&zeroDelay]() { ++zeroDelay; });
+  });
+
+  wheel.advance(1);
+  EXPECT_EQ(zeroDelay, 0);
+  wheel.advance(2);
+  EXPECT_EQ(zeroDelay, 1);
+
+  wheel.advance(100);
+  EXPECT_EQ(ticks, 3);
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, NextTimeout) {
+  TimingWheel wheel(0);
+  EXPECT_EQ(wheel.nextTimeoutMs(0, 100), 100);
+  wheel.schedule(30, []() {});
+  EXPECT_EQ(wheel.nextTimeoutMs(0, 100), 30);
+  EXPECT_EQ(wheel.nextTimeoutMs(10, 100), 20);
+  EXPECT_EQ(wheel.nextTimeoutMs(10, 5), 5);
+  EXPECT_EQ(wheel.nextTimeoutMs(40, 100), 0);
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <server/db/bplusTree.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using tinyredis::BPlusTree;
+using tinyredis::Slice;
+
+namespace {
+using Key = std::pair<double, std::string>;
+
+Slice slice(const std::string& s) {
+  return Slice{s.data(), s.size()};
+}
+
+// 按叶子链表正向、反向各遍历一次，与 expect 比较
+void expectOrder(const BPlusTree& tree, const std::set<Key>& expect) {
+  ASSERT_EQ(tree.size(), expect.size());
+  BPlusTree::Cursor c = tree.first();
+  for (const Key& k : expect) {
+    ASSERT_TRUE(c.valid());
+    EXPECT_EQ(c.score(), k.first);
+    EXPECT_EQ(c.member(), k.second);
+    c.next();
+  }
+  EXPECT_FALSE(c.valid());
+  c = tree.last();
+  for (auto it = expect.rbegin(); it != expect.rend(); ++it) {
+    ASSERT_TRUE(c.valid());
+    EXPECT_EQ(c.member(), it->second);
+    c.prev();
+  }
+  EXPECT_FALSE(c.valid());
+}
+}  // namespace
+
+TEST(BPlusTreeTest, OrdersByScoreThenMember) {
+  BPlusTree tree;
+  tree.insert(2, Slice{"b", 1});
+  tree.insert(1, Slice{"z", 1});
+  tree.insert(2, Slice{"a", 1});
+  tree.insert(-1, Slice{"m", 1});
+  expectOrder(tree, {{-1, "m"}, {1, "z"}, {2, "a"}, {2, "b"}});
+  EXPECT_EQ(tree.rank(2, Slice{"a", 1}), 2u);
+  EXPECT_EQ(tree.rank(2, Slice{"c", 1}), BPlusTree::npos);
+  EXPECT_EQ(tree.byRank(3).member(), "b");
+  EXPECT_FALSE(tree.byRank(4).valid());
+  EXPECT_EQ(tree.height(), 1);
+}
+
+TEST(BPlusTreeTest, RandomInsertEraseMatchesSet) {
+  BPlusTree tree;
+  std::set<Key> expect;
+  std::mt19937 rng(11);
+  // 分数范围小，大量成员分数相同，覆盖按成员比较的分支
+  for (int i = 0; i < 20000; ++i) {
+    const double score = static_cast<double>(rng() % 300);
+    std::string member = "m" + std::to_string(rng() % 50000);
+    if (expect.insert(Key(score, member)).second)
+      tree.insert(score, slice(member));
+  }
+  EXPECT_GT(tree.height(), 2);
+  expectOrder(tree, expect);
+
+  // 随机删除一半以上，覆盖合并与均分
+  std::vector<Key> keys(expect.begin(), expect.end());
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (std::size_t i = 0; i < keys.size() * 2 / 3; ++i) {
+    ASSERT_TRUE(tree.erase(keys[i].first, slice(keys[i].second)));
+    expect.erase(keys[i]);
+    EXPECT_FALSE(tree.erase(keys[i].first, slice(keys[i].second)));
+  }
+  expectOrder(tree, expect);
+
+  std::size_t r = 0;
+  for (const Key& k : expect) {
+    ASSERT_EQ(tree.rank(k.first, slice(k.second)), r);
+    const BPlusTree::Cursor c = tree.byRank(r);
+    ASSERT_TRUE(c.valid());
+    EXPECT_EQ(c.member(), k.second);
+    ++r;
+  }
+}
+
+TEST(BPlusTreeTest, CountBelowGivesScoreBounds) {
+  BPlusTree tree;
+  std::vector<double> scores;
+  for (int i = 0; i < 5000; ++i) {
+    const double score = static_cast<double>(i % 250) / 2;
+    std::string member = "m" + std::to_string(i);
+    tree.insert(score, slice(member));
+    scores.push_back(score);
+  }
+  std::sort(scores.begin(), scores.end());
+  for (double s = -1; s <= 126; s += 0.25) {
+    const std::size_t less = static_cast<std::size_t>(
+        std::lower_bound(scores.begin(), scores.end(), s) - scores.begin());
+    const std::size_t notGreater = static_cast<std::size_t>(
+        std::upper_bound(scores.begin(), scores.end(), s) - scores.begin());
+    EXPECT_EQ(tree.countBelow(s, false), less) << s;
+    EXPECT_EQ(tree.countBelow(s, true), notGreater) << s;
+  }
+}
+
+TEST(BPlusTreeTest, EraseToEmptyAndReuse) {
+  BPlusTree tree;
+  for (int i = 0; i < 3000; ++i) {
+    std::string m = "m" + std::to_string(i);
+    tree.insert(i, slice(m));
+  }
+  for (int i = 0; i < 3000; ++i) {
+    std::string m = "m" + std::to_string(i);
+    ASSERT_TRUE(tree.erase(i, slice(m)));
+  }
+  EXPECT_EQ(tree.size(), 0u);
+  EXPECT_EQ(tree.height(), 1);
+  EXPECT_FALSE(tree.first().valid());
+  EXPECT_FALSE(tree.last().valid());
+  EXPECT_EQ(tree.nodeBytes(), sizeof(BPlusTree::Leaf));
+
+  tree.insert(1, Slice{"x", 1});
+  EXPECT_EQ(tree.rank(1, Slice{"x", 1}), 0u);
+}
+
+TEST(BPlusTreeTest, UpdateScoreMovesElement) {
+  BPlusTree tree;
+  std::set<Key> expect;
+  for (int i = 0; i < 1000; ++i) {
+    std::string m = "m" + std::to_string(i);
+    tree.insert(i, slice(m));
+    expect.insert(Key(i, m));
+  }
+  // 叶子内部：原地修改
+  EXPECT_TRUE(tree.updateScore(5, Slice{"m5", 2}, 5.5));
+  EXPECT_EQ(tree.rank(5.5, Slice{"m5", 2}), 5u);
+  expect.erase(Key(5, "m5"));
+  expect.insert(Key(5.5, "m5"));
+  // 移到另一端
+  EXPECT_TRUE(tree.updateScore(10, Slice{"m10", 3}, 5000));
+  EXPECT_EQ(tree.rank(5000, Slice{"m10", 3}), 999u);
+  expect.erase(Key(10, "m10"));
+  expect.insert(Key(5000, "m10"));
+  EXPECT_TRUE(tree.updateScore(900, Slice{"m900", 4}, -1));
+  EXPECT_EQ(tree.rank(-1, Slice{"m900", 4}), 0u);
+  expect.erase(Key(900, "m900"));
+  expect.insert(Key(-1, "m900"));
+  EXPECT_FALSE(tree.updateScore(7, Slice{"m8", 2}, 1));
+  expectOrder(tree, expect);
+
+  std::vector<std::string> got;
+  tree.range(1, 3, [&got](const std::string& m, double) { got.push_back(m); });
+  EXPECT_EQ(got, (std::vector<std::string>{"m0", "m1", "m2"}));
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <server/db/database.h>
+#include <server/db/dict.h>
+
+#include <cstdint>
+#include <set>
+#include <string>
+
+using tinyredis::Dict;
+
+namespace {
+using IntDict = Dict<uint64_t, uint64_t>;
+}  // namespace
+
+TEST(DictTest, SetFindEraseAcrossResizes) {
+  IntDict d;
+  const uint64_t n = 10000;
+  for (uint64_t i = 0; i < n; ++i) {
+    EXPECT_TRUE(d.set(i, i * 2));
+    // 迁移进行到一半时，新旧两张表里的键都必须能找到
+    if (i % 97 == 0) {
+      for (uint64_t j = 0; j <= i; j += 13)
+        ASSERT_NE(d.find(j), nullptr) << i << " " << j;
+    }
+  }
+  EXPECT_EQ(d.size(), n);
+  EXPECT_FALSE(d.set(uint64_t(5), uint64_t(7)));
+  EXPECT_EQ(*d.find(uint64_t(5)), 7u);
+
+  for (uint64_t i = 0; i < n; i += 2)
+    EXPECT_TRUE(d.erase(i));
+  EXPECT_FALSE(d.erase(uint64_t(0)));
+  EXPECT_EQ(d.size(), n / 2);
+  for (uint64_t i = 0; i < n; ++i)
+    EXPECT_EQ(d.find(i) != nullptr, i % 2 == 1) << i;
+}
+
+TEST(DictTest, RehashIsIncremental) {
+  IntDict d;
+  d.reserve(1024);
+  for (uint64_t i = 0; i < 1024; ++i)
+    d.set(i, i);
+  EXPECT_FALSE(d.isRehashing());
+
+  // 装满后再插入触发扩容，但一次操作只迁移一个桶
+  d.set(uint64_t(1024), uint64_t(1024));
+  ASSERT_TRUE(d.isRehashing());
+  EXPECT_EQ(d.bucketCount(), 1024u + 2048u);
+  d.find(uint64_t(1));
+  EXPECT_TRUE(d.isRehashing());
+
+  // 空闲时在预算内完成剩余迁移
+  while (d.rehashFor(1000) > 0) {
+  }
+  EXPECT_FALSE(d.isRehashing());
+  EXPECT_EQ(d.bucketCount(), 2048u);
+  for (uint64_t i = 0; i <= 1024; ++i)
+    ASSERT_NE(d.find(i), nullptr);
+}
+
+TEST(DictTest, ShrinksWhenSparse) {
+  IntDict d;
+  for (uint64_t i = 0; i < 4096; ++i)
+    d.set(i, i);
+  while (d.rehash(100)) {
+  }
+  const std::size_t before = d.bucketCount();
+  for (uint64_t i = 0; i < 4000; ++i)
+    d.erase(i);
+  while (d.rehash(100)) {
+  }
+  EXPECT_LE(d.bucketCount(), before / 8);
+  EXPECT_EQ(d.size(), 96u);
+  for (uint64_t i = 4000; i < 4096; ++i)
+    ASSERT_NE(d.find(i), nullptr);
+}
+
+TEST(DictTest, ScanSurvivesResize) {
+  IntDict d;
+  for (uint64_t i = 0; i < 500; ++i)
+    d.set(i, i);
+
+  // 前 100 次 scan 之间不断插入，表会经历几次扩容，scan 时常处在迁移中；
+  // 从头到尾一直存在的键必须都被返回
+  std::set<uint64_t> seen;
+  uint64_t cursor = 0;
+  uint64_t next = 500;
+  int calls = 0;
+  do {
+    cursor = d.scan(cursor, [&seen](const IntDict::Entry& e) {
+      seen.insert(e.key);
+    });
+    if (calls++ < 100) {
+      for (int k = 0; k < 20; ++k)
+        d.set(next++, uint64_t(0));
+    }
+  } while (cursor != 0);
+
+  EXPECT_GT(calls, 1);
+  for (uint64_t i = 0; i < 500; ++i)
+    EXPECT_EQ(seen.count(i), 1u) << i;
+}
+
+TEST(DictTest, SafeIteratorAllowsDeletingCurrent) {
+  IntDict d;
+  for (uint64_t i = 0; i < 1024; ++i)
+    d.set(i, i);
+  d.set(uint64_t(1024), uint64_t(1024));  // 表已满，开始一次扩容
+  ASSERT_TRUE(d.isRehashing());
+
+  std::set<uint64_t> seen;
+  {
+    IntDict::Iterator it(&d);
+    while (IntDict::Entry* e = it.next()) {
+      EXPECT_TRUE(seen.insert(e->key).second) << "duplicate " << e->key;
+      if (e->key % 2 == 0)
+        d.erase(e->key);
+    }
+    // 迭代期间没有迁移
+    EXPECT_TRUE(d.isRehashing());
+  }
+  EXPECT_EQ(seen.size(), 1025u);
+  EXPECT_EQ(d.size(), 512u);
+}
+
+TEST(DictTest, KeyspaceLooksUpBySlice) {
+  tinyredis::Database::Keyspace keys;
+  keys.set(std::string("user:1"), tinyredis::Object::fromString("alice", 5));
+  const char req[] = "GET user:1";
+  tinyredis::Object* v = keys.find(tinyredis::Slice{req + 4, 6});
+  ASSERT_NE(v, nullptr);
+  char buf[tinyredis::Object::kIntBufSize];
+  EXPECT_EQ(v->stringValue(buf).toString(), "alice");
+  EXPECT_EQ(keys.find(tinyredis::Slice{req + 4, 5}), nullptr);
+  EXPECT_TRUE(keys.erase(tinyredis::Slice{req + 4, 6}));
+  EXPECT_TRUE(keys.empty());
+}
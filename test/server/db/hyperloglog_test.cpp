@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <server/db/hyperloglog.h>
+#include "support/kernelGuard.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+
+using tinyredis::Object;
+using tinyredis::Slice;
+
+namespace hll = tinyredis::hll;
+
+namespace {
+const hll::Kernel kKernels[] = {hll::Kernel::kScalar, hll::Kernel::kAvx2};
+const std::size_t kSparseMaxBytes = 3000;
+
+Slice contents(const Object& o, char* buf) {
+  return o.stringValue(buf);
+}
+
+std::string element(std::size_t i) {
+  return "element:" + std::to_string(i);
+}
+
+// 从 0 开始合并，得到 o 展开后的寄存器
+std::unique_ptr<hll::Registers> registersOf(const Object& o) {
+  std::unique_ptr<hll::Registers> regs(new hll::Registers);
+  std::memset(regs->r, 0, sizeof(regs->r));
+  char buf[Object::kIntBufSize];
+  EXPECT_TRUE(hll::merge(*regs, contents(o, buf)));
+  return regs;
+}
+
+uint64_t countOf(Object& o) {
+  uint64_t card = 0;
+  EXPECT_TRUE(hll::count(o, &card));
+  return card;
+}
+
+class HyperLogLogTest : public ::testing::Test {
+ private:
+  tinyredis::KernelGuard<hll::Kernel> guard_{hll::kernels()};
+};
+}  // namespace
+
+TEST_F(HyperLogLogTest, EmptyIsSparse) {
+  Object o = hll::create();
+  char buf[Object::kIntBufSize];
+  const Slice s = contents(o, buf);
+  EXPECT_TRUE(hll::valid(s));
+  EXPECT_FALSE(hll::isDense(s));
+  EXPECT_EQ(hll::kHeaderSize + 2, s.len);
+  EXPECT_EQ(0u, countOf(o));
+
+  EXPECT_FALSE(hll::valid(Slice{"HYLL", 4}));
+  const std::string notHll(hll::kDenseSize, 'x');
+  EXPECT_FALSE(hll::valid(Slice{notHll.data(), notHll.size()}));
+}
+
+TEST_F(HyperLogLogTest, AddIsIdempotent) {
+  Object o = hll::create();
+  EXPECT_EQ(1, hll::add(o, Slice{"a", 1}, kSparseMaxBytes));
+  EXPECT_EQ(0, hll::add(o, Slice{"a", 1}, kSparseMaxBytes));
+  EXPECT_EQ(1u, countOf(o));
+  // 第二次读取使用缓存
+  EXPECT_EQ(1u, countOf(o));
+}
+
+TEST_F(HyperLogLogTest, EstimateWithinStandardError) {
+  Object o = hll::create();
+  const std::size_t checkpoints[] = {10, 100, 1000, 10000, 100000};
+  std::size_t added = 0;
+  for (std::size_t target : checkpoints) {
+    for (; added < target; ++added) {
+      const std::string e = element(added);
+      ASSERT_GE(hll::add(o, Slice{e.data(), e.size()}, kSparseMaxBytes), 0);
+    }
+    const double card = static_cast<double>(countOf(o));
+    // 标准误差约 0.81%，留足余量
+    EXPECT_NEAR(static_cast<double>(target), card, target * 0.03 + 1)
+        << target;
+  }
+  char buf[Object::kIntBufSize];
+  EXPECT_TRUE(hll::isDense(contents(o, buf)));
+}
+
+// sparse 中途转为 dense 不影响寄存器
+TEST_F(HyperLogLogTest, SparseMatchesDense) {
+  Object sparse = hll::create();
+  Object dense = hll::create();
+  char buf[Object::kIntBufSize];
+  for (std::size_t i = 0; i < 3000; ++i) {
+    const std::string e = element(i);
+    const Slice s{e.data(), e.size()};
+    const int a = hll::add(sparse, s, 1 << 20);
+    const int b = hll::add(dense, s, 0);
+    ASSERT_EQ(b, a) << i;
+  }
+  EXPECT_FALSE(hll::isDense(contents(sparse, buf)));
+  EXPECT_TRUE(hll::isDense(contents(dense, buf)));
+  EXPECT_EQ(0, std::memcmp(registersOf(sparse)->r, registersOf(dense)->r,
+                           hll::kRegisters));
+  EXPECT_EQ(countOf(dense), countOf(sparse));
+
+  // 超过上限时转为 dense
+  Object limited = hll::create();
+  for (std::size_t i = 0; i < 3000; ++i) {
+    const std::string e = element(i);
+    hll::add(limited, Slice{e.data(), e.size()}, 200);
+    const Slice c = contents(limited, buf);
+    ASSERT_TRUE(hll::isDense(c) || c.len <= 200) << i;
+  }
+  EXPECT_EQ(0, std::memcmp(registersOf(limited)->r, registersOf(dense)->r,
+                           hll::kRegisters));
+}
+
+TEST(HyperLogLogRegistersTest, HeapAllocationIsAligned) {
+  std::unique_ptr<hll::Registers> regs[4];
+  for (auto& r : regs) {
+    r.reset(new hll::Registers);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(r.get()) %
+                      alignof(hll::Registers));
+  }
+}
+
+TEST_F(HyperLogLogTest, StoreRoundTrip) {
+  std::mt19937 rng(1);
+  std::unique_ptr<hll::Registers> regs(new hll::Registers);
+  char buf[Object::kIntBufSize];
+  // 稀疏的小值：保持 sparse；出现大于 32 的值：dense
+  for (int maxValue : {8, 50}) {
+    std::memset(regs->r, 0, sizeof(regs->r));
+    for (int i = 0; i < 200; ++i)
+      regs->r[rng() % hll::kRegisters] =
+          static_cast<uint8_t>(rng() % maxValue + 1);
+    Object o;
+    hll::store(o, *regs, false, kSparseMaxBytes);
+    const Slice s = contents(o, buf);
+    ASSERT_TRUE(hll::valid(s));
+    EXPECT_EQ(maxValue > 32, hll::isDense(s));
+    EXPECT_EQ(0, std::memcmp(registersOf(o)->r, regs->r, hll::kRegisters));
+    EXPECT_EQ(hll::count(*regs), countOf(o));
+
+    hll::store(o, *regs, true, kSparseMaxBytes);
+    EXPECT_TRUE(hll::isDense(contents(o, buf)));
+    EXPECT_EQ(0, std::memcmp(registersOf(o)->r, regs->r, hll::kRegisters));
+  }
+}
+
+TEST_F(HyperLogLogTest, MergeKernelsAgree) {
+  std::mt19937 rng(2);
+  std::unique_ptr<hll::Registers> a(new hll::Registers);
+  std::unique_ptr<hll::Registers> b(new hll::Registers);
+  for (std::size_t i = 0; i < hll::kRegisters; ++i) {
+    a->r[i] = static_cast<uint8_t>(rng() % 64);
+    b->r[i] = static_cast<uint8_t>(rng() % 64);
+  }
+  Object da;
+  Object db;
+  hll::store(da, *a, true, 0);
+  hll::store(db, *b, true, 0);
+  char buf[Object::kIntBufSize];
+  for (hll::Kernel kernel : kKernels) {
+    if (!hll::kernels().force(kernel))
+      continue;
+    SCOPED_TRACE(hll::kernelName(kernel));
+    std::unique_ptr<hll::Registers> out(new hll::Registers);
+    std::memset(out->r, 0, sizeof(out->r));
+    ASSERT_TRUE(hll::merge(*out, contents(da, buf)));
+    ASSERT_TRUE(hll::merge(*out, contents(db, buf)));
+    for (std::size_t i = 0; i < hll::kRegisters; ++i)
+      ASSERT_EQ(std::max(a->r[i], b->r[i]), out->r[i]) << i;
+  }
+}
+
+// 两个集合的并集：合并后的估计接近并集的真实大小
+TEST_F(HyperLogLogTest, MergeEstimatesUnion) {
+  Object a = hll::create();
+  Object b = hll::create();
+  for (std::size_t i = 0; i < 20000; ++i) {
+    const std::string e = element(i);
+    hll::add(i < 15000 ? a : b, Slice{e.data(), e.size()}, kSparseMaxBytes);
+    if (i >= 10000 && i < 15000)
+      hll::add(b, Slice{e.data(), e.size()}, kSparseMaxBytes);
+  }
+  hll::Registers& regs = hll::scratch();
+  std::memset(regs.r, 0, sizeof(regs.r));
+  char buf[Object::kIntBufSize];
+  ASSERT_TRUE(hll::merge(regs, contents(a, buf)));
+  ASSERT_TRUE(hll::merge(regs, contents(b, buf)));
+  EXPECT_NEAR(20000.0, static_cast<double>(hll::count(regs)), 600.0);
+}
+
+TEST_F(HyperLogLogTest, CorruptedSparse) {
+  Object o = hll::create();
+  char buf[Object::kIntBufSize];
+  std::string s = contents(o, buf).toString();
+  // 只有一个寄存器的 ZERO
+  s.resize(hll::kHeaderSize + 1);
+  s[hll::kHeaderSize] = 0;
+  Object bad = Object::fromString(s.data(), s.size());
+  hll::Registers& regs = hll::scratch();
+  EXPECT_FALSE(hll::merge(regs, contents(bad, buf)));
+  EXPECT_EQ(-1, hll::add(bad, Slice{"x", 1}, kSparseMaxBytes));
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <server/db/intset.h>
+#include <server/db/intsetIntersect.h>
+#include "support/kernelGuard.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using tinyredis::IntArray;
+using tinyredis::IntersectKernel;
+using tinyredis::Intset;
+
+namespace {
+const IntersectKernel kKernels[] = {IntersectKernel::kScalar,
+                                    IntersectKernel::kAvx2};
+
+std::vector<int64_t> values(const Intset& is) {
+  std::vector<int64_t> out;
+  for (std::size_t i = 0; i < is.size(); ++i)
+    out.push_back(is.get(i));
+  return out;
+}
+
+// 有序、无重复、按 width 存放的随机数组
+std::vector<unsigned char> makeArray(std::mt19937_64& rng, std::size_t n,
+                                     int width, int64_t range,
+                                     std::vector<int64_t>* sorted) {
+  std::vector<int64_t> v;
+  while (v.size() < n) {
+    for (std::size_t i = v.size(); i < n; ++i)
+      v.push_back(static_cast<int64_t>(rng() % range) - range / 2);
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+  }
+  std::vector<unsigned char> bytes(n * width);
+  for (std::size_t i = 0; i < n; ++i) {
+    const int16_t v16 = static_cast<int16_t>(v[i]);
+    const int32_t v32 = static_cast<int32_t>(v[i]);
+    const void* src = width == 2   ? static_cast<const void*>(&v16)
+                      : width == 4 ? static_cast<const void*>(&v32)
+                                   : static_cast<const void*>(&v[i]);
+    std::memcpy(bytes.data() + i * width, src, width);
+  }
+  *sorted = v;
+  return bytes;
+}
+
+std::vector<int64_t> decode(const void* data, std::size_t n, int width) {
+  std::vector<int64_t> out;
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < n; ++i) {
+    int64_t v = 0;
+    if (width == 2) {
+      int16_t x;
+      std::memcpy(&x, p + i * 2, 2);
+      v = x;
+    } else if (width == 4) {
+      int32_t x;
+      std::memcpy(&x, p + i * 4, 4);
+      v = x;
+    } else {
+      std::memcpy(&v, p + i * 8, 8);
+    }
+    out.push_back(v);
+  }
+  return out;
+}
+
+class IntersectTest : public ::testing::Test {
+ private:
+  tinyredis::KernelGuard<IntersectKernel> guard_{
+      tinyredis::intersectKernels()};
+};
+}  // namespace
+
+TEST(IntsetTest, AddKeepsOrderAndUpgradesWidth) {
+  Intset is = Intset::create();
+  EXPECT_TRUE(is.add(5));
+  EXPECT_TRUE(is.add(1));
+  EXPECT_TRUE(is.add(3));
+  EXPECT_FALSE(is.add(3));
+  EXPECT_EQ(is.width(), 2);
+  EXPECT_EQ(values(is), (std::vector<int64_t>{1, 3, 5}));
+
+  EXPECT_TRUE(is.add(100000));
+  EXPECT_EQ(is.width(), 4);
+  EXPECT_TRUE(is.add(-5000000000LL));
+  EXPECT_EQ(is.width(), 8);
+  EXPECT_EQ(values(is),
+            (std::vector<int64_t>{-5000000000LL, 1, 3, 5, 100000}));
+  EXPECT_EQ(is.bytes(), Intset::kHeaderSize + 5 * 8);
+
+  EXPECT_TRUE(is.contains(100000));
+  EXPECT_FALSE(is.contains(4));
+  EXPECT_TRUE(is.erase(-5000000000LL));
+  EXPECT_FALSE(is.erase(-5000000000LL));
+  // 不会降级
+  EXPECT_EQ(is.width(), 8);
+  EXPECT_EQ(values(is), (std::vector<int64_t>{1, 3, 5, 100000}));
+  is.destroy();
+}
+
+TEST(IntsetTest, RandomMatchesSortedVector) {
+  Intset is = Intset::create();
+  std::vector<int64_t> expect;
+  std::mt19937_64 rng(3);
+  for (int i = 0; i < 3000; ++i) {
+    const int64_t v = static_cast<int64_t>(rng() % 20000) - 10000;
+    const bool fresh =
+        !std::binary_search(expect.begin(), expect.end(), v);
+    EXPECT_EQ(is.add(v), fresh);
+    if (fresh)
+      expect.insert(std::lower_bound(expect.begin(), expect.end(), v), v);
+    if (i % 3 == 0) {
+      const int64_t e = static_cast<int64_t>(rng() % 20000) - 10000;
+      auto it = std::lower_bound(expect.begin(), expect.end(), e);
+      const bool present = it != expect.end() && *it == e;
+      EXPECT_EQ(is.erase(e), present);
+      if (present)
+        expect.erase(it);
+    }
+  }
+  EXPECT_EQ(values(is), expect);
+  is.destroy();
+}
+
+TEST_F(IntersectTest, MatchesStdSetIntersection) {
+  std::mt19937_64 rng(5);
+  struct Case {
+    std::size_t na;
+    std::size_t nb;
+    int wa;
+    int wb;
+    int64_t range;
+  } cases[] = {
+      {1000, 1000, 2, 2, 4000},     // 归并
+      {1000, 1200, 4, 4, 3000},
+      {700, 900, 8, 8, 2000},
+      {50, 5000, 2, 2, 20000},      // 倍增查找
+      {37, 8000, 4, 4, 30000},
+      {20, 3000, 8, 8, 10000},
+      {1000, 1000, 2, 4, 4000},     // 宽度不同
+      {900, 3000, 8, 4, 9000},
+      {3, 5, 4, 4, 10},             // 不足一个向量
+      {0, 100, 4, 4, 1000},
+  };
+  for (IntersectKernel kernel : kKernels) {
+    if (!tinyredis::intersectKernels().force(kernel))
+      continue;
+    SCOPED_TRACE(tinyredis::intersectKernelName(kernel));
+    for (const Case& c : cases) {
+      std::vector<int64_t> va, vb;
+      std::vector<unsigned char> a = makeArray(rng, c.na, c.wa, c.range, &va);
+      std::vector<unsigned char> b = makeArray(rng, c.nb, c.wb, c.range, &vb);
+      std::vector<int64_t> expect;
+      std::set_intersection(va.begin(), va.end(), vb.begin(), vb.end(),
+                            std::back_inserter(expect));
+
+      const IntArray x{a.data(), c.na, c.wa};
+      const IntArray y{b.data(), c.nb, c.wb};
+      const int width = std::min(c.wa, c.wb);
+      std::vector<int64_t> out(std::min(c.na, c.nb) + 1);
+      const std::size_t n = tinyredis::intersect(x, y, out.data(), 0);
+      EXPECT_EQ(decode(out.data(), n, width), expect);
+      EXPECT_EQ(tinyredis::intersect(y, x, nullptr, 0), expect.size());
+
+      // limit 取交集的前若干个
+      if (expect.size() > 2) {
+        const std::size_t limit = expect.size() / 2;
+        EXPECT_EQ(tinyredis::intersect(x, y, out.data(), limit), limit);
+        EXPECT_EQ(decode(out.data(), limit, width),
+                  std::vector<int64_t>(expect.begin(),
+                                       expect.begin() + limit));
+      }
+    }
+  }
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <server/db/listpack.h>
+
+#include <string>
+#include <vector>
+
+using tinyredis::Listpack;
+using tinyredis::Slice;
+
+namespace {
+Slice slice(const std::string& s) {
+  return Slice{s.data(), s.size()};
+}
+
+std::vector<std::string> forward(const Listpack& lp) {
+  std::vector<std::string> out;
+  char buf[Listpack::kIntBufSize];
+  for (std::size_t p = lp.first(); p != Listpack::npos; p = lp.next(p))
+    out.push_back(lp.get(p, buf).toString());
+  return out;
+}
+
+std::vector<std::string> backward(const Listpack& lp) {
+  std::vector<std::string> out;
+  char buf[Listpack::kIntBufSize];
+  for (std::size_t p = lp.last(); p != Listpack::npos; p = lp.prev(p))
+    out.insert(out.begin(), lp.get(p, buf).toString());
+  return out;
+}
+
+// 覆盖每一种整数与字符串编码，以及 1 到 3 字节的反向长度
+std::vector<std::string> samples() {
+  return {"0",
+          "127",
+          "-1",
+          "4095",
+          "-4096",
+          "32767",
+          "-32768",
+          "8388607",
+          "-8388608",
+          "2147483647",
+          "-2147483648",
+          "9223372036854775807",
+          "-9223372036854775808",
+          "",
+          "a",
+          "007",
+          std::string(63, 's'),
+          std::string(64, 'm'),
+          std::string(4095, 'm'),
+          std::string(4096, 'l'),
+          std::string(20000, 'l')};
+}
+}  // namespace
+
+TEST(ListpackTest, RoundTripsAllEncodings) {
+  Listpack lp = Listpack::create();
+  const std::vector<std::string> values = samples();
+  std::size_t expectBytes = Listpack::kHeaderSize + 1;
+  for (const std::string& v : values) {
+    lp.append(slice(v));
+    expectBytes += Listpack::entrySize(slice(v));
+  }
+  EXPECT_EQ(lp.size(), values.size());
+  EXPECT_EQ(lp.bytes(), expectBytes);
+  EXPECT_EQ(forward(lp), values);
+  EXPECT_EQ(backward(lp), values);
+
+  long long v;
+  EXPECT_TRUE(lp.getInteger(lp.first(), &v));
+  EXPECT_EQ(v, 0);
+  EXPECT_FALSE(lp.getInteger(lp.seek(15), &v));  // "007" 按字符串存
+  lp.destroy();
+}
+
+TEST(ListpackTest, SmallIntegersAreCompact) {
+  EXPECT_EQ(Listpack::entrySize(Slice{"7", 1}), 2u);
+  EXPECT_EQ(Listpack::entrySize(Slice{"-100", 4}), 3u);
+  EXPECT_EQ(Listpack::entrySize(Slice{"hello", 5}), 7u);
+}
+
+TEST(ListpackTest, InsertEraseAndReplace) {
+  Listpack lp = Listpack::create();
+  lp.append(Slice{"b", 1});
+  lp.prepend(Slice{"a", 1});
+  lp.append(Slice{"d", 1});
+  lp.insert(lp.seek(-1), Slice{"c", 1});
+  EXPECT_EQ(forward(lp), (std::vector<std::string>{"a", "b", "c", "d"}));
+
+  // 等长原地替换，不等长重新编码
+  lp.replace(lp.seek(1), Slice{"B", 1});
+  lp.replace(lp.seek(2), slice(std::string(100, 'c')));
+  lp.replace(lp.seek(3), Slice{"12345", 5});
+  EXPECT_EQ(forward(lp), (std::vector<std::string>{
+                             "a", "B", std::string(100, 'c'), "12345"}));
+  EXPECT_EQ(backward(lp), forward(lp));
+
+  std::size_t p = lp.erase(lp.seek(1), 2);
+  char buf[Listpack::kIntBufSize];
+  EXPECT_EQ(lp.get(p, buf).toString(), "12345");
+  EXPECT_EQ(forward(lp), (std::vector<std::string>{"a", "12345"}));
+  EXPECT_EQ(lp.erase(lp.seek(1), 10), Listpack::npos);
+  EXPECT_EQ(lp.size(), 1u);
+  lp.erase(lp.first());
+  EXPECT_TRUE(lp.empty());
+  EXPECT_EQ(lp.first(), Listpack::npos);
+  EXPECT_EQ(lp.bytes(), Listpack::kHeaderSize + 1);
+  lp.destroy();
+}
+
+// 插入或替换的内容来自本 listpack 的 get()：缓冲区 realloc 后不能再读原地址
+TEST(ListpackTest, InsertAndReplaceWithOwnContents) {
+  const std::string big(5000, 'x');
+  const std::string mid(300, 'y');
+  Listpack lp = Listpack::create();
+  lp.append(slice(mid));
+  lp.append(slice(big));
+  char buf[Listpack::kIntBufSize];
+  // 来源在插入位置之前与之后各一次
+  lp.prepend(lp.get(lp.seek(-1), buf));
+  lp.append(lp.get(lp.seek(1), buf));
+  EXPECT_EQ(forward(lp), (std::vector<std::string>{big, mid, big, mid}));
+
+  // 不等长替换会先删除再插入
+  lp.replace(lp.first(), lp.get(lp.seek(1), buf));
+  lp.replace(lp.seek(1), lp.get(lp.seek(2), buf));
+  EXPECT_EQ(forward(lp), (std::vector<std::string>{mid, big, big, mid}));
+  EXPECT_EQ(backward(lp), forward(lp));
+  lp.destroy();
+}
+
+TEST(ListpackTest, SeekAndFind) {
+  Listpack lp = Listpack::create();
+  for (int i = 0; i < 10; ++i) {
+    std::string field = "f" + std::to_string(i);
+    lp.append(slice(field));
+    lp.append(slice(std::to_string(i * 100)));
+  }
+  char buf[Listpack::kIntBufSize];
+  EXPECT_EQ(lp.get(lp.seek(0), buf).toString(), "f0");
+  EXPECT_EQ(lp.get(lp.seek(-1), buf).toString(), "900");
+  EXPECT_EQ(lp.seek(20), Listpack::npos);
+  EXPECT_EQ(lp.seek(-21), Listpack::npos);
+
+  // 跳过值只比较字段：值 "f3" 不会被当成字段
+  std::size_t f = lp.find(lp.first(), Slice{"f7", 2}, 1);
+  ASSERT_NE(f, Listpack::npos);
+  EXPECT_EQ(lp.get(lp.next(f), buf).toString(), "700");
+  lp.replace(lp.seek(1), Slice{"f3", 2});
+  f = lp.find(lp.first(), Slice{"f3", 2}, 1);
+  EXPECT_EQ(f, lp.seek(6));
+  EXPECT_EQ(lp.find(lp.first(), Slice{"300", 3}, 1), Listpack::npos);
+  // 整数元素按数值比较
+  EXPECT_EQ(lp.find(lp.first(), Slice{"300", 3}, 0), lp.seek(7));
+  lp.destroy();
+}
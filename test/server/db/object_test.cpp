@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <server/db/object.h>
+#include <server/util/numbers.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+using tinyredis::Object;
+
+namespace {
+std::string valueOf(const Object& o) {
+  char buf[Object::kIntBufSize];
+  return o.stringValue(buf).toString();
+}
+
+Object fromString(const std::string& s) {
+  return Object::fromString(s.data(), s.size());
+}
+}  // namespace
+
+TEST(ObjectTest, ChoosesEncodingByContent) {
+  EXPECT_EQ(fromString("12345").encoding(), Object::Encoding::kInt);
+  EXPECT_EQ(fromString("-9223372036854775808").encoding(),
+            Object::Encoding::kInt);
+  // 不能无损往返的数字按字符串存
+  EXPECT_EQ(fromString("007").encoding(), Object::Encoding::kEmbStr);
+  EXPECT_EQ(fromString("+1").encoding(), Object::Encoding::kEmbStr);
+  EXPECT_EQ(fromString("9223372036854775808").encoding(),
+            Object::Encoding::kEmbStr);
+
+  EXPECT_EQ(fromString(std::string(44, 'a')).encoding(),
+            Object::Encoding::kEmbStr);
+  EXPECT_EQ(fromString(std::string(45, 'a')).encoding(),
+            Object::Encoding::kRaw);
+  EXPECT_EQ(Object().encoding(), Object::Encoding::kEmbStr);
+  EXPECT_STREQ(fromString("1").encodingName(), "int");
+}
+
+TEST(ObjectTest, ValueIsTransparentAcrossEncodings) {
+  Object o = fromString("-42");
+  EXPECT_EQ(valueOf(o), "-42");
+  EXPECT_EQ(o.stringLength(), 3u);
+  long long v = 0;
+  ASSERT_TRUE(o.integerValue(&v));
+  EXPECT_EQ(v, -42);
+
+  // 追加后转为 raw，内容不变
+  o.append("7", 1);
+  EXPECT_EQ(o.encoding(), Object::Encoding::kRaw);
+  EXPECT_EQ(valueOf(o), "-427");
+  ASSERT_TRUE(o.integerValue(&v));
+  EXPECT_EQ(v, -427);
+
+  Object e = fromString("hello");
+  e.setRange(8, "xy", 2);
+  EXPECT_EQ(valueOf(e), std::string("hello\0\0\0xy", 10));
+  e.setRange(0, "J", 1);
+  EXPECT_EQ(valueOf(e), std::string("Jello\0\0\0xy", 10));
+  EXPECT_FALSE(e.integerValue(&v));
+}
+
+TEST(ObjectTest, AppendReservesSpareCapacity) {
+  Object o = fromString(std::string(100, 'a'));
+  EXPECT_EQ(o.encoding(), Object::Encoding::kRaw);
+  o.append("b", 1);
+  const std::size_t bytes = o.allocatedBytes();
+  // 预留之后连续的小追加不再重新分配
+  for (int i = 0; i < 50; ++i)
+    o.append("b", 1);
+  EXPECT_EQ(o.allocatedBytes(), bytes);
+  EXPECT_EQ(o.stringLength(), 151u);
+  EXPECT_EQ(valueOf(o), std::string(100, 'a') + std::string(51, 'b'));
+}
+
+// 共享出去的内容在对象被修改、删除之后保持不变
+TEST(ObjectTest, SharedStringIsCopyOnWrite) {
+  EXPECT_FALSE(fromString("short").shareString());
+  EXPECT_FALSE(Object::fromInteger(42).shareString());
+
+  const std::string orig(100, 'a');
+  Object o = fromString(orig);
+  std::shared_ptr<const char> shared = o.shareString();
+  ASSERT_TRUE(shared);
+  o.append("b", 1);
+  o.setRange(0, "Z", 1);
+  EXPECT_EQ(std::string(shared.get(), orig.size()), orig);
+  EXPECT_EQ(valueOf(o), "Z" + std::string(99, 'a') + "b");
+
+  // 不再共享后恢复原地修改
+  std::shared_ptr<const char> again = o.shareString();
+  again.reset();
+  const std::size_t bytes = o.allocatedBytes();
+  o.append("c", 1);
+  EXPECT_EQ(o.allocatedBytes(), bytes);
+
+  shared = o.shareString();
+  o = Object::fromInteger(1);
+  EXPECT_EQ(std::string(shared.get(), 102),
+            "Z" + std::string(99, 'a') + "bc");
+}
+
+TEST(ObjectTest, MoveTransfersOwnership) {
+  Object a = fromString(std::string(64, 'x'));
+  Object b(std::move(a));
+  EXPECT_EQ(a.stringLength(), 0u);
+  EXPECT_EQ(b.stringLength(), 64u);
+  a = std::move(b);
+  EXPECT_EQ(a.stringLength(), 64u);
+  EXPECT_EQ(b.stringLength(), 0u);
+  b = Object::fromInteger(5);
+  EXPECT_EQ(b.allocatedBytes(), 0u);
+  EXPECT_EQ(sizeof(Object), 16u);
+}
+
+TEST(NumbersTest, ParseLongLongIsStrict) {
+  long long v = 0;
+  EXPECT_TRUE(tinyredis::parseLongLong("0", 1, &v));
+  EXPECT_EQ(v, 0);
+  EXPECT_TRUE(tinyredis::parseLongLong("9223372036854775807", 19, &v));
+  EXPECT_EQ(v, 9223372036854775807LL);
+  EXPECT_TRUE(tinyredis::parseLongLong("-9223372036854775808", 20, &v));
+  EXPECT_EQ(v, -9223372036854775807LL - 1);
+
+  EXPECT_FALSE(tinyredis::parseLongLong("", 0, &v));
+  EXPECT_FALSE(tinyredis::parseLongLong("-", 1, &v));
+  EXPECT_FALSE(tinyredis::parseLongLong("-0", 2, &v));
+  EXPECT_FALSE(tinyredis::parseLongLong("01", 2, &v));
+  EXPECT_FALSE(tinyredis::parseLongLong(" 1", 2, &v));
+  EXPECT_FALSE(tinyredis::parseLongLong("1a", 2, &v));
+  EXPECT_FALSE(tinyredis::parseLongLong("9223372036854775808", 19, &v));
+  EXPECT_FALSE(tinyredis::parseLongLong("99999999999999999999", 20, &v));
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <server/db/quicklist.h>
+
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+using tinyredis::Quicklist;
+using tinyredis::Slice;
+
+namespace {
+Slice slice(const std::string& s) {
+  return Slice{s.data(), s.size()};
+}
+
+std::string itemOf(int i) {
+  return "item:" + std::to_string(i) + ":padding-padding-padding";
+}
+
+std::vector<std::string> all(const Quicklist& l) {
+  std::vector<std::string> out;
+  if (l.size() > 0) {
+    l.range(0, l.size() - 1,
+            [&out](const Slice& v) { out.push_back(v.toString()); });
+  }
+  return out;
+}
+}  // namespace
+
+TEST(QuicklistTest, SplitsIntoNodesByFill) {
+  Quicklist l(4, 0);
+  for (int i = 0; i < 10; ++i)
+    l.push(slice(std::to_string(i)), false);
+  EXPECT_EQ(l.size(), 10u);
+  EXPECT_EQ(l.nodeCount(), 3u);
+  EXPECT_EQ(l.head()->count, 4u);
+  l.push(Slice{"h", 1}, true);
+  EXPECT_EQ(l.nodeCount(), 4u);
+  EXPECT_EQ(all(l), (std::vector<std::string>{"h", "0", "1", "2", "3", "4",
+                                              "5", "6", "7", "8", "9"}));
+}
+
+TEST(QuicklistTest, IndexSkipsWholeNodes) {
+  Quicklist l(-1, 0);
+  std::vector<std::string> expect;
+  for (int i = 0; i < 5000; ++i) {
+    expect.push_back(itemOf(i));
+    l.push(slice(expect.back()), false);
+  }
+  ASSERT_GT(l.nodeCount(), 10u);
+  std::string v;
+  for (int i : {0, 1, 99, 2500, 4998, 4999}) {
+    ASSERT_TRUE(l.index(i, &v));
+    EXPECT_EQ(v, expect[i]);
+  }
+  ASSERT_TRUE(l.index(-1, &v));
+  EXPECT_EQ(v, expect.back());
+  ASSERT_TRUE(l.index(-5000, &v));
+  EXPECT_EQ(v, expect.front());
+  EXPECT_FALSE(l.index(5000, &v));
+  EXPECT_FALSE(l.index(-5001, &v));
+
+  std::vector<std::string> got;
+  l.range(1234, 3456, [&got](const Slice& s) { got.push_back(s.toString()); });
+  EXPECT_EQ(got, std::vector<std::string>(expect.begin() + 1234,
+                                          expect.begin() + 3457));
+}
+
+TEST(QuicklistTest, CompressesInteriorNodes) {
+  Quicklist l(-1, 1);
+  for (int i = 0; i < 20000; ++i)
+    l.push(slice(itemOf(i)), false);
+  const std::size_t nodes = l.nodeCount();
+  ASSERT_GT(nodes, 4u);
+  // 除了两端各一个节点都被压缩
+  EXPECT_EQ(l.compressedNodes(), nodes - 2);
+  EXPECT_EQ(l.head()->lzf, nullptr);
+
+  Quicklist plain(-1, 0);
+  for (int i = 0; i < 20000; ++i)
+    plain.push(slice(itemOf(i)), false);
+  EXPECT_LT(l.allocatedBytes() * 2, plain.allocatedBytes());
+
+  // 读取压缩节点不改变其状态
+  std::string v;
+  ASSERT_TRUE(l.index(10000, &v));
+  EXPECT_EQ(v, itemOf(10000));
+  EXPECT_EQ(l.compressedNodes(), nodes - 2);
+}
+
+TEST(QuicklistTest, PopKeepsEndsUncompressed) {
+  Quicklist l(-1, 2);
+  std::deque<std::string> expect;
+  std::mt19937 rng(3);
+  for (int i = 0; i < 30000; ++i) {
+    const std::string v = itemOf(i);
+    if (rng() % 4 == 0 && !expect.empty()) {
+      const bool head = rng() % 2 == 0;
+      std::string got;
+      ASSERT_TRUE(l.pop(head, &got));
+      EXPECT_EQ(got, head ? expect.front() : expect.back());
+      if (head)
+        expect.pop_front();
+      else
+        expect.pop_back();
+    } else if (rng() % 2 == 0) {
+      l.push(slice(v), true);
+      expect.push_front(v);
+    } else {
+      l.push(slice(v), false);
+      expect.push_back(v);
+    }
+  }
+  ASSERT_EQ(l.size(), expect.size());
+  EXPECT_EQ(all(l), std::vector<std::string>(expect.begin(), expect.end()));
+
+  // 弹空的过程中，两端 depth 个节点始终可以直接读写
+  std::string got;
+  while (l.pop(true, &got)) {
+    EXPECT_EQ(got, expect.front());
+    expect.pop_front();
+    const Quicklist::Node* n = l.head();
+    for (int i = 0; i < 2 && n; ++i, n = n->next)
+      ASSERT_EQ(n->lzf, nullptr);
+  }
+  EXPECT_TRUE(expect.empty());
+  EXPECT_EQ(l.nodeCount(), 0u);
+}
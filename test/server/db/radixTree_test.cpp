@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <server/db/radixTree.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using tinyredis::RadixTree;
+
+namespace {
+using Key = std::string;
+
+// 两个 64 位整数按大端拼成 16 字节的键
+Key makeKey(uint64_t hi, uint64_t lo) {
+  Key k(RadixTree::kKeyLen, '\0');
+  for (int i = 0; i < 8; ++i) {
+    k[i] = static_cast<char>(hi >> (56 - 8 * i));
+    k[8 + i] = static_cast<char>(lo >> (56 - 8 * i));
+  }
+  return k;
+}
+
+const unsigned char* bytes(const Key& k) {
+  return reinterpret_cast<const unsigned char*>(k.data());
+}
+
+void* tag(std::size_t i) {
+  return reinterpret_cast<void*>(i + 1);
+}
+
+Key cursorKey(const RadixTree::Cursor& c) {
+  return Key(reinterpret_cast<const char*>(c.key()), RadixTree::kKeyLen);
+}
+
+// 正向、反向各遍历一次，与 expect 比较
+void expectOrder(const RadixTree& tree, const std::map<Key, void*>& expect) {
+  ASSERT_EQ(tree.size(), expect.size());
+  RadixTree::Cursor c(tree);
+  bool ok = c.first();
+  for (const auto& kv : expect) {
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(cursorKey(c), kv.first);
+    EXPECT_EQ(c.value(), kv.second);
+    ok = c.next();
+  }
+  EXPECT_FALSE(ok);
+  ok = c.last();
+  for (auto it = expect.rbegin(); it != expect.rend(); ++it) {
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(cursorKey(c), it->first);
+    ok = c.prev();
+  }
+  EXPECT_FALSE(ok);
+}
+}  // namespace
+
+TEST(RadixTreeTest, Empty) {
+  RadixTree tree;
+  RadixTree::Cursor c(tree);
+  EXPECT_TRUE(tree.empty());
+  EXPECT_FALSE(c.first());
+  EXPECT_FALSE(c.last());
+  EXPECT_FALSE(c.seekCeil(bytes(makeKey(0, 0))));
+  EXPECT_EQ(tree.find(bytes(makeKey(1, 2))), nullptr);
+  EXPECT_FALSE(tree.erase(bytes(makeKey(1, 2))));
+  EXPECT_EQ(tree.nodeBytes(), 0u);
+}
+
+TEST(RadixTreeTest, InsertFindErase) {
+  RadixTree tree;
+  const Key a = makeKey(1000, 0), b = makeKey(1000, 1), c = makeKey(2000, 0);
+  EXPECT_TRUE(tree.insert(bytes(a), tag(0)));
+  EXPECT_TRUE(tree.insert(bytes(b), tag(1)));
+  EXPECT_TRUE(tree.insert(bytes(c), tag(2)));
+  EXPECT_FALSE(tree.insert(bytes(b), tag(9)));
+  EXPECT_EQ(tree.size(), 3u);
+
+  void** v = tree.find(bytes(b));
+  ASSERT_NE(v, nullptr);
+  EXPECT_EQ(*v, tag(1));
+  *v = tag(7);
+  EXPECT_EQ(*tree.find(bytes(b)), tag(7));
+  EXPECT_EQ(tree.find(bytes(makeKey(1000, 2))), nullptr);
+
+  void* old = nullptr;
+  EXPECT_TRUE(tree.erase(bytes(a), &old));
+  EXPECT_EQ(old, tag(0));
+  EXPECT_FALSE(tree.erase(bytes(a)));
+  EXPECT_EQ(tree.find(bytes(a)), nullptr);
+  EXPECT_EQ(*tree.find(bytes(b)), tag(7));
+  EXPECT_EQ(*tree.find(bytes(c)), tag(2));
+
+  EXPECT_TRUE(tree.erase(bytes(b)));
+  EXPECT_TRUE(tree.erase(bytes(c)));
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.nodeBytes(), 0u);
+}
+
+TEST(RadixTreeTest, Seek) {
+  RadixTree tree;
+  for (uint64_t ms = 10; ms <= 50; ms += 10)
+    tree.insert(bytes(makeKey(ms, 0)), tag(ms));
+  RadixTree::Cursor c(tree);
+
+  ASSERT_TRUE(c.seekCeil(bytes(makeKey(20, 0))));
+  EXPECT_EQ(cursorKey(c), makeKey(20, 0));
+  ASSERT_TRUE(c.seekCeil(bytes(makeKey(20, 1))));
+  EXPECT_EQ(cursorKey(c), makeKey(30, 0));
+  ASSERT_TRUE(c.seekCeil(bytes(makeKey(0, 5))));
+  EXPECT_EQ(cursorKey(c), makeKey(10, 0));
+  EXPECT_FALSE(c.seekCeil(bytes(makeKey(50, 1))));
+
+  ASSERT_TRUE(c.seekFloor(bytes(makeKey(30, 0))));
+  EXPECT_EQ(cursorKey(c), makeKey(30, 0));
+  ASSERT_TRUE(c.seekFloor(bytes(makeKey(29, ~0ull))));
+  EXPECT_EQ(cursorKey(c), makeKey(20, 0));
+  ASSERT_TRUE(c.seekFloor(bytes(makeKey(~0ull, ~0ull))));
+  EXPECT_EQ(cursorKey(c), makeKey(50, 0));
+  EXPECT_FALSE(c.seekFloor(bytes(makeKey(9, 0))));
+
+  // 定位后可以继续前后移动
+  ASSERT_TRUE(c.seekCeil(bytes(makeKey(25, 0))));
+  ASSERT_TRUE(c.prev());
+  EXPECT_EQ(cursorKey(c), makeKey(20, 0));
+  ASSERT_TRUE(c.next());
+  ASSERT_TRUE(c.next());
+  EXPECT_EQ(cursorKey(c), makeKey(40, 0));
+}
+
+// 随机插入删除与 std::map 对照，包括随机的 ceil/floor 定位
+TEST(RadixTreeTest, RandomAgainstMap) {
+  std::mt19937_64 rng(24);
+  RadixTree tree;
+  std::map<Key, void*> expect;
+  for (int round = 0; round < 20000; ++round) {
+    // 键集中在少数前缀上，使节点既有分裂也有合并
+    const Key k = makeKey(rng() % 64 * 1000 + rng() % 3, rng() % 300);
+    if (rng() % 3 != 0) {
+      const bool fresh = expect.find(k) == expect.end();
+      EXPECT_EQ(tree.insert(bytes(k), tag(round)), fresh);
+      if (fresh)
+        expect[k] = tag(round);
+    } else {
+      void* old = nullptr;
+      auto it = expect.find(k);
+      ASSERT_EQ(tree.erase(bytes(k), &old), it != expect.end());
+      if (it != expect.end()) {
+        EXPECT_EQ(old, it->second);
+        expect.erase(it);
+      }
+    }
+  }
+  expectOrder(tree, expect);
+
+  RadixTree::Cursor c(tree);
+  for (int i = 0; i < 2000; ++i) {
+    const Key k = makeKey(rng() % 66 * 1000 + rng() % 3, rng() % 300);
+    auto ceil = expect.lower_bound(k);
+    ASSERT_EQ(c.seekCeil(bytes(k)), ceil != expect.end());
+    if (ceil != expect.end()) {
+      EXPECT_EQ(cursorKey(c), ceil->first);
+    }
+    auto floor = expect.upper_bound(k);
+    ASSERT_EQ(c.seekFloor(bytes(k)), floor != expect.begin());
+    if (floor != expect.begin()) {
+      EXPECT_EQ(cursorKey(c), (--floor)->first);
+    }
+  }
+
+  for (auto& kv : expect)
+    ASSERT_TRUE(tree.erase(bytes(kv.first)));
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.nodeBytes(), 0u);
+}
+
+// 256 个分叉的节点
+TEST(RadixTreeTest, FullFanout) {
+  RadixTree tree;
+  std::map<Key, void*> expect;
+  for (uint64_t i = 0; i < 256; ++i) {
+    for (uint64_t j = 0; j < 4; ++j) {
+      const Key k = makeKey(i << 56, j);
+      tree.insert(bytes(k), tag(i * 4 + j));
+      expect[k] = tag(i * 4 + j);
+    }
+  }
+  expectOrder(tree, expect);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <server/db/skiplist.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using tinyredis::SkipList;
+using tinyredis::Slice;
+
+namespace {
+Slice slice(const std::string& s) {
+  return Slice{s.data(), s.size()};
+}
+
+std::vector<std::string> members(const SkipList& zsl) {
+  std::vector<std::string> out;
+  for (const SkipList::Node* n = zsl.first(); n; n = SkipList::next(n))
+    out.push_back(n->member);
+  return out;
+}
+}  // namespace
+
+TEST(SkipListTest, OrdersByScoreThenMember) {
+  SkipList zsl;
+  zsl.insert(2, Slice{"b", 1});
+  zsl.insert(1, Slice{"z", 1});
+  zsl.insert(2, Slice{"a", 1});
+  zsl.insert(-1, Slice{"m", 1});
+  EXPECT_EQ(members(zsl), (std::vector<std::string>{"m", "z", "a", "b"}));
+  EXPECT_EQ(zsl.last()->member, "b");
+  EXPECT_EQ(SkipList::prev(zsl.last())->member, "a");
+  EXPECT_EQ(zsl.rank(2, Slice{"a", 1}), 2u);
+  EXPECT_EQ(zsl.rank(2, Slice{"c", 1}), SkipList::npos);
+  EXPECT_EQ(zsl.byRank(3)->member, "b");
+  EXPECT_EQ(zsl.byRank(4), nullptr);
+}
+
+TEST(SkipListTest, RankMatchesSortedOrder) {
+  SkipList zsl;
+  std::vector<std::pair<double, std::string>> expect;
+  std::mt19937 rng(7);
+  for (int i = 0; i < 2000; ++i) {
+    const double score = static_cast<double>(rng() % 500);
+    std::string member = "m" + std::to_string(i);
+    zsl.insert(score, slice(member));
+    expect.emplace_back(score, member);
+  }
+  // 删除一半，覆盖 span 的维护
+  for (int i = 0; i < 2000; i += 2) {
+    ASSERT_TRUE(zsl.erase(expect[i].first, slice(expect[i].second)));
+  }
+  std::vector<std::pair<double, std::string>> left;
+  for (int i = 1; i < 2000; i += 2)
+    left.push_back(expect[i]);
+  std::sort(left.begin(), left.end());
+
+  ASSERT_EQ(zsl.size(), left.size());
+  for (std::size_t i = 0; i < left.size(); ++i) {
+    EXPECT_EQ(zsl.rank(left[i].first, slice(left[i].second)), i);
+    const SkipList::Node* n = zsl.byRank(i);
+    ASSERT_NE(n, nullptr);
+    EXPECT_EQ(n->member, left[i].second);
+  }
+  EXPECT_FALSE(zsl.erase(left[0].first + 1, slice(left[0].second)));
+}
+
+TEST(SkipListTest, UpdateScoreMovesNode) {
+  SkipList zsl;
+  for (int i = 0; i < 10; ++i) {
+    std::string m = "m" + std::to_string(i);
+    zsl.insert(i, slice(m));
+  }
+  // 位置不变时原地修改
+  const SkipList::Node* n = zsl.byRank(5);
+  EXPECT_EQ(zsl.updateScore(5, Slice{"m5", 2}, 5.5), n);
+  EXPECT_EQ(zsl.rank(5.5, Slice{"m5", 2}), 5u);
+
+  zsl.updateScore(5.5, Slice{"m5", 2}, 100);
+  EXPECT_EQ(zsl.last()->member, "m5");
+  zsl.updateScore(0, Slice{"m0", 2}, 50);
+  EXPECT_EQ(zsl.first()->member, "m1");
+  EXPECT_EQ(zsl.rank(50, Slice{"m0", 2}), 8u);
+  EXPECT_EQ(zsl.size(), 10u);
+}
@@ -0,0 +1,377 @@
+#include <gtest/gtest.h>
+#include <server/db/stream.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using tinyredis::Slice;
+using tinyredis::Stream;
+using tinyredis::StreamConsumer;
+using tinyredis::StreamGroup;
+using tinyredis::StreamId;
+using tinyredis::StreamNack;
+using tinyredis::StreamWaiter;
+
+namespace {
+using Fields = std::vector<std::pair<std::string, std::string>>;
+
+struct Entry {
+  StreamId id;
+  Fields fields;
+};
+
+void append(Stream& s, const Entry& e, std::size_t maxBytes = 4096,
+            std::size_t maxEntries = 100) {
+  std::vector<Slice> args;
+  for (const auto& kv : e.fields) {
+    args.push_back(Slice{kv.first.data(), kv.first.size()});
+    args.push_back(Slice{kv.second.data(), kv.second.size()});
+  }
+  s.append(e.id, args.data(), e.fields.size(), maxBytes, maxEntries);
+}
+
+// 按范围读出全部条目
+std::vector<Entry> range(const Stream& s, const StreamId& start,
+                         const StreamId& end, bool rev) {
+  std::vector<Entry> out;
+  Stream::Iterator it(s, start, end, rev);
+  StreamId id;
+  while (it.next(&id)) {
+    Entry e{id, {}};
+    it.forEachField([&](const Slice& f, const Slice& v) {
+      e.fields.emplace_back(f.toString(), v.toString());
+    });
+    EXPECT_EQ(e.fields.size(), it.numFields());
+    out.push_back(std::move(e));
+  }
+  return out;
+}
+
+// 与 expect 中落在范围内的条目逐个比较
+void expectRange(const Stream& s, const std::vector<Entry>& expect,
+                 const StreamId& start, const StreamId& end) {
+  std::vector<Entry> want;
+  for (const Entry& e : expect) {
+    if (e.id >= start && e.id <= end)
+      want.push_back(e);
+  }
+  const std::vector<Entry> fwd = range(s, start, end, false);
+  ASSERT_EQ(fwd.size(), want.size());
+  for (std::size_t i = 0; i < want.size(); ++i) {
+    EXPECT_EQ(fwd[i].id, want[i].id);
+    EXPECT_EQ(fwd[i].fields, want[i].fields);
+  }
+  const std::vector<Entry> rev = range(s, start, end, true);
+  ASSERT_EQ(rev.size(), want.size());
+  for (std::size_t i = 0; i < want.size(); ++i)
+    EXPECT_EQ(rev[i].id, want[want.size() - 1 - i].id);
+}
+
+// 记录被唤醒的次数；closed 时拒绝唤醒，模拟已关闭的连接
+class CountingWaiter : public StreamWaiter {
+ public:
+  int wakes = 0;
+  bool closed = false;
+
+ private:
+  bool _OnWake() override {
+    if (closed)
+      return false;
+    ++wakes;
+    return true;
+  }
+};
+}  // namespace
+
+TEST(StreamTest, IdEncodingKeepsOrder) {
+  const StreamId ids[] = {{0, 0},   {0, 1},       {0, UINT64_MAX}, {1, 0},
+                          {256, 3}, {1ull << 40, 0}, StreamId::max()};
+  unsigned char prev[16], cur[16];
+  for (std::size_t i = 0; i < sizeof(ids) / sizeof(ids[0]); ++i) {
+    ids[i].encode(cur);
+    EXPECT_EQ(StreamId::decode(cur), ids[i]);
+    if (i > 0) {
+      EXPECT_LT(std::memcmp(prev, cur, 16), 0);
+    }
+    std::memcpy(prev, cur, 16);
+  }
+}
+
+TEST(StreamTest, NextId) {
+  Stream s;
+  StreamId id;
+  ASSERT_TRUE(s.nextId(1000, &id));
+  EXPECT_EQ(id, (StreamId{1000, 0}));
+  append(s, Entry{{1000, 5}, {{"f", "v"}}});
+  // 时钟回拨时沿用最后一个 ID 的时间戳
+  ASSERT_TRUE(s.nextId(999, &id));
+  EXPECT_EQ(id, (StreamId{1000, 6}));
+  ASSERT_TRUE(s.nextId(1001, &id));
+  EXPECT_EQ(id, (StreamId{1001, 0}));
+}
+
+TEST(StreamTest, AppendAndRange) {
+  Stream s;
+  std::vector<Entry> expect;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    Entry e{{1000 + i / 3, i % 3}, {}};
+    e.fields.emplace_back("sensor", std::to_string(i % 7));
+    e.fields.emplace_back("value", "v" + std::to_string(i));
+    // 部分条目的字段与 master 不同
+    if (i % 10 == 0)
+      e.fields.emplace_back("extra", std::string(i % 50, 'x'));
+    append(s, e);
+    expect.push_back(e);
+  }
+  EXPECT_EQ(s.size(), 1000u);
+  EXPECT_EQ(s.lastId(), (StreamId{1333, 0}));
+  EXPECT_GT(s.nodeCount(), 1u);
+
+  expectRange(s, expect, StreamId::min(), StreamId::max());
+  expectRange(s, expect, StreamId{1100, 1}, StreamId{1200, 0});
+  expectRange(s, expect, StreamId{1100, 2}, StreamId{1100, 2});
+  expectRange(s, expect, StreamId{0, 0}, StreamId{999, 0});
+  expectRange(s, expect, StreamId{2000, 0}, StreamId::max());
+  EXPECT_TRUE(range(s, StreamId{1200, 0}, StreamId{1100, 0}, false).empty());
+}
+
+TEST(StreamTest, NodeLimits) {
+  Stream byEntries;
+  for (uint64_t i = 1; i <= 100; ++i)
+    append(byEntries, Entry{{i, 0}, {{"k", "v"}}}, 0, 10);
+  EXPECT_EQ(byEntries.nodeCount(), 10u);
+
+  Stream byBytes;
+  const std::string big(1000, 'x');
+  for (uint64_t i = 1; i <= 10; ++i)
+    append(byBytes, Entry{{i, 0}, {{"k", big}}}, 4096, 0);
+  EXPECT_GE(byBytes.nodeCount(), 3u);
+  EXPECT_LE(byBytes.nodeCount(), 5u);
+}
+
+// 差值编码的 ID 在 seq 比 master 小、差值超出有符号范围时仍能还原
+TEST(StreamTest, DeltaWraparound) {
+  Stream s;
+  std::vector<Entry> expect = {
+      {{5, UINT64_MAX - 1}, {{"a", "1"}}},
+      {{6, 0}, {{"a", "2"}}},
+      {{UINT64_MAX - 1, 3}, {{"a", "3"}}},
+      {StreamId::max(), {{"a", "4"}}},
+  };
+  for (const Entry& e : expect)
+    append(s, e);
+  EXPECT_EQ(s.nodeCount(), 1u);
+  expectRange(s, expect, StreamId::min(), StreamId::max());
+}
+
+TEST(StreamTest, TrimMaxLen) {
+  Stream s;
+  std::vector<Entry> expect;
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    expect.push_back(Entry{{i, 0}, {{"n", std::to_string(i)}}});
+    append(s, expect.back());
+  }
+  Stream::TrimArgs args{Stream::TrimStrategy::kMaxLen, true, 550,
+                        StreamId{0, 0}, 0};
+  // 近似裁剪只删除整个节点，留下的条目不少于 maxLen
+  EXPECT_EQ(s.trim(args), 400u);
+  EXPECT_EQ(s.size(), 600u);
+  EXPECT_EQ(s.nodeCount(), 6u);
+
+  // 有 LIMIT 时一次最多删除 limit 个条目
+  args.maxLen = 0;
+  args.limit = 250;
+  EXPECT_EQ(s.trim(args), 200u);
+  EXPECT_EQ(s.size(), 400u);
+
+  // 精确裁剪在第一个节点里打删除标记
+  args.approx = false;
+  args.limit = 0;
+  args.maxLen = 333;
+  EXPECT_EQ(s.trim(args), 67u);
+  EXPECT_EQ(s.size(), 333u);
+  expect.erase(expect.begin(), expect.end() - 333);
+  expectRange(s, expect, StreamId::min(), StreamId::max());
+  expectRange(s, expect, StreamId{650, 0}, StreamId{720, 0});
+
+  // 删空之后仍然可以追加，ID 继续递增
+  args.maxLen = 0;
+  EXPECT_EQ(s.trim(args), 333u);
+  EXPECT_EQ(s.size(), 0u);
+  EXPECT_EQ(s.nodeCount(), 0u);
+  EXPECT_EQ(s.lastId(), (StreamId{1000, 0}));
+  append(s, Entry{{1001, 0}, {{"n", "x"}}});
+  EXPECT_EQ(range(s, StreamId::min(), StreamId::max(), false).size(), 1u);
+}
+
+TEST(StreamTest, TrimMinId) {
+  Stream s;
+  std::vector<Entry> expect;
+  for (uint64_t i = 1; i <= 500; ++i) {
+    expect.push_back(Entry{{i * 10, 0}, {{"n", std::to_string(i)}}});
+    append(s, expect.back());
+  }
+  Stream::TrimArgs args{Stream::TrimStrategy::kMinId, true, 0,
+                        StreamId{2055, 0}, 0};
+  EXPECT_EQ(s.trim(args), 200u);
+  args.approx = false;
+  EXPECT_EQ(s.trim(args), 5u);
+  EXPECT_EQ(s.size(), 295u);
+  expect.erase(expect.begin(), expect.begin() + 205);
+  expectRange(s, expect, StreamId::min(), StreamId::max());
+  // 已经满足时不再删除
+  EXPECT_EQ(s.trim(args), 0u);
+}
+
+// 随机追加、裁剪后与记录的条目对照
+TEST(StreamTest, RandomAgainstVector) {
+  std::mt19937_64 rng(24);
+  Stream s;
+  std::vector<Entry> expect;
+  StreamId last{0, 0};
+  for (int round = 0; round < 3000; ++round) {
+    const uint64_t gap = rng() % 4;
+    last = gap == 0 ? StreamId{last.ms, last.seq + 1}
+                    : StreamId{last.ms + gap, rng() % 3};
+    Entry e{last, {}};
+    const int n = 1 + static_cast<int>(rng() % 3);
+    for (int i = 0; i < n; ++i)
+      e.fields.emplace_back("f" + std::to_string(rng() % 2 + i),
+                            std::to_string(rng() % 100000));
+    append(s, e, 512, 20);
+    expect.push_back(e);
+    if (rng() % 200 == 0) {
+      const std::size_t keep = expect.size() * (rng() % 100) / 100;
+      Stream::TrimArgs args{Stream::TrimStrategy::kMaxLen, false,
+                            static_cast<long long>(keep), StreamId{0, 0}, 0};
+      EXPECT_EQ(s.trim(args), expect.size() - keep);
+      expect.erase(expect.begin(), expect.end() - keep);
+    }
+  }
+  ASSERT_EQ(s.size(), expect.size());
+  expectRange(s, expect, StreamId::min(), StreamId::max());
+  for (int i = 0; i < 50 && !expect.empty(); ++i) {
+    StreamId a = expect[rng() % expect.size()].id;
+    StreamId b = expect[rng() % expect.size()].id;
+    if (b < a)
+      std::swap(a, b);
+    expectRange(s, expect, a, b);
+  }
+}
+
+TEST(StreamGroupTest, PelIndexedByIdAndConsumer) {
+  StreamGroup g(StreamId::min());
+  bool created;
+  StreamConsumer* a = g.createConsumer("a", &created);
+  EXPECT_TRUE(created);
+  EXPECT_EQ(a, g.createConsumer("a", &created));
+  EXPECT_FALSE(created);
+  StreamConsumer* b = g.createConsumer("b", &created);
+
+  for (uint64_t i = 1; i <= 10; ++i)
+    g.deliver(StreamId{i, 0}, i % 2 ? a : b, 1000);
+  EXPECT_EQ(10u, g.pel().size());
+  EXPECT_EQ(5u, a->pel.size());
+  EXPECT_EQ(5u, b->pel.size());
+
+  // 重新投递给另一个消费者：转移并增加投递次数
+  StreamNack* n = g.deliver(StreamId{1, 0}, b, 2000);
+  EXPECT_EQ(b, n->consumer);
+  EXPECT_EQ(2u, n->deliveryCount);
+  EXPECT_EQ(2000u, n->deliveryTime);
+  EXPECT_EQ(4u, a->pel.size());
+  EXPECT_EQ(6u, b->pel.size());
+
+  // 认领只改归属
+  g.assign(StreamId{2, 0}, g.nack(StreamId{2, 0}), a);
+  EXPECT_EQ(a, g.nack(StreamId{2, 0})->consumer);
+  EXPECT_EQ(1u, g.nack(StreamId{2, 0})->deliveryCount);
+  EXPECT_EQ(5u, a->pel.size());
+
+  EXPECT_TRUE(g.ack(StreamId{2, 0}));
+  EXPECT_FALSE(g.ack(StreamId{2, 0}));
+  EXPECT_EQ(nullptr, g.nack(StreamId{2, 0}));
+  EXPECT_EQ(4u, a->pel.size());
+  EXPECT_EQ(9u, g.pel().size());
+
+  EXPECT_EQ(4, g.deleteConsumer("a"));
+  EXPECT_EQ(-1, g.deleteConsumer("a"));
+  EXPECT_EQ(5u, g.pel().size());
+  EXPECT_EQ(1u, g.consumers().size());
+}
+
+TEST(StreamGroupTest, CreateAndDestroyGroups) {
+  Stream s;
+  append(s, Entry{StreamId{1, 0}, {{"f", "v"}}});
+  StreamGroup* g = s.createGroup("g", s.lastId());
+  ASSERT_NE(nullptr, g);
+  EXPECT_EQ(nullptr, s.createGroup("g", StreamId::min()));
+  EXPECT_EQ(g, s.group("g"));
+  EXPECT_EQ(StreamId({1, 0}), g->lastId());
+  EXPECT_TRUE(s.contains(StreamId{1, 0}));
+  EXPECT_FALSE(s.contains(StreamId{1, 1}));
+
+  CountingWaiter w;
+  w.waitOn(g);
+  EXPECT_TRUE(s.destroyGroup("g"));
+  EXPECT_FALSE(s.destroyGroup("g"));
+  EXPECT_EQ(1, w.wakes);
+  EXPECT_FALSE(w.waiting());
+}
+
+TEST(StreamGroupTest, SignalWakesOneWaiterPerGroup) {
+  Stream s;
+  StreamGroup* g1 = s.createGroup("g1", StreamId::min());
+  StreamGroup* g2 = s.createGroup("g2", StreamId::min());
+  std::vector<CountingWaiter> waiters(4);
+  // 0、1 等 g1；2 同时等 g1 和 g2；3 等 g2
+  waiters[0].waitOn(g1);
+  waiters[1].waitOn(g1);
+  waiters[2].waitOn(g1);
+  waiters[2].waitOn(g2);
+  waiters[3].waitOn(g2);
+
+  // 没有新条目时不唤醒
+  s.signalWaiters();
+  for (const auto& w : waiters)
+    EXPECT_EQ(0, w.wakes);
+
+  append(s, Entry{StreamId{1, 0}, {{"f", "v"}}});
+  s.signalWaiters();
+  EXPECT_EQ(1, waiters[0].wakes);
+  EXPECT_EQ(0, waiters[1].wakes);
+  EXPECT_EQ(1, waiters[2].wakes);  // g2 的队首
+  EXPECT_EQ(0, waiters[3].wakes);
+  // 被唤醒的等待者离开了所有队列
+  EXPECT_FALSE(waiters[2].waiting());
+  EXPECT_TRUE(waiters[1].waiting());
+
+  // 组已读到最后一个 ID 后不再唤醒
+  g2->setLastId(s.lastId());
+  waiters[1].closed = true;
+  append(s, Entry{StreamId{2, 0}, {{"f", "v"}}});
+  g2->setLastId(s.lastId());
+  s.signalWaiters();
+  EXPECT_EQ(0, waiters[1].wakes);  // 已关闭，由下一个接替
+  EXPECT_FALSE(waiters[1].waiting());
+  EXPECT_EQ(0, waiters[3].wakes);
+  EXPECT_TRUE(waiters[3].waiting());
+  waiters[3].cancelWait();
+  EXPECT_FALSE(g1->hasWaiters());
+  EXPECT_FALSE(g2->hasWaiters());
+}
+
+TEST(StreamGroupTest, StreamDestructorWakesWaiters) {
+  CountingWaiter w;
+  {
+    Stream s;
+    w.waitOn(s.createGroup("a", StreamId::min()));
+    w.waitOn(s.createGroup("b", StreamId::min()));
+  }
+  EXPECT_EQ(1, w.wakes);
+  EXPECT_FALSE(w.waiting());
+}
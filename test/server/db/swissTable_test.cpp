@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <server/db/database.h>
+#include <server/db/swissTable.h>
+
+#include <cstdint>
+#include <set>
+#include <string>
+
+using tinyredis::SwissTable;
+
+namespace {
+using IntTable = SwissTable<uint64_t, uint64_t>;
+using StringTable = SwissTable<std::string, std::string, tinyredis::KeyHash,
+                               tinyredis::KeyEqual>;
+}  // namespace
+
+TEST(SwissTableTest, SetFindEraseAcrossGrowth) {
+  IntTable t;
+  const uint64_t n = 10000;
+  for (uint64_t i = 0; i < n; ++i) {
+    EXPECT_TRUE(t.set(i, i * 2));
+    if (i % 97 == 0) {
+      for (uint64_t j = 0; j <= i; j += 13)
+        ASSERT_NE(t.find(j), nullptr) << i << " " << j;
+    }
+  }
+  EXPECT_EQ(t.size(), n);
+  // 装载因子不超过 7/8
+  EXPECT_LE(t.size() * 8, t.bucketCount() * 7);
+  EXPECT_FALSE(t.set(uint64_t(5), uint64_t(7)));
+  EXPECT_EQ(*t.find(uint64_t(5)), 7u);
+
+  for (uint64_t i = 0; i < n; i += 2)
+    EXPECT_TRUE(t.erase(i));
+  EXPECT_FALSE(t.erase(uint64_t(0)));
+  EXPECT_EQ(t.size(), n / 2);
+  for (uint64_t i = 0; i < n; ++i)
+    EXPECT_EQ(t.find(i) != nullptr, i % 2 == 1) << i;
+}
+
+TEST(SwissTableTest, TombstonesAreReclaimed) {
+  IntTable t;
+  t.reserve(1000);
+  const std::size_t capacity = t.bucketCount();
+  for (uint64_t i = 0; i < 1000; ++i)
+    t.set(i, i);
+
+  // 反复删旧插新，大小不变：墓碑被复用或在原地重建时清除，表不应增长
+  for (uint64_t i = 1000; i < 200000; ++i) {
+    ASSERT_TRUE(t.erase(i - 1000));
+    ASSERT_TRUE(t.set(i, i));
+  }
+  EXPECT_EQ(t.size(), 1000u);
+  EXPECT_EQ(t.bucketCount(), capacity);
+  for (uint64_t i = 199000; i < 200000; ++i)
+    ASSERT_NE(t.find(i), nullptr) << i;
+  EXPECT_EQ(t.find(uint64_t(0)), nullptr);
+}
+
+TEST(SwissTableTest, ShrinksWhenSparse) {
+  IntTable t;
+  for (uint64_t i = 0; i < 4096; ++i)
+    t.set(i, i);
+  const std::size_t before = t.bucketCount();
+  for (uint64_t i = 0; i < 4000; ++i)
+    t.erase(i);
+  EXPECT_LE(t.bucketCount(), before / 8);
+  for (uint64_t i = 4000; i < 4096; ++i)
+    ASSERT_NE(t.find(i), nullptr);
+}
+
+TEST(SwissTableTest, ScanSurvivesGrowth) {
+  IntTable t;
+  for (uint64_t i = 0; i < 500; ++i)
+    t.set(i, i);
+
+  // 遍历期间不断插入导致重建，开始时就存在的键仍然至少返回一次
+  std::set<uint64_t> seen;
+  uint64_t next = 500;
+  uint64_t cursor = 0;
+  int calls = 0;
+  do {
+    cursor = t.scan(cursor, [&seen](const IntTable::Entry& e) {
+      seen.insert(e.key);
+    });
+    if (++calls <= 100) {
+      for (int k = 0; k < 50; ++k, ++next)
+        t.set(next, next);
+    }
+  } while (cursor != 0);
+  for (uint64_t i = 0; i < 500; ++i)
+    EXPECT_TRUE(seen.count(i)) << i;
+}
+
+TEST(SwissTableTest, IteratorAllowsDeletingCurrent) {
+  IntTable t;
+  for (uint64_t i = 0; i < 1000; ++i)
+    t.set(i, i);
+  const std::size_t capacity = t.bucketCount();
+
+  std::set<uint64_t> seen;
+  {
+    IntTable::Iterator it(&t);
+    while (IntTable::Entry* e = it.next()) {
+      seen.insert(e->key);
+      if (e->key % 10 != 0)
+        t.erase(e->key);
+    }
+    // 迭代器存活期间删到很稀疏也不缩容
+    EXPECT_EQ(t.bucketCount(), capacity);
+  }
+  EXPECT_EQ(seen.size(), 1000u);
+  EXPECT_EQ(t.size(), 100u);
+  EXPECT_TRUE(t.shrinkIfNeeded());
+  EXPECT_LT(t.bucketCount(), capacity);
+  for (uint64_t i = 0; i < 1000; i += 10)
+    ASSERT_NE(t.find(i), nullptr);
+}
+
+TEST(SwissTableTest, OwnsNonTrivialValues) {
+  StringTable t;
+  for (int i = 0; i < 1000; ++i)
+    t.set(std::string("key:") + std::to_string(i), std::string(100, 'v'));
+  for (int i = 0; i < 1000; i += 3)
+    EXPECT_TRUE(t.erase(std::string("key:") + std::to_string(i)));
+
+  // 以 Slice 查找，不构造 std::string
+  const char raw[] = "key:7";
+  tinyredis::Slice key{raw, sizeof(raw) - 1};
+  ASSERT_NE(t.find(key), nullptr);
+  EXPECT_EQ(t.find(key)->size(), 100u);
+  EXPECT_EQ(t.find(tinyredis::Slice{"key:9", 5}), nullptr);
+  t.clear();
+  EXPECT_TRUE(t.empty());
+  EXPECT_EQ(t.bucketCount(), 0u);
+}
@@ -0,0 +1,287 @@
+#include <gtest/gtest.h>
+#include <server/db/hashType.h>
+#include <server/db/listType.h>
+#include <server/db/setType.h>
+#include <server/db/zsetType.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+using tinyredis::EncodingConfig;
+using tinyredis::Listpack;
+using tinyredis::Object;
+using tinyredis::Slice;
+namespace hashType = tinyredis::hashType;
+namespace listType = tinyredis::listType;
+namespace setType = tinyredis::setType;
+namespace zsetType = tinyredis::zsetType;
+
+namespace {
+Slice slice(const std::string& s) {
+  return Slice{s.data(), s.size()};
+}
+
+std::string hget(Object& o, const std::string& field) {
+  char buf[Listpack::kIntBufSize];
+  Slice v;
+  if (!hashType::get(o, slice(field), buf, &v))
+    return "(nil)";
+  return v.toString();
+}
+
+std::vector<std::string> smembers(Object& o) {
+  std::vector<std::string> out;
+  setType::forEach(o, [&out](const Slice& m) { out.push_back(m.toString()); });
+  return out;
+}
+
+std::vector<std::string> lrange(Object& o) {
+  std::vector<std::string> out;
+  if (listType::size(o) > 0) {
+    listType::range(o, 0, listType::size(o) - 1,
+                    [&out](const Slice& v) { out.push_back(v.toString()); });
+  }
+  return out;
+}
+
+std::vector<std::pair<std::string, double>> zrange(Object& o) {
+  std::vector<std::pair<std::string, double>> out;
+  if (zsetType::size(o) > 0) {
+    zsetType::range(o, 0, zsetType::size(o) - 1,
+                    [&out](const Slice& m, double s) {
+                      out.emplace_back(m.toString(), s);
+                    });
+  }
+  return out;
+}
+}  // namespace
+
+TEST(HashTypeTest, ConvertsAtEntryThreshold) {
+  EncodingConfig cfg;
+  cfg.hashMaxListpackEntries = 4;
+  Object o = hashType::create();
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(hashType::set(o, slice("f" + std::to_string(i)),
+                              slice(std::to_string(i)), cfg));
+  }
+  EXPECT_FALSE(hashType::set(o, Slice{"f0", 2}, Slice{"zero", 4}, cfg));
+  EXPECT_EQ(o.encoding(), Object::Encoding::kListpack);
+  EXPECT_STREQ(o.typeName(), "hash");
+
+  EXPECT_TRUE(hashType::set(o, Slice{"f4", 2}, Slice{"4", 1}, cfg));
+  EXPECT_EQ(o.encoding(), Object::Encoding::kHashTable);
+  EXPECT_STREQ(o.encodingName(), "hashtable");
+  EXPECT_EQ(hashType::size(o), 5u);
+  EXPECT_EQ(hget(o, "f0"), "zero");
+  EXPECT_EQ(hget(o, "f3"), "3");
+  EXPECT_TRUE(hashType::erase(o, Slice{"f3", 2}));
+  EXPECT_EQ(hget(o, "f3"), "(nil)");
+  EXPECT_GT(o.allocatedBytes(), 0u);
+}
+
+TEST(HashTypeTest, ConvertsOnLongValue) {
+  EncodingConfig cfg;
+  Object o = hashType::create();
+  hashType::set(o, Slice{"a", 1}, slice(std::string(64, 'v')), cfg);
+  EXPECT_EQ(o.encoding(), Object::Encoding::kListpack);
+  hashType::set(o, Slice{"b", 1}, slice(std::string(65, 'v')), cfg);
+  EXPECT_EQ(o.encoding(), Object::Encoding::kHashTable);
+  EXPECT_EQ(hget(o, "a"), std::string(64, 'v'));
+}
+
+TEST(SetTypeTest, ConvertsAtThresholds) {
+  EncodingConfig cfg;
+  cfg.setMaxListpackEntries = 3;
+  Object o = setType::create();
+  EXPECT_TRUE(setType::add(o, Slice{"a", 1}, cfg));
+  EXPECT_FALSE(setType::add(o, Slice{"a", 1}, cfg));
+  EXPECT_TRUE(setType::add(o, Slice{"1", 1}, cfg));
+  EXPECT_TRUE(setType::add(o, Slice{"c", 1}, cfg));
+  EXPECT_EQ(o.encoding(), Object::Encoding::kListpack);
+  EXPECT_TRUE(setType::add(o, Slice{"d", 1}, cfg));
+  EXPECT_EQ(o.encoding(), Object::Encoding::kHashTable);
+  EXPECT_TRUE(setType::contains(o, Slice{"1", 1}));
+  EXPECT_TRUE(setType::erase(o, Slice{"a", 1}));
+  EXPECT_FALSE(setType::contains(o, Slice{"a", 1}));
+  EXPECT_EQ(setType::size(o), 3u);
+}
+
+TEST(SetTypeTest, IntegerSetsUseIntset) {
+  EncodingConfig cfg;
+  cfg.setMaxIntsetEntries = 4;
+  Object o = setType::create(Slice{"3", 1});
+  EXPECT_EQ(o.encoding(), Object::Encoding::kIntset);
+  EXPECT_STREQ(o.encodingName(), "intset");
+  EXPECT_TRUE(setType::add(o, Slice{"3", 1}, cfg));
+  EXPECT_TRUE(setType::add(o, Slice{"-1", 2}, cfg));
+  EXPECT_FALSE(setType::add(o, Slice{"3", 1}, cfg));
+  EXPECT_TRUE(setType::contains(o, Slice{"-1", 2}));
+  // 不是规范形式的整数不是同一个成员
+  EXPECT_FALSE(setType::contains(o, Slice{"03", 2}));
+  EXPECT_EQ(smembers(o), (std::vector<std::string>{"-1", "3"}));
+
+  // 非整数成员：转为 listpack
+  EXPECT_TRUE(setType::add(o, Slice{"x", 1}, cfg));
+  EXPECT_EQ(o.encoding(), Object::Encoding::kListpack);
+  EXPECT_TRUE(setType::contains(o, Slice{"3", 1}));
+  EXPECT_EQ(setType::size(o), 3u);
+
+  // 超过 set-max-intset-entries：转为哈希表
+  Object big = setType::create(Slice{"1", 1});
+  for (int i = 0; i < 5; ++i)
+    setType::add(big, slice(std::to_string(i)), cfg);
+  EXPECT_EQ(big.encoding(), Object::Encoding::kHashTable);
+  EXPECT_EQ(setType::size(big), 5u);
+  EXPECT_TRUE(setType::contains(big, Slice{"4", 1}));
+
+  Object letters = setType::create(Slice{"a", 1});
+  EXPECT_EQ(letters.encoding(), Object::Encoding::kListpack);
+}
+
+TEST(SetTypeTest, IntersectAcrossEncodings) {
+  EncodingConfig cfg;
+  Object a = setType::create(Slice{"0", 1});
+  Object b = setType::create(Slice{"0", 1});
+  Object c = setType::create(Slice{"0", 1});
+  for (int i = 0; i < 300; ++i) {
+    setType::add(a, slice(std::to_string(i)), cfg);
+    setType::add(b, slice(std::to_string(i * 2)), cfg);
+    setType::add(c, slice(std::to_string(i * 3)), cfg);
+  }
+  std::vector<Object*> sets{&a, &b, &c};
+  std::vector<std::string> out;
+  // 0 到 299 中 6 的倍数
+  EXPECT_EQ(setType::intersect(sets, 0, &out), 50u);
+  EXPECT_EQ(out.front(), "0");
+  EXPECT_EQ(out.back(), "294");
+  EXPECT_EQ(setType::intersect(sets, 7, nullptr), 7u);
+
+  // 有一个不是 intset 时逐个查找
+  setType::add(c, Slice{"x", 1}, cfg);
+  ASSERT_NE(c.encoding(), Object::Encoding::kIntset);
+  out.clear();
+  EXPECT_EQ(setType::intersect(sets, 0, &out), 50u);
+  std::sort(out.begin(), out.end());
+  EXPECT_EQ(out[1], "102");
+  EXPECT_EQ(setType::intersect(sets, 7, nullptr), 7u);
+}
+
+TEST(ListTypeTest, ConvertsAtSizeLimit) {
+  EncodingConfig cfg;
+  cfg.listMaxListpackSize = 3;
+  Object o = listType::create();
+  listType::push(o, Slice{"b", 1}, false, cfg);
+  listType::push(o, Slice{"a", 1}, true, cfg);
+  listType::push(o, Slice{"3", 1}, false, cfg);
+  EXPECT_EQ(o.encoding(), Object::Encoding::kListpack);
+  listType::push(o, Slice{"d", 1}, false, cfg);
+  EXPECT_EQ(o.encoding(), Object::Encoding::kQuicklist);
+  EXPECT_EQ(lrange(o), (std::vector<std::string>{"a", "b", "3", "d"}));
+
+  std::string v;
+  EXPECT_TRUE(listType::index(o, -2, &v));
+  EXPECT_EQ(v, "3");
+  EXPECT_FALSE(listType::index(o, 4, &v));
+  std::string popped;
+  EXPECT_TRUE(listType::pop(o, true, &popped));
+  EXPECT_EQ(popped, "a");
+  EXPECT_TRUE(listType::pop(o, false, &popped));
+  EXPECT_EQ(popped, "d");
+  EXPECT_EQ(listType::size(o), 2u);
+}
+
+TEST(ListTypeTest, ByteLimitCountsEncodedSize) {
+  EncodingConfig cfg;  // -2：8KB
+  Object o = listType::create();
+  const std::string v(1000, 'x');
+  for (int i = 0; i < 8; ++i)
+    listType::push(o, slice(v), false, cfg);
+  EXPECT_EQ(o.encoding(), Object::Encoding::kListpack);
+  listType::push(o, slice(v), false, cfg);
+  EXPECT_EQ(o.encoding(), Object::Encoding::kQuicklist);
+  EXPECT_EQ(listType::size(o), 9u);
+}
+
+TEST(ZsetTypeTest, ListpackKeepsScoreOrder) {
+  EncodingConfig cfg;
+  Object o = zsetType::create();
+  EXPECT_TRUE(zsetType::add(o, 3, Slice{"c", 1}, cfg));
+  EXPECT_TRUE(zsetType::add(o, 1.5, Slice{"a", 1}, cfg));
+  EXPECT_TRUE(zsetType::add(o, 3, Slice{"b", 1}, cfg));
+  EXPECT_TRUE(zsetType::add(o, -1e300, Slice{"z", 1}, cfg));
+  EXPECT_FALSE(zsetType::add(o, 10, Slice{"a", 1}, cfg));
+  EXPECT_EQ(o.encoding(), Object::Encoding::kListpack);
+
+  using Pairs = std::vector<std::pair<std::string, double>>;
+  EXPECT_EQ(zrange(o), (Pairs{{"z", -1e300}, {"b", 3}, {"c", 3}, {"a", 10}}));
+  double score;
+  EXPECT_TRUE(zsetType::score(o, Slice{"a", 1}, &score));
+  EXPECT_EQ(score, 10);
+  std::size_t rank;
+  EXPECT_TRUE(zsetType::rank(o, Slice{"c", 1}, &rank));
+  EXPECT_EQ(rank, 2u);
+  EXPECT_TRUE(zsetType::erase(o, Slice{"b", 1}));
+  EXPECT_FALSE(zsetType::rank(o, Slice{"b", 1}, &rank));
+  EXPECT_EQ(zsetType::size(o), 3u);
+}
+
+TEST(ZsetTypeTest, ConvertsAtThresholds) {
+  EncodingConfig cfg;
+  cfg.zsetMaxListpackEntries = 3;
+  Object o = zsetType::create();
+  zsetType::add(o, 2, Slice{"b", 1}, cfg);
+  zsetType::add(o, 1, Slice{"a", 1}, cfg);
+  zsetType::add(o, 0.25, Slice{"c", 1}, cfg);
+  EXPECT_EQ(o.encoding(), Object::Encoding::kListpack);
+  zsetType::add(o, 3, Slice{"d", 1}, cfg);
+  EXPECT_EQ(o.encoding(), Object::Encoding::kBTree);
+  EXPECT_STREQ(o.encodingName(), "btree");
+
+  using Pairs = std::vector<std::pair<std::string, double>>;
+  EXPECT_EQ(zrange(o), (Pairs{{"c", 0.25}, {"a", 1}, {"b", 2}, {"d", 3}}));
+  EXPECT_FALSE(zsetType::add(o, -5, Slice{"d", 1}, cfg));
+  std::size_t rank;
+  EXPECT_TRUE(zsetType::rank(o, Slice{"d", 1}, &rank));
+  EXPECT_EQ(rank, 0u);
+  EXPECT_TRUE(zsetType::erase(o, Slice{"a", 1}));
+  EXPECT_EQ(zsetType::size(o), 3u);
+  double score;
+  EXPECT_FALSE(zsetType::score(o, Slice{"a", 1}, &score));
+
+  Object big = zsetType::create();
+  zsetType::add(big, 1, slice(std::string(65, 'm')), cfg);
+  EXPECT_EQ(big.encoding(), Object::Encoding::kBTree);
+}
+
+TEST(ZsetTypeTest, RankRangeByScore) {
+  EncodingConfig cfg;
+  cfg.zsetMaxListpackEntries = 4;
+  Object small = zsetType::create();
+  Object big = zsetType::create();
+  for (int i = 0; i < 4; ++i)
+    zsetType::add(small, i, slice("m" + std::to_string(i)), cfg);
+  for (int i = 0; i < 400; ++i)
+    zsetType::add(big, i % 100, slice("m" + std::to_string(i)), cfg);
+  ASSERT_EQ(small.encoding(), Object::Encoding::kListpack);
+  ASSERT_EQ(big.encoding(), Object::Encoding::kBTree);
+
+  std::size_t first;
+  EXPECT_EQ(zsetType::rankRange(small, {1, 2, false, false}, &first), 2u);
+  EXPECT_EQ(first, 1u);
+  EXPECT_EQ(zsetType::rankRange(small, {1, 2, true, false}, &first), 1u);
+  EXPECT_EQ(first, 2u);
+  EXPECT_EQ(zsetType::rankRange(small, {3, 1, false, false}, &first), 0u);
+
+  // 每个分数有 4 个成员
+  EXPECT_EQ(zsetType::rankRange(big, {10, 20, false, false}, &first), 44u);
+  EXPECT_EQ(first, 40u);
+  EXPECT_EQ(zsetType::rankRange(big, {10, 20, true, true}, &first), 36u);
+  EXPECT_EQ(first, 44u);
+  const double inf = std::numeric_limits<double>::infinity();
+  EXPECT_EQ(zsetType::rankRange(big, {-inf, inf, false, false}, &first), 400u);
+  EXPECT_EQ(first, 0u);
+  EXPECT_EQ(zsetType::rankRange(big, {99, 99, true, false}, &first), 0u);
+}
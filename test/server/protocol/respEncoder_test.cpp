@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <base/socket/streamSocket.h>
+#include <server/protocol/respEncoder.h>
+
+#include <limits>
+#include <string>
+
+using tinyredis::RespEncoder;
+using tinyredis::RespVersion;
+
+namespace {
+// 不连接真实套接字，直接取出发送缓冲区里的内容
+class CaptureSocket : public StreamSocket {
+ public:
+  std::string drain() {
+    std::string out;
+    for (;;) {
+      BufferSequence bf;
+      sendBuf_.processBuffer(bf);
+      if (bf.totalBytes() == 0)
+        return out;
+      for (std::size_t i = 0; i < bf.count; ++i)
+        out.append(static_cast<const char*>(bf.buffers[i].iov_base),
+                   bf.buffers[i].iov_len);
+      sendBuf_.skip(bf.totalBytes());
+    }
+  }
+};
+
+// 以两种协议版本各编码一次同样的回复
+template <typename F>
+void expectBoth(F encode, const std::string& resp2, const std::string& resp3) {
+  CaptureSocket sock;
+  RespEncoder enc(&sock);
+  encode(enc);
+  EXPECT_EQ(sock.drain(), resp2);
+  enc.setVersion(RespVersion::kResp3);
+  encode(enc);
+  EXPECT_EQ(sock.drain(), resp3);
+}
+}  // namespace
+
+TEST(RespEncoderTest, Scalars) {
+  expectBoth([](RespEncoder& e) { e.simpleString("OK"); }, "+OK\r\n",
+             "+OK\r\n");
+  expectBoth([](RespEncoder& e) { e.integer(-42); }, ":-42\r\n", ":-42\r\n");
+  expectBoth(
+      [](RespEncoder& e) { e.integer(std::numeric_limits<long long>::min()); },
+      ":-9223372036854775808\r\n", ":-9223372036854775808\r\n");
+  expectBoth([](RespEncoder& e) { e.bulk("", 0); }, "$0\r\n\r\n",
+             "$0\r\n\r\n");
+  expectBoth([](RespEncoder& e) { e.null(); }, "$-1\r\n", "_\r\n");
+  expectBoth([](RespEncoder& e) { e.nullArray(); }, "*-1\r\n", "_\r\n");
+  expectBoth([](RespEncoder& e) { e.boolean(true); }, ":1\r\n", "#t\r\n");
+  expectBoth([](RespEncoder& e) { e.dbl(1.5); }, "$3\r\n1.5\r\n",
+             ",1.5\r\n");
+  expectBoth(
+      [](RespEncoder& e) { e.dbl(-std::numeric_limits<double>::infinity()); },
+      "$4\r\n-inf\r\n", ",-inf\r\n");
+  expectBoth([](RespEncoder& e) { e.bigNumber("12345678901234567890", 20); },
+             "$20\r\n12345678901234567890\r\n", "(12345678901234567890\r\n");
+  expectBoth([](RespEncoder& e) { e.verbatim("txt", "hello", 5); },
+             "$5\r\nhello\r\n", "=9\r\ntxt:hello\r\n");
+}
+
+TEST(RespEncoderTest, Errors) {
+  expectBoth([](RespEncoder& e) { e.error("no such key"); },
+             "-ERR no such key\r\n", "-ERR no such key\r\n");
+  expectBoth([](RespEncoder& e) { e.error("ERR bad"); }, "-ERR bad\r\n",
+             "-ERR bad\r\n");
+  expectBoth([](RespEncoder& e) { e.error("-NOPROTO bad"); },
+             "-NOPROTO bad\r\n", "-NOPROTO bad\r\n");
+  // 换行不能出现在错误行里
+  expectBoth([](RespEncoder& e) { e.error("a\r\nb"); }, "-ERR a  b\r\n",
+             "-ERR a  b\r\n");
+}
+
+TEST(RespEncoderTest, Aggregates) {
+  auto encode = [](RespEncoder& e) {
+    e.map(1);
+    e.bulk("k", 1);
+    e.set(2);
+    e.integer(1);
+    e.integer(2);
+  };
+  expectBoth(encode, "*2\r\n$1\r\nk\r\n*2\r\n:1\r\n:2\r\n",
+             "%1\r\n$1\r\nk\r\n~2\r\n:1\r\n:2\r\n");
+  expectBoth(
+      [](RespEncoder& e) {
+        e.push(2);
+        e.bulk("invalidate", 10);
+        e.array(0);
+      },
+      "*2\r\n$10\r\ninvalidate\r\n*0\r\n",
+      ">2\r\n$10\r\ninvalidate\r\n*0\r\n");
+}
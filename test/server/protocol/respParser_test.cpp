@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <server/protocol/respParser.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using tinyredis::RespParser;
+
+namespace {
+std::vector<std::string> argsOf(const RespParser& parser) {
+  std::vector<std::string> out;
+  for (const auto& arg : parser.args())
+    out.push_back(arg.toString());
+  return out;
+}
+}  // namespace
+
+TEST(RespParserTest, MultiBulk) {
+  const std::string req = "*3\r\n$3\r\nSET\r\n$3\r\nkey\r\n$5\r\nva\r\nl\r\n";
+  RespParser parser;
+  std::size_t consumed = 0;
+  ASSERT_EQ(parser.parse(req.data(), req.size(), consumed),
+            RespParser::Result::kOk);
+  EXPECT_EQ(consumed, req.size());
+  EXPECT_EQ(argsOf(parser),
+            (std::vector<std::string>{"SET", "key", "va\r\nl"}));
+  // 参数直接指向输入，不拷贝
+  EXPECT_EQ(parser.args()[1].data, req.data() + 17);
+}
+
+TEST(RespParserTest, InlineAndPipeline) {
+  const std::string req = "PING  hello\tworld\r\n*1\r\n$4\r\nPING\r\n";
+  RespParser parser;
+  std::size_t consumed = 0;
+  ASSERT_EQ(parser.parse(req.data(), req.size(), consumed),
+            RespParser::Result::kOk);
+  EXPECT_EQ(argsOf(parser),
+            (std::vector<std::string>{"PING", "hello", "world"}));
+  EXPECT_EQ(consumed, 19u);
+
+  parser.reset();
+  std::size_t second = 0;
+  ASSERT_EQ(parser.parse(req.data() + consumed, req.size() - consumed, second),
+            RespParser::Result::kOk);
+  EXPECT_EQ(argsOf(parser), std::vector<std::string>{"PING"});
+  EXPECT_EQ(consumed + second, req.size());
+}
+
+TEST(RespParserTest, ResumeByteByByte) {
+  // 每次多给一个字节，并且每次都换一块内存，模拟绕圈时的拷贝
+  const std::string req = "*2\r\n$4\r\nECHO\r\n$11\r\nhello world\r\n";
+  RespParser parser;
+  std::size_t consumed = 0;
+  for (std::size_t n = 1; n < req.size(); ++n) {
+    std::string copy = req.substr(0, n);
+    ASSERT_EQ(parser.parse(copy.data(), copy.size(), consumed),
+              RespParser::Result::kIncomplete)
+        << n;
+  }
+  std::string copy = req;
+  ASSERT_EQ(parser.parse(copy.data(), copy.size(), consumed),
+            RespParser::Result::kOk);
+  EXPECT_EQ(consumed, req.size());
+  EXPECT_EQ(argsOf(parser),
+            (std::vector<std::string>{"ECHO", "hello world"}));
+}
+
+TEST(RespParserTest, EmptyMultiBulk) {
+  const std::string req = "*0\r\n";
+  RespParser parser;
+  std::size_t consumed = 0;
+  ASSERT_EQ(parser.parse(req.data(), req.size(), consumed),
+            RespParser::Result::kOk);
+  EXPECT_EQ(consumed, req.size());
+  EXPECT_TRUE(parser.args().empty());
+}
+
+TEST(RespParserTest, ProtocolErrors) {
+  const char* bad[] = {"*abc\r\n", "*1\r\n+OK\r\n", "*1\r\n$-5\r\n",
+                       "*1\r\n$99999999999\r\n", "*2000000\r\n"};
+  for (const char* req : bad) {
+    RespParser parser;
+    std::size_t consumed = 0;
+    EXPECT_EQ(parser.parse(req, std::strlen(req), consumed),
+              RespParser::Result::kError)
+        << req;
+    EXPECT_EQ(parser.error().compare(0, 15, "Protocol error:"), 0);
+  }
+
+  // 长度与内容对不上、'\r' 后面不是 '\n'：不能静默跳过，否则后续的帧全部错位
+  const char* badTrailers[] = {"*1\r\n$3\r\nGETXX",
+                               "*1\r\n$3\r\nGET\rX",
+                               "*1\r\n$3\r\nGET\n\r",
+                               "*1\rX$3\r\nGET\r\n",
+                               "*1\r\n$3\rXGET\r\n",
+                               "*2\r\n$1\r\na\r\n$1\r\nbc\r\n"};
+  for (const char* req : badTrailers) {
+    RespParser parser;
+    std::size_t consumed = 0;
+    EXPECT_EQ(parser.parse(req, std::strlen(req), consumed),
+              RespParser::Result::kError)
+        << req;
+    EXPECT_EQ(parser.error().compare(0, 15, "Protocol error:"), 0);
+  }
+
+  // 没有换行的超长内联请求
+  std::string huge(RespParser::kMaxInlineLen + 1, 'a');
+  RespParser parser;
+  std::size_t consumed = 0;
+  EXPECT_EQ(parser.parse(huge.data(), huge.size(), consumed),
+            RespParser::Result::kError);
+}
+
+// 每一项都不超限，但整帧填满了调用方能给的空间：报错而不是一直等
+TEST(RespParserTest, RequestLargerThanLimit) {
+  std::string req = "*100\r\n";
+  for (int i = 0; i < 100; ++i)
+    req += "$3\r\nabc\r\n";
+
+  RespParser fits(req.size());
+  std::size_t consumed = 0;
+  EXPECT_EQ(fits.parse(req.data(), req.size(), consumed),
+            RespParser::Result::kOk);
+  EXPECT_EQ(consumed, req.size());
+
+  RespParser parser(64);
+  EXPECT_EQ(parser.parse(req.data(), 32, consumed),
+            RespParser::Result::kIncomplete);
+  EXPECT_EQ(parser.parse(req.data(), 64, consumed),
+            RespParser::Result::kError);
+  EXPECT_EQ(parser.error(), "Protocol error: too big request");
+}
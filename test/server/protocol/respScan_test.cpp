@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <server/protocol/respScan.h>
+#include "support/kernelGuard.h"
+
+#include <cstring>
+#include <string>
+
+using tinyredis::ScanKernel;
+
+namespace {
+const ScanKernel kKernels[] = {ScanKernel::kScalar, ScanKernel::kLibc,
+                               ScanKernel::kSse2, ScanKernel::kAvx2};
+
+class RespScanTest : public ::testing::Test {
+ private:
+  tinyredis::KernelGuard<ScanKernel> guard_{tinyredis::scanKernels()};
+};
+}  // namespace
+
+TEST_F(RespScanTest, FindMatchesMemchr) {
+  // 覆盖块内、块边界和尾部的各种位置，以及不同的起始对齐
+  std::string buf(200, 'x');
+  for (ScanKernel kernel : kKernels) {
+    if (!tinyredis::scanKernels().force(kernel))
+      continue;
+    SCOPED_TRACE(tinyredis::scanKernelName(kernel));
+    for (std::size_t start = 0; start < 8; ++start) {
+      for (std::size_t len = 0; len + start <= 100; ++len) {
+        for (std::size_t hit = start; hit <= start + len; ++hit) {
+          std::string data = buf;
+          if (hit < data.size()) {
+            data[hit] = '\r';
+            data[hit + 1] = '\n';
+          }
+          const char* p = data.data() + start;
+          EXPECT_EQ(tinyredis::findCR(p, len), std::memchr(p, '\r', len));
+          EXPECT_EQ(tinyredis::findLF(p, len), std::memchr(p, '\n', len));
+        }
+      }
+    }
+  }
+}
+
+TEST_F(RespScanTest, ParseDecimal) {
+  struct Case {
+    const char* text;
+    long long value;
+  } good[] = {{"0", 0},
+              {"7", 7},
+              {"-1", -1},
+              {"12345678", 12345678},
+              {"-87654321", -87654321},
+              {"123456789", 123456789},
+              {"000000000000000042", 42},
+              {"999999999999999999", 999999999999999999LL},
+              {"-100000000000000000", -100000000000000000LL}};
+  for (const auto& c : good) {
+    long long v = -12345;
+    EXPECT_TRUE(tinyredis::parseDecimal(c.text, std::strlen(c.text), v))
+        << c.text;
+    EXPECT_EQ(v, c.value) << c.text;
+  }
+
+  const char* bad[] = {"",    "-",         "1a",        "+1", " 1",
+                       "1 ",  "12345678/", "1234567:8", "--1",
+                       "1234567890123456789"};
+  for (const char* text : bad) {
+    long long v = 0;
+    EXPECT_FALSE(tinyredis::parseDecimal(text, std::strlen(text), v)) << text;
+  }
+}
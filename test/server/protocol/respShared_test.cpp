@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <server/protocol/respShared.h>
+
+#include <limits>
+#include <string>
+
+namespace shared = tinyredis::shared;
+
+namespace {
+std::string format(long long v) {
+  char buf[32];
+  char* end = buf + sizeof(buf);
+  return std::string(tinyredis::formatDecimal(end, v), end);
+}
+}  // namespace
+
+TEST(RespSharedTest, FormatDecimal) {
+  for (long long v = -1000; v <= 100000; ++v)
+    ASSERT_EQ(format(v), std::to_string(v));
+
+  const long long edges[] = {std::numeric_limits<long long>::max(),
+                             std::numeric_limits<long long>::min(),
+                             999999999999999999LL, 1000000000000000000LL,
+                             -9999999999LL};
+  for (long long v : edges)
+    EXPECT_EQ(format(v), std::to_string(v));
+}
+
+TEST(RespSharedTest, CachedReplies) {
+  for (long long n = 0; n < shared::kIntegers; ++n)
+    ASSERT_EQ(shared::integer(n).toString(), ":" + std::to_string(n) + "\r\n");
+
+  const char types[] = {'*', '$', '%', '~', '>'};
+  for (char type : types) {
+    for (std::size_t n = 0; n < shared::kHeaders; ++n) {
+      EXPECT_EQ(shared::header(type, n).toString(),
+                std::string(1, type) + std::to_string(n) + "\r\n");
+    }
+  }
+
+  EXPECT_EQ(shared::header(':', 1).len, 0u);
+  EXPECT_EQ(shared::header('*', shared::kHeaders).len, 0u);
+
+  // 同一个回复每次都引用同一块内存
+  EXPECT_EQ(shared::integer(42).data, shared::integer(42).data);
+  EXPECT_EQ(shared::kWrongType.toString().size(), shared::kWrongType.len);
+  EXPECT_EQ(shared::kSyntaxErr.toString(), "-ERR syntax error\r\n");
+}
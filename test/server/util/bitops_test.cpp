@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <server/util/bitops.h>
+#include "support/kernelGuard.h"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using tinyredis::BitKernel;
+using tinyredis::BitOp;
+
+namespace {
+const BitKernel kKernels[] = {BitKernel::kScalar, BitKernel::kPopcnt,
+                              BitKernel::kAvx2};
+
+// 覆盖尾部、单个向量、Harley-Seal 的 16 向量块和 bitop 的 4KB 分段
+const std::size_t kLengths[] = {0,   1,   7,    8,    31,   32,   33,
+                                63,  64,  511,  512,  513,  1000, 4095,
+                                4096, 4097, 10000};
+
+std::vector<unsigned char> randomBytes(std::mt19937& rng, std::size_t n) {
+  std::vector<unsigned char> v(n + 1);
+  for (unsigned char& b : v)
+    b = static_cast<unsigned char>(rng());
+  return v;
+}
+
+std::size_t naivePopcount(const unsigned char* p, std::size_t n) {
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; ++i)
+    count += static_cast<std::size_t>(__builtin_popcount(p[i]));
+  return count;
+}
+
+unsigned char naiveOp(BitOp op, unsigned char a, unsigned char b) {
+  switch (op) {
+    case BitOp::kAnd:
+      return a & b;
+    case BitOp::kOr:
+      return a | b;
+    case BitOp::kXor:
+      return a ^ b;
+    case BitOp::kNot:
+      break;
+  }
+  return static_cast<unsigned char>(~a);
+}
+
+class BitopsTest : public ::testing::Test {
+ private:
+  tinyredis::KernelGuard<BitKernel> guard_{tinyredis::bitKernels()};
+};
+}  // namespace
+
+TEST_F(BitopsTest, PopcountMatchesNaive) {
+  std::mt19937 rng(1);
+  for (BitKernel kernel : kKernels) {
+    if (!tinyredis::bitKernels().force(kernel))
+      continue;
+    SCOPED_TRACE(tinyredis::bitKernelName(kernel));
+    for (std::size_t n : kLengths) {
+      const std::vector<unsigned char> buf = randomBytes(rng, n);
+      // 从奇数地址开始，检查非对齐的读取
+      for (std::size_t off = 0; off < 2; ++off) {
+        SCOPED_TRACE(n);
+        EXPECT_EQ(naivePopcount(buf.data() + off, n - (n ? off : 0)),
+                  tinyredis::popcount(buf.data() + off, n - (n ? off : 0)));
+      }
+    }
+    std::vector<unsigned char> ones(5000, 0xFF);
+    EXPECT_EQ(5000u * 8, tinyredis::popcount(ones.data(), ones.size()));
+  }
+}
+
+TEST_F(BitopsTest, FindByteNot) {
+  for (BitKernel kernel : kKernels) {
+    if (!tinyredis::bitKernels().force(kernel))
+      continue;
+    SCOPED_TRACE(tinyredis::bitKernelName(kernel));
+    for (std::size_t n : kLengths) {
+      for (unsigned char skip : {0x00, 0xFF}) {
+        std::vector<unsigned char> buf(n + 1, skip);
+        EXPECT_EQ(n, tinyredis::findByteNot(buf.data(), n, skip));
+        // 每个位置放一个不同的字节，应当恰好找到它
+        for (std::size_t i = 0; i < n; i += (n > 100 ? 37 : 1)) {
+          buf[i] = static_cast<unsigned char>(skip ^ 0x10);
+          EXPECT_EQ(i, tinyredis::findByteNot(buf.data(), n, skip));
+          buf[i] = skip;
+        }
+        // 范围之外的字节不应被看到
+        buf[n] = static_cast<unsigned char>(~skip);
+        EXPECT_EQ(n, tinyredis::findByteNot(buf.data(), n, skip));
+      }
+    }
+  }
+}
+
+TEST_F(BitopsTest, BitopMatchesNaive) {
+  std::mt19937 rng(2);
+  const BitOp ops[] = {BitOp::kAnd, BitOp::kOr, BitOp::kXor, BitOp::kNot};
+  for (BitKernel kernel : kKernels) {
+    if (!tinyredis::bitKernels().force(kernel))
+      continue;
+    SCOPED_TRACE(tinyredis::bitKernelName(kernel));
+    for (BitOp op : ops) {
+      for (std::size_t n : kLengths) {
+        if (n == 0)
+          continue;
+        SCOPED_TRACE(n);
+        // 长度各不相同的源，短的部分视为 0
+        std::vector<std::vector<unsigned char>> bufs;
+        std::vector<const void*> srcs;
+        std::vector<std::size_t> lens;
+        const std::size_t count = op == BitOp::kNot ? 1 : 3;
+        for (std::size_t i = 0; i < count; ++i) {
+          const std::size_t len = i == 1 ? n : (n * (i + 1)) / 4;
+          bufs.push_back(randomBytes(rng, len));
+          lens.push_back(len);
+        }
+        for (const auto& b : bufs)
+          srcs.push_back(b.data());
+
+        std::vector<unsigned char> expected(n);
+        for (std::size_t j = 0; j < n; ++j) {
+          unsigned char v = j < lens[0] ? bufs[0][j] : 0;
+          if (op == BitOp::kNot)
+            v = naiveOp(op, v, 0);
+          for (std::size_t i = 1; i < count; ++i)
+            v = naiveOp(op, v, j < lens[i] ? bufs[i][j] : 0);
+          expected[j] = v;
+        }
+        std::vector<unsigned char> dst(n, 0xAA);
+        tinyredis::bitop(op, dst.data(), n, srcs.data(), lens.data(), count);
+        EXPECT_EQ(expected, dst);
+      }
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <server/util/lzf.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using tinyredis::lzfCompress;
+using tinyredis::lzfDecompress;
+
+namespace {
+std::string roundTrip(const std::string& in, std::size_t* compressed) {
+  std::vector<char> out(in.size() + in.size() / 16 + 64);
+  *compressed = lzfCompress(in.data(), in.size(), out.data(), out.size());
+  if (*compressed == 0)
+    return "";
+  std::string back(in.size(), '\0');
+  const std::size_t n =
+      lzfDecompress(out.data(), *compressed, &back[0], back.size());
+  back.resize(n);
+  return back;
+}
+}  // namespace
+
+TEST(LzfTest, RoundTripsRepetitiveData) {
+  std::string in;
+  for (int i = 0; i < 500; ++i)
+    in += "item:" + std::to_string(i % 37) + ",";
+  std::size_t compressed;
+  EXPECT_EQ(roundTrip(in, &compressed), in);
+  EXPECT_LT(compressed, in.size() / 3);
+
+  // 距离小于长度的重叠拷贝，以及超过一次回溯上限的长匹配
+  const std::string runs(10000, 'a');
+  EXPECT_EQ(roundTrip(runs, &compressed), runs);
+  EXPECT_LT(compressed, 200u);
+}
+
+TEST(LzfTest, RoundTripsRandomData) {
+  std::mt19937 rng(1);
+  for (std::size_t len : {1u, 2u, 3u, 31u, 32u, 33u, 1000u, 9000u}) {
+    std::string in(len, '\0');
+    for (char& c : in)
+      c = static_cast<char>(rng() % 4 == 0 ? 'x' : rng());
+    std::size_t compressed;
+    EXPECT_EQ(roundTrip(in, &compressed), in) << len;
+  }
+}
+
+TEST(LzfTest, GivesUpWhenOutputTooSmall) {
+  std::mt19937 rng(2);
+  std::string in(1000, '\0');
+  for (char& c : in)
+    c = static_cast<char>(rng());
+  std::vector<char> out(in.size() - 8);
+  EXPECT_EQ(lzfCompress(in.data(), in.size(), out.data(), out.size()), 0u);
+}
+
+TEST(LzfTest, RejectsCorruptInput) {
+  char out[16];
+  // 回溯距离超出已解压的数据
+  const unsigned char backRef[] = {0x00, 'a', 0x20, 0x05};
+  EXPECT_EQ(lzfDecompress(backRef, sizeof(backRef), out, sizeof(out)), 0u);
+  // 字面量被截断
+  const unsigned char truncated[] = {0x05, 'a', 'b'};
+  EXPECT_EQ(lzfDecompress(truncated, sizeof(truncated), out, sizeof(out)), 0u);
+  // 输出空间不够
+  const unsigned char literal[] = {0x03, 'a', 'b', 'c', 'd'};
+  EXPECT_EQ(lzfDecompress(literal, sizeof(literal), out, 3), 0u);
+}
@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+#include <server/util/stringMatch.h>
+
+#include <cstring>
+
+namespace {
+bool match(const char* pattern, const char* str, bool nocase = false) {
+  return tinyredis::stringMatch(pattern, std::strlen(pattern), str,
+                                std::strlen(str), nocase);
+}
+}  // namespace
+
+TEST(StringMatchTest, Glob) {
+  EXPECT_TRUE(match("*", ""));
+  EXPECT_TRUE(match("user:*", "user:42"));
+  EXPECT_FALSE(match("user:*", "users:42"));
+  EXPECT_TRUE(match("h?llo", "hello"));
+  EXPECT_FALSE(match("h?llo", "hllo"));
+  EXPECT_TRUE(match("h[ae]llo", "hallo"));
+  EXPECT_FALSE(match("h[^e]llo", "hello"));
+  EXPECT_TRUE(match("h[a-c]llo", "hbllo"));
+  EXPECT_TRUE(match("*a*b*c", "xxaxxbxxc"));
+  EXPECT_FALSE(match("*a*b*c", "xxaxxbxx"));
+  EXPECT_TRUE(match("a\\*b", "a*b"));
+  EXPECT_FALSE(match("a\\*b", "axb"));
+  EXPECT_TRUE(match("HELLO", "hello", true));
+  EXPECT_FALSE(match("HELLO", "hello"));
+}
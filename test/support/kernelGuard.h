@@ -0,0 +1,24 @@
+#ifndef TEST_SUPPORT_KERNELGUARD_H
+#define TEST_SUPPORT_KERNELGUARD_H
+
+#include <server/util/cpuFeatures.h>
+
+namespace tinyredis {
+// 构造时记下当前内核，析构时恢复，用例里强制切换内核后不影响后面的用例
+template <typename Kernel>
+class KernelGuard {
+ public:
+  explicit KernelGuard(KernelSelector<Kernel>& selector)
+      : selector_(selector), saved_(selector.current()) {}
+  ~KernelGuard() { selector_.force(saved_); }
+
+  KernelGuard(const KernelGuard&) = delete;
+  KernelGuard& operator=(const KernelGuard&) = delete;
+
+ private:
+  KernelSelector<Kernel>& selector_;
+  Kernel saved_;
+};
+}  // namespace tinyredis
+
+#endif